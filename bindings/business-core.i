@@ -125,6 +125,7 @@ GLIST_HELPER_INOUT(OwnerList, SWIGTYPE_p__gncOwner);
 %include <gncInvoice.h>
 %include <gncJob.h>
 %include <gncOrder.h>
+%newobject gncOwnerGetLots;
 %include <gncOwner.h>
 %include <gncTaxTable.h>
 %include <gncVendor.h>
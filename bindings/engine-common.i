@@ -44,6 +44,9 @@ AccountList * gnc_account_get_descendants_sorted (const Account *account);
 %ignore gnc_account_get_children_sorted;
 %ignore gnc_account_get_descendants;
 %ignore gnc_account_get_descendants_sorted;
+%ignore xaccAccountForEachSplitInRange;
+%ignore gnc_account_get_balances_at_dates;
+%newobject xaccAccountGetSplitsInRange;
 %include <Account.h>
 
 %include <Transaction.h>
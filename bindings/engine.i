@@ -92,8 +92,24 @@ engine-common.i */
 
 #endif
 
+%ignore qof_log_generation;
+%ignore qof_log_check_site;
 %include "qoflog.h"
 
+%ignore qof_stat_lookup;
+%ignore qof_stat_add;
+%ignore qof_stat_timer_start;
+%ignore qof_stat_timer_stop;
+%ignore qof_stat_foreach;
+%ignore qof_stat_cached;
+%newobject qof_stat_dump;
+%include "qofstats.h"
+%include "qoftrace.h"
+%ignore qof_memory_register_source;
+%ignore qof_memory_foreach;
+%newobject qof_memory_report;
+%include "qofmemory.h"
+
 %inline %{
 static const GncGUID * gncPriceGetGUID(GNCPrice *x)
 { return qof_instance_get_guid(QOF_INSTANCE(x)); }
@@ -118,6 +134,7 @@ functions. */
 %newobject gnc_pricedb_lookup_at_time64;
 %newobject gnc_pricedb_lookup_day;
 %newobject gnc_pricedb_lookup_day_t64;
+%newobject gnc_pricedb_lookup_nearest_before_commodities_t64;
 
 %newobject xaccQueryGetSplitsUniqueTrans;
 %newobject xaccQueryGetTransactions;
@@ -179,6 +196,9 @@ functions. */
 %typemap(in) char * action;
 
 %include <policy.h>
+// No typemaps for the arrays; the bindings use the list form.
+%ignore gnc_pricedb_lookup_nearest_before_matrix_t64;
+%ignore gnc_price_matrix_destroy;
 %include <gnc-pricedb.h>
 
 QofSession * qof_session_new (QofBook* book);
@@ -188,6 +208,8 @@ const char *qof_session_get_url (QofSession *session);
 
 %ignore qof_print_date_time_buff;
 %ignore gnc_tm_free;
+// No typemaps for the arrays.
+%ignore gnc_time64_get_period_bounds_gdate;
 %include <gnc-date.h>
 extern const char *gnc_default_strftime_date_format;
 
@@ -222,10 +244,14 @@ SplitList * qof_query_run_subquery (QofQuery *q, const QofQuery *q);
 %ignore GNC_ERROR_OVERFLOW;
 %ignore GNC_ERROR_DENOM_DIFF;
 %ignore GNC_ERROR_REMAINDER;
+%ignore gnc_numeric_sum_array;
 %include <gnc-numeric.h>
 
 time64 time64CanonicalDayTime(time64 t);
 
+%ignore gnc_budget_set_account_period_values;
+%ignore gnc_budget_get_account_period_values;
+%ignore gnc_budget_get_account_period_actual_values;
 %include <gnc-budget.h>
 
 %typemap(in) GList * {
@@ -1852,6 +1852,156 @@ SCM gnc_account_value_ptr_to_scm (GncAccountValue *av)
                      gnc_numeric_to_scm (val));
 }
 
+SCM
+gnc_accounts_get_balances_at_dates (SCM accounts, SCM dates)
+{
+    swig_type_info * account_type = get_acct_type();
+    gsize n_accounts, n_dates, i, j;
+    Account **accts;
+    time64 *times;
+    gnc_numeric *balances;
+    SCM result = SCM_EOL;
+
+    SCM_ASSERT (scm_is_true (scm_list_p (accounts)), accounts, SCM_ARG1,
+                "gnc-accounts-get-balances-at-dates");
+    SCM_ASSERT (scm_is_true (scm_list_p (dates)), dates, SCM_ARG2,
+                "gnc-accounts-get-balances-at-dates");
+
+    n_accounts = scm_to_size_t (scm_length (accounts));
+    n_dates = scm_to_size_t (scm_length (dates));
+    accts = g_new (Account *, n_accounts);
+    times = g_new (time64, n_dates);
+    balances = g_new (gnc_numeric, n_accounts * n_dates);
+
+    for (i = 0; i < n_accounts; i++, accounts = SCM_CDR (accounts))
+    {
+        SCM acc = SCM_CAR (accounts);
+
+        accts[i] = SWIG_IsPointerOfType (acc, account_type) ?
+            SWIG_MustGetPtr (acc, account_type, 1, 0) : NULL;
+    }
+
+    for (j = 0; j < n_dates; j++, dates = SCM_CDR (dates))
+        times[j] = scm_to_int64 (SCM_CAR (dates));
+
+    gnc_account_get_balances_at_dates (accts, n_accounts, times, n_dates,
+                                       balances);
+
+    for (i = n_accounts; i-- > 0; )
+    {
+        SCM row = SCM_EOL;
+
+        for (j = n_dates; j-- > 0; )
+            row = scm_cons (gnc_numeric_to_scm (balances[i * n_dates + j]),
+                            row);
+        result = scm_cons (row, result);
+    }
+
+    g_free (balances);
+    g_free (times);
+    g_free (accts);
+    return result;
+}
+
+/* A split sequence is a bytevector holding the Split pointers, so
+ * that it costs one allocation however long it is and only the splits
+ * actually looked at get a SWIG wrapper. */
+
+static swig_type_info *
+get_split_type ()
+{
+    static swig_type_info * split_type = NULL;
+
+    if (!split_type)
+        split_type = SWIG_TypeQuery("_p_Split");
+
+    return split_type;
+}
+
+static SCM
+gnc_split_list_to_seq (GList *splits)
+{
+    SCM seq = scm_c_make_bytevector (g_list_length (splits) * sizeof (Split *));
+    Split **data = (Split **) SCM_BYTEVECTOR_CONTENTS (seq);
+
+    for (; splits; splits = splits->next)
+        *data++ = splits->data;
+    return seq;
+}
+
+static size_t
+gnc_split_seq_size (SCM seq, int pos, const char *func)
+{
+    SCM_ASSERT (scm_is_bytevector (seq), seq, pos, func);
+    return SCM_BYTEVECTOR_LENGTH (seq) / sizeof (Split *);
+}
+
+SCM
+gnc_query_run_split_seq (QofQuery *q)
+{
+    return gnc_split_list_to_seq (qof_query_run (q));
+}
+
+SCM
+gnc_account_get_split_seq (const Account *acc)
+{
+    return gnc_split_list_to_seq (xaccAccountGetSplitList (acc));
+}
+
+SCM
+gnc_split_seq_length (SCM seq)
+{
+    return scm_from_size_t (gnc_split_seq_size (seq, SCM_ARG1,
+                                                "gnc-split-seq-length"));
+}
+
+SCM
+gnc_split_seq_ref (SCM seq, SCM index)
+{
+    size_t n = gnc_split_seq_size (seq, SCM_ARG1, "gnc-split-seq-ref");
+    size_t i = scm_to_size_t (index);
+
+    if (i >= n)
+        scm_out_of_range ("gnc-split-seq-ref", index);
+    return SWIG_NewPointerObj (((Split **) SCM_BYTEVECTOR_CONTENTS (seq))[i],
+                               get_split_type (), 0);
+}
+
+SCM
+gnc_split_seq_fold (SCM proc, SCM init, SCM seq)
+{
+    size_t n = gnc_split_seq_size (seq, SCM_ARG3, "gnc-split-seq-fold");
+    size_t i;
+
+    SCM_ASSERT (scm_is_true (scm_procedure_p (proc)), proc, SCM_ARG1,
+                "gnc-split-seq-fold");
+    for (i = 0; i < n; i++)
+        init = scm_call_2 (proc,
+                           SWIG_NewPointerObj (((Split **) SCM_BYTEVECTOR_CONTENTS (seq))[i],
+                                               get_split_type (), 0),
+                           init);
+    return init;
+}
+
+static void
+qof_stat_to_scm_cb (const char *name, guint64 count, gint64 usecs,
+                    gpointer user_data)
+{
+    SCM *result = user_data;
+    *result = scm_cons (scm_cons (scm_from_utf8_string (name),
+                                  scm_cons (scm_from_uint64 (count),
+                                            scm_from_int64 (usecs))),
+                        *result);
+}
+
+SCM
+gnc_qof_stats (void)
+{
+    SCM result = SCM_EOL;
+    qof_stat_foreach (qof_stat_to_scm_cb, &result);
+    return scm_reverse_x (result, SCM_EOL);
+}
+
 typedef struct
 {
     SCM proc;
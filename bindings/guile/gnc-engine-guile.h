@@ -59,6 +59,31 @@ SCM gnc_book_to_scm (const QofBook *book);
 GncAccountValue * gnc_scm_to_account_value_ptr (SCM valuearg);
 SCM gnc_account_value_ptr_to_scm (GncAccountValue *);
 
+/** Return, for each account in the list 'accounts', the list of its
+ * balances at each of the times in the list 'dates', including the
+ * splits posted at that time. The balances come from
+ * gnc_account_get_balances_at_dates() in one call. */
+SCM gnc_accounts_get_balances_at_dates (SCM accounts, SCM dates);
+
+/** @name Split sequences
+ * The splits found by a query or in an account as an opaque sequence
+ * that wraps a split for Scheme only when it is looked at, unlike the
+ * list qof-query-run returns.  It stays valid as long as its splits
+ * do.
+ * @{ */
+SCM gnc_query_run_split_seq (QofQuery *q);
+SCM gnc_account_get_split_seq (const Account *acc);
+SCM gnc_split_seq_length (SCM seq);
+SCM gnc_split_seq_ref (SCM seq, SCM index);
+/** Call (proc split accumulator) on each split in turn, starting with
+ *  init, and return the last result, like srfi-1 fold. */
+SCM gnc_split_seq_fold (SCM proc, SCM init, SCM seq);
+/** @} */
+
+/** The engine's performance counters as an alist of
+ *  (name count . microseconds), in name order. See qofstats.h. */
+SCM gnc_qof_stats (void);
+
 /**
  * add Scheme-style danglers from a hook
  */
@@ -1,11 +1,13 @@
 (use-modules (srfi srfi-64))
 (use-modules (tests srfi64-extras))
 (use-modules (gnucash engine))
+(use-modules (tests test-engine-extras))
 
 (define (run-test)
   (test-runner-factory gnc:test-runner)
   (test-begin "test-engine")
   (test-engine)
+  (test-split-seq)
   (test-end "test-engine"))
 
 (define (test-engine)
@@ -18,3 +20,34 @@
     (gnc-pricedb-lookup-latest-before-any-currency-t64 '() '() 0))
 
   (test-end "testing deprecated functions"))
+
+(define (test-split-seq)
+  (let* ((env (create-test-env))
+         (book (gnc-get-current-book))
+         (usd (gnc-commodity-table-lookup
+               (gnc-commodity-table-get-table book) "CURRENCY" "USD"))
+         (bank (env-create-root-account env ACCT-TYPE-BANK usd))
+         (income (env-create-root-account env ACCT-TYPE-INCOME usd)))
+    (env-create-transaction env (current-time) bank income 10)
+    (env-create-transaction env (current-time) bank income 20)
+    (test-begin "split sequences")
+
+    (let ((seq (gnc-account-get-split-seq bank)))
+      (test-equal "length" 2 (gnc-split-seq-length seq))
+      (test-equal "ref"
+        (xaccSplitGetAmount (cadr (xaccAccountGetSplitList bank)))
+        (xaccSplitGetAmount (gnc-split-seq-ref seq 1)))
+      (test-error "ref out of range" (gnc-split-seq-ref seq 2))
+      (test-equal "fold" 30
+        (gnc-split-seq-fold
+         (lambda (split total) (+ total (xaccSplitGetAmount split)))
+         0 seq)))
+
+    (let ((query (qof-query-create-for-splits)))
+      (qof-query-set-book query book)
+      (test-equal "query length"
+        (length (qof-query-run query))
+        (gnc-split-seq-length (gnc-query-run-split-seq query)))
+      (qof-query-destroy query))
+
+    (test-end "split sequences")))
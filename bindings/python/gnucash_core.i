@@ -51,6 +51,9 @@
 #include "qofbook.h"
 #include "qofbackend.h"
 #include "qoflog.h"
+#include "qofstats.h"
+#include "qoftrace.h"
+#include "qofmemory.h"
 #include "qofutil.h"
 #include "qofid.h"
 #include "guid.h"
@@ -92,6 +95,26 @@
 
 %include <qofbackend.h>
 
+/* Opening, loading, saving and querying a big book take a while; let
+ * other Python threads run meanwhile.  The argument conversions before
+ * and the result conversions after the call still hold the GIL.  See
+ * the Session docstring in gnucash_core.py for the thread rules. */
+%define GNC_PY_ALLOW_THREADS(function)
+%exception function {
+    Py_BEGIN_ALLOW_THREADS
+    $action
+    Py_END_ALLOW_THREADS
+}
+%enddef
+GNC_PY_ALLOW_THREADS(qof_session_begin)
+GNC_PY_ALLOW_THREADS(qof_session_load)
+GNC_PY_ALLOW_THREADS(qof_session_save)
+GNC_PY_ALLOW_THREADS(qof_session_safe_save)
+GNC_PY_ALLOW_THREADS(qof_session_end)
+GNC_PY_ALLOW_THREADS(qof_session_destroy)
+GNC_PY_ALLOW_THREADS(qof_query_run)
+GNC_PY_ALLOW_THREADS(qof_query_run_subquery)
+
 // this function is defined in qofsession.h, but isn't found in the libraries,
 // ignored because SWIG attempts to link against (to create language bindings)
 %ignore qof_session_not_saved;
@@ -105,6 +128,68 @@
 
 %include <qofquerycore.h>
 
+%ignore qof_stat_lookup;
+%ignore qof_stat_add;
+%ignore qof_stat_timer_start;
+%ignore qof_stat_timer_stop;
+%ignore qof_stat_foreach;
+%ignore qof_stat_cached;
+%ignore qof_stat_dump;
+%include <qofstats.h>
+
+%include <qoftrace.h>
+
+%ignore qof_memory_register_source;
+%ignore qof_memory_foreach;
+%newobject qof_memory_report;
+%include <qofmemory.h>
+
+%{
+static void
+gnc_py_stat_cb (const char *name, guint64 count, gint64 usecs, gpointer user_data)
+{
+    PyObject **result = user_data;
+    PyObject *value;
+
+    if (!*result) return;
+    value = Py_BuildValue ("(KL)", (unsigned long long) count, (long long) usecs);
+    if (!value || PyDict_SetItemString (*result, name, value) < 0)
+        Py_CLEAR (*result);
+    Py_XDECREF (value);
+}
+
+static void
+gnc_py_memory_cb (const char *name, guint64 count, guint64 bytes, gpointer user_data)
+{
+    PyObject **result = user_data;
+    PyObject *value;
+
+    if (!*result) return;
+    value = Py_BuildValue ("(KK)", (unsigned long long) count, (unsigned long long) bytes);
+    if (!value || PyDict_SetItemString (*result, name, value) < 0)
+        Py_CLEAR (*result);
+    Py_XDECREF (value);
+}
+%}
+
+%inline %{
+PyObject *
+gnc_py_get_stats (void)
+{
+    PyObject *result = PyDict_New ();
+    qof_stat_foreach (gnc_py_stat_cb, &result);
+    return result;
+}
+
+PyObject *
+gnc_py_get_memory_usage (QofBook *book)
+{
+    PyObject *result = PyDict_New ();
+    qof_memory_foreach (book, gnc_py_memory_cb, &result);
+    return result;
+}
+%}
+
 /* SWIG doesn't like this macro, so redefine it to simply mean const */
 #define G_CONST_RETURN const
 %include <guid.h>
@@ -115,6 +200,8 @@
 
 //Ignored because it is unimplemented
 %ignore gnc_numeric_convert_with_error;
+//Ignored because there is no typemap for arrays of gnc_numeric
+%ignore gnc_numeric_sum_array;
 %include <gnc-numeric.h>
 
 %include <gnc-commodity.h>
@@ -210,11 +297,88 @@ static const GncGUID * gncEntryGetGUID(GncEntry *x);
 %include <gncIDSearch.h>
 
 // Commodity prices includes and stuff
+// No typemaps for the arrays; use gnc_pricedb_lookup_nearest_before_commodities_t64
+%ignore gnc_pricedb_lookup_nearest_before_matrix_t64;
+%ignore gnc_price_matrix_destroy;
 %include <gnc-pricedb.h>
 
 %include <cap-gains.h>
 %include <Scrub3.h>
 
+/* Bulk access to the splits of an account for analysis scripts: one
+ * call copies a field of every split into a bytes object, which
+ * gnucash_core.py hands out as a typed memoryview. */
+%{
+static PyObject *
+gnc_py_account_split_column (Py_ssize_t n, Py_ssize_t width, char **data)
+{
+    PyObject *column = PyBytes_FromStringAndSize (NULL, n * width);
+    if (column)
+        *data = PyBytes_AS_STRING (column);
+    return column;
+}
+%}
+
+%inline %{
+PyObject *
+gnc_py_account_get_split_columns (const Account *account)
+{
+    SplitList *splits = xaccAccountGetSplitList (account);
+    Py_ssize_t n = g_list_length (splits), i = 0;
+    const char *names[] = { "post_date", "amount_num", "amount_denom",
+                            "value_num", "value_denom", "reconcile", "guid" };
+    const Py_ssize_t widths[] = { sizeof (gint64), sizeof (gint64),
+                                  sizeof (gint64), sizeof (gint64),
+                                  sizeof (gint64), 1, GUID_DATA_SIZE };
+    enum { N_COLUMNS = G_N_ELEMENTS (names) };
+    char *data[N_COLUMNS];
+    PyObject *columns[N_COLUMNS] = { NULL };
+    PyObject *result = NULL;
+    gint64 *post_date, *amount_num, *amount_denom, *value_num, *value_denom;
+    int c;
+
+    for (c = 0; c < N_COLUMNS; c++)
+        if (!(columns[c] = gnc_py_account_split_column (n, widths[c], &data[c])))
+            goto done;
+
+    post_date = (gint64*) data[0];
+    amount_num = (gint64*) data[1];
+    amount_denom = (gint64*) data[2];
+    value_num = (gint64*) data[3];
+    value_denom = (gint64*) data[4];
+    for (; splits; splits = splits->next, i++)
+    {
+        Split *split = splits->data;
+        gnc_numeric amount = xaccSplitGetAmount (split);
+        gnc_numeric value = xaccSplitGetValue (split);
+
+        post_date[i] = xaccTransGetDate (xaccSplitGetParent (split));
+        amount_num[i] = amount.num;
+        amount_denom[i] = amount.denom;
+        value_num[i] = value.num;
+        value_denom[i] = value.denom;
+        data[5][i] = xaccSplitGetReconcile (split);
+        memcpy (data[6] + i * GUID_DATA_SIZE,
+                qof_instance_get_guid (QOF_INSTANCE (split))->reserved,
+                GUID_DATA_SIZE);
+    }
+
+    if (!(result = PyDict_New ()))
+        goto done;
+    for (c = 0; c < N_COLUMNS; c++)
+        if (PyDict_SetItemString (result, names[c], columns[c]) < 0)
+        {
+            Py_CLEAR (result);
+            break;
+        }
+
+done:
+    for (c = 0; c < N_COLUMNS; c++)
+        Py_XDECREF (columns[c]);
+    return result;
+}
+%}
+
 %init %{
 gnc_environment_setup();
 qof_log_init();
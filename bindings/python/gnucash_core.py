@@ -50,6 +50,18 @@ from gnucash.gnucash_core_c import gncInvoiceLookup, gncInvoiceGetInvoiceFromTxn
     gnc_numeric_create, double_to_gnc_numeric, string_to_gnc_numeric, \
     gnc_numeric_to_string
 
+from gnucash.gnucash_core_c import qof_stat_get_count, qof_stat_get_usecs, \
+    qof_stat_reset
+from gnucash.gnucash_core_c import qof_trace_start, qof_trace_stop, \
+    qof_trace_is_recording, qof_trace_begin, qof_trace_end, \
+    qof_trace_get_count, qof_trace_write, qof_trace_clear
+
+def get_engine_stats():
+    """Return the engine's performance counters as a dict mapping each
+    stat's name, like 'account.recompute-balance', to a tuple of the
+    number of times it fired and the microseconds spent in it."""
+    return gnucash_core_c.gnc_py_get_stats()
+
 from gnucash.deprecation import (
     deprecated_args_session,
     deprecated_args_session_init,
@@ -155,6 +167,15 @@ class Session(GnuCashCoreClass):
     Every Session has a Book in the book attribute, which you'll definitely
     be interested in, as every GnuCash entity (Transaction, Split, Vendor,
     Invoice..) is associated with a particular book where it is stored.
+
+    Threads: begin, load, save, safe_save, end and destroy, as well as
+    Query.run, release the GIL while the engine works, so other Python
+    threads keep running.  The engine itself is not thread safe, so those
+    threads must not use this session, its book or anything in it until
+    the call returns; use a lock around all access to a session if
+    several threads share it.  Threads working on different sessions
+    are fine, as long as each session is only used by one thread at a
+    time and nothing is passed between their books.
     """
 
     @deprecated_args_session_init
@@ -523,6 +544,19 @@ methods_return_instance(GncPriceDB,PriceDB_dict)
 GncPriceDB.get_prices = method_function_returns_instance_list(
     GncPriceDB.get_prices, GncPrice )
 
+def gnc_pricedb_lookup_nearest_before_commodities_t64(self, commodities, currency, date):
+    """Look up the price nearest before date of each of a list of commodities
+    in currency in one call. Returns a list in the order of commodities holding
+    a GncPrice, or None where there is no price."""
+    prices = gnucash_core_c.gnc_pricedb_lookup_nearest_before_commodities_t64(
+        self.instance, [commodity.instance for commodity in commodities],
+        currency.instance, date)
+    return [GncPrice(instance=price) if price is not None else None
+            for price in prices]
+
+GncPriceDB.lookup_nearest_before_commodities_t64 = \
+    gnc_pricedb_lookup_nearest_before_commodities_t64
+
 class GncCommodity(GnuCashCoreClass): pass
 
 class GncCommodityTable(GnuCashCoreClass):
@@ -626,6 +660,31 @@ class Account(GnuCashCoreClass):
     """
     _new_instance = 'xaccMallocAccount'
 
+    # memoryview formats of the columns returned by GetSplitColumns
+    _split_column_formats = { 'post_date': 'q', 'amount_num': 'q',
+                              'amount_denom': 'q', 'value_num': 'q',
+                              'value_denom': 'q', 'reconcile': 'c',
+                              'guid': 'B' }
+
+    def GetSplitColumns(self):
+        """Return the splits of this account, in the order of
+        GetSplitList, as a dict of memoryviews with one item per split:
+
+        post_date     the posted date of the transaction, in seconds (int64)
+        amount_num    the amount as numerator and denominator (int64)
+        amount_denom
+        value_num     the value as numerator and denominator (int64)
+        value_denom
+        reconcile     the reconcile flag, e.g. b'n' or b'y' (char)
+        guid          the GUIDs of the splits, 16 bytes each (uint8)
+
+        The data is copied in one call, so it can be handed to e.g.
+        numpy.frombuffer without a Python call per split."""
+        columns = gnucash_core_c.gnc_py_account_get_split_columns(
+            self.get_instance())
+        return { name: memoryview(data).cast(self._split_column_formats[name])
+                 for name, data in columns.items() }
+
 class GUID(GnuCashCoreClass):
     _new_instance = 'guid_new_return'
 
@@ -689,6 +748,8 @@ Book.add_method('gnc_book_set_root_account', 'set_root_account')
 Book.add_method('gnc_commodity_table_get_table', 'get_table')
 Book.add_method('gnc_pricedb_get_db', 'get_price_db')
 Book.add_method('qof_book_increment_and_format_counter', 'increment_and_format_counter')
+Book.add_method('gnc_py_get_memory_usage', 'get_memory_usage')
+Book.add_method('qof_memory_report', 'memory_report')
 
 #Functions that return Account
 Book.get_root_account = method_function_returns_instance(
@@ -859,6 +920,7 @@ account_dict =  {
 methods_return_instance(Account, account_dict)
 methods_return_instance_lists(
     Account, { 'GetSplitList': Split,
+               'GetSplitsInRange': Split,
                'get_children': Account,
                'get_children_sorted': Account,
                'get_descendants': Account,
@@ -66,5 +66,42 @@ class TestAccount(AccountSession):
         self.account.ScrubLots()
         self.assertEqual(len(self.account.GetLotList()),1)
 
+    def test_split_columns(self):
+        self.assertEqual(len(self.account.GetSplitColumns()['post_date']), 0)
+
+        other = Account(self.book)
+        self.account.SetCommodity(self.currency)
+        other.SetCommodity(self.currency)
+
+        tx = Transaction(self.book)
+        tx.BeginEdit()
+        tx.SetCurrency(self.currency)
+        tx.SetDatePostedSecs(datetime(2021, 3, 4, 10, 59))
+
+        s1 = Split(self.book)
+        s1.SetParent(tx)
+        s1.SetAccount(self.account)
+        s1.SetAmount(GncNumeric(125, 100))
+        s1.SetValue(GncNumeric(125, 100))
+        s1.SetReconcile('y')
+
+        s2 = Split(self.book)
+        s2.SetParent(tx)
+        s2.SetAccount(other)
+        s2.SetAmount(GncNumeric(-125, 100))
+        s2.SetValue(GncNumeric(-125, 100))
+        tx.CommitEdit()
+
+        columns = self.account.GetSplitColumns()
+        self.assertEqual(len(columns['post_date']), 1)
+        self.assertEqual(datetime.fromtimestamp(columns['post_date'][0]),
+                         tx.GetDate())
+        self.assertEqual(columns['amount_num'].tolist(), [125])
+        self.assertEqual(columns['amount_denom'].tolist(), [100])
+        self.assertEqual(columns['value_num'].tolist(), [125])
+        self.assertEqual(columns['value_denom'].tolist(), [100])
+        self.assertEqual(columns['reconcile'].tolist(), [b'y'])
+        self.assertEqual(len(columns['guid']), 16)
+
 if __name__ == '__main__':
     main()
@@ -266,6 +266,30 @@ typedef char gchar;
     }
 }
 
+%typemap(in) CommodityList * {
+    $1 = NULL;
+    /* Check if is a list */
+    if (PyList_Check($input)) {
+        int i;
+        int size = PyList_Size($input);
+        for (i = size-1; i >= 0; i--) {
+            PyObject *o = PyList_GetItem($input, i);
+            void *p = NULL;
+            if (SWIG_ConvertPtr(o, &p, SWIGTYPE_p_gnc_commodity, 0) < 0) {
+                PyErr_SetString(PyExc_TypeError, "list must contain commodities");
+                g_list_free($1);
+                return NULL;
+            }
+            $1 = g_list_prepend($1, p);
+        }
+    } else {
+        PyErr_SetString(PyExc_TypeError, "not a list");
+        return NULL;
+    }
+}
+
+%typemap(freearg) CommodityList * "g_list_free($1);"
+
 %typemap(out) GList *, CommodityList *, SplitList *, AccountList *, LotList *,
     MonetaryList *, PriceList *, EntryList * {
     gpointer data;
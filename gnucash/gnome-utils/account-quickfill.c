@@ -54,15 +54,34 @@ static void listen_for_account_events (QofInstance* entity,
 typedef struct
 {
     QuickFill* qf;
-    gboolean load_list_store;
     GtkListStore* list_store;
     QofBook* book;
     Account* root;
     gint  listener;
     AccountBoolCB dont_add_cb;
     gpointer dont_add_data;
+    /* QFBEntry of each account in the tree, listed or not. */
+    GHashTable* entries;
 } QFB;
 
+/* What the quickfill knows of an account: the name it was last given
+ * and, unless dont_add_cb skipped it, its row in the list store.  The
+ * list store's iters persist, so the row needn't be searched for. */
+typedef struct
+{
+    char* name;
+    gboolean listed;
+    GtkTreeIter iter;
+} QFBEntry;
+
+static void
+qfb_entry_free (gpointer data)
+{
+    QFBEntry* entry = data;
+    g_free (entry->name);
+    g_free (entry);
+}
+
 static void
 shared_quickfill_destroy (QofBook* book, gpointer key, gpointer user_data)
 {
@@ -77,73 +96,101 @@ shared_quickfill_destroy (QofBook* book, gpointer key, gpointer user_data)
                                  qfb);
     gnc_quickfill_destroy (qfb->qf);
     g_object_unref (qfb->list_store);
+    g_hash_table_destroy (qfb->entries);
     qof_event_unregister_handler (qfb->listener);
     g_free (qfb);
 }
 
-
-typedef struct find_data
-{
-    GList* accounts;
-    GList* refs;
-} find_data;
-
 static gboolean
-shared_quickfill_find_accounts (GtkTreeModel* model,
-                                GtkTreePath* path,
-                                GtkTreeIter* iter,
-                                gpointer user_data)
+shared_quickfill_skip (QFB* qfb, Account* account)
 {
-    Account* account = NULL;
-    find_data* data = user_data;
-    GtkTreeRowReference* ref;
-    GList* tmp;
+    return qfb->dont_add_cb && qfb->dont_add_cb (account, qfb->dont_add_data);
+}
 
-    gtk_tree_model_get (model, iter, ACCOUNT_POINTER, &account, -1);
-    for (tmp = data->accounts; tmp; tmp = g_list_next (tmp))
-    {
-        if (tmp->data == account)
-        {
-            ref = gtk_tree_row_reference_new (model, path);
-            data->refs = g_list_append (data->refs, ref);
-            data->accounts = g_list_remove_link (data->accounts, tmp);
-            return (data->accounts == NULL);
-        }
-    }
-    return FALSE;
+static void
+shared_quickfill_list (QFB* qfb, Account* account, QFBEntry* entry)
+{
+    gnc_quickfill_insert (qfb->qf, entry->name, QUICKFILL_ALPHA);
+    gtk_list_store_append (qfb->list_store, &entry->iter);
+    gtk_list_store_set (qfb->list_store, &entry->iter,
+                        ACCOUNT_NAME, entry->name,
+                        ACCOUNT_POINTER, account,
+                        -1);
+    entry->listed = TRUE;
 }
 
+static void
+shared_quickfill_unlist (QFB* qfb, QFBEntry* entry)
+{
+    gnc_quickfill_remove (qfb->qf, entry->name, QUICKFILL_ALPHA);
+    gtk_list_store_remove (qfb->list_store, &entry->iter);
+    entry->listed = FALSE;
+}
 
 /* Splat the account name into the shared quickfill object */
 static void
 load_shared_qf_cb (Account* account, gpointer data)
 {
     QFB* qfb = data;
+    QFBEntry* entry;
     char* name;
-    GtkTreeIter iter;
 
-    if (qfb->dont_add_cb)
-    {
-        gboolean skip = (qfb->dont_add_cb) (account, qfb->dont_add_data);
-        if (skip)
-            return;
-    }
+    if (g_hash_table_contains (qfb->entries, account))
+        return;
 
     name = gnc_get_account_name_for_register (account);
     if (NULL == name)
         return;
-    gnc_quickfill_insert (qfb->qf, name, QUICKFILL_ALPHA);
-    if (qfb->load_list_store)
+
+    entry = g_new0 (QFBEntry, 1);
+    entry->name = name;
+    g_hash_table_insert (qfb->entries, account, entry);
+    if (!shared_quickfill_skip (qfb, account))
+        shared_quickfill_list (qfb, account, entry);
+}
+
+static void
+unload_shared_qf_cb (Account* account, gpointer data)
+{
+    QFB* qfb = data;
+    QFBEntry* entry = g_hash_table_lookup (qfb->entries, account);
+
+    if (!entry)
+        return;
+    if (entry->listed)
+        shared_quickfill_unlist (qfb, entry);
+    g_hash_table_remove (qfb->entries, account);
+}
+
+/* Bring the account's name and row up to date.  Returns TRUE if its
+ * name changed, and so the names of its descendants too. */
+static gboolean
+update_shared_qf (QFB* qfb, Account* account)
+{
+    QFBEntry* entry = g_hash_table_lookup (qfb->entries, account);
+    gboolean skip, renamed;
+    char* name;
+
+    if (!entry)
     {
-        gtk_list_store_append (qfb->list_store, &iter);
-        gtk_list_store_set (qfb->list_store, &iter,
-                            ACCOUNT_NAME, name,
-                            ACCOUNT_POINTER, account,
-                            -1);
+        load_shared_qf_cb (account, qfb);
+        return FALSE;
     }
-    g_free (name);
-}
 
+    name = gnc_get_account_name_for_register (account);
+    if (NULL == name)
+        return FALSE;
+
+    skip = shared_quickfill_skip (qfb, account);
+    renamed = (g_strcmp0 (name, entry->name) != 0);
+    if (entry->listed && (skip || renamed))
+        shared_quickfill_unlist (qfb, entry);
+    g_free (entry->name);
+    entry->name = name;
+    if (!entry->listed && !skip)
+        shared_quickfill_list (qfb, account, entry);
+    return renamed;
+}
 
 static void
 shared_quickfill_pref_changed (gpointer prefs, gchar* pref, gpointer user_data)
@@ -153,9 +200,8 @@ shared_quickfill_pref_changed (gpointer prefs, gchar* pref, gpointer user_data)
     /* Reload the quickfill */
     gnc_quickfill_purge (qfb->qf);
     gtk_list_store_clear (qfb->list_store);
-    qfb->load_list_store = TRUE;
+    g_hash_table_remove_all (qfb->entries);
     gnc_account_foreach_descendant (qfb->root, load_shared_qf_cb, qfb);
-    qfb->load_list_store = FALSE;
 }
 
 
@@ -175,9 +221,10 @@ build_shared_quickfill (QofBook* book, Account* root, const char* key,
     qfb->listener = 0;
     qfb->dont_add_cb = cb;
     qfb->dont_add_data = data;
-    qfb->load_list_store = TRUE;
     qfb->list_store      = gtk_list_store_new (NUM_ACCOUNT_COLUMNS,
                                                G_TYPE_STRING, G_TYPE_POINTER);
+    qfb->entries = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                          NULL, qfb_entry_free);
 
     gnc_prefs_register_cb (GNC_PREFS_GROUP_GENERAL,
                            GNC_PREF_ACCOUNT_SEPARATOR,
@@ -190,9 +237,12 @@ build_shared_quickfill (QofBook* book, Account* root, const char* key,
                            qfb);
 
     gnc_account_foreach_descendant (root, load_shared_qf_cb, qfb);
-    qfb->load_list_store = FALSE;
 
-    qfb->listener = qof_event_register_handler (listen_for_account_events, qfb);
+    qfb->listener =
+        qof_event_register_handler_filtered (listen_for_account_events, qfb,
+                                             GNC_ID_ACCOUNT,
+                                             QOF_EVENT_MODIFY | QOF_EVENT_ADD |
+                                             QOF_EVENT_REMOVE);
 
     qof_book_set_data_fin (book, key, qfb, shared_quickfill_destroy);
 
@@ -234,24 +284,18 @@ gnc_get_shared_account_name_list_store (Account* root, const char* key,
 }
 
 /* Since we are maintaining a 'global' quickfill list, we need to
- * update it whenever the user creates a new account.  So listen
- * for account modification events, and add new accounts.
+ * update it whenever the user creates, changes or removes an account.
+ * So listen for account events.  Most modify events come from balance
+ * changes and leave the name alone; only a rename needs the names of
+ * the descendants worked out again.
  */
 static void
 listen_for_account_events (QofInstance* entity, QofEventId event_type,
                            gpointer user_data, gpointer event_data)
 {
     QFB* qfb = user_data;
-    QuickFill* qf = qfb->qf;
-    QuickFill* match;
-    char* name;
-    const char* match_str;
     Account* account;
-    GtkTreeIter iter;
-    find_data data = { 0 };
-    GtkTreePath* path;
-    GList* tmp;
-    gboolean valid;
+    GList* descendants, *node;
 
     if (0 == (event_type & (QOF_EVENT_MODIFY | QOF_EVENT_ADD | QOF_EVENT_REMOVE)))
         return;
@@ -269,154 +313,36 @@ listen_for_account_events (QofInstance* entity, QofEventId event_type,
         return;
     }
 
-    name = gnc_get_account_name_for_register (account);
-    if (NULL == name)
-    {
-        LEAVE ("account has no name");
-        return;
-    }
-
     switch (event_type)
     {
     case QOF_EVENT_MODIFY:
-        DEBUG ("modify %s", name);
-
-        /* Find the account (and all its descendants) in the model.  The
-         * full name of all these accounts has changed. */
-        data.accounts = gnc_account_get_descendants (account);
-        data.accounts = g_list_prepend (data.accounts, account);
-        gtk_tree_model_foreach (GTK_TREE_MODEL (qfb->list_store),
-                                shared_quickfill_find_accounts, &data);
-
-        /* Update the existing items in the list store.  Its possible
-         * that the change has caused an existing item to now become
-         * hidden, in which case it needs to be removed from the list
-         * store.  Otherwise its a simple update of the name string. */
-        for (tmp = data.refs; tmp; tmp = g_list_next (tmp))
-        {
-            gchar* old_name, *new_name;
-            path = gtk_tree_row_reference_get_path (tmp->data);
-            gtk_tree_row_reference_free (tmp->data);
-            if (!gtk_tree_model_get_iter (GTK_TREE_MODEL (qfb->list_store),
-                                          &iter, path))
-            {
-                gtk_tree_path_free (path);
-                continue;
-            }
-            gtk_tree_path_free (path);
-            gtk_tree_model_get (GTK_TREE_MODEL (qfb->list_store), &iter,
-                                ACCOUNT_POINTER, &account,
-                                ACCOUNT_NAME, &old_name,
-                                -1);
-
-            new_name = gnc_get_account_name_for_register (account);
-
-            /* check if the name has changed */
-            match = gnc_quickfill_get_string_match (qf, old_name);
-            if (match && (g_strcmp0 (old_name, new_name) != 0))
-                gnc_quickfill_remove (qf, old_name, QUICKFILL_ALPHA);
-
-            if (qfb->dont_add_cb &&
-                qfb->dont_add_cb (account, qfb->dont_add_data))
-            {
-                gnc_quickfill_remove (qf, new_name, QUICKFILL_ALPHA);
-                gtk_list_store_remove (qfb->list_store, &iter);
-            }
-            else
-            {
-                gnc_quickfill_insert (qf, new_name, QUICKFILL_ALPHA);
-                gtk_list_store_set (qfb->list_store, &iter,
-                                    ACCOUNT_NAME, new_name,
-                                    -1);
-            }
-            g_free (old_name);
-            g_free (new_name);
-        }
-
-        /* Any accounts that weren't found in the tree are accounts that
-         * were hidden but have now become visible. Add them to the list
-         * store. */
-        for (tmp = data.accounts; tmp; tmp = g_list_next (tmp))
-        {
-            account = tmp->data;
-            if (qfb->dont_add_cb)
-            {
-                if (qfb->dont_add_cb (account, qfb->dont_add_data))
-                {
-                    continue;
-                }
-            }
-            gnc_quickfill_insert (qf, name, QUICKFILL_ALPHA);
-            gtk_list_store_append (qfb->list_store, &iter);
-            gtk_list_store_set (qfb->list_store, &iter,
-                                ACCOUNT_NAME, name,
-                                ACCOUNT_POINTER, account,
-                                -1);
-        }
+        if (!update_shared_qf (qfb, account))
+            break;
+        DEBUG ("rename %s", xaccAccountGetName (account));
+        descendants = gnc_account_get_descendants (account);
+        for (node = descendants; node; node = g_list_next (node))
+            update_shared_qf (qfb, node->data);
+        g_list_free (descendants);
         break;
 
     case QOF_EVENT_REMOVE:
-        DEBUG ("remove %s", name);
-
-        /* Remove from qf */
-        gnc_quickfill_remove (qfb->qf, name, QUICKFILL_ALPHA);
-
-        /* Does the account exist in the model? */
-        data.accounts = g_list_append (NULL, account);
-        gtk_tree_model_foreach (GTK_TREE_MODEL (qfb->list_store),
-                                shared_quickfill_find_accounts, &data);
-
-        /* Remove from list store */
-        for (tmp = data.refs; tmp; tmp = g_list_next (tmp))
-        {
-            path = gtk_tree_row_reference_get_path (tmp->data);
-            gtk_tree_row_reference_free (tmp->data);
-            if (gtk_tree_model_get_iter (GTK_TREE_MODEL (qfb->list_store),
-                                         &iter, path))
-            {
-                gtk_list_store_remove (qfb->list_store, &iter);
-            }
-            gtk_tree_path_free (path);
-        }
+        /* The account takes its subtree out of the tree with it. */
+        DEBUG ("remove %s", xaccAccountGetName (account));
+        unload_shared_qf_cb (account, qfb);
+        gnc_account_foreach_descendant (account, unload_shared_qf_cb, qfb);
         break;
 
     case QOF_EVENT_ADD:
-        DEBUG ("add %s", name);
-
-        if (qfb->dont_add_cb &&
-            qfb->dont_add_cb (account, qfb->dont_add_data))
-            break;
-
-        match = gnc_quickfill_get_string_match (qf, name);
-        if (match)
-        {
-            match_str = gnc_quickfill_string (match);
-            if (match_str && (g_strcmp0 (match_str, name) != 0))
-            {
-                PINFO ("got match for %s", name);
-                break;
-            }
-        }
-
-        PINFO ("insert new account %s into qf=%p", name, qf);
-        gnc_quickfill_insert (qf, name, QUICKFILL_ALPHA);
-        gtk_list_store_append (qfb->list_store, &iter);
-        gtk_list_store_set (qfb->list_store, &iter,
-                            ACCOUNT_NAME, name,
-                            ACCOUNT_POINTER, account,
-                            -1);
+        DEBUG ("add %s", xaccAccountGetName (account));
+        load_shared_qf_cb (account, qfb);
+        gnc_account_foreach_descendant (account, load_shared_qf_cb, qfb);
         break;
 
     default:
-        DEBUG ("other %s", name);
+        DEBUG ("other %s", xaccAccountGetName (account));
         break;
     }
 
-    if (data.accounts)
-        g_list_free (data.accounts);
-    if (data.refs)
-        g_list_free (data.refs);
-    g_free (name);
     LEAVE (" ");
 }
 
@@ -106,6 +106,33 @@ typedef struct GncTreeModelAccountPrivate
 #define GNC_TREE_MODEL_ACCOUNT_GET_PRIVATE(o)  \
    ((GncTreeModelAccountPrivate*)g_type_instance_get_private ((GTypeInstance*)o, GNC_TYPE_TREE_MODEL_ACCOUNT))
 
+/* The cached string values of one account, one slot per column. The
+ * cache is keyed by the account's GUID rather than its address so a
+ * deleted account's values can never be handed to a new one. */
+typedef struct
+{
+    GncGUID guid;
+    gboolean cached[GNC_TREE_MODEL_ACCOUNT_NUM_COLUMNS];
+    gchar *values[GNC_TREE_MODEL_ACCOUNT_NUM_COLUMNS];
+} AccountValues;
+
+static void
+account_values_free (gpointer data)
+{
+    AccountValues *av = data;
+
+    for (gint col = 0; col < GNC_TREE_MODEL_ACCOUNT_NUM_COLUMNS; col++)
+        g_free (av->values[col]);
+    g_free (av);
+}
+
+static GHashTable *
+account_values_hash_new (void)
+{
+    return g_hash_table_new_full (guid_hash_to_guint, guid_g_hash_table_equal,
+                                  NULL, account_values_free);
+}
+
 
 /************************************************************/
 /*           Account Tree Model - Misc Functions            */
@@ -131,8 +158,7 @@ gnc_tree_model_account_update_color (gpointer gsettings, gchar *key, gpointer us
 
     // destroy/recreate the cached account value hash to force update
     g_hash_table_destroy (priv->account_values_hash);
-    priv->account_values_hash = g_hash_table_new_full (g_str_hash, g_str_equal,
-                                                       g_free, g_free);
+    priv->account_values_hash = account_values_hash_new ();
 
     use_red = gnc_prefs_get_bool (GNC_PREFS_GROUP_GENERAL, GNC_PREF_NEGATIVE_IN_RED);
 
@@ -198,8 +224,7 @@ gnc_tree_model_account_init (GncTreeModelAccount *model)
         priv->negative_color = NULL;
 
     // create the account values cache hash
-    priv->account_values_hash = g_hash_table_new_full (g_str_hash, g_str_equal,
-                                                       g_free, g_free);
+    priv->account_values_hash = account_values_hash_new ();
 
     gnc_prefs_register_cb (GNC_PREFS_GROUP_GENERAL, GNC_PREF_NEGATIVE_IN_RED,
                            gnc_tree_model_account_update_color,
@@ -603,8 +628,7 @@ gnc_tree_model_account_clear_cache (GncTreeModelAccount *model)
 
         // destroy the cached account values and recreate
         g_hash_table_destroy (priv->account_values_hash);
-        priv->account_values_hash = g_hash_table_new_full (g_str_hash, g_str_equal,
-                                                           g_free, g_free);
+        priv->account_values_hash = account_values_hash_new ();
 
         gtk_tree_model_foreach (GTK_TREE_MODEL(model), row_changed_foreach_func, NULL);
     }
@@ -614,7 +638,6 @@ static void
 clear_account_cached_values (GncTreeModelAccount *model, GHashTable *hash, Account *account)
 {
     GtkTreeIter iter;
-    gchar acct_guid_str[GUID_ENCODING_LENGTH + 1];
 
     if (!account)
         return;
@@ -628,16 +651,7 @@ clear_account_cached_values (GncTreeModelAccount *model, GHashTable *hash, Accou
         gtk_tree_path_free (path);
     }
 
-    guid_to_string_buff (xaccAccountGetGUID (account), acct_guid_str);
-
-    // loop over the columns and remove any found
-    for (gint col = 0; col <= GNC_TREE_MODEL_ACCOUNT_NUM_COLUMNS; col++)
-    {
-        gchar *key = g_strdup_printf ("%s,%d", acct_guid_str, col);
-
-        g_hash_table_remove (hash, key);
-        g_free (key);
-    }
+    g_hash_table_remove (hash, xaccAccountGetGUID (account));
 }
 
 static void
@@ -666,26 +680,19 @@ gnc_tree_model_account_get_cached_value (GncTreeModelAccount *model, Account *ac
                                          gint column, gchar **cached_string)
 {
     GncTreeModelAccountPrivate *priv = GNC_TREE_MODEL_ACCOUNT_GET_PRIVATE(model);
-    gchar acct_guid_str[GUID_ENCODING_LENGTH + 1];
-    gchar *key = NULL;
-    gpointer value;
-    gboolean found;
+    AccountValues *av;
 
     if ((!priv->account_values_hash) || (!account))
         return FALSE;
 
-    guid_to_string_buff (xaccAccountGetGUID (account), acct_guid_str);
-    key = g_strdup_printf ("%s,%d", acct_guid_str, column);
-
-    found = g_hash_table_lookup_extended (priv->account_values_hash, key,
-                                          NULL, &value);
+    av = g_hash_table_lookup (priv->account_values_hash,
+                              xaccAccountGetGUID (account));
 
-     if (found)
-         *cached_string = g_strdup (value);
-
-    g_free (key);
+    if (!av || !av->cached[column])
+        return FALSE;
 
-    return found;
+    *cached_string = g_strdup (av->values[column]);
+    return TRUE;
 }
 
 static void
@@ -700,14 +707,19 @@ gnc_tree_model_account_set_cached_value (GncTreeModelAccount *model, Account *ac
     // only interested in string values
     if (G_VALUE_HOLDS_STRING(value))
     {
-        gchar acct_guid_str[GUID_ENCODING_LENGTH + 1];
-        const gchar *str = g_value_get_string (value);
-        gchar *key = NULL;
+        const GncGUID *guid = xaccAccountGetGUID (account);
+        AccountValues *av = g_hash_table_lookup (priv->account_values_hash, guid);
 
-        guid_to_string_buff (xaccAccountGetGUID (account), acct_guid_str);
-        key = g_strdup_printf ("%s,%d", acct_guid_str, column);
+        if (!av)
+        {
+            av = g_new0 (AccountValues, 1);
+            av->guid = *guid;
+            g_hash_table_insert (priv->account_values_hash, &av->guid, av);
+        }
 
-        g_hash_table_insert (priv->account_values_hash, key, g_strdup (str));
+        g_free (av->values[column]);
+        av->values[column] = g_strdup (g_value_get_string (value));
+        av->cached[column] = TRUE;
     }
 }
 
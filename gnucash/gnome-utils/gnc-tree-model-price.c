@@ -1134,7 +1134,6 @@ gnc_tree_model_price_get_iter_from_price (GncTreeModelPrice *model,
 {
     GncTreeModelPricePrivate *priv;
     gnc_commodity *commodity;
-    GList *list;
     gint n;
 
     ENTER("model %p, price %p, iter %p", model, price, iter);
@@ -1150,17 +1149,10 @@ gnc_tree_model_price_get_iter_from_price (GncTreeModelPrice *model,
         return FALSE;
     }
 
-    list = gnc_pricedb_get_prices(priv->price_db, commodity, NULL);
-    if (list == NULL)
-    {
-        LEAVE("empty list");
-        return FALSE;
-    }
-
-    n = g_list_index(list, price);
+    /* The same index gnc_pricedb_nth_price uses for the rows. */
+    n = gnc_pricedb_nth_price_index(priv->price_db, price);
     if (n == -1)
     {
-        gnc_price_list_destroy(list);
         LEAVE("not in list");
         return FALSE;
     }
@@ -1169,7 +1161,6 @@ gnc_tree_model_price_get_iter_from_price (GncTreeModelPrice *model,
     iter->user_data  = ITER_IS_PRICE;
     iter->user_data2 = price;
     iter->user_data3 = GINT_TO_POINTER(n);
-    gnc_price_list_destroy(list);
     LEAVE("iter %s", iter_to_string(model, iter));
     return TRUE;
 }
@@ -1598,6 +1589,9 @@ gnc_tree_model_price_event_handler (QofInstance *entity,
         name = "price";
         if (event_type != QOF_EVENT_DESTROY)
         {
+            /* Look the price up among its commodity's prices as they are
+             * now, which for a removal is just before it goes. */
+            gnc_pricedb_nth_price_reset_cache (priv->price_db);
             if (!gnc_tree_model_price_get_iter_from_price (model, price, &iter))
             {
                 LEAVE("no iter");
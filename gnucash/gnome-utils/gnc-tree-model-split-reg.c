@@ -101,7 +101,8 @@ struct GncTreeModelSplitRegPrivate
     QofBook *book;                   // GNC Book
     Account *anchor;                 // Account of register
 
-    GList *full_tlist;               // List of unique transactions derived from the query slist in same order
+    GPtrArray *full_tlist;           // Array of unique transactions derived from the query slist in same order
+    GHashTable *full_tlist_pos;      // The position of each transaction in full_tlist, plus one
     GList *tlist;                    // List of unique transactions derived from the full_tlist to display in same order
     gint   tlist_start;              // The position of the first transaction in tlist in the full_tlist
 
@@ -373,6 +374,8 @@ gnc_tree_model_split_reg_init (GncTreeModelSplitReg *model)
     }
 
     model->priv = g_new0 (GncTreeModelSplitRegPrivate, 1);
+    model->priv->full_tlist = g_ptr_array_new ();
+    model->priv->full_tlist_pos = g_hash_table_new (NULL, NULL);
 
     gnc_prefs_register_cb (GNC_PREFS_GROUP_GENERAL,
                            GNC_PREF_ACCOUNTING_LABELS,
@@ -425,8 +428,10 @@ gnc_tree_model_split_reg_dispose (GObject *object)
     priv->tlist = NULL;
 
     /* Free the full_tlist */
-    g_list_free (priv->full_tlist);
+    g_ptr_array_free (priv->full_tlist, TRUE);
     priv->full_tlist = NULL;
+    g_hash_table_destroy (priv->full_tlist_pos);
+    priv->full_tlist_pos = NULL;
 
     /* Free the blank split */
     priv->bsplit = NULL;
@@ -547,62 +552,33 @@ gtm_sr_remove_all_rows (GncTreeModelSplitReg *model)
     g_list_free (rr_list);
 }
 
+/* Load tlist with the chunk of num_of_rows transactions of full_tlist
+ * at the start or end, or for VIEW_GOTO the three chunks centred on
+ * position num_of_rows. */
 static void
 gtm_sr_reg_load (GncTreeModelSplitReg *model, GncTreeModelSplitRegUpdate model_update, gint num_of_rows)
 {
     GncTreeModelSplitRegPrivate *priv;
-    GList *node;
-    gint rows = 0;
+    gint full_len, i;
 
     priv = model->priv;
+    full_len = priv->full_tlist->len;
 
     if (model_update == VIEW_HOME)
-    {
         priv->tlist_start = 0;
 
-        for (node = g_list_nth (priv->full_tlist, priv->tlist_start); node; node = node->next)
-        {
-            Transaction *trans = node->data;
-
-            priv->tlist = g_list_append (priv->tlist, trans);
-            rows++;
-
-            if (rows == num_of_rows)
-                break;
-        } 
-    }
-    
     if (model_update == VIEW_END)
-    {
-        priv->tlist_start = g_list_length (priv->full_tlist) - num_of_rows;
-
-        for (node = g_list_nth (priv->full_tlist, priv->tlist_start); node; node = node->next)
-        {
-            Transaction *trans = node->data;
-
-            priv->tlist = g_list_append (priv->tlist, trans);
-            rows++;
-
-            if (rows == num_of_rows)
-                break;
-        } 
-    }
+        priv->tlist_start = full_len - num_of_rows;
 
     if (model_update == VIEW_GOTO)
     {
         priv->tlist_start = num_of_rows - NUM_OF_TRANS*1.5;
-
-        for (node = g_list_nth (priv->full_tlist, priv->tlist_start); node; node = node->next)
-        {
-            Transaction *trans = node->data;
-
-            priv->tlist = g_list_append (priv->tlist, trans);
-            rows++;
-
-            if (rows == (NUM_OF_TRANS*3))
-                break;
-        } 
+        num_of_rows = NUM_OF_TRANS*3;
     }
+
+    /* Work back from the end of the chunk so each one is prepended. */
+    for (i = MIN (priv->tlist_start + num_of_rows, full_len) - 1; i >= priv->tlist_start; i--)
+        priv->tlist = g_list_prepend (priv->tlist, g_ptr_array_index (priv->full_tlist, i));
 }
 
 
@@ -611,6 +587,7 @@ void
 gnc_tree_model_split_reg_load (GncTreeModelSplitReg *model, GList *slist, Account *default_account)
 {
     GncTreeModelSplitRegPrivate *priv;
+    GList *tlist, *node;
 
     ENTER("#### Load ModelSplitReg = %p and slist length is %d ####", model, g_list_length (slist));
 
@@ -618,30 +595,42 @@ gnc_tree_model_split_reg_load (GncTreeModelSplitReg *model, GList *slist, Accoun
 
     /* Clear the treeview */
     gtm_sr_remove_all_rows (model);
-    priv->full_tlist = NULL;
+    g_list_free (priv->tlist);
     priv->tlist = NULL;
+    g_ptr_array_set_size (priv->full_tlist, 0);
+    g_hash_table_remove_all (priv->full_tlist_pos);
 
     if (model->current_trans == NULL)
         model->current_trans = priv->btrans;
 
     /* Get a list of Unique Transactions from an slist */
-    priv->full_tlist = xaccSplitListGetUniqueTransactionsReversed (slist);
+    tlist = xaccSplitListGetUniqueTransactionsReversed (slist);
 
     /* Add the blank transaction to the full_tlist */
-    priv->full_tlist = g_list_prepend (priv->full_tlist, priv->btrans);
+    tlist = g_list_prepend (tlist, priv->btrans);
 
     if (model->sort_direction == GTK_SORT_ASCENDING)
-        priv->full_tlist = g_list_reverse (priv->full_tlist);
+        tlist = g_list_reverse (tlist);
+
+    /* The views move around the full_tlist by position, so keep it in
+     * an array with the position of each transaction to hand. */
+    for (node = tlist; node; node = node->next)
+    {
+        g_ptr_array_add (priv->full_tlist, node->data);
+        g_hash_table_insert (priv->full_tlist_pos, node->data,
+                             GINT_TO_POINTER (priv->full_tlist->len));
+    }
+    g_list_free (tlist);
 
     // Update the scrollbar
     gnc_tree_model_split_reg_sync_scrollbar (model);
 
-    model->number_of_trans_in_full_tlist = g_list_length (priv->full_tlist);
+    model->number_of_trans_in_full_tlist = priv->full_tlist->len;
 
     if (model->number_of_trans_in_full_tlist < NUM_OF_TRANS*3)
     {
         // Copy the full_tlist to tlist
-        priv->tlist = g_list_copy (priv->full_tlist);
+        gtm_sr_reg_load (model, VIEW_HOME, model->number_of_trans_in_full_tlist);
     }
     else
     {
@@ -657,7 +646,7 @@ gnc_tree_model_split_reg_load (GncTreeModelSplitReg *model, GList *slist, Accoun
     }
 
     PINFO("#### Register for Account '%s' has %d transactions and %d splits and tlist is %d ####",
-          default_account ? xaccAccountGetName (default_account) : "NULL", g_list_length (priv->full_tlist), g_list_length (slist), g_list_length (priv->tlist));
+          default_account ? xaccAccountGetName (default_account) : "NULL", priv->full_tlist->len, g_list_length (slist), g_list_length (priv->tlist));
 
     /* Update the completion model liststores */
     g_idle_add ((GSourceFunc) gnc_tree_model_split_reg_update_completion, model);
@@ -673,15 +662,15 @@ void
 gnc_tree_model_split_reg_move (GncTreeModelSplitReg *model, GncTreeModelSplitRegUpdate model_update)
 {
     GncTreeModelSplitRegPrivate *priv;
-    GList *inode, *dnode;
-    gint rows = 0;
+    gint full_len, i;
     gint icount = 0;
     gint dcount = 0;
 
     priv = model->priv;
+    full_len = priv->full_tlist->len;
 
     // if list is not long enough, return
-    if (g_list_length (priv->full_tlist) < NUM_OF_TRANS*3)
+    if (full_len < NUM_OF_TRANS*3)
         return;
 
     if ((model_update == VIEW_UP) && (model->current_row < NUM_OF_TRANS) && (priv->tlist_start > 0))
@@ -702,34 +691,17 @@ gnc_tree_model_split_reg_move (GncTreeModelSplitReg *model, GncTreeModelSplitReg
         priv->tlist_start = iblock_start;
 
         // Insert at the front end
-        for (inode = g_list_nth (priv->full_tlist, iblock_end); inode; inode = inode->prev)
-        {
-            Transaction *trans = inode->data;
+        for (i = iblock_end; i >= iblock_start; i--)
+            gtm_sr_insert_trans (model, g_ptr_array_index (priv->full_tlist, i), TRUE);
 
-            gtm_sr_insert_trans (model, trans, TRUE);
-
-            rows++;
-
-            if (rows == icount)
-                break;
-        }
-        rows = 0;
         // Delete at the back end
-        for (dnode = g_list_nth (priv->full_tlist, dblock_end); dnode; dnode = dnode->prev)
-        {
-            Transaction *trans = dnode->data;
-
-            gtm_sr_delete_trans (model, trans);
-
-            rows++;
+        for (i = dblock_end; i >= dblock_start && i < full_len; i--)
+            gtm_sr_delete_trans (model, g_ptr_array_index (priv->full_tlist, i));
 
-            if (rows == dcount)
-                break;
-        }
         g_signal_emit_by_name (model, "refresh_view");
     }
 
-    if ((model_update == VIEW_DOWN) && (model->current_row > NUM_OF_TRANS*2) && (priv->tlist_start < (g_list_length (priv->full_tlist) - NUM_OF_TRANS*3 )))
+    if ((model_update == VIEW_DOWN) && (model->current_row > NUM_OF_TRANS*2) && (priv->tlist_start < (full_len - NUM_OF_TRANS*3 )))
     {
         gint dblock_end = 0;
         gint iblock_start = priv->tlist_start + NUM_OF_TRANS*3;
@@ -739,8 +711,8 @@ gnc_tree_model_split_reg_move (GncTreeModelSplitReg *model, GncTreeModelSplitReg
         if (iblock_start < 0)
             iblock_start = 0;
 
-        if (iblock_end > g_list_length (priv->full_tlist))
-            iblock_end = g_list_length (priv->full_tlist) - 1;
+        if (iblock_end >= full_len)
+            iblock_end = full_len - 1;
 
         icount = iblock_end - iblock_start + 1;
 
@@ -750,30 +722,13 @@ gnc_tree_model_split_reg_move (GncTreeModelSplitReg *model, GncTreeModelSplitReg
         priv->tlist_start = dblock_end;
 
         // Insert at the back end
-        for (inode = g_list_nth (priv->full_tlist, iblock_start); inode; inode = inode->next)
-        {
-            Transaction *trans = inode->data;
-
-            gtm_sr_insert_trans (model, trans, FALSE);
+        for (i = iblock_start; i <= iblock_end; i++)
+            gtm_sr_insert_trans (model, g_ptr_array_index (priv->full_tlist, i), FALSE);
 
-            rows++;
-
-            if (rows == icount)
-                break;
-        }
-        rows = 0;
         // Delete at the front end
-        for (dnode = g_list_nth (priv->full_tlist, dblock_start); dnode; dnode = dnode->next)
-        {
-            Transaction *trans = dnode->data;
+        for (i = dblock_start; i < dblock_end; i++)
+            gtm_sr_delete_trans (model, g_ptr_array_index (priv->full_tlist, i));
 
-            gtm_sr_delete_trans (model, trans);
-
-            rows++;
-
-            if (rows == dcount)
-                break;
-        }
         g_signal_emit_by_name (model, "refresh_view");
     }
 }
@@ -784,20 +739,15 @@ Transaction *
 gnc_tree_model_split_reg_get_first_trans (GncTreeModelSplitReg *model)
 {
     GncTreeModelSplitRegPrivate *priv;
-    GList *node;
     Transaction *trans;
 
     priv = model->priv;
 
-    node = g_list_first (priv->full_tlist);
-
-    trans = node->data;
+    trans = g_ptr_array_index (priv->full_tlist, 0);
 
     if (trans == priv->btrans)
-    {
-        node = g_list_last (priv->full_tlist);
-        trans = node->data;
-    }
+        trans = g_ptr_array_index (priv->full_tlist, priv->full_tlist->len - 1);
+
     return trans;
 }
 
@@ -825,17 +775,15 @@ gnc_tree_model_split_reg_get_tooltip (GncTreeModelSplitReg *model, gint position
     Transaction *trans;
     char date_text[MAX_DATE_LENGTH + 1];
     const gchar *desc_text;
-    GList *node;
 
     memset (date_text, 0, sizeof(date_text));
     priv = model->priv;
 
-    node = g_list_nth (priv->full_tlist, position);
-    if (node == NULL)
+    if (position < 0 || position >= priv->full_tlist->len)
        return g_strconcat ("Error", NULL);
     else
     {
-        trans = node->data;
+        trans = g_ptr_array_index (priv->full_tlist, position);
         if (trans == NULL)
            return g_strconcat ("Error", NULL);
         else if (trans == priv->btrans)
@@ -857,15 +805,13 @@ void
 gnc_tree_model_split_reg_set_current_trans_by_position (GncTreeModelSplitReg *model, gint position)
 {
     GncTreeModelSplitRegPrivate *priv;
-    GList *node;
 
     priv = model->priv;
 
-    node = g_list_nth (priv->full_tlist, position);
-    if (node == NULL)
-        node = g_list_last (priv->full_tlist);
+    if (position < 0 || position >= priv->full_tlist->len)
+        position = priv->full_tlist->len - 1;
 
-    model->current_trans = node->data;
+    model->current_trans = g_ptr_array_index (priv->full_tlist, position);
 }
 
 
@@ -877,7 +823,8 @@ gnc_tree_model_split_reg_sync_scrollbar (GncTreeModelSplitReg *model)
 
     priv = model->priv;
 
-    model->position_of_trans_in_full_tlist = g_list_index (priv->full_tlist, model->current_trans);
+    model->position_of_trans_in_full_tlist = GPOINTER_TO_INT (g_hash_table_lookup (
+        priv->full_tlist_pos, model->current_trans)) - 1;
 
     g_signal_emit_by_name (model, "scroll_sync");
 }
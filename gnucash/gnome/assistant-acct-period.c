@@ -36,6 +36,7 @@
 
 #include <gtk/gtk.h>
 #include <glib/gi18n.h>
+#include <string.h>
 
 #include "Recurrence.h"
 #include "Query.h"
@@ -49,6 +50,8 @@
 #include "gnc-file.h"
 #include "gnc-frequency.h"
 #include "gnc-gui-query.h"
+#include "gnc-period-archive.h"
+#include "gnc-uri-utils.h"
 #include "gnc-ui-util.h"
 #include "misc-gnome-utils.h"
 #include "gnc-session.h"
@@ -161,6 +164,10 @@ get_num_xactions_before_date(QofBook *book, time64 close_date)
     pred = qof_query_date_predicate (QOF_COMPARE_LTE, QOF_DATE_MATCH_NORMAL, close_date);
     qof_query_add_term (q,  param, pred, QOF_QUERY_FIRST_TERM);
 
+    /* The date posted is a plain read, so a big book can be scanned
+     * on several threads. */
+    qof_query_set_parallel (q, TRUE);
+
     /* Run the query, find how many transactions there are */
     res = qof_query_run (q);
 
@@ -187,6 +194,9 @@ get_close_status_str (AcctPeriodInfo *info)
     case 0:
         str = _("The book was closed successfully.");
         break;
+    case 1:
+        str = _("The closed period could not be archived.");
+        break;
     default:
         str = "";
         break;
@@ -458,6 +468,100 @@ ap_validate_menu (GtkAssistant *assistant, gpointer user_data)
 
 /* =============================================================== */
 
+static Account *
+ap_equity_cb (gnc_commodity *currency, gpointer user_data)
+{
+    return gnc_find_or_create_equity_account (gnc_get_current_root_account (),
+                                              EQUITY_RETAINED_EARNINGS,
+                                              currency);
+}
+
+/* The archive goes next to the book's file, named after the closing
+ * date: book.gnucash is archived to book-2020-12-31.gnucash. */
+static char *
+ap_archive_uri (const char *uri, const GDate *closing_date)
+{
+    char date_str[MAX_DATE_LENGTH];
+    const char *slash, *dot;
+    char *base, *archive_uri;
+
+    if (!uri || !gnc_uri_is_file_uri (uri))
+        return NULL;
+
+    g_date_strftime (date_str, sizeof (date_str), "%Y-%m-%d", closing_date);
+    slash = strrchr (uri, '/');
+    dot = strrchr (uri, '.');
+    if (dot && slash && dot < slash)
+        dot = NULL;
+    base = dot ? g_strndup (uri, dot - uri) : g_strdup (uri);
+    archive_uri = g_strdup_printf ("%s-%s%s", base, date_str, dot ? dot : "");
+    g_free (base);
+    return archive_uri;
+}
+
+/* Save what can be archived at the closing date to a book of its own,
+ * and only once that has worked take it out of the current book.
+ * Returns the close status. */
+static int
+ap_archive_period (AcctPeriodInfo *info)
+{
+    QofSession *session = gnc_get_current_session ();
+    QofBook *book = gnc_get_current_book ();
+    time64 cutoff = gnc_time64_get_day_end_gdate (&info->closing_date);
+    QofSession *archive_session;
+    QofBook *archive;
+    char *archive_uri;
+    int status = 0;
+
+    archive_uri = ap_archive_uri (qof_session_get_url (session),
+                                  &info->closing_date);
+    if (!archive_uri)
+    {
+        gnc_error_dialog (GTK_WINDOW (info->window), "%s",
+                          _("Closed periods can only be archived from a book "
+                            "saved in a file."));
+        return 1;
+    }
+
+    gnc_suspend_gui_refresh ();
+    archive = gnc_period_archive_new (book, cutoff);
+    if (archive)
+    {
+        archive_session = qof_session_new (archive);
+        qof_session_begin (archive_session, archive_uri, SESSION_NEW_STORE);
+        if (qof_session_get_error (archive_session) == ERR_BACKEND_NO_ERR)
+            qof_session_save (archive_session, NULL);
+
+        if (qof_session_get_error (archive_session) != ERR_BACKEND_NO_ERR)
+        {
+            gnc_error_dialog (GTK_WINDOW (info->window),
+                              _("The closed period could not be saved to %s: %s"),
+                              archive_uri,
+                              qof_session_get_error_message (archive_session));
+            status = 1;
+        }
+        else if (gnc_period_archive_commit (book, archive, cutoff, archive_uri,
+                                            ap_equity_cb, info))
+            PINFO ("archived to %s", archive_uri);
+        else
+        {
+            gnc_error_dialog (GTK_WINDOW (info->window), "%s",
+                              _("A transaction in the closed period is being "
+                                "edited. Finish or cancel the edit and try "
+                                "again."));
+            status = 1;
+        }
+        qof_session_end (archive_session);
+        qof_session_destroy (archive_session);
+    }
+    gnc_resume_gui_refresh ();
+
+    g_free (archive_uri);
+    return status;
+}
+
+/* =============================================================== */
+
 void
 ap_assistant_finish (GtkAssistant *assistant, gpointer user_data)
 {
@@ -482,7 +586,9 @@ ap_assistant_finish (GtkAssistant *assistant, gpointer user_data)
     g_free(bnotes);
 
     /* Report the status back to the user. */
-    info->close_status = 0;  /* XXX fixme success or failure? */
+    info->close_status = ap_archive_period (info);
+    if (info->close_status != 0)
+        return;
 
     /* Find the next closing date ... */
     info->prev_closing_date = info->closing_date;
@@ -971,9 +971,13 @@ estimate_budget_helper (GtkTreeModel *model, GtkTreePath *path,
         if (gnc_reverse_budget_balance (acct, FALSE))
             num = gnc_numeric_neg (num);
 
-        for (i = 0; i < num_periods; i++)
         {
-            gnc_budget_set_account_period_value (priv->budget, acct, i, num);
+            gnc_numeric *values = g_new (gnc_numeric, num_periods);
+            for (i = 0; i < num_periods; i++)
+                values[i] = num;
+            gnc_budget_set_account_period_values (priv->budget, acct,
+                                                  values, num_periods);
+            g_free (values);
         }
     }
     else
@@ -1086,7 +1090,7 @@ allperiods_budget_helper (GtkTreeModel *model, GtkTreePath *path,
 {
     Account *acct;
     guint num_periods, i;
-    gnc_numeric num, allvalue;
+    gnc_numeric *values, allvalue;
     GncPluginPageBudgetPrivate *priv;
     GncPluginPageBudget *page = data;
 
@@ -1098,33 +1102,35 @@ allperiods_budget_helper (GtkTreeModel *model, GtkTreePath *path,
     if (gnc_reverse_budget_balance (acct, TRUE))
         allvalue = gnc_numeric_neg (allvalue);
 
+    values = g_new (gnc_numeric, num_periods);
+    gnc_budget_get_account_period_values (priv->budget, acct,
+                                          values, num_periods);
     for (i = 0; i < num_periods; i++)
     {
         switch (priv->action)
         {
         case ADD:
-            num = gnc_budget_get_account_period_value (priv->budget, acct, i);
-            num = gnc_numeric_add (num, allvalue, GNC_DENOM_AUTO,
-                                   GNC_HOW_DENOM_SIGFIGS(priv->sigFigs) |
-                                   GNC_HOW_RND_ROUND_HALF_UP);
-            gnc_budget_set_account_period_value (priv->budget, acct, i, num);
+            values[i] = gnc_numeric_add (values[i], allvalue, GNC_DENOM_AUTO,
+                                         GNC_HOW_DENOM_SIGFIGS(priv->sigFigs) |
+                                         GNC_HOW_RND_ROUND_HALF_UP);
             break;
         case MULTIPLY:
-            num = gnc_budget_get_account_period_value (priv->budget, acct, i);
-            num = gnc_numeric_mul (num, priv->allValue, GNC_DENOM_AUTO,
-                                   GNC_HOW_DENOM_SIGFIGS(priv->sigFigs) |
-                                   GNC_HOW_RND_ROUND_HALF_UP);
-            gnc_budget_set_account_period_value (priv->budget, acct, i, num);
+            values[i] = gnc_numeric_mul (values[i], priv->allValue, GNC_DENOM_AUTO,
+                                         GNC_HOW_DENOM_SIGFIGS(priv->sigFigs) |
+                                         GNC_HOW_RND_ROUND_HALF_UP);
             break;
         case UNSET:
-            gnc_budget_unset_account_period_value (priv->budget, acct, i);
+            /* an invalid value unsets the period */
+            values[i] = gnc_numeric_error (GNC_ERROR_ARG);
             break;
         default:
-            gnc_budget_set_account_period_value (priv->budget, acct, i,
-                                                 allvalue);
+            values[i] = allvalue;
             break;
         }
     }
+    gnc_budget_set_account_period_values (priv->budget, acct,
+                                          values, num_periods);
+    g_free (values);
 }
 
 /*******************************/
@@ -378,7 +378,7 @@ gnc_reconcile_view_new (Account *account, GNCReconcileViewType type,
 
             if (recn == CREC &&
         gnc_difftime (trans_date, statement_date_day_end) <= 0)
-        g_hash_table_insert (view->reconciled, split, split);
+        grv_add_reconciled (view, split);
         }
     }
 
@@ -398,6 +398,7 @@ gnc_reconcile_view_init (GNCReconcileView *view)
                 qof_book_use_split_action_for_num_field(gnc_get_current_book());
 
     view->reconciled = g_hash_table_new (NULL, NULL);
+    view->reconciled_total = gnc_numeric_zero ();
     view->account = NULL;
     view->sibling = NULL;
 
@@ -483,6 +484,24 @@ gnc_reconcile_view_class_init (GNCReconcileViewClass *klass)
 }
 
 
+/* The reconciled balance is kept as a running total, so that ticking a
+ * split doesn't sum all the ticked ones again. */
+static void
+grv_add_reconciled (GNCReconcileView *view, Split *split)
+{
+    g_hash_table_insert (view->reconciled, split, split);
+    view->reconciled_total = gnc_numeric_add_fixed (view->reconciled_total,
+                                                    xaccSplitGetAmount (split));
+}
+
+static void
+grv_remove_reconciled (GNCReconcileView *view, Split *split)
+{
+    if (g_hash_table_remove (view->reconciled, split))
+        view->reconciled_total = gnc_numeric_sub_fixed (view->reconciled_total,
+                                                        xaccSplitGetAmount (split));
+}
+
 static void
 gnc_reconcile_view_toggle_split (GNCReconcileView *view, Split *split)
 {
@@ -494,9 +513,9 @@ gnc_reconcile_view_toggle_split (GNCReconcileView *view, Split *split)
     current = g_hash_table_lookup (view->reconciled, split);
 
     if (current == NULL)
-        g_hash_table_insert (view->reconciled, split, split);
+        grv_add_reconciled (view, split);
     else
-        g_hash_table_remove (view->reconciled, split);
+        grv_remove_reconciled (view, split);
 }
 
 
@@ -752,14 +771,22 @@ gnc_reconcile_view_is_reconciled (gpointer item, gpointer user_data)
  * Args: view - view to refresh                                     *
  * Returns: nothing                                                 *
 \********************************************************************/
-static void
+static gboolean
 grv_refresh_helper (gpointer key, gpointer value, gpointer user_data)
 {
     GNCReconcileView *view = user_data;
     GNCQueryView *qview = GNC_QUERY_VIEW (view);
 
-    if (!gnc_query_view_item_in_view (qview, key))
-        g_hash_table_remove (view->reconciled, key);
+    return !gnc_query_view_item_in_view (qview, key);
+}
+
+static void
+grv_balance_hash_helper (gpointer key, gpointer value, gpointer user_data)
+{
+    Split *split = key;
+    gnc_numeric *total = user_data;
+
+    *total = gnc_numeric_add_fixed (*total, xaccSplitGetAmount (split));
 }
 
 void
@@ -787,9 +814,15 @@ gnc_reconcile_view_refresh (GNCReconcileView *view)
     }
     g_list_free_full (path_list, (GDestroyNotify) gtk_tree_path_free);
 
-    /* Now verify that everything in the reconcile hash is still in qview */
+    /* Now verify that everything in the reconcile hash is still in qview,
+     * and total it again in case the splits were edited meanwhile */
     if (view->reconciled)
-        g_hash_table_foreach (view->reconciled, grv_refresh_helper, view);
+    {
+        g_hash_table_foreach_remove (view->reconciled, grv_refresh_helper, view);
+        view->reconciled_total = gnc_numeric_zero ();
+        g_hash_table_foreach (view->reconciled, grv_balance_hash_helper,
+                              &view->reconciled_total);
+    }
 }
 
 
@@ -800,15 +833,6 @@ gnc_reconcile_view_refresh (GNCReconcileView *view)
  * Args: view - view to get reconciled balance of                   *
  * Returns: reconciled balance (gnc_numeric)                        *
 \********************************************************************/
-static void
-grv_balance_hash_helper (gpointer key, gpointer value, gpointer user_data)
-{
-    Split *split = key;
-    gnc_numeric *total = user_data;
-
-    *total = gnc_numeric_add_fixed (*total, xaccSplitGetAmount (split));
-}
-
 gnc_numeric
 gnc_reconcile_view_reconciled_balance (GNCReconcileView *view)
 {
@@ -820,9 +844,7 @@ gnc_reconcile_view_reconciled_balance (GNCReconcileView *view)
     if (view->reconciled == NULL)
         return total;
 
-    g_hash_table_foreach (view->reconciled, grv_balance_hash_helper, &total);
-
-    return gnc_numeric_abs (total);
+    return gnc_numeric_abs (view->reconciled_total);
 }
 
 
@@ -59,6 +59,7 @@ struct GNCReconcileView
     GNCQueryView         qview;
 
     GHashTable          *reconciled;
+    gnc_numeric          reconciled_total;  /* sum of the amounts in reconciled */
     Account             *account;
     GList               *column_list;
 
@@ -30,7 +30,6 @@
 (use-modules (gnucash utilities))
 (use-modules (gnucash gnome-utils))
 (use-modules (gnucash report))
-(use-modules (gnucash reports standard dashboard))
 
 (eval-when (compile load eval expand)
   (load-extension "libgnc-gnome" "scm_init_sw_gnome_module"))
@@ -118,4 +117,9 @@
     (N_ "A basic dashboard for your accounting data")
     (list gnc:menuname-reports gnc:menuname-multicolumn)
     (lambda (window)
-      (gnc-main-window-open-report (gnc:make-dashboard) window)))))
+      ;; the dashboard's module is loaded when it is first opened
+      (let ((make-dashboard
+             (module-ref (gnc:load-report-module
+                          '(gnucash reports standard dashboard))
+                         'gnc:make-dashboard)))
+        (gnc-main-window-open-report (make-dashboard) window))))))
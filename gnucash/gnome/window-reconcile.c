@@ -1571,7 +1571,7 @@ recn_set_watches_one_account (gpointer data, gpointer user_data)
 {
     Account *account = (Account *)data;
     RecnWindow *recnData = (RecnWindow *)user_data;
-    GList *node;
+    GList *splits, *node;
 
     /* add a watch on the account */
     gnc_gui_component_watch_entity (recnData->component_id,
@@ -1579,7 +1579,8 @@ recn_set_watches_one_account (gpointer data, gpointer user_data)
                                     QOF_EVENT_MODIFY | QOF_EVENT_DESTROY);
 
     /* add a watch on each unreconciled or cleared split for the account */
-    for (node = xaccAccountGetSplitList (account); node; node = node->next)
+    splits = xaccAccountGetUnreconciledSplits (account);
+    for (node = splits; node; node = node->next)
     {
         Split *split = node->data;
         Transaction *trans;
@@ -1603,6 +1604,7 @@ recn_set_watches_one_account (gpointer data, gpointer user_data)
             break;
         }
     }
+    g_list_free (splits);
 }
 
 
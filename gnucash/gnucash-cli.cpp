@@ -66,10 +66,23 @@ namespace Gnucash {
         boost::optional <std::string> m_report_name;
         boost::optional <std::string> m_export_type;
         boost::optional <std::string> m_output_file;
+        boost::optional <std::string> m_batch_file;
+        int m_iterations;
+
+        bool m_stats = false;
+        bool m_memory_report = false;
     };
 
 }
 
+static void
+print_stats (void)
+{
+    auto stats = qof_stat_dump ();
+    std::cerr << stats;
+    g_free (stats);
+}
+
 Gnucash::GnucashCli::GnucashCli (const char *app_name) : Gnucash::CoreApp (app_name)
 {
     configure_program_options();
@@ -108,16 +121,32 @@ Gnucash::GnucashCli::configure_program_options (void)
      "  list: \tLists available reports.\n"
      "  show: \tDescribe the options modified in the named report. A datafile \
 may be specified to describe some saved options.\n"
-     "  run: \tRun the named report in the given GnuCash datafile.\n"))
+     "  run: \tRun the named report in the given GnuCash datafile. With \
+--batch-file, run every report listed in the file.\n"
+     "  bench: \tRun the named report --iterations times in the given \
+GnuCash datafile and show where the time goes.\n"))
     ("name", bpo::value (&m_report_name),
      _("Name of the report to run\n"))
     ("export-type", bpo::value (&m_export_type),
      _("Specify export type\n"))
     ("output-file", bpo::value (&m_output_file),
-     _("Output file for report\n"));
+     _("Output file for report\n"))
+    ("batch-file", bpo::value (&m_batch_file),
+     _("File listing reports to run after loading the datafile once. Each \
+line holds a report name, optionally followed by a tab and its output file.\n"))
+    ("iterations", bpo::value (&m_iterations)->default_value (10),
+     _("Number of times 'bench' runs the report\n"));
     m_opt_desc_display->add (report_options);
     m_opt_desc_all.add (report_options);
 
+    bpo::options_description diagnostic_options(_("Diagnostic Options"));
+    diagnostic_options.add_options()
+    ("stats", bpo::bool_switch (&m_stats),
+     _("Print the engine's performance counters to stderr when the command finishes"))
+    ("memory-report", bpo::bool_switch (&m_memory_report),
+     _("Print an estimate of the memory the loaded datafile takes, by type, to stderr"));
+    m_opt_desc_display->add (diagnostic_options);
+    m_opt_desc_all.add (diagnostic_options);
 }
 
 int
@@ -125,6 +154,12 @@ Gnucash::GnucashCli::start ([[maybe_unused]] int argc, [[maybe_unused]] char **a
 {
     Gnucash::CoreApp::start();
 
+    /* The commands end by calling exit from inside Guile, so this is
+     * the one place that is sure to run after them. */
+    if (m_stats)
+        atexit (print_stats);
+    Gnucash::set_memory_report (m_memory_report);
+
     if (m_quotes_cmd)
     {
         if (*m_quotes_cmd != "get")
@@ -154,11 +189,38 @@ Gnucash::GnucashCli::start ([[maybe_unused]] int argc, [[maybe_unused]] char **a
                           << *m_opt_desc_display.get();
                 return 1;
             }
+            else if (m_batch_file)
+            {
+                Gnucash::report_batch reports;
+                if (!Gnucash::read_report_batch (*m_batch_file, reports))
+                    return 1;
+                return Gnucash::run_reports (m_file_to_load, reports,
+                                             m_export_type);
+            }
             else
                 return Gnucash::run_report(m_file_to_load, m_report_name,
                                            m_export_type, m_output_file);
         }
 
+        else if (*m_report_cmd == "bench")
+        {
+            if (!m_file_to_load || m_file_to_load->empty())
+            {
+                std::cerr << bl::translate("Missing data file parameter") << "\n\n"
+                          << *m_opt_desc_display.get();
+                return 1;
+            }
+            else if (!m_report_name || m_report_name->empty())
+            {
+                std::cerr << bl::translate("Missing --name parameter") << "\n\n"
+                          << *m_opt_desc_display.get();
+                return 1;
+            }
+            else
+                return Gnucash::bench_report (m_file_to_load, m_report_name,
+                                              m_iterations);
+        }
+
         // The command "list" does *not* test&pass the m_file_to_load
         // argument because the reports are global rather than
         // per-file objects. In the future, saved reports may be saved
@@ -39,11 +39,13 @@ extern "C" {
 #include <gnc-report.h>
 #include <gnc-session.h>
 #include <qoflog.h>
+#include <qofmemory.h>
 }
 
 #include <boost/locale.hpp>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 namespace bl = boost::locale;
 
@@ -113,6 +115,7 @@ scm_add_quotes(void *data, [[maybe_unused]] int argc, [[maybe_unused]] char **ar
     if (qof_session_get_error(session) != ERR_BACKEND_NO_ERR)
         scm_cleanup_and_exit_with_failure (session);
 
+    print_memory_report (session);
     qof_session_destroy(session);
     if (!scm_is_true(scm_result))
     {
@@ -125,6 +128,24 @@ scm_add_quotes(void *data, [[maybe_unused]] int argc, [[maybe_unused]] char **ar
     return;
 }
 
+static bool memory_report = false;
+
+void
+Gnucash::set_memory_report (bool enabled)
+{
+    memory_report = enabled;
+}
+
+static void
+print_memory_report (QofSession *session)
+{
+    if (!memory_report)
+        return;
+    auto report = qof_memory_report (qof_session_get_book (session));
+    std::cerr << report;
+    g_free (report);
+}
+
 static void
 report_session_percentage (const char *message, double percent)
 {
@@ -142,9 +163,8 @@ report_session_percentage (const char *message, double percent)
  */
 struct run_report_args {
     const std::string& file_to_load;
-    const std::string& run_report;
+    const Gnucash::report_batch& reports;
     const std::string& export_type;
-    const std::string& output_file;
 };
 
 static inline void
@@ -161,6 +181,98 @@ write_report_file (const char *html, const char* file)
     // ofs destructor will close the file
 }
 
+static inline void
+write_report_output (const char *output, const std::string& output_file)
+{
+    if (!output_file.empty())
+        write_report_file (output, output_file.c_str());
+    else
+        std::cout << output << std::endl;
+}
+
+/* Render one report from the loaded book. Returns false if the report
+ * couldn't produce its export, in which case the run must fail. */
+static bool
+render_one_report (SCM report, SCM type, const std::string& output_file)
+{
+    if (scm_is_true (type))
+    {
+        auto run_export_cmd = scm_c_eval_string ("gnc:cmdline-template-export");
+        SCM retval = scm_call_2 (run_export_cmd, report, type);
+        SCM query_result = scm_c_eval_string ("gnc:html-document?");
+        SCM get_export_string = scm_c_eval_string ("gnc:html-document-export-string");
+        SCM get_export_error = scm_c_eval_string ("gnc:html-document-export-error");
+
+        if (scm_is_false (scm_call_1 (query_result, retval)))
+        {
+            std::cerr << _("This report must be upgraded to \
+return a document object with export-string or export-error.") << std::endl;
+            return false;
+        }
+
+        SCM export_string = scm_call_1 (get_export_string, retval);
+        SCM export_error = scm_call_1 (get_export_error, retval);
+
+        if (scm_is_string (export_string))
+        {
+            auto output = scm_to_utf8_string (export_string);
+            write_report_output (output, output_file);
+            free (output);
+        }
+        else if (scm_is_string (export_error))
+        {
+            auto err = scm_to_utf8_string (export_error);
+            std::cerr << err << std::endl;
+            free (err);
+            return false;
+        }
+        else
+        {
+            std::cerr << _("This report must be upgraded to \
+return a document object with export-string or export-error.") << std::endl;
+            return false;
+        }
+    }
+    else
+    {
+        auto get_report_cmd = scm_c_eval_string ("gnc:cmdline-get-report-id");
+        SCM id = scm_call_1(get_report_cmd, report);
+
+        if (scm_is_false (id))
+            return false;
+
+        /* Write a report going to a file straight there as it renders,
+         * rather than holding the whole html in memory first. */
+        if (!output_file.empty())
+        {
+            auto to_file_cmd = scm_c_eval_string ("gnc:cmdline-report-to-file");
+            SCM error = scm_call_2 (to_file_cmd, id,
+                                    scm_from_utf8_string (output_file.c_str()));
+            if (scm_is_string (error))
+            {
+                auto err = scm_to_utf8_string (error);
+                std::cerr << err << std::endl;
+                free (err);
+            }
+            return true;
+        }
+
+        char *html, *errmsg;
+
+        if (gnc_run_report_with_error_handling (scm_to_int(id), &html, &errmsg))
+        {
+            write_report_output (html, output_file);
+            g_free (html);
+        }
+        else
+        {
+            std::cerr << errmsg << std::endl;
+            g_free (errmsg);
+        }
+    }
+    return true;
+}
+
 static void
 scm_run_report (void *data,
                 [[maybe_unused]] int argc, [[maybe_unused]] char **argv)
@@ -180,8 +292,6 @@ scm_run_report (void *data,
 
     auto datafile = args->file_to_load.c_str();
     auto check_report_cmd = scm_c_eval_string ("gnc:cmdline-check-report");
-    auto get_report_cmd = scm_c_eval_string ("gnc:cmdline-get-report-id");
-    auto run_export_cmd = scm_c_eval_string ("gnc:cmdline-template-export");
     /* We generally insist on using scm_from_utf8_string() throughout GnuCash
      * because all GUI-sourced strings and all file-sourced strings are encoded
      * that way. In this case, though, the input is coming from a shell window
@@ -189,12 +299,18 @@ scm_run_report (void *data,
      * so it's necessary here to allow guile to read the locale and interpret
      * the input in that encoding.
      */
-    auto report = scm_from_locale_string (args->run_report.c_str());
     auto type = !args->export_type.empty() ?
                 scm_from_locale_string (args->export_type.c_str()) : SCM_BOOL_F;
+    std::vector<SCM> reports;
 
-    if (scm_is_false (scm_call_2 (check_report_cmd, report, type)))
-        scm_cleanup_and_exit_with_failure (nullptr);
+    /* Check every report before spending time on loading the book. */
+    for (const auto& entry : args->reports)
+    {
+        auto report = scm_from_locale_string (entry.first.c_str());
+        if (scm_is_false (scm_call_2 (check_report_cmd, report, type)))
+            scm_cleanup_and_exit_with_failure (nullptr);
+        reports.push_back (report);
+    }
 
     PINFO ("Loading datafile %s...\n", datafile);
 
@@ -210,75 +326,74 @@ scm_run_report (void *data,
     if (qof_session_get_error (session) != ERR_BACKEND_NO_ERR)
         scm_cleanup_and_exit_with_failure (session);
 
-    char *output;
-
-    if (!args->export_type.empty())
+    auto failed = false;
+    for (size_t i = 0; i < reports.size(); i++)
     {
-        SCM retval = scm_call_2 (run_export_cmd, report, type);
-        SCM query_result = scm_c_eval_string ("gnc:html-document?");
-        SCM get_export_string = scm_c_eval_string ("gnc:html-document-export-string");
-        SCM get_export_error = scm_c_eval_string ("gnc:html-document-export-error");
+        PINFO ("Running report %s...", args->reports[i].first.c_str());
+        if (!render_one_report (reports[i], type, args->reports[i].second))
+            failed = true;
+    }
 
-        if (scm_is_false (scm_call_1 (query_result, retval)))
-        {
-            std::cerr << _("This report must be upgraded to \
-return a document object with export-string or export-error.") << std::endl;
-            scm_cleanup_and_exit_with_failure (nullptr);
-        }
+    if (failed)
+        scm_cleanup_and_exit_with_failure (session);
 
-        SCM export_string = scm_call_1 (get_export_string, retval);
-        SCM export_error = scm_call_1 (get_export_error, retval);
+    print_memory_report (session);
+    qof_session_destroy (session);
 
-        if (scm_is_string (export_string))
-        {
-            output = scm_to_utf8_string (export_string);
-            if (!args->output_file.empty())
-            {
-                write_report_file(output, args->output_file.c_str());
-            }
-            else
-            {
-                std::cout << output << std::endl;
-            }
-        }
-        else if (scm_is_string (export_error))
-        {
-            auto err = scm_to_utf8_string (export_error);
-            std::cerr << err << std::endl;
-            scm_cleanup_and_exit_with_failure (nullptr);
-        }
-        else
-        {
-            std::cerr << _("This report must be upgraded to \
-return a document object with export-string or export-error.") << std::endl;
-            scm_cleanup_and_exit_with_failure (nullptr);
-        }
-    }
-    else
-    {
-        SCM id = scm_call_1(get_report_cmd, report);
+    qof_event_resume ();
+    gnc_shutdown (0);
+    return;
+}
 
-        if (scm_is_false (id))
-            scm_cleanup_and_exit_with_failure (nullptr);
-        char *html, *errmsg;
 
-        if (gnc_run_report_with_error_handling (scm_to_int(id), &html, &errmsg))
-        {
-            if (!args->output_file.empty())
-            {
-                write_report_file(html, args->output_file.c_str());
-            }
-            else
-            {
-                std::cout << html << std::endl;
-            }
-        }
-        else
-        {
-            std::cerr << errmsg << std::endl;
-        }
-    }
+struct bench_report_args {
+    const std::string& file_to_load;
+    const std::string& bench_report;
+    int iterations;
+};
+
+static void
+scm_bench_report (void *data,
+                  [[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    auto args = static_cast<bench_report_args*>(data);
+
+    scm_c_eval_string("(debug-set! stack 200000)");
+    scm_c_use_module ("gnucash utilities");
+    scm_c_use_module ("gnucash app-utils");
+    scm_c_use_module ("gnucash reports");
 
+    gnc_report_init ();
+    gnc_prefs_init ();
+    qof_event_suspend ();
+
+    auto report = scm_from_locale_string (args->bench_report.c_str());
+    auto check_report_cmd = scm_c_eval_string ("gnc:cmdline-check-report");
+    if (scm_is_false (scm_call_2 (check_report_cmd, report, SCM_BOOL_F)))
+        scm_cleanup_and_exit_with_failure (nullptr);
+
+    auto datafile = args->file_to_load.c_str();
+    PINFO ("Loading datafile %s...\n", datafile);
+
+    auto session = gnc_get_current_session ();
+    if (!session)
+        scm_cleanup_and_exit_with_failure (session);
+
+    qof_session_begin (session, datafile, SESSION_READ_ONLY);
+    if (qof_session_get_error (session) != ERR_BACKEND_NO_ERR)
+        scm_cleanup_and_exit_with_failure (session);
+
+    qof_session_load (session, report_session_percentage);
+    if (qof_session_get_error (session) != ERR_BACKEND_NO_ERR)
+        scm_cleanup_and_exit_with_failure (session);
+
+    auto bench_cmd = scm_c_eval_string ("gnc:cmdline-report-bench");
+    if (scm_is_false (scm_call_3 (bench_cmd, report,
+                                  scm_from_int (args->iterations),
+                                  scm_current_output_port ())))
+        scm_cleanup_and_exit_with_failure (session);
+
+    print_memory_report (session);
     qof_session_destroy (session);
 
     qof_event_resume ();
@@ -356,16 +471,58 @@ Gnucash::run_report (const bo_str& file_to_load,
                      const bo_str& export_type,
                      const bo_str& output_file)
 {
-    auto args = run_report_args { file_to_load ? *file_to_load : empty_string,
-                                  run_report ? *run_report : empty_string,
-                                  export_type ? *export_type : empty_string,
-                                  output_file ? *output_file : empty_string };
+    report_batch reports;
     if (run_report && !run_report->empty())
+        reports.emplace_back (*run_report,
+                              output_file ? *output_file : empty_string);
+    return run_reports (file_to_load, reports, export_type);
+}
+
+int
+Gnucash::run_reports (const bo_str& file_to_load,
+                      const report_batch& reports,
+                      const bo_str& export_type)
+{
+    auto args = run_report_args { file_to_load ? *file_to_load : empty_string,
+                                  reports,
+                                  export_type ? *export_type : empty_string };
+    if (!reports.empty())
         scm_boot_guile (0, nullptr, scm_run_report, &args);
 
     return 0;
 }
 
+bool
+Gnucash::read_report_batch (const std::string& batch_file, report_batch& reports)
+{
+    std::ifstream ifs{batch_file};
+    if (!ifs)
+    {
+        std::cerr << "Failed to open file " << batch_file << " for reading\n";
+        return false;
+    }
+
+    std::string line;
+    for (auto lineno = 1; std::getline (ifs, line); lineno++)
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        auto tab = line.find ('\t');
+        auto name = line.substr (0, tab);
+        auto output = tab == std::string::npos ? empty_string : line.substr (tab + 1);
+        if (name.empty())
+        {
+            std::cerr << batch_file << ":" << lineno << ": missing report name\n";
+            return false;
+        }
+        reports.emplace_back (name, output);
+    }
+    return true;
+}
+
 int
 Gnucash::report_show (const bo_str& file_to_load,
                       const bo_str& show_report)
@@ -378,6 +535,20 @@ Gnucash::report_show (const bo_str& file_to_load,
     return 0;
 }
 
+int
+Gnucash::bench_report (const bo_str& file_to_load,
+                       const bo_str& bench_report,
+                       int iterations)
+{
+    auto args = bench_report_args { file_to_load ? *file_to_load : empty_string,
+                                    bench_report ? *bench_report : empty_string,
+                                    iterations };
+    if (bench_report && !bench_report->empty())
+        scm_boot_guile (0, nullptr, scm_bench_report, &args);
+
+    return 0;
+}
+
 int
 Gnucash::report_list (void)
 {
@@ -26,19 +26,41 @@
 #define GNUCASH_COMMANDS_HPP
 
 #include <string>
+#include <utility>
+#include <vector>
 #include <boost/optional.hpp>
 
 using bo_str = boost::optional <std::string>;
 
 namespace Gnucash {
 
+    /* Report names, each with the file its output goes to. An empty
+     * file name sends the output to stdout. */
+    using report_batch = std::vector<std::pair<std::string, std::string>>;
+
     int add_quotes (const bo_str& uri);
     int run_report (const bo_str& file_to_load,
                     const bo_str& run_report,
                     const bo_str& export_type,
                     const bo_str& output_file);
+    int run_reports (const bo_str& file_to_load,
+                     const report_batch& reports,
+                     const bo_str& export_type);
+    /* Read a batch file: one report per line, the report name optionally
+     * followed by a tab and the output file. Blank lines and lines
+     * starting with '#' are skipped. */
+    bool read_report_batch (const std::string& batch_file,
+                            report_batch& reports);
+    /* Run the named report iterations times and print where its time
+     * goes. */
+    int bench_report (const bo_str& file_to_load,
+                      const bo_str& run_report,
+                      int iterations);
     int report_list (void);
     int report_show (const bo_str& file_to_load,
                      const bo_str& run_report);
+    /* Have the commands that load a datafile print the memory the book
+     * holds to stderr once they are done with it. */
+    void set_memory_report (bool enabled);
 }
 #endif
@@ -72,6 +72,18 @@ static int is_development_version = FALSE;
 #endif
 
 static gchar *userdata_migration_msg = NULL;
+static gchar *trace_file = NULL;
+
+/* gnucash and gnucash-cli both leave through exit(), from inside Guile. */
+static void
+write_trace (void)
+{
+    qof_trace_stop ();
+    if (!qof_trace_write (trace_file))
+        std::cerr << "Can't write the trace to " << trace_file << "\n";
+    g_free (trace_file);
+    trace_file = NULL;
+}
 
 static void
 gnc_print_unstable_message(void)
@@ -339,7 +351,9 @@ Gnucash::CoreApp::add_common_program_options (void)
         ("logto", bpo::value (&m_log_to_filename),
          _("File to log into; defaults to \"/tmp/gnucash.trace\"; can be \"stderr\" or \"stdout\"."))
         ("gsettings-prefix", bpo::value (&m_gsettings_prefix),
-         _("Set the prefix for gsettings schemas for gsettings queries. This can be useful to have a different settings tree while debugging."));
+         _("Set the prefix for gsettings schemas for gsettings queries. This can be useful to have a different settings tree while debugging."))
+        ("trace", bpo::value (&m_trace_file),
+         _("Record how long loading, saving, reports, registers and imports take and write it on exit to this file, in the Chrome trace format that chrome://tracing and Perfetto can show."));
 
     bpo::options_description hidden_options(_("Hidden Options"));
     hidden_options.add_options()
@@ -369,6 +383,13 @@ Gnucash::CoreApp::start (void)
     gnc_log_init (m_log_flags, m_log_to_filename);
     gnc_engine_init (0, NULL);
 
+    if (m_trace_file)
+    {
+        trace_file = g_strdup (m_trace_file->c_str());
+        qof_trace_start ();
+        atexit (write_trace);
+    }
+
     /* Write some locale details to the log to simplify debugging */
     PINFO ("System locale returned %s", sys_locale ? sys_locale : "(null)");
     PINFO ("Effective locale set to %s.", setlocale (LC_ALL, NULL));
@@ -64,6 +64,7 @@ extern "C" {
 #ifdef __MINGW32__
 #include <boost/nowide/args.hpp>
 #endif
+#include <functional>
 #include <iostream>
 #include <gnc-locale-utils.hpp>
 
@@ -176,6 +177,15 @@ get_file_to_load (const char* file_to_load)
 
 extern SCM scm_init_sw_gnome_module(void);
 
+/* Runs one step of the start up inside a span of the "startup"
+ * category, so that --trace shows where the start up time goes. */
+static void
+startup_phase (const char *name, const std::function<void ()>& phase)
+{
+    QofTraceSpan span {"startup", name};
+    phase ();
+}
+
 struct t_file_spec {
     int nofile;
     const char *file_to_load;
@@ -191,51 +201,63 @@ scm_run_gnucash (void *data, [[maybe_unused]] int argc, [[maybe_unused]] char **
 
     scm_c_eval_string("(debug-set! stack 200000)");
 
-    main_mod = scm_c_resolve_module("gnucash utilities");
-    scm_set_current_module(main_mod);
-    scm_c_use_module("gnucash app-utils");
+    startup_phase ("app-utils", [&main_mod] {
+        main_mod = scm_c_resolve_module("gnucash utilities");
+        scm_set_current_module(main_mod);
+        scm_c_use_module("gnucash app-utils");
+    });
 
     /* Check whether the settings need a version update */
     gnc_gsettings_version_upgrade ();
 
-    gnc_gnome_utils_init();
-    gnc_search_core_initialize ();
-    gnc_hook_add_dangler(HOOK_UI_SHUTDOWN, (GFunc)gnc_search_core_finalize, NULL, NULL);
-    gnucash_register_add_cell_types ();
-    gnc_report_init ();
+    startup_phase ("gnome-utils", [] {
+        gnc_gnome_utils_init();
+        gnc_search_core_initialize ();
+        gnc_hook_add_dangler(HOOK_UI_SHUTDOWN, (GFunc)gnc_search_core_finalize, NULL, NULL);
+        gnucash_register_add_cell_types ();
+    });
+    startup_phase ("reports", gnc_report_init);
 
-    load_gnucash_plugins();
-    load_gnucash_modules();
+    startup_phase ("plugins", [] {
+        load_gnucash_plugins();
+        load_gnucash_modules();
+    });
 
     /* Load the config before starting up the gui. This insures that
      * custom reports have been read into memory before the Reports
      * menu is created. */
-    load_system_config();
-    load_user_config();
+    startup_phase ("config", [] {
+        load_system_config();
+        load_user_config();
+    });
 
     /* Setting-up the report menu must come after the module
      loading but before the gui initializat*ion. */
-    gnc_plugin_report_system_new();
+    startup_phase ("report-menus", gnc_plugin_report_system_new);
 
     /* TODO: After some more guile-extraction, this should happen even
        before booting guile.  */
-    gnc_main_gui_init();
+    startup_phase ("main-window", gnc_main_gui_init);
 
     gnc_hook_add_dangler(HOOK_UI_SHUTDOWN, (GFunc)gnc_file_quit, NULL, NULL);
 
     /* Install Price Quote Sources */
-    auto msg = bl::translate ("Checking Finance::Quote...").str(gnc_get_boost_locale());
-    gnc_update_splash_screen (msg.c_str(), GNC_SPLASH_PERCENTAGE_UNKNOWN);
-    scm_c_use_module("gnucash price-quotes");
-    scm_c_eval_string("(gnc:price-quotes-install-sources)");
+    startup_phase ("price-quotes", [] {
+        auto msg = bl::translate ("Checking Finance::Quote...").str(gnc_get_boost_locale());
+        gnc_update_splash_screen (msg.c_str(), GNC_SPLASH_PERCENTAGE_UNKNOWN);
+        scm_c_use_module("gnucash price-quotes");
+        scm_c_eval_string("(gnc:price-quotes-install-sources)");
+    });
 
-    gnc_hook_run(HOOK_STARTUP, NULL);
+    startup_phase ("startup-hooks", [] { gnc_hook_run(HOOK_STARTUP, NULL); });
 
     if (!user_file_spec->nofile && (fn = get_file_to_load (user_file_spec->file_to_load)) && *fn )
     {
         auto msg = bl::translate ("Loading data...").str(gnc_get_boost_locale());
         gnc_update_splash_screen (msg.c_str(), GNC_SPLASH_PERCENTAGE_UNKNOWN);
-        gnc_file_open_file(gnc_get_splash_screen(), fn, /*open_readonly*/ FALSE);
+        startup_phase ("open-file", [fn] {
+            gnc_file_open_file(gnc_get_splash_screen(), fn, /*open_readonly*/ FALSE);
+        });
         g_free(fn);
     }
     else if (gnc_prefs_get_bool(GNC_PREFS_GROUP_NEW_USER, GNC_PREF_FIRST_STARTUP))
@@ -374,9 +396,9 @@ Gnucash::Gnucash::start ([[maybe_unused]] int argc, [[maybe_unused]] char **argv
 
     /* Now the module files are looked up, which might cause some library
      initialization to be run, hence gtk must be initialized b*eforehand. */
-    gnc_module_system_init();
+    startup_phase ("module-system", gnc_module_system_init);
 
-    gnc_gui_init();
+    startup_phase ("gui-init", [] { gnc_gui_init(); });
 
     auto user_file_spec = t_file_spec {
         m_nofile,
@@ -71,7 +71,7 @@ typedef struct
     CsvExportType   export_type;
     CsvExportDate   csvd;
     CsvExportAcc    csva;
-    GList          *trans_list;
+    GHashTable     *trans_set;
 
     Query          *query;
     Account        *account;
@@ -99,6 +99,9 @@ typedef struct
 
     gchar          *end_sep;
     gchar          *mid_sep;
+
+    GHashTable     *full_names;
+    GString        *field;
 } CsvExportInfo;
 
 
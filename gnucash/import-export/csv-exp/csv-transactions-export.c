@@ -75,311 +75,254 @@ gboolean write_line_to_file (FILE *fh, char * line)
         return TRUE;
 }
 
+/* Write out a built line and empty it for the next one. */
+static
+gboolean write_gstring_to_file (FILE *fh, GString *line)
+{
+    size_t len = line->len;
+    DEBUG("Account String: %s", line->str);
+
+    if (fwrite (line->str, 1, len, fh) != len)
+        return FALSE;
+    g_string_truncate (line, 0);
+    return TRUE;
+}
+
 
 /*******************************************************
- * csv_txn_test_field_string
+ * csv_txn_append_field_string
  *
- * Test the field string for ," and new lines
+ * Append the field string to the line, quoting it if
+ * it has ," or new lines in it
  *******************************************************/
-static
-gchar *csv_txn_test_field_string (CsvExportInfo *info, const gchar *string_in)
+static void
+csv_txn_append_field_string (GString *line, const gchar *string_in, CsvExportInfo *info)
 {
+    GString *field = info->field;
     gboolean need_quote = FALSE;
-    gchar **parts;
-    gchar *string_parts;
-    gchar *string_out;
+
+    if (!string_in)
+        string_in = "";
 
     /* Check for " and then "" them */
-    parts = g_strsplit (string_in, "\"", -1);
-    string_parts = g_strjoinv ("\"\"", parts);
-    g_strfreev (parts);
+    g_string_truncate (field, 0);
+    for (const gchar *c = string_in; *c; c++)
+    {
+        if (*c == '"')
+            g_string_append_c (field, '"');
+        g_string_append_c (field, *c);
+    }
 
     /* Check for separator string and \n and " in field,
        if so quote field if not already quoted */
-    if (g_strrstr (string_parts, info->separator_str) != NULL)
+    if (g_strrstr (field->str, info->separator_str) != NULL)
         need_quote = TRUE;
-    if (g_strrstr (string_parts, "\n") != NULL)
+    if (strchr (field->str, '\n') != NULL)
         need_quote = TRUE;
-    if (g_strrstr (string_parts, "\"") != NULL)
+    if (strchr (field->str, '"') != NULL)
         need_quote = TRUE;
 
     if (!info->use_quotes && need_quote)
-        string_out = g_strconcat ("\"", string_parts, "\"", NULL);
+    {
+        g_string_append_c (line, '"');
+        g_string_append_len (line, field->str, field->len);
+        g_string_append_c (line, '"');
+    }
     else
-        string_out = g_strdup (string_parts);
+        g_string_append_len (line, field->str, field->len);
+}
 
-    g_free (string_parts);
-    return string_out;
+/* Each account's full name is built once per export. */
+static const gchar*
+cached_full_name (Account *account, CsvExportInfo *info)
+{
+    gchar *name = g_hash_table_lookup (info->full_names, account);
+    if (!name)
+    {
+        name = gnc_account_get_full_name (account);
+        g_hash_table_insert (info->full_names, account, name);
+    }
+    return name;
 }
 
 /******************** Helper functions *********************/
 
 // Transaction Date
-static gchar*
-add_date (gchar *so_far, Transaction *trans, CsvExportInfo *info)
+static void
+add_date (GString *line, Transaction *trans, CsvExportInfo *info)
 {
-    gchar *date = qof_print_date (xaccTransGetDate (trans));
-    gchar *result = g_strconcat (so_far, info->end_sep, date, info->mid_sep, NULL);
-    g_free (date);
-    g_free (so_far);
-    return result;
+    char date[MAX_DATE_LENGTH + 1];
+    memset (date, 0, sizeof(date));
+    qof_print_date_buff (date, MAX_DATE_LENGTH, xaccTransGetDate (trans));
+    g_string_append (line, info->end_sep);
+    g_string_append (line, date);
+    g_string_append (line, info->mid_sep);
 }
 
 
 // Transaction GUID
-static gchar*
-add_guid (gchar *so_far, Transaction *trans, CsvExportInfo *info)
+static void
+add_guid (GString *line, Transaction *trans, CsvExportInfo *info)
 {
-    gchar *result;
-    gchar *guid;
-
-    guid = guid_to_string (xaccTransGetGUID (trans));
-    result = g_strconcat (so_far, guid, info->mid_sep, NULL);
-    g_free (guid);
-    g_free (so_far);
-    return result;
+    gchar guid[GUID_ENCODING_LENGTH + 1];
+
+    guid_to_string_buff (xaccTransGetGUID (trans), guid);
+    g_string_append (line, guid);
+    g_string_append (line, info->mid_sep);
 }
 
 // Reconcile Date
-static gchar*
-add_reconcile_date (gchar *so_far, Split *split, CsvExportInfo *info)
+static void
+add_reconcile_date (GString *line, Split *split, CsvExportInfo *info)
 {
-    gchar *result;
-
     if (xaccSplitGetReconcile (split) == YREC)
     {
         time64 t = xaccSplitGetDateReconciled (split);
         char str_rec_date[MAX_DATE_LENGTH + 1];
         memset (str_rec_date, 0, sizeof(str_rec_date));
         qof_print_date_buff (str_rec_date, MAX_DATE_LENGTH, t);
-        result = g_strconcat (so_far, str_rec_date, info->mid_sep, NULL);
+        g_string_append (line, str_rec_date);
     }
-    else
-        result = g_strconcat (so_far, info->mid_sep, NULL);
-
-    g_free (so_far);
-    return result;
+    g_string_append (line, info->mid_sep);
 }
 
 // Account Name short or Long
-static gchar*
-add_account_name (gchar *so_far, Split *split, gboolean full, CsvExportInfo *info)
+static void
+add_account_name (GString *line, Split *split, gboolean full, CsvExportInfo *info)
 {
-    gchar       *name = NULL;
-    gchar       *conv;
-    gchar       *result;
-
     Account     *account = xaccSplitGetAccount (split);
     if (full)
-        name = gnc_account_get_full_name (account);
+        csv_txn_append_field_string (line, cached_full_name (account, info), info);
     else
-        name = g_strdup (xaccAccountGetName (account));
-    conv = csv_txn_test_field_string (info, name);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (name);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+        csv_txn_append_field_string (line, xaccAccountGetName (account), info);
+    g_string_append (line, info->mid_sep);
 }
 
 // Number
-static gchar*
-add_number (gchar *so_far, Transaction *trans, CsvExportInfo *info)
+static void
+add_number (GString *line, Transaction *trans, CsvExportInfo *info)
 {
-    const gchar *num;
-    gchar       *conv;
-    gchar       *result;
-
-    num = xaccTransGetNum (trans) ? xaccTransGetNum (trans) : "" ;
-    conv = csv_txn_test_field_string (info, num);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    csv_txn_append_field_string (line, xaccTransGetNum (trans), info);
+    g_string_append (line, info->mid_sep);
 }
 
 // Description
-static gchar*
-add_description (gchar *so_far, Transaction *trans, CsvExportInfo *info)
+static void
+add_description (GString *line, Transaction *trans, CsvExportInfo *info)
 {
-    const gchar *desc;
-    gchar       *conv;
-    gchar       *result;
-
-    desc = xaccTransGetDescription (trans) ? xaccTransGetDescription (trans) : "" ;
-    conv = csv_txn_test_field_string (info, desc);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    csv_txn_append_field_string (line, xaccTransGetDescription (trans), info);
+    g_string_append (line, info->mid_sep);
 }
 
 // Notes
-static gchar*
-add_notes (gchar *so_far, Transaction *trans, CsvExportInfo *info)
+static void
+add_notes (GString *line, Transaction *trans, CsvExportInfo *info)
 {
-    const gchar *notes;
-    gchar       *conv;
-    gchar       *result;
-
-    notes = xaccTransGetNotes (trans) ? xaccTransGetNotes (trans) : "" ;
-    conv = csv_txn_test_field_string (info, notes);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    csv_txn_append_field_string (line, xaccTransGetNotes (trans), info);
+    g_string_append (line, info->mid_sep);
 }
 
 // Void reason
-static gchar*
-add_void_reason (gchar *so_far, Transaction *trans, CsvExportInfo *info)
+static void
+add_void_reason (GString *line, Transaction *trans, CsvExportInfo *info)
 {
-    gchar       *result;
-
     if (xaccTransGetVoidStatus (trans))
-    {
-        const gchar *void_reason = xaccTransGetVoidReason (trans);
-        gchar *conv = csv_txn_test_field_string (info, void_reason);
-        result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-        g_free (conv);
-    }
-    else
-        result = g_strconcat (so_far, info->mid_sep, NULL);
-
-    g_free (so_far);
-    return result;
+        csv_txn_append_field_string (line, xaccTransGetVoidReason (trans), info);
+    g_string_append (line, info->mid_sep);
 }
 
 // Memo
-static gchar*
-add_memo (gchar *so_far, Split *split, CsvExportInfo *info)
+static void
+add_memo (GString *line, Split *split, CsvExportInfo *info)
 {
-    const gchar *memo;
-    gchar       *conv;
-    gchar       *result;
-
-    memo = xaccSplitGetMemo (split) ? xaccSplitGetMemo (split) : "" ;
-    conv = csv_txn_test_field_string (info, memo);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    csv_txn_append_field_string (line, xaccSplitGetMemo (split), info);
+    g_string_append (line, info->mid_sep);
 }
 
 // Full Category Path or Not
-static gchar*
-add_category (gchar *so_far, Split *split, gboolean full, CsvExportInfo *info)
+static void
+add_category (GString *line, Split *split, gboolean full, CsvExportInfo *info)
 {
-    gchar       *cat;
-    gchar       *conv;
-    gchar       *result;
+    Split *other = NULL;
 
-    if (full)
-        cat = xaccSplitGetCorrAccountFullName (split);
+    /* The same choice xaccSplitGetCorrAccountFullName makes, but with
+     * the full name taken from the cache. */
+    if (full && xaccTransCountSplits (xaccSplitGetParent (split)) <= 2)
+        other = xaccSplitGetOtherSplit (split);
+
+    if (other)
+        csv_txn_append_field_string (line,
+                                     cached_full_name (xaccSplitGetAccount (other), info),
+                                     info);
     else
-        cat = g_strdup(xaccSplitGetCorrAccountName (split));
-
-    conv = csv_txn_test_field_string (info, cat);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (cat);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+        /* Either the short name or "-- Split Transaction --" */
+        csv_txn_append_field_string (line, xaccSplitGetCorrAccountName (split), info);
+    g_string_append (line, info->mid_sep);
 }
 
 // Action
-static gchar*
-add_action (gchar *so_far, Split *split, CsvExportInfo *info)
+static void
+add_action (GString *line, Split *split, CsvExportInfo *info)
 {
-    const gchar *action = xaccSplitGetAction (split);
-    gchar *conv = csv_txn_test_field_string (info, action);
-    gchar *result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    csv_txn_append_field_string (line, xaccSplitGetAction (split), info);
+    g_string_append (line, info->mid_sep);
 }
 
 // Reconcile
-static gchar*
-add_reconcile (gchar *so_far, Split *split, CsvExportInfo *info)
+static void
+add_reconcile (GString *line, Split *split, CsvExportInfo *info)
 {
-    const gchar *recon;
-    gchar       *conv;
-    gchar       *result;
-
-    recon = gnc_get_reconcile_str (xaccSplitGetReconcile (split));
-    conv = csv_txn_test_field_string (info, recon);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    const gchar *recon = gnc_get_reconcile_str (xaccSplitGetReconcile (split));
+    csv_txn_append_field_string (line, recon, info);
+    g_string_append (line, info->mid_sep);
 }
 
 // Transaction commodity
-static gchar*
-add_commodity (gchar *so_far, Transaction *trans, CsvExportInfo *info)
+static void
+add_commodity (GString *line, Transaction *trans, CsvExportInfo *info)
 {
-    const gchar *comm_m;
-    gchar       *conv;
-    gchar       *result;
-
-    comm_m = gnc_commodity_get_unique_name (xaccTransGetCurrency (trans));
-
-    conv = csv_txn_test_field_string (info, comm_m);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    const gchar *comm_m = gnc_commodity_get_unique_name (xaccTransGetCurrency (trans));
+    csv_txn_append_field_string (line, comm_m, info);
+    g_string_append (line, info->mid_sep);
 }
 
 // Amount with Symbol or not
-static gchar*
-add_amount (gchar *so_far, Split *split, gboolean t_void, gboolean symbol, CsvExportInfo *info)
+static void
+add_amount (GString *line, Split *split, gboolean t_void, gboolean symbol, CsvExportInfo *info)
 {
     const gchar *amt;
-    gchar       *conv;
-    gchar       *result;
 
     if (t_void)
         amt = xaccPrintAmount (xaccSplitVoidFormerAmount (split), gnc_split_amount_print_info (split, symbol));
     else
         amt = xaccPrintAmount (xaccSplitGetAmount (split), gnc_split_amount_print_info (split, symbol));
-    conv = csv_txn_test_field_string (info, amt);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    csv_txn_append_field_string (line, amt, info);
+    g_string_append (line, info->mid_sep);
 }
 
 // Share Price / Conversion factor
-static gchar*
-add_rate (gchar *so_far, Split *split, gboolean t_void, CsvExportInfo *info)
+static void
+add_rate (GString *line, Split *split, gboolean t_void, CsvExportInfo *info)
 {
     const gchar *amt;
     gnc_commodity *curr = xaccAccountGetCommodity (xaccSplitGetAccount (split));
-    gchar       *conv;
-    gchar       *result;
 
     if (t_void)
         amt = xaccPrintAmount (gnc_numeric_zero(), gnc_default_price_print_info (curr));
     else
         amt = xaccPrintAmount (xaccSplitGetSharePrice (split), gnc_default_price_print_info (curr));
 
-    conv = csv_txn_test_field_string (info, amt);
-    result = g_strconcat (so_far, conv, info->end_sep, EOLSTR, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    csv_txn_append_field_string (line, amt, info);
+    g_string_append (line, info->end_sep);
+    g_string_append (line, EOLSTR);
 }
 
 // Share Price / Conversion factor
-static gchar*
-add_price (gchar *so_far, Split *split, gboolean t_void, CsvExportInfo *info)
+static void
+add_price (GString *line, Split *split, gboolean t_void, CsvExportInfo *info)
 {
     const gchar *string_amount;
     gnc_commodity *curr = xaccAccountGetCommodity (xaccSplitGetAccount (split));
-    gchar       *conv;
-    gchar       *result;
 
     if (t_void)
     {
@@ -390,70 +333,66 @@ add_price (gchar *so_far, Split *split, gboolean t_void, CsvExportInfo *info)
     else
         string_amount = xaccPrintAmount (xaccSplitGetSharePrice (split), gnc_default_price_print_info (curr));
 
-    conv = csv_txn_test_field_string (info, string_amount);
-    result = g_strconcat (so_far, conv, info->end_sep, EOLSTR, NULL);
-    g_free (conv);
-    return result;
+    csv_txn_append_field_string (line, string_amount, info);
+    g_string_append (line, info->end_sep);
+    g_string_append (line, EOLSTR);
 }
 
 /******************************************************************************/
 
-static gchar*
-make_simple_trans_line (Account *acc, Transaction *trans, Split *split, CsvExportInfo *info)
+static void
+make_simple_trans_line (GString *line, Transaction *trans, Split *split, CsvExportInfo *info)
 {
     gboolean t_void = xaccTransGetVoidStatus (trans);
 
-    gchar *exp_line = g_strdup("");
-    exp_line = add_date (exp_line, trans, info);
-    exp_line = add_account_name (exp_line, split, TRUE, info);
-    exp_line = add_number (exp_line, trans, info);
-    exp_line = add_description (exp_line, trans, info);
-    exp_line = add_category (exp_line, split, TRUE, info);
-    exp_line = add_reconcile (exp_line, split, info);
-    exp_line = add_amount (exp_line, split, t_void, TRUE, info);
-    exp_line = add_amount (exp_line, split, t_void, FALSE, info);
-    exp_line = add_rate (exp_line, split, t_void, info);
-    return exp_line;
+    add_date (line, trans, info);
+    add_account_name (line, split, TRUE, info);
+    add_number (line, trans, info);
+    add_description (line, trans, info);
+    add_category (line, split, TRUE, info);
+    add_reconcile (line, split, info);
+    add_amount (line, split, t_void, TRUE, info);
+    add_amount (line, split, t_void, FALSE, info);
+    add_rate (line, split, t_void, info);
 }
 
-static gchar*
-make_split_part (gchar* exp_line, Split *split, gboolean t_void, CsvExportInfo *info)
+static void
+make_split_part (GString *line, Split *split, gboolean t_void, CsvExportInfo *info)
 {
-    exp_line = add_action (exp_line, split, info);
-    exp_line = add_memo (exp_line, split, info);
-    exp_line = add_account_name (exp_line, split, TRUE, info);
-    exp_line = add_account_name (exp_line, split, FALSE, info);
-    exp_line = add_amount (exp_line, split, t_void, TRUE, info);
-    exp_line = add_amount (exp_line, split, t_void, FALSE, info);
-    exp_line = add_reconcile (exp_line, split, info);
-    exp_line = add_reconcile_date (exp_line, split, info);
-    exp_line = add_price (exp_line, split, t_void, info);
-    return exp_line;
+    add_action (line, split, info);
+    add_memo (line, split, info);
+    add_account_name (line, split, TRUE, info);
+    add_account_name (line, split, FALSE, info);
+    add_amount (line, split, t_void, TRUE, info);
+    add_amount (line, split, t_void, FALSE, info);
+    add_reconcile (line, split, info);
+    add_reconcile_date (line, split, info);
+    add_price (line, split, t_void, info);
 }
 
-static gchar*
-make_complex_trans_line (Account *acc, Transaction *trans, Split *split, CsvExportInfo *info)
+static void
+make_complex_trans_line (GString *line, Transaction *trans, Split *split, CsvExportInfo *info)
 {
-    gchar *exp_line = g_strdup("");
-    exp_line = add_date (exp_line, trans, info);
-    exp_line = add_guid (exp_line, trans, info);
-    exp_line = add_number (exp_line, trans, info);
-    exp_line = add_description (exp_line, trans, info);
-    exp_line = add_notes (exp_line, trans, info);
-    exp_line = add_commodity (exp_line, trans, info);
-    exp_line = add_void_reason (exp_line, trans, info);
-    return make_split_part (exp_line, split, xaccTransGetVoidStatus (trans), info);
+    add_date (line, trans, info);
+    add_guid (line, trans, info);
+    add_number (line, trans, info);
+    add_description (line, trans, info);
+    add_notes (line, trans, info);
+    add_commodity (line, trans, info);
+    add_void_reason (line, trans, info);
+    make_split_part (line, split, xaccTransGetVoidStatus (trans), info);
 }
 
-static gchar*
-make_complex_split_line (Transaction *trans, Split *split, CsvExportInfo *info)
+static void
+make_complex_split_line (GString *line, Transaction *trans, Split *split, CsvExportInfo *info)
 {
     /* Pure split lines don't have any transaction information,
      * so start with empty fields for all transaction columns.
      */
-    gchar *result = g_strconcat (info->end_sep, info->mid_sep, info->mid_sep, info->mid_sep,
-            info->mid_sep, info->mid_sep, info->mid_sep, info->mid_sep, NULL);
-    return make_split_part (result, split, xaccTransGetVoidStatus (trans), info);
+    g_string_append (line, info->end_sep);
+    for (int i = 0; i < 7; i++)
+        g_string_append (line, info->mid_sep);
+    make_split_part (line, split, xaccTransGetVoidStatus (trans), info);
 }
 
 
@@ -469,6 +408,7 @@ void account_splits (CsvExportInfo *info, Account *acc, FILE *fh )
     GSList  *p1, *p2;
     GList   *splits;
     QofBook *book;
+    GString *line = g_string_sized_new (256);
 
     // Setup the query for normal transaction export
     if (info->export_type == XML_EXPORT_TRANS)
@@ -497,15 +437,14 @@ void account_splits (CsvExportInfo *info, Account *acc, FILE *fh )
         Split       *t_split;
         int          nSplits;
         int          cnt;
-        gchar       *line;
 
         split = splits->data;
         trans = xaccSplitGetParent (split);
         nSplits = xaccTransCountSplits (trans);
         s_list = xaccTransGetSplitList (trans);
 
-        // Look for trans already exported in trans_list
-        if (g_list_find (info->trans_list, trans) != NULL)
+        // Look for trans already exported in trans_set
+        if (g_hash_table_contains (info->trans_set, trans))
             continue;
 
         // Look for blank split
@@ -515,28 +454,26 @@ void account_splits (CsvExportInfo *info, Account *acc, FILE *fh )
         // This will be a simple layout equivalent to a single line register view.
         if (info->simple_layout)
         {
-            line = make_simple_trans_line (acc, trans, split, info);
+            make_simple_trans_line (line, trans, split, info);
 
             /* Write to file */
-            if (!write_line_to_file (fh, line))
+            if (!write_gstring_to_file (fh, line))
             {
                 info->failed = TRUE;
                 break;
             }
-            g_free (line);
             continue;
         }
 
         // Complex Transaction Line.
-        line = make_complex_trans_line (acc, trans, split, info);
+        make_complex_trans_line (line, trans, split, info);
 
         /* Write to file */
-        if (!write_line_to_file (fh, line))
+        if (!write_gstring_to_file (fh, line))
         {
             info->failed = TRUE;
             break;
         }
-        g_free (line);
 
         /* Loop through the list of splits for the Transaction */
         node = s_list;
@@ -549,22 +486,21 @@ void account_splits (CsvExportInfo *info, Account *acc, FILE *fh )
             if (split != t_split)
             {
             // Complex Split Line.
-                line = make_complex_split_line (trans, t_split, info);
+                make_complex_split_line (line, trans, t_split, info);
 
-                if (!write_line_to_file (fh, line))
+                if (!write_gstring_to_file (fh, line))
                     info->failed = TRUE;
-
-                g_free (line);
             }
 
             cnt++;
             node = node->next;
         }
-        info->trans_list = g_list_prepend (info->trans_list, trans); // add trans to trans_list
+        g_hash_table_add (info->trans_set, trans); // add trans to trans_set
     }
     if (info->export_type == XML_EXPORT_TRANS)
         qof_query_destroy (info->query);
     g_list_free (splits);
+    g_string_free (line, TRUE);
 }
 
 
@@ -640,6 +576,11 @@ void csv_transactions_export (CsvExportInfo *info)
         }
         g_free (header);
 
+        info->trans_set = g_hash_table_new (g_direct_hash, g_direct_equal);
+        info->full_names = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                                  NULL, g_free);
+        info->field = g_string_sized_new (64);
+
         if (info->export_type == XML_EXPORT_TRANS)
         {
             /* Go through list of accounts */
@@ -653,7 +594,12 @@ void csv_transactions_export (CsvExportInfo *info)
         else
             account_splits (info, info->account, fh);
 
-        g_list_free (info->trans_list); // free trans_list
+        g_hash_table_destroy (info->trans_set); // free trans_set
+        info->trans_set = NULL;
+        g_hash_table_destroy (info->full_names);
+        info->full_names = NULL;
+        g_string_free (info->field, TRUE);
+        info->field = NULL;
     }
     else
         info->failed = TRUE;
@@ -290,7 +290,8 @@ std::string GncImportPrice::verify_essentials (void)
         return std::string();
 }
 
-Result GncImportPrice::create_price (QofBook* book, GNCPriceDB *pdb, bool over)
+Result GncImportPrice::create_price (QofBook* book, GNCPriceDB *pdb, bool over,
+                                     PriceList **batch, std::set<GNCPrice*> *replaced)
 {
     /* Gently refuse to create the price if the basics are not set correctly
      * This should have been tested before calling this function though!
@@ -314,10 +315,20 @@ Result GncImportPrice::create_price (QofBook* book, GNCPriceDB *pdb, bool over)
     if ((old_price != nullptr) && (over == true))
     {
         DEBUG("Over write");
-        gnc_pricedb_remove_price (pdb, old_price);
-        gnc_price_unref (old_price);
+        if (!replaced)
+        {
+            gnc_pricedb_remove_price (pdb, old_price);
+            gnc_price_unref (old_price);
+            ret_val = REPLACED;
+        }
+        /* The price stays in pdb until the caller removes the lot, so a
+         * later line for the same day finds it again. That line is
+         * added like any other, for the batch to sort out. */
+        else if (replaced->insert (old_price).second)
+            ret_val = REPLACED;
+        else
+            gnc_price_unref (old_price);
         old_price = nullptr;
-        ret_val = REPLACED;
     }
 
     char date_str [MAX_DATE_LENGTH + 1];
@@ -348,6 +359,12 @@ Result GncImportPrice::create_price (QofBook* book, GNCPriceDB *pdb, bool over)
         gnc_price_set_typestr (price, PRICE_TYPE_LAST);
         gnc_price_commit_edit (price);
 
+        if (batch)
+        {
+            *batch = g_list_prepend (*batch, price);
+            return ret_val;
+        }
+
         bool perr = gnc_pricedb_add_price (pdb, price);
 
         gnc_price_unref (price);
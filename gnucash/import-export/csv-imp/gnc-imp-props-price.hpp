@@ -38,6 +38,7 @@ extern "C" {
 #include <string>
 #include <map>
 #include <memory>
+#include <set>
 #include <boost/optional.hpp>
 #include <gnc-datetime.hpp>
 #include <gnc-numeric.hpp>
@@ -93,7 +94,14 @@ public:
     void set_currency_format (int currency_format) { m_currency_format = currency_format ;}
     void reset (GncPricePropType prop_type);
     std::string verify_essentials (void);
-    Result create_price (QofBook* book, GNCPriceDB *pdb, bool over);
+    /** Create the price. If batch is given the new price is prepended to it
+     *  for the caller to add with gnc_pricedb_add_prices_bulk, otherwise it is
+     *  added to pdb right away. Likewise if replaced is given a price being
+     *  overwritten is put in it, with a reference, for the caller to remove
+     *  with gnc_pricedb_remove_prices before adding the batch. */
+    Result create_price (QofBook* book, GNCPriceDB *pdb, bool over,
+                         PriceList **batch = nullptr,
+                         std::set<GNCPrice*> *replaced = nullptr);
 
     gnc_commodity* get_from_commodity () { if (m_from_commodity) return *m_from_commodity; else return nullptr; }
     void set_from_commodity (gnc_commodity* comm) { if (comm) m_from_commodity = comm; else m_from_commodity = boost::none; }
@@ -44,6 +44,7 @@ extern "C" {
 #include <exception>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <boost/locale.hpp>
@@ -118,10 +119,11 @@ GncNumeric parse_amount (const std::string &str, int currency_format)
         return GncNumeric{};
 
     /* Strings otherwise containing not digits will be considered invalid */
-    if(!boost::regex_search(str, boost::regex("[0-9]")))
+    static const boost::regex digit_re ("[0-9]");
+    if(!boost::regex_search(str, digit_re))
         throw std::invalid_argument (_("Value doesn't appear to contain a valid number."));
 
-    auto expr = boost::make_u32regex("[[:Sc:]]");
+    static const auto expr = boost::make_u32regex("[[:Sc:]]");
     std::string str_no_symbols = boost::u32regex_replace(str, expr, "");
 
     /* Convert based on user chosen currency format */
@@ -149,6 +151,24 @@ GncNumeric parse_amount (const std::string &str, int currency_format)
     return GncNumeric(val);
 }
 
+GncDate GncImpParseCache::parse_date (const std::string& str, int date_format)
+{
+    auto& dates = m_dates[date_format];
+    auto it = dates.find (str);
+    if (it == dates.end())
+        it = dates.emplace (str, GncDate (str, GncDate::c_formats[date_format].m_fmt)).first;
+    return it->second;
+}
+
+GncNumeric GncImpParseCache::parse_amount (const std::string& str, int currency_format)
+{
+    auto& amounts = m_amounts[currency_format];
+    auto it = amounts.find (str);
+    if (it == amounts.end())
+        it = amounts.emplace (str, ::parse_amount (str, currency_format)).first;
+    return it->second;
+}
+
 static char parse_reconciled (const std::string& reconcile)
 {
     if (g_strcmp0 (reconcile.c_str(), gnc_get_reconcile_str(NREC)) == 0) // Not reconciled
@@ -212,10 +232,11 @@ static GncNumeric parse_price (const std::string &str)
         return GncNumeric{};
 
     /* Strings otherwise containing not digits will be considered invalid */
-    if(!boost::regex_search(str, boost::regex("[0-9]")))
+    static const boost::regex digit_re ("[0-9]");
+    if(!boost::regex_search(str, digit_re))
         throw std::invalid_argument (_("Value doesn't appear to contain a valid number."));
 
-    auto expr = boost::make_u32regex("[[:Sc:]]");
+    static const auto expr = boost::make_u32regex("[[:Sc:]]");
     std::string str_no_symbols = boost::u32regex_replace(str, expr, "");
 
     /* Convert based on user chosen currency format */
@@ -248,7 +269,10 @@ void GncPreTrans::set (GncTransPropType prop_type, const std::string& value)
 
             case GncTransPropType::DATE:
                 m_date = boost::none;
-                m_date = GncDate(value, GncDate::c_formats[m_date_format].m_fmt); // Throws if parsing fails
+                if (m_cache)
+                    m_date = m_cache->parse_date (value, m_date_format); // Throws if parsing fails
+                else
+                    m_date = GncDate(value, GncDate::c_formats[m_date_format].m_fmt); // Throws if parsing fails
                 break;
 
             case GncTransPropType::NUM:
@@ -406,6 +430,20 @@ std::string GncPreTrans::errors ()
     return gen_err_str (m_errors);
 }
 
+GncDate GncPreSplit::parse_date (const std::string& str)
+{
+    if (m_cache)
+        return m_cache->parse_date (str, m_date_format);
+    return GncDate (str, GncDate::c_formats[m_date_format].m_fmt);
+}
+
+GncNumeric GncPreSplit::parse_amount (const std::string& str)
+{
+    if (m_cache)
+        return m_cache->parse_amount (str, m_currency_format);
+    return ::parse_amount (str, m_currency_format);
+}
+
 void GncPreSplit::set (GncTransPropType prop_type, const std::string& value)
 {
     try
@@ -465,11 +503,11 @@ void GncPreSplit::set (GncTransPropType prop_type, const std::string& value)
 
             case GncTransPropType::DEPOSIT:
                 m_deposit = boost::none;
-                m_deposit = parse_amount (value, m_currency_format); // Will throw if parsing fails
+                m_deposit = parse_amount (value); // Will throw if parsing fails
                 break;
             case GncTransPropType::WITHDRAWAL:
                 m_withdrawal = boost::none;
-                m_withdrawal = parse_amount (value, m_currency_format); // Will throw if parsing fails
+                m_withdrawal = parse_amount (value); // Will throw if parsing fails
                 break;
 
             case GncTransPropType::PRICE:
@@ -490,15 +528,13 @@ void GncPreSplit::set (GncTransPropType prop_type, const std::string& value)
             case GncTransPropType::REC_DATE:
                 m_rec_date = boost::none;
                 if (!value.empty())
-                    m_rec_date = GncDate (value,
-                                          GncDate::c_formats[m_date_format].m_fmt); // Throws if parsing fails
+                    m_rec_date = parse_date (value); // Throws if parsing fails
                 break;
 
             case GncTransPropType::TREC_DATE:
                 m_trec_date = boost::none;
                 if (!value.empty())
-                    m_trec_date = GncDate (value,
-                                           GncDate::c_formats[m_date_format].m_fmt); // Throws if parsing fails
+                    m_trec_date = parse_date (value); // Throws if parsing fails
                 break;
 
             default:
@@ -551,14 +587,14 @@ void GncPreSplit::add (GncTransPropType prop_type, const std::string& value)
         switch (prop_type)
         {
             case GncTransPropType::DEPOSIT:
-                num_val = parse_amount (value, m_currency_format); // Will throw if parsing fails
+                num_val = parse_amount (value); // Will throw if parsing fails
                 if (m_deposit)
                     num_val += *m_deposit;
                 m_deposit = num_val;
                 break;
 
             case GncTransPropType::WITHDRAWAL:
-                num_val = parse_amount (value, m_currency_format); // Will throw if parsing fails
+                num_val = parse_amount (value); // Will throw if parsing fails
                 if (m_withdrawal)
                     num_val += *m_withdrawal;
                 m_withdrawal = num_val;
@@ -40,6 +40,7 @@ extern "C" {
 #include <string>
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <boost/optional.hpp>
 #include <gnc-datetime.hpp>
 #include <gnc-numeric.hpp>
@@ -107,10 +108,29 @@ GncTransPropType sanitize_trans_prop (GncTransPropType prop, bool multi_split);
 gnc_commodity* parse_commodity (const std::string& comm_str);
 GncNumeric parse_amount (const std::string &str, int currency_format);
 
+/** Remembers what the date and amount cells of an import parsed to.
+ *  Export files repeat the same dates and amounts over and over, and
+ *  the assistant reparses a column on every change to it, so this way each
+ *  distinct string is parsed only once per format. Strings that fail to
+ *  parse are not remembered; they throw again each time.
+ */
+class GncImpParseCache
+{
+public:
+    GncDate parse_date (const std::string& str, int date_format);
+    GncNumeric parse_amount (const std::string& str, int currency_format);
+
+private:
+    std::map<int, std::unordered_map<std::string, GncDate>> m_dates;
+    std::map<int, std::unordered_map<std::string, GncNumeric>> m_amounts;
+};
+
 struct GncPreTrans
 {
 public:
-    GncPreTrans(int date_format) : m_date_format{date_format} {};
+    GncPreTrans(int date_format,
+                std::shared_ptr<GncImpParseCache> cache = nullptr) :
+        m_date_format{date_format}, m_cache{cache} {};
 
     void set (GncTransPropType prop_type, const std::string& value);
     void set_date_format (int date_format) { m_date_format = date_format ;}
@@ -138,6 +158,7 @@ public:
 
 private:
     int m_date_format;
+    std::shared_ptr<GncImpParseCache> m_cache;
     boost::optional<std::string> m_differ;
     boost::optional<GncDate> m_date;
     boost::optional<std::string> m_num;
@@ -153,8 +174,10 @@ private:
 struct GncPreSplit
 {
 public:
-    GncPreSplit (int date_format, int currency_format) : m_date_format{date_format},
-        m_currency_format{currency_format}{};
+    GncPreSplit (int date_format, int currency_format,
+                 std::shared_ptr<GncImpParseCache> cache = nullptr) :
+        m_date_format{date_format}, m_currency_format{currency_format},
+        m_cache{cache} {};
     void set (GncTransPropType prop_type, const std::string& value);
     void reset (GncTransPropType prop_type);
     void add (GncTransPropType prop_type, const std::string& value);
@@ -168,8 +191,12 @@ public:
     std::string errors(bool check_accts_mapped);
 
 private:
+    GncDate parse_date (const std::string& str);
+    GncNumeric parse_amount (const std::string& str);
+
     int m_date_format;
     int m_currency_format;
+    std::shared_ptr<GncImpParseCache> m_cache;
     boost::optional<std::string> m_action;
     boost::optional<Account*> m_account;
     boost::optional<GncNumeric> m_deposit;
@@ -554,7 +554,8 @@ static void price_properties_verify_essentials (std::vector<parse_line_t>::itera
         throw std::invalid_argument(error_message);
 }
 
-void GncPriceImport::create_price (std::vector<parse_line_t>::iterator& parsed_line)
+void GncPriceImport::create_price (std::vector<parse_line_t>::iterator& parsed_line,
+                                   PriceList **batch, std::set<GNCPrice*> *replaced)
 {
     StrVec line;
     std::string error_message;
@@ -610,7 +611,7 @@ void GncPriceImport::create_price (std::vector<parse_line_t>::iterator& parsed_l
         GNCPriceDB *pdb = gnc_pricedb_get_db (book);
 
         /* If all went well, add this price to the list. */
-        auto price_created = price_props->create_price (book, pdb, m_over_write);
+        auto price_created = price_props->create_price (book, pdb, m_over_write, batch, replaced);
         if (price_created == ADDED)
             m_prices_added++;
         else if (price_created == DUPLICATED)
@@ -643,6 +644,12 @@ void GncPriceImport::create_prices ()
     m_prices_duplicated = 0;
     m_prices_replaced = 0;
 
+    /* The new prices are collected and added to the price database in one
+     * go, which is much faster than adding them one by one. So are the
+     * prices they overwrite removed, beforehand. */
+    PriceList *batch = nullptr;
+    std::set<GNCPrice*> replaced;
+
     /* Iterate over all parsed lines */
     for (auto parsed_lines_it = m_parsed_lines.begin();
             parsed_lines_it != m_parsed_lines.end();
@@ -653,7 +660,28 @@ void GncPriceImport::create_prices ()
             continue;
 
         /* Should not throw anymore, otherwise verify needs revision */
-        create_price (parsed_lines_it);
+        create_price (parsed_lines_it, &batch, &replaced);
+    }
+
+    auto pdb = gnc_pricedb_get_db (gnc_get_current_book());
+    if (!replaced.empty())
+    {
+        GList *doomed = nullptr;
+        for (auto price : replaced)
+            doomed = g_list_prepend (doomed, price);
+        gnc_pricedb_remove_prices (pdb, doomed);
+        g_list_free_full (doomed, (GDestroyNotify)gnc_price_unref);
+    }
+
+    if (batch)
+    {
+        int batch_size = g_list_length (batch);
+        int added = gnc_pricedb_add_prices_bulk (pdb, batch);
+        /* Lines for a day already given by an earlier line are duplicates. */
+        auto dropped = std::min (batch_size - added, m_prices_added);
+        m_prices_added -= dropped;
+        m_prices_duplicated += dropped;
+        g_list_free_full (batch, (GDestroyNotify)gnc_price_unref);
     }
     PINFO("Number of lines is %d, added %d, duplicated %d, replaced %d",
          (int)m_parsed_lines.size(), m_prices_added, m_prices_duplicated, m_prices_replaced);
@@ -193,7 +193,7 @@ void GncTxImport::base_account (Account* base_account)
                             GncTransPropType::NONE);
 
         /* Set default account for each line's split properties */
-        for (auto line : m_parsed_lines)
+        for (auto& line : m_parsed_lines)
             std::get<PL_PRESPLIT>(line)->set_account (m_settings.m_base_account);
 
 
@@ -365,6 +365,8 @@ std::string GncTxImport::settings_name () { return m_settings.m_name; }
  */
 void GncTxImport::load_file (const std::string& filename)
 {
+    /* What the old file's cells parsed to is of no use for this one. */
+    m_parse_cache = std::make_shared<GncImpParseCache>();
 
     /* Get the raw data first and handle an error if one occurs. */
     try
@@ -398,14 +400,16 @@ void GncTxImport::tokenize (bool guessColTypes)
 
     uint32_t max_cols = 0;
     m_tokenizer->tokenize();
+    auto old_lines = std::move (m_parsed_lines);
     m_parsed_lines.clear();
-    for (auto tokenized_line : m_tokenizer->get_tokens())
+    for (const auto& tokenized_line : m_tokenizer->get_tokens())
     {
         auto length = tokenized_line.size();
         if (length > 0)
             m_parsed_lines.push_back (std::make_tuple (tokenized_line, std::string(),
-                    std::make_shared<GncPreTrans>(date_format()),
-                    std::make_shared<GncPreSplit>(date_format(), currency_format()),
+                    std::make_shared<GncPreTrans>(date_format(), m_parse_cache),
+                    std::make_shared<GncPreSplit>(date_format(), currency_format(),
+                                                  m_parse_cache),
                     false));
         if (length > max_cols)
             max_cols = length;
@@ -418,14 +422,40 @@ void GncTxImport::tokenize (bool guessColTypes)
         return;
     }
 
+    /* A change of separators or column widths usually leaves most
+     * columns as they were. If the lines still line up with the previous
+     * ones, keep their properties and only reinterpret the columns in
+     * which some cell changed. */
+    auto changed_cols = std::vector<bool> (max_cols, true);
+    if ((old_lines.size() == m_parsed_lines.size()) &&
+        (m_settings.m_column_types.size() == max_cols))
+    {
+        std::fill (changed_cols.begin(), changed_cols.end(), false);
+        for (size_t row = 0; row < m_parsed_lines.size(); row++)
+        {
+            auto& old_input = std::get<PL_INPUT>(old_lines[row]);
+            auto& new_input = std::get<PL_INPUT>(m_parsed_lines[row]);
+            for (uint32_t col = 0; col < max_cols; col++)
+            {
+                auto in_old = col < old_input.size();
+                auto in_new = col < new_input.size();
+                if ((in_old != in_new) || (in_old && old_input[col] != new_input[col]))
+                    changed_cols[col] = true;
+            }
+            old_input = std::move (new_input);
+        }
+        m_parsed_lines = std::move (old_lines);
+    }
+
     m_settings.m_column_types.resize(max_cols, GncTransPropType::NONE);
 
     /* Force reinterpretation of already set columns and/or base_account */
     for (uint32_t i = 0; i < m_settings.m_column_types.size(); i++)
-        set_column_type (i, m_settings.m_column_types[i], true);
+        if (changed_cols[i])
+            set_column_type (i, m_settings.m_column_types[i], true);
     if (m_settings.m_base_account)
     {
-        for (auto line : m_parsed_lines)
+        for (auto& line : m_parsed_lines)
             std::get<PL_PRESPLIT>(line)->set_account (m_settings.m_base_account);
     }
 
@@ -538,7 +568,7 @@ std::string GncTxImport::verify ()
     update_skipped_lines (boost::none, boost::none, boost::none, boost::none);
 
     auto have_line_errors = false;
-    for (auto line : m_parsed_lines)
+    for (const auto& line : m_parsed_lines)
     {
         if (!std::get<PL_SKIP>(line) && !std::get<PL_ERROR>(line).empty())
         {
@@ -927,13 +957,13 @@ GncTxImport::accounts ()
     uint32_t tacct_col = tacct_col_it - m_settings.m_column_types.begin();
 
     /* Iterate over all parsed lines */
-    for (auto parsed_line : m_parsed_lines)
+    for (const auto& parsed_line : m_parsed_lines)
     {
         /* Skip current line if the user specified so */
         if ((std::get<PL_SKIP>(parsed_line)))
             continue;
 
-        auto col_strs = std::get<PL_INPUT>(parsed_line);
+        const auto& col_strs = std::get<PL_INPUT>(parsed_line);
         if ((acct_col_it != m_settings.m_column_types.end()) &&
             (acct_col < col_strs.size()) &&
             !col_strs[acct_col].empty())
@@ -193,6 +193,8 @@ private:
     CsvTransImpSettings m_settings;
     bool m_skip_errors;
     bool m_req_mapped_accts;
+    /* Shared by the properties of all lines, see GncImpParseCache */
+    std::shared_ptr<GncImpParseCache> m_parse_cache = std::make_shared<GncImpParseCache>();
 
     /* The parameters below are only used while creating
      * transactions. They keep state information while processing multi-split
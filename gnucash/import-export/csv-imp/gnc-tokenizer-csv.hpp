@@ -57,6 +57,9 @@ public:
     void set_separators(const std::string& separators);
     int  tokenize() override;
 
+protected:
+    size_t complete_rows_length(const std::string& text) override;
+
 private:
     std::string m_sep_str = ",";
 };
@@ -10,6 +10,9 @@
 #include <algorithm>    // copy
 #include <iterator>     // ostream_operator
 #include <memory>
+#include <cerrno>
+#include <cstdio>
+#include <type_traits>
 
 #include <boost/locale.hpp>
 #include <boost/algorithm/string.hpp>
@@ -99,3 +102,121 @@ GncTokenizer::get_tokens()
 {
     return m_tokenized_contents;
 }
+
+/* How much of the file stream_file reads at a time. */
+static constexpr size_t STREAM_BLOCK_SIZE = 1 << 20;
+
+/* Convert as much of raw as possible, appending the result to utf8 and
+ * leaving in raw only an incomplete character at its end. Like the whole
+ * file conversion in encoding(), bytes that can't be converted are
+ * skipped. */
+static void
+convert_block (GIConv conv, std::string& raw, std::string& utf8, bool at_eof)
+{
+    gchar out[4096];
+    gchar *inbuf = &raw[0];
+    gsize inleft = raw.size();
+
+    while (inleft > 0)
+    {
+        gchar *outbuf = out;
+        gsize outleft = sizeof(out);
+        auto rc = g_iconv (conv, &inbuf, &inleft, &outbuf, &outleft);
+        utf8.append (out, outbuf - out);
+        if (rc != static_cast<gsize>(-1) || errno == E2BIG)
+            continue;
+        if (errno == EINVAL && !at_eof)
+            break;
+        inbuf++;
+        inleft--;
+    }
+    raw.erase (0, raw.size() - inleft);
+}
+
+bool
+GncTokenizer::stream_file(const std::string& path, size_t chunk_rows,
+                          const TokenChunkCb& chunk_cb)
+{
+    using Iconv = std::unique_ptr<std::remove_pointer_t<GIConv>,
+                                  decltype(&g_iconv_close)>;
+
+    std::unique_ptr<FILE, decltype(&fclose)> file {g_fopen (path.c_str(), "rb"),
+                                                   &fclose};
+    if (!file)
+        throw std::ifstream::failure(g_strerror (errno));
+
+    m_imp_file_str = path;
+    m_tokenized_contents.clear();
+
+    Iconv conv {nullptr, &g_iconv_close};
+    std::vector<char> block (STREAM_BLOCK_SIZE);
+    std::string raw, text;
+    bool held_cr = false;
+    bool at_eof = false;
+
+    while (!at_eof)
+    {
+        auto len = fread (block.data(), 1, block.size(), file.get());
+        if (ferror (file.get()))
+            throw std::ifstream::failure(g_strerror (errno));
+        at_eof = feof (file.get());
+        raw.append (block.data(), len);
+
+        if (!conv)
+        {
+            auto guessed_enc = go_guess_encoding (raw.c_str(), raw.length(),
+                                                  m_enc_str.empty() ? "UTF-8" : m_enc_str.c_str(),
+                                                  NULL);
+            if (guessed_enc)
+                m_enc_str = guessed_enc;
+            auto cd = g_iconv_open ("UTF-8", m_enc_str.c_str());
+            if (cd == (GIConv) -1)
+                throw boost::locale::conv::invalid_charset_error(m_enc_str);
+            conv.reset (cd);
+        }
+
+        // Normalize line endings as encoding() does. A block ending in
+        // "\r" may continue with "\n", so that one waits for the next.
+        std::string fresh (held_cr ? "\r" : "");
+        convert_block (conv.get(), raw, fresh, at_eof);
+        held_cr = !at_eof && !fresh.empty() && fresh.back() == '\r';
+        if (held_cr)
+            fresh.pop_back();
+        boost::replace_all (fresh, "\r\n", "\n");
+        boost::replace_all (fresh, "\r", "\n");
+        text.append (fresh);
+
+        auto complete = at_eof ? text.size() : complete_rows_length (text);
+        if (complete == 0)
+            continue;
+        m_utf8_contents.assign (text, 0, complete);
+        text.erase (0, complete);
+        tokenize();
+
+        auto rows = m_tokenized_contents.begin();
+        while (rows != m_tokenized_contents.end())
+        {
+            auto left = static_cast<size_t>(m_tokenized_contents.end() - rows);
+            auto end = rows + (chunk_rows ? std::min (chunk_rows, left) : left);
+            std::vector<StrVec> chunk (std::make_move_iterator (rows),
+                                       std::make_move_iterator (end));
+            rows = end;
+            if (!chunk_cb (chunk))
+            {
+                m_utf8_contents.clear();
+                m_tokenized_contents.clear();
+                return false;
+            }
+        }
+    }
+    m_utf8_contents.clear();
+    m_tokenized_contents.clear();
+    return true;
+}
+
+size_t
+GncTokenizer::complete_rows_length(const std::string& text)
+{
+    auto last_nl = text.rfind ('\n');
+    return last_nl == std::string::npos ? 0 : last_nl + 1;
+}
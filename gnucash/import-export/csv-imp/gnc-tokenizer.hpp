@@ -44,9 +44,14 @@ extern "C" {
 #include <vector>
 #include <string>
 #include <memory>
+#include <functional>
 
 using StrVec = std::vector<std::string>;
 
+/** Receives a chunk of rows from GncTokenizer::stream_file. The rows may
+ * be moved from. Return false to stop reading the file. */
+using TokenChunkCb = std::function<bool(std::vector<StrVec>& rows)>;
+
 /** Enumeration for file formats supported by this importer. */
 enum class GncImpFileFormat {
     UNKNOWN,
@@ -74,7 +79,19 @@ public:
     virtual int  tokenize() = 0;
     const std::vector<StrVec>& get_tokens();
 
+    /** Tokenize a file without loading it: it is read and converted from
+     * encoding() a block at a time, and its rows are handed to chunk_cb
+     * at most chunk_rows at a time. If no encoding was set one is guessed
+     * from the first block. get_tokens() is empty afterwards.
+     * @return false if chunk_cb stopped the reading. */
+    bool stream_file(const std::string& path, size_t chunk_rows,
+                     const TokenChunkCb& chunk_cb);
+
 protected:
+    /** The length of the start of text that holds only complete rows, so
+     * that a block can be tokenized without the rest of the file. */
+    virtual size_t complete_rows_length(const std::string& text);
+
     std::string m_utf8_contents;
     std::vector<StrVec> m_tokenized_contents;
 
@@ -34,6 +34,8 @@
 
 #include <string>
 #include <stdlib.h>     /* getenv */
+#include <glib.h>
+#include <glib/gstdio.h>
 
 
 typedef struct
@@ -182,6 +184,72 @@ static tokenize_csv_test_data comma_separated [] = {
         { NULL, 0, { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL } },
 };
 
+TEST_F (GncTokenizerTest, stream_csv_file)
+{
+
+    auto file = get_filepath ("sample1.csv");
+    std::vector<StrVec> tokens;
+    auto chunks = 0;
+
+    auto done = csv_tok->stream_file (file, 1, [&](std::vector<StrVec>& rows)
+        {
+            chunks++;
+            tokens.insert (tokens.end(), rows.begin(), rows.end());
+            return true;
+        });
+    EXPECT_TRUE(done);
+    EXPECT_EQ(2, chunks);
+    EXPECT_TRUE(csv_tok->get_tokens().empty());
+
+    csv_tok->load_file (file);
+    csv_tok->tokenize();
+    EXPECT_EQ(csv_tok->get_tokens(), tokens);
+}
+
+TEST_F (GncTokenizerTest, stream_csv_file_blocks)
+{
+    /* Enough quoted multi-line fields and CRLF line endings for the
+     * file's blocks to end in the middle of either. */
+    gchar *path = nullptr;
+    auto fd = g_file_open_tmp ("test-tokenizer-XXXXXX.csv", &path, nullptr);
+    ASSERT_NE(-1, fd);
+    g_close (fd, nullptr);
+    const auto num_rows = 200000u;
+    {
+        std::ofstream out (path, std::ios::binary);
+        for (auto i = 0u; i < num_rows; i++)
+            out << i << ",\"first\r\nsecond\"\r\n";
+    }
+
+    auto rows_seen = 0u;
+    auto bad_rows = 0u;
+    csv_tok->stream_file (path, 1000, [&](std::vector<StrVec>& rows)
+        {
+            for (const auto& row : rows)
+            {
+                if (row.size() != 2 || row[0] != std::to_string (rows_seen) ||
+                    row[1] != "first second")
+                    bad_rows++;
+                rows_seen++;
+            }
+            return true;
+        });
+    EXPECT_EQ(num_rows, rows_seen);
+    EXPECT_EQ(0u, bad_rows);
+
+    auto stopped_after = 0u;
+    auto done = csv_tok->stream_file (path, 1000, [&](std::vector<StrVec>& rows)
+        {
+            stopped_after += rows.size();
+            return false;
+        });
+    EXPECT_FALSE(done);
+    EXPECT_EQ(1000u, stopped_after);
+
+    g_unlink (path);
+    g_free (path);
+}
+
 TEST_F (GncTokenizerTest, tokenize_comma_sep)
 {
     test_gnc_tokenize_helper (",", comma_separated);
@@ -50,24 +50,6 @@ static QofLogModule log_module = GNC_MOD_IMPORT;
 
 #define GNC_PREFS_GROUP "dialogs.import.generic.account-picker"
 
-typedef struct
-{
-    Account* partial_match;
-    int count;
-    const char* online_id;
-} AccountOnlineMatch;
-
-static Account*
-partial_match_if_valid (AccountOnlineMatch *match)
-{
-    if (match->partial_match && match->count == 1)
-        return match->partial_match;
-    else
-        PERR("Online ID %s partially matches %d accounts and fully matches none",
-             match->online_id, match->count);
-    return NULL;
-}
-
 /*-******************************************************************\
  * Functions needed by gnc_import_select_account
  *
@@ -93,74 +75,6 @@ static AccountPickerDialog* gnc_import_new_account_picker(void)
 }
 
 
-/**************************************************
- * test_acct_online_id_match
- *
- * test for match of account online_ids.
- **************************************************/
-static gpointer test_acct_online_id_match(Account *acct, gpointer data)
-{
-    AccountOnlineMatch *match = (AccountOnlineMatch*)data;
-    const char *acct_online_id = gnc_import_get_acc_online_id(acct);
-    int acct_len, match_len;
-
-    if (acct_online_id == NULL || match->online_id == NULL)
-        return NULL;
-
-    acct_len = strlen(acct_online_id);
-    match_len = strlen(match->online_id);
-
-    if (acct_online_id[acct_len - 1] == ' ')
-        --acct_len;
-    if (match->online_id[match_len - 1] == ' ')
-        --match_len;
-
-    if (strncmp (acct_online_id, match->online_id, acct_len) == 0)
-    {
-        if (strncmp(acct_online_id, match->online_id, match_len) == 0)
-            return (gpointer *) acct;
-        if (match->partial_match == NULL)
-        {
-            match->partial_match = acct;
-            ++match->count;
-        }
-        else
-        {
-            const char *partial_online_id =
-                gnc_import_get_acc_online_id(match->partial_match);
-            int partial_len = strlen(partial_online_id);
-            if (partial_online_id[partial_len - 1] == ' ')
-                --partial_len;
-            /* Both partial_online_id and acct_online_id are substrings of
-             * match->online_id, but whichever is longer is the better match.
-             * Reset match->count to 1 just in case there was ambiguity on the
-             * shorter partial match.
-             */
-            if (partial_len < acct_len)
-            {
-                match->partial_match = acct;
-                match->count = 1;
-            }
-            /* If they're the same size then there are two accounts with the
-             * same online id and we don't know which one to select. Increment
-             * match->count to dissuade gnc_import_find_account from using
-             * match->online_id and log an error.
-             */
-            else if (partial_len == acct_len)
-            {
-                ++match->count;
-                PERR("Accounts %s and %s have the same online-id %s",
-                     gnc_account_get_full_name(match->partial_match),
-                     gnc_account_get_full_name(acct),
-                     partial_online_id);
-            }
-        }
-    }
-
-    return NULL;
-}
-
-
 /***********************************************************
  * build_acct_tree
  *
@@ -420,14 +334,13 @@ Account * gnc_import_select_account(GtkWidget *parent,
     /*DEBUG("Looking for account with online_id: \"%s\"", account_online_id_value);*/
     if (account_online_id_value != NULL)
     {
-        AccountOnlineMatch match = {NULL, 0, account_online_id_value};
+        Account *partial_match = NULL;
         retval =
-            gnc_account_foreach_descendant_until(gnc_get_current_root_account (),
-                                                 test_acct_online_id_match,
-                                                 (void*)&match);
-        if (!retval && match.count == 1 &&
-            new_account_default_type == ACCT_TYPE_NONE)
-            retval = match.partial_match;
+            gnc_account_lookup_by_online_id (gnc_get_current_root_account (),
+                                             account_online_id_value,
+                                             &partial_match);
+        if (!retval && new_account_default_type == ACCT_TYPE_NONE)
+            retval = partial_match;
     }
     if (retval == NULL && auto_create != 0)
     {
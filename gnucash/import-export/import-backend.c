@@ -382,46 +382,40 @@ GdkPixbuf* gen_probability_pixbuf(gint score_original, GNCImportSettings *settin
  */
 
 /* Tokenize a string and append to an existing GList(or an empty GList)
- * the tokens
+ * the tokens. seen holds the tokens already in the list, so that each
+ * one is only added once.
  */
 static GList*
-tokenize_string(GList* existing_tokens, const char *string)
+tokenize_string(GList* existing_tokens, GHashTable *seen, const char *string)
 {
-    char **tokenized_strings; /* array of strings returned by g_strsplit() */
-    char **stringpos;
+    const char *start, *end;
 
-    tokenized_strings = g_strsplit(string, " ", 0);
-    stringpos = tokenized_strings;
+    if (!string)
+        return existing_tokens;
 
-    /* add each token to the token GList */
-    while (stringpos && *stringpos)
+    /* add each space separated token to the token GList */
+    for (start = string; *start; start = end)
     {
-        if (strlen(*stringpos) > 0)
+        gchar *token;
+
+        while (*start == ' ')
+            start++;
+        for (end = start; *end && *end != ' '; end++)
+            ;
+        if (end == start)
+            continue;
+
+        token = g_strndup (start, end - start);
+        if (g_hash_table_contains (seen, token))
         {
-            /* check for duplicated tokens */
-            gboolean duplicated = FALSE;
-            for (GList* token = existing_tokens; token != NULL; token = token->next)
-            {
-                if (g_strcmp0(token->data, *stringpos) == 0)
-                {
-                    duplicated = TRUE;
-                    break;
-                }
-            }
-            if (duplicated == FALSE)
-            {
-                /* prepend the char* to the token GList */
-                existing_tokens = g_list_prepend(existing_tokens, g_strdup(*stringpos));
-            }
+            g_free (token);
+            continue;
         }
-
-        /* then move to the next string */
-        stringpos++;
+        /* prepend the char* to the token GList */
+        existing_tokens = g_list_prepend(existing_tokens, token);
+        g_hash_table_add (seen, token);
     }
 
-    /* free up the strings that g_strsplit() created */
-    g_strfreev(tokenized_strings);
-
     return existing_tokens;
 }
 
@@ -435,6 +429,7 @@ TransactionGetTokens(GNCImportTransInfo *info)
     time64 transtime;
     struct tm *tm_struct;
     char local_day_of_week[16];
+    GHashTable *seen;
 
     g_return_val_if_fail (info, NULL);
     if (info->match_tokens) return info->match_tokens;
@@ -443,10 +438,12 @@ TransactionGetTokens(GNCImportTransInfo *info)
     g_assert(transaction);
 
     tokens = 0; /* start off with an empty list */
+    /* The list owns the tokens, this only remembers them. */
+    seen = g_hash_table_new (g_str_hash, g_str_equal);
 
     /* make tokens from the transaction description */
     text = xaccTransGetDescription(transaction);
-    tokens = tokenize_string(tokens, text);
+    tokens = tokenize_string(tokens, seen, text);
 
     /* The day of week the transaction occurred is a good indicator of
      * what account this transaction belongs in.  Get the date and covert
@@ -463,13 +460,15 @@ TransactionGetTokens(GNCImportTransInfo *info)
      * it frees the same way the rest do
      */
     tokens = g_list_prepend(tokens, g_strdup(local_day_of_week));
+    g_hash_table_add (seen, tokens->data);
 
     /* make tokens from the memo of each split of this transaction */
     for (GList *split=xaccTransGetSplitList (transaction); split; split=split->next)
     {
         text = xaccSplitGetMemo(split->data);
-        tokens = tokenize_string(tokens, text);
+        tokens = tokenize_string(tokens, seen, text);
     }
+    g_hash_table_destroy (seen);
 
     /* remember the list of tokens for later.. */
     info->match_tokens = tokens;
@@ -1091,51 +1090,238 @@ static gint check_trans_online_id(Transaction *trans1, void *user_data)
     }
 }
 
-static gint collect_trans_online_id(Transaction *trans, void *user_data)
+/* The online ids in each account that has been checked for duplicates,
+ * kept up to date from the engine's events for as long as the book is
+ * open. Importing into the same account again then doesn't read the
+ * online ids of its whole history again. */
+#define ONLINE_ID_INDEX "gnc-import-online-id-index"
+
+typedef struct
 {
-    Split *split;
-    GHashTable *id_hash = user_data;
-    int i=0;
-    
-    const gchar* online_id = gnc_import_get_trans_online_id (trans);
-    if (online_id)
-        g_hash_table_add (id_hash, (void*) online_id);
+    Account *account;
+    gchar *online_id;
+} OnlineIdEntry;
+
+typedef struct
+{
+    GHashTable *accounts;       /* Account* -> (online id -> count) */
+    GHashTable *transactions;   /* Transaction* -> GSList of OnlineIdEntry */
+    gint trans_listener;
+    gint account_listener;
+} OnlineIdIndex;
+
+static void
+online_id_entries_free (GSList *entries)
+{
+    for (GSList *node = entries; node; node = node->next)
+    {
+        OnlineIdEntry *entry = node->data;
+        g_free (entry->online_id);
+        g_free (entry);
+    }
+    g_slist_free (entries);
+}
+
+/* Count online_id, which is taken over, once more for account. */
+static GSList *
+online_id_index_count (OnlineIdIndex *index, GSList *entries,
+                       Account *account, gchar *online_id)
+{
+    GHashTable *ids = g_hash_table_lookup (index->accounts, account);
+    gint count = GPOINTER_TO_INT (g_hash_table_lookup (ids, online_id));
+    OnlineIdEntry *entry = g_new (OnlineIdEntry, 1);
+
+    g_hash_table_replace (ids, g_strdup (online_id), GINT_TO_POINTER (count + 1));
+    entry->account = account;
+    entry->online_id = online_id;
+    return g_slist_prepend (entries, entry);
+}
 
+/* Record the online ids of trans and of its splits under account. */
+static void
+online_id_index_add_trans (OnlineIdIndex *index, Transaction *trans,
+                           Account *account)
+{
+    GSList *entries = g_hash_table_lookup (index->transactions, trans);
+    gchar *online_id = (gchar*) gnc_import_get_trans_online_id (trans);
+
+    if (online_id)
+        entries = online_id_index_count (index, entries, account, online_id);
     for (GList *splits = xaccTransGetSplitList (trans); splits; splits = splits->next)
     {
-        if (gnc_import_split_has_online_id (splits->data))
-            g_hash_table_add(id_hash, (void*) gnc_import_get_split_online_id (splits->data));
+        online_id = (gchar*) gnc_import_get_split_online_id (splits->data);
+        if (online_id && *online_id)
+            entries = online_id_index_count (index, entries, account, online_id);
+        else
+            g_free (online_id);
     }
+    g_hash_table_steal (index->transactions, trans);
+    if (entries)
+        g_hash_table_insert (index->transactions, trans, entries);
+}
+
+static void
+online_id_index_remove_trans (OnlineIdIndex *index, Transaction *trans)
+{
+    GSList *entries = g_hash_table_lookup (index->transactions, trans);
+
+    for (GSList *node = entries; node; node = node->next)
+    {
+        OnlineIdEntry *entry = node->data;
+        GHashTable *ids = g_hash_table_lookup (index->accounts, entry->account);
+        gint count;
+
+        if (!ids)
+            continue;
+        count = GPOINTER_TO_INT (g_hash_table_lookup (ids, entry->online_id));
+        if (count > 1)
+            g_hash_table_replace (ids, g_strdup (entry->online_id),
+                                  GINT_TO_POINTER (count - 1));
+        else
+            g_hash_table_remove (ids, entry->online_id);
+    }
+    g_hash_table_remove (index->transactions, trans);
+}
+
+static gint
+index_trans_online_id (Transaction *trans, void *user_data)
+{
+    gpointer *data = user_data;
+    online_id_index_add_trans (data[0], trans, data[1]);
     return 0;
 }
 
+static void
+online_id_index_trans_event (QofInstance *ent, QofEventId event_type,
+                             gpointer user_data, gpointer event_data)
+{
+    OnlineIdIndex *index = user_data;
+    Transaction *trans = GNC_TRANSACTION (ent);
+    GList *accounts = NULL;
+
+    online_id_index_remove_trans (index, trans);
+    /* A transaction still being edited, e.g. one just downloaded, is
+     * counted once it's committed. */
+    if (event_type == QOF_EVENT_DESTROY || xaccTransIsOpen (trans))
+        return;
+
+    for (GList *splits = xaccTransGetSplitList (trans); splits; splits = splits->next)
+    {
+        Account *account = xaccSplitGetAccount (splits->data);
+        if (account && !g_list_find (accounts, account) &&
+            g_hash_table_contains (index->accounts, account))
+        {
+            accounts = g_list_prepend (accounts, account);
+            online_id_index_add_trans (index, trans, account);
+        }
+    }
+    g_list_free (accounts);
+}
+
+static void
+online_id_index_account_event (QofInstance *ent, QofEventId event_type,
+                               gpointer user_data, gpointer event_data)
+{
+    OnlineIdIndex *index = user_data;
+    GHashTableIter iter;
+    gpointer trans, entries;
+
+    if (!g_hash_table_remove (index->accounts, ent))
+        return;
+
+    g_hash_table_iter_init (&iter, index->transactions);
+    while (g_hash_table_iter_next (&iter, &trans, &entries))
+    {
+        GSList *kept = NULL;
+        for (GSList *node = entries; node; node = node->next)
+        {
+            OnlineIdEntry *entry = node->data;
+            if (entry->account == (Account*) ent)
+            {
+                g_free (entry->online_id);
+                g_free (entry);
+            }
+            else
+                kept = g_slist_prepend (kept, entry);
+        }
+        g_slist_free (entries);
+        if (kept)
+            g_hash_table_iter_replace (&iter, kept);
+        else
+            g_hash_table_iter_steal (&iter);
+    }
+}
+
+static void
+online_id_index_destroy (QofBook *book, gpointer key, gpointer user_data)
+{
+    OnlineIdIndex *index = user_data;
+
+    qof_event_unregister_handler (index->trans_listener);
+    qof_event_unregister_handler (index->account_listener);
+    g_hash_table_destroy (index->transactions);
+    g_hash_table_destroy (index->accounts);
+    g_free (index);
+}
+
+/* The online ids in account, read from its transactions the first time. */
+static GHashTable *
+online_id_index_get (Account *account)
+{
+    QofBook *book = gnc_account_get_book (account);
+    OnlineIdIndex *index = qof_book_get_data (book, ONLINE_ID_INDEX);
+    GHashTable *ids;
+
+    if (!index)
+    {
+        index = g_new0 (OnlineIdIndex, 1);
+        index->accounts = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+                                                 (GDestroyNotify) g_hash_table_destroy);
+        index->transactions = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+                                                     (GDestroyNotify) online_id_entries_free);
+        index->trans_listener =
+            qof_event_register_handler_filtered (online_id_index_trans_event, index,
+                                                 GNC_ID_TRANS,
+                                                 QOF_EVENT_MODIFY | QOF_EVENT_DESTROY);
+        index->account_listener =
+            qof_event_register_handler_filtered (online_id_index_account_event, index,
+                                                 GNC_ID_ACCOUNT, QOF_EVENT_DESTROY);
+        qof_book_set_data_fin (book, ONLINE_ID_INDEX, index, online_id_index_destroy);
+    }
+
+    ids = g_hash_table_lookup (index->accounts, account);
+    if (!ids)
+    {
+        gpointer data[2] = { index, account };
+        ids = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+        g_hash_table_insert (index->accounts, account, ids);
+        xaccAccountForEachTransaction (account, index_trans_online_id, data);
+    }
+    return ids;
+}
+
 /** Checks whether the given transaction's online_id already exists in
   its parent account. */
-gboolean gnc_import_exists_online_id (Transaction *trans, GHashTable* acct_id_hash)
+gboolean gnc_import_exists_online_id (Transaction *trans)
 {
     gboolean online_id_exists = FALSE;
     Account *dest_acct;
     Split *source_split;
+    gchar *online_id;
 
     /* Look for an online_id in the first split */
     source_split = xaccTransGetSplit(trans, 0);
     g_assert(source_split);
 
     // No online id, no point in continuing. We'd crash if we tried.
-    if (!gnc_import_get_split_online_id (source_split))
+    online_id = (gchar*) gnc_import_get_split_online_id (source_split);
+    if (!online_id)
         return FALSE;
-    // Create a hash per account of a hash of all transactions IDs. Then the test below will be fast if
-    // we have many transactions to import.
     dest_acct = xaccSplitGetAccount (source_split);
-    if (!g_hash_table_contains (acct_id_hash, dest_acct))
-    {
-        GHashTable* new_hash = g_hash_table_new (g_str_hash, g_str_equal);
-        g_hash_table_insert (acct_id_hash, dest_acct, new_hash);
-        xaccAccountForEachTransaction (dest_acct, collect_trans_online_id, new_hash);
-    }
-    online_id_exists = g_hash_table_contains (g_hash_table_lookup (acct_id_hash, dest_acct),
-                                              gnc_import_get_split_online_id (source_split));
-    
+    online_id_exists = g_hash_table_contains (online_id_index_get (dest_acct),
+                                              online_id);
+    g_free (online_id);
+
     /* If it does, abort the process for this transaction, since it is
        already in the system. */
     if (online_id_exists == TRUE)
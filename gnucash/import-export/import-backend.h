@@ -61,10 +61,12 @@ typedef enum _action
  * its parent account. The given transaction has to be open for
  * editing. If a matching online_id exists, the transaction is
  * destroyed (!) and TRUE is returned, otherwise FALSE is returned.
+ * The online ids of an account are read once per session and then kept
+ * up to date as transactions change.
  *
  * @param trans The transaction for which to check for an existing
  * online_id. */
-gboolean gnc_import_exists_online_id (Transaction *trans, GHashTable* acct_id_hash);
+gboolean gnc_import_exists_online_id (Transaction *trans);
 
 /** Evaluates the match between trans_info and split using the provided parameters.
  *
@@ -76,7 +76,7 @@ struct _main_matcher_info
     gboolean add_toggled;     // flag to indicate that add has been toggled to stop selection
     gint id;
     GSList* temp_trans_list;  // Temporary list of imported transactions
-    GHashTable* acct_id_hash; // Hash table, per account, of list of transaction IDs.
+    guint num_unmatched;      // Transactions at the head of temp_trans_list not matched yet
     GSList* edited_accounts;  // List of accounts currently edited.
 };
 
@@ -115,8 +115,6 @@ gboolean on_matcher_delete_event (GtkWidget *widget, GdkEvent *event, gpointer d
 void on_matcher_help_clicked (GtkButton *button, gpointer user_data);
 void on_matcher_help_close_clicked (GtkButton *button, gpointer user_data);
 
-static void gnc_gen_trans_list_create_matches (GNCImportMainMatcher *gui);
-
 /* Local prototypes */
 static void gnc_gen_trans_assign_transfer_account (GtkTreeView *treeview,
                                                    gboolean *first,
@@ -144,14 +142,6 @@ static gboolean query_tooltip_tree_view_cb (GtkWidget *widget, gint x, gint y,
                                             gpointer user_data);
 /* end local prototypes */
 
-static
-gboolean delete_hash (gpointer key, gpointer value, gpointer user_data)
-{
-    // Value is a hash table that needs to be destroyed.
-    g_hash_table_destroy (value);
-    return TRUE;
-}
-
 static void
 update_all_balances (GNCImportMainMatcher *info)
 {
@@ -217,9 +207,6 @@ gnc_gen_trans_list_delete (GNCImportMainMatcher *info)
 
     // We've deferred balance computations on many accounts. Let's do it now that we're done.
     update_all_balances (info);
-
-    g_hash_table_foreach_remove (info->acct_id_hash, delete_hash, NULL);
-    info->acct_id_hash = NULL;
     g_free (info);
 }
 
@@ -473,6 +460,7 @@ on_matcher_ok_clicked (GtkButton *button, GNCImportMainMatcher *info)
     /* Don't run any queries and/or split sorts while processing the matcher
     results. */
     gnc_suspend_gui_refresh ();
+    qof_trace_begin ("import", "process", NULL);
     do
     {
         gtk_tree_model_get (model, &iter,
@@ -492,11 +480,14 @@ on_matcher_ok_clicked (GtkButton *button, GNCImportMainMatcher *info)
         }
     }
     while (gtk_tree_model_iter_next (model, &iter));
+    qof_trace_end ();
 
     gnc_gen_trans_list_delete (info);
 
     /* Allow GUI refresh again. */
+    qof_trace_begin ("import", "refresh", NULL);
     gnc_resume_gui_refresh ();
+    qof_trace_end ();
 
     /* DEBUG ("End") */
 }
@@ -1133,8 +1124,6 @@ gnc_gen_trans_init_view (GNCImportMainMatcher *info,
                       G_CALLBACK(gnc_gen_trans_onButtonPressed_cb), info);
     g_signal_connect (view, "popup-menu",
                       G_CALLBACK(gnc_gen_trans_onPopupMenu_cb), info);
-
-    info->acct_id_hash = g_hash_table_new (g_direct_hash, g_direct_equal);
 }
 
 static void
@@ -1715,7 +1704,7 @@ gnc_gen_trans_list_add_trans_with_ref_id (GNCImportMainMatcher *gui, Transaction
     g_assert (gui);
     g_assert (trans);
 
-    if (gnc_import_exists_online_id (trans, gui->acct_id_hash))
+    if (gnc_import_exists_online_id (trans))
         return;
     else
     {
@@ -1724,6 +1713,7 @@ gnc_gen_trans_list_add_trans_with_ref_id (GNCImportMainMatcher *gui, Transaction
         // It's much faster to gather the imported transactions into a GSList than directly into the
         // treeview.
         gui->temp_trans_list = g_slist_prepend (gui->temp_trans_list, transaction_info);
+        gui->num_unmatched++;
     }
     return;
 }
@@ -1744,11 +1734,11 @@ query_imported_transaction_accounts (GNCImportMainMatcher *gui)
     time64 match_timelimit = match_date_limit * secs_per_day;
     Query *query = qof_query_create_for (GNC_ID_SPLIT);
 
-    /* Go through all imported transactions, gather the list of accounts, and
-     * min/max date range.
+    /* Go through the imported transactions not matched yet, gather the list
+     * of accounts, and min/max date range.
      */
-    for (GSList* txn = gui->temp_trans_list; txn != NULL;
-         txn = g_slist_next (txn))
+    GSList* txn = gui->temp_trans_list;
+    for (guint i = 0; i < gui->num_unmatched; i++, txn = g_slist_next (txn))
     {
         GNCImportTransInfo* txn_info = txn->data;
         Account *txn_account =
@@ -1776,8 +1766,24 @@ query_imported_transaction_accounts (GNCImportMainMatcher *gui)
     return retval;
 }
 
+static gint
+split_date_cmp (gconstpointer a, gconstpointer b)
+{
+    time64 ta = xaccTransGetDate (xaccSplitGetParent (*(Split**)a));
+    time64 tb = xaccTransGetDate (xaccSplitGetParent (*(Split**)b));
+    return ta < tb ? -1 : ta > tb;
+}
+
+static void
+sort_potential_matches (gpointer key, gpointer value, gpointer user_data)
+{
+    g_ptr_array_sort ((GPtrArray*)value, split_date_cmp);
+}
+
 /* Create a hash by account of all splits that could match one of the imported
  * transactions based on their account and date and organized per account.
+ * Each account's splits are sorted by date, so that the ones close enough in
+ * date to an imported transaction can be found without looking at the rest.
  */
 static GHashTable*
 create_hash_of_potential_matches (GList *candidate_txns,
@@ -1787,18 +1793,19 @@ create_hash_of_potential_matches (GList *candidate_txns,
          candidate = g_list_next (candidate))
     {
         Account* split_account;
-        GSList* split_list;
+        GPtrArray* splits;
         if (gnc_import_split_has_online_id (candidate->data))
             continue;
         split_account = xaccSplitGetAccount (candidate->data);
-        /* g_hash_table_steal_extended would do the two calls in one shot but is
-         * not available until GLib 2.58.
-         */
-        split_list = g_hash_table_lookup (account_hash, split_account);
-        g_hash_table_steal (account_hash, split_account);
-        split_list = g_slist_prepend (split_list, candidate->data);
-        g_hash_table_insert (account_hash, split_account, split_list);
+        splits = g_hash_table_lookup (account_hash, split_account);
+        if (!splits)
+        {
+            splits = g_ptr_array_new ();
+            g_hash_table_insert (account_hash, split_account, splits);
+        }
+        g_ptr_array_add (splits, candidate->data);
     }
+    g_hash_table_foreach (account_hash, sort_potential_matches, NULL);
     return account_hash;
 }
 
@@ -1809,6 +1816,8 @@ typedef struct _match_struct
     gint date_threshold;
     gint date_not_threshold;
     double fuzzy_amount;
+    GPtrArray* splits;
+    time64 match_timelimit;
 } match_struct;
 
 static void
@@ -1821,6 +1830,86 @@ match_helper (Split* data, match_struct* s)
                       s->fuzzy_amount);
 }
 
+/* Try the splits in the date sorted array s->splits that lie within
+ * s->match_timelimit of the imported transaction. */
+static void
+match_in_date_window (match_struct* s)
+{
+    GPtrArray *splits = s->splits;
+    time64 txn_time;
+    guint lo = 0, hi;
+
+    if (!splits)
+        return;
+    txn_time = xaccTransGetDate (gnc_import_TransInfo_get_trans (s->transaction_info));
+    hi = splits->len;
+    while (lo < hi)
+    {
+        guint mid = lo + (hi - lo) / 2;
+        Split *split = g_ptr_array_index (splits, mid);
+        if (xaccTransGetDate (xaccSplitGetParent (split)) < txn_time - s->match_timelimit)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    for (; lo < splits->len; lo++)
+    {
+        Split *split = g_ptr_array_index (splits, lo);
+        if (xaccTransGetDate (xaccSplitGetParent (split)) > txn_time + s->match_timelimit)
+            break;
+        match_helper (split, s);
+    }
+}
+
+static void
+match_in_date_window_job (gpointer data, gpointer user_data)
+{
+    match_in_date_window (data);
+}
+
+/* Below this many imported transactions the matches are scored on the
+ * main thread. */
+#define PARALLEL_MATCH_MIN_TRANS 64
+
+/* Score the candidate splits for every imported transaction. Each
+ * transaction only collects into its own match list and the book is
+ * only read, so the transactions are scored on a thread pool when
+ * there are enough of them. */
+static void
+score_matches (match_struct *jobs, guint n_jobs)
+{
+    GThreadPool *pool = NULL;
+    guint n_threads = MIN (g_get_num_processors (), n_jobs);
+
+    if (n_threads > 1 && n_jobs >= PARALLEL_MATCH_MIN_TRANS)
+    {
+        GError *error = NULL;
+        /* The num/action heuristic reads a book option that is cached
+         * on first use; fill the cache in before the jobs share it. */
+        qof_book_use_split_action_for_num_field (gnc_get_current_book ());
+        pool = g_thread_pool_new (match_in_date_window_job, NULL,
+                                  n_threads, TRUE, &error);
+        if (!pool)
+        {
+            PWARN ("Unable to create thread pool: %s", error->message);
+            g_error_free (error);
+        }
+    }
+
+    if (pool)
+    {
+        for (guint i = 0; i < n_jobs; i++)
+            g_thread_pool_push (pool, &jobs[i], NULL);
+        g_thread_pool_free (pool, FALSE, TRUE);
+        PINFO ("scored %u transactions on %u threads", n_jobs, n_threads);
+    }
+    else
+    {
+        for (guint i = 0; i < n_jobs; i++)
+            match_in_date_window (&jobs[i]);
+    }
+}
+
 /* Iterate through the imported transactions selecting matches from the
  * potential match lists in the account hash and update the matcher with the
  * results.
@@ -1829,6 +1918,7 @@ match_helper (Split* data, match_struct* s)
 static void
 perform_matching (GNCImportMainMatcher *gui, GHashTable *account_hash)
 {
+    static const int secs_per_day = 86400;
     GtkTreeModel* model = gtk_tree_view_get_model (gui->view);
     gint display_threshold =
         gnc_import_Settings_get_display_threshold (gui->user_settings);
@@ -1838,19 +1928,32 @@ perform_matching (GNCImportMainMatcher *gui, GHashTable *account_hash)
         gnc_import_Settings_get_date_not_threshold (gui->user_settings);
     double fuzzy_amount =
         gnc_import_Settings_get_fuzzy_amount (gui->user_settings);
+    time64 match_timelimit = secs_per_day *
+        gnc_import_Settings_get_match_date_hardlimit (gui->user_settings);
+    guint n_jobs = gui->num_unmatched;
+    match_struct *jobs = g_new (match_struct, n_jobs);
+    GSList *imported_txn = gui->temp_trans_list;
 
-    for (GSList *imported_txn = gui->temp_trans_list; imported_txn !=NULL;
-         imported_txn = g_slist_next (imported_txn))
+    for (guint i = 0; i < n_jobs; i++, imported_txn = g_slist_next (imported_txn))
     {
-        GtkTreeIter iter;
-        GNCImportMatchInfo *selected_match;
-        gboolean match_selected_manually;
         GNCImportTransInfo* txn_info = imported_txn->data;
         Account *importaccount = xaccSplitGetAccount (gnc_import_TransInfo_get_fsplit (txn_info));
-        match_struct s = {txn_info, display_threshold, date_threshold, date_not_threshold, fuzzy_amount};
+        match_struct s = {txn_info, display_threshold, date_threshold,
+                          date_not_threshold, fuzzy_amount,
+                          g_hash_table_lookup (account_hash, importaccount),
+                          match_timelimit};
+        jobs[i] = s;
+    }
+
+    score_matches (jobs, n_jobs);
 
-        g_slist_foreach (g_hash_table_lookup (account_hash, importaccount),
-                         (GFunc) match_helper, &s);
+    // The rest touches the pending matches and the tree, in list order.
+    for (guint i = 0; i < n_jobs; i++)
+    {
+        GtkTreeIter iter;
+        GNCImportMatchInfo *selected_match;
+        gboolean match_selected_manually;
+        GNCImportTransInfo* txn_info = jobs[i].transaction_info;
 
         // Sort the matches, select the best match, and set the action.
         gnc_import_TransInfo_init_matches (txn_info, gui->user_settings);
@@ -1867,6 +1970,7 @@ perform_matching (GNCImportMainMatcher *gui, GHashTable *account_hash)
         gtk_tree_store_append (GTK_TREE_STORE (model), &iter, NULL);
         refresh_model_row (gui, model, &iter, txn_info);
     }
+    g_free (jobs);
 }
 
 void
@@ -1874,13 +1978,26 @@ gnc_gen_trans_list_create_matches (GNCImportMainMatcher *gui)
 {
     GHashTable* account_hash =
         g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
-                              (GDestroyNotify)g_slist_free);
+                              (GDestroyNotify)g_ptr_array_unref);
     GList *candidate_txns;
     g_assert (gui);
+    if (!gui->num_unmatched)
+    {
+        g_hash_table_destroy (account_hash);
+        return;
+    }
+    qof_trace_begin ("import", "query-candidates", NULL);
     candidate_txns = query_imported_transaction_accounts (gui);
+    qof_trace_end ();
 
+    qof_trace_begin ("import", "hash-candidates", NULL);
     create_hash_of_potential_matches (candidate_txns, account_hash);
+    qof_trace_end ();
+
+    qof_trace_begin ("import", "match", NULL);
     perform_matching (gui, account_hash);
+    qof_trace_end ();
+    gui->num_unmatched = 0;
 
     g_list_free (candidate_txns);
     g_hash_table_destroy (account_hash);
@@ -195,6 +195,16 @@ GtkWidget *gnc_gen_trans_list_widget (GNCImportMainMatcher *info);
  */
 gboolean gnc_gen_trans_list_empty (GNCImportMainMatcher *info);
 
+/** Finds the matches for the transactions added since the last call
+ * and appends them to the list. An importer that adds a lot of
+ * transactions can call this every so often while it reads, instead of
+ * leaving all the matching for gnc_gen_trans_list_show_all(), which
+ * matches whatever is left. Conflicts between matches are resolved when
+ * the list is shown.
+ * @param info A pointer to a the GNCImportMainMatcher structure.
+ */
+void gnc_gen_trans_list_create_matches (GNCImportMainMatcher *info);
+
 /** Shows widgets.
  * @param info A pointer to a the GNCImportMainMatcher structure.
  */
@@ -42,6 +42,7 @@
 #include "qof.h"
 #include "gnc-ui-util.h"
 #include "gnc-gui-query.h"
+#include "gnc-component-manager.h"
 
 #define GNC_PREFS_GROUP "dialogs.log-replay"
 
@@ -359,8 +360,50 @@ static void dump_split_record(split_record record)
     }
 }
 
+/* The replayed transactions are committed together, this many at a
+ * time, instead of one by one. */
+#define REPLAY_BATCH_SIZE 1000
+
+typedef struct
+{
+    GPtrArray *trans;           /* Open transactions waiting to be committed */
+    GHashTable *pending;        /* The same transactions, to look them up */
+} replay_batch;
+
+static void replay_batch_commit (replay_batch *batch)
+{
+    guint n_trans = batch->trans->len;
+    GncTransCommitStatus *status;
+
+    if (n_trans == 0)
+        return;
+
+    status = g_new (GncTransCommitStatus, n_trans);
+    xaccTransCommitEditBatch ((Transaction**) batch->trans->pdata, n_trans, status);
+    for (guint i = 0; i < n_trans; i++)
+    {
+        /* The batch leaves the transactions that fail its checks open;
+         * commit those on their own, as the replay always did. A backend
+         * error has already rolled the edit back. */
+        if (status[i] != GNC_TRANS_COMMIT_OK &&
+            status[i] != GNC_TRANS_COMMIT_BACKEND_ERROR)
+            xaccTransCommitEdit (g_ptr_array_index (batch->trans, i));
+    }
+    g_free (status);
+    g_ptr_array_set_size (batch->trans, 0);
+    g_hash_table_remove_all (batch->pending);
+}
+
+/* A record for a transaction that's still waiting in the batch has to
+ * see it committed first. */
+static void replay_batch_check (replay_batch *batch, Transaction *trans)
+{
+    if (trans && g_hash_table_contains (batch->pending, trans))
+        replay_batch_commit (batch);
+}
+
 /* File pointer must already be at the beginning of a record */
-static void  process_trans_record(  FILE *log_file)
+static void  process_trans_record(  FILE *log_file, replay_batch *batch)
 {
     char read_buf[2048];
     char *read_retval;
@@ -404,6 +447,7 @@ static void  process_trans_record(  FILE *log_file)
                             && first_record == TRUE)
                     {
                         first_record = FALSE;
+                        replay_batch_check (batch, trans);
                         if (xaccTransGetReadOnly(trans))
                         {
                             PWARN("Destroying a read only transaction.");
@@ -428,6 +472,7 @@ static void  process_trans_record(  FILE *log_file)
                         if (trans != NULL)
                         {
                             DEBUG("process_trans_record(): Transaction to be edited was found");
+                            replay_batch_check (batch, trans);
                             xaccTransBeginEdit(trans);
                             trans_ro = g_strdup(xaccTransGetReadOnly(trans));
                             if (trans_ro)
@@ -475,6 +520,7 @@ static void  process_trans_record(  FILE *log_file)
                         if (split != NULL)
                         {
                             DEBUG("process_trans_record(): Split to be edited was found");
+                            replay_batch_check (batch, xaccSplitGetParent (split));
                             is_new_split = FALSE;
                         }
                         else
@@ -539,8 +585,16 @@ static void  process_trans_record(  FILE *log_file)
             {
                 xaccTransScrubCurrency(trans);
                 xaccTransSetReadOnly(trans, trans_ro);
-                xaccTransCommitEdit(trans);
                 g_free(trans_ro);
+                if (qof_instance_get_destroying (trans))
+                    xaccTransCommitEdit(trans);
+                else
+                {
+                    g_ptr_array_add (batch->trans, trans);
+                    g_hash_table_add (batch->pending, trans);
+                    if (batch->trans->len >= REPLAY_BATCH_SIZE)
+                        replay_batch_commit (batch);
+                }
             }
         }
     }
@@ -636,16 +690,25 @@ void gnc_file_log_replay (GtkWindow *parent)
                     }
                     else
                     {
+                        replay_batch batch = { g_ptr_array_new (),
+                                               g_hash_table_new (g_direct_hash, g_direct_equal) };
+
+                        /* Refresh the registers once, when it's all done. */
+                        gnc_suspend_gui_refresh ();
                         do
                         {
                             read_retval = fgets(read_buf, sizeof(read_buf), log_file);
                             /*DEBUG("Chunk read: %s",read_retval);*/
                             if (read_retval && strncmp(record_start_str, read_buf, strlen(record_start_str)) == 0) /* If a record started */
                             {
-                                process_trans_record(log_file);
+                                process_trans_record(log_file, &batch);
                             }
                         }
                         while (feof(log_file) == 0);
+                        replay_batch_commit (&batch);
+                        g_ptr_array_free (batch.trans, TRUE);
+                        g_hash_table_destroy (batch.pending);
+                        gnc_resume_gui_refresh ();
                     }
                 }
                 fclose(log_file);
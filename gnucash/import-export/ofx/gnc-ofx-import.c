@@ -48,6 +48,7 @@
 #include "gnc-glib-utils.h"
 #include "gnc-prefs.h"
 #include "gnc-ui.h"
+#include "gnc-window.h"
 #include "dialog-account.h"
 #include "dialog-utils.h"
 #include "window-reconcile.h"
@@ -57,6 +58,10 @@
 
 static QofLogModule log_module = GNC_MOD_IMPORT;
 
+/* Match the downloaded transactions in batches of this many while the
+ * file is read, so that a big download doesn't leave it all for the end. */
+#define OFX_MATCH_BATCH 500
+
 /********************************************************************\
  * gnc_file_ofx_import
  * Entry point
@@ -73,6 +78,7 @@ typedef struct _ofx_info
     Account *last_investment_account;
     Account *last_income_account;
     gint num_trans_processed;               // Number of transactions processed
+    gint num_trans_added;                   // Number of them sent to the matcher
     struct OfxStatementData* statement;     // Statement, if any
     gboolean run_reconcile;                 // If TRUE the reconcile window is opened after matching.
     GSList* file_list;                      // List of OFX files to import
@@ -901,6 +907,12 @@ int ofx_proc_transaction_cb(struct OfxTransactionData data, void *user_data)
         {
             DEBUG("%d splits sent to the importer gui", xaccTransCountSplits(transaction));
             gnc_gen_trans_list_add_trans (info->gnc_ofx_importer_gui, transaction);
+            if (++info->num_trans_added % OFX_MATCH_BATCH == 0)
+            {
+                gnc_gen_trans_list_create_matches (info->gnc_ofx_importer_gui);
+                /* The number of transactions isn't known in advance. */
+                gnc_window_show_progress (_("Matching downloaded transactions..."), 101.0);
+            }
         }
         else
         {
@@ -1167,6 +1179,7 @@ gnc_file_ofx_import_process_file (ofx_info* info)
 
     // Reset the reconciliation information.
     info->num_trans_processed = 0;
+    info->num_trans_added = 0;
     info->statement = NULL;
 
     /* Initialize libofx and set the callbacks*/
@@ -1179,6 +1192,7 @@ gnc_file_ofx_import_process_file (ofx_info* info)
     // Create the match dialog, and run the ofx file through the importer.
     info->gnc_ofx_importer_gui = gnc_gen_trans_list_new (GTK_WIDGET(parent), NULL, FALSE, 42, FALSE);
     libofx_proc_file (libofx_context, selected_filename, AUTODETECT);
+    gnc_window_show_progress (NULL, -1.0);
 
     // Free the libofx context before recursing to process the next file
     libofx_free_context(libofx_context);
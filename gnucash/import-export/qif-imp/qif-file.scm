@@ -937,11 +937,17 @@
          (format #f)
          (len (length objects))
          (work-to-do (* len 2))
-         (work-done 0))
+         (work-done 0)
+         ;; Values repeat a lot in a big file (dates especially), so
+         ;; each distinct one is only checked and parsed once.
+         (checked (make-hash-table))
+         (parsed-values (make-hash-table)))
 
     ;; first find the right format for the field
     ;; loop over objects.  If the formats list ever gets down
     ;; to 1 element, we can stop right there.
+    ;; The formats only ever shrink to those that fit every value seen
+    ;; so far, so checking a value again can't change them.
     (if (not (null? objects))
         (let loop ((current (car objects))
                    (rest (cdr objects)))
@@ -949,7 +955,9 @@
             (if val
                 (begin
                   (set! do-parsing #t)
-                  (set! formats (checker val formats))))
+                  (unless (hash-ref checked val)
+                    (hash-set! checked val #t)
+                    (set! formats (checker val formats)))))
             (set! work-done (+ 1 work-done))
             (reporter (/ work-done work-to-do)))
           (if (and (not (null? formats))
@@ -1007,7 +1015,10 @@
                   (parsed #f))
               (if val
                   (begin
-                    (set! parsed (parser val format))
+                    (set! parsed (or (hash-ref parsed-values val)
+                                     (parser val format)))
+                    (if parsed
+                        (hash-set! parsed-values val parsed))
                     (if parsed
                         (setter current parsed)
                         (begin
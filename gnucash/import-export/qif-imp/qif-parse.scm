@@ -271,8 +271,7 @@
   (let* ((date-parts (list (match:substring match 1)
                            (match:substring match 2)
                            (match:substring match 3)))
-         (numeric-date-parts (map (lambda (elt) (with-input-from-string elt read))
-                                  date-parts))
+         (numeric-date-parts (map string->number date-parts))
          (n1 (car numeric-date-parts))
          (n2 (cadr numeric-date-parts))
          (n3 (caddr numeric-date-parts))
@@ -363,8 +362,7 @@
                                (match:substring m 3)))))))
               '()))
          ;; get the strings into numbers (but keep the strings around)
-         (numeric-date-parts (map (lambda (elt) (with-input-from-string elt read))
-                                  date-parts)))
+         (numeric-date-parts (map string->number date-parts)))
 
     (define (refs->list dd mm yy)
       (let ((d (list-ref numeric-date-parts dd))
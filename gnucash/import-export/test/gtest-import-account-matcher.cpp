@@ -170,3 +170,22 @@ TEST_F(ImportMatcherTest, test_subaccount_match_internal_space)
     ASSERT_NE(nullptr, found);
     EXPECT_STREQ("Cash Management", xaccAccountGetName(found));
 }
+
+TEST_F(ImportMatcherTest, test_changed_online_id)
+{
+    auto found = gnc_import_select_account(nullptr, "BrokerStocksHPE", FALSE,
+                                           nullptr, nullptr, ACCT_TYPE_NONE,
+                                           nullptr, nullptr);
+    ASSERT_NE(nullptr, found);
+    qof_instance_set(QOF_INSTANCE(found), "online-id", "BrokerStocksHPQ", NULL);
+    found = gnc_import_select_account(nullptr, "BrokerStocksHPQ", FALSE,
+                                      nullptr, nullptr, ACCT_TYPE_NONE,
+                                      nullptr, nullptr);
+    ASSERT_NE(nullptr, found);
+    EXPECT_STREQ("HPE", xaccAccountGetName(found));
+    found = gnc_import_select_account(nullptr, "BrokerStocksHPE", FALSE,
+                                      nullptr, nullptr, ACCT_TYPE_NONE,
+                                      nullptr, nullptr);
+    ASSERT_NE(nullptr, found);
+    EXPECT_STREQ("Stocks", xaccAccountGetName(found));
+}
@@ -77,6 +77,28 @@
 (define gnc:*finance-quote-helper*
   (string-append (gnc-path-get-bindir) "/gnc-fq-helper"))
 
+;; How many gnc-fq-helper processes fetch quotes at the same time, and
+;; how many symbols of one quote source are sent in a single request.
+(define gnc:*fq-max-helpers* 4)
+(define gnc:*fq-symbols-per-request* 50)
+
+(define (gnc:fq-service-connect)
+  ;; Connect to a long-lived "gnc-fq-helper --socket" service if
+  ;; GNC_FQ_HELPER_SOCKET names its socket.  Returns a connection as
+  ;; used by gnc:fq-get-quotes, or #f to use helper processes instead.
+  (let ((path (getenv "GNC_FQ_HELPER_SOCKET")))
+    (and path
+         (not (string-null? path))
+         (catch 'system-error
+           (lambda ()
+             (let ((sock (socket PF_UNIX SOCK_STREAM 0)))
+               (connect sock AF_UNIX path)
+               (vector sock sock (lambda () (close-port sock)))))
+           (lambda (key . args)
+             (gnc:warn "Cannot connect to the quote service at " path
+                       ", starting gnc-fq-helper instead.")
+             #f)))))
+
 (define (gnc:fq-get-quotes requests)
   ;; requests should be a list where each item is of the form
   ;;
@@ -115,46 +137,115 @@
   ;; was unparsable.  See the gnc-fq-helper for more details
   ;; about it's output.
 
-  (let ((quoter #f))
-
-    (define (start-quoter)
-      (set! quoter
-        (gnc-spawn-process-async (list "perl" "-w" gnc:*finance-quote-helper*) #t)))
+  ;; The requests are shared out among up to gnc:*fq-max-helpers*
+  ;; gnc-fq-helper processes, which work on them concurrently.  Each
+  ;; helper gets one request at a time and its next one as soon as its
+  ;; answer has been read, in whatever order the helpers finish.
+
+  (define (need-key? request)
+    (and (member (car request) '("currency" "alphavantage" "vanguard"))
+         (not (getenv "ALPHAVANTAGE_API_KEY"))))
+
+  (let* ((requests (list->vector requests))
+         (results (make-vector (vector-length requests) #f))
+         ;; indices of the requests to send, sorted so that the
+         ;; requests for a quote source are handed out together.
+         (pending (stable-sort (iota (vector-length requests))
+                               (lambda (a b)
+                                 (string<? (car (vector-ref requests a))
+                                           (car (vector-ref requests b))))))
+         ;; each helper is a mutable (connection . index-of-its-request)
+         ;; where connection is #(input-port output-port close-thunk)
+         (quoters '()))
+
+    (define (spawn-helper)
+      (let ((helper (gnc-spawn-process-async
+                     (list "perl" "-w" gnc:*finance-quote-helper*) #t)))
+        (and helper
+             (vector (fdes->inport (gnc-process-get-fd helper 1))
+                     (fdes->outport (gnc-process-get-fd helper 0))
+                     (lambda () (gnc-detach-process helper #t))))))
+
+    (define (start-quoters)
+      (set! quoters
+        (map (lambda (connection) (cons connection #f))
+             (cond
+              ((gnc:fq-service-connect) => list)
+              (else
+               (filter-map
+                (lambda (i) (spawn-helper))
+                (iota (min gnc:*fq-max-helpers*
+                           (max 1 (length pending))))))))))
+
+    (define (quoter-port quoter fd)
+      (vector-ref (car quoter) (if (zero? fd) 1 0)))
+
+    ;; Send the next request to quoter, answering requests that can't
+    ;; be sent on the spot.  Leaves quoter idle when none are left.
+    (define (send-next! quoter)
+      (set-cdr! quoter #f)
+      (let lp ()
+        (unless (or (cdr quoter) (null? pending))
+          (let* ((index (car pending))
+                 (request (vector-ref requests index)))
+            (set! pending (cdr pending))
+            (gnc:debug "handling-request: " request)
+            (catch #t
+              (lambda ()
+                (when (need-key? request)
+                  (throw 'need-alphavantage-key))
+                ;; we need to display the first element (the method,
+                ;; so it won't be quoted) and then write the rest
+                (with-output-to-port (quoter-port quoter 0)
+                  (lambda ()
+                    (display #\()
+                    (display (car request))
+                    (display " ")
+                    (for-each write (cdr request))
+                    (display #\))
+                    (newline)
+                    (force-output)))
+                (set-cdr! quoter index))
+              (lambda (key . args)
+                (vector-set! results index key)))
+            (lp)))))
+
+    (define (receive! quoter)
+      (let ((index (cdr quoter)))
+        (vector-set!
+         results index
+         (catch #t
+           (lambda ()
+             (let ((result (read (quoter-port quoter 1))))
+               (gnc:debug "results: " result)
+               result))
+           (lambda (key . args) key)))
+        (send-next! quoter)))
 
     (define (get-quotes)
-      (when quoter
-        (map
-         (lambda (request)
-           (catch #t
-             (lambda ()
-               (gnc:debug "handling-request: " request)
-               (and (member (car request) '("currency" "alphavantage" "vanguard"))
-                    (not (getenv "ALPHAVANTAGE_API_KEY"))
-                    (throw 'need-alphavantage-key))
-               ;; we need to display the first element (the method,
-               ;; so it won't be quoted) and then write the rest
-               (with-output-to-port (fdes->outport (gnc-process-get-fd quoter 0))
-                 (lambda ()
-                   (display #\()
-                   (display (car request))
-                   (display " ")
-                   (for-each write (cdr request))
-                   (display #\))
-                   (newline)
-                   (force-output)))
-
-               (let ((results (read (fdes->inport (gnc-process-get-fd quoter 1)))))
-                 (gnc:debug "results: " results)
-                 results))
-             (lambda (key . args) key)))
-         requests)))
-
-    (define (kill-quoter)
-      (when quoter
-        (gnc-detach-process quoter #t)
-        (set! quoter #f)))
-
-    (dynamic-wind start-quoter get-quotes kill-quoter)))
+      (and (pair? quoters)
+           (begin
+             (for-each send-next! quoters)
+             (let lp ()
+               (let ((busy (filter cdr quoters)))
+                 (when (pair? busy)
+                   (let ((ready (car (select (map (lambda (q) (quoter-port q 1))
+                                                  busy)
+                                             '() '()))))
+                     (for-each
+                      (lambda (quoter)
+                        (when (memq (quoter-port quoter 1) ready)
+                          (receive! quoter)))
+                      busy))
+                   (lp))))
+             (vector->list results))))
+
+    (define (kill-quoters)
+      (for-each (lambda (quoter) ((vector-ref (car quoter) 2)))
+                quoters)
+      (set! quoters '()))
+
+    (dynamic-wind start-quoters get-quotes kill-quoters)))
 
 (define (gnc:book-add-quotes window book)
 
@@ -199,10 +290,20 @@
                         (cons val (hash-ref commodity-hash key '())))))
          commodity-list)
 
-        ;; Now translate to just what gnc-fq-helper expects.
+        ;; Now translate to just what gnc-fq-helper expects, splitting
+        ;; big sources into several calls the helpers can share.
         (and (or (pair? currency-list-filtered) (pair? commodity-list))
              (append
-              (hash-map->list cons commodity-hash)
+              (append-map
+               (lambda (source)
+                 (let lp ((items (cdr source)) (calls '()))
+                   (if (> (length items) gnc:*fq-symbols-per-request*)
+                       (let-values (((head tail)
+                                     (split-at items
+                                               gnc:*fq-symbols-per-request*)))
+                         (lp tail (cons (cons (car source) head) calls)))
+                       (reverse (cons (cons (car source) items) calls)))))
+               (hash-map->list cons commodity-hash))
               (map (lambda (cmd) (cons (car cmd) (list (cdr cmd))))
                    currency-list-filtered))))))
 
@@ -394,13 +495,10 @@
       ))
 
   (define (book-add-prices! book prices)
-    (let ((pricedb (gnc-pricedb-get-db book)))
-      (for-each
-       (lambda (price)
-         (when price
-           (gnc-pricedb-add-price pricedb price)
-           (gnc-price-unref price)))
-       prices)))
+    ;; prices that updated one already in the pricedb are #f.
+    (let ((new-prices (filter identity prices)))
+      (gnc-pricedb-add-prices-bulk (gnc-pricedb-get-db book) new-prices)
+      (for-each gnc-price-unref new-prices)))
 
   (define (show-error msg)
     (gnc:gui-error msg (G_ msg)))
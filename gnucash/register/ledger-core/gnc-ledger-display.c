@@ -39,6 +39,7 @@
 #include "gnc-ui-util.h"
 #include "split-register-control.h"
 #include "split-register-model.h"
+#include "split-register-p.h"
 
 
 #define REGISTER_SINGLE_CM_CLASS     "register-single"
@@ -74,8 +75,22 @@ struct gnc_ledger_display
     gint number_of_subaccounts;
 
     gint component_id;
+
+    /* What the register was last loaded from, so that changes which
+     * leave its rows in place can be shown without a reload. */
+    GPtrArray* loaded_splits;
+    GHashTable* loaded_trans;
+    time64 loaded_present;
 };
 
+typedef struct
+{
+    GncGUID guid;
+    Transaction* trans;
+    gint num_splits;
+    time64 posted;
+} LoadedTrans;
+
 
 /** GLOBALS *********************************************************/
 static QofLogModule log_module = GNC_MOD_LEDGER;
@@ -548,6 +563,119 @@ gnc_ledger_display_set_watches (GNCLedgerDisplay* ld, GList* splits)
     }
 }
 
+static void
+gnc_ledger_display_clear_loaded (GNCLedgerDisplay* ld)
+{
+    if (ld->loaded_splits)
+        g_ptr_array_free (ld->loaded_splits, TRUE);
+    ld->loaded_splits = NULL;
+
+    if (ld->loaded_trans)
+        g_hash_table_destroy (ld->loaded_trans);
+    ld->loaded_trans = NULL;
+}
+
+static void
+gnc_ledger_display_record_loaded (GNCLedgerDisplay* ld, GList* splits)
+{
+    GList* node;
+
+    gnc_ledger_display_clear_loaded (ld);
+
+    ld->loaded_splits = g_ptr_array_new ();
+    ld->loaded_trans = g_hash_table_new_full (guid_hash_to_guint,
+                                              guid_g_hash_table_equal,
+                                              NULL, g_free);
+    ld->loaded_present = gnc_time64_get_today_end ();
+
+    for (node = splits; node; node = node->next)
+    {
+        Split* split = node->data;
+        Transaction* trans = xaccSplitGetParent (split);
+        const GncGUID* guid = xaccTransGetGUID (trans);
+
+        g_ptr_array_add (ld->loaded_splits, split);
+
+        if (!g_hash_table_lookup (ld->loaded_trans, guid))
+        {
+            LoadedTrans* lt = g_new (LoadedTrans, 1);
+
+            lt->guid = *guid;
+            lt->trans = trans;
+            lt->num_splits = xaccTransCountSplits (trans);
+            lt->posted = xaccTransGetDate (trans);
+            g_hash_table_insert (ld->loaded_trans, &lt->guid, lt);
+        }
+    }
+}
+
+/* Most changes to the transactions of a big register edit values but
+ * leave every row where it was: the same splits come back from the
+ * query, in the same order, and no changed transaction gained or lost
+ * a split or moved its date. The cells take their values from the
+ * model when drawn, so such a change only needs a redraw. Anything
+ * that touches the transaction under the cursor, the one being edited
+ * or the blank one still goes through a full load. */
+static gboolean
+gnc_ledger_display_refresh_rows (GNCLedgerDisplay* ld, GHashTable* changes,
+                                 GList* splits)
+{
+    SRInfo* info = gnc_split_register_get_info (ld->reg);
+    Transaction* cursor_trans;
+    Transaction* blank_trans;
+    GHashTableIter iter;
+    gpointer key, value;
+    GList* node;
+    guint i = 0;
+
+    if (!ld->loaded_splits || !info || !info->full_refresh ||
+        info->separator_changed || !guid_equal (&info->pending_trans_guid,
+                                                guid_null ()))
+        return FALSE;
+
+    if (ld->loaded_present != gnc_time64_get_today_end ())
+        return FALSE;
+
+    for (node = splits; node; node = node->next, i++)
+    {
+        if (i >= ld->loaded_splits->len ||
+            g_ptr_array_index (ld->loaded_splits, i) != node->data)
+            return FALSE;
+    }
+    if (i != ld->loaded_splits->len)
+        return FALSE;
+
+    cursor_trans = gnc_split_register_get_current_trans (ld->reg);
+    blank_trans = xaccSplitGetParent (gnc_split_register_get_blank_split (ld->reg));
+
+    g_hash_table_iter_init (&iter, changes);
+    while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+        const EventInfo* ei = value;
+        LoadedTrans* lt = g_hash_table_lookup (ld->loaded_trans, key);
+
+        if (!lt)
+        {
+            if (blank_trans && guid_equal (key, xaccTransGetGUID (blank_trans)))
+                return FALSE;
+            continue;
+        }
+
+        if (ei->event_mask & QOF_EVENT_DESTROY)
+            return FALSE;
+
+        if (lt->trans == cursor_trans || lt->trans == blank_trans)
+            return FALSE;
+
+        if (xaccTransCountSplits (lt->trans) != lt->num_splits ||
+            xaccTransGetDate (lt->trans) != lt->posted)
+            return FALSE;
+    }
+
+    gnc_table_refresh_gui (ld->reg->table, FALSE);
+    return TRUE;
+}
+
 static void
 refresh_handler (GHashTable* changes, gpointer user_data)
 {
@@ -610,6 +738,12 @@ refresh_handler (GHashTable* changes, gpointer user_data)
      */
     splits = qof_query_run (ld->query);
 
+    if (changes && gnc_ledger_display_refresh_rows (ld, changes, splits))
+    {
+        LEAVE ("rows redrawn");
+        return;
+    }
+
     gnc_ledger_display_set_watches (ld, splits);
 
     gnc_ledger_display_refresh_internal (ld, splits);
@@ -633,6 +767,8 @@ close_handler (gpointer user_data)
     gnc_split_register_destroy (ld->reg);
     ld->reg = NULL;
 
+    gnc_ledger_display_clear_loaded (ld);
+
     qof_query_destroy (ld->query);
     ld->query = NULL;
 
@@ -666,6 +802,8 @@ gnc_ledger_display_make_query (GNCLedgerDisplay* ld,
 
     qof_query_destroy (ld->query);
     ld->query = qof_query_create_for (GNC_ID_SPLIT);
+    /* Register refreshes only re-check the splits that changed. */
+    qof_query_set_live (ld->query, TRUE);
 
     /* This is a bit of a hack. The number of splits should be
      * configurable, or maybe we should go back a time range instead
@@ -801,13 +939,19 @@ gnc_ledger_display_internal (Account* lead_account, Query* q,
     ld->destroy = NULL;
     ld->get_parent = NULL;
     ld->user_data = NULL;
+    ld->loaded_splits = NULL;
+    ld->loaded_trans = NULL;
+    ld->loaded_present = 0;
 
     limit = gnc_prefs_get_float (GNC_PREFS_GROUP_GENERAL_REGISTER,
                                  GNC_PREF_MAX_TRANS);
 
     /* set up the query filter */
     if (q)
+    {
         ld->query = qof_query_copy (q);
+        qof_query_set_live (ld->query, TRUE);
+    }
     else
         gnc_ledger_display_make_query (ld, limit, reg_type);
 
@@ -845,6 +989,7 @@ gnc_ledger_display_set_query (GNCLedgerDisplay* ledger_display, Query* q)
 
     qof_query_destroy (ledger_display->query);
     ledger_display->query = qof_query_copy (q);
+    qof_query_set_live (ledger_display->query, TRUE);
 }
 
 GNCLedgerDisplay*
@@ -873,6 +1018,7 @@ gnc_ledger_display_refresh_internal (GNCLedgerDisplay* ld, GList* splits)
 
     gnc_split_register_load (ld->reg, splits,
                              gnc_ledger_display_leader (ld));
+    gnc_ledger_display_record_loaded (ld, splits);
 
     ld->loading = FALSE;
 }
@@ -894,7 +1040,9 @@ gnc_ledger_display_refresh (GNCLedgerDisplay* ld)
         return;
     }
 
+    qof_trace_begin ("register", "refresh", NULL);
     gnc_ledger_display_refresh_internal (ld, qof_query_run (ld->query));
+    qof_trace_end ();
     LEAVE (" ");
 }
 
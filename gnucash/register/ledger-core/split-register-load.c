@@ -30,6 +30,7 @@
 #include "combocell.h"
 #include "gnc-component-manager.h"
 #include "qof.h"
+#include "gnc-trans-quickfill.h"
 #include "gnc-ui-util.h"
 #include "gnc-gui-query.h"
 #include "numcell.h"
@@ -236,11 +237,21 @@ _find_split_with_parent_txn (gconstpointer a, gconstpointer b)
 }
 
 static void add_quickfill_completions (TableLayout* layout, Transaction* trans,
-                                       Split* split, gboolean has_last_num)
+                                       Split* split, gboolean has_last_num,
+                                       gboolean shared_quickfills)
 {
     Split* s;
     int i = 0;
 
+    if (!has_last_num)
+        gnc_num_cell_set_last_num (
+            (NumCell*) gnc_table_layout_get_cell (layout, NUM_CELL),
+            gnc_get_num_action (trans, split));
+
+    /* The shared quickfills fill themselves from the account. */
+    if (shared_quickfills)
+        return;
+
     gnc_quickfill_cell_add_completion (
         (QuickFillCell*) gnc_table_layout_get_cell (layout, DESC_CELL),
         xaccTransGetDescription (trans));
@@ -249,11 +260,6 @@ static void add_quickfill_completions (TableLayout* layout, Transaction* trans,
         (QuickFillCell*) gnc_table_layout_get_cell (layout, NOTES_CELL),
         xaccTransGetNotes (trans));
 
-    if (!has_last_num)
-        gnc_num_cell_set_last_num (
-            (NumCell*) gnc_table_layout_get_cell (layout, NUM_CELL),
-            gnc_get_num_action (trans, split));
-
     while ((s = xaccTransGetSplit (trans, i)) != NULL)
     {
         gnc_quickfill_cell_add_completion (
@@ -263,6 +269,20 @@ static void add_quickfill_completions (TableLayout* layout, Transaction* trans,
     }
 }
 
+static void
+gnc_split_register_use_shared_quickfill (SplitRegister* reg,
+                                         const char* cell_name,
+                                         Account* account,
+                                         GncTransQuickFillField field)
+{
+    QuickFillCell* cell;
+
+    cell = (QuickFillCell*) gnc_table_layout_get_cell (reg->table->layout,
+                                                       cell_name);
+    gnc_quickfill_cell_use_quickfill_cache (cell,
+        gnc_get_shared_trans_quickfill (account, field));
+}
+
 static Split*
 create_blank_split (Account* default_account, SRInfo* info)
 {
@@ -372,6 +392,7 @@ gnc_split_register_load (SplitRegister* reg, GList* slist,
 
     gboolean start_primary_color = TRUE;
     gboolean found_pending = FALSE;
+    gboolean shared_quickfills = FALSE;
     gboolean need_divider_upper = FALSE;
     gboolean found_divider_upper = FALSE;
     gboolean found_divider = FALSE;
@@ -401,6 +422,8 @@ gnc_split_register_load (SplitRegister* reg, GList* slist,
     g_return_if_fail (info);
 
     ENTER ("reg=%p, slist=%p, default_account=%p", reg, slist, default_account);
+    qof_trace_begin ("register", "load",
+                     default_account ? xaccAccountGetName (default_account) : NULL);
 
     blank_split = xaccSplitLookup (&info->blank_split_guid,
                                    gnc_get_current_book());
@@ -533,6 +556,23 @@ gnc_split_register_load (SplitRegister* reg, GList* slist,
         gnc_split_register_load_doclink_cells (reg);
         gnc_split_register_load_recn_cells (reg);
         gnc_split_register_load_type_cells (reg);
+
+        /* A register of a single account shares its description,
+         * notes and memo completions with every other register of the
+         * account; they are filled in the background. */
+        if (default_account && reg->type < NUM_SINGLE_REGISTER_TYPES)
+        {
+            gnc_split_register_use_shared_quickfill (reg, DESC_CELL,
+                                                     default_account,
+                                                     GNC_TRANS_QF_DESCRIPTION);
+            gnc_split_register_use_shared_quickfill (reg, NOTES_CELL,
+                                                     default_account,
+                                                     GNC_TRANS_QF_NOTES);
+            gnc_split_register_use_shared_quickfill (reg, MEMO_CELL,
+                                                     default_account,
+                                                     GNC_TRANS_QF_MEMO);
+            shared_quickfills = TRUE;
+        }
     }
 
     if (info->separator_changed)
@@ -542,20 +582,17 @@ gnc_split_register_load (SplitRegister* reg, GList* slist,
     table->model->dividing_row = -1;
     table->model->dividing_row_lower = -1;
 
-    // Ensure that the transaction and splits being edited are in the split
-    // list we're about to load.
-    if (pending_trans != NULL)
+    // Ensure that the transaction being edited is in the split list we're
+    // about to load. One split of it is enough, so a single scan of the
+    // list answers for all of its splits.
+    if (pending_trans != NULL &&
+        g_list_find_custom (slist, pending_trans,
+                            _find_split_with_parent_txn) == NULL)
     {
         for (node = xaccTransGetSplitList (pending_trans); node; node = node->next)
         {
             Split* pending_split = (Split*)node->data;
             if (!xaccTransStillHasSplit (pending_trans, pending_split)) continue;
-            if (g_list_find (slist, pending_split) != NULL)
-                continue;
-
-            if (g_list_find_custom (slist, pending_trans,
-                                    _find_split_with_parent_txn) != NULL)
-                continue;
 
             if (!we_own_slist)
             {
@@ -564,6 +601,7 @@ gnc_split_register_load (SplitRegister* reg, GList* slist,
                 we_own_slist = TRUE;
             }
             slist = g_list_append (slist, pending_split);
+            break;
         }
     }
 
@@ -662,7 +700,8 @@ gnc_split_register_load (SplitRegister* reg, GList* slist,
         /* If this is the first load of the register,
          * fill up the quickfill cells. */
         if (info->first_pass)
-            add_quickfill_completions (reg->table->layout, trans, split, has_last_num);
+            add_quickfill_completions (reg->table->layout, trans, split,
+                                       has_last_num, shared_quickfills);
 
         if (trans == find_trans)
             new_trans_row = vcell_loc.virt_row;
@@ -807,6 +846,7 @@ gnc_split_register_load (SplitRegister* reg, GList* slist,
     if (we_own_slist)
         g_list_free (slist);
 
+    qof_trace_end ();
     LEAVE (" ");
 }
 
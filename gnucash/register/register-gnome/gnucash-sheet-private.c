@@ -59,31 +59,39 @@ find_block_by_pixel (GnucashSheet *sheet,
 {
     SheetBlock *block;
     VirtualCellLocation vc_loc = { 1, 0 };
+    gint lo = 1, hi = sheet->num_virt_rows;
 
     g_return_val_if_fail (y >= 0, NULL);
     g_return_val_if_fail (x >= 0, NULL);
 
-    do
+    /* Block origins only grow down the sheet, so the block holding y
+     * is the first one that ends below it. */
+    while (lo < hi)
     {
+        gint bottom;
+
+        vc_loc.virt_row = lo + (hi - lo) / 2;
         block = gnucash_sheet_get_block (sheet, vc_loc);
         if (!block)
             return NULL;
 
-        if (block->visible &&
-                y >= block->origin_y &&
-                y < block->origin_y + block->style->dimensions->height)
-        {
-            if (vcell_loc)
-                vcell_loc->virt_row = vc_loc.virt_row;
-            break;
-        }
-        vc_loc.virt_row++;
+        bottom = block->origin_y;
+        if (block->visible)
+            bottom += block->style->dimensions->height;
+
+        if (bottom > y)
+            hi = vc_loc.virt_row;
+        else
+            lo = vc_loc.virt_row + 1;
     }
-    while (vc_loc.virt_row < sheet->num_virt_rows);
 
-    if (vc_loc.virt_row == sheet->num_virt_rows)
+    if (lo == sheet->num_virt_rows)
         return NULL;
 
+    vc_loc.virt_row = lo;
+    if (vcell_loc)
+        vcell_loc->virt_row = vc_loc.virt_row;
+
     do
     {
         block = gnucash_sheet_get_block (sheet, vc_loc);
@@ -493,7 +501,13 @@ draw_cell (GnucashSheet *sheet, SheetBlock *block,
                        table->model->dividing_row_lower, block->style->nrows,
                        fg_color, x, y, width, height);
 
-    layout = gtk_widget_create_pango_layout (GTK_WIDGET (sheet), text);
+    /* One layout serves every cell; creating one per cell on every
+     * expose was a large part of the cost of scrolling. */
+    if (!sheet->cell_layout)
+        sheet->cell_layout = gtk_widget_create_pango_layout (GTK_WIDGET (sheet),
+                                                             NULL);
+    layout = sheet->cell_layout;
+    pango_layout_set_text (layout, text ? text : "", -1);
 
     if (gtk_style_context_has_class (stylectxt, GTK_STYLE_CLASS_VIEW))
         gtk_style_context_remove_class (stylectxt, GTK_STYLE_CLASS_VIEW);
@@ -557,7 +571,6 @@ exit:
     pango_font_description_set_style (font, PANGO_STYLE_NORMAL);
     pango_context_set_font_description (context, font);
     pango_font_description_free (font);
-    g_object_unref (layout);
 
     gtk_style_context_restore (stylectxt);
 }
@@ -565,7 +578,7 @@ exit:
 static void
 draw_block (GnucashSheet *sheet, SheetBlock *block,
             VirtualLocation virt_loc, cairo_t *cr,
-            int x, int y, int width, int height)
+            int x, int y, const GdkRectangle *clip)
 {
     CellDimensions *cd;
     gint x_paint;
@@ -588,11 +601,11 @@ draw_block (GnucashSheet *sheet, SheetBlock *block,
             if (!cd) break;
 
             x_paint = block->origin_x + cd->origin_x - x;
-            if (x_paint > width)
+            if (x_paint > clip->x + clip->width)
                 break;
 
             y_paint = block->origin_y + cd->origin_y - y;
-            if (y_paint > height)
+            if (y_paint > clip->y + clip->height)
                 return;
 
             h = cd->pixel_height;
@@ -601,10 +614,10 @@ draw_block (GnucashSheet *sheet, SheetBlock *block,
             if (w == 0)
                 continue;
 
-            if (x_paint + w < 0)
+            if (x_paint + w < clip->x)
                 continue;
 
-            if (y_paint + h < 0)
+            if (y_paint + h < clip->y)
                 continue;
 
             draw_cell (sheet, block, virt_loc, cr,
@@ -619,10 +632,9 @@ gnucash_sheet_draw_internal (GnucashSheet* sheet, cairo_t* cr,
 {
     VirtualLocation virt_loc = {{0, 0}, 0, 0};
     SheetBlock *sheet_block;
+    GdkRectangle clip;
     int x = 0;
     int y = 0;
-    int width = alloc->width;
-    int height = alloc->height;
     GtkAdjustment * adj;
 
     adj = gtk_scrollable_get_hadjustment (GTK_SCROLLABLE(sheet));
@@ -633,8 +645,19 @@ gnucash_sheet_draw_internal (GnucashSheet* sheet, cairo_t* cr,
     if (x < 0 || y < 0)
         return FALSE;
 
+    /* Only the damaged part of the window needs drawing. */
+    if (!gdk_cairo_get_clip_rectangle (cr, &clip))
+    {
+        clip.x = 0;
+        clip.y = 0;
+        clip.width = alloc->width;
+        clip.height = alloc->height;
+    }
+    clip.x = MAX (clip.x, 0);
+    clip.y = MAX (clip.y, 0);
+
     /* compute our initial values where we start drawing */
-    sheet_block = find_block_by_pixel (sheet, x, y, &virt_loc.vcell_loc);
+    sheet_block = find_block_by_pixel (sheet, x, y + clip.y, &virt_loc.vcell_loc);
     if (!sheet_block || !sheet_block->style)
         return FALSE;
 
@@ -656,11 +679,10 @@ gnucash_sheet_draw_internal (GnucashSheet* sheet, cairo_t* cr,
             virt_loc.vcell_loc.virt_row++;
         }
 
-        if (y + height < sheet_block->origin_y)
+        if (y + clip.y + clip.height < sheet_block->origin_y)
             return TRUE;
 
-        draw_block (sheet, sheet_block, virt_loc, cr,
-                    x, y, width, height);
+        draw_block (sheet, sheet_block, virt_loc, cr, x, y, &clip);
     }
     return TRUE;
 }
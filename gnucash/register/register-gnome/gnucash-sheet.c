@@ -817,6 +817,8 @@ gnucash_sheet_finalize (GObject *object)
     g_hash_table_destroy (sheet->cursor_styles);
     g_hash_table_destroy (sheet->dimensions_hash_table);
 
+    g_clear_object (&sheet->cell_layout);
+
     if (G_OBJECT_CLASS(sheet_parent_class)->finalize)
         (*G_OBJECT_CLASS(sheet_parent_class)->finalize)(object);
 }
@@ -2360,6 +2362,7 @@ gnucash_sheet_init (GnucashSheet *sheet)
     sheet->num_virt_cols = 0;
     sheet->item_editor = NULL;
     sheet->entry = NULL;
+    sheet->cell_layout = NULL;
     sheet->editing = FALSE;
     sheet->button = 0;
     sheet->grabbed = FALSE;
@@ -64,6 +64,8 @@ struct _GnucashSheet
     GtkWidget *item_editor;
     GtkWidget *entry;
 
+    PangoLayout *cell_layout; /** Reused to draw the text of every cell */
+
     gboolean   use_gnc_color_theme;
     gboolean   use_horizontal_lines;
     gboolean   use_vertical_lines;
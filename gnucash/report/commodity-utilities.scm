@@ -301,8 +301,32 @@
 ;; Find the price in 'pricelist' that's nearest to 'date'. The
 ;; pricelist comes from
 ;; e.g. gnc:get-commodity-totalavg-prices. Returns a <gnc-numeric> or,
-;; if pricelist was empty, #f.
+;; if pricelist was empty, #f. The pricelist may also be given as a
+;; vector, which is searched by bisection.
 (define (gnc:pricelist-price-find-nearest pricelist date)
+  (if (vector? pricelist)
+      (pricevector-price-find-nearest pricelist date)
+      (pricelist-price-find-nearest pricelist date)))
+
+(define (pricevector-price-find-nearest pricevec date)
+  ;; same answer as the list walk below: find the first later entry
+  ;; whose date isn't before 'date', then pick the nearer neighbour.
+  (let ((len (vector-length pricevec)))
+    (and (positive? len)
+         (let lp ((lo 1) (hi len))
+           (if (< lo hi)
+               (let ((mid (quotient (+ lo hi) 2)))
+                 (if (< (car (vector-ref pricevec mid)) date)
+                     (lp (1+ mid) hi)
+                     (lp lo mid)))
+               (if (= lo len)
+                   (cadr (vector-ref pricevec (1- len)))
+                   (match (list (vector-ref pricevec (1- lo))
+                                (vector-ref pricevec lo))
+                     (((date1 price1) (date2 price2))
+                      (if (< (- date date1) (- date2 date)) price1 price2)))))))))
+
+(define (pricelist-price-find-nearest pricelist date)
   (let lp ((pricelist pricelist))
     (match pricelist
       (() #f)
@@ -855,14 +879,22 @@
                                           report-currency to-date-tp))))
                       (lambda (foreign domestic date)
                         (exchange-fn foreign domestic))))
-    ((weighted-average) (let ((pricealist
-                               (gnc:get-commoditylist-totalavg-prices
-                                commodity-list report-currency to-date-tp
-                                start-percent delta-percent)))
+    ;; the price series are built once per distinct commodity and
+    ;; kept as vectors so that each lookup is a bisection.
+    ((weighted-average) (let* ((pricealist
+                                (gnc:get-commoditylist-totalavg-prices
+                                 (delete-duplicates commodity-list
+                                                    gnc-commodity-equiv)
+                                 report-currency to-date-tp
+                                 start-percent delta-percent))
+                               (pricevecs
+                                (map (lambda (p)
+                                       (cons (car p) (list->vector (cdr p))))
+                                     pricealist)))
                           (gnc:debug "weighted-average pricealist " pricealist)
                           (lambda (foreign domestic date)
                             (gnc:exchange-by-pricealist-nearest
-                             pricealist foreign domestic date))))
+                             pricevecs foreign domestic date))))
     ((pricedb-before) gnc:exchange-by-pricedb-nearest-before)
     ((pricedb-latest) (lambda (foreign domestic date)
                         (gnc:exchange-by-pricedb-latest foreign domestic)))
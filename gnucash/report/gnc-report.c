@@ -50,6 +50,11 @@ static QofLogModule log_module = GNC_MOD_GUI;
 static GHashTable *reports = NULL;
 static gint report_next_serial_id = 0;
 
+/* Bumped on every engine event, so cached report output can tell
+ * whether anything it was computed from may have changed. */
+static guint64 book_generation = 0;
+static gint book_generation_handler_id = 0;
+
 static gboolean
 try_load_config_array(const gchar *fns[])
 {
@@ -186,6 +191,24 @@ gint gnc_report_add(SCM report)
     return G_MAXINT;
 }
 
+static void
+book_generation_event_handler (QofInstance *ent, QofEventId event_type,
+                               gpointer handler_data, gpointer event_data)
+{
+    book_generation++;
+}
+
+guint64
+gnc_report_book_generation (void)
+{
+    /* Changes made before the first call can't matter: nothing has been
+     * cached against a generation yet. */
+    if (!book_generation_handler_id)
+        book_generation_handler_id =
+            qof_event_register_handler (book_generation_event_handler, NULL);
+    return book_generation;
+}
+
 static gboolean
 yes_remove(gpointer key, gpointer val, gpointer data)
 {
@@ -59,6 +59,11 @@ SCM gnc_report_find(gint id);
 void gnc_report_remove_by_id(gint id);
 gint gnc_report_add(SCM report);
 
+/** A counter that changes whenever the engine reports a change to any
+ *  book object. Report output cached at one value may be reused only
+ *  while the counter still has that value. */
+guint64 gnc_report_book_generation (void);
+
 void gnc_reports_flush_global(void);
 GHashTable *gnc_reports_get_global(void);
 
@@ -61,7 +61,9 @@
 (export gnc:html-document?)
 (export gnc:html-document-set-style!)
 (export gnc:html-document-tree-collapse)
+(export gnc:html-document-tree-write)
 (export gnc:html-document-render)
+(export gnc:html-document-render-to-port)
 (export gnc:html-document-push-style)
 (export gnc:html-document-pop-style)
 (export gnc:html-document-add-object!)
@@ -154,6 +156,19 @@
           ((string? e) (cons e accum))
           (else (cons (object->string e) accum)))))
 
+;; writes a tree of the kind the render functions return, each list
+;; holding its parts last first, to port in document order.
+(define (gnc:html-document-tree-write tree port)
+  (let lp ((e tree))
+    (cond ((null? e) #f)
+          ((pair? e) (for-each lp (reverse e)))
+          ((string? e) (display e port))
+          (else (display (object->string e) port)))))
+
+;; the port gnc:html-document-render-to-port writes to, for the
+;; trivial render to find after going through the style sheet.
+(define render-port (make-parameter #f))
+
 ;; first optional argument is "headers?"
 ;; returns the html document as a string, I think.
 (define (gnc:html-document-render doc . rest)
@@ -166,8 +181,12 @@
         (gnc:html-style-sheet-render stylesheet doc headers?)
 
         ;; otherwise, do the trivial render.
-        (let* ((retval '())
-               (push (lambda (l) (set! retval (cons l retval))))
+        (let* ((port (render-port))
+               (retval '())
+               (push (lambda (l)
+                       (if port
+                           (gnc:html-document-tree-write l port)
+                           (set! retval (cons l retval)))))
                (objs (gnc:html-document-objects doc))
                (title (gnc:html-document-title doc)))
           ;; compile the doc style
@@ -197,10 +216,18 @@
             ;; attributes like bgcolor get included
             (push ((gnc:html-markup/open-tag-only "body") doc)))
 
-          ;; now render the children
+          ;; now render the children. when writing to a port, the
+          ;; rows of a table at the top level go out as they are
+          ;; rendered; anything rendered inside a child is a string.
           (for-each
            (lambda (child)
-               (push (gnc:html-object-render child doc)))
+             (parameterize ((render-port #f))
+               (if (and port
+                        (gnc:html-object? child)
+                        (eq? (gnc:html-object-renderer child) gnc:html-table-render))
+                   (gnc:html-table-render-to-port
+                    (gnc:html-object-data child) doc port)
+                   (push (gnc:html-object-render child doc)))))
            objs)
 
           (when headers?
@@ -211,7 +238,17 @@
           (gnc:html-document-pop-style doc)
           (gnc:html-style-table-uncompile (gnc:html-document-style doc))
 
-          (string-concatenate (gnc:html-document-tree-collapse retval))))))
+          (if port
+              ""
+              (string-concatenate (gnc:html-document-tree-collapse retval)))))))
+
+;; renders the document like gnc:html-document-render, but writes the
+;; html to port as it goes instead of returning it as a string, so the
+;; rows of a long table needn't all be held at once.
+(define (gnc:html-document-render-to-port doc port . rest)
+  (parameterize ((render-port port))
+    (apply gnc:html-document-render doc rest))
+  *unspecified*)
 
 
 (define (gnc:html-document-push-style doc style)
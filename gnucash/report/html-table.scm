@@ -99,6 +99,7 @@
 (export gnc:html-table-set-cell/tag!)
 (export gnc:html-table-append-column!)
 (export gnc:html-table-render)
+(export gnc:html-table-render-to-port)
 
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 ;; 
@@ -437,8 +438,22 @@ populate html-table row-wise using gnc:html-table-append-row! instead.")
           (1+ numrows))))))
 
 (define (gnc:html-table-render table doc)
+  (html-table-render table doc #f))
+
+;; writes the table to port a row at a time instead of returning it, so
+;; that the rows needn't all be held at once.
+(define (gnc:html-table-render-to-port table doc port)
+  (html-table-render table doc port))
+
+;; returns the rendered table, or if port is given writes it there as
+;; it goes and returns '().
+(define (html-table-render table doc port)
   (let* ((retval '())
-         (push (lambda (l) (set! retval (cons l retval)))))
+         (push (lambda (l) (set! retval (cons l retval))))
+         (flush (lambda ()
+                  (when port
+                    (gnc:html-document-tree-write retval port)
+                    (set! retval '())))))
 
     ;; compile the table style to make other compiles faster
     (gnc:html-style-table-compile (gnc:html-table-style table)
@@ -550,6 +565,7 @@ populate html-table row-wise using gnc:html-table-append-row! instead.")
           (when rowstyle (gnc:html-document-push-style doc rowstyle))
           (push (gnc:html-document-markup-end doc rowmarkup))
           (when rowstyle (gnc:html-document-pop-style doc))
+          (flush)
 
           (rowloop (cdr rows) (1+ rownum)))))
     (push (gnc:html-document-markup-end doc "tbody"))
@@ -557,6 +573,7 @@ populate html-table row-wise using gnc:html-table-append-row! instead.")
     ;; write the table end tag and pop the table style
     (push (gnc:html-document-markup-end doc "table"))
     (gnc:html-document-pop-style doc)
+    (flush)
     retval))
 
 (define (gnc:html-table-set-last-row-style! table tag . rest)
@@ -44,10 +44,12 @@
 (export <report>)
 (export gnc:all-report-template-guids)
 (export gnc:custom-report-template-guids)
+(export gnc:declare-report-template)
 (export gnc:define-report)
 (export gnc:delete-report)
 (export gnc:find-report-template)
 (export gnc:is-custom-report-type)
+(export gnc:load-report-module)
 (export gnc:make-report)
 (export gnc:make-report-options)
 (export gnc:menuname-asset-liability)
@@ -73,12 +75,14 @@
 (export gnc:report-export-thunk)
 (export gnc:report-export-types)
 (export gnc:report-id)
+(export gnc:report-manifest-entries)
 (export gnc:report-menu-name)
 (export gnc:report-name)
 (export gnc:report-needs-save?)
 (export gnc:report-options)
 (export gnc:report-render-html)
 (export gnc:render-report)
+(export gnc:report-render-to-port)
 (export gnc:report-run)
 (export gnc:report-serialize)
 (export gnc:report-set-ctext!)
@@ -146,6 +150,12 @@
 ;; value is the report definition structure.
 (define *gnc:_report-templates_* (make-hash-table 23))
 
+;; Templates declared from the report manifest whose module hasn't
+;; been loaded yet. The key is the report guid and the value is the
+;; module defining it. Loading the module fills in the declared
+;; template, see gnc:define-report.
+(define *gnc:_report-template-stubs_* (make-hash-table 23))
+
 ;; Define those strings here to make changes easier and avoid typos.
 (define gnc:menuname-reports "Reports/StandardReports")
 (define gnc:menuname-asset-liability (N_ "_Assets & Liabilities"))
@@ -169,7 +179,7 @@
   (make-new-record-template version name report-guid parent-type options-generator
                             options-cleanup-cb options-changed-cb
                             renderer in-menu? menu-path menu-name
-                            menu-tip export-types export-thunk)
+                            menu-tip export-types export-thunk module)
   report-template?
   (version report-template-version)
   (report-guid report-template-report-guid report-template-set-report-guid!)
@@ -184,10 +194,27 @@
   (menu-name report-template-menu-name)
   (menu-tip report-template-menu-tip)
   (export-types report-template-export-types)
-  (export-thunk report-template-export-thunk))
+  (export-thunk report-template-export-thunk)
+  (module report-template-module report-template-set-module!))
 
 (define (make-report-template)
-  (make-new-record-template #f #f #f #f #f #f #f #f #t #f #f #f #f #f))
+  (make-new-record-template #f #f #f #f #f #f #f #f #t #f #f #f #f #f #f))
+
+;; loads the module of a template declared from the manifest, which
+;; fills in the rest of the template.
+(define (load-report-template! templ)
+  (let* ((guid (report-template-report-guid templ))
+         (module (hash-ref *gnc:_report-template-stubs_* guid)))
+    (when module
+      (gnc:load-report-module module)
+      (when (hash-ref *gnc:_report-template-stubs_* guid)
+        (hash-remove! *gnc:_report-template-stubs_* guid)
+        (gnc:warn "report module " module " doesn't define report " guid)))
+    templ))
+
+(define (after-loading accessor)
+  (lambda (templ) (accessor (load-report-template! templ))))
+
 (define gnc:report-template-version report-template-version)
 (define gnc:report-template-report-guid report-template-report-guid)
 (define gnc:report-template-set-report-guid! report-template-set-report-guid!)
@@ -195,16 +222,16 @@
 (define gnc:report-template-set-name report-template-set-name)
 (define gnc:report-template-parent-type report-template-parent-type)
 (define gnc:report-template-set-parent-type! report-template-set-parent-type!)
-(define gnc:report-template-options-generator report-template-options-generator)
-(define gnc:report-template-options-cleanup-cb report-template-options-cleanup-cb)
-(define gnc:report-template-options-changed-cb report-template-options-changed-cb)
-(define gnc:report-template-renderer report-template-renderer)
+(define gnc:report-template-options-generator (after-loading report-template-options-generator))
+(define gnc:report-template-options-cleanup-cb (after-loading report-template-options-cleanup-cb))
+(define gnc:report-template-options-changed-cb (after-loading report-template-options-changed-cb))
+(define gnc:report-template-renderer (after-loading report-template-renderer))
 (define gnc:report-template-in-menu? report-template-in-menu?)
 (define gnc:report-template-menu-path report-template-menu-path)
 (define gnc:report-template-menu-name report-template-menu-name)
 (define gnc:report-template-menu-tip report-template-menu-tip)
-(define gnc:report-template-export-types report-template-export-types)
-(define gnc:report-template-export-thunk report-template-export-thunk)
+(define gnc:report-template-export-types (after-loading report-template-export-types))
+(define gnc:report-template-export-thunk (after-loading report-template-export-thunk))
 
 ;; define strings centrally to ease code clarity
 (define rpterr-dupe
@@ -240,6 +267,9 @@ not found.")))
   (define (not-a-field? fld) (not (memq fld allowable-fields)))
   (define (xor . args) (fold (lambda (a b) (if a (if b #f a) b)) #f args))
 
+  ;; the module whose loading defines the report
+  (report-template-set-module! report-rec (module-name (current-module)))
+
   (let loop ((args args))
     (match args
       (()
@@ -250,6 +280,17 @@ not found.")))
           ((not report-guid)
            (gui-error (string-append rpterr-guid1 report-name rpterr-guid2)))
 
+          ;; declared from the manifest: complete the declared
+          ;; template, which menus and reports may already refer to
+          ((hash-ref *gnc:_report-template-stubs_* report-guid)
+           (let ((templ (hash-ref *gnc:_report-templates_* report-guid)))
+             (hash-remove! *gnc:_report-template-stubs_* report-guid)
+             (for-each
+              (lambda (fld)
+                ((record-modifier <report-template> fld)
+                 templ ((record-accessor <report-template> fld) report-rec)))
+              allowable-fields)))
+
           ;; dupe: report-guid is a duplicate
           ((hash-ref *gnc:_report-templates_* report-guid)
            (gui-error (string-append rpterr-dupe report-guid)))
@@ -284,7 +325,64 @@ not found.")))
 (define (gnc:report-template-renderer/report-guid template-id template-name)
   (let ((templ (hash-ref *gnc:_report-templates_* template-id)))
     (and templ
-         (gnc:report-template-renderer templ))))
+         (if (hash-ref *gnc:_report-template-stubs_* template-id)
+             ;; saved reports ask for this as they are loaded; leave
+             ;; loading the parent's module until the report is run
+             (lambda (report) ((gnc:report-template-renderer templ) report))
+             (gnc:report-template-renderer templ)))))
+
+;; The report manifest lets the standard reports be offered in the menus
+;; without loading their modules. Each entry is the defining module and
+;; what the menus need of the template, as an alist of field values.
+(define manifest-fields
+  '(version name report-guid parent-type in-menu? menu-path menu-name menu-tip))
+
+(define (gnc:load-report-module module)
+  (call-with-trace-span "load-module" (format #f "~a" module)
+    (lambda ()
+      (resolve-interface module))))
+
+;; manifest entries for the templates defined by the modules under
+;; mod-prefix, or #f if one of them can't be written and read back.
+(define (gnc:report-manifest-entries mod-prefix)
+  (define (under-prefix? module)
+    (and (> (length module) (length mod-prefix))
+         (equal? mod-prefix (list-head module (length mod-prefix)))))
+  (define (readable? val)
+    (or (string? val) (symbol? val) (number? val) (boolean? val) (null? val)
+        (and (pair? val) (readable? (car val)) (readable? (cdr val)))))
+  (let ((entries
+         (filter-map
+          (lambda (templ)
+            (let ((module (report-template-module templ)))
+              (and module
+                   (not (report-template-parent-type templ))
+                   (under-prefix? module)
+                   (cons module
+                         (map (lambda (fld)
+                                (cons fld ((record-accessor <report-template> fld)
+                                           templ)))
+                              manifest-fields)))))
+          (hash-map->list (lambda (k v) v) *gnc:_report-templates_*))))
+    (and (every readable? entries)
+         entries)))
+
+(define (gnc:declare-report-template entry)
+  (match entry
+    ((module . fields)
+     (let ((templ (make-report-template))
+           (guid (assq-ref fields 'report-guid)))
+       (for-each
+        (match-lambda
+          (((? (cut memq <> manifest-fields) fld) . val)
+           ((record-modifier <report-template> fld) templ val))
+          (_ #f))
+        fields)
+       (report-template-set-module! templ module)
+       (unless (or (not guid) (hash-ref *gnc:_report-templates_* guid))
+         (hash-set! *gnc:_report-templates_* guid templ)
+         (hash-set! *gnc:_report-template-stubs_* guid module))))
+    (_ (gnc:warn "gnc:declare-report-template: bad entry " entry))))
 
 (define (gnc:report-template-new-options report-template)
   (let ((generator (gnc:report-template-options-generator report-template))
@@ -735,29 +833,56 @@ not found.")))
           (gnc:custom-report-templates-list))))
 
 
+;; the book generation and day each report's ctext was rendered at.
+;; the cached html is only good while neither has moved on.
+(define *gnc:_report-render-stamps_* (make-weak-key-hash-table))
+
+(define (report-render-stamp)
+  (cons (gnc-report-book-generation)
+        (gnc:time64-start-day-time (current-time))))
+
 ;; gets the renderer from the report template;
 ;; gets the stylesheet from the report;
-;; renders the html doc and caches the resulting string;
+;; renders the html doc and caches the resulting string
+;; until the report is dirtied or its stamp changes;
 ;; returns the html string.
 ;; Now accepts either an html-doc or finished HTML from the renderer -
 ;; the former requires further processing, the latter is just returned.
 (define (gnc:report-render-html report headers?)
   (if (and (not (gnc:report-dirty? report))
-           (gnc:report-ctext report))
+           (gnc:report-ctext report)
+           (equal? (hashq-ref *gnc:_report-render-stamps_* report)
+                   (report-render-stamp)))
       (gnc:report-ctext report)
       (let ((template (hash-ref *gnc:_report-templates_* (gnc:report-type report))))
         (and template
-             (let* ((renderer (gnc:report-template-renderer template))
-                    (stylesheet (gnc:report-stylesheet report))
-                    (doc (renderer report))
-                    (html (cond
-                           ((string? doc) doc)
-                           (else
-                            (gnc:html-document-set-style-sheet! doc stylesheet)
-                            (gnc:html-document-render doc headers?)))))
-               (gnc:report-set-ctext! report html) ;; cache the html
-               (gnc:report-set-dirty?! report #f)  ;; mark it clean
-               html)))))
+             (call-with-trace-span
+              "render" (gnc:report-template-name template)
+              (lambda ()
+                (let* ((stamp (report-render-stamp))
+                       (renderer (gnc:report-template-renderer template))
+                       (stylesheet (gnc:report-stylesheet report))
+                       (doc (call-with-trace-span
+                             "renderer" "" (lambda () (renderer report))))
+                       (html (cond
+                              ((string? doc) doc)
+                              (else
+                               (gnc:html-document-set-style-sheet! doc stylesheet)
+                               (call-with-trace-span
+                                "html" ""
+                                (lambda () (gnc:html-document-render doc headers?)))))))
+                  (gnc:report-set-ctext! report html) ;; cache the html
+                  (hashq-set! *gnc:_report-render-stamps_* report stamp)
+                  (gnc:report-set-dirty?! report #f)  ;; mark it clean
+                  html)))))))
+
+;; calls thunk inside a tracing span of the "report" category, see
+;; qoftrace.h; the span is closed however thunk exits.
+(define (call-with-trace-span name detail thunk)
+  (dynamic-wind
+    (lambda () (qof-trace-begin "report" name detail))
+    thunk
+    (lambda () (qof-trace-end))))
 
 ;; render report. will return a 2-element list: either (list html #f)
 ;; where html is the report html string, or (list #f captured-error)
@@ -766,6 +891,29 @@ not found.")))
   (define (get-report) (gnc:report-render-html report #t))
   (gnc:apply-with-error-handling get-report '()))
 
+;; renders the report like gnc:report-render-html, but writes the html
+;; to port as it goes, a table row at a time, rather than building the
+;; whole string. the html isn't cached.
+(define (gnc:report-render-to-port report port headers?)
+  (let ((template (hash-ref *gnc:_report-templates_* (gnc:report-type report))))
+    (and template
+         (call-with-trace-span
+          "render" (gnc:report-template-name template)
+          (lambda ()
+            (let* ((renderer (gnc:report-template-renderer template))
+                   (doc (call-with-trace-span
+                         "renderer" "" (lambda () (renderer report)))))
+              (cond
+               ((string? doc) (display doc port))
+               (else
+                (gnc:html-document-set-style-sheet!
+                 doc (gnc:report-stylesheet report))
+                (call-with-trace-span
+                 "html" ""
+                 (lambda ()
+                   (gnc:html-document-render-to-port doc port headers?)))))
+              #t))))))
+
 ;; looks up the report by id and renders it with gnc:report-render-html
 ;; marks the cursor busy during rendering; returns the html
 (define (gnc:report-run id)
@@ -928,3 +1076,117 @@ not found.")))
   (match (reportname->templates report)
     ((template) (gnc:make-report (gnc:report-template-report-guid template)))
     (_ (gnc:error report " does not match unique report") #f)))
+
+;; In: id - a report id from gnc:cmdline-get-report-id
+;; In: file - name of the file to write the report html to
+;; Out: #f if written, else the error string
+(define-public (gnc:cmdline-report-to-file id file)
+  (define (write-report)
+    (call-with-output-file file
+      (lambda (port)
+        (gnc:report-render-to-port (gnc-report-find id) port #t)
+        (newline port))
+      #:encoding "UTF-8"))
+  (match (gnc:apply-with-error-handling write-report '())
+    ((_ #f) #f)
+    ((_ err) err)))
+
+;; Run thunk with every procedure of the engine's wrapper module
+;; counting the internal time units spent in it into the box
+;; engine-time.  Calls the engine makes back into wrapped procedures
+;; are counted once.  The wrappers' own overhead is counted as engine
+;; time, so the split is a little in the engine's disfavour.
+(define (call-with-engine-timing engine-time thunk)
+  (define depth 0)
+  (define saved '())
+  (define (timed proc)
+    (lambda args
+      (if (positive? depth)
+          (apply proc args)
+          (let ((start (get-internal-real-time)))
+            (set! depth 1)
+            (call-with-values (lambda () (apply proc args))
+              (lambda vals
+                (set! depth 0)
+                (variable-set! engine-time (+ (variable-ref engine-time)
+                                              (- (get-internal-real-time) start)))
+                (apply values vals)))))))
+  (dynamic-wind
+    (lambda ()
+      (module-for-each
+       (lambda (sym var)
+         (when (and (variable-bound? var) (procedure? (variable-ref var)))
+           (set! saved (cons (cons var (variable-ref var)) saved))
+           (variable-set! var (timed (variable-ref var)))))
+       (resolve-module '(sw_engine))))
+    thunk
+    (lambda ()
+      (for-each (lambda (p) (variable-set! (car p) (cdr p))) saved)
+      (set! saved '()))))
+
+;; In: report - string matching reportname
+;; In: iterations - number of times to run it
+;; In: port - where the timings go
+;; Runs the report iterations times against the loaded book and writes
+;; where the wall time went: making the report and its options, engine
+;; calls, the rest of the renderer's Scheme code, and turning the
+;; document into HTML.  When Guile has (statprof) a profile of the runs
+;; follows, which is statistical and so only a guide.
+;; Out: #f if the report doesn't match a unique template, else #t
+(define-public (gnc:cmdline-report-bench report iterations port)
+  (define (now) (get-internal-real-time))
+  (define (seconds t) (exact->inexact (/ t internal-time-units-per-second)))
+  (match (reportname->templates report)
+    ((template)
+     (let ((guid (gnc:report-template-report-guid template))
+           (statprof (false-if-exception (resolve-interface '(statprof))))
+           (engine (make-variable 0))
+           (options-time 0) (data-time 0) (scheme-time 0) (html-time 0))
+       (define (run-once)
+         (let* ((start (now))
+                (id (gnc:make-report guid))
+                (r (gnc-report-find id))
+                (tmpl (hash-ref *gnc:_report-templates_* (gnc:report-type r)))
+                (renderer (gnc:report-template-renderer tmpl))
+                (rendering (now))
+                (engine-before (variable-ref engine))
+                (doc (renderer r))
+                (rendered (now))
+                (engine-rendered (variable-ref engine)))
+           (unless (string? doc)
+             (gnc:html-document-set-style-sheet! doc (gnc:report-stylesheet r))
+             (gnc:html-document-render doc #t))
+           (let ((engine-done (variable-ref engine)))
+             (set! options-time (+ options-time (- rendering start)))
+             (set! data-time (+ data-time (- engine-done engine-before)))
+             (set! scheme-time (+ scheme-time (- rendered rendering)
+                                  (- engine-before engine-rendered)))
+             (set! html-time (+ html-time (- (now) rendered)
+                                (- engine-rendered engine-done))))
+           (gnc-report-remove-by-id id)))
+
+       (when statprof
+         ((module-ref statprof 'statprof-reset) 0 10000 #f)
+         ((module-ref statprof 'statprof-start)))
+       (call-with-engine-timing
+        engine (lambda () (do ((i 0 (1+ i))) ((>= i iterations)) (run-once))))
+       (when statprof
+         ((module-ref statprof 'statprof-stop)))
+
+       (format port "~a: ~a runs\n" (gnc:report-template-name template) iterations)
+       (format port "~12a ~12@a ~12@a\n" "phase" "total s" "mean ms")
+       (for-each
+        (lambda (phase)
+          (let ((total (seconds (cdr phase))))
+            (format port "~12a ~12,3f ~12,3f\n" (car phase) total
+                    (if (positive? iterations) (/ (* 1000 total) iterations) 0))))
+        (list (cons "options" options-time)
+              (cons "engine" data-time)
+              (cons "scheme" scheme-time)
+              (cons "html" html-time)
+              (cons "total" (+ options-time data-time scheme-time html-time))))
+       (when statprof
+         (format port "\n")
+         ((module-ref statprof 'statprof-display) port))
+       #t))
+    (_ (gnc:error report " does not match unique report") #f)))
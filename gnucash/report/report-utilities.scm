@@ -451,11 +451,15 @@
     (gnc:make-gnc-monetary (xaccAccountGetCommodity account) (or bal 0)))
   (define balance 0)
   (map amount->monetary
-       (gnc:account-accumulate-at-dates
-        account dates-list #:split->elt
-        (lambda (s)
-          (if s (set! balance (+ balance (or (split->amount s) 0))))
-          balance))))
+       (if (eq? split->amount xaccSplitGetAmount)
+           ;; plain balances come from the engine in one call
+           (car (gnc-accounts-get-balances-at-dates
+                 (list account) (sort dates-list <)))
+           (gnc:account-accumulate-at-dates
+            account dates-list #:split->elt
+            (lambda (s)
+              (if s (set! balance (+ balance (or (split->amount s) 0))))
+              balance)))))
 
 
 ;; this function will scan through account splitlist, building a list
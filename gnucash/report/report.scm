@@ -26,9 +26,11 @@
 
 (define-module (gnucash report))
 (use-modules (gnucash utilities)) 
+(use-modules (ice-9 match))
 (use-modules (ice-9 regex))
 (use-modules (srfi srfi-1))
 (use-modules (srfi srfi-19))
+(use-modules (srfi srfi-26))
 (use-modules (gnucash core-utils))
 (use-modules (gnucash engine))
 (use-modules (gnucash app-utils))
@@ -55,6 +57,7 @@
 ;; Report uuids used for the category barcharts
 
 (export report-module-loader)
+(export lazy-report-module-loader)
 (export category-barchart-income-uuid)
 (export category-barchart-expense-uuid)
 (export category-barchart-asset-uuid)
@@ -65,6 +68,49 @@
 (define category-barchart-asset-uuid "e9cf815f79db44bcb637d0295093ae3d")
 (define category-barchart-liability-uuid "faf410e8f8da481fbc09e4763da40bcc")
 
+;; Returns a list of the scm files in a directory, without the suffix
+;;
+;; Param:
+;;   dir - directory name
+;;
+;; Return value:
+;;   list of files in the directory
+(define (directory-files dir)
+  (cond
+    ((file-exists? dir)
+     (let ((dir-stream (opendir dir)))
+          (let loop ((fname (readdir dir-stream))
+                     (acc '()))
+                    (cond
+                      ((eof-object? fname)
+                       (closedir dir-stream)
+                       acc)
+                      (else
+                        (loop (readdir dir-stream)
+                              (if (string-suffix? ".scm" fname)
+                                  (cons (string-drop-right fname 4) acc)
+                                  acc)))))))
+    (else
+      (gnc:warn "Can't access " dir ".\nEmpty list will be returned.")
+      '())))
+
+(define (module-directory mod-prefix)
+  (gnc-build-scm-path (string-join (map symbol->string mod-prefix) "/")))
+
+;; Return a list of symbols representing modules in the directory
+;; matching the prefix
+;;
+;; Return value:
+;;  List of symbols for modules
+(define (get-module-list mod-prefix)
+  (let* ((subdir (string-join (map symbol->string mod-prefix) "/"))
+         (mod-dir (module-directory mod-prefix))
+         (mod-list (directory-files mod-dir)))
+        (gnc:debug "rpt-subdir=" subdir)
+        (gnc:debug "mod-dir=" mod-dir)
+        (gnc:debug "dir-files=" mod-list)
+   (map string->symbol mod-list)))
+
 ;; Given a list of module prefixes, load all guile modules with these prefixes
 ;; This assumes the modules are located on the file system in a
 ;; path matching the module prefix
@@ -77,47 +123,6 @@
 ;; This function is non-recursive so it won't
 ;; descend in subdirectories.
 (define (report-module-loader mod-prefix-list)
-
-  ;; Returns a list of files in a directory
-  ;;
-  ;; Param:
-  ;;   dir - directory name
-  ;;
-  ;; Return value:
-  ;;   list of files in the directory
-  (define (directory-files dir)
-    (cond
-      ((file-exists? dir)
-       (let ((dir-stream (opendir dir)))
-            (let loop ((fname (readdir dir-stream))
-                       (acc '()))
-                      (cond
-                        ((eof-object? fname)
-                         (closedir dir-stream)
-                         acc)
-                        (else
-                          (loop (readdir dir-stream)
-                                (if (string-suffix? ".scm" fname)
-                                    (cons (string-drop-right fname 4) acc)
-                                    acc)))))))
-      (else
-        (gnc:warn "Can't access " dir ".\nEmpty list will be returned.")
-        '())))
-
-    ;; Return a list of symbols representing modules in the directory
-    ;; matching the prefix
-    ;;
-    ;; Return value:
-    ;;  List of symbols for modules
-  (define (get-module-list mod-prefix)
-    (let* ((subdir (string-join (map symbol->string mod-prefix) "/"))
-           (mod-dir (gnc-build-scm-path subdir))
-           (mod-list (directory-files mod-dir)))
-          (gnc:debug "rpt-subdir=" subdir)
-          (gnc:debug "mod-dir=" mod-dir)
-          (gnc:debug "dir-files=" mod-list)
-     (map string->symbol mod-list)))
-
   (for-each
     (lambda (mod-prefix)
       (for-each
@@ -129,5 +134,81 @@
         (get-module-list mod-prefix)))
     mod-prefix-list))
 
+;; The report manifest caches, for each directory of report modules,
+;; the reports its modules define, so that the next start can offer
+;; them without loading a single one. A directory's entry is thrown
+;; away when the GnuCash version or any file's modification time
+;; changes.
+(define (report-manifest-file)
+  (gnc-build-userdata-path "report-manifest.scm"))
+
+(define (read-report-manifest)
+  (let ((file (report-manifest-file)))
+    (or (and (file-exists? file)
+             (catch #t
+               (lambda ()
+                 (let ((manifest (call-with-input-file file read)))
+                   (and (list? manifest) manifest)))
+               (lambda (key . args)
+                 (gnc:warn "Can't read the report manifest " file ": " key)
+                 #f)))
+        '())))
+
+(define (write-report-manifest manifest)
+  (let ((file (report-manifest-file)))
+    (catch #t
+      (lambda ()
+        (call-with-output-file file
+          (lambda (port)
+            (display ";; Written by GnuCash, do not edit.\n" port)
+            (write manifest port)
+            (newline port))))
+      (lambda (key . args)
+        (gnc:warn "Can't write the report manifest " file ": " key)))))
+
+(define (module-prefix-stamp mod-prefix)
+  (let ((mod-dir (module-directory mod-prefix)))
+    (cons gnc:version
+          (sort
+           (map
+            (lambda (mod-file)
+              (let ((st (false-if-exception
+                         (stat (string-append mod-dir "/" mod-file ".scm")))))
+                (cons mod-file (and st (stat:mtime st)))))
+            (directory-files mod-dir))
+           (lambda (a b) (string<? (car a) (car b)))))))
+
+;; Like report-module-loader, but the reports of a directory found in
+;; the report manifest are only declared; each module is loaded the
+;; first time one of its reports is run or has its options made.
+;; Directories missing from the manifest, or changed since it was
+;; written, are loaded and recorded in it.
+(define (lazy-report-module-loader mod-prefix-list)
+  (let* ((manifest (read-report-manifest))
+         (entries
+          (map
+           (lambda (mod-prefix)
+             (let ((stamp (module-prefix-stamp mod-prefix))
+                   (cached (assoc mod-prefix manifest)))
+               (match cached
+                 ((_ (? (cut equal? stamp <>)) declared)
+                  (gnc:debug "declaring reports of " mod-prefix " from the manifest")
+                  (for-each gnc:declare-report-template declared)
+                  cached)
+                 (_
+                  (for-each
+                   (lambda (mod-file)
+                     (gnc:load-report-module (append mod-prefix (list mod-file))))
+                   (get-module-list mod-prefix))
+                  (let ((declared (gnc:report-manifest-entries mod-prefix)))
+                    (and declared (list mod-prefix stamp declared)))))))
+           mod-prefix-list))
+         (updated
+          (append (filter identity entries)
+                  (remove (lambda (entry) (member (car entry) mod-prefix-list))
+                          manifest))))
+    (unless (equal? updated manifest)
+      (write-report-manifest updated))))
+
 ;; Add hooks when this module is loaded
 (gnc-hook-add-scm-dangler HOOK-SAVE-OPTIONS gnc:save-style-sheet-options)
@@ -47,6 +47,7 @@
   (test-exchange-by-pricedb-nearest)
   (test-get-commodity-totalavg-prices)
   (test-get-commodity-inst-prices)
+  (test-pricelist-price-find-nearest)
   (test-weighted-average)
   (test-end "commodity-utils"))
 
@@ -599,6 +600,21 @@
      (test-end "Daimler-DEM"))
    (teardown)))
 
+(define (test-pricelist-price-find-nearest)
+  (test-begin "gnc:pricelist-price-find-nearest")
+  (let ((pricelist '((10 1) (20 2) (20 3) (40 4))))
+    (test-equal "empty list" #f (gnc:pricelist-price-find-nearest '() 15))
+    (test-equal "empty vector" #f (gnc:pricelist-price-find-nearest #() 15))
+    (for-each
+     (lambda (date)
+       (test-equal (format #f "vector matches list at ~a" date)
+         (gnc:pricelist-price-find-nearest pricelist date)
+         (gnc:pricelist-price-find-nearest (list->vector pricelist) date)))
+     '(0 10 14 15 16 20 29 30 31 40 50)))
+  (test-equal "single-entry vector" 7
+    (gnc:pricelist-price-find-nearest #((5 7)) 100))
+  (test-end "gnc:pricelist-price-find-nearest"))
+
 (define (test-get-commodity-inst-prices)
       (test-group-with-cleanup
    "gnc:get-commodity-inst-prices"
@@ -42,6 +42,7 @@
     (test-html-objects)
     (test-html-cells)
     (test-html-table)
+    (test-html-document-render-to-port)
     (test-gnc:html-table-add-labeled-amount-line!)
     (test-gnc:make-html-acct-table/env/accts)
     (test-end "Testing/Temporary/test-report-html")
@@ -815,6 +816,38 @@ HTML Document Title</title></head><body></body>\n\
   (test-end "HTML Tables - without style sheets")
 )
 
+(define (test-html-document-render-to-port)
+  (test-begin "HTML Document - render to port")
+  (let* ((test-doc (gnc:make-html-document))
+         (test-table (gnc:make-html-table))
+         (nested (gnc:make-html-table)))
+    (gnc:html-document-set-title! test-doc "Streamed")
+    (gnc:html-document-add-object! test-doc (gnc:make-html-text "Before"))
+    (gnc:html-table-set-col-headers! test-table '("Col A" "Col B"))
+    (gnc:html-table-append-row! nested '("inner"))
+    (gnc:html-table-append-row! test-table '("r0c0" "r0c1"))
+    (gnc:html-table-append-row! test-table (list "r1c0" nested))
+    (gnc:html-document-add-object! test-doc test-table)
+    (gnc:html-document-add-object! test-doc (gnc:make-html-text "After"))
+
+    (test-equal "render to port matches render"
+      (gnc:html-document-render test-doc)
+      (call-with-output-string
+        (lambda (port) (gnc:html-document-render-to-port test-doc port))))
+
+    (test-equal "render to port matches render, no headers"
+      (gnc:html-document-render test-doc #f)
+      (call-with-output-string
+        (lambda (port) (gnc:html-document-render-to-port test-doc port #f))))
+
+    (gnc:html-document-set-style-sheet!
+     test-doc (gnc:html-style-sheet-find "Default"))
+    (test-equal "render to port matches render, with style sheet"
+      (gnc:html-document-render test-doc)
+      (call-with-output-string
+        (lambda (port) (gnc:html-document-render-to-port test-doc port)))))
+  (test-end "HTML Document - render to port"))
+
 (define (test-gnc:html-table-add-labeled-amount-line!)
 
   (define (table->html table)
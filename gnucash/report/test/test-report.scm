@@ -1,5 +1,6 @@
 (use-modules (gnucash app-utils))
 (use-modules (gnucash report))
+(use-modules (srfi srfi-1))
 (use-modules (srfi srfi-64))
 (use-modules (tests test-engine-extras))
 (use-modules (tests srfi64-extras))
@@ -18,6 +19,7 @@
   (test-report-template-getters)
   (test-make-report)
   (test-report)
+  (test-declared-report)
   (test-end "Testing/Temporary/test-report"))
 
 (define test4-guid "54c2fc051af64a08ba2334c2e9179e24")
@@ -237,3 +239,44 @@
     (test-assert "gnc:report-serialize = string"
       (string?
        (gnc:report-serialize report)))))
+
+(define (test-declared-report)
+  (define guid "declared-report-guid")
+  (define entry
+    `((gnucash reports test declared)
+      (version . 1)
+      (name . "Declared Report")
+      (report-guid . ,guid)
+      (in-menu? . #t)
+      (menu-name . "Declared Menu Name")
+      (menu-tip . "Declared Menu Tip")))
+  (test-begin "test-declared-report")
+  (gnc:declare-report-template entry)
+  (let ((templ (gnc:find-report-template guid)))
+    (test-equal "declared template has its menu name"
+      "Declared Menu Name"
+      (gnc:report-template-menu-name templ))
+    (test-assert "declared template's renderer is deferred"
+      (procedure? (gnc:report-template-renderer/report-guid guid #f)))
+
+    ;; what loading the declared module does
+    (gnc:define-report 'version 1
+                       'name "Declared Report"
+                       'report-guid guid
+                       'menu-name "Declared Menu Name"
+                       'renderer (lambda (report) "declared-string"))
+    (test-eq "defining the report completes the declared template"
+      templ
+      (gnc:find-report-template guid))
+    (test-equal "completed template renders"
+      "declared-string"
+      ((gnc:report-template-renderer templ) #f)))
+
+  (let* ((name (module-name (current-module)))
+         (entries (gnc:report-manifest-entries
+                   (list-head name (1- (length name))))))
+    (test-assert "manifest has the defined report"
+      (find (lambda (entry)
+              (equal? guid (assq-ref (cdr entry) 'report-guid)))
+            entries)))
+  (test-end "test-declared-report"))
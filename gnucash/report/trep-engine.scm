@@ -2048,43 +2048,57 @@ warning will be removed in GnuCash 5.0"))
        (else
         (string-contains str transaction-matcher))))
 
-    (define (generic-less? split-X split-Y sortkey date-subtotal-key ascend?)
-      ;; compare splits X and Y, whereby
-      ;; sortkey and date-subtotal-key specify the options used
+    (define (split-sortvalue-fn sortkey date-subtotal-key)
+      ;; the split->value function used to compare splits by sortkey,
+      ;; with date-subtotal-key grouping the date sortkeys
+      (if (memq sortkey DATE-SORTING-TYPES)
+          (let ((date (keylist-get-info
+                       (sortkey-list BOOK-SPLIT-ACTION)
+                       sortkey 'split-sortvalue))
+                (date-comparator
+                 (keylist-get-info date-subtotal-list
+                                   date-subtotal-key 'date-sortvalue)))
+            (lambda (s)
+              (and date-comparator (date-comparator (date s)))))
+          (or (keylist-get-info (sortkey-list BOOK-SPLIT-ACTION)
+                                sortkey 'split-sortvalue)
+              (lambda (s) #f))))
+
+    (define (sortvalue-less? value-of-X value-of-Y ascend?)
+      ;; compare two values from split-sortvalue-fn
       ;; ascend? specifies whether ascending or descending
-      (let* ((comparator-function
-              (if (memq sortkey DATE-SORTING-TYPES)
-                  (let ((date (keylist-get-info
-                               (sortkey-list BOOK-SPLIT-ACTION)
-                               sortkey 'split-sortvalue))
-                        (date-comparator
-                         (keylist-get-info date-subtotal-list
-                                           date-subtotal-key 'date-sortvalue)))
-                    (lambda (s)
-                      (and date-comparator (date-comparator (date s)))))
-                  (or (keylist-get-info (sortkey-list BOOK-SPLIT-ACTION)
-                                        sortkey 'split-sortvalue)
-                      (lambda (s) #f))))
-             (value-of-X (comparator-function split-X))
-             (value-of-Y (comparator-function split-Y))
-             (op (if (string? value-of-X)
-                     (if ascend? gnc:string-locale<? gnc:string-locale>?)
-                     (if ascend? < >))))
+      (let ((op (if (string? value-of-X)
+                    (if ascend? gnc:string-locale<? gnc:string-locale>?)
+                    (if ascend? < >))))
         (and value-of-X (op value-of-X value-of-Y))))
 
-    (define (primary-comparator? X Y)
-      (generic-less? X Y primary-key
-                     primary-date-subtotal
-                     (eq? primary-order 'ascend)))
-
-    (define (secondary-comparator? X Y)
-      (generic-less? X Y secondary-key
-                     secondary-date-subtotal
-                     (eq? secondary-order 'ascend)))
-
-    ;; This will, by default, sort the split list by ascending posted-date.
-    (define (date-comparator? X Y)
-      (generic-less? X Y 'date 'none #t))
+    (define (custom-sort splits)
+      ;; Sort by primary key, then secondary key, then by default by
+      ;; ascending posted-date. Each split's sort values are computed
+      ;; once up front rather than on every comparison.
+      (let ((fns (vector (split-sortvalue-fn primary-key primary-date-subtotal)
+                         (split-sortvalue-fn secondary-key secondary-date-subtotal)
+                         (split-sortvalue-fn 'date 'none)))
+            (ascend (vector (eq? primary-order 'ascend)
+                            (eq? secondary-order 'ascend)
+                            #t)))
+        (define (decorate split)
+          (vector ((vector-ref fns 0) split)
+                  ((vector-ref fns 1) split)
+                  ((vector-ref fns 2) split)
+                  split))
+        (define (less? X Y)
+          (let lp ((i 0))
+            (and (< i 3)
+                 (let ((x (vector-ref X i))
+                       (y (vector-ref Y i))
+                       (ascend? (vector-ref ascend i)))
+                   (cond
+                    ((sortvalue-less? x y ascend?) #t)
+                    ((sortvalue-less? y x ascend?) #f)
+                    (else (lp (1+ i))))))))
+        (map (lambda (v) (vector-ref v 3))
+             (stable-sort! (map decorate splits) less?))))
 
     (define (transaction-filter-match split)
       (or (match? (xaccTransGetDescription (xaccSplitGetParent split)))
@@ -2179,9 +2193,7 @@ warning will be removed in GnuCash 5.0"))
          splits))
 
       (when custom-sort?
-        (set! splits (stable-sort! splits date-comparator?))
-        (set! splits (stable-sort! splits secondary-comparator?))
-        (set! splits (stable-sort! splits primary-comparator?)))
+        (set! splits (custom-sort splits)))
 
       (cond
        ((null? splits)
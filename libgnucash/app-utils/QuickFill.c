@@ -32,24 +32,130 @@
 #include "gnc-ui-util.h"
 
 
-struct _QuickFill
+/* Every node on the path of an inserted string points at the same
+ * copy of it, so the text is stored once rather than once per
+ * character. */
+typedef struct
 {
-    char *text;          /* the first matching text string     */
+    gint ref_count;
     int len;             /* number of chars in text string     */
-    GHashTable *matches; /* array of children in the tree      */
+    char text[];
+} QuickFillText;
+
+typedef struct
+{
+    guint key;           /* upper-cased next character         */
+    QuickFill *qf;
+} QuickFillChild;
+
+struct _QuickFill
+{
+    QuickFillText *text;      /* the first matching text string     */
+    guint num_children;
+    QuickFillChild *children; /* children in the tree, sorted by key */
 };
 
 
 /** PROTOTYPES ******************************************************/
-static void quickfill_insert_recursive (QuickFill *qf, const char *text, int len,
-                                        const char* next_char, QuickFillSort sort);
-
 static void gnc_quickfill_remove_recursive (QuickFill *qf, const gchar *text,
-        gint depth, QuickFillSort sort);
+        const gchar *next_char, QuickFillSort sort);
 
 /* This static indicates the debugging module that this .o belongs to.  */
 static QofLogModule log_module = GNC_MOD_REGISTER;
 
+/* Totals over every quickfill, for the memory report.  Quickfills are
+ * only used from the GUI thread. */
+static guint64 quickfill_nodes;
+static guint64 quickfill_child_slots;
+static guint64 quickfill_texts;
+static guint64 quickfill_text_bytes;
+
+static void
+quickfill_memory_source (QofBook *book, QofMemoryCB cb, gpointer user_data)
+{
+    cb ("quickfill nodes", quickfill_nodes,
+        quickfill_nodes * sizeof (QuickFill) +
+        quickfill_child_slots * sizeof (QuickFillChild), user_data);
+    cb ("quickfill texts", quickfill_texts, quickfill_text_bytes, user_data);
+}
+
+/********************************************************************\
+\********************************************************************/
+
+static QuickFillText *
+quickfill_text_new (const char *text, int len)
+{
+    size_t size = strlen (text) + 1;
+    QuickFillText *qft = g_malloc (sizeof (QuickFillText) + size);
+
+    qft->ref_count = 1;
+    qft->len = len;
+    memcpy (qft->text, text, size);
+    quickfill_texts++;
+    quickfill_text_bytes += sizeof (QuickFillText) + size;
+    return qft;
+}
+
+static QuickFillText *
+quickfill_text_ref (QuickFillText *qft)
+{
+    qft->ref_count++;
+    return qft;
+}
+
+static void
+quickfill_text_unref (QuickFillText *qft)
+{
+    if (qft && --qft->ref_count == 0)
+    {
+        quickfill_texts--;
+        quickfill_text_bytes -= sizeof (QuickFillText) + strlen (qft->text) + 1;
+        g_free (qft);
+    }
+}
+
+/* Binary search of the children of qf. Returns the child for key, or
+ * NULL with *pos set to where it would go. */
+static QuickFill *
+quickfill_find_child (QuickFill *qf, guint key, guint *pos)
+{
+    guint lo = 0, hi = qf->num_children;
+
+    while (lo < hi)
+    {
+        guint mid = (lo + hi) / 2;
+        guint mid_key = qf->children[mid].key;
+
+        if (mid_key == key)
+        {
+            if (pos)
+                *pos = mid;
+            return qf->children[mid].qf;
+        }
+        if (mid_key < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (pos)
+        *pos = lo;
+    return NULL;
+}
+
+static void
+quickfill_destroy_children (QuickFill *qf)
+{
+    guint i;
+
+    for (i = 0; i < qf->num_children; i++)
+        gnc_quickfill_destroy (qf->children[i].qf);
+    quickfill_child_slots -= qf->num_children;
+    g_free (qf->children);
+    qf->children = NULL;
+    qf->num_children = 0;
+}
+
 /********************************************************************\
 \********************************************************************/
 
@@ -67,9 +173,11 @@ gnc_quickfill_new (void)
     qf = g_new (QuickFill, 1);
 
     qf->text = NULL;
-    qf->len = 0;
+    qf->num_children = 0;
+    qf->children = NULL;
 
-    qf->matches = g_hash_table_new (g_direct_hash, g_direct_equal);
+    if (quickfill_nodes++ == 0)
+        qof_memory_register_source (quickfill_memory_source);
 
     return qf;
 }
@@ -77,28 +185,18 @@ gnc_quickfill_new (void)
 /********************************************************************\
 \********************************************************************/
 
-static gboolean
-destroy_helper (gpointer key, gpointer value, gpointer data)
-{
-    gnc_quickfill_destroy (value);
-    return TRUE;
-}
-
 void
 gnc_quickfill_destroy (QuickFill *qf)
 {
     if (qf == NULL)
         return;
 
-    g_hash_table_foreach (qf->matches, (GHFunc)destroy_helper, NULL);
-    g_hash_table_destroy (qf->matches);
-    qf->matches = NULL;
+    quickfill_destroy_children (qf);
 
-    if (qf->text)
-        g_free(qf->text);
+    quickfill_text_unref (qf->text);
     qf->text = NULL;
-    qf->len = 0;
 
+    quickfill_nodes--;
     g_free (qf);
 }
 
@@ -108,12 +206,10 @@ gnc_quickfill_purge (QuickFill *qf)
     if (qf == NULL)
         return;
 
-    g_hash_table_foreach_remove (qf->matches, destroy_helper, NULL);
+    quickfill_destroy_children (qf);
 
-    if (qf->text)
-        g_free (qf->text);
+    quickfill_text_unref (qf->text);
     qf->text = NULL;
-    qf->len = 0;
 }
 
 /********************************************************************\
@@ -122,10 +218,10 @@ gnc_quickfill_purge (QuickFill *qf)
 const char *
 gnc_quickfill_string (QuickFill *qf)
 {
-    if (qf == NULL)
+    if (qf == NULL || qf->text == NULL)
         return NULL;
 
-    return qf->text;
+    return qf->text->text;
 }
 
 /********************************************************************\
@@ -140,7 +236,7 @@ gnc_quickfill_get_char_match (QuickFill *qf, gunichar uc)
 
     DEBUG ("xaccGetQuickFill(): index = %u\n", key);
 
-    return g_hash_table_lookup (qf->matches, GUINT_TO_POINTER (key));
+    return quickfill_find_child (qf, key, NULL);
 }
 
 /********************************************************************\
@@ -187,14 +283,6 @@ gnc_quickfill_get_string_match (QuickFill *qf, const char *str)
 /********************************************************************\
 \********************************************************************/
 
-static void
-unique_len_helper (gpointer key, gpointer value, gpointer data)
-{
-    QuickFill **qf_p = data;
-
-    *qf_p = value;
-}
-
 QuickFill *
 gnc_quickfill_get_unique_len_match (QuickFill *qf, int *length)
 {
@@ -204,16 +292,9 @@ gnc_quickfill_get_unique_len_match (QuickFill *qf, int *length)
     if (qf == NULL)
         return NULL;
 
-    while (1)
+    while (qf->num_children == 1)
     {
-        guint count;
-
-        count = g_hash_table_size (qf->matches);
-
-        if (count != 1)
-            break;
-
-        g_hash_table_foreach (qf->matches, unique_len_helper, &qf);
+        qf = qf->children[0].qf;
 
         if (length != NULL)
             (*length)++;
@@ -229,78 +310,72 @@ void
 gnc_quickfill_insert (QuickFill *qf, const char *text, QuickFillSort sort)
 {
     gchar *normalized_str;
-    int len;
+    QuickFillText *qft;
+    const char *next_char;
 
     if (NULL == qf) return;
     if (NULL == text) return;
 
 
     normalized_str = g_utf8_normalize (text, -1, G_NORMALIZE_NFC);
-    len = g_utf8_strlen (text, -1);
-    quickfill_insert_recursive (qf, normalized_str, len, normalized_str, sort);
+    qft = quickfill_text_new (normalized_str, g_utf8_strlen (text, -1));
     g_free (normalized_str);
-}
-
-/********************************************************************\
-\********************************************************************/
-
-static void
-quickfill_insert_recursive (QuickFill *qf, const char *text, int len,
-                            const char *next_char, QuickFillSort sort)
-{
-    guint key;
-    char *old_text;
-    QuickFill *match_qf;
-    gunichar key_char_uc;
-
-    if (qf == NULL)
-        return;
-
-    if ((text == NULL) || (*next_char == '\0'))
-        return;
-
 
-    key_char_uc = g_utf8_get_char (next_char);
-    key = g_unichar_toupper (key_char_uc);
-
-    match_qf = g_hash_table_lookup (qf->matches, GUINT_TO_POINTER (key));
-    if (match_qf == NULL)
+    for (next_char = qft->text; *next_char != '\0';
+         next_char = g_utf8_next_char (next_char))
     {
-        match_qf = gnc_quickfill_new ();
-        g_hash_table_insert (qf->matches, GUINT_TO_POINTER (key), match_qf);
-    }
+        guint key = g_unichar_toupper (g_utf8_get_char (next_char));
+        QuickFillText *old_text;
+        QuickFill *match_qf;
+        guint pos;
 
-    old_text = match_qf->text;
+        match_qf = quickfill_find_child (qf, key, &pos);
+        if (match_qf == NULL)
+        {
+            match_qf = gnc_quickfill_new ();
+            qf->children = g_renew (QuickFillChild, qf->children,
+                                    qf->num_children + 1);
+            memmove (&qf->children[pos + 1], &qf->children[pos],
+                     (qf->num_children - pos) * sizeof (QuickFillChild));
+            qf->children[pos].key = key;
+            qf->children[pos].qf = match_qf;
+            qf->num_children++;
+            quickfill_child_slots++;
+        }
 
-    switch (sort)
-    {
-    case QUICKFILL_ALPHA:
-        if (old_text && (g_utf8_collate (text, old_text) >= 0))
-            break;
-        /* fall through */
+        old_text = match_qf->text;
 
-    case QUICKFILL_LIFO:
-    default:
-        /* If there's no string there already, just put the new one in. */
-        if (old_text == NULL)
+        switch (sort)
         {
-            match_qf->text = g_strdup(text);
-            match_qf->len = len;
-            break;
-        }
+        case QUICKFILL_ALPHA:
+            if (old_text && (g_utf8_collate (qft->text, old_text->text) >= 0))
+                break;
+            /* fall through */
+
+        case QUICKFILL_LIFO:
+        default:
+            /* If there's no string there already, just put the new one in. */
+            if (old_text == NULL)
+            {
+                match_qf->text = quickfill_text_ref (qft);
+                break;
+            }
+
+            /* Leave prefixes in place */
+            if ((qft->len > old_text->len) &&
+                    (strncmp (qft->text, old_text->text,
+                              strlen (old_text->text)) == 0))
+                break;
 
-        /* Leave prefixes in place */
-        if ((len > match_qf->len) &&
-                (strncmp(text, old_text, strlen(old_text)) == 0))
+            quickfill_text_unref (old_text);
+            match_qf->text = quickfill_text_ref (qft);
             break;
+        }
 
-        g_free(old_text);
-        match_qf->text = g_strdup(text);
-        match_qf->len = len;
-        break;
+        qf = match_qf;
     }
 
-    quickfill_insert_recursive (match_qf, text, len, g_utf8_next_char (next_char), sort);
+    quickfill_text_unref (qft);
 }
 
 /********************************************************************\
@@ -315,87 +390,75 @@ gnc_quickfill_remove (QuickFill *qf, const gchar *text, QuickFillSort sort)
     if (text == NULL) return;
 
     normalized_str = g_utf8_normalize (text, -1, G_NORMALIZE_NFC);
-    gnc_quickfill_remove_recursive (qf, normalized_str, 0, sort);
+    gnc_quickfill_remove_recursive (qf, normalized_str, normalized_str, sort);
     g_free (normalized_str);
 }
 
 /********************************************************************\
 \********************************************************************/
 
-struct _BestText
-{
-    gchar *text;
-    QuickFillSort sort;
-};
-
-static void
-best_text_helper (gpointer key, gpointer value, gpointer user_data)
+/* Pick the replacement text among the children of a node. */
+static QuickFillText *
+best_child_text (QuickFill *qf)
 {
-    QuickFill *qf = value;
-    struct _BestText *best = user_data;
+    QuickFillText *best = NULL;
+    guint i;
 
-    if (best->text == NULL)
+    for (i = 0; i < qf->num_children; i++)
     {
-        /* start with the first text */
-        best->text = qf->text;
+        QuickFillText *child_text = qf->children[i].qf->text;
 
+        if (best == NULL)
+        {
+            /* start with the first text */
+            best = child_text;
+        }
+        else if (g_utf8_collate (child_text->text, best->text) < 0)
+        {
+            /* even better text */
+            best = child_text;
+        }
     }
-    else if (best->text == QUICKFILL_LIFO)
-    {
-        /* we do not track history, so ignore it */
-        return;
 
-    }
-    else if (g_utf8_collate (qf->text, best->text) < 0)
-    {
-        /* even better text */
-        best->text = qf->text;
-    }
+    return best;
 }
 
-
-
 static void
-gnc_quickfill_remove_recursive (QuickFill *qf, const gchar *text, gint depth,
-                                QuickFillSort sort)
+gnc_quickfill_remove_recursive (QuickFill *qf, const gchar *text,
+                                const gchar *next_char, QuickFillSort sort)
 {
     QuickFill *match_qf;
-    gchar *child_text;
-    gint child_len;
+    QuickFillText *child_text;
 
     child_text = NULL;
-    child_len = 0;
 
-    if (depth < g_utf8_strlen (text, -1))
+    if (*next_char != '\0')
     {
         /* process next letter */
 
-        gchar *key_char;
-        gunichar key_char_uc;
-        guint key;
-
-        key_char = g_utf8_offset_to_pointer (text, depth);
-        key_char_uc = g_utf8_get_char (key_char);
-        key = g_unichar_toupper (key_char_uc);
+        guint key = g_unichar_toupper (g_utf8_get_char (next_char));
+        guint pos;
 
-        match_qf = g_hash_table_lookup (qf->matches, GUINT_TO_POINTER (key));
+        match_qf = quickfill_find_child (qf, key, &pos);
         if (match_qf)
         {
             /* remove text from child qf */
-            gnc_quickfill_remove_recursive (match_qf, text, depth + 1, sort);
+            gnc_quickfill_remove_recursive (match_qf, text,
+                                            g_utf8_next_char (next_char), sort);
 
             if (match_qf->text == NULL)
             {
                 /* text was the only word with a prefix up to match_qf */
-                g_hash_table_remove (qf->matches, GUINT_TO_POINTER (key));
+                qf->num_children--;
+                quickfill_child_slots--;
+                memmove (&qf->children[pos], &qf->children[pos + 1],
+                         (qf->num_children - pos) * sizeof (QuickFillChild));
                 gnc_quickfill_destroy (match_qf);
-
             }
             else
             {
                 /* remember remaining best child string */
                 child_text = match_qf->text;
-                child_len = match_qf->len;
             }
         }
     }
@@ -403,47 +466,19 @@ gnc_quickfill_remove_recursive (QuickFill *qf, const gchar *text, gint depth,
     if (qf->text == NULL)
         return;
 
-    if (strcmp (text, qf->text) == 0)
+    if (strcmp (text, qf->text->text) == 0)
     {
         /* the currently best text is about to be removed */
 
-        gchar *best_text = NULL;
-        gint best_len = 0;
-
-        if (child_text != NULL)
-        {
-            /* other children are pretty good as well */
-            best_text = child_text;
-            best_len = child_len;
+        QuickFillText *best_text = child_text;
 
-        }
-        else
-        {
-            if (g_hash_table_size (qf->matches) != 0)
-            {
-                /* otherwise search for another good text */
-                struct _BestText bts;
-                bts.text = NULL;
-                bts.sort = sort;
-
-                g_hash_table_foreach (qf->matches, (GHFunc) best_text_helper, &bts);
-                best_text = bts.text;
-                best_len = (best_text == NULL) ? 0 : g_utf8_strlen (best_text, -1);
-            }
-        }
+        /* otherwise search for another good text */
+        if (best_text == NULL)
+            best_text = best_child_text (qf);
 
         /* now replace or clear text */
-        g_free(qf->text);
-        if (best_text != NULL)
-        {
-            qf->text = g_strdup(best_text);
-            qf->len = best_len;
-        }
-        else
-        {
-            qf->text = NULL;
-            qf->len = 0;
-        }
+        quickfill_text_unref (qf->text);
+        qf->text = best_text ? quickfill_text_ref (best_text) : NULL;
     }
 }
 
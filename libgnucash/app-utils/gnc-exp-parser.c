@@ -39,6 +39,7 @@
 #include "guile-mappings.h"
 
 #define GEP_GROUP_NAME "Variables"
+#define MAX_CONSTANT_RESULTS 1024
 
 static QofLogModule log_module = GNC_MOD_GUI;
 
@@ -56,6 +57,13 @@ static ParseError    last_error        = PARSER_NO_ERROR;
 static GNCParseError last_gncp_error   = NO_ERR;
 static gboolean      parser_inited     = FALSE;
 
+/* Results of expressions made only of numbers and arithmetic, keyed by
+ * the expression. They depend on nothing but the separators they were
+ * parsed with, which are kept alongside. */
+static GHashTable   *constant_results  = NULL;
+static gchar        *constant_radix    = NULL;
+static gchar        *constant_group    = NULL;
+
 
 /** Implementations ************************************************/
 
@@ -156,6 +164,14 @@ gnc_exp_parser_shutdown (void)
     g_hash_table_destroy (variable_bindings);
     variable_bindings = NULL;
 
+    if (constant_results)
+        g_hash_table_destroy (constant_results);
+    constant_results = NULL;
+    g_free (constant_radix);
+    constant_radix = NULL;
+    g_free (constant_group);
+    constant_group = NULL;
+
     last_error = PARSER_NO_ERROR;
     last_gncp_error = NO_ERR;
 
@@ -463,6 +479,86 @@ gnc_ep_tmpvarhash_clean( gpointer key, gpointer value, gpointer user_data )
     }
 }
 
+/* TRUE if the expression has no variables, functions, strings or
+ * assignments, so that it always evaluates to the same thing. */
+static gboolean
+is_constant_expression (const char *expression, const char *radix_point,
+                        const char *group_char)
+{
+    size_t radix_len = radix_point ? strlen (radix_point) : 0;
+    size_t group_len = group_char ? strlen (group_char) : 0;
+    const char *p = expression;
+
+    while (*p)
+    {
+        if (isdigit ((unsigned char)*p) || isspace ((unsigned char)*p) ||
+            strchr ("+-*/()", *p))
+            p++;
+        else if (radix_len && strncmp (p, radix_point, radix_len) == 0)
+            p += radix_len;
+        else if (group_len && strncmp (p, group_char, group_len) == 0)
+            p += group_len;
+        else
+            return FALSE;
+    }
+    return TRUE;
+}
+
+static gboolean
+lookup_constant_result (const char *expression, struct lconv *lc,
+                        gnc_numeric *value_p)
+{
+    gnc_numeric *cached;
+
+    if (constant_results == NULL)
+        return FALSE;
+
+    if (g_strcmp0 (constant_radix, lc->mon_decimal_point) != 0 ||
+        g_strcmp0 (constant_group, lc->mon_thousands_sep) != 0)
+    {
+        g_hash_table_remove_all (constant_results);
+        return FALSE;
+    }
+
+    cached = g_hash_table_lookup (constant_results, expression);
+    if (cached == NULL)
+        return FALSE;
+
+    if (value_p)
+        *value_p = *cached;
+    return TRUE;
+}
+
+static void
+store_constant_result (const char *expression, struct lconv *lc,
+                       gnc_numeric value)
+{
+    gnc_numeric *cached;
+
+    if (constant_results == NULL)
+        constant_results = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                  g_free, g_free);
+
+    if (g_hash_table_size (constant_results) == 0 ||
+        g_strcmp0 (constant_radix, lc->mon_decimal_point) != 0 ||
+        g_strcmp0 (constant_group, lc->mon_thousands_sep) != 0)
+    {
+        g_hash_table_remove_all (constant_results);
+        g_free (constant_radix);
+        constant_radix = g_strdup (lc->mon_decimal_point);
+        g_free (constant_group);
+        constant_group = g_strdup (lc->mon_thousands_sep);
+    }
+    else if (g_hash_table_size (constant_results) >= MAX_CONSTANT_RESULTS)
+    {
+        g_hash_table_remove_all (constant_results);
+    }
+
+    cached = g_new (gnc_numeric, 1);
+    *cached = value;
+    g_hash_table_insert (constant_results, g_strdup (expression), cached);
+}
+
 gboolean
 gnc_exp_parser_parse( const char * expression, gnc_numeric *value_p,
                       char **error_loc_p )
@@ -508,6 +604,7 @@ gnc_exp_parser_parse_separate_vars (const char * expression,
     var_store result;
     char * error_loc;
     ParserNum *pnum;
+    gboolean is_constant;
 
     if (expression == NULL)
         return FALSE;
@@ -515,6 +612,21 @@ gnc_exp_parser_parse_separate_vars (const char * expression,
     if (!parser_inited)
         gnc_exp_parser_real_init ( (varHash == NULL) );
 
+    lc = gnc_localeconv ();
+
+    /* An expression without any names can't touch the variables, so if
+     * it has been parsed before the answer is already known. */
+    is_constant = is_constant_expression (expression, lc->mon_decimal_point,
+                                          lc->mon_thousands_sep);
+    if (is_constant && lookup_constant_result (expression, lc, value_p))
+    {
+        if (error_loc_p != NULL)
+            *error_loc_p = NULL;
+
+        last_error = PARSER_NO_ERROR;
+        return TRUE;
+    }
+
     result.variable_name = NULL;
     result.value = NULL;
     result.next_var = NULL;
@@ -526,8 +638,6 @@ gnc_exp_parser_parse_separate_vars (const char * expression,
         g_hash_table_foreach( varHash, make_predefined_vars_from_external_helper, &vars);
     }
 
-    lc = gnc_localeconv ();
-
     pe = init_parser (vars, lc->mon_decimal_point, lc->mon_thousands_sep,
                       trans_numeric, numeric_ops, negate_numeric, g_free,
                       func_op);
@@ -552,6 +662,10 @@ gnc_exp_parser_parse_separate_vars (const char * expression,
                 if (value_p)
                     *value_p = gnc_numeric_reduce (pnum->value);
 
+                if (is_constant)
+                    store_constant_result (expression, lc,
+                                           gnc_numeric_reduce (pnum->value));
+
                 if (!result.variable_name)
                     g_free (pnum);
             }
@@ -70,6 +70,7 @@ static GObjectClass *parent_class = NULL;
 typedef struct _SxTxnCreationData
 {
     GncSxInstance *instance;
+    GHashTable *parser_vars; /* instance variables for the parser, or NULL */
     GList **created_txn_guids;
     GList **creation_errors;
 } SxTxnCreationData;
@@ -533,6 +534,7 @@ gnc_sx_get_instances(const GDate *range_end, gboolean include_disabled)
 {
     GList *all_sxes = gnc_book_get_schedxactions(gnc_get_current_book())->sx_list;
     GncSxInstanceModel *instances;
+    GList *iter;
 
     g_assert(range_end != NULL);
     g_assert(g_date_valid(range_end));
@@ -563,6 +565,12 @@ gnc_sx_get_instances(const GDate *range_end, gboolean include_disabled)
         g_list_free(enabled_sxes);
     }
 
+    for (iter = instances->sx_instance_list; iter != NULL; iter = iter->next)
+    {
+        GncSxInstances *sx_instances = (GncSxInstances*)iter->data;
+        g_hash_table_insert(instances->sx_instances, sx_instances->sx, sx_instances);
+    }
+
     return instances;
 }
 static GncSxInstanceModel*
@@ -665,6 +673,10 @@ gnc_sx_instance_model_finalize (GObject *object)
     }
     g_list_free(model->sx_instance_list);
     model->sx_instance_list = NULL;
+    g_hash_table_destroy(model->sx_instances);
+    model->sx_instances = NULL;
+    g_hash_table_destroy(model->stale_sxes);
+    model->stale_sxes = NULL;
 
     G_OBJECT_CLASS(parent_class)->finalize(object);
 }
@@ -723,15 +735,17 @@ gnc_sx_instance_model_init(GTypeInstance *instance, gpointer klass)
 
     g_date_clear(&inst->range_end, 1);
     inst->sx_instance_list = NULL;
+    inst->sx_instances = g_hash_table_new(g_direct_hash, g_direct_equal);
+    inst->stale_sxes = g_hash_table_new(g_direct_hash, g_direct_equal);
     inst->qof_event_handler_id = qof_event_register_handler(_gnc_sx_instance_event_handler, inst);
 }
 
-static gint
-_gnc_sx_instance_find_by_sx(GncSxInstances *in_list_instances, SchedXaction *sx_to_find)
+static void
+_gnc_sx_instance_model_add_sx(GncSxInstanceModel *model, SchedXaction *sx)
 {
-    if (in_list_instances->sx == sx_to_find)
-        return 0;
-    return -1;
+    GncSxInstances *sx_instances = _gnc_sx_gen_instances((gpointer)sx, (gpointer)&model->range_end);
+    model->sx_instance_list = g_list_append(model->sx_instance_list, sx_instances);
+    g_hash_table_insert(model->sx_instances, sx, sx_instances);
 }
 
 static void
@@ -754,13 +768,14 @@ _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer
 
         sx = GNC_SX(ent);
         // only send `updated` if it's actually in the model
-        sx_is_in_model = (g_list_find_custom(instances->sx_instance_list, sx, (GCompareFunc)_gnc_sx_instance_find_by_sx) != NULL);
+        sx_is_in_model = g_hash_table_contains(instances->sx_instances, sx);
         if (event_type & QOF_EVENT_MODIFY)
         {
             if (sx_is_in_model)
             {
                 if (instances->include_disabled || xaccSchedXactionGetEnabled(sx))
                 {
+                    g_hash_table_add(instances->stale_sxes, sx);
                     g_signal_emit_by_name(instances, "updated", (gpointer)sx);
                 }
                 else
@@ -776,9 +791,7 @@ _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer
                 if (g_list_find(all_sxes, sx) && (!instances->include_disabled && xaccSchedXactionGetEnabled(sx)))
                 {
                     /* it's moved from disabled to enabled, add the instances */
-                    instances->sx_instance_list
-                        = g_list_append(instances->sx_instance_list,
-                                        _gnc_sx_gen_instances((gpointer)sx, (gpointer) & instances->range_end));
+                    _gnc_sx_instance_model_add_sx(instances, sx);
                     g_signal_emit_by_name(instances, "added", (gpointer)sx);
                 }
             }
@@ -791,9 +804,7 @@ _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer
 
         if (event_type & GNC_EVENT_ITEM_REMOVED)
         {
-            GList *instances_link;
-            instances_link = g_list_find_custom(instances->sx_instance_list, sx, (GCompareFunc)_gnc_sx_instance_find_by_sx);
-            if (instances_link != NULL)
+            if (g_hash_table_contains(instances->sx_instances, sx))
             {
                 g_signal_emit_by_name(instances, "removing", (gpointer)sx);
             }
@@ -807,9 +818,7 @@ _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer
             if (instances->include_disabled || xaccSchedXactionGetEnabled(sx))
             {
                 /* generate instances, add to instance list, emit update. */
-                instances->sx_instance_list
-                    = g_list_append(instances->sx_instance_list,
-                                    _gnc_sx_gen_instances((gpointer)sx, (gpointer) & instances->range_end));
+                _gnc_sx_instance_model_add_sx(instances, sx);
                 g_signal_emit_by_name(instances, "added", (gpointer)sx);
             }
         }
@@ -840,17 +849,20 @@ void
 gnc_sx_instance_model_update_sx_instances(GncSxInstanceModel *model, SchedXaction *sx)
 {
     GncSxInstances *existing, *new_instances;
-    GList *link;
 
-    link = g_list_find_custom(model->sx_instance_list, sx, (GCompareFunc)_gnc_sx_instance_find_by_sx);
-    if (link == NULL)
+    existing = (GncSxInstances*)g_hash_table_lookup(model->sx_instances, sx);
+    if (existing == NULL)
     {
         g_critical("couldn't find sx [%p]\n", sx);
         return;
     }
 
+    // nothing to do if the sx hasn't changed since it was last generated,
+    // e.g. another consumer of the same "updated" signal got here first.
+    if (!g_hash_table_remove(model->stale_sxes, sx))
+        return;
+
     // merge the new instance data into the existing structure, mutating as little as possible.
-    existing = (GncSxInstances*)link->data;
     new_instances = _gnc_sx_gen_instances((gpointer)sx, &model->range_end);
     existing->sx = new_instances->sx;
     existing->next_instance_date = new_instances->next_instance_date;
@@ -967,17 +979,19 @@ gnc_sx_instance_model_update_sx_instances(GncSxInstanceModel *model, SchedXactio
 void
 gnc_sx_instance_model_remove_sx_instances(GncSxInstanceModel *model, SchedXaction *sx)
 {
-    GList *instance_link = NULL;
+    GncSxInstances *instances;
 
-    instance_link = g_list_find_custom(model->sx_instance_list, sx, (GCompareFunc)_gnc_sx_instance_find_by_sx);
-    if (instance_link == NULL)
+    instances = (GncSxInstances*)g_hash_table_lookup(model->sx_instances, sx);
+    if (instances == NULL)
     {
         g_warning("instance not found!\n");
         return;
     }
 
-    model->sx_instance_list = g_list_remove_link(model->sx_instance_list, instance_link);
-    gnc_sx_instances_free((GncSxInstances*)instance_link->data);
+    g_hash_table_remove(model->sx_instances, sx);
+    g_hash_table_remove(model->stale_sxes, sx);
+    model->sx_instance_list = g_list_remove(model->sx_instance_list, instances);
+    gnc_sx_instances_free(instances);
 }
 
 static void
@@ -1032,7 +1046,8 @@ _get_sx_formula_value(const SchedXaction* sx,
 		      GList **creation_errors,
 		      const char *formula_key,
 		      const char* numeric_key,
-		      GHashTable *variable_bindings)
+		      GHashTable *variable_bindings,
+		      GHashTable *parser_vars)
 {
 
     char *formula_str = NULL, *parseErrorLoc = NULL;
@@ -1058,11 +1073,6 @@ _get_sx_formula_value(const SchedXaction* sx,
 
     if (formula_str != NULL && strlen(formula_str) != 0)
     {
-        GHashTable *parser_vars = NULL;
-        if (variable_bindings)
-        {
-            parser_vars = gnc_sx_instance_get_variables_for_parser(variable_bindings);
-        }
         if (!gnc_exp_parser_parse_separate_vars(formula_str,
                                                 numeric,
                                                 &parseErrorLoc,
@@ -1076,31 +1086,29 @@ _get_sx_formula_value(const SchedXaction* sx,
                     parseErrorLoc,
                     gnc_exp_parser_error_string());
        }
-
-        if (parser_vars != NULL)
-        {
-            g_hash_table_destroy(parser_vars);
-        }
     }
 }
 
 static void
-_get_credit_formula_value(GncSxInstance *instance,
-                          const Split *template_split, gnc_numeric *credit_num,
-                          GList **creation_errors)
+_get_credit_formula_value(SxTxnCreationData *creation_data,
+                          const Split *template_split, gnc_numeric *credit_num)
 {
+    GncSxInstance *instance = creation_data->instance;
     _get_sx_formula_value(instance->parent->sx, template_split, credit_num,
-                          creation_errors, "sx-credit-formula",
-                          "sx-credit-numeric", instance->variable_bindings);
+                          creation_data->creation_errors, "sx-credit-formula",
+                          "sx-credit-numeric", instance->variable_bindings,
+                          creation_data->parser_vars);
 }
 
 static void
-_get_debit_formula_value(GncSxInstance *instance, const Split *template_split,
-                         gnc_numeric *debit_num, GList **creation_errors)
+_get_debit_formula_value(SxTxnCreationData *creation_data,
+                         const Split *template_split, gnc_numeric *debit_num)
 {
+    GncSxInstance *instance = creation_data->instance;
     _get_sx_formula_value(instance->parent->sx, template_split, debit_num,
-                          creation_errors, "sx-debit-formula",
-                          "sx-debit-numeric", instance->variable_bindings);
+                          creation_data->creation_errors, "sx-debit-formula",
+                          "sx-debit-numeric", instance->variable_bindings,
+                          creation_data->parser_vars);
 }
 
 static gnc_numeric
@@ -1112,10 +1120,8 @@ split_apply_formulas (const Split *split, SxTxnCreationData* creation_data)
     gint gncn_error;
     SchedXaction *sx = creation_data->instance->parent->sx;
 
-    _get_credit_formula_value(creation_data->instance, split, &credit_num,
-                              creation_data->creation_errors);
-    _get_debit_formula_value(creation_data->instance, split, &debit_num,
-                             creation_data->creation_errors);
+    _get_credit_formula_value(creation_data, split, &credit_num);
+    _get_debit_formula_value(creation_data, split, &debit_num);
 
     final = gnc_numeric_sub_fixed(debit_num, credit_num);
 
@@ -1346,8 +1352,8 @@ create_each_transaction_helper(Transaction *template_txn, void *user_data)
     if (creation_data->created_txn_guids != NULL)
     {
         *creation_data->created_txn_guids
-            = g_list_append(*(creation_data->created_txn_guids),
-                            (gpointer)xaccTransGetGUID(new_txn));
+            = g_list_prepend(*(creation_data->created_txn_guids),
+                             (gpointer)xaccTransGetGUID(new_txn));
     }
 
     return FALSE;
@@ -1364,14 +1370,19 @@ create_transactions_for_instance(GncSxInstance *instance, GList **created_txn_gu
     creation_data.instance = instance;
     creation_data.created_txn_guids = created_txn_guids;
     creation_data.creation_errors = creation_errors;
-    /* Don't update the GUI for every transaction, it can really slow things
-     * down.
-     */
-    qof_event_suspend();
+    /* The bindings are the same for every split of every template
+     * transaction, so convert them for the parser just once. */
+    creation_data.parser_vars = NULL;
+    if (instance->variable_bindings != NULL)
+        creation_data.parser_vars =
+            gnc_sx_instance_get_variables_for_parser(instance->variable_bindings);
+
     xaccAccountForEachTransaction(sx_template_account,
                                   create_each_transaction_helper,
                                   &creation_data);
-    qof_event_resume();
+
+    if (creation_data.parser_vars != NULL)
+        g_hash_table_destroy(creation_data.parser_vars);
 }
 
 void
@@ -1381,6 +1392,7 @@ gnc_sx_instance_model_effect_change(GncSxInstanceModel *model,
                                     GList **creation_errors)
 {
     GList *iter;
+    GList *created_guids = NULL;
 
     if (qof_book_is_readonly(gnc_get_current_book()))
     {
@@ -1406,6 +1418,11 @@ gnc_sx_instance_model_effect_change(GncSxInstanceModel *model,
         instance_count = gnc_sx_get_instance_count(instances->sx, NULL);
         remain_occur_count = xaccSchedXactionGetRemOccur(instances->sx);
 
+        /* Don't update the GUI for every transaction, it can really slow
+         * things down. The SX itself is updated below, after the events have
+         * been resumed, so that the model and its views still hear about it.
+         */
+        qof_event_suspend();
         for (instance_iter = instances->instance_list; instance_iter != NULL; instance_iter = instance_iter->next)
         {
             GncSxInstance *inst = (GncSxInstance*)instance_iter->data;
@@ -1449,7 +1466,7 @@ gnc_sx_instance_model_effect_change(GncSxInstanceModel *model,
                     break;
                 case SX_INSTANCE_STATE_TO_CREATE:
                     create_transactions_for_instance (inst,
-                                                      created_transaction_guids,
+                                                      created_transaction_guids ? &created_guids : NULL,
                                                       &instance_errors);
                     if (instance_errors == NULL)
                     {
@@ -1472,11 +1489,16 @@ gnc_sx_instance_model_effect_change(GncSxInstanceModel *model,
                     break;
             }
         }
+        qof_event_resume();
 
         xaccSchedXactionSetLastOccurDate(instances->sx, last_occur_date);
         gnc_sx_set_instance_count(instances->sx, instance_count);
         xaccSchedXactionSetRemOccur(instances->sx, remain_occur_count);
     }
+
+    if (created_transaction_guids != NULL)
+        *created_transaction_guids = g_list_concat(*created_transaction_guids,
+                                                   g_list_reverse(created_guids));
 }
 
 void
@@ -1769,11 +1791,11 @@ create_cashflow_helper(Transaction *template_txn, void *user_data)
             _get_sx_formula_value(creation_data->sx, template_split,
 				  &credit_num, creation_data->creation_errors,
 				  "sx-credit-formula", "sx-credit-numeric",
-				  NULL);
+				  NULL, NULL);
             /* Debit value */
             _get_sx_formula_value(creation_data->sx, template_split,
 				  &debit_num, creation_data->creation_errors,
-				  "sx-debit-formula", "sx-debit-numeric", NULL);
+				  "sx-debit-formula", "sx-debit-numeric", NULL, NULL);
 
             /* The resulting cash flow number: debit minus credit,
              * multiplied with the count factor. */
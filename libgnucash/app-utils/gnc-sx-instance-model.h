@@ -48,6 +48,8 @@ typedef struct _GncSxInstanceModel
 
     /* private */
     gint qof_event_handler_id;
+    GHashTable *sx_instances; /* <SchedXaction*,GncSxInstances*> */
+    GHashTable *stale_sxes; /* set of SchedXaction* modified since generation */
 
     /* signals */
     /* void (*added)(SchedXaction *sx); // gpointer user_data */
@@ -132,6 +134,10 @@ GncSxInstanceModel* gnc_sx_get_instances(const GDate *range_end, gboolean includ
  * consumers are probably going to call this in response to seeing the
  * "update" signal, unless they need to be doing something else like
  * finishing an iteration over an existing GncSxInstances*.
+ *
+ * Only an SX that has been modified since its instances were generated
+ * is regenerated, so several consumers of one model can all call this
+ * for the same signal and the work is done once.
  **/
 void gnc_sx_instance_model_update_sx_instances(GncSxInstanceModel *model, SchedXaction *sx);
 void gnc_sx_instance_model_remove_sx_instances(GncSxInstanceModel *model, SchedXaction *sx);
@@ -0,0 +1,236 @@
+/********************************************************************\
+ * gnc-trans-quickfill.c -- Create transaction text quick-fills     *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+
+#include <config.h>
+#include "gnc-trans-quickfill.h"
+#include "gnc-engine.h"
+#include "Split.h"
+#include "Transaction.h"
+
+/* This static indicates the debugging module that this .o belongs to. */
+G_GNUC_UNUSED static QofLogModule log_module = GNC_MOD_REGISTER;
+
+#define TRANS_QF_KEY "gnc-shared-trans-quickfill"
+
+/* Number of transactions added to the quickfills per idle call. */
+#define TRANS_QF_FILL_BATCH 250
+
+typedef struct
+{
+    GncGUID guid;                  /* of the account */
+    QofBook *book;
+    QuickFill *qf[GNC_TRANS_QF_NUM_FIELDS];
+    GArray *to_fill;               /* GUIDs of transactions not yet added */
+    guint next;
+    guint idle_id;
+} AccountTransQF;
+
+typedef struct
+{
+    QofBook *book;
+    GHashTable *accounts;          /* account GUID -> AccountTransQF */
+    gint listener;
+} TransQFCache;
+
+static void
+add_trans_completions (AccountTransQF *aqf, Transaction *trans)
+{
+    Split *s;
+    int i = 0;
+
+    gnc_quickfill_insert (aqf->qf[GNC_TRANS_QF_DESCRIPTION],
+                          xaccTransGetDescription (trans), QUICKFILL_LIFO);
+    gnc_quickfill_insert (aqf->qf[GNC_TRANS_QF_NOTES],
+                          xaccTransGetNotes (trans), QUICKFILL_LIFO);
+
+    while ((s = xaccTransGetSplit (trans, i)) != NULL)
+    {
+        gnc_quickfill_insert (aqf->qf[GNC_TRANS_QF_MEMO],
+                              xaccSplitGetMemo (s), QUICKFILL_LIFO);
+        i++;
+    }
+}
+
+static void
+finish_fill (AccountTransQF *aqf)
+{
+    if (aqf->to_fill)
+        g_array_free (aqf->to_fill, TRUE);
+    aqf->to_fill = NULL;
+    aqf->idle_id = 0;
+}
+
+static gboolean
+fill_account_quickfills (gpointer user_data)
+{
+    AccountTransQF *aqf = user_data;
+    guint end = MIN (aqf->next + TRANS_QF_FILL_BATCH, aqf->to_fill->len);
+
+    /* Look the transactions up again rather than holding on to them,
+     * some may have been deleted since the fill was started. */
+    for (; aqf->next < end; aqf->next++)
+    {
+        GncGUID *guid = &g_array_index (aqf->to_fill, GncGUID, aqf->next);
+        Transaction *trans = xaccTransLookup (guid, aqf->book);
+
+        if (trans)
+            add_trans_completions (aqf, trans);
+    }
+
+    if (aqf->next < aqf->to_fill->len)
+        return G_SOURCE_CONTINUE;
+
+    DEBUG ("filled quickfills of account %s", guid_to_string (&aqf->guid));
+    finish_fill (aqf);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+account_trans_qf_destroy (gpointer data)
+{
+    AccountTransQF *aqf = data;
+    int i;
+
+    if (aqf->idle_id)
+        g_source_remove (aqf->idle_id);
+    finish_fill (aqf);
+
+    for (i = 0; i < GNC_TRANS_QF_NUM_FIELDS; i++)
+        gnc_quickfill_destroy (aqf->qf[i]);
+    g_free (aqf);
+}
+
+static AccountTransQF *
+account_trans_qf_new (Account *account)
+{
+    AccountTransQF *aqf = g_new0 (AccountTransQF, 1);
+    GList *node;
+    int i;
+
+    aqf->guid = *xaccAccountGetGUID (account);
+    aqf->book = gnc_account_get_book (account);
+    for (i = 0; i < GNC_TRANS_QF_NUM_FIELDS; i++)
+        aqf->qf[i] = gnc_quickfill_new ();
+
+    /* The split list is in date order, so the most recent strings go
+     * in last and win the LIFO ordering, as they do when a register
+     * adds them while loading. */
+    aqf->to_fill = g_array_new (FALSE, FALSE, sizeof (GncGUID));
+    for (node = xaccAccountGetSplitList (account); node; node = node->next)
+    {
+        Transaction *trans = xaccSplitGetParent (node->data);
+        g_array_append_val (aqf->to_fill, *xaccTransGetGUID (trans));
+    }
+
+    if (aqf->to_fill->len > 0)
+        aqf->idle_id = g_idle_add_full (G_PRIORITY_LOW,
+                                        fill_account_quickfills, aqf, NULL);
+    else
+        finish_fill (aqf);
+
+    return aqf;
+}
+
+static void
+listen_for_trans_events (QofInstance *entity, QofEventId event_type,
+                         gpointer user_data, gpointer event_data)
+{
+    TransQFCache *cache = user_data;
+    Transaction *trans;
+    GList *node;
+
+    /* We only listen for changed transactions, their strings go into
+     * the quickfills of the accounts they touch. */
+    if (!GNC_IS_TRANSACTION (entity) || !(event_type & QOF_EVENT_MODIFY))
+        return;
+
+    if (qof_instance_get_book (entity) != cache->book)
+        return;
+
+    trans = GNC_TRANSACTION (entity);
+    for (node = xaccTransGetSplitList (trans); node; node = node->next)
+    {
+        Account *account = xaccSplitGetAccount (node->data);
+        AccountTransQF *aqf;
+
+        if (!account)
+            continue;
+
+        aqf = g_hash_table_lookup (cache->accounts,
+                                   xaccAccountGetGUID (account));
+        if (aqf)
+            add_trans_completions (aqf, trans);
+    }
+}
+
+static void
+shared_quickfill_destroy (QofBook *book, gpointer key, gpointer user_data)
+{
+    TransQFCache *cache = user_data;
+
+    qof_event_unregister_handler (cache->listener);
+    g_hash_table_destroy (cache->accounts);
+    g_free (cache);
+}
+
+static TransQFCache *
+get_cache (QofBook *book)
+{
+    TransQFCache *cache = qof_book_get_data (book, TRANS_QF_KEY);
+
+    if (cache)
+        return cache;
+
+    cache = g_new0 (TransQFCache, 1);
+    cache->book = book;
+    /* Keyed by GUID so that an account freed and another allocated in
+     * its place can never pick up the old account's strings. */
+    cache->accounts = g_hash_table_new_full (guid_hash_to_guint,
+                                             guid_g_hash_table_equal,
+                                             NULL, account_trans_qf_destroy);
+    cache->listener = qof_event_register_handler (listen_for_trans_events,
+                                                  cache);
+
+    qof_book_set_data_fin (book, TRANS_QF_KEY, cache,
+                           shared_quickfill_destroy);
+    return cache;
+}
+
+QuickFill *
+gnc_get_shared_trans_quickfill (Account *account, GncTransQuickFillField field)
+{
+    TransQFCache *cache;
+    AccountTransQF *aqf;
+
+    g_assert (account);
+    g_assert (field < GNC_TRANS_QF_NUM_FIELDS);
+
+    cache = get_cache (gnc_account_get_book (account));
+    aqf = g_hash_table_lookup (cache->accounts, xaccAccountGetGUID (account));
+    if (!aqf)
+    {
+        aqf = account_trans_qf_new (account);
+        g_hash_table_insert (cache->accounts, &aqf->guid, aqf);
+    }
+
+    return aqf->qf[field];
+}
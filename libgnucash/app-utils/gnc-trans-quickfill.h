@@ -0,0 +1,69 @@
+/********************************************************************\
+ * gnc-trans-quickfill.h -- Create transaction text quick-fills     *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+/** @addtogroup QuickFill Auto-complete typed user input.
+   @{
+*/
+/** Similar to the @ref Account_QuickFill account name quickfill, we
+ * keep cached quickfills with the descriptions, notes and memos of
+ * the transactions in an account, shared by every register of that
+ * account.
+*/
+
+#ifndef GNC_TRANS_QUICKFILL_H
+#define GNC_TRANS_QUICKFILL_H
+
+#include "qof.h"
+#include "Account.h"
+#include "QuickFill.h"
+
+typedef enum
+{
+    GNC_TRANS_QF_DESCRIPTION,
+    GNC_TRANS_QF_NOTES,
+    GNC_TRANS_QF_MEMO,
+    GNC_TRANS_QF_NUM_FIELDS
+} GncTransQuickFillField;
+
+/** Create/fetch a quickfill of transaction strings for an account.
+ *
+ *  The quickfills of an account are kept in its book and are filled
+ *  from the account's transactions a batch at a time in an idle
+ *  callback, so the first call returns a quickfill that is still
+ *  empty and fills up once the main loop is idle. For memos the
+ *  quickfill holds the memos of every split of those transactions.
+ *
+ *  This code listens to transaction change events and adds the
+ *  strings of changed transactions to the quickfills of their
+ *  accounts. Strings are never removed.
+ *
+ * \param account The account whose transactions fill the quickfill
+ * \param field Which string of the transactions to complete
+ *
+ * \return The shared QuickFill object, owned by the book.
+ */
+QuickFill * gnc_get_shared_trans_quickfill (Account *account,
+        GncTransQuickFillField field);
+
+#endif
+
+/** @} */
+/** @} */
@@ -1488,12 +1488,127 @@ gnc_integral_print_info (void)
     return info;
 }
 
+/* The number of decimal places of a denominator that is a power of
+ * ten up to 10^18, or -1 for any other. */
+static int
+decimal_denom_places (gint64 denom)
+{
+    int places = 0;
+
+    if (denom <= 0)
+        return -1;
+    while (denom % 10 == 0)
+    {
+        denom /= 10;
+        places++;
+    }
+    return (denom == 1) ? places : -1;
+}
+
+/* PrintAmountInternal for the common case of an amount whose
+ * denominator is a power of ten, as amounts in a commodity's fraction
+ * are: the digits are worked out in integer arithmetic and the whole
+ * part is grouped as it is written, from the last digit back.
+ * Returns -1, having written nothing, for the cases it doesn't cover. */
+static int
+PrintDecimalAmount (char *buf, gnc_numeric val, const GNCPrintAmountInfo *info,
+                    const struct lconv *lc)
+{
+    /* 19 digits with a separator of up to 6 bytes after each. */
+    char whole_buf[19 * 7 + 1];
+    char *whole_ptr = whole_buf + sizeof (whole_buf);
+    const char *separator = NULL, *group = NULL, *decimal_point;
+    int sep_len = 0, group_count = 0;
+    int places, max_dp, shown, i;
+    gint64 num, unit, whole, frac;
+    char *buf_ptr;
+
+    places = decimal_denom_places (val.denom);
+    if (places < 0 || val.num == G_MININT64)
+        return -1;
+
+    num = val.num < 0 ? -val.num : val.num;
+    max_dp = info->force_fit ? info->max_decimal_places : 99;
+
+    /* Round half up at max_dp by adding half a unit of the first place
+     * dropped, as the general case does. */
+    if (info->round && info->force_fit && places > max_dp)
+    {
+        gint64 half = 5;
+        for (i = max_dp + 1; i < places; i++)
+            half *= 10;
+        if (num > G_MAXINT64 - half)
+            return -1;
+        num += half;
+    }
+
+    for (i = 0, unit = 1; i < places; i++)
+        unit *= 10;
+    whole = num / unit;
+    frac = num % unit;
+
+    if (info->use_separators)
+    {
+        separator = info->monetary ? lc->mon_thousands_sep : lc->thousands_sep;
+        group = info->monetary ? lc->mon_grouping : lc->grouping;
+        if (separator && *separator)
+            sep_len = g_utf8_next_char (separator) - separator;
+    }
+
+    /* Write the whole part backwards, with a separator after each group
+     * of digits.  A '\0' group code repeats the last group, CHAR_MAX
+     * stops the grouping. */
+    *--whole_ptr = '\0';
+    do
+    {
+        *--whole_ptr = '0' + whole % 10;
+        whole /= 10;
+        if (whole && group && *group != CHAR_MAX && ++group_count == *group)
+        {
+            whole_ptr -= sep_len;
+            memcpy (whole_ptr, separator, sep_len);
+            group_count = 0;
+            if (group[1] != '\0')
+                group++;
+        }
+    }
+    while (whole);
+    buf_ptr = g_stpcpy (buf, whole_ptr);
+
+    /* The fraction, cut at max_dp, without the trailing zeros beyond
+     * min_decimal_places. */
+    shown = MIN (places, max_dp);
+    for (i = shown; i < places; i++)
+        frac /= 10;
+    while (shown > info->min_decimal_places && frac % 10 == 0)
+    {
+        frac /= 10;
+        shown--;
+    }
+    if (MAX (shown, info->min_decimal_places) == 0)
+        return buf_ptr - buf;
+
+    decimal_point = info->monetary ? lc->mon_decimal_point : lc->decimal_point;
+    g_utf8_strncpy (buf_ptr, decimal_point, 1);
+    buf_ptr = g_utf8_find_next_char (buf_ptr, NULL);
+    for (i = shown - 1; i >= 0; i--)
+    {
+        buf_ptr[i] = '0' + frac % 10;
+        frac /= 10;
+    }
+    buf_ptr += shown;
+    for (i = shown; i < info->min_decimal_places; i++)
+        *buf_ptr++ = '0';
+    *buf_ptr = '\0';
+    return buf_ptr - buf;
+}
+
 /* Utility function for printing non-negative amounts */
 static int
 PrintAmountInternal(char *buf, gnc_numeric val, const GNCPrintAmountInfo *info)
 {
     struct lconv *lc = gnc_localeconv();
-    int num_whole_digits;
+    int num_whole_digits, decimal_len;
     char temp_buf[128];
     gnc_numeric whole, rounding;
     int min_dp, max_dp;
@@ -1509,6 +1624,10 @@ PrintAmountInternal(char *buf, gnc_numeric val, const GNCPrintAmountInfo *info)
         return 0;
     }
 
+    decimal_len = PrintDecimalAmount (buf, val, info, lc);
+    if (decimal_len >= 0)
+        return decimal_len;
+
     /* Print the absolute value, but remember sign */
     value_is_negative = gnc_numeric_negative_p (val);
     val = gnc_numeric_abs (val);
@@ -246,12 +246,40 @@ test_variable_expressions()
     success("variable found");
 }
 
+static void
+test_constant_expressions()
+{
+    gnc_numeric num;
+    gchar *errLoc = NULL;
+    int pass;
+
+    for (pass = 0; pass < 2; pass++)
+    {
+        num = gnc_numeric_zero ();
+        do_test(gnc_exp_parser_parse("(4 + 5 * 2) - 7 / 3", &num, &errLoc),
+                "constant expression parses");
+        do_test(gnc_numeric_equal(num, gnc_numeric_create(35, 3)),
+                "constant expression value");
+        do_test(errLoc == NULL, "no error location");
+
+        do_test(gnc_exp_parser_parse("(12)", &num, NULL),
+                "parenthesised number parses");
+        do_test(gnc_numeric_equal(num, gnc_numeric_create(-12, 1)),
+                "parenthesised number is negative");
+
+        do_test(!gnc_exp_parser_parse("4 / (1 - 1)", &num, NULL),
+                "divide by zero still fails");
+    }
+    success("constant expressions give the same answer when reparsed");
+}
+
 static void
 real_main (void *closure, int argc, char **argv)
 {
     /* set_should_print_success (TRUE); */
     test_parser();
     test_variable_expressions();
+    test_constant_expressions();
     print_test_results();
     exit(get_rv());
 }
@@ -160,9 +160,51 @@ run_tests (void)
     test_clear_error_list();
 }
 
+static void
+test_print_decimal (gint64 num, gint64 denom, int min_dp, int max_dp,
+                    gboolean round, const char *expected, int line)
+{
+    GNCPrintAmountInfo print_info;
+    const char *s;
+
+    print_info.commodity = NULL;
+    print_info.min_decimal_places = min_dp;
+    print_info.max_decimal_places = max_dp;
+    print_info.use_separators = 1;
+    print_info.use_symbol = 0;
+    print_info.use_locale = 1;
+    print_info.monetary = 1;
+    print_info.force_fit = 1;
+    print_info.round = round;
+
+    s = xaccPrintAmount (gnc_numeric_create (num, denom), print_info);
+    do_test_args (g_strcmp0 (s, expected) == 0, "print decimal", __FILE__, __LINE__,
+                  "%" G_GINT64_FORMAT "/%" G_GINT64_FORMAT " printed as %s, not %s (line %d)",
+                  num, denom, s, expected, line);
+}
+
+static void
+run_decimal_tests (void)
+{
+    test_print_decimal (123456789, 100, 2, 2, TRUE, "1,234,567.89", __LINE__);
+    test_print_decimal (-1234567, 100, 2, 2, TRUE, "-12,345.67", __LINE__);
+    test_print_decimal (100, 100, 2, 2, TRUE, "1.00", __LINE__);
+    test_print_decimal (100, 100, 0, 2, TRUE, "1", __LINE__);
+    test_print_decimal (1230, 1000, 0, 3, TRUE, "1.23", __LINE__);
+    test_print_decimal (5, 1000, 0, 2, TRUE, "0.01", __LINE__);
+    test_print_decimal (4, 1000, 2, 2, TRUE, "0.00", __LINE__);
+    test_print_decimal (999, 1000, 0, 2, TRUE, "1", __LINE__);
+    test_print_decimal (1239, 1000, 0, 2, FALSE, "1.23", __LINE__);
+    test_print_decimal (25, 10, 0, 2, TRUE, "2.5", __LINE__);
+    test_print_decimal (0, 1, 0, 2, TRUE, "0", __LINE__);
+    test_print_decimal (1000000, 1, 0, 0, TRUE, "1,000,000", __LINE__);
+    test_print_decimal (1, 3, 0, 2, TRUE, "0.33", __LINE__);
+}
+
 int
 main (int argc, char **argv)
 {
+    run_decimal_tests ();
     run_tests ();
     print_test_results ();
     exit (get_rv ());
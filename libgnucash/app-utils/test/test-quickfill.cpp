@@ -0,0 +1,110 @@
+/********************************************************************
+ * test-quickfill.cpp: test suite for QuickFill                     *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, you can retrieve it from        *
+ * https://www.gnu.org/licenses/old-licenses/gpl-2.0.html            *
+ * or contact:                                                      *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ ********************************************************************/
+#include "config.h"
+#include <glib.h>
+extern "C" {
+#include "../QuickFill.h"
+}
+#include <gtest/gtest.h>
+
+class QuickFillTest : public ::testing::Test
+{
+protected:
+    void SetUp () override { m_qf = gnc_quickfill_new (); }
+    void TearDown () override { gnc_quickfill_destroy (m_qf); }
+
+    const char* match (const char* str)
+    {
+        return gnc_quickfill_string (gnc_quickfill_get_string_match (m_qf, str));
+    }
+
+    QuickFill* m_qf;
+};
+
+TEST_F (QuickFillTest, LifoPrefersLastInserted)
+{
+    gnc_quickfill_insert (m_qf, "Groceries", QUICKFILL_LIFO);
+    gnc_quickfill_insert (m_qf, "Gasoline", QUICKFILL_LIFO);
+
+    EXPECT_STREQ ("Gasoline", match ("g"));
+    EXPECT_STREQ ("Groceries", match ("GR"));
+    EXPECT_EQ (nullptr, gnc_quickfill_get_string_match (m_qf, "x"));
+
+    gnc_quickfill_insert (m_qf, "Groceries", QUICKFILL_LIFO);
+    EXPECT_STREQ ("Groceries", match ("g"));
+}
+
+TEST_F (QuickFillTest, LifoLeavesPrefixesInPlace)
+{
+    gnc_quickfill_insert (m_qf, "Gas", QUICKFILL_LIFO);
+    gnc_quickfill_insert (m_qf, "Gasoline", QUICKFILL_LIFO);
+
+    EXPECT_STREQ ("Gas", match ("ga"));
+    EXPECT_STREQ ("Gasoline", match ("gaso"));
+}
+
+TEST_F (QuickFillTest, AlphaPrefersFirstInOrder)
+{
+    gnc_quickfill_insert (m_qf, "Rent", QUICKFILL_ALPHA);
+    gnc_quickfill_insert (m_qf, "Rebate", QUICKFILL_ALPHA);
+    gnc_quickfill_insert (m_qf, "Salary", QUICKFILL_ALPHA);
+
+    EXPECT_STREQ ("Rebate", match ("r"));
+    EXPECT_STREQ ("Rent", match ("ren"));
+}
+
+TEST_F (QuickFillTest, UniqueLenMatch)
+{
+    int len;
+
+    gnc_quickfill_insert (m_qf, "The Book", QUICKFILL_LIFO);
+    gnc_quickfill_insert (m_qf, "The Movie", QUICKFILL_LIFO);
+
+    auto qf = gnc_quickfill_get_unique_len_match (m_qf, &len);
+    EXPECT_EQ (4, len);
+    EXPECT_STREQ ("The Book",
+                  gnc_quickfill_string (gnc_quickfill_get_char_match (qf, 'b')));
+}
+
+TEST_F (QuickFillTest, Remove)
+{
+    gnc_quickfill_insert (m_qf, "Rent", QUICKFILL_LIFO);
+    gnc_quickfill_insert (m_qf, "Rebate", QUICKFILL_LIFO);
+
+    gnc_quickfill_remove (m_qf, "Rebate", QUICKFILL_LIFO);
+    EXPECT_STREQ ("Rent", match ("re"));
+    EXPECT_EQ (nullptr, gnc_quickfill_get_string_match (m_qf, "reb"));
+
+    gnc_quickfill_remove (m_qf, "Rent", QUICKFILL_LIFO);
+    EXPECT_EQ (nullptr, gnc_quickfill_get_string_match (m_qf, "r"));
+}
+
+TEST_F (QuickFillTest, Purge)
+{
+    gnc_quickfill_insert (m_qf, "Rent", QUICKFILL_LIFO);
+    gnc_quickfill_purge (m_qf);
+
+    EXPECT_EQ (nullptr, gnc_quickfill_get_string_match (m_qf, "r"));
+    gnc_quickfill_insert (m_qf, "Salary", QUICKFILL_LIFO);
+    EXPECT_STREQ ("Salary", match ("s"));
+}
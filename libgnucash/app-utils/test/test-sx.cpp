@@ -214,6 +214,49 @@ test_state_changes()
     remove_sx(foo);
 }
 
+static void
+test_update_sx_instances()
+{
+    SchedXaction *foo;
+    GDate *start, *end, *new_end;
+    GncSxInstanceModel *model;
+    GncSxInstances *insts;
+    GncSxInstance *inst;
+
+    start = g_date_new();
+    gnc_gdate_set_today (start);
+
+    end = g_date_new();
+    gnc_gdate_set_today (end);
+    g_date_add_days(end, 3);
+
+    foo = add_daily_sx("foo", start, NULL, NULL);
+    model = gnc_sx_get_instances(end, TRUE);
+    insts = (GncSxInstances*)g_list_nth_data(model->sx_instance_list, 0);
+    do_test(g_list_length(insts->instance_list) == 4, "4 instances");
+
+    inst = _nth_instance(insts, 0);
+    gnc_sx_instance_model_update_sx_instances(model, foo);
+    do_test(g_list_length(insts->instance_list) == 4, "unmodified sx kept its instances");
+    do_test(_nth_instance(insts, 0) == inst, "unmodified sx wasn't regenerated");
+
+    new_end = g_date_new();
+    gnc_gdate_set_today (new_end);
+    g_date_add_days(new_end, 1);
+    xaccSchedXactionSetEndDate(foo, new_end);
+
+    gnc_sx_instance_model_update_sx_instances(model, foo);
+    do_test(g_list_length(insts->instance_list) == 2, "modified sx regenerated");
+    do_test(_nth_instance(insts, 0) == inst, "matching instance retained");
+
+    gnc_sx_instance_model_update_sx_instances(model, foo);
+    do_test(g_list_length(insts->instance_list) == 2, "second update is a no-op");
+
+    g_object_unref(model);
+    remove_sx(foo);
+    g_date_free(new_end);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -229,6 +272,7 @@ main(int argc, char **argv)
     }
     test_basic();
     test_state_changes();
+    test_update_sx_instances();
 
     print_test_results();
     exit(get_rv());
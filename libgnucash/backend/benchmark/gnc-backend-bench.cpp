@@ -0,0 +1,307 @@
+/********************************************************************
+ * gnc-backend-bench.cpp -- time loading and saving through backends *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ *******************************************************************/
+
+/* gnc-backend-bench save SOURCE TARGET [--output FILE]
+ * gnc-backend-bench load TARGET [--output FILE]
+ *
+ * "save" reads the book at SOURCE, usually one written by gnc-gen-book,
+ * and writes it to TARGET; "load" reads TARGET back.  Each run appends
+ * one line of JSON with the phase timings in seconds and the peak
+ * resident set size in kilobytes to FILE, or prints it.  Saving and
+ * loading are separate runs so that each peak belongs to one of them.
+ *
+ * The XML backend doesn't separate its own phases, so they are worked
+ * out from the outside:
+ *   save: serialize  an uncompressed save
+ *         compress   a compressed save, less the uncompressed one
+ *         fsync      flushing the written file to the disk
+ *   load: parse      running the file through libxml2 without handlers
+ *         construct  the backend's load, less the parse
+ * The SQL backends report their save and load as a whole.  Both kinds
+ * of load also report recompute, the time to recompute every account's
+ * running balances in the loaded book. */
+
+#include <glib.h>
+
+extern "C"
+{
+#include <config.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <libxml/parser.h>
+
+#include "qof.h"
+#include "Account.h"
+#include "TransLog.h"
+#include "gnc-engine.h"
+#include "gnc-prefs.h"
+#include "gnc-uri-utils.h"
+}
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gnc-backend-xml.h"
+
+using Phases = std::vector<std::pair<std::string, double>>;
+
+static double
+time_call (const std::function<void ()>& call)
+{
+    auto start = std::chrono::steady_clock::now ();
+    call ();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now () - start;
+    return elapsed.count ();
+}
+
+static bool
+session_ok (QofSession* session, const char* what)
+{
+    if (qof_session_get_error (session) == ERR_BACKEND_NO_ERR)
+        return true;
+    g_printerr ("%s failed: %s\n", what, qof_session_get_error_message (session));
+    return false;
+}
+
+static bool
+is_xml_uri (const char* uri)
+{
+    auto scheme = gnc_uri_get_scheme (uri);
+    auto xml = !scheme || !g_strcmp0 (scheme, "xml") || !g_strcmp0 (scheme, "file");
+    g_free (scheme);
+    return xml;
+}
+
+/* Saves book to uri, replacing whatever is there. */
+static bool
+save_book (QofSession* book_session, const char* uri)
+{
+    auto session = qof_session_new (qof_book_new ());
+    qof_session_begin (session, uri, SESSION_NEW_OVERWRITE);
+    auto ok = session_ok (session, "Opening the target");
+    if (ok)
+    {
+        qof_session_swap_data (book_session, session);
+        qof_book_mark_session_dirty (qof_session_get_book (session));
+        qof_session_save (session, nullptr);
+        ok = session_ok (session, "Saving");
+        qof_session_swap_data (book_session, session);
+    }
+    qof_session_end (session);
+    qof_session_destroy (session);
+    return ok;
+}
+
+static void
+fsync_file (const char* uri)
+{
+    auto path = gnc_uri_get_path (uri);
+    auto fd = open (path, O_RDONLY);
+    if (fd >= 0)
+    {
+        fsync (fd);
+        close (fd);
+    }
+    g_free (path);
+}
+
+static bool
+run_save (const char* source, const char* target, Phases& phases)
+{
+    auto book_session = qof_session_new (qof_book_new ());
+    qof_session_begin (book_session, source, SESSION_READ_ONLY);
+    if (!session_ok (book_session, "Opening the source"))
+        return false;
+    qof_session_load (book_session, nullptr);
+    if (!session_ok (book_session, "Loading the source"))
+        return false;
+
+    bool ok = true;
+    if (is_xml_uri (target))
+    {
+        gnc_prefs_set_file_save_compressed (FALSE);
+        auto plain = time_call ([&]{ ok = save_book (book_session, target); });
+        gnc_prefs_set_file_save_compressed (TRUE);
+        auto compressed = time_call ([&]{ ok = ok && save_book (book_session, target); });
+        phases.emplace_back ("serialize", plain);
+        phases.emplace_back ("compress", compressed - plain);
+    }
+    else
+    {
+        phases.emplace_back ("save", time_call ([&]{ ok = save_book (book_session, target); }));
+    }
+    if (ok && gnc_uri_is_file_uri (target))
+        phases.emplace_back ("fsync", time_call ([&]{ fsync_file (target); }));
+
+    qof_session_end (book_session);
+    qof_session_destroy (book_session);
+    return ok;
+}
+
+/* Reads the possibly compressed file through libxml2's push parser
+ * with no SAX callbacks, which is all of the parsing and none of the
+ * object construction. */
+static void
+parse_xml_only (const char* uri)
+{
+    auto path = gnc_uri_get_path (uri);
+    auto file = gzopen (path, "rb");
+    g_free (path);
+    if (!file)
+        return;
+
+    xmlSAXHandler handler;
+    memset (&handler, 0, sizeof (handler));
+    handler.initialized = XML_SAX2_MAGIC;
+    char buf[65536];
+    auto len = gzread (file, buf, sizeof (buf));
+    auto ctxt = xmlCreatePushParserCtxt (&handler, nullptr, buf, MAX (len, 0), nullptr);
+    while ((len = gzread (file, buf, sizeof (buf))) > 0)
+        xmlParseChunk (ctxt, buf, len, 0);
+    xmlParseChunk (ctxt, nullptr, 0, 1);
+    xmlFreeParserCtxt (ctxt);
+    gzclose (file);
+}
+
+static void
+recompute_balances (QofBook* book)
+{
+    gnc_account_foreach_descendant (gnc_book_get_root_account (book),
+                                    (AccountCb)xaccAccountRecomputeBalance,
+                                    nullptr);
+}
+
+static bool
+run_load (const char* target, Phases& phases)
+{
+    auto xml = is_xml_uri (target);
+    double parse = 0.0;
+    if (xml)
+        parse = time_call ([&]{ parse_xml_only (target); });
+
+    auto session = qof_session_new (qof_book_new ());
+    qof_session_begin (session, target, SESSION_READ_ONLY);
+    if (!session_ok (session, "Opening the target"))
+        return false;
+    auto load = time_call ([&]{ qof_session_load (session, nullptr); });
+    if (!session_ok (session, "Loading"))
+        return false;
+
+    if (xml)
+    {
+        phases.emplace_back ("parse", parse);
+        phases.emplace_back ("construct", load - parse);
+    }
+    else
+    {
+        phases.emplace_back ("load", load);
+    }
+    auto book = qof_session_get_book (session);
+    phases.emplace_back ("recompute", time_call ([&]{ recompute_balances (book); }));
+
+    qof_session_end (session);
+    qof_session_destroy (session);
+    return true;
+}
+
+static void
+report (const char* mode, const char* uri, const Phases& phases, const char* output)
+{
+    struct rusage usage;
+    getrusage (RUSAGE_SELF, &usage);
+
+    /* Leave any password out of the record. */
+    auto scheme = gnc_uri_get_scheme (uri);
+    auto path = gnc_uri_get_path (uri);
+    auto line = g_string_new (nullptr);
+    g_string_append_printf (line, "{\"mode\": \"%s\", \"backend\": \"%s\", \"path\": \"%s\"",
+                            mode, scheme ? scheme : "xml", path ? path : "");
+    for (const auto& phase : phases)
+        g_string_append_printf (line, ", \"%s\": %.6f", phase.first.c_str (), phase.second);
+    g_string_append_printf (line, ", \"peak_rss_kb\": %ld}\n", usage.ru_maxrss);
+    g_free (scheme);
+    g_free (path);
+
+    auto out = output ? fopen (output, "a") : stdout;
+    if (out)
+    {
+        fputs (line->str, out);
+        if (out != stdout)
+            fclose (out);
+    }
+    else
+        g_printerr ("Can't write to %s\n", output);
+    g_string_free (line, TRUE);
+}
+
+static gchar* opt_output = nullptr;
+
+static GOptionEntry options[] =
+{
+    { "output", 'o', 0, G_OPTION_ARG_FILENAME, &opt_output,
+      "Append the results to FILE instead of printing them", "FILE" },
+    { NULL }
+};
+
+int
+main (int argc, char** argv)
+{
+    GError* error = nullptr;
+    auto context = g_option_context_new ("save SOURCE TARGET | load TARGET");
+    g_option_context_add_main_entries (context, options, nullptr);
+    auto parsed = g_option_context_parse (context, &argc, &argv, &error);
+    auto save = parsed && argc == 4 && !g_strcmp0 (argv[1], "save");
+    auto load = parsed && argc == 3 && !g_strcmp0 (argv[1], "load");
+    if (!save && !load)
+    {
+        if (error)
+            g_printerr ("%s\n", error->message);
+        auto help = g_option_context_get_help (context, TRUE, nullptr);
+        g_printerr ("%s", help);
+        g_free (help);
+        g_clear_error (&error);
+        g_option_context_free (context);
+        return 1;
+    }
+    g_option_context_free (context);
+
+    gnc_engine_init (0, nullptr);
+    xaccLogDisable ();
+    gnc_prefs_set_file_retention_policy (XML_RETAIN_NONE);
+
+    Phases phases;
+    auto target = save ? argv[3] : argv[2];
+    auto ok = save ? run_save (argv[2], target, phases) : run_load (target, phases);
+    if (ok)
+        report (argv[1], target, phases, opt_output);
+
+    g_free (opt_output);
+    gnc_engine_shutdown ();
+    return ok ? 0 : 1;
+}
@@ -52,7 +52,7 @@ extern "C"
 #define BUDGET_TABLE "budgets"
 #define TABLE_VERSION 1
 #define AMOUNTS_TABLE "budget_amounts"
-#define AMOUNTS_TABLE_VERSION 1
+#define AMOUNTS_TABLE_VERSION 2
 
 static QofLogModule log_module = G_LOG_DOMAIN;
 
@@ -109,6 +109,12 @@ static const EntryVec budget_amounts_col_table
                                          (QofSetterFunc)set_amount),
 };
 
+/* Special column table for the index on the amounts' budget */
+static const EntryVec budget_guid_col_table
+{
+    gnc_sql_make_table_entry<CT_GUID>("budget_guid", 0, 0),
+};
+
 /* ================================================================= */
 static QofInstance*
 get_budget (gpointer pObj)
@@ -361,6 +367,21 @@ GncSqlBudgetBackend::create_tables (GncSqlBackend* sql_be)
     {
         (void)sql_be->create_table(AMOUNTS_TABLE, AMOUNTS_TABLE_VERSION,
                                     budget_amounts_col_table);
+        if (!sql_be->create_index ("budget_amounts_budget_guid_index",
+                                   AMOUNTS_TABLE, budget_guid_col_table))
+            PERR ("Unable to create index\n");
+    }
+    else if (version < AMOUNTS_TABLE_VERSION)
+    {
+        /* Upgrade:
+            1->2: Add index on budget_guid
+        */
+        if (!sql_be->create_index ("budget_amounts_budget_guid_index",
+                                   AMOUNTS_TABLE, budget_guid_col_table))
+            PERR ("Unable to create index\n");
+        sql_be->set_table_version (AMOUNTS_TABLE, AMOUNTS_TABLE_VERSION);
+        PINFO ("Budget amounts table upgraded from version %d to version %d\n",
+               version, AMOUNTS_TABLE_VERSION);
     }
 }
 
@@ -159,6 +159,7 @@ GncSqlCommodityBackend::load_all (GncSqlBackend* sql_be)
             if (qof_instance_is_dirty (QOF_INSTANCE (pCommodity)))
                 sql_be->commodity_for_postload_processing(pCommodity);
             qof_instance_set_guid (QOF_INSTANCE (pCommodity), &guid);
+            sql_be->set_commodity_in_db (QOF_INSTANCE (pCommodity), true);
         }
 
     }
@@ -217,8 +218,12 @@ GncSqlCommodityBackend::commit (GncSqlBackend* sql_be, QofInstance* inst)
     g_return_val_if_fail (sql_be != NULL, FALSE);
     g_return_val_if_fail (inst != NULL, FALSE);
     g_return_val_if_fail (GNC_IS_COMMODITY (inst), FALSE);
-    auto in_be = instance_in_db(sql_be, inst);
-    return do_commit_commodity (sql_be, inst, !in_be);
+    auto in_be = sql_be->commodity_in_db (inst) ||
+        instance_in_db (sql_be, inst);
+    auto is_ok = do_commit_commodity (sql_be, inst, !in_be);
+    if (is_ok)
+        sql_be->set_commodity_in_db (inst, !qof_instance_get_destroying (inst));
+    return is_ok;
 }
 
 /* ----------------------------------------------------------------- */
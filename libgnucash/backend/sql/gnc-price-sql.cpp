@@ -56,18 +56,26 @@ static QofLogModule log_module = G_LOG_DOMAIN;
 #define PRICE_MAX_SOURCE_LEN 2048
 #define PRICE_MAX_TYPE_LEN 2048
 
+/* Saved through the price's properties, loaded with its setters. */
 static const EntryVec col_table
 ({
-    gnc_sql_make_table_entry<CT_GUID>("guid", 0, COL_NNUL | COL_PKEY, "guid"),
+    gnc_sql_make_table_entry<CT_GUID>("guid", 0, COL_NNUL | COL_PKEY, "guid",
+                                      (QofSetterFunc)qof_instance_set_guid),
     gnc_sql_make_table_entry<CT_COMMODITYREF>("commodity_guid", 0, COL_NNUL,
-                                              "commodity"),
+                                              "commodity",
+                                              (QofSetterFunc)gnc_price_set_commodity),
     gnc_sql_make_table_entry<CT_COMMODITYREF>("currency_guid", 0, COL_NNUL,
-                                              "currency"),
-    gnc_sql_make_table_entry<CT_TIME>("date", 0, COL_NNUL, "date"),
+                                              "currency",
+                                              (QofSetterFunc)gnc_price_set_currency),
+    gnc_sql_make_table_entry<CT_TIME>("date", 0, COL_NNUL, "date",
+                                      (QofSetterFunc)gnc_price_set_time64),
     gnc_sql_make_table_entry<CT_STRING>("source", PRICE_MAX_SOURCE_LEN, 0,
-                                        "source"),
-    gnc_sql_make_table_entry<CT_STRING>("type", PRICE_MAX_TYPE_LEN, 0, "type"),
-    gnc_sql_make_table_entry<CT_NUMERIC>("value", 0, COL_NNUL, "value")
+                                        "source",
+                                        (QofSetterFunc)gnc_price_set_source_string),
+    gnc_sql_make_table_entry<CT_STRING>("type", PRICE_MAX_TYPE_LEN, 0, "type",
+                                        (QofSetterFunc)gnc_price_set_typestr),
+    gnc_sql_make_table_entry<CT_NUMERIC>("value", 0, COL_NNUL, "value",
+                                         (QofSetterFunc)gnc_price_set_value)
 });
 
 GncSqlPriceBackend::GncSqlPriceBackend() :
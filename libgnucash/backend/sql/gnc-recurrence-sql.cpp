@@ -49,7 +49,7 @@ extern "C"
 G_GNUC_UNUSED static QofLogModule log_module = G_LOG_DOMAIN;
 
 #define TABLE_NAME "recurrences"
-#define TABLE_VERSION 2
+#define TABLE_VERSION 3
 
 #define BUDGET_MAX_RECURRENCE_PERIOD_TYPE_LEN 2048
 #define BUDGET_MAX_RECURRENCE_WEEKEND_ADJUST_LEN 2048
@@ -367,6 +367,37 @@ gnc_sql_recurrence_load_list (GncSqlBackend* sql_be, const GncGUID* guid)
     return list;
 }
 
+RecurrenceListMap
+gnc_sql_recurrence_load_lists_for_sql_subquery (GncSqlBackend* sql_be,
+                                                const std::string& subquery)
+{
+    RecurrenceListMap lists;
+
+    g_return_val_if_fail (sql_be != NULL, lists);
+
+    const std::string idkey(col_table[0]->name());
+    const std::string objkey(guid_col_table[0]->name());
+    std::string sql("SELECT * FROM " TABLE_NAME " WHERE ");
+    sql += objkey + " IN (" + subquery + ") ORDER BY " + idkey;
+    auto stmt = sql_be->create_statement_from_sql (sql);
+    if (stmt == nullptr)
+        return lists;
+    auto result = sql_be->execute_select_statement(stmt);
+    for (auto row : *result)
+    {
+        Recurrence* pRecurrence = g_new0 (Recurrence, 1);
+        g_assert (pRecurrence != NULL);
+        load_recurrence (sql_be, row, pRecurrence);
+        auto& list = lists[row.get_string_at_col (objkey.c_str())];
+        list = g_list_prepend (list, pRecurrence);
+    }
+    delete result;
+
+    for (auto& entry : lists)
+        entry.second = g_list_reverse (entry.second);
+    return lists;
+}
+
 /* ================================================================= */
 static void
 upgrade_recurrence_table_1_2 (GncSqlBackend* sql_be)
@@ -409,16 +440,29 @@ GncSqlRecurrenceBackend::create_tables (GncSqlBackend* sql_be)
     if (version == 0)
     {
         (void)sql_be->create_table(TABLE_NAME, TABLE_VERSION, col_table);
+        ok = sql_be->create_index ("recurrences_obj_guid_index", TABLE_NAME,
+                                   guid_col_table);
+        if (!ok)
+        {
+            PERR ("Unable to create index\n");
+        }
     }
     else if (version < TABLE_VERSION)
     {
         /* Upgrade:
             1->2: Add recurrence_weekend_adjust field (mandatory, non-null field)
+            2->3: Add index on obj_guid
         */
-        if (version < m_version)
+        if (version < 2)
         {
             upgrade_recurrence_table_1_2 (sql_be);
         }
+        ok = sql_be->create_index ("recurrences_obj_guid_index", TABLE_NAME,
+                                   guid_col_table);
+        if (!ok)
+        {
+            PERR ("Unable to create index\n");
+        }
         sql_be->set_table_version (TABLE_NAME, TABLE_VERSION);
         PINFO ("Recurrence table upgraded from version %d to version %d\n", version,
                TABLE_VERSION);
@@ -34,6 +34,9 @@ extern "C"
 #include "Recurrence.h"
 #include "guid.h"
 }
+#include <string>
+#include <unordered_map>
+
 #include "gnc-sql-object-backend.hpp"
 
 class GncSqlRecurrenceBackend : public GncSqlObjectBackend
@@ -53,4 +56,17 @@ gboolean gnc_sql_recurrence_delete (GncSqlBackend* sql_be, const GncGUID* guid);
 Recurrence* gnc_sql_recurrence_load (GncSqlBackend* sql_be, const GncGUID* guid);
 GList* gnc_sql_recurrence_load_list (GncSqlBackend* sql_be, const GncGUID* guid);
 
+/** Recurrence lists keyed by the string form of the owning object's guid. */
+using RecurrenceListMap = std::unordered_map<std::string, GList*>;
+/**
+ * Loads the recurrence lists of all objects whose guid is supplied by a
+ * subquery of the form "SELECT guid FROM ..." in a single query.
+ *
+ * @param sql_be SQL backend
+ * @param subquery Subquery selecting the object guids
+ * @return The lists found. The caller takes ownership of them.
+ */
+RecurrenceListMap gnc_sql_recurrence_load_lists_for_sql_subquery (GncSqlBackend* sql_be,
+                                                                  const std::string& subquery);
+
 #endif /* GNC_RECURRENCE_SQL_H */
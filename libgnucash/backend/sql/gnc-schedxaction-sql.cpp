@@ -25,6 +25,7 @@
  * This file implements the top-level QofBackend API for saving/
  * restoring data to/from an SQL db
  */
+#include <guid.hpp>
 #include <glib.h>
 
 extern "C"
@@ -90,12 +91,12 @@ GncSqlSchedXactionBackend::GncSqlSchedXactionBackend() :
 
 /* ================================================================= */
 static  SchedXaction*
-load_single_sx (GncSqlBackend* sql_be, GncSqlRow& row)
+load_single_sx (GncSqlBackend* sql_be, GncSqlRow& row,
+                RecurrenceListMap& schedules)
 {
     const GncGUID* guid;
     SchedXaction* pSx;
-    GList* schedule;
-    GDate start_date;
+    GList* schedule = nullptr;
 
     g_return_val_if_fail (sql_be != NULL, NULL);
 
@@ -105,12 +106,14 @@ load_single_sx (GncSqlBackend* sql_be, GncSqlRow& row)
 
     gnc_sx_begin_edit (pSx);
     gnc_sql_load_object (sql_be, row, GNC_SX_ID, pSx, col_table);
-    schedule = gnc_sql_recurrence_load_list (sql_be, guid);
+    auto it = schedules.find (gnc::GUID(*guid).to_string());
+    if (it != schedules.end())
+    {
+        schedule = it->second;
+        schedules.erase (it);
+    }
     gnc_sx_set_schedule (pSx, schedule);
     gnc_sx_commit_edit (pSx);
-    gnc_sql_transaction_load_tx_for_account (sql_be, pSx->template_acct);
-
-    g_object_get (pSx, "start-date", &start_date, NULL);
 
     return pSx;
 }
@@ -122,6 +125,10 @@ gnc_sx_lookup (const GncGUID *guid, const QofBook *book)
      QOF_BOOK_RETURN_ENTITY(book, guid, GNC_ID_SCHEDXACTION, SchedXaction);
 }
 
+/* The schedules and template transactions of all of the scheduled
+ * transactions are each loaded with one query rather than with one per
+ * scheduled transaction.
+ */
 void
 GncSqlSchedXactionBackend::load_all (GncSqlBackend* sql_be)
 {
@@ -134,15 +141,25 @@ GncSqlSchedXactionBackend::load_all (GncSqlBackend* sql_be)
     SchedXactions* sxes;
     sxes = gnc_book_get_schedxactions (sql_be->book());
 
+    std::string pkey(col_table[0]->name());
+    std::string subquery("SELECT " + pkey + " FROM " SCHEDXACTION_TABLE);
+    auto schedules =
+        gnc_sql_recurrence_load_lists_for_sql_subquery (sql_be, subquery);
     for (auto row : *result)
     {
         SchedXaction* sx;
 
-        sx = load_single_sx (sql_be, row);
+        sx = load_single_sx (sql_be, row, schedules);
         if (sx != nullptr)
             gnc_sxes_add_sx (sxes, sx);
     }
-    std::string pkey(col_table[0]->name());
+    for (auto& entry : schedules)
+        g_list_free_full (entry.second, g_free);
+
+    std::string tkey(col_table[col_table.size() - 1]->name());
+    subquery = "SELECT " + tkey + " FROM " SCHEDXACTION_TABLE;
+    gnc_sql_transaction_load_tx_for_accounts (sql_be, subquery);
+
     sql = "SELECT DISTINCT ";
     sql += pkey + " FROM " SCHEDXACTION_TABLE;
     gnc_sql_slots_load_for_sql_subquery (sql_be, sql,
@@ -42,6 +42,8 @@ extern "C"
 
 #include <string>
 #include <sstream>
+#include <unordered_set>
+#include <vector>
 
 #include "gnc-sql-connection.hpp"
 #include "gnc-sql-backend.hpp"
@@ -63,6 +65,9 @@ typedef enum
     LIST
 } context_t;
 
+struct pending_slots_t;
+using PendingSlotsMap = std::unordered_map<std::string, pending_slots_t>;
+
 struct slot_info_t
 {
     GncSqlBackend* be;
@@ -75,6 +80,17 @@ struct slot_info_t
     KvpValue* pKvpValue;
     std::string path;
     std::string parent_path;
+    /* When loading in bulk, frames and lists wait here for their rows
+     * instead of querying for them one by one. */
+    PendingSlotsMap* pending = nullptr;
+};
+
+/* A frame or list waiting for its rows during a bulk load. list_value is
+ * the value receiving a list's items. */
+struct pending_slots_t
+{
+    slot_info_t* info;
+    KvpValue* list_value;
 };
 
 
@@ -100,6 +116,8 @@ static GDate* get_gdate_val (gpointer pObject);
 static void set_gdate_val (gpointer pObject, GDate* value);
 static slot_info_t* slot_info_copy (slot_info_t* pInfo, GncGUID* guid);
 static void slots_load_info (slot_info_t* pInfo);
+static void defer_slots (slot_info_t* pInfo, const GncGUID* guid,
+                         KvpValue* list_value);
 
 #define SLOT_MAX_PATHNAME_LEN 4096
 #define SLOT_MAX_STRINGVAL_LEN 4096
@@ -456,6 +474,13 @@ set_guid_val (gpointer pObject,  gpointer pValue)
 
         newInfo->context = LIST;
 
+        if (pInfo->pending != nullptr)
+        {
+            pValue = new KvpValue {static_cast<GList*> (nullptr)};
+            pInfo->pKvpFrame->set ({key.c_str()}, pValue);
+            defer_slots (newInfo, newInfo->guid, pValue);
+            break;
+        }
         slots_load_info (newInfo);
         pValue = new KvpValue {newInfo->pList};
         pInfo->pKvpFrame->set ({key.c_str()}, pValue);
@@ -487,6 +512,11 @@ set_guid_val (gpointer pObject,  gpointer pValue)
         }
 
         newInfo->context = FRAME;
+        if (pInfo->pending != nullptr)
+        {
+            defer_slots (newInfo, newInfo->guid, nullptr);
+            break;
+        }
         slots_load_info (newInfo);
         delete newInfo;
         break;
@@ -570,6 +600,7 @@ slot_info_copy (slot_info_t* pInfo, GncGUID* guid)
     newSlot->pList = pInfo->pList;
     newSlot->context = pInfo->context;
     newSlot->pKvpValue = pInfo->pKvpValue;
+    newSlot->pending = pInfo->pending;
     if (!pInfo->path.empty())
         newSlot->parent_path = pInfo->path + "/";
     else
@@ -646,23 +677,128 @@ save_slot (const char* key, KvpValue* value, slot_info_t & slot_info)
     }
 }
 
+/* Brings the saved slots of an object in line with pFrame one top-level key
+ * at a time: the rows of keys whose value changed or went away are deleted,
+ * along with any frame or list beneath them, and only the changed and new
+ * keys are inserted. Rows that don't look like ones save_slot() wrote fall
+ * back to replacing everything.
+ */
+static gboolean
+update_slots (GncSqlBackend* sql_be, const GncGUID* guid, KvpFrame* pFrame)
+{
+    gnc::GUID obj_guid(*guid);
+    std::string sql("SELECT * FROM " TABLE_NAME " WHERE obj_guid='");
+    sql += obj_guid.to_string() + "'";
+    auto stmt = sql_be->create_statement_from_sql(sql);
+    if (stmt == nullptr)
+        return FALSE;
+
+    KvpFrame saved;
+    std::unordered_set<std::string> saved_keys;
+    std::unordered_set<std::string> unchanged;
+    std::string stale_ids;
+    std::vector<GncGUID> stale_children;
+    auto replace_all = false;
+    auto result = sql_be->execute_select_statement (stmt);
+    for (auto row : *result)
+    {
+        slot_info_t info = { sql_be, guid, TRUE, &saved,
+                             KvpValue::Type::INVALID, NULL, NONE, NULL, "" };
+        gnc_sql_load_object (sql_be, row, TABLE_NAME, &info, col_table);
+        auto key = info.path;
+        if (key.empty() || key.find ('/') != std::string::npos ||
+            !saved_keys.insert (key).second)
+        {
+            replace_all = true;
+            break;
+        }
+        auto value = pFrame->get_slot ({key});
+        if (value && compare (value, saved.get_slot ({key})) == 0)
+        {
+            unchanged.insert (key);
+            continue;
+        }
+        if (!stale_ids.empty())
+            stale_ids += ",";
+        stale_ids += std::to_string (row.get_int_at_col (col_table[id_col]->name()));
+        if (info.value_type == KvpValue::Type::FRAME ||
+            info.value_type == KvpValue::Type::GLIST)
+        {
+            try
+            {
+                GncGUID child_guid;
+                auto val = row.get_string_at_col (col_table[guid_val_col]->name());
+                if (string_to_guid (val.c_str(), &child_guid))
+                    stale_children.push_back (child_guid);
+            }
+            catch (std::invalid_argument&)
+            {
+                continue;
+            }
+        }
+    }
+    delete result;
+
+    if (replace_all)
+    {
+        unchanged.clear();
+        if (!gnc_sql_slots_delete (sql_be, guid))
+            return FALSE;
+    }
+    else
+    {
+        if (!stale_ids.empty())
+        {
+            sql = "DELETE FROM " TABLE_NAME " WHERE ";
+            sql += std::string{col_table[id_col]->name()} + " IN (" +
+                stale_ids + ")";
+            stmt = sql_be->create_statement_from_sql(sql);
+            if (stmt == nullptr ||
+                sql_be->execute_nonselect_statement (stmt) < 0)
+                return FALSE;
+        }
+        for (auto& child : stale_children)
+            if (!gnc_sql_slots_delete (sql_be, &child))
+                return FALSE;
+    }
+
+    slot_info_t slot_info = { sql_be, guid, TRUE, NULL,
+                              KvpValue::Type::INVALID, NULL, FRAME, NULL, "" };
+    pFrame->for_each_slot_temp (
+        [&unchanged, &slot_info](const char* key, KvpValue* value)
+        {
+            if (unchanged.count (key) == 0)
+                save_slot (key, value, slot_info);
+        });
+
+    return slot_info.is_ok;
+}
+
 gboolean
 gnc_sql_slots_save (GncSqlBackend* sql_be, const GncGUID* guid, gboolean is_infant,
                     QofInstance* inst)
 {
     slot_info_t slot_info = { NULL, NULL, TRUE, NULL, KvpValue::Type::INVALID,
                               NULL, FRAME, NULL, "" };
-    KvpFrame* pFrame = qof_instance_get_slots (inst);
+    KvpFrame* pFrame;
 
     g_return_val_if_fail (sql_be != NULL, FALSE);
     g_return_val_if_fail (guid != NULL, FALSE);
-    g_return_val_if_fail (pFrame != NULL, FALSE);
+    g_return_val_if_fail (inst != NULL, FALSE);
 
-    // If this is not saving into a new db, clear out the old saved slots first
-    if (!sql_be->pristine() && !is_infant)
+    /* Don't make a frame for an instance that has no slots; all there
+     * can be to do is drop the slots it used to have. */
+    if (!qof_instance_has_kvp (inst))
     {
-        (void)gnc_sql_slots_delete (sql_be, guid);
+        if (sql_be->pristine() || is_infant)
+            return TRUE;
+        return gnc_sql_slots_delete (sql_be, guid);
     }
+    pFrame = qof_instance_get_slots (inst);
+
+    // If this is not saving into a new db, write only what has changed
+    if (!sql_be->pristine() && !is_infant)
+        return update_slots (sql_be, guid, pFrame);
 
     slot_info.be = sql_be;
     slot_info.guid = guid;
@@ -822,7 +958,7 @@ load_slot_for_list_item (GncSqlBackend* sql_be, GncSqlRow& row,
 
 static void
 load_slot_for_book_object (GncSqlBackend* sql_be, GncSqlRow& row,
-                           BookLookupFn lookup_fn)
+                           BookLookupFn lookup_fn, PendingSlotsMap& pending)
 {
     slot_info_t slot_info = { NULL, NULL, TRUE, NULL, KvpValue::Type::INVALID,
                               NULL, FRAME, NULL, "" };
@@ -840,10 +976,75 @@ load_slot_for_book_object (GncSqlBackend* sql_be, GncSqlRow& row,
     slot_info.be = sql_be;
     slot_info.pKvpFrame = qof_instance_get_slots (inst);
     slot_info.path.clear();
+    slot_info.pending = &pending;
 
     gnc_sql_load_object (sql_be, row, TABLE_NAME, &slot_info, col_table);
 }
 
+static void
+defer_slots (slot_info_t* pInfo, const GncGUID* guid, KvpValue* list_value)
+{
+    auto key = gnc::GUID(*guid).to_string();
+    pInfo->guid = nullptr; // Only valid for the duration of the setter.
+    if (!pInfo->pending->emplace (key, pending_slots_t {pInfo, list_value}).second)
+    {
+        PWARN ("Slots %s are referenced more than once", key.c_str());
+        delete pInfo;
+    }
+}
+
+/* Loads the rows of the frames and lists met during a bulk load, one query per
+ * level of nesting (split into chunks of SLOTS_GUID_CHUNK guids) rather than
+ * one per frame, dispatching each row to its frame by guid.
+ */
+#define SLOTS_GUID_CHUNK 1000
+
+static void
+load_pending_slots (GncSqlBackend* sql_be, PendingSlotsMap& pending)
+{
+    const std::string objkey(col_table[obj_guid_col]->name());
+    const std::string idkey(col_table[id_col]->name());
+    while (!pending.empty())
+    {
+        PendingSlotsMap level;
+        level.swap (pending);
+
+        auto next = level.begin();
+        while (next != level.end())
+        {
+            std::string sql("SELECT * FROM " TABLE_NAME " WHERE ");
+            sql += objkey + " IN (";
+            for (auto n = 0; next != level.end() && n < SLOTS_GUID_CHUNK;
+                 ++next, ++n)
+            {
+                if (n > 0)
+                    sql += ",";
+                sql += "'" + next->first + "'";
+            }
+            // List items must come back in the order they were saved.
+            sql += ") ORDER BY " + idkey;
+            auto stmt = sql_be->create_statement_from_sql(sql);
+            if (stmt == nullptr)
+                continue;
+            auto result = sql_be->execute_select_statement(stmt);
+            for (auto row : *result)
+            {
+                auto owner = level.find (row.get_string_at_col (objkey.c_str()));
+                if (owner != level.end())
+                    load_slot (owner->second.info, row);
+            }
+            delete result;
+        }
+
+        for (auto& entry : level)
+        {
+            if (entry.second.list_value != nullptr)
+                entry.second.list_value->set (entry.second.info->pList);
+            delete entry.second.info;
+        }
+    }
+}
+
 /**
  * gnc_sql_slots_load_for_sql_subquery - Loads slots for all objects whose guid is
  * supplied by a subquery.  The subquery should be of the form "SELECT DISTINCT guid FROM ...".
@@ -874,9 +1075,11 @@ void gnc_sql_slots_load_for_sql_subquery (GncSqlBackend* sql_be,
         return;
     }
     auto result = sql_be->execute_select_statement(stmt);
+    PendingSlotsMap pending;
     for (auto row : *result)
-        load_slot_for_book_object (sql_be, row, lookup_fn);
+        load_slot_for_book_object (sql_be, row, lookup_fn, pending);
     delete result;
+    load_pending_slots (sql_be, pending);
 }
 
 /* ================================================================= */
@@ -96,9 +96,11 @@ GncSqlBackend::~GncSqlBackend()
 void
 GncSqlBackend::connect(GncSqlConnection *conn) noexcept
 {
+    finish_group_commit();
     if (m_conn != nullptr && m_conn != conn)
         delete m_conn;
     finalize_version_info();
+    m_commodities_in_db.clear();
     m_conn = conn;
 }
 
@@ -117,6 +119,9 @@ GncSqlBackend::create_statement_from_sql(const std::string& str) const noexcept
 GncSqlResultPtr
 GncSqlBackend::execute_select_statement(const GncSqlStatementPtr& stmt) const noexcept
 {
+    /* Whatever is asked for must see the rows already written. */
+    if (!flush_pending_inserts())
+        return nullptr;
     auto result = m_conn ? m_conn->execute_select_statement(stmt) : nullptr;
     if (result == nullptr)
     {
@@ -129,6 +134,8 @@ GncSqlBackend::execute_select_statement(const GncSqlStatementPtr& stmt) const no
 int
 GncSqlBackend::execute_nonselect_statement(const GncSqlStatementPtr& stmt) const noexcept
 {
+    if (!flush_pending_inserts())
+        return -1;
     int result = m_conn ? m_conn->execute_nonselect_statement(stmt) : -1;
     if (result == -1)
     {
@@ -178,9 +185,24 @@ GncSqlBackend::create_index(const std::string& index_name,
                             const EntryVec& col_table) const noexcept
 {
     g_return_val_if_fail (m_conn != nullptr, false);
+    if (m_defer_indexes)
+    {
+        m_pending_indexes.push_back({index_name, table_name, col_table});
+        return true;
+    }
     return m_conn->create_index(index_name, table_name, col_table);
 }
 
+void
+GncSqlBackend::create_pending_indexes() noexcept
+{
+    QofTraceSpan span {"backend", "sql.create-indexes"};
+    for (const auto& index : m_pending_indexes)
+        if (!m_conn->create_index(index.name, index.table, index.columns))
+            PERR ("Unable to create index %s\n", index.name.c_str());
+    m_pending_indexes.clear();
+}
+
 bool
 GncSqlBackend::add_columns_to_table(const std::string& table_name,
                                     const EntryVec& col_table) const noexcept
@@ -213,6 +235,7 @@ GncSqlBackend::finish_progress() const noexcept
 void
 GncSqlBackend::create_tables() noexcept
 {
+    QofTraceSpan span {"backend", "sql.create-tables"};
     for(auto entry : m_backend_registry)
     {
         update_progress(101.0);
@@ -252,6 +275,7 @@ GncSqlBackend::ObjectBackendRegistry::load_remaining(GncSqlBackend* sql_be)
 
         num_done++;
         sql_be->update_progress(num_done * 100 / num_types);
+        QofTraceSpan span {"backend", "sql.load", type.c_str()};
         obe->load_all (sql_be);
     }
 }
@@ -302,6 +326,7 @@ GncSqlBackend::load (QofBook* book, QofBackendLoadType loadType)
             if (obe)
             {
                 update_progress(num_done * 100 / num_types);
+                QofTraceSpan span {"backend", "sql.load", type.c_str()};
                 obe->load_all(this);
             }
         }
@@ -312,6 +337,7 @@ GncSqlBackend::load (QofBook* book, QofBackendLoadType loadType)
             if (obe)
             {
                 update_progress(num_done * 100 / num_types);
+                QofTraceSpan span {"backend", "sql.load", type.c_str()};
                 obe->load_all(this);
             }
         }
@@ -319,16 +345,26 @@ GncSqlBackend::load (QofBook* book, QofBackendLoadType loadType)
         root = gnc_book_get_root_account( book );
         gnc_account_foreach_descendant(root, (AccountCb)xaccAccountBeginEdit,
                                        nullptr);
+        gnc_account_foreach_descendant(root,
+                                       (AccountCb)gnc_account_begin_bulk_insert,
+                                       nullptr);
 
         m_backend_registry.load_remaining(this);
 
+        qof_trace_begin ("backend", "sql.bulk-insert", nullptr);
+        gnc_account_tree_bring_up_to_date (root);
+        gnc_account_foreach_descendant(root,
+                                       (AccountCb)gnc_account_end_bulk_insert,
+                                       nullptr);
         gnc_account_foreach_descendant(root, (AccountCb)xaccAccountCommitEdit,
                                        nullptr);
+        qof_trace_end ();
     }
     else if (loadType == LOAD_TYPE_LOAD_ALL)
     {
         // Load all transactions
         auto obe = m_backend_registry.get_object_backend (GNC_ID_TRANS);
+        QofTraceSpan span {"backend", "sql.load", GNC_ID_TRANS};
         obe->load_all (this);
     }
 
@@ -380,6 +416,7 @@ GncSqlBackend::write_account_tree(Account* root)
 bool
 GncSqlBackend::write_accounts()
 {
+    QofTraceSpan span {"backend", "sql.write-accounts"};
     update_progress(101.0);
     auto is_ok = write_account_tree (gnc_book_get_root_account (m_book));
     if (is_ok)
@@ -414,6 +451,7 @@ write_tx (Transaction* tx, gpointer data)
 bool
 GncSqlBackend::write_transactions()
 {
+    QofTraceSpan span {"backend", "sql.write-transactions"};
     auto obe = m_backend_registry.get_object_backend(GNC_ID_TRANS);
     write_objects_t data{this, TRUE, obe.get()};
 
@@ -426,6 +464,7 @@ GncSqlBackend::write_transactions()
 bool
 GncSqlBackend::write_template_transactions()
 {
+    QofTraceSpan span {"backend", "sql.write-template-transactions"};
     auto obe = m_backend_registry.get_object_backend(GNC_ID_TRANS);
     write_objects_t data{this, true, obe.get()};
     auto ra = gnc_book_get_template_root (m_book);
@@ -441,6 +480,7 @@ GncSqlBackend::write_template_transactions()
 bool
 GncSqlBackend::write_schedXactions()
 {
+    QofTraceSpan span {"backend", "sql.write-scheduled-transactions"};
     GList* schedXactions;
     SchedXaction* tmpSX;
     bool is_ok = true;
@@ -466,17 +506,24 @@ GncSqlBackend::sync(QofBook* book)
     g_return_if_fail (book != NULL);
     g_return_if_fail (m_conn != nullptr);
 
+    finish_group_commit();
     reset_version_info();
     ENTER ("book=%p, sql_be->book=%p", book, m_book);
     update_progress(101.0);
 
     /* Create new tables */
     m_is_pristine_db = true;
+    m_commodities_in_db.clear();
+    /* Indexes are cheaper to build over the loaded tables than to keep up
+     * to date row by row. */
+    m_defer_indexes = true;
     create_tables();
+    m_defer_indexes = false;
 
     /* Save all contents */
     m_book = book;
     auto is_ok = m_conn->begin_transaction();
+    m_defer_inserts = is_ok;
 
     // FIXME: should write the set of commodities that are used
     // write_commodities(sql_be, book);
@@ -504,10 +551,21 @@ GncSqlBackend::sync(QofBook* book)
     if (is_ok)
     {
         for (auto entry : m_backend_registry)
+        {
+            QofTraceSpan span {"backend", "sql.write", std::get<0>(entry).c_str()};
             std::get<1>(entry)->write (this);
+        }
     }
     if (is_ok)
     {
+        QofTraceSpan span {"backend", "sql.flush-inserts"};
+        is_ok = flush_pending_inserts();
+    }
+    m_defer_inserts = false;
+    m_pending_inserts.clear();
+    if (is_ok)
+    {
+        QofTraceSpan span {"backend", "sql.commit-transaction"};
         is_ok = m_conn->commit_transaction();
     }
     if (is_ok)
@@ -523,7 +581,9 @@ GncSqlBackend::sync(QofBook* book)
     {
         set_error (ERR_BACKEND_SERVER_ERR);
         m_conn->rollback_transaction ();
+        m_commodities_in_db.clear();
     }
+    create_pending_indexes();
     finish_progress();
     LEAVE ("book=%p", book);
 }
@@ -549,6 +609,57 @@ GncSqlBackend::rollback(QofInstance* inst)
     //LEAVE ("");
 }
 
+void
+GncSqlBackend::begin_batch()
+{
+    if (m_batch_level++ > 0) return;
+    m_batch_open = m_conn != nullptr && !m_loading &&
+        !qof_book_is_readonly(m_book) && m_conn->begin_transaction ();
+}
+
+bool
+GncSqlBackend::commit_batch()
+{
+    g_return_val_if_fail (m_batch_level > 0, false);
+    if (--m_batch_level > 0 || !m_batch_open) return true;
+    m_batch_open = false;
+    if (!m_conn->commit_transaction ())
+    {
+        PERR ("Committing the batch failed");
+        m_commodities_in_db.clear();
+        /* The commits in the batch marked the book saved, but the
+         * database threw them all away. */
+        qof_book_mark_session_dirty (m_book);
+        set_error (ERR_BACKEND_SERVER_ERR);
+        return false;
+    }
+    return true;
+}
+
+void
+GncSqlBackend::set_group_commit(unsigned int ms) noexcept
+{
+    finish_group_commit();
+    m_group_commit_ms = ms;
+}
+
+static gboolean
+group_commit_timeout(gpointer data)
+{
+    static_cast<GncSqlBackend*>(data)->finish_group_commit();
+    return G_SOURCE_REMOVE;
+}
+
+void
+GncSqlBackend::finish_group_commit() noexcept
+{
+    if (m_group_commit_source == 0)
+        return;
+    g_source_remove (m_group_commit_source);
+    m_group_commit_source = 0;
+    commit_batch();
+}
+
 void
 GncSqlBackend::commodity_for_postload_processing(gnc_commodity* commodity)
 {
@@ -614,6 +725,21 @@ GncSqlBackend::commit (QofInstance* inst)
         return;
     }
 
+    static QofStat *commit_stat;
+    QofStatTimer timer {qof_stat_cached (&commit_stat, "sql.commit")};
+
+    /* Open a commit group unless one is open already. The group is an
+     * ordinary batch, so each commit in it only adds a savepoint. */
+    if (m_group_commit_ms > 0 && m_group_commit_source == 0)
+    {
+        begin_batch();
+        if (m_batch_open)
+            m_group_commit_source = g_timeout_add (m_group_commit_ms,
+                                                   group_commit_timeout, this);
+        else
+            commit_batch();
+    }
+
     if (!m_conn->begin_transaction ())
     {
         PERR ("begin_transaction failed\n");
@@ -641,6 +767,7 @@ GncSqlBackend::commit (QofInstance* inst)
     {
         // Error - roll it back
         (void)m_conn->rollback_transaction();
+        m_commodities_in_db.clear();
 
         // This *should* leave things marked dirty
         LEAVE ("Rolled back - database error");
@@ -854,6 +981,10 @@ GncSqlBackend::do_db_operation (E_DB_OPERATION op, const char* table_name,
     g_return_val_if_fail (obj_name != nullptr, false);
     g_return_val_if_fail (pObject != nullptr, false);
 
+    if (op == OP_DB_INSERT && m_defer_inserts)
+        return defer_insert (table_name,
+                             get_object_values (obj_name, pObject, table));
+
     switch(op)
     {
         case  OP_DB_INSERT:
@@ -871,17 +1002,122 @@ GncSqlBackend::do_db_operation (E_DB_OPERATION op, const char* table_name,
     return (execute_nonselect_statement(stmt) != -1);
 }
 
+/* Kept under the smallest default limits: older SQLite caps a VALUES
+ * list at 500 rows and MySQL's max_allowed_packet is 4MB. */
+#define MAX_PENDING_INSERT_ROWS 250
+#define MAX_PENDING_INSERT_BYTES (1 << 20)
+
+bool
+GncSqlBackend::defer_insert (const char* table_name,
+                             const PairVec& values) const noexcept
+{
+    std::string columns, row;
+
+    for (auto const& col_value : values)
+    {
+        if (!columns.empty())
+        {
+            columns += ",";
+            row += ",";
+        }
+        columns += col_value.first;
+        row += col_value.second;
+    }
+
+    /* Objects of one type don't always write the same columns, so rows
+     * are grouped by both. */
+    auto pending = std::find_if (m_pending_inserts.begin(),
+                                 m_pending_inserts.end(),
+                                 [table_name, &columns](const PendingInserts& p)
+                                 {
+                                     return p.table == table_name &&
+                                         p.columns == columns;
+                                 });
+    if (pending == m_pending_inserts.end())
+    {
+        m_pending_inserts.push_back ({table_name, std::move (columns), "", 0});
+        pending = m_pending_inserts.end() - 1;
+    }
+    if (pending->n_rows++ > 0)
+        pending->values += ",";
+    pending->values += "(" + row + ")";
+
+    if (pending->n_rows >= MAX_PENDING_INSERT_ROWS ||
+        pending->values.size() >= MAX_PENDING_INSERT_BYTES)
+        return flush_inserts (*pending);
+    return true;
+}
+
+bool
+GncSqlBackend::flush_inserts (PendingInserts& pending) const noexcept
+{
+    if (pending.n_rows == 0)
+        return true;
+
+    auto sql = "INSERT INTO " + pending.table + "(" + pending.columns +
+        ") VALUES" + pending.values;
+    pending.values.clear();
+    pending.n_rows = 0;
+
+    auto stmt = create_statement_from_sql (sql);
+    if (stmt == nullptr)
+        return false;
+    if (m_conn->execute_nonselect_statement (stmt) == -1)
+    {
+        PERR ("SQL error: %s\n", stmt->to_sql());
+        qof_backend_set_error ((QofBackend*)this, ERR_BACKEND_SERVER_ERR);
+        return false;
+    }
+    return true;
+}
+
+bool
+GncSqlBackend::flush_pending_inserts () const noexcept
+{
+    auto is_ok = true;
+    for (auto& pending : m_pending_inserts)
+        if (!flush_inserts (pending))
+            is_ok = false;
+    return is_ok;
+}
+
 bool
 GncSqlBackend::save_commodity(gnc_commodity* comm) noexcept
 {
     if (comm == nullptr) return false;
     QofInstance* inst = QOF_INSTANCE(comm);
+    if (commodity_in_db(inst))
+        return true;
     auto obe = m_backend_registry.get_object_backend(std::string(inst->e_type));
     if (obe && !obe->instance_in_db(this, inst))
         return obe->commit(this, inst);
+    set_commodity_in_db(inst, true);
     return true;
 }
 
+static std::string
+commodity_key(const QofInstance* inst)
+{
+    auto guid = qof_instance_get_guid(inst);
+    return std::string{reinterpret_cast<const char*>(guid->reserved),
+                       GUID_DATA_SIZE};
+}
+
+void
+GncSqlBackend::set_commodity_in_db(const QofInstance* inst, bool in_db) noexcept
+{
+    if (in_db)
+        m_commodities_in_db.insert(commodity_key(inst));
+    else
+        m_commodities_in_db.erase(commodity_key(inst));
+}
+
+bool
+GncSqlBackend::commodity_in_db(const QofInstance* inst) const noexcept
+{
+    return m_commodities_in_db.count(commodity_key(inst)) != 0;
+}
+
 GncSqlStatementPtr
 GncSqlBackend::build_insert_statement (const char* table_name,
                                        QofIdTypeConst obj_name,
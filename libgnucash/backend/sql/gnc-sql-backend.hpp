@@ -32,6 +32,8 @@ extern "C"
 #include <memory>
 #include <exception>
 #include <sstream>
+#include <string>
+#include <unordered_set>
 #include <vector>
 #include <qof-backend.hpp>
 
@@ -97,6 +99,28 @@ public:
      * @param inst Object being edited
      */
     void rollback(QofInstance*) override;
+    /**
+     * Open one database transaction for a batch of commits, so that each
+     * commit only adds a savepoint to it.
+     */
+    void begin_batch() override;
+    /**
+     * Commit the database transaction opened by the outermost begin_batch.
+     *
+     * @return false if the commit failed, in which case nothing committed
+     * in the batch was saved and the book is marked dirty again.
+     */
+    bool commit_batch() override;
+    /**
+     * Group commits made within ms milliseconds of the first one into a
+     * single database transaction, committed from the main loop when the
+     * window closes. 0, the default, commits each one immediately.
+     */
+    void set_group_commit(unsigned int ms) noexcept;
+    /**
+     * Commit the open commit group, if any, now.
+     */
+    void finish_group_commit() noexcept;
     /** Connect the backend to a GncSqlConnection.
      * Sets up version info. Calling with nullptr clears the connection and
      * destroys the version info.
@@ -234,6 +258,17 @@ public:
      * @return true if the commodity needed to be saved.
      */
     bool save_commodity(gnc_commodity* comm) noexcept;
+    /**
+     * Record whether a commodity is known to have a row in the database so
+     * that save_commodity() needn't ask the database again.
+     *
+     * @param inst The commodity
+     * @param in_db true once its row is loaded or written, false if the row
+     * is deleted.
+     */
+    void set_commodity_in_db(const QofInstance* inst, bool in_db) noexcept;
+    /** @return true if the commodity is known to have a row in the database. */
+    bool commodity_in_db(const QofInstance* inst) const noexcept;
     QofBook* book() const noexcept { return m_book; }
     void set_loading(bool loading) noexcept { m_loading = loading; }
     bool pristine() const noexcept { return m_is_pristine_db; }
@@ -246,9 +281,45 @@ protected:
     bool m_loading;        /**< We are performing an initial load */
     bool m_in_query;       /**< We are processing a query */
     bool m_is_pristine_db; /**< Are we saving to a new pristine db? */
+    unsigned int m_batch_level = 0; /**< begin_batch nesting depth */
+    bool m_batch_open = false; /**< The outermost begin_batch opened a
+                                * database transaction */
+    unsigned int m_group_commit_ms = 0; /**< Commit grouping window */
+    unsigned int m_group_commit_source = 0; /**< Main loop timeout closing
+                                             * the open commit group */
     const char* m_time_format = nullptr; /**< Server-specific date-time string format */
     VersionVec m_versions;    /**< Version number for each table */
 private:
+    /** Rows held back by do_db_operation while sync fills a pristine
+     * database, sent as one multi-row INSERT per table and column list. */
+    struct PendingInserts
+    {
+        std::string table;
+        std::string columns;
+        std::string values;
+        unsigned int n_rows;
+    };
+    bool defer_insert(const char* table_name, const PairVec& values) const noexcept;
+    bool flush_inserts(PendingInserts& pending) const noexcept;
+    bool flush_pending_inserts() const noexcept;
+    bool m_defer_inserts = false;
+    mutable std::vector<PendingInserts> m_pending_inserts;
+    /** Indexes held back by create_index while sync creates the tables of a
+     * pristine database, built once the data is in. */
+    struct PendingIndex
+    {
+        std::string name;
+        std::string table;
+        EntryVec columns;
+    };
+    void create_pending_indexes() noexcept;
+    bool m_defer_indexes = false;
+    mutable std::vector<PendingIndex> m_pending_indexes;
+    /** Raw GUIDs of the commodities known to be in the database. Cleared
+     * whenever a database transaction is rolled back, since rows written in
+     * it are gone. */
+    std::unordered_set<std::string> m_commodities_in_db;
+
     bool write_account_tree(Account*);
     bool write_accounts();
     bool write_transactions();
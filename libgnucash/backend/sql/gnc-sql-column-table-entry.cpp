@@ -402,16 +402,16 @@ GncSqlColumnTableEntryImpl<CT_TIME>::load (const GncSqlBackend* sql_be,
             }
         }
     }
-    if (m_gobj_param_name != nullptr)
+    auto setter = get_setter(obj_name);
+    if (setter != nullptr)
     {
-        Time64 t64{t};
-        set_parameter(pObject, &t64, m_gobj_param_name);
+        set_parameter(pObject, t, reinterpret_cast<Time64SetterFunc>(setter),
+                      nullptr);
     }
     else
     {
-        set_parameter(pObject, t,
-                      reinterpret_cast<Time64SetterFunc>(get_setter(obj_name)),
-                      nullptr);
+        Time64 t64{t};
+        set_parameter(pObject, &t64, m_gobj_param_name);
     }
 }
 
@@ -313,6 +313,22 @@ gnc_sql_make_table_entry(const char* name, unsigned int s, int f,
         name, Type, s, f, nullptr, nullptr, get, set);
 }
 
+/**
+ * A column read from the object through its GObject property but loaded with
+ * a setter. set is called with the loaded value the way the column type's load
+ * passes it, so the object's own typed setter can usually be cast to
+ * QofSetterFunc; loading then avoids g_object_set's property lookup and GValue
+ * boxing for every row.
+ */
+template <GncSqlObjectType Type>
+std::shared_ptr<GncSqlColumnTableEntryImpl<Type>>
+gnc_sql_make_table_entry(const char* name, unsigned int s, int f,
+                         const char* param, QofSetterFunc set)
+{
+    return std::make_shared<GncSqlColumnTableEntryImpl<Type>>(
+        name, Type, s, f, param, nullptr, nullptr, set);
+}
+
 
 template <typename T> T
 GncSqlColumnTableEntry::get_row_value_from_object(QofIdTypeConst obj_name,
@@ -559,18 +575,19 @@ void set_parameter(T object, P item, const char* property)
 };
 
 /**
- * Set an object property with either a g_object_set or a setter.
+ * Set an object property with either a setter or a g_object_set.
  *
- * See previous templates for the parameter meanings. This is clunky but fits in
- * the current architecture for refactoring.
+ * See previous templates for the parameter meanings. The setter is preferred
+ * when the column has both. This is clunky but fits in the current
+ * architecture for refactoring.
  */
 template <typename T, typename P, typename F>
 void set_parameter(T object, P item, F setter, const char* property)
 {
-    if (property)
-        set_parameter(object, item, property);
-    else
+    if (setter)
         set_parameter(object, item, setter);
+    else
+        set_parameter(object, item, property);
 }
 
 #endif //__GNC_SQL_COLUMN_TABLE_ENTRY_HPP__
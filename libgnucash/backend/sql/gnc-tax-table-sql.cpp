@@ -92,7 +92,7 @@ static EntryVec tt_parent_col_table
 });
 
 #define TTENTRIES_TABLE_NAME "taxtable_entries"
-#define TTENTRIES_TABLE_VERSION 3
+#define TTENTRIES_TABLE_VERSION 4
 
 static EntryVec ttentries_col_table
 ({
@@ -260,7 +260,6 @@ load_single_taxtable (GncSqlBackend* sql_be, GncSqlRow& row,
         tt = gncTaxTableCreate (sql_be->book());
     }
     gnc_sql_load_object (sql_be, row, GNC_ID_TAXTABLE, tt, tt_col_table);
-    gnc_sql_slots_load (sql_be, QOF_INSTANCE (tt));
     load_taxtable_entries (sql_be, tt);
 
     /* If the tax table doesn't have a parent, it might be because it hasn't
@@ -283,6 +282,13 @@ load_single_taxtable (GncSqlBackend* sql_be, GncSqlRow& row,
     qof_instance_mark_clean (QOF_INSTANCE (tt));
 }
 
+/* Because gncTaxTableLookup has the arguments backwards: */
+static inline GncTaxTable*
+gnc_taxtable_lookup (const GncGUID *guid, const QofBook *book)
+{
+     QOF_BOOK_RETURN_ENTITY(book, guid, GNC_ID_TAXTABLE, GncTaxTable);
+}
+
 void
 GncSqlTaxTableBackend::load_all (GncSqlBackend* sql_be)
 {
@@ -297,6 +303,11 @@ GncSqlTaxTableBackend::load_all (GncSqlBackend* sql_be)
 
     for (auto row : *result)
         load_single_taxtable (sql_be, row, tt_needing_parents);
+    delete result;
+    std::string pkey(tt_col_table[0]->name());
+    std::string subquery("SELECT DISTINCT " + pkey + " FROM " TT_TABLE_NAME);
+    gnc_sql_slots_load_for_sql_subquery (sql_be, subquery,
+                                         (BookLookupFn)gnc_taxtable_lookup);
 
     /* While there are items on the list of taxtables needing parents,
        try to see if the parent has now been loaded.  Theory says that if
@@ -359,11 +370,21 @@ GncSqlTaxTableBackend::create_tables (GncSqlBackend* sql_be)
     {
         sql_be->create_table(TTENTRIES_TABLE_NAME, TTENTRIES_TABLE_VERSION,
                               ttentries_col_table);
+        if (!sql_be->create_index ("taxtable_entries_taxtable_index",
+                                   TTENTRIES_TABLE_NAME, guid_col_table))
+            PERR ("Unable to create index\n");
     }
     else if (version < TTENTRIES_TABLE_VERSION)
     {
-        /* Upgrade 64 bit int handling */
-        sql_be->upgrade_table(TTENTRIES_TABLE_NAME, ttentries_col_table);
+        /* Upgrade:
+            1->3: 64 bit int handling
+            3->4: Add index on taxtable
+        */
+        if (version < 3)
+            sql_be->upgrade_table(TTENTRIES_TABLE_NAME, ttentries_col_table);
+        if (!sql_be->create_index ("taxtable_entries_taxtable_index",
+                                   TTENTRIES_TABLE_NAME, guid_col_table))
+            PERR ("Unable to create index\n");
         sql_be->set_table_version (TTENTRIES_TABLE_NAME, TTENTRIES_TABLE_VERSION);
         PINFO ("Taxtable entries table upgraded from version 1 to version %d\n",
                TTENTRIES_TABLE_VERSION);
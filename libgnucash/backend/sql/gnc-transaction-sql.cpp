@@ -84,16 +84,25 @@ struct split_info_t : public write_objects_t
 #define TX_MAX_NUM_LEN 2048
 #define TX_MAX_DESCRIPTION_LEN 2048
 
+/* The columns are saved through the objects' properties but loaded with their
+ * setters, which saves a property lookup and a GValue for every column of
+ * every row. */
 static const EntryVec tx_col_table
 {
-    gnc_sql_make_table_entry<CT_GUID>("guid", 0, COL_NNUL | COL_PKEY, "guid"),
+    gnc_sql_make_table_entry<CT_GUID>("guid", 0, COL_NNUL | COL_PKEY, "guid",
+                                      (QofSetterFunc)qof_instance_set_guid),
     gnc_sql_make_table_entry<CT_COMMODITYREF>("currency_guid", 0, COL_NNUL,
-                                              "currency"),
-    gnc_sql_make_table_entry<CT_STRING>("num", TX_MAX_NUM_LEN, COL_NNUL, "num"),
-    gnc_sql_make_table_entry<CT_TIME>("post_date", 0, 0, "post-date"),
-    gnc_sql_make_table_entry<CT_TIME>("enter_date", 0, 0, "enter-date"),
+                                              "currency",
+                                              (QofSetterFunc)xaccTransSetCurrency),
+    gnc_sql_make_table_entry<CT_STRING>("num", TX_MAX_NUM_LEN, COL_NNUL, "num",
+                                        (QofSetterFunc)xaccTransSetNum),
+    gnc_sql_make_table_entry<CT_TIME>("post_date", 0, 0, "post-date",
+                                      (QofSetterFunc)xaccTransSetDatePostedSecs),
+    gnc_sql_make_table_entry<CT_TIME>("enter_date", 0, 0, "enter-date",
+                                      (QofSetterFunc)xaccTransSetDateEnteredSecs),
     gnc_sql_make_table_entry<CT_STRING>("description", TX_MAX_DESCRIPTION_LEN,
-                                        0, "description"),
+                                        0, "description",
+                                        (QofSetterFunc)xaccTransSetDescription),
 };
 
 static  gpointer get_split_reconcile_state (gpointer pObject);
@@ -105,21 +114,28 @@ static void set_split_lot (gpointer pObject,  gpointer pLot);
 
 static const EntryVec split_col_table
 {
-    gnc_sql_make_table_entry<CT_GUID>("guid", 0, COL_NNUL | COL_PKEY, "guid"),
-    gnc_sql_make_table_entry<CT_TXREF>("tx_guid", 0, COL_NNUL, "transaction"),
+    gnc_sql_make_table_entry<CT_GUID>("guid", 0, COL_NNUL | COL_PKEY, "guid",
+                                      (QofSetterFunc)qof_instance_set_guid),
+    gnc_sql_make_table_entry<CT_TXREF>("tx_guid", 0, COL_NNUL, "transaction",
+                                       (QofSetterFunc)xaccSplitSetParent),
     gnc_sql_make_table_entry<CT_ACCOUNTREF>("account_guid", 0, COL_NNUL,
-                                            "account"),
+                                            "account",
+                                            (QofSetterFunc)xaccSplitSetAccount),
     gnc_sql_make_table_entry<CT_STRING>("memo", SPLIT_MAX_MEMO_LEN, COL_NNUL,
-                                        "memo"),
+                                        "memo", (QofSetterFunc)xaccSplitSetMemo),
     gnc_sql_make_table_entry<CT_STRING>("action", SPLIT_MAX_ACTION_LEN,
-                                        COL_NNUL, "action"),
+                                        COL_NNUL, "action",
+                                        (QofSetterFunc)xaccSplitSetAction),
     gnc_sql_make_table_entry<CT_STRING>("reconcile_state", 1, COL_NNUL,
                                        (QofAccessFunc)get_split_reconcile_state,
                                         set_split_reconcile_state),
     gnc_sql_make_table_entry<CT_TIME>("reconcile_date", 0, 0,
-                                          "reconcile-date"),
-    gnc_sql_make_table_entry<CT_NUMERIC>("value", 0, COL_NNUL, "value"),
-    gnc_sql_make_table_entry<CT_NUMERIC>("quantity", 0, COL_NNUL, "amount"),
+                                      "reconcile-date",
+                                      (QofSetterFunc)xaccSplitSetDateReconciledSecs),
+    gnc_sql_make_table_entry<CT_NUMERIC>("value", 0, COL_NNUL, "value",
+                                         (QofSetterFunc)xaccSplitSetValue),
+    gnc_sql_make_table_entry<CT_NUMERIC>("quantity", 0, COL_NNUL, "amount",
+                                         (QofSetterFunc)xaccSplitSetAmount),
     gnc_sql_make_table_entry<CT_LOTREF>("lot_guid", 0, 0,
                                         (QofAccessFunc)xaccSplitGetLot,
                                         set_split_lot),
@@ -323,6 +339,85 @@ typedef struct
     gnc_numeric end_reconciled_bal;
 } full_acct_balances_t;
 
+/* When the whole book is loaded the transactions are read this many at a time,
+ * so only one page of rows is held in memory at once. */
+static const unsigned int TX_LOAD_PAGE_SIZE = 10000;
+
+/**
+ * Loads the splits and slots of a page of transactions and commits them.
+ *
+ * @param sql_be SQL backend
+ * @param selector Parenthesized subquery selecting the page's guids
+ * @param instances The transactions loaded from the page
+ */
+static void
+finish_tx_page (GncSqlBackend* sql_be, const std::string& selector,
+                const InstanceVec& instances)
+{
+    load_splits_for_transactions (sql_be, selector);
+    gnc_sql_slots_load_for_sql_subquery (sql_be, selector,
+                                         (BookLookupFn)xaccTransLookup);
+    for (auto instance : instances)
+         xaccTransCommitEdit(GNC_TRANSACTION(instance));
+}
+
+/**
+ * Loads every transaction in pages ordered by guid, each page starting after
+ * the last guid of the one before, so that neither the transaction rows nor
+ * the split rows of the whole book are pulled into memory at once.
+ *
+ * @param sql_be SQL backend
+ */
+static void
+query_all_transactions (GncSqlBackend* sql_be)
+{
+    const std::string tpkey(tx_col_table[0]->name());
+    std::string last;
+
+    while (true)
+    {
+        std::string sql("SELECT * FROM " TRANSACTION_TABLE);
+        if (!last.empty())
+            sql += " WHERE " + tpkey + " > '" + last + "'";
+        sql += " ORDER BY " + tpkey + " LIMIT " +
+            std::to_string (TX_LOAD_PAGE_SIZE);
+        auto stmt = sql_be->create_statement_from_sql(sql);
+        if (stmt == nullptr)
+            return;
+        auto result = sql_be->execute_select_statement(stmt);
+        if (result == nullptr)
+            return;
+
+        std::string first;
+        unsigned int n_rows = 0;
+        InstanceVec instances;
+        instances.reserve(result->size());
+        for (auto row : *result)
+        {
+            last = row.get_string_at_col (tpkey.c_str());
+            if (n_rows++ == 0)
+                first = last;
+            auto tx = load_single_tx (sql_be, row);
+            if (tx != nullptr)
+            {
+                xaccTransScrubPostedDate (tx);
+                instances.push_back(QOF_INSTANCE(tx));
+            }
+        }
+        delete result;
+
+        if (!instances.empty())
+        {
+            std::string selector("(SELECT " + tpkey + " FROM " TRANSACTION_TABLE
+                                 " WHERE " + tpkey + " >= '" + first + "' AND " +
+                                 tpkey + " <= '" + last + "')");
+            finish_tx_page (sql_be, selector, instances);
+        }
+        if (n_rows < TX_LOAD_PAGE_SIZE)
+            break;
+    }
+}
+
 /**
  * Executes a transaction query statement and loads the transactions and all
  * of the splits.
@@ -335,6 +430,12 @@ query_transactions (GncSqlBackend* sql_be, std::string selector)
 {
     g_return_if_fail (sql_be != NULL);
 
+    if (selector.empty())
+    {
+        query_all_transactions (sql_be);
+        return;
+    }
+
     const std::string tpkey(tx_col_table[0]->name());
     std::string sql("SELECT * FROM " TRANSACTION_TABLE);
 
@@ -705,6 +806,19 @@ void gnc_sql_transaction_load_tx_for_account (GncSqlBackend* sql_be,
     query_transactions (sql_be, sql);
 }
 
+void gnc_sql_transaction_load_tx_for_accounts (GncSqlBackend* sql_be,
+                                               const std::string& subquery)
+{
+    g_return_if_fail (sql_be != NULL);
+
+    const std::string stkey(split_col_table[1]->name()); //txn_guid
+    const std::string sakey(split_col_table[2]->name()); //account_guid
+    std::string sql("(SELECT DISTINCT ");
+    sql += stkey + " FROM " SPLIT_TABLE " WHERE " + sakey + " IN (";
+    sql += subquery + "))";
+    query_transactions (sql_be, sql);
+}
+
 /**
  * Loads all transactions.  This might be used during a save-as operation to ensure that
  * all data is in memory and ready to be saved.
@@ -719,7 +833,14 @@ GncSqlTransBackend::load_all (GncSqlBackend* sql_be)
     auto root = gnc_book_get_root_account (sql_be->book());
     gnc_account_foreach_descendant(root, (AccountCb)xaccAccountBeginEdit,
                                    nullptr);
+    gnc_account_foreach_descendant(root,
+                                   (AccountCb)gnc_account_begin_bulk_insert,
+                                   nullptr);
     query_transactions (sql_be, "");
+    gnc_account_tree_bring_up_to_date (root);
+    gnc_account_foreach_descendant(root,
+                                   (AccountCb)gnc_account_end_bulk_insert,
+                                   nullptr);
     gnc_account_foreach_descendant(root, (AccountCb)xaccAccountCommitEdit,
                                    nullptr);
 }
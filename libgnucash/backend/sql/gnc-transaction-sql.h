@@ -35,6 +35,8 @@ extern "C"
 #include "qof.h"
 #include "Account.h"
 }
+#include <string>
+
 class GncSqlTransBackend : public GncSqlObjectBackend
 {
 public:
@@ -61,6 +63,16 @@ public:
  */
 void gnc_sql_transaction_load_tx_for_account (GncSqlBackend* sql_be,
                                               Account* account);
+/**
+ * Loads all transactions which have splits for any of a set of accounts in a
+ * single query.
+ *
+ * @param sql_be SQL backend
+ * @param subquery Subquery of the form "SELECT guid FROM ..." selecting the
+ * account guids.
+ */
+void gnc_sql_transaction_load_tx_for_accounts (GncSqlBackend* sql_be,
+                                               const std::string& subquery);
 typedef struct
 {
     Account* acct;
@@ -49,6 +49,11 @@ extern "C"
 
 #include "sixtp-dom-parsers.h"
 
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
 const gchar* transaction_version_string = "2.0.0";
 
 static void
@@ -193,6 +198,82 @@ gnc_transaction_dom_tree_create (Transaction* trn)
     return ret;
 }
 
+static void
+split_to_xml_stream (GncXmlWriter& writer, const gchar* tag, Split* spl)
+{
+    writer.start_element (tag);
+
+    guid_to_xml_stream (writer, "split:id", xaccSplitGetGUID (spl));
+
+    auto memo = xaccSplitGetMemo (spl);
+    if (memo && *memo)
+        writer.text_element ("split:memo", memo);
+
+    auto action = xaccSplitGetAction (spl);
+    if (action && *action)
+        writer.text_element ("split:action", action);
+
+    char tmp[2] = { xaccSplitGetReconcile (spl), '\0' };
+    writer.text_element ("split:reconciled-state", tmp);
+
+    auto reconciled = xaccSplitGetDateReconciled (spl);
+    if (reconciled)
+        time64_to_xml_stream (writer, "split:reconcile-date", reconciled);
+
+    auto value = xaccSplitGetValue (spl);
+    gnc_numeric_to_xml_stream (writer, "split:value", &value);
+
+    auto amount = xaccSplitGetAmount (spl);
+    gnc_numeric_to_xml_stream (writer, "split:quantity", &amount);
+
+    guid_to_xml_stream (writer, "split:account",
+                        xaccAccountGetGUID (xaccSplitGetAccount (spl)));
+
+    if (auto lot = xaccSplitGetLot (spl))
+        guid_to_xml_stream (writer, "split:lot", gnc_lot_get_guid (lot));
+
+    qof_instance_slots_to_xml_stream (writer, "split:slots",
+                                      QOF_INSTANCE (spl));
+    writer.end_element ();
+}
+
+/* Writes the same bytes as xmlElemDump of gnc_transaction_dom_tree_create
+ * without building the tree, which is most of the cost of saving a large
+ * book. */
+void
+gnc_transaction_xml_stream (GncXmlWriter& writer, Transaction* trn)
+{
+    writer.start_element ("gnc:transaction");
+    writer.attribute ("version", transaction_version_string);
+
+    guid_to_xml_stream (writer, "trn:id", xaccTransGetGUID (trn));
+
+    commodity_ref_to_xml_stream (writer, "trn:currency",
+                                 xaccTransGetCurrency (trn));
+
+    auto num = xaccTransGetNum (trn);
+    if (num && *num)
+        writer.text_element ("trn:num", num);
+
+    time64_to_xml_stream (writer, "trn:date-posted",
+                          xaccTransRetDatePosted (trn));
+    time64_to_xml_stream (writer, "trn:date-entered",
+                          xaccTransRetDateEntered (trn));
+
+    if (auto description = xaccTransGetDescription (trn))
+        writer.text_element ("trn:description", description);
+
+    qof_instance_slots_to_xml_stream (writer, "trn:slots",
+                                      QOF_INSTANCE (trn));
+
+    writer.start_element ("trn:splits");
+    for (auto n = xaccTransGetSplitList (trn); n; n = n->next)
+        split_to_xml_stream (writer, "trn:split", static_cast<Split*> (n->data));
+    writer.end_element ();
+
+    writer.end_element ();
+}
+
 /***********************************************************************/
 
 struct split_pdata
@@ -573,77 +654,618 @@ struct dom_tree_handler trn_dom_handlers[] =
     { NULL, NULL, 0, 0 },
 };
 
-static gboolean
-gnc_transaction_end_handler (gpointer data_for_children,
-                             GSList* data_from_children, GSList* sibling_data,
-                             gpointer parent_data, gpointer global_data,
-                             gpointer* result, const gchar* tag)
+Transaction*
+dom_tree_to_transaction (xmlNodePtr node, QofBook* book)
 {
-    Transaction* trn = NULL;
-    xmlNodePtr tree = (xmlNodePtr)data_for_children;
-    gxpf_data* gdata = (gxpf_data*)global_data;
+    Transaction* trn;
+    gboolean successful;
+    struct trans_pdata pdata;
 
-    if (parent_data)
+    g_return_val_if_fail (node, NULL);
+    g_return_val_if_fail (book, NULL);
+
+    trn = xaccMallocTransaction (book);
+    g_return_val_if_fail (trn, NULL);
+    xaccTransBeginEdit (trn);
+
+    pdata.trans = trn;
+    pdata.book = book;
+
+    successful = dom_tree_generic_parse (node, trn_dom_handlers, &pdata);
+
+    xaccTransCommitEdit (trn);
+
+    if (!successful)
+    {
+        xmlElemDump (stdout, NULL, node);
+        xaccTransBeginEdit (trn);
+        xaccTransDestroy (trn);
+        xaccTransCommitEdit (trn);
+        trn = NULL;
+    }
+
+    return trn;
+}
+
+/***********************************************************************/
+/* Direct SAX parsing.
+ *
+ * Loading used to build a DOM subtree for every <gnc:transaction> and then
+ * walk it with dom_tree_generic_parse.  The parser below builds the
+ * transaction and its splits straight from the SAX events instead, keeping
+ * only the text of the element being read.  The slot frames are the one
+ * exception: they nest arbitrarily, so their subtree is still collected as
+ * DOM and handed to dom_tree_create_instance_slots.  The results, the
+ * required-tag checks and the diagnostics follow the DOM handlers above,
+ * which remain in use for the template transactions.
+ */
+
+enum class TrnTag
+{
+    UNKNOWN,
+    TRANSACTION,
+    ID, CURRENCY, NUM, DATE_POSTED, DATE_ENTERED, DESCRIPTION, SLOTS, SPLITS,
+    SPLIT,
+    SPLIT_ID, SPLIT_MEMO, SPLIT_ACTION, SPLIT_RECONCILED_STATE,
+    SPLIT_RECONCILE_DATE, SPLIT_VALUE, SPLIT_QUANTITY, SPLIT_ACCOUNT,
+    SPLIT_LOT, SPLIT_SLOTS,
+    TS_DATE, CMDTY_SPACE, CMDTY_ID,
+};
+
+static TrnTag
+trn_tag_lookup (const char* tag)
+{
+    static const std::unordered_map<std::string_view, TrnTag> tags
+    {
+        { "gnc:transaction", TrnTag::TRANSACTION },
+        { "trn:id", TrnTag::ID },
+        { "trn:currency", TrnTag::CURRENCY },
+        { "trn:num", TrnTag::NUM },
+        { "trn:date-posted", TrnTag::DATE_POSTED },
+        { "trn:date-entered", TrnTag::DATE_ENTERED },
+        { "trn:description", TrnTag::DESCRIPTION },
+        { "trn:slots", TrnTag::SLOTS },
+        { "trn:splits", TrnTag::SPLITS },
+        { "trn:split", TrnTag::SPLIT },
+        { "split:id", TrnTag::SPLIT_ID },
+        { "split:memo", TrnTag::SPLIT_MEMO },
+        { "split:action", TrnTag::SPLIT_ACTION },
+        { "split:reconciled-state", TrnTag::SPLIT_RECONCILED_STATE },
+        { "split:reconcile-date", TrnTag::SPLIT_RECONCILE_DATE },
+        { "split:value", TrnTag::SPLIT_VALUE },
+        { "split:quantity", TrnTag::SPLIT_QUANTITY },
+        { "split:account", TrnTag::SPLIT_ACCOUNT },
+        { "split:lot", TrnTag::SPLIT_LOT },
+        { "split:slots", TrnTag::SPLIT_SLOTS },
+        { "ts:date", TrnTag::TS_DATE },
+        { "cmdty:space", TrnTag::CMDTY_SPACE },
+        { "cmdty:id", TrnTag::CMDTY_ID },
+    };
+    auto iter = tags.find (tag);
+    return iter == tags.end () ? TrnTag::UNKNOWN : iter->second;
+}
+
+/* The tags dom_tree_generic_parse insists on, as bits. */
+static constexpr guint trn_required = 1 << static_cast<int>(TrnTag::ID) |
+    1 << static_cast<int>(TrnTag::DATE_POSTED) |
+    1 << static_cast<int>(TrnTag::DATE_ENTERED) |
+    1 << static_cast<int>(TrnTag::SPLITS);
+static constexpr guint spl_required = 1 << static_cast<int>(TrnTag::SPLIT_ID) |
+    1 << static_cast<int>(TrnTag::SPLIT_RECONCILED_STATE) |
+    1 << static_cast<int>(TrnTag::SPLIT_VALUE) |
+    1 << static_cast<int>(TrnTag::SPLIT_QUANTITY) |
+    1 << static_cast<int>(TrnTag::SPLIT_ACCOUNT);
+
+struct trn_sax_frame
+{
+    TrnTag tag;
+    std::string text;
+    gboolean guid_type_ok;
+};
+
+struct trn_sax_state
+{
+    QofBook* book;
+    Transaction* trn;
+    Split* split;
+    std::vector<trn_sax_frame> stack;
+    guint trn_gotten;
+    guint spl_gotten;
+    gboolean ok;
+    /* A split failed to parse; like trn_splits_handler, take no more. */
+    gboolean splits_done;
+    /* The date or commodity reference being assembled. */
+    time64 time;
+    int n_dates;
+    std::string cmdty_space, cmdty_id;
+    int n_cmdty_space, n_cmdty_id;
+    /* The slots subtree being collected, and the node to add to. */
+    xmlNodePtr slots;
+    xmlNodePtr slots_cursor;
+};
+
+/* dom_tree_to_guid wants exactly a type="guid" or type="new" attribute. */
+static gboolean
+sax_guid_type_ok (gchar** attrs)
+{
+    if (!attrs || !attrs[0])
+        return FALSE;
+    if (strcmp (attrs[0], "type") != 0)
     {
+        PERR ("Unknown attribute for id tag: %s", attrs[0]);
+        return FALSE;
+    }
+    if (g_strcmp0 ("guid", attrs[1]) == 0 || g_strcmp0 ("new", attrs[1]) == 0)
         return TRUE;
+    PERR ("Unknown type %s for attribute type for tag %s",
+          attrs[1] ? attrs[1] : "(null)", attrs[0]);
+    return FALSE;
+}
+
+static gboolean
+sax_frame_guid (trn_sax_frame& frame, GncGUID* guid)
+{
+    if (!frame.guid_type_ok)
+        return FALSE;
+    *guid = guid_new_return ();
+    string_to_guid (frame.text.c_str (), guid);
+    return TRUE;
+}
+
+static gnc_numeric
+sax_frame_numeric (trn_sax_frame& frame)
+{
+    gnc_numeric num;
+    if (!string_to_gnc_numeric (frame.text.c_str (), &num))
+        num = gnc_numeric_zero ();
+    return num;
+}
+
+static time64
+sax_state_time (trn_sax_state* state, const char* tag)
+{
+    auto time = state->time;
+    if (state->n_dates == 0)
+        PERR ("no ts:date node found.");
+    if (state->n_dates != 1)
+        time = INT64_MAX;
+    if (!dom_tree_valid_time64 (time, BAD_CAST tag))
+        time = 0;
+    return time;
+}
+
+static gnc_commodity*
+sax_state_commodity (trn_sax_state* state)
+{
+    if (state->n_cmdty_space != 1 || state->n_cmdty_id != 1)
+        return NULL;
+    auto space = g_strstrip (&state->cmdty_space[0]);
+    auto id = g_strstrip (&state->cmdty_id[0]);
+    return gnc_commodity_table_lookup (gnc_commodity_table_get_table (state->book),
+                                       space, id);
+}
+
+static void
+sax_split_account (trn_sax_state* state, const GncGUID* id)
+{
+    auto account = xaccAccountLookup (id, state->book);
+    if (!account && gnc_transaction_xml_v2_testing &&
+        !guid_equal (id, guid_null ()))
+    {
+        account = xaccMallocAccount (state->book);
+        xaccAccountSetGUID (account, id);
+        xaccAccountSetCommoditySCU (account,
+                                    xaccSplitGetAmount (state->split).denom);
+    }
+    xaccAccountInsertSplit (account, state->split);
+}
+
+static void
+sax_split_lot (trn_sax_state* state, const GncGUID* id)
+{
+    auto lot = gnc_lot_lookup (id, state->book);
+    if (!lot && gnc_transaction_xml_v2_testing &&
+        !guid_equal (id, guid_null ()))
+    {
+        lot = gnc_lot_new (state->book);
+        gnc_lot_set_guid (lot, *id);
+    }
+    gnc_lot_add_split (lot, state->split);
+}
+
+static void
+sax_state_free (trn_sax_state* state)
+{
+    if (state->split)
+        xaccSplitDestroy (state->split);
+    if (state->slots)
+        xmlFreeNode (state->slots);
+    if (state->trn)
+    {
+        xaccTransDestroy (state->trn);
+        xaccTransCommitEdit (state->trn);
+    }
+    delete state;
+}
+
+static void
+sax_slots_start (trn_sax_state* state, const gchar* tag, gchar** attrs)
+{
+    xmlNodePtr node;
+    if (state->slots)
+        node = xmlNewChild (state->slots_cursor, NULL, BAD_CAST tag, NULL);
+    else
+        node = state->slots = xmlNewNode (NULL, BAD_CAST tag);
+    for (auto atptr = attrs; atptr && *atptr; atptr += 2)
+    {
+        gchar* attr0 = g_strdup (atptr[0]);
+        gchar* attr1 = g_strdup (atptr[1]);
+        xmlSetProp (node, checked_char_cast (attr0), checked_char_cast (attr1));
+        g_free (attr0);
+        g_free (attr1);
     }
+    state->slots_cursor = node;
+}
+
+/* Which element a new child of parent is, given where it may appear. */
+static TrnTag
+sax_child_tag (TrnTag parent, TrnTag tag)
+{
+    switch (parent)
+    {
+    case TrnTag::TRANSACTION:
+        return tag >= TrnTag::ID && tag <= TrnTag::SPLITS ? tag : TrnTag::UNKNOWN;
+    case TrnTag::SPLITS:
+        return tag == TrnTag::SPLIT ? tag : TrnTag::UNKNOWN;
+    case TrnTag::SPLIT:
+        return tag >= TrnTag::SPLIT_ID && tag <= TrnTag::SPLIT_SLOTS ?
+               tag : TrnTag::UNKNOWN;
+    case TrnTag::DATE_POSTED:
+    case TrnTag::DATE_ENTERED:
+    case TrnTag::SPLIT_RECONCILE_DATE:
+        return tag == TrnTag::TS_DATE ? tag : TrnTag::UNKNOWN;
+    case TrnTag::CURRENCY:
+        return tag == TrnTag::CMDTY_SPACE || tag == TrnTag::CMDTY_ID ?
+               tag : TrnTag::UNKNOWN;
+    default:
+        return TrnTag::UNKNOWN;
+    }
+}
+
+static gboolean
+trn_sax_start_handler (GSList* sibling_data, gpointer parent_data,
+                       gpointer global_data, gpointer* data_for_children,
+                       gpointer* result, const gchar* tag, gchar** attrs)
+{
+    auto gdata = static_cast<gxpf_data*> (global_data);
+    auto state = static_cast<trn_sax_state*> (parent_data);
 
-    /* OK.  For some messed up reason this is getting called again with a
-       NULL tag.  So we ignore those cases */
+    /* As the top parser we're started for the document itself. */
     if (!tag)
     {
+        *data_for_children = NULL;
+        *result = NULL;
         return TRUE;
     }
 
-    g_return_val_if_fail (tree, FALSE);
+    if (!state)
+    {
+        state = new trn_sax_state {};
+        state->book = static_cast<QofBook*> (gdata->bookdata);
+        state->ok = TRUE;
+        state->stack.reserve (8);
+        state->trn = xaccMallocTransaction (state->book);
+        xaccTransBeginEdit (state->trn);
+        state->stack.push_back ({TrnTag::TRANSACTION, std::string (), FALSE});
+        *data_for_children = state;
+        /* Only the top frame owns the state; see trn_sax_fail_handler. */
+        *result = state;
+        return TRUE;
+    }
+
+    *data_for_children = state;
+    *result = NULL;
 
-    trn = dom_tree_to_transaction (tree,
-                                   static_cast<QofBook*> (gdata->bookdata));
-    if (trn != NULL)
+    if (state->slots)
     {
-        gdata->cb (tag, gdata->parsedata, trn);
+        sax_slots_start (state, tag, attrs);
+        state->stack.push_back ({TrnTag::UNKNOWN, std::string (), FALSE});
+        return TRUE;
     }
 
-    xmlFreeNode (tree);
+    auto parent = state->stack.back ().tag;
+    auto child = sax_child_tag (parent, trn_tag_lookup (tag));
+    if (child == TrnTag::UNKNOWN &&
+        (parent == TrnTag::TRANSACTION || parent == TrnTag::SPLIT))
+    {
+        PERR ("Unhandled tag: %s", tag ? tag : "(null)");
+        PERR ("gnc_xml_set_data failed");
+        if (parent == TrnTag::TRANSACTION)
+            state->ok = FALSE;
+        else
+            state->splits_done = TRUE;
+    }
+    if (parent == TrnTag::SPLITS && child == TrnTag::UNKNOWN)
+        state->splits_done = TRUE;
 
-    return trn != NULL;
+    switch (child)
+    {
+    case TrnTag::SLOTS:
+    case TrnTag::SPLIT_SLOTS:
+        sax_slots_start (state, tag, attrs);
+        break;
+    case TrnTag::SPLIT:
+        if (!state->splits_done)
+            state->split = xaccMallocSplit (state->book);
+        state->spl_gotten = 0;
+        break;
+    case TrnTag::DATE_POSTED:
+    case TrnTag::DATE_ENTERED:
+    case TrnTag::SPLIT_RECONCILE_DATE:
+        state->time = INT64_MAX;
+        state->n_dates = 0;
+        break;
+    case TrnTag::CURRENCY:
+        state->n_cmdty_space = state->n_cmdty_id = 0;
+        break;
+    default:
+        break;
+    }
+    gboolean guid_ok = (child == TrnTag::ID || child == TrnTag::SPLIT_ID ||
+                        child == TrnTag::SPLIT_ACCOUNT ||
+                        child == TrnTag::SPLIT_LOT) && sax_guid_type_ok (attrs);
+    state->stack.push_back ({child, std::string (), guid_ok});
+    return TRUE;
 }
 
-Transaction*
-dom_tree_to_transaction (xmlNodePtr node, QofBook* book)
+static gboolean
+trn_sax_characters_handler (GSList* sibling_data, gpointer parent_data,
+                            gpointer global_data, gpointer* result,
+                            const char* text, int length)
 {
-    Transaction* trn;
-    gboolean successful;
-    struct trans_pdata pdata;
+    auto state = static_cast<trn_sax_state*> (parent_data);
 
-    g_return_val_if_fail (node, NULL);
-    g_return_val_if_fail (book, NULL);
+    if (!state || length <= 0)
+        return TRUE;
+    if (state->slots)
+    {
+        gchar* newtext = g_strndup (text, length);
+        xmlNodeAddContentLen (state->slots_cursor, checked_char_cast (newtext),
+                              length);
+        g_free (newtext);
+    }
+    else
+    {
+        /* Only leaves have text worth keeping; the rest is indentation. */
+        auto& frame = state->stack.back ();
+        switch (frame.tag)
+        {
+        case TrnTag::TRANSACTION:
+        case TrnTag::SPLITS:
+        case TrnTag::SPLIT:
+        case TrnTag::UNKNOWN:
+            break;
+        default:
+            frame.text.append (text, length);
+        }
+    }
+    return TRUE;
+}
 
-    trn = xaccMallocTransaction (book);
-    g_return_val_if_fail (trn, NULL);
-    xaccTransBeginEdit (trn);
+/* Handle the end of a child of the transaction or of a split, once its
+ * text and children are complete. */
+static void
+sax_end_child (trn_sax_state* state, trn_sax_frame& frame, const gchar* tag)
+{
+    auto trn = state->trn;
+    auto spl = state->split;
+    GncGUID guid;
 
-    pdata.trans = trn;
-    pdata.book = book;
+    checked_char_cast (&frame.text[0]);
+    switch (frame.tag)
+    {
+    case TrnTag::ID:
+        if (sax_frame_guid (frame, &guid))
+            xaccTransSetGUID (trn, &guid);
+        else
+            PERR ("bad guid in %s", tag);
+        break;
+    case TrnTag::CURRENCY:
+        if (auto currency = sax_state_commodity (state))
+            xaccTransSetCurrency (trn, currency);
+        else
+            PERR ("unknown commodity in %s", tag);
+        break;
+    case TrnTag::NUM:
+        xaccTransSetNum (trn, frame.text.c_str ());
+        break;
+    case TrnTag::DATE_POSTED:
+        xaccTransSetDatePostedSecs (trn, sax_state_time (state, tag));
+        break;
+    case TrnTag::DATE_ENTERED:
+        xaccTransSetDateEnteredSecs (trn, sax_state_time (state, tag));
+        break;
+    case TrnTag::DESCRIPTION:
+        xaccTransSetDescription (trn, frame.text.c_str ());
+        break;
+    case TrnTag::SLOTS:
+        if (!dom_tree_create_instance_slots (state->slots, QOF_INSTANCE (trn)))
+            PERR ("bad slots in %s", tag);
+        break;
+    case TrnTag::SPLIT:
+        if (!spl)
+            break;
+        state->split = NULL;
+        if ((state->spl_gotten & spl_required) == spl_required &&
+            !state->splits_done)
+        {
+            xaccTransAppendSplit (trn, spl);
+        }
+        else
+        {
+            PERR ("didn't find all of the expected tags in the input");
+            xaccSplitDestroy (spl);
+            state->splits_done = TRUE;
+        }
+        break;
+    case TrnTag::SPLIT_ID:
+        if (sax_frame_guid (frame, &guid))
+            xaccSplitSetGUID (spl, &guid);
+        break;
+    case TrnTag::SPLIT_MEMO:
+        xaccSplitSetMemo (spl, frame.text.c_str ());
+        break;
+    case TrnTag::SPLIT_ACTION:
+        xaccSplitSetAction (spl, frame.text.c_str ());
+        break;
+    case TrnTag::SPLIT_RECONCILED_STATE:
+        xaccSplitSetReconcile (spl, frame.text[0]);
+        break;
+    case TrnTag::SPLIT_RECONCILE_DATE:
+        xaccSplitSetDateReconciledSecs (spl, sax_state_time (state, tag));
+        break;
+    case TrnTag::SPLIT_VALUE:
+        xaccSplitSetValue (spl, sax_frame_numeric (frame));
+        break;
+    case TrnTag::SPLIT_QUANTITY:
+        xaccSplitSetAmount (spl, sax_frame_numeric (frame));
+        break;
+    case TrnTag::SPLIT_ACCOUNT:
+        if (sax_frame_guid (frame, &guid))
+            sax_split_account (state, &guid);
+        break;
+    case TrnTag::SPLIT_LOT:
+        if (sax_frame_guid (frame, &guid))
+            sax_split_lot (state, &guid);
+        break;
+    case TrnTag::SPLIT_SLOTS:
+        if (!dom_tree_create_instance_slots (state->slots, QOF_INSTANCE (spl)))
+            PERR ("bad slots in %s", tag);
+        break;
+    case TrnTag::TS_DATE:
+        if (state->n_dates++ == 0)
+            state->time = gnc_iso8601_to_time64_gmt (frame.text.c_str ());
+        break;
+    case TrnTag::CMDTY_SPACE:
+        state->cmdty_space = frame.text;
+        state->n_cmdty_space++;
+        break;
+    case TrnTag::CMDTY_ID:
+        state->cmdty_id = frame.text;
+        state->n_cmdty_id++;
+        break;
+    default:
+        break;
+    }
+}
 
-    successful = dom_tree_generic_parse (node, trn_dom_handlers, &pdata);
+static gboolean
+trn_sax_end_handler (gpointer data_for_children,
+                     GSList* data_from_children, GSList* sibling_data,
+                     gpointer parent_data, gpointer global_data,
+                     gpointer* result, const gchar* tag)
+{
+    auto state = static_cast<trn_sax_state*> (data_for_children);
+    auto gdata = static_cast<gxpf_data*> (global_data);
 
-    xaccTransCommitEdit (trn);
+    /* The top-level frame's end handler is called with a NULL tag when
+       this is the top parser; there's nothing to do for it. */
+    if (!tag || !state)
+        return TRUE;
 
-    if (!successful)
+    if (parent_data)
+    {
+        auto frame = std::move (state->stack.back ());
+        state->stack.pop_back ();
+        auto parent = state->stack.back ().tag;
+
+        if (state->slots)
+        {
+            /* Still inside the slots subtree? */
+            if (state->slots_cursor != state->slots)
+            {
+                state->slots_cursor = state->slots_cursor->parent;
+                return TRUE;
+            }
+        }
+        if (parent == TrnTag::TRANSACTION)
+            state->trn_gotten |= 1 << static_cast<int>(frame.tag);
+        else if (parent == TrnTag::SPLIT)
+            state->spl_gotten |= 1 << static_cast<int>(frame.tag);
+
+        /* Parts of a split that won't be added are not applied. */
+        if (state->split || frame.tag < TrnTag::SPLIT_ID ||
+            frame.tag > TrnTag::SPLIT_SLOTS)
+            sax_end_child (state, frame, tag);
+
+        if (state->slots)
+        {
+            xmlFreeNode (state->slots);
+            state->slots = state->slots_cursor = NULL;
+        }
+        return TRUE;
+    }
+
+    auto trn = state->trn;
+    state->trn = NULL;
+    xaccTransCommitEdit (trn);
+    if ((state->trn_gotten & trn_required) != trn_required)
+    {
+        PERR ("didn't find all of the expected tags in the input");
+        state->ok = FALSE;
+    }
+    if (!state->ok)
     {
-        xmlElemDump (stdout, NULL, node);
         xaccTransBeginEdit (trn);
         xaccTransDestroy (trn);
         xaccTransCommitEdit (trn);
         trn = NULL;
     }
+    else
+        gdata->cb (tag, gdata->parsedata, trn);
 
-    return trn;
+    sax_state_free (state);
+    *result = NULL;
+    return trn != NULL;
+}
+
+static void
+trn_sax_fail_handler (gpointer data_for_children,
+                      GSList* data_from_children,
+                      GSList* sibling_data,
+                      gpointer parent_data,
+                      gpointer global_data,
+                      gpointer* result,
+                      const gchar* tag)
+{
+    if (*result)
+    {
+        sax_state_free (static_cast<trn_sax_state*> (*result));
+        *result = NULL;
+    }
 }
 
 sixtp*
 gnc_transaction_sixtp_parser_create (void)
 {
-    return sixtp_dom_parser_new (gnc_transaction_end_handler, NULL, NULL);
+    sixtp* top_level;
+
+    if (! (top_level =
+               sixtp_set_any (sixtp_new (), FALSE,
+                              SIXTP_START_HANDLER_ID, trn_sax_start_handler,
+                              SIXTP_CHARACTERS_HANDLER_ID, trn_sax_characters_handler,
+                              SIXTP_END_HANDLER_ID, trn_sax_end_handler,
+                              SIXTP_FAIL_HANDLER_ID, trn_sax_fail_handler,
+                              SIXTP_NO_MORE_HANDLERS)))
+    {
+        return NULL;
+    }
+
+    if (!sixtp_add_sub_parser (top_level, SIXTP_MAGIC_CATCHER, top_level))
+    {
+        sixtp_destroy (top_level);
+        return NULL;
+    }
+
+    return top_level;
 }
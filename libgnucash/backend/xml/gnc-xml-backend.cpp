@@ -30,15 +30,23 @@ extern "C"
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <regex.h>
+#ifdef HAVE_FICLONE
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#endif
 
 #include <gnc-engine.h> //for GNC_MOD_BACKEND
 #include <gnc-uri-utils.h>
 #include <TransLog.h>
+#include <Transaction.h>
+#include <gnc-commodity.h>
 #include <gnc-prefs.h>
 
 }
 
+#include <algorithm>
 #include <sstream>
+#include <vector>
 
 #include "gnc-xml-backend.hpp"
 #include "gnc-backend-xml.h"
@@ -124,6 +132,7 @@ GncXmlBackend::session_begin(QofSession* session, const char* new_uri,
         set_message("No path specified");
         return;
     }
+    m_journal = m_fullpath + ".journal";
     if (mode == SESSION_NEW_STORE && save_may_clobber_data())
     {
         set_error(ERR_BACKEND_STORE_EXISTS);
@@ -150,6 +159,9 @@ GncXmlBackend::session_begin(QofSession* session, const char* new_uri,
     /* Set the lock file */
     m_lockfile = m_fullpath + ".LCK";
     auto locked = get_file_lock();
+    /* Only the session that holds the file may replay, write or remove
+     * its journal; another instance may be writing to it. */
+    m_owns_lock = locked || mode == SESSION_BREAK_LOCK;
     if (mode == SESSION_BREAK_LOCK && !locked)
     {
         // Don't pass on locked or readonly errors.
@@ -162,6 +174,14 @@ GncXmlBackend::session_begin(QofSession* session, const char* new_uri,
 void
 GncXmlBackend::session_end()
 {
+    finish_backup();
+    /* Whatever wasn't saved by now was meant to be thrown away, but a
+     * journal this session didn't keep holds someone else's changes. */
+    close_journal(m_journal_owned && !(m_book && qof_book_is_readonly (m_book)));
+    m_journaling = false;
+    m_journal_owned = false;
+    m_owns_lock = false;
+
     if (m_book && qof_book_is_readonly (m_book))
     {
         set_error(ERR_BACKEND_READONLY);
@@ -173,6 +193,7 @@ GncXmlBackend::session_end()
 
     if (m_lockfd > 0)
         close (m_lockfd);
+    m_lockfd = -1;
 
     if (!m_lockfile.empty())
     {
@@ -194,6 +215,7 @@ GncXmlBackend::session_end()
     m_fullpath.clear();
     m_lockfile.clear();
     m_linkfile.clear();
+    m_journal.clear();
 }
 
 static QofBookFileType
@@ -235,6 +257,7 @@ GncXmlBackend::load(QofBook* book, QofBackendLoadType loadType)
 
     error = ERR_BACKEND_NO_ERR;
     m_book = book;
+    m_journaling = false;
 
     int rc;
     switch (determine_file_type (m_fullpath))
@@ -295,6 +318,26 @@ GncXmlBackend::load(QofBook* book, QofBackendLoadType loadType)
 
     /* We just got done loading, it can't possibly be dirty !! */
     qof_book_mark_session_saved (book);
+
+    if (error != ERR_BACKEND_NO_ERR || qof_book_is_readonly (book) ||
+        !m_owns_lock)
+        return;
+
+    /* A journal left behind means the last session ended without saving
+     * or throwing its changes away, so bring them back. */
+    if (g_file_test (m_journal.c_str(), G_FILE_TEST_EXISTS))
+    {
+        QofTraceSpan span {"backend", "xml.journal-replay"};
+        auto replayed = gnc_xml_journal_replay (book, m_journal.c_str());
+        if (replayed > 0)
+        {
+            PINFO ("restored %d transactions from %s", replayed,
+                   m_journal.c_str());
+            qof_book_mark_session_dirty (book);
+        }
+    }
+    m_journaling = true;
+    m_journal_owned = true;
 }
 
 void
@@ -317,12 +360,75 @@ GncXmlBackend::sync(QofBook* book)
     }
 
     write_to_file (true);
+    QofTraceSpan span {"backend", "xml.remove-old-files"};
     remove_old_files();
 }
 
+void
+GncXmlBackend::journal_commit(Transaction* trans)
+{
+    if (!m_journal_fd)
+    {
+        m_journal_fd = g_fopen (m_journal.c_str(), "ab");
+        if (!m_journal_fd)
+        {
+            PINFO ("unable to open journal %s: %s", m_journal.c_str(),
+                   g_strerror (errno));
+            m_journaling = false;
+            return;
+        }
+        if (fseek (m_journal_fd, 0, SEEK_END) == 0 && ftell (m_journal_fd) == 0 &&
+            !gnc_xml_journal_write_header (m_journal_fd))
+        {
+            PWARN ("unable to write journal %s", m_journal.c_str());
+            close_journal(true);
+            m_journaling = false;
+            return;
+        }
+    }
+    if (!gnc_xml_journal_append_transaction (m_journal_fd, trans))
+    {
+        PWARN ("unable to write journal %s", m_journal.c_str());
+        close_journal(false);
+        m_journaling = false;
+    }
+}
+
+void
+GncXmlBackend::close_journal(bool remove)
+{
+    if (m_journal_fd)
+    {
+        fclose (m_journal_fd);
+        m_journal_fd = nullptr;
+    }
+    if (remove && !m_journal.empty())
+        g_unlink (m_journal.c_str());
+}
+
 void
 GncXmlBackend::commit(QofInstance* instance)
 {
+    if (m_journaling && GNC_IS_TRANSACTION(instance) &&
+        qof_instance_get_book(instance) == m_book)
+        journal_commit(GNC_TRANSACTION(instance));
+
+    if (!m_trn_cache.empty())
+    {
+        /* A split is written as part of its transaction, and the
+         * transaction's currency by its name, so a renamed commodity
+         * could be in any of them. */
+        if (GNC_IS_TRANSACTION(instance))
+            m_trn_cache.erase(*qof_instance_get_guid(instance));
+        else if (GNC_IS_SPLIT(instance))
+        {
+            auto trans = xaccSplitGetParent(GNC_SPLIT(instance));
+            if (trans)
+                m_trn_cache.erase(*qof_instance_get_guid(trans));
+        }
+        else if (GNC_IS_COMMODITY(instance))
+            m_trn_cache.clear();
+    }
     if (qof_instance_is_dirty(instance))
         qof_instance_mark_clean(instance);
 }
@@ -391,6 +497,7 @@ GncXmlBackend::write_to_file (bool make_backup)
 
     if (make_backup)
     {
+        QofTraceSpan span {"backend", "xml.backup"};
         if (!backup_file ())
         {
             g_free (tmp_name);
@@ -481,6 +588,10 @@ GncXmlBackend::write_to_file (bool make_backup)
         /* Since we successfully saved the book,
          * we should mark it clean. */
         qof_book_mark_session_saved (m_book);
+        /* ...and everything the journal held is in the file now. */
+        close_journal(m_owns_lock);
+        m_journaling = m_owns_lock && !qof_book_is_readonly (m_book);
+        m_journal_owned = m_journal_owned || m_journaling;
         LEAVE (" successful save of book=%p to file=%s", m_book,
                m_fullpath.c_str());
         return TRUE;
@@ -524,15 +635,66 @@ GncXmlBackend::write_to_file (bool make_backup)
     return TRUE;
 }
 
+/* Copy everything from orig_fd to bkup_fd.  Where the file system can
+ * share the blocks or copy them itself the data never passes through
+ * here, which matters most on network shares. */
+static bool
+copy_fd (int orig_fd, int bkup_fd)
+{
+#ifdef HAVE_FICLONE
+    if (ioctl (bkup_fd, FICLONE, orig_fd) == 0)
+        return true;
+#endif
+#ifdef HAVE_COPY_FILE_RANGE
+    ssize_t copied;
+    while ((copied = copy_file_range (orig_fd, NULL, bkup_fd, NULL,
+                                      1 << 30, 0)) > 0)
+        ;
+    if (copied == 0)
+        return true;
+    /* Not supported between these files; carry on from wherever it got
+     * to the old way. */
+    if (errno != EXDEV && errno != ENOSYS && errno != EINVAL &&
+        errno != EOPNOTSUPP)
+        return false;
+#endif
+
+    constexpr size_t buf_size = 1 << 16;
+    std::vector<char> buf (buf_size);
+    ssize_t count_read;
+
+    do
+    {
+        count_read = read (orig_fd, buf.data(), buf_size);
+        if (count_read == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        for (ssize_t done = 0; done < count_read;)
+        {
+            auto count_write = write (bkup_fd, buf.data() + done,
+                                      count_read - done);
+            if (count_write == -1)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+            done += count_write;
+        }
+    }
+    while (count_read != 0);
+
+    return true;
+}
+
 static bool
 copy_file (const std::string& orig, const std::string& bkup)
 {
-    constexpr size_t buf_size = 1024;
-    char buf[buf_size];
     int flags = 0;
-    ssize_t count_write = 0;
-    ssize_t count_read = 0;
-
 
 #ifdef G_OS_WIN32
     flags = O_BINARY;
@@ -551,33 +713,27 @@ copy_file (const std::string& orig, const std::string& bkup)
         return FALSE;
     }
 
-    do
-    {
-        count_read = read (orig_fd, buf, buf_size);
-        if (count_read == -1 && errno != EINTR)
-        {
-            close (orig_fd);
-            close (bkup_fd);
-            return FALSE;
-        }
-
-        if (count_read > 0)
-        {
-            count_write = write (bkup_fd, buf, count_read);
-            if (count_write == -1)
-            {
-                close (orig_fd);
-                close (bkup_fd);
-                return FALSE;
-            }
-        }
-    }
-    while (count_read > 0);
-
+    auto ok = copy_fd (orig_fd, bkup_fd);
     close (orig_fd);
-    close (bkup_fd);
+    if (close (bkup_fd) != 0)
+        ok = false;
 
-    return TRUE;
+    return ok;
+}
+
+/* Whether link() failing with err means the file system can't do links,
+ * as opposed to the link itself being impossible. */
+static bool
+link_unsupported (int err)
+{
+    return err == EPERM || err == ENOSYS
+#ifdef EOPNOTSUPP
+           || err == EOPNOTSUPP
+#endif
+#ifdef ENOTSUP
+           || err == ENOTSUP
+#endif
+           ;
 }
 
 bool
@@ -595,17 +751,7 @@ GncXmlBackend::link_or_make_backup (const std::string& orig,
     if (err_ret != 0)
     {
 #ifdef HAVE_LINK
-        if (errno == EPERM || errno == ENOSYS
-# ifdef EOPNOTSUPP
-            || errno == EOPNOTSUPP
-# endif
-# ifdef ENOTSUP
-            || errno == ENOTSUP
-# endif
-# ifdef ENOSYS
-            || errno == ENOSYS
-# endif
-           )
+        if (link_unsupported (errno))
 #endif
         {
             copy_success = copy_file (orig.c_str(), bkup);
@@ -708,6 +854,7 @@ GncXmlBackend::get_file_lock ()
         set_error(ERR_BACKEND_LOCKED);
         g_unlink (linkfile.str().c_str());
         close (m_lockfd);
+        m_lockfd = -1;
         g_unlink (m_lockfile.c_str());
         return false;
     }
@@ -721,6 +868,7 @@ GncXmlBackend::get_file_lock ()
         set_message(msg + m_lockfile);
         g_unlink (linkfile.str().c_str());
         close (m_lockfd);
+        m_lockfd = -1;
         g_unlink (m_lockfile.c_str());
         return false;
     }
@@ -730,6 +878,7 @@ GncXmlBackend::get_file_lock ()
         set_error(ERR_BACKEND_LOCKED);
         g_unlink (linkfile.str().c_str());
         close (m_lockfd);
+        m_lockfd = -1;
         g_unlink (m_lockfile.c_str());
         return false;
     }
@@ -744,6 +893,43 @@ GncXmlBackend::get_file_lock ()
 #endif /* ifndef G_OS_WIN32 */
 }
 
+#ifdef HAVE_LINK
+struct BackupCopy
+{
+    int orig_fd;
+    int bkup_fd;
+    std::string name;
+};
+
+static gpointer
+backup_copy_thread (gpointer data)
+{
+    auto copy = static_cast<BackupCopy*>(data);
+    auto ok = copy_fd (copy->orig_fd, copy->bkup_fd);
+    close (copy->orig_fd);
+    if (close (copy->bkup_fd) != 0)
+        ok = false;
+    if (!ok)
+    {
+        PWARN ("unable to make file backup %s: %s", copy->name.c_str(),
+               g_strerror (errno));
+        g_unlink (copy->name.c_str());
+    }
+    delete copy;
+    return nullptr;
+}
+#endif
+
+void
+GncXmlBackend::finish_backup()
+{
+    if (m_backup_thread)
+    {
+        g_thread_join (m_backup_thread);
+        m_backup_thread = nullptr;
+    }
+}
+
 bool
 GncXmlBackend::backup_file()
 {
@@ -751,6 +937,8 @@ GncXmlBackend::backup_file()
 
     auto datafile = m_fullpath.c_str();
 
+    finish_backup();
+
     auto rc = g_stat (datafile, &statbuf);
     if (rc)
         return (errno == ENOENT);
@@ -770,7 +958,56 @@ GncXmlBackend::backup_file()
     auto backup = m_fullpath + "." + timestamp + GNC_DATAFILE_EXT;
     g_free (timestamp);
 
+#ifdef HAVE_LINK
+    if (link (datafile, backup.c_str()) == 0)
+    {
+        m_old_files.emplace_back (backup, statbuf.st_mtime);
+        return true;
+    }
+    if (!link_unsupported (errno))
+    {
+        set_error(ERR_FILEIO_BACKUP_ERROR);
+        PWARN ("unable to make file backup from %s to %s: %s",
+               datafile, backup.c_str(), g_strerror (errno));
+        return false;
+    }
+
+    /* Copying can take a long while on a network share. The file being
+     * backed up stays readable through a descriptor opened now even once
+     * the new one replaces it, so the copy is left to a thread. */
+    auto orig_fd = g_open (datafile, O_RDONLY, 0);
+    auto bkup_fd = orig_fd == -1 ? -1 :
+        g_open (backup.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_EXCL, 0600);
+    if (bkup_fd == -1)
+    {
+        if (orig_fd != -1)
+            close (orig_fd);
+        set_error(ERR_FILEIO_BACKUP_ERROR);
+        PWARN ("unable to make file backup from %s to %s: %s",
+               datafile, backup.c_str(), g_strerror (errno));
+        return false;
+    }
+    m_backup_thread = g_thread_new ("xml_backup", backup_copy_thread,
+                                    new BackupCopy {orig_fd, bkup_fd, backup});
+    m_old_files.emplace_back (backup, gnc_time (NULL));
+    return true;
+#else
     return link_or_make_backup (datafile, backup);
+#endif
+}
+
+/* Remove a backup or log file if it is past the retention period. */
+static bool
+expire_old_file (const char* name, time64 mtime, time64 now)
+{
+    auto days = (int) (difftime (now, mtime) / 86400);
+
+    PINFO ("file retention = %d days", gnc_prefs_get_file_retention_days ());
+    if (days < gnc_prefs_get_file_retention_days ())
+        return false;
+    PINFO ("remove stale file: %s  - reason: more than %d days old", name, days);
+    g_unlink (name);
+    return true;
 }
 
 /*
@@ -786,11 +1023,33 @@ GncXmlBackend::remove_old_files ()
     if (g_stat (m_lockfile.c_str(), &lockstatbuf) != 0)
         return;
 
+    /* Listing the directory and stat-ing everything in it is slow on
+     * network shares, so between daily rescans only the files found last
+     * time and the backups made since are looked at. Log files started in
+     * the meantime can't come due in less than a day. */
+    auto now = gnc_time (NULL);
+    if (gnc_prefs_get_file_retention_policy () == XML_RETAIN_DAYS &&
+        m_old_files_scanned != 0 && now - m_old_files_scanned < 86400)
+    {
+        if (gnc_prefs_get_file_retention_days () > 0)
+        {
+            auto expired = [now](const auto& file)
+            {
+                return expire_old_file (file.first.c_str(), file.second, now);
+            };
+            m_old_files.erase (std::remove_if (m_old_files.begin(),
+                                               m_old_files.end(), expired),
+                               m_old_files.end());
+        }
+        return;
+    }
+
     auto dir = g_dir_open (m_dirname.c_str(), 0, NULL);
     if (!dir)
         return;
 
-    auto now = gnc_time (NULL);
+    m_old_files.clear();
+    m_old_files_scanned = now;
     const char* dent;
     while ((dent = g_dir_read_name (dir)) != NULL)
     {
@@ -881,22 +1140,14 @@ GncXmlBackend::remove_old_files ()
         else if ((gnc_prefs_get_file_retention_policy () == XML_RETAIN_DAYS) &&
                  (gnc_prefs_get_file_retention_days () > 0))
         {
-            int days;
-
             /* Is the backup file old enough to delete */
             if (g_stat (name, &statbuf) != 0)
             {
                 g_free (name);
                 continue;
             }
-            days = (int) (difftime (now, statbuf.st_mtime) / 86400);
-
-            PINFO ("file retention = %d days", gnc_prefs_get_file_retention_days ());
-            if (days >= gnc_prefs_get_file_retention_days ())
-            {
-                PINFO ("remove stale file: %s  - reason: more than %d days old", name, days);
-                g_unlink (name);
-            }
+            if (!expire_old_file (name, statbuf.st_mtime, now))
+                m_old_files.emplace_back (name, statbuf.st_mtime);
         }
         g_free (name);
     }
@@ -24,8 +24,24 @@ extern "C"
 }
 
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <qof-backend.hpp>
 
+struct GncXmlGuidHash
+{
+    size_t operator()(const GncGUID& guid) const { return guid_hash_to_guint(&guid); }
+};
+
+struct GncXmlGuidEqual
+{
+    bool operator()(const GncGUID& a, const GncGUID& b) const { return guid_equal(&a, &b); }
+};
+
+/* Transactions as they were last written, by GUID. */
+using GncXmlTrnCache = std::unordered_map<GncGUID, std::string,
+                                          GncXmlGuidHash, GncXmlGuidEqual>;
+
 class GncXmlBackend : public QofBackend
 {
 public:
@@ -46,22 +62,38 @@ public:
     void commit(QofInstance* instance) override;
     const char * get_filename() { return m_fullpath.c_str(); }
     QofBook* get_book() { return m_book; }
+    /* Saves copy unchanged transactions from here instead of serializing
+     * them again; commit() drops whatever it sees change. */
+    GncXmlTrnCache& get_trn_cache() { return m_trn_cache; }
 
 private:
     bool save_may_clobber_data();
     bool get_file_lock();
     bool link_or_make_backup(const std::string& orig, const std::string& bkup);
     bool backup_file();
+    void finish_backup();
     bool write_to_file(bool make_backup);
     void remove_old_files();
     void write_accounts(QofBook* book);
     bool check_path(const char* fullpath, bool create);
+    void journal_commit(Transaction* trans);
+    void close_journal(bool remove);
 
     std::string m_dirname;
     std::string m_lockfile;
     std::string m_linkfile;
-    int m_lockfd;
+    std::string m_journal;  /* Changes committed since the last save */
+    int m_lockfd = -1;
+    FILE* m_journal_fd = nullptr;
+    GThread* m_backup_thread = nullptr;
+    /* Backup and log files remove_old_files found, with their mtimes. */
+    std::vector<std::pair<std::string, time64>> m_old_files;
+    time64 m_old_files_scanned = 0;
+    bool m_journaling = false;
+    bool m_owns_lock = false;      /* Holds the lock, or broke it */
+    bool m_journal_owned = false;  /* Kept the journal at some point */
 
     QofBook* m_book = nullptr;  /* The primary, main open book */
+    GncXmlTrnCache m_trn_cache;
 };
 #endif // __GNC_XML_BACKEND_HPP__
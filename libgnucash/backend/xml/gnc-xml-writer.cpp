@@ -0,0 +1,169 @@
+/********************************************************************\
+ * gnc-xml-writer.cpp -- streaming xml output for the file backend  *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+#include <glib.h>
+
+#include "gnc-xml-helper.h"
+#include "gnc-xml-writer.h"
+
+void
+GncXmlWriter::close_start_tag (Content content)
+{
+    auto& top = m_open.back ();
+    if (top.second != Content::NONE)
+        return;
+    top.second = content;
+    /* libxml2 only breaks lines inside elements without text children. */
+    m_buf += content == Content::ELEMENTS ? ">\n" : ">";
+}
+
+void
+GncXmlWriter::indent (size_t level)
+{
+    m_buf.append (2 * level, ' ');
+}
+
+void
+GncXmlWriter::escape (const char* str, bool attr)
+{
+    for (auto c = str; *c; ++c)
+    {
+        switch (*c)
+        {
+        case '<':
+            m_buf += "&lt;";
+            break;
+        case '>':
+            m_buf += "&gt;";
+            break;
+        case '&':
+            m_buf += "&amp;";
+            break;
+        case '\r':
+            m_buf += "&#13;";
+            break;
+        case '"':
+            m_buf += attr ? "&quot;" : "\"";
+            break;
+        case '\n':
+            m_buf += attr ? "&#10;" : "\n";
+            break;
+        case '\t':
+            m_buf += attr ? "&#9;" : "\t";
+            break;
+        default:
+            m_buf += *c;
+        }
+    }
+}
+
+void
+GncXmlWriter::start_element (const char* tag)
+{
+    g_return_if_fail (tag);
+    if (!m_open.empty ())
+    {
+        g_return_if_fail (m_open.back ().second != Content::TEXT);
+        close_start_tag (Content::ELEMENTS);
+        indent (m_open.size ());
+    }
+    m_buf += '<';
+    m_buf += tag;
+    m_open.emplace_back (tag, Content::NONE);
+}
+
+void
+GncXmlWriter::attribute (const char* name, const char* value)
+{
+    g_return_if_fail (name && value);
+    g_return_if_fail (!m_open.empty () &&
+                      m_open.back ().second == Content::NONE);
+    m_buf += ' ';
+    m_buf += name;
+    m_buf += "=\"";
+    escape (value, true);
+    m_buf += '"';
+}
+
+void
+GncXmlWriter::text (const char* str)
+{
+    g_return_if_fail (str);
+    g_return_if_fail (!m_open.empty () &&
+                      m_open.back ().second != Content::ELEMENTS);
+    close_start_tag (Content::TEXT);
+    m_scratch.assign (str);
+    escape (reinterpret_cast<char*>(checked_char_cast (&m_scratch[0])), false);
+}
+
+void
+GncXmlWriter::end_element ()
+{
+    g_return_if_fail (!m_open.empty ());
+    auto& top = m_open.back ();
+    switch (top.second)
+    {
+    case Content::NONE:
+        m_buf += "/>";
+        break;
+    case Content::ELEMENTS:
+        indent (m_open.size () - 1);
+        /* fall through */
+    case Content::TEXT:
+        m_buf += "</";
+        m_buf += top.first;
+        m_buf += '>';
+        break;
+    }
+    m_open.pop_back ();
+    if (!m_open.empty ())
+        m_buf += '\n';
+}
+
+void
+GncXmlWriter::text_element (const char* tag, const char* str)
+{
+    start_element (tag);
+    if (str)
+        text (str);
+    end_element ();
+}
+
+gboolean
+GncXmlWriter::flush ()
+{
+    if (!m_out)
+        return TRUE;
+    if (!m_buf.empty ())
+    {
+        fwrite (m_buf.data (), 1, m_buf.size (), m_out);
+        m_buf.clear ();
+    }
+    return !ferror (m_out);
+}
+
+std::string
+GncXmlWriter::release ()
+{
+    std::string text;
+    text.swap (m_buf);
+    return text;
+}
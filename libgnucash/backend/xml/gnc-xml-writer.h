@@ -0,0 +1,86 @@
+/********************************************************************\
+ * gnc-xml-writer.h -- streaming xml output for the file backend    *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+
+#ifndef GNC_XML_WRITER_H
+#define GNC_XML_WRITER_H
+
+#include <glib.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/** Writes elements straight to a FILE without building a libxml2 tree.
+ *
+ * The output is byte-for-byte what xmlElemDump produces for the
+ * equivalent tree: an element whose children are all elements gets each
+ * child on its own line indented two spaces per level, an element with
+ * text content is written inline and an element with no content at all
+ * is written as an empty tag. Text passed in is sanitized the same way
+ * checked_char_cast() sanitizes it for the DOM generators.
+ *
+ * Output is buffered; call flush() once the element is complete. A
+ * writer made without a FILE only accumulates, and the text is collected
+ * with release().
+ */
+class GncXmlWriter
+{
+public:
+    GncXmlWriter () : m_out {nullptr} {}
+    explicit GncXmlWriter (FILE* out) : m_out {out} {}
+    GncXmlWriter (const GncXmlWriter&) = delete;
+    GncXmlWriter& operator= (const GncXmlWriter&) = delete;
+    ~GncXmlWriter () { flush (); }
+
+    /** Open an element. Attributes may be added until the first child
+     * or text is written. An element holds either text or child
+     * elements, never both. The tag must outlive the element. */
+    void start_element (const char* tag);
+    void attribute (const char* name, const char* value);
+    /** Append sanitized, escaped character data to the open element. */
+    void text (const char* str);
+    void end_element ();
+
+    /** Equivalent of xmlNewTextChild: a NULL str gives an empty tag, an
+     * empty one gives an open/close pair. */
+    void text_element (const char* tag, const char* str);
+
+    /** Break the line after a top-level element. */
+    void newline () { m_buf += '\n'; }
+
+    /** Write out the buffer. Returns FALSE if the FILE has an error. */
+    gboolean flush ();
+    /** Hand over everything written so far, leaving the buffer empty. */
+    std::string release ();
+
+private:
+    enum class Content { NONE, ELEMENTS, TEXT };
+    void close_start_tag (Content content);
+    void indent (size_t level);
+    void escape (const char* str, bool attr);
+
+    FILE* m_out;
+    std::string m_buf;
+    std::string m_scratch;
+    std::vector<std::pair<const char*, Content>> m_open;
+};
+
+#endif /* GNC_XML_WRITER_H */
@@ -34,6 +34,7 @@ extern "C"
 }
 
 #include "gnc-xml-helper.h"
+#include "gnc-xml-writer.h"
 #include "sixtp.h"
 
 xmlNodePtr gnc_account_dom_tree_create (Account* act, gboolean exporting,
@@ -63,6 +64,7 @@ xmlNodePtr gnc_budget_dom_tree_create (GncBudget* bgt);
 sixtp* gnc_budget_sixtp_parser_create (void);
 
 xmlNodePtr gnc_transaction_dom_tree_create (Transaction* txn);
+void gnc_transaction_xml_stream (GncXmlWriter& writer, Transaction* txn);
 sixtp* gnc_transaction_sixtp_parser_create (void);
 
 sixtp* gnc_template_transaction_sixtp_parser_create (void);
@@ -1243,6 +1243,7 @@ account_restore_after_child_handler (gpointer data_for_children,
         g_return_val_if_fail (f, FALSE);
         if (a->inst.kvp_data) delete a->inst.kvp_data;
         a->inst.kvp_data = f;
+        KvpFrame::changed ();
         child_result->should_cleanup = FALSE;
     }
     else if (strcmp (child_result->tag, "currency") == 0)
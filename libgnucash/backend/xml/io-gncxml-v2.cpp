@@ -55,6 +55,7 @@ extern "C"
 #include "Transaction.h"
 #include "TransactionP.h"
 #include "TransLog.h"
+#include "gnc-prefs.h"
 #if PLATFORM(WINDOWS)
 #ifdef __STRICT_ANSI_UNSET__
 #undef __STRICT_ANSI_UNSET__
@@ -76,6 +77,11 @@ extern "C"
 #include "io-gncxml-v2.h"
 #include "io-gncxml-gen.h"
 
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+
 /* Do not treat -Wstrict-aliasing warnings as errors because of problems of the
  * G_LOCK* macros as declared by glib.  See
  * https://bugs.gnucash.org/show_bug.cgi?id=316221 for additional information.
@@ -96,6 +102,7 @@ typedef struct
     gchar* filename;
     gchar* perms;
     gboolean compress;
+    gint level;
 } gz_thread_params_t;
 
 /* Callback structure */
@@ -108,6 +115,7 @@ struct file_backend
     sixtp*          parser;
     FILE*           out;
     QofBook*        book;
+    GncXmlWriter*   writer;
 };
 
 static std::vector<GncXmlDataType_t> backend_registry;
@@ -249,6 +257,9 @@ add_account_local (sixtp_gdv2* data, Account* act)
             root = gnc_book_get_root_account (data->book);
             gnc_account_append_child (root, act);
         }
+        /* Append the account's splits as they are read and sort them
+         * once when the whole file is in. */
+        gnc_account_begin_bulk_insert (act);
     }
 
     data->counter.accounts_loaded++;
@@ -377,6 +388,13 @@ counter (const GncXmlDataType_t& data, file_backend* be_data)
     /* XXX: should we do anything with this counter? */
 }
 
+static void
+reserve_collection (QofBook* book, QofIdType type, gint64 count)
+{
+    if (book && count > 0 && count <= G_MAXUINT)
+        qof_collection_reserve (qof_book_get_collection (book, type), count);
+}
+
 static gboolean
 gnc_counter_end_handler (gpointer data_for_children,
                          GSList* data_from_children, GSList* sibling_data,
@@ -416,10 +434,16 @@ gnc_counter_end_handler (gpointer data_for_children,
     else if (g_strcmp0 (type, "transaction") == 0)
     {
         sixdata->counter.transactions_total = val;
+        /* The counts come ahead of the data, so size the collections now
+         * rather than growing them one entity at a time.  Splits aren't
+         * counted in the file but every transaction has at least two. */
+        reserve_collection (sixdata->book, GNC_ID_TRANS, val);
+        reserve_collection (sixdata->book, GNC_ID_SPLIT, 2 * val);
     }
     else if (g_strcmp0 (type, "account") == 0)
     {
         sixdata->counter.accounts_total = val;
+        reserve_collection (sixdata->book, GNC_ID_ACCOUNT, val);
     }
     else if (g_strcmp0 (type, "book") == 0)
     {
@@ -432,10 +456,12 @@ gnc_counter_end_handler (gpointer data_for_children,
     else if (g_strcmp0 (type, "schedxaction") == 0)
     {
         sixdata->counter.schedXactions_total = val;
+        reserve_collection (sixdata->book, GNC_ID_SCHEDXACTION, val);
     }
     else if (g_strcmp0 (type, "budget") == 0)
     {
         sixdata->counter.budgets_total = val;
+        reserve_collection (sixdata->book, GNC_ID_BUDGET, val);
     }
     else if (g_strcmp0 (type, "price") == 0)
     {
@@ -774,6 +800,8 @@ qof_session_load_from_xml_file_v2_full (
     /* stop logging while we load */
     xaccLogDisable ();
     xaccDisableDataScrubbing ();
+    dom_tree_commodity_intern_begin (book);
+    qof_trace_begin ("backend", "xml.parse", NULL);
 
     if (push_handler)
     {
@@ -796,10 +824,13 @@ qof_session_load_from_xml_file_v2_full (
          * info.
          */
          const char* filename = xml_be->get_filename();
-        FILE* file;
+        FILE* file = NULL;
         gboolean is_compressed = is_gzipped_file (filename);
-        file = try_gz_open (filename, "r", is_compressed, FALSE);
-        if (file == NULL)
+        if (!is_compressed)
+            retval = gnc_xml_parse_mapped_file (top_parser, filename,
+                                                generic_callback, gd, book);
+        else if ((file = try_gz_open (filename, "r", is_compressed,
+                                      FALSE)) == NULL)
         {
             PWARN ("Unable to open file %s", filename);
             retval = FALSE;
@@ -814,8 +845,15 @@ qof_session_load_from_xml_file_v2_full (
         }
     }
 
+    qof_trace_end ();
+    dom_tree_commodity_intern_end (book);
     if (!retval)
     {
+        /* The accounts read before the parse failed are still in bulk
+         * insert. */
+        gnc_account_foreach_descendant (gnc_book_get_root_account (book),
+                                        (AccountCb) gnc_account_end_bulk_insert,
+                                        NULL);
         sixtp_destroy (top_parser);
         xaccLogEnable ();
         xaccEnableDataScrubbing ();
@@ -827,12 +865,21 @@ qof_session_load_from_xml_file_v2_full (
     sixtp_destroy (top_parser);
     g_free (gd);
 
+    qof_trace_begin ("backend", "xml.bulk-insert", NULL);
+    root = gnc_book_get_root_account (book);
+    gnc_account_tree_bring_up_to_date (root);
+    gnc_account_foreach_descendant (root,
+                                    (AccountCb) gnc_account_end_bulk_insert,
+                                    NULL);
+    qof_trace_end ();
+
     xaccEnableDataScrubbing ();
 
     /* Mark the session as saved */
     qof_book_mark_session_saved (book);
 
     /* Call individual scrub functions */
+    qof_trace_begin ("backend", "xml.scrub", NULL);
     memset (&be_data, 0, sizeof (be_data));
     be_data.book = book;
     for (auto data : backend_registry)
@@ -847,16 +894,19 @@ qof_session_load_from_xml_file_v2_full (
 
     /* Fix split amount/value */
     xaccAccountTreeScrubSplits (root);
+    qof_trace_end ();
 
     /* commit all groups, this completes the BeginEdit started when the
      * account_end_handler finished reading the account.
      */
+    qof_trace_begin ("backend", "xml.commit-accounts", NULL);
     gnc_account_foreach_descendant (root,
                                     (AccountCb) xaccAccountCommitEdit,
                                     NULL);
     gnc_account_foreach_descendant (gnc_book_get_template_root (book),
                                     (AccountCb) xaccAccountCommitEdit,
                                     NULL);
+    qof_trace_end ();
 
     /* start logging again */
     xaccLogEnable ();
@@ -1045,6 +1095,7 @@ write_book (FILE* out, QofBook* book, sixtp_gdv2* gd)
 gboolean
 write_commodities (FILE* out, QofBook* book, sixtp_gdv2* gd)
 {
+    QofTraceSpan span {"backend", "xml.write-commodities"};
     gnc_commodity_table* tbl;
     GList* namespaces;
     GList* lp;
@@ -1097,6 +1148,7 @@ write_commodities (FILE* out, QofBook* book, sixtp_gdv2* gd)
 static gboolean
 write_pricedb (FILE* out, QofBook* book, sixtp_gdv2* gd)
 {
+    QofTraceSpan span {"backend", "xml.write-prices"};
     xmlNodePtr node;
     xmlNodePtr parent;
     xmlOutputBufferPtr outbuf;
@@ -1154,14 +1206,11 @@ static int
 xml_add_trn_data (Transaction* t, gpointer data)
 {
     struct file_backend* be_data = static_cast<decltype (be_data)> (data);
-    xmlNodePtr node;
 
-    node = gnc_transaction_dom_tree_create (t);
-
-    xmlElemDump (be_data->out, NULL, node);
-    xmlFreeNode (node);
+    gnc_transaction_xml_stream (*be_data->writer, t);
+    be_data->writer->newline ();
 
-    if (ferror (be_data->out) || fprintf (be_data->out, "\n") < 0)
+    if (!be_data->writer->flush ())
         return -1;
 
     be_data->gd->counter.transactions_loaded++;
@@ -1169,27 +1218,246 @@ xml_add_trn_data (Transaction* t, gpointer data)
     return 0;
 }
 
+/* Below this many transactions the thread start-up isn't worth it. */
+#define XML_PARALLEL_MIN_TRANSACTIONS 2048
+#define XML_TRN_CHUNK_SIZE 256
+
+/* Transactions to write, each with its text from the previous save if
+ * it hasn't changed since. */
+struct trn_to_write
+{
+    Transaction* trn;
+    const std::string* cached;
+};
+
+struct trn_chunk
+{
+    std::vector<trn_to_write>::const_iterator begin;
+    std::vector<trn_to_write>::const_iterator end;
+    std::string xml;
+    /* Where each freshly serialized transaction ends in xml. */
+    std::vector<size_t> fresh_ends;
+    gboolean done;
+};
+
+struct work_pipeline
+{
+    GMutex mutex;
+    GCond cond;
+};
+
+static int
+collect_trn_cb (Transaction* t, gpointer data)
+{
+    static_cast<std::vector<Transaction*>*> (data)->push_back (t);
+    return 0;
+}
+
+static void
+serialize_trn_chunk_job (gpointer data, gpointer user_data)
+{
+    auto chunk = static_cast<trn_chunk*> (data);
+    auto pipeline = static_cast<work_pipeline*> (user_data);
+    GncXmlWriter writer;
+    std::string xml;
+
+    for (auto iter = chunk->begin; iter != chunk->end; ++iter)
+    {
+        if (iter->cached)
+        {
+            xml += *iter->cached;
+            continue;
+        }
+        gnc_transaction_xml_stream (writer, iter->trn);
+        writer.newline ();
+        xml += writer.release ();
+        chunk->fresh_ends.push_back (xml.size ());
+    }
+
+    g_mutex_lock (&pipeline->mutex);
+    chunk->xml = std::move (xml);
+    chunk->done = TRUE;
+    g_cond_broadcast (&pipeline->cond);
+    g_mutex_unlock (&pipeline->mutex);
+}
+
+/* Serialize chunks of transactions on a thread pool and write each chunk
+ * out as soon as it and everything before it is done, so the file is the
+ * same as the serial writer's. Only a window of chunks is queued ahead of
+ * the writer to bound the memory held in pending buffers. Returns FALSE
+ * without writing anything if the pool can't be used. */
+static gboolean
+write_transactions_parallel (FILE* out, const std::vector<trn_to_write>& trns,
+                             GncXmlTrnCache* cache, sixtp_gdv2* gd,
+                             gboolean* ok)
+{
+    work_pipeline pipeline;
+    std::vector<trn_chunk> chunks;
+    GError* error = NULL;
+    guint n_threads = g_get_num_processors ();
+
+    if (n_threads < 2 || trns.size () < XML_PARALLEL_MIN_TRANSACTIONS)
+        return FALSE;
+
+    for (auto begin = trns.cbegin (); begin != trns.cend ();)
+    {
+        auto left = static_cast<size_t> (trns.cend () - begin);
+        auto end = begin + std::min (left, static_cast<size_t> (XML_TRN_CHUNK_SIZE));
+        chunks.push_back ({begin, end, std::string (), {}, FALSE});
+        begin = end;
+    }
+
+    g_mutex_init (&pipeline.mutex);
+    g_cond_init (&pipeline.cond);
+    auto pool = g_thread_pool_new (serialize_trn_chunk_job, &pipeline,
+                                   n_threads, TRUE, &error);
+    if (!pool)
+    {
+        PWARN ("Unable to create thread pool: %s", error->message);
+        g_error_free (error);
+        g_mutex_clear (&pipeline.mutex);
+        g_cond_clear (&pipeline.cond);
+        return FALSE;
+    }
+
+    auto window = n_threads * 4;
+    size_t queued = 0;
+    *ok = TRUE;
+    for (size_t i = 0; i < chunks.size () && *ok; ++i)
+    {
+        for (; queued < chunks.size () && queued < i + window; ++queued)
+            g_thread_pool_push (pool, &chunks[queued], NULL);
+
+        auto& chunk = chunks[i];
+        g_mutex_lock (&pipeline.mutex);
+        while (!chunk.done)
+            g_cond_wait (&pipeline.cond, &pipeline.mutex);
+        g_mutex_unlock (&pipeline.mutex);
+
+        fwrite (chunk.xml.data (), 1, chunk.xml.size (), out);
+        if (ferror (out))
+        {
+            *ok = FALSE;
+            break;
+        }
+        /* The workers only hold pointers to existing entries, which
+         * adding new ones doesn't move. */
+        if (cache)
+        {
+            size_t start = 0;
+            auto end = chunk.fresh_ends.cbegin ();
+            for (auto iter = chunk.begin; iter != chunk.end; ++iter)
+            {
+                if (iter->cached)
+                {
+                    start += iter->cached->size ();
+                    continue;
+                }
+                if (!xaccTransIsOpen (iter->trn))
+                    cache->emplace (*qof_instance_get_guid (iter->trn),
+                                    chunk.xml.substr (start, *end - start));
+                start = *end++;
+            }
+        }
+        std::string ().swap (chunk.xml);
+        for (auto iter = chunk.begin; iter != chunk.end; ++iter)
+        {
+            gd->counter.transactions_loaded++;
+            sixtp_run_callback (gd, "transaction");
+        }
+    }
+
+    /* On a write error drop the chunks nobody has started. */
+    g_thread_pool_free (pool, !*ok, TRUE);
+    g_mutex_clear (&pipeline.mutex);
+    g_cond_clear (&pipeline.cond);
+    PINFO ("serialized %zu transactions on %u threads", trns.size (), n_threads);
+    return TRUE;
+}
+
+/* The XML backend keeps each transaction's text from the last save until
+ * it sees the transaction committed again, so an autosave after a few
+ * edits copies almost everything and serializes only what changed. A
+ * book with some other backend, or a transaction that is still open for
+ * editing, is written out afresh. */
+static GncXmlTrnCache*
+trn_cache_for_book (QofBook* book)
+{
+    auto xml_be = dynamic_cast<GncXmlBackend*> (qof_book_get_backend (book));
+    return xml_be ? &xml_be->get_trn_cache () : nullptr;
+}
+
 static gboolean
 write_transactions (FILE* out, QofBook* book, sixtp_gdv2* gd)
 {
-    struct file_backend be_data;
+    QofTraceSpan span {"backend", "xml.write-transactions"};
+    std::vector<Transaction*> collected;
+    std::vector<trn_to_write> trns;
+    GncXmlWriter writer;
+    auto cache = trn_cache_for_book (book);
+    size_t n_cached = 0;
+    gboolean ok;
+
+    /* The traversal marks transactions, so it has to stay on this
+     * thread; only serialization is farmed out. */
+    xaccAccountTreeForEachTransaction (gnc_book_get_root_account (book),
+                                       collect_trn_cb, &collected);
+    trns.reserve (collected.size ());
+    for (auto trn : collected)
+    {
+        const std::string* cached = nullptr;
+        if (cache && !xaccTransIsOpen (trn))
+        {
+            auto iter = cache->find (*qof_instance_get_guid (trn));
+            if (iter != cache->end ())
+            {
+                cached = &iter->second;
+                ++n_cached;
+            }
+        }
+        trns.push_back ({trn, cached});
+    }
+    PINFO ("%zu of %zu transactions unchanged since the last save",
+           n_cached, trns.size ());
 
-    be_data.out = out;
-    be_data.gd = gd;
-    return 0 ==
-           xaccAccountTreeForEachTransaction (gnc_book_get_root_account (book),
-                                              xml_add_trn_data,
-                                              (gpointer) &be_data);
+    if (write_transactions_parallel (out, trns, cache, gd, &ok))
+        return ok;
+
+    for (const auto& item : trns)
+    {
+        if (item.cached)
+        {
+            fwrite (item.cached->data (), 1, item.cached->size (), out);
+        }
+        else
+        {
+            gnc_transaction_xml_stream (writer, item.trn);
+            writer.newline ();
+            auto xml = writer.release ();
+            fwrite (xml.data (), 1, xml.size (), out);
+            if (cache && !xaccTransIsOpen (item.trn))
+                cache->emplace (*qof_instance_get_guid (item.trn),
+                                std::move (xml));
+        }
+        if (ferror (out))
+            return FALSE;
+        gd->counter.transactions_loaded++;
+        sixtp_run_callback (gd, "transaction");
+    }
+    return TRUE;
 }
 
 static gboolean
 write_template_transaction_data (FILE* out, QofBook* book, sixtp_gdv2* gd)
 {
+    QofTraceSpan span {"backend", "xml.write-template-transactions"};
     Account* ra;
     struct file_backend be_data;
+    GncXmlWriter writer {out};
 
     be_data.out = out;
     be_data.gd = gd;
+    be_data.writer = &writer;
 
     ra = gnc_book_get_template_root (book);
     if (gnc_account_n_descendants (ra) > 0)
@@ -1208,6 +1476,7 @@ write_template_transaction_data (FILE* out, QofBook* book, sixtp_gdv2* gd)
 static gboolean
 write_schedXactions (FILE* out, QofBook* book, sixtp_gdv2* gd)
 {
+    QofTraceSpan span {"backend", "xml.write-scheduled-transactions"};
     GList* schedXactions;
     SchedXaction* tmpSX;
     xmlNodePtr node;
@@ -1272,10 +1541,10 @@ write_namespace (const GncXmlDataType_t& data, FILE* out)
 }
 
 static gboolean
-write_v2_header (FILE* out)
+write_header_with_root (FILE* out, const char* root)
 {
     if (fprintf (out, "<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n") < 0
-        || fprintf (out, "<" GNC_V2_STRING) < 0
+        || fprintf (out, "<%s", root) < 0
 
         || !gnc_xml2_write_namespace_decl (out, "gnc")
         || !gnc_xml2_write_namespace_decl (out, "act")
@@ -1305,6 +1574,12 @@ write_v2_header (FILE* out)
     return TRUE;
 }
 
+static gboolean
+write_v2_header (FILE* out)
+{
+    return write_header_with_root (out, GNC_V2_STRING);
+}
+
 gboolean
 gnc_book_write_to_xml_filehandle_v2 (QofBook* book, FILE* out)
 {
@@ -1381,6 +1656,190 @@ gnc_book_write_accounts_to_xml_filehandle_v2 (QofBackend* qof_be, QofBook* book,
 }
 
 #define BUFLEN 4096
+/* Input size of each gzip member. The members are compressed on their own,
+ * so each one restarts with an empty dictionary; a large block keeps the
+ * cost of that to a fraction of a percent. */
+#define GZ_BLOCK_SIZE (1 << 20)
+
+struct gz_block
+{
+    std::string in;
+    std::string out;
+    gint level;
+    gboolean ok;
+    gboolean done;
+};
+
+static void
+gz_compress_block_job (gpointer data, gpointer user_data)
+{
+    auto block = static_cast<gz_block*> (data);
+    auto pipeline = static_cast<work_pipeline*> (user_data);
+    z_stream strm {};
+    gboolean ok;
+
+    /* windowBits + 16 makes deflate write a gzip header and trailer. */
+    ok = deflateInit2 (&strm, block->level, Z_DEFLATED, MAX_WBITS + 16, 8,
+                       Z_DEFAULT_STRATEGY) == Z_OK;
+    if (ok)
+    {
+        std::string out (deflateBound (&strm, block->in.size ()), '\0');
+        strm.next_in = reinterpret_cast<Bytef*> (&block->in[0]);
+        strm.avail_in = block->in.size ();
+        strm.next_out = reinterpret_cast<Bytef*> (&out[0]);
+        strm.avail_out = out.size ();
+        ok = deflate (&strm, Z_FINISH) == Z_STREAM_END;
+        out.resize (strm.total_out);
+        deflateEnd (&strm);
+        block->out.swap (out);
+    }
+
+    if (pipeline)
+        g_mutex_lock (&pipeline->mutex);
+    std::string ().swap (block->in);
+    block->ok = ok;
+    block->done = TRUE;
+    if (pipeline)
+    {
+        g_cond_broadcast (&pipeline->cond);
+        g_mutex_unlock (&pipeline->mutex);
+    }
+}
+
+/* Fill block->in from fd. Returns FALSE on a read error; *eof is set when
+ * the writer has closed its end of the pipe. */
+static gboolean
+gz_read_block (gint fd, gz_block* block, gboolean* eof)
+{
+    size_t got = 0;
+
+    block->in.resize (GZ_BLOCK_SIZE);
+    while (got < block->in.size ())
+    {
+        auto bytes = read (fd, &block->in[got], block->in.size () - got);
+        if (bytes > 0)
+            got += bytes;
+        else if (bytes == 0)
+        {
+            *eof = TRUE;
+            break;
+        }
+        else if (errno != EINTR)
+        {
+            g_warning ("Could not read from pipe. The error is '%s' (errno %d)",
+                       g_strerror (errno) ? g_strerror (errno) : "", errno);
+            return FALSE;
+        }
+    }
+    block->in.resize (got);
+    return TRUE;
+}
+
+/* Compress everything read from params->fd into a multi-member gzip file,
+ * pigz-style: each block becomes a complete gzip member compressed on a
+ * thread pool, and the members are written out in order. gzread and gunzip
+ * read concatenated members as one stream, so older versions can load the
+ * result. Returns 1 on success or 0 otherwise. */
+static gint
+gz_compress_parallel (gz_thread_params_t* params)
+{
+    std::deque<gz_block> blocks;
+    work_pipeline pipeline;
+    GError* error = NULL;
+    guint n_threads = g_get_num_processors ();
+    gboolean eof = FALSE;
+    gint success = 1;
+    gsize members = 0;
+    FILE* file;
+
+    file = g_fopen (params->filename, "wb");
+    if (file == NULL)
+    {
+        g_warning ("Child threads could not open '%s'", params->filename);
+        return 0;
+    }
+
+    g_mutex_init (&pipeline.mutex);
+    g_cond_init (&pipeline.cond);
+    auto pool = g_thread_pool_new (gz_compress_block_job, &pipeline,
+                                   n_threads, TRUE, &error);
+    if (!pool)
+    {
+        PWARN ("Unable to create thread pool, compressing serially: %s",
+               error->message);
+        g_error_free (error);
+    }
+
+    /* Keep a couple of blocks per thread in flight so the workers don't
+     * wait for the writer, without holding the whole file in memory. */
+    auto window = std::max (n_threads, 1u) * 2;
+    while (success)
+    {
+        while (!eof && blocks.size () < window)
+        {
+            blocks.emplace_back ();
+            auto& block = blocks.back ();
+            block.level = params->level;
+            block.done = FALSE;
+            if (!gz_read_block (params->fd, &block, &eof))
+            {
+                blocks.pop_back ();
+                success = 0;
+                break;
+            }
+            /* A final empty read only needs a member if there is no
+             * other, so that an empty file is still valid gzip. */
+            if (block.in.empty () && members)
+            {
+                blocks.pop_back ();
+                break;
+            }
+            ++members;
+            if (pool)
+                g_thread_pool_push (pool, &block, NULL);
+            else
+                gz_compress_block_job (&block, NULL);
+        }
+        if (!success || blocks.empty ())
+            break;
+
+        auto& block = blocks.front ();
+        g_mutex_lock (&pipeline.mutex);
+        while (!block.done)
+            g_cond_wait (&pipeline.cond, &pipeline.mutex);
+        g_mutex_unlock (&pipeline.mutex);
+
+        if (!block.ok)
+        {
+            g_warning ("Could not compress the data for '%s'", params->filename);
+            success = 0;
+        }
+        else if (fwrite (block.out.data (), 1, block.out.size (), file)
+                 != block.out.size ())
+        {
+            g_warning ("Could not write the compressed file '%s'. The error is: '%s' (%d)",
+                       params->filename, g_strerror (errno), errno);
+            success = 0;
+        }
+        blocks.pop_front ();
+    }
+
+    /* On failure drop the blocks nobody has started; wait for the rest
+     * since they point into the deque. */
+    if (pool)
+        g_thread_pool_free (pool, !success, TRUE);
+    g_mutex_clear (&pipeline.mutex);
+    g_cond_clear (&pipeline.cond);
+
+    if (fclose (file) != 0)
+    {
+        g_warning ("Could not close the compressed file '%s'", params->filename);
+        success = 0;
+    }
+    PINFO ("wrote %" G_GSIZE_FORMAT " gzip members at level %d on %u threads",
+           members, params->level, n_threads);
+    return success;
+}
 
 /* Compress or decompress function that is to be run in a separate thread.
  * Returns 1 on success or 0 otherwise, stuffed into a pointer type. */
@@ -1388,11 +1847,16 @@ static gpointer
 gz_thread_func (gz_thread_params_t* params)
 {
     gchar buffer[BUFLEN];
-    gssize bytes;
     gint gzval;
     gzFile file;
     gint success = 1;
 
+    if (params->compress)
+    {
+        success = gz_compress_parallel (params);
+        goto cleanup_gz_thread_func;
+    }
+
 #ifdef G_OS_WIN32
     {
         gchar* conv_name = g_win32_locale_filename_from_utf8 (params->filename);
@@ -1426,67 +1890,36 @@ gz_thread_func (gz_thread_params_t* params)
         goto cleanup_gz_thread_func;
     }
 
-    if (params->compress)
-    {
-        while (success)
-        {
-            bytes = read (params->fd, buffer, BUFLEN);
-            if (bytes > 0)
-            {
-                if (gzwrite (file, buffer, bytes) <= 0)
-                {
-                    gint errnum;
-                    const gchar* error = gzerror (file, &errnum);
-                    g_warning ("Could not write the compressed file '%s'. The error is: '%s' (%d)",
-                               params->filename, error, errnum);
-                    success = 0;
-                }
-            }
-            else if (bytes == 0)
-            {
-                break;
-            }
-            else
-            {
-                g_warning ("Could not read from pipe. The error is '%s' (errno %d)",
-                           g_strerror (errno) ? g_strerror (errno) : "", errno);
-                success = 0;
-            }
-        }
-    }
-    else
+    while (success)
     {
-        while (success)
+        gzval = gzread (file, buffer, BUFLEN);
+        if (gzval > 0)
         {
-            gzval = gzread (file, buffer, BUFLEN);
-            if (gzval > 0)
-            {
-                if (
+            if (
 #if COMPILER(MSVC)
-                    _write
+                _write
 #else
-                    write
+                write
 #endif
-                    (params->fd, buffer, gzval) < 0)
-                {
-                    g_warning ("Could not write to pipe. The error is '%s' (%d)",
-                               g_strerror (errno) ? g_strerror (errno) : "", errno);
-                    success = 0;
-                }
-            }
-            else if (gzval == 0)
+                (params->fd, buffer, gzval) < 0)
             {
-                break;
-            }
-            else
-            {
-                gint errnum;
-                const gchar* error = gzerror (file, &errnum);
-                g_warning ("Could not read from compressed file '%s'. The error is: '%s' (%d)",
-                           params->filename, error, errnum);
+                g_warning ("Could not write to pipe. The error is '%s' (%d)",
+                           g_strerror (errno) ? g_strerror (errno) : "", errno);
                 success = 0;
             }
         }
+        else if (gzval == 0)
+        {
+            break;
+        }
+        else
+        {
+            gint errnum;
+            const gchar* error = gzerror (file, &errnum);
+            g_warning ("Could not read from compressed file '%s'. The error is: '%s' (%d)",
+                       params->filename, error, errnum);
+            success = 0;
+        }
     }
 
     if ((gzval = gzclose (file)) != Z_OK)
@@ -1537,6 +1970,7 @@ try_gz_open (const char* filename, const char* perms, gboolean use_gzip,
         params->filename = g_strdup (filename);
         params->perms = g_strdup (perms);
         params->compress = compress;
+        params->level = gnc_prefs_get_file_compression_level ();
 
         thread = g_thread_new ("xml_thread", (GThreadFunc) gz_thread_func,
                                params);
@@ -1617,6 +2051,156 @@ gnc_book_write_to_xml_file_v2 (
     return success;
 }
 
+/* The journal.
+ *
+ * Between saves each committed transaction is appended to a journal next
+ * to the book, so that a crash loses nothing that was committed.  It is
+ * an XML document that is never closed: every record is a forget
+ * element naming the transaction, then the transaction as it now stands
+ * unless it was destroyed, then a marker comment.  Replay drops anything
+ * after the last marker, which is a record torn by the crash, closes the
+ * root element and runs the result through the normal parsers.  Records
+ * are whole states, so replaying one over a book that already has it
+ * does no harm.
+ */
+#define JOURNAL_ROOT_TAG "gnc-journal"
+#define JOURNAL_RECORD_END "<!-- end of record -->\n"
+static const char* JOURNAL_FORGET_TAG = "gnc:journal-forget";
+
+gboolean
+gnc_xml_journal_write_header (FILE* journal)
+{
+    return write_header_with_root (journal, JOURNAL_ROOT_TAG) &&
+           fflush (journal) == 0;
+}
+
+gboolean
+gnc_xml_journal_append_transaction (FILE* journal, Transaction* trn)
+{
+    GncXmlWriter writer;
+    char guidstr[GUID_ENCODING_LENGTH + 1];
+
+    guid_to_string_buff (xaccTransGetGUID (trn), guidstr);
+    writer.text_element (JOURNAL_FORGET_TAG, guidstr);
+    writer.newline ();
+    if (!qof_instance_get_destroying (trn))
+    {
+        gnc_transaction_xml_stream (writer, trn);
+        writer.newline ();
+    }
+    auto record = writer.release ();
+    record += JOURNAL_RECORD_END;
+
+    return fwrite (record.data (), 1, record.size (), journal) == record.size () &&
+           fflush (journal) == 0;
+}
+
+static gboolean
+journal_forget_end_handler (gpointer data_for_children,
+                            GSList* data_from_children, GSList* sibling_data,
+                            gpointer parent_data, gpointer global_data,
+                            gpointer* result, const gchar* tag)
+{
+    xmlNodePtr tree = (xmlNodePtr)data_for_children;
+    gxpf_data* gdata = (gxpf_data*)global_data;
+    sixtp_gdv2* gd = (sixtp_gdv2*)gdata->parsedata;
+
+    if (parent_data)
+        return TRUE;
+    if (!tag)
+        return TRUE;
+
+    g_return_val_if_fail (tree, FALSE);
+
+    auto guid = dom_tree_to_guid (tree);
+    if (!guid)
+    {
+        PERR ("bad guid in %s", tag);
+        return FALSE;
+    }
+    if (auto trn = xaccTransLookup (guid, gd->book))
+    {
+        xaccTransBeginEdit (trn);
+        xaccTransDestroy (trn);
+        xaccTransCommitEdit (trn);
+    }
+    guid_free (guid);
+    return TRUE;
+}
+
+static gboolean
+journal_callback (const char* tag, gpointer globaldata, gpointer data)
+{
+    sixtp_gdv2* gd = (sixtp_gdv2*)globaldata;
+
+    if (g_strcmp0 (tag, TRANSACTION_TAG) == 0)
+        add_transaction_local (gd, (Transaction*)data);
+    else
+        PWARN ("unexpected tag %s", tag);
+    return TRUE;
+}
+
+gint
+gnc_xml_journal_replay (QofBook* book, const char* filename)
+{
+    gchar* contents = NULL;
+    gsize length = 0;
+    GError* error = NULL;
+    gpointer parse_result = NULL;
+    gxpf_data gpdata;
+    gint replayed = -1;
+
+    if (!g_file_get_contents (filename, &contents, &length, &error))
+    {
+        PWARN ("Unable to read journal %s: %s", filename, error->message);
+        g_error_free (error);
+        return -1;
+    }
+
+    std::string buf {contents, length};
+    g_free (contents);
+    auto end = buf.rfind (JOURNAL_RECORD_END);
+    if (end == std::string::npos)
+        return 0;
+    buf.resize (end + strlen (JOURNAL_RECORD_END));
+    buf += "</" JOURNAL_ROOT_TAG ">\n";
+
+    auto top_parser = sixtp_new ();
+    auto root_parser = sixtp_new ();
+    if (!sixtp_add_some_sub_parsers (
+            top_parser, TRUE,
+            JOURNAL_ROOT_TAG, root_parser,
+            NULL, NULL)
+        || !sixtp_add_some_sub_parsers (
+            root_parser, TRUE,
+            JOURNAL_FORGET_TAG, sixtp_dom_parser_new (journal_forget_end_handler,
+                                                      NULL, NULL),
+            TRANSACTION_TAG, gnc_transaction_sixtp_parser_create (),
+            NULL, NULL))
+    {
+        sixtp_destroy (top_parser);
+        return -1;
+    }
+
+    auto gd = gnc_sixtp_gdv2_new (book, FALSE, NULL, NULL);
+    gpdata.cb = journal_callback;
+    gpdata.parsedata = gd;
+    gpdata.bookdata = book;
+
+    /* The original commits went to the log already. */
+    xaccLogDisable ();
+    if (sixtp_parse_buffer (top_parser, &buf[0], buf.size (), NULL, &gpdata,
+                            &parse_result))
+        replayed = gd->counter.transactions_loaded;
+    else
+        PWARN ("Unable to replay journal %s", filename);
+    xaccLogEnable ();
+
+    sixtp_destroy (top_parser);
+    g_free (gd);
+    return replayed;
+}
+
 /*
  * Have to pass in the backend as this routine needs the temporary
  * backend for file export, not the real backend which could be
@@ -172,5 +172,14 @@ typedef struct
 } GncXmlDataType_t;
 
 void gnc_xml_register_backend(GncXmlDataType_t&);
+
+/** Start a new journal file. */
+gboolean gnc_xml_journal_write_header (FILE* journal);
+/** Append a committed or destroyed transaction to the journal and flush
+ * it to the OS. */
+gboolean gnc_xml_journal_append_transaction (FILE* journal, Transaction* trn);
+/** Apply a journal to a freshly loaded book. Returns the number of
+ * transactions restored, or -1 if the journal couldn't be read. */
+gint gnc_xml_journal_replay (QofBook* book, const char* filename);
 #endif /* __cplusplus */
 #endif /* __IO_GNCXML_V2_H__ */
@@ -87,5 +87,6 @@ write_account_tree (FILE* out, Account* root, sixtp_gdv2* gd)
 gboolean
 write_accounts (FILE* out, QofBook* book, sixtp_gdv2* gd)
 {
+    QofTraceSpan span {"backend", "xml.write-accounts"};
     return write_account_tree (out, gnc_book_get_root_account (book), gd);
 }
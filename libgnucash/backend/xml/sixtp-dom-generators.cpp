@@ -36,6 +36,7 @@ extern "C"
 #include "sixtp-utils.h"
 
 #include <kvp-frame.hpp>
+#include <qofinstance-p.h>
 #include <gnc-datetime.hpp>
 
 static QofLogModule log_module = GNC_MOD_IO;
@@ -172,19 +173,16 @@ xmlNodePtr
 gnc_numeric_to_dom_tree (const char* tag, const gnc_numeric* num)
 {
     xmlNodePtr ret;
-    gchar* numstr;
+    gchar numstr[GNC_NUMERIC_STRING_LENGTH + 1];
 
     g_return_val_if_fail (num, NULL);
 
-    numstr = gnc_numeric_to_string (*num);
-    g_return_val_if_fail (numstr, NULL);
+    gnc_numeric_to_string_buff (*num, numstr);
 
     ret = xmlNewNode (NULL, BAD_CAST tag);
 
     xmlNodeAddContent (ret, checked_char_cast (numstr));
 
-    g_free (numstr);
-
     return ret;
 }
 
@@ -329,11 +327,199 @@ qof_instance_slots_to_dom_tree (const char* tag, const QofInstance* inst)
     xmlNodePtr ret;
     const char** keys;
     unsigned int i;
-    KvpFrame* frame = qof_instance_get_slots (inst);
-    if (!frame || frame->empty())
+    /* Don't make the instance allocate a frame just to find it empty. */
+    if (!qof_instance_has_kvp (const_cast<QofInstance*> (inst)))
         return nullptr;
+    KvpFrame* frame = qof_instance_get_slots (inst);
 
     ret = xmlNewNode (nullptr, BAD_CAST tag);
     frame->for_each_slot_temp (&add_kvp_slot, ret);
     return ret;
 }
+
+/* Streaming writers. Keep these in step with the DOM generators above: the
+ * file must not change depending on which path wrote it. */
+
+void
+guid_to_xml_stream (GncXmlWriter& writer, const char* tag, const GncGUID* gid)
+{
+    char guid_str[GUID_ENCODING_LENGTH + 1];
+
+    if (!guid_to_string_buff (gid, guid_str))
+    {
+        PERR ("guid_to_string_buff failed\n");
+        return;
+    }
+    writer.start_element (tag);
+    writer.attribute ("type", "guid");
+    writer.text (guid_str);
+    writer.end_element ();
+}
+
+void
+commodity_ref_to_xml_stream (GncXmlWriter& writer, const char* tag,
+                             const gnc_commodity* c)
+{
+    g_return_if_fail (c);
+
+    auto name_space = gnc_commodity_get_namespace (c);
+    auto mnemonic = gnc_commodity_get_mnemonic (c);
+    if (!name_space || !mnemonic)
+        return;
+    writer.start_element (tag);
+    writer.text_element ("cmdty:space", name_space);
+    writer.text_element ("cmdty:id", mnemonic);
+    writer.end_element ();
+}
+
+static void
+time64_to_xml_stream_typed (GncXmlWriter& writer, const char* tag,
+                            const time64 time, const char* type)
+{
+    g_return_if_fail (time != INT64_MAX);
+    auto date_str = GncDateTime(time).format_iso8601();
+    if (date_str.empty())
+        return;
+    date_str += " +0000"; //Tack on a UTC offset to mollify GnuCash for Android
+    writer.start_element (tag);
+    if (type)
+        writer.attribute ("type", type);
+    writer.text_element ("ts:date", date_str.c_str ());
+    writer.end_element ();
+}
+
+void
+time64_to_xml_stream (GncXmlWriter& writer, const char* tag, const time64 time)
+{
+    time64_to_xml_stream_typed (writer, tag, time, nullptr);
+}
+
+void
+gnc_numeric_to_xml_stream (GncXmlWriter& writer, const char* tag,
+                           const gnc_numeric* num)
+{
+    gchar numstr[GNC_NUMERIC_STRING_LENGTH + 1];
+
+    g_return_if_fail (num);
+
+    gnc_numeric_to_string_buff (*num, numstr);
+    writer.text_element (tag, numstr);
+}
+
+static void
+add_typed_text_to_stream (GncXmlWriter& writer, const gchar* tag,
+                          const gchar* type, const gchar* val)
+{
+    writer.start_element (tag);
+    writer.attribute ("type", type);
+    if (val)
+        writer.text (val);
+    writer.end_element ();
+}
+
+static void add_kvp_slot_to_stream (const char* key, KvpValue* value,
+                                    void* data);
+
+static void
+add_kvp_value_to_stream (GncXmlWriter& writer, const gchar* tag,
+                         KvpValue* val)
+{
+    switch (val->get_type ())
+    {
+    case KvpValue::Type::INT64:
+        add_typed_text_to_stream (writer, tag, "integer",
+                                  std::to_string (val->get<int64_t> ()).c_str ());
+        break;
+    case KvpValue::Type::DOUBLE:
+    {
+        auto numstr = double_to_string (val->get<double> ());
+        add_typed_text_to_stream (writer, tag, "double", numstr);
+        g_free (numstr);
+        break;
+    }
+    case KvpValue::Type::NUMERIC:
+    {
+        gchar numstr[GNC_NUMERIC_STRING_LENGTH + 1];
+        gnc_numeric_to_string_buff (val->get<gnc_numeric> (), numstr);
+        add_typed_text_to_stream (writer, tag, "numeric", numstr);
+        break;
+    }
+    case KvpValue::Type::STRING:
+        add_typed_text_to_stream (writer, tag, "string",
+                                  val->get<const char*> ());
+        break;
+    case KvpValue::Type::GUID:
+    {
+        gchar guidstr[GUID_ENCODING_LENGTH + 1];
+        auto ok = guid_to_string_buff (val->get<GncGUID*> (), guidstr);
+        add_typed_text_to_stream (writer, tag, "guid", ok ? guidstr : nullptr);
+        break;
+    }
+    /* Note: The type attribute must remain 'timespec' to maintain
+     * compatibility.
+     */
+    case KvpValue::Type::TIME64:
+        time64_to_xml_stream_typed (writer, tag, val->get<Time64> ().t,
+                                    "timespec");
+        break;
+    case KvpValue::Type::GDATE:
+    {
+        gchar date_str[512];
+        auto d = val->get<GDate> ();
+        g_date_strftime (date_str, sizeof (date_str), "%Y-%m-%d", &d);
+        writer.start_element (tag);
+        writer.attribute ("type", "gdate");
+        writer.text_element ("gdate", date_str);
+        writer.end_element ();
+        break;
+    }
+    case KvpValue::Type::GLIST:
+        writer.start_element (tag);
+        writer.attribute ("type", "list");
+        for (auto cursor = val->get<GList*> (); cursor; cursor = cursor->next)
+        {
+            auto val = static_cast<KvpValue*> (cursor->data);
+            add_kvp_value_to_stream (writer, "slot:value", val);
+        }
+        writer.end_element ();
+        break;
+    case KvpValue::Type::FRAME:
+    {
+        writer.start_element (tag);
+        writer.attribute ("type", "frame");
+        auto frame = val->get<KvpFrame*> ();
+        if (frame)
+            frame->for_each_slot_temp (&add_kvp_slot_to_stream, &writer);
+        writer.end_element ();
+        break;
+    }
+    default:
+        writer.start_element (tag);
+        writer.end_element ();
+        break;
+    }
+}
+
+static void
+add_kvp_slot_to_stream (const char* key, KvpValue* value, void* data)
+{
+    auto& writer = *static_cast<GncXmlWriter*> (data);
+
+    writer.start_element ("slot");
+    writer.text_element ("slot:key", key);
+    add_kvp_value_to_stream (writer, "slot:value", value);
+    writer.end_element ();
+}
+
+void
+qof_instance_slots_to_xml_stream (GncXmlWriter& writer, const char* tag,
+                                  const QofInstance* inst)
+{
+    if (!qof_instance_has_kvp (const_cast<QofInstance*> (inst)))
+        return;
+    KvpFrame* frame = qof_instance_get_slots (inst);
+
+    writer.start_element (tag);
+    frame->for_each_slot_temp (&add_kvp_slot_to_stream, &writer);
+    writer.end_element ();
+}
@@ -34,6 +34,7 @@ extern "C"
 }
 
 #include "gnc-xml-helper.h"
+#include "gnc-xml-writer.h"
 
 xmlNodePtr text_to_dom_tree (const char* tag, const char* str);
 xmlNodePtr int_to_dom_tree (const char* tag, gint64 val);
@@ -50,4 +51,16 @@ xmlNodePtr recurrence_to_dom_tree (const gchar* tag, const Recurrence* r);
 
 gchar* double_to_string (double value);
 
+/* Streaming counterparts of the generators above; each writes exactly
+ * what xmlElemDump would for the tree its DOM twin returns. */
+void guid_to_xml_stream (GncXmlWriter& writer, const char* tag,
+                         const GncGUID* gid);
+void commodity_ref_to_xml_stream (GncXmlWriter& writer, const char* tag,
+                                  const gnc_commodity* c);
+void time64_to_xml_stream (GncXmlWriter& writer, const char* tag, time64);
+void gnc_numeric_to_xml_stream (GncXmlWriter& writer, const char* tag,
+                                const gnc_numeric* num);
+void qof_instance_slots_to_xml_stream (GncXmlWriter& writer, const char* tag,
+                                       const QofInstance* inst);
+
 #endif /* _SIXTP_DOM_GENERATORS_H_ */
@@ -36,6 +36,9 @@ extern "C"
 #include "sixtp-dom-parsers.h"
 #include <kvp-frame.hpp>
 
+#include <string>
+#include <unordered_map>
+
 static QofLogModule log_module = GNC_MOD_IO;
 
 GncGUID*
@@ -672,26 +675,19 @@ failure:
 }
 
 
-gnc_commodity*
-dom_tree_to_commodity_ref_no_engine (xmlNodePtr node, QofBook* book)
+/* Reads the cmdty:space and cmdty:id children of a commodity reference into
+ * space_str and id_str, which the caller must g_free. Both sub-nodes are
+ * required, though for now, order is irrelevant. */
+static gboolean
+dom_tree_to_commodity_names (xmlNodePtr node, gchar** space_str,
+                             gchar** id_str)
 {
-    /* Turn something like this
-
-       <currency>
-         <cmdty:space>NASDAQ</cmdty:space>
-         <cmdty:id>LNUX</cmdty:space>
-       </currency>
-
-       into a gnc_commodity*, returning NULL on failure.  Both sub-nodes
-       are required, though for now, order is irrelevant. */
-
-    gnc_commodity* c = NULL;
-    gchar* space_str = NULL;
-    gchar* id_str = NULL;
     xmlNodePtr n;
 
-    if (!node) return NULL;
-    if (!node->xmlChildrenNode) return NULL;
+    *space_str = NULL;
+    *id_str = NULL;
+    if (!node) return FALSE;
+    if (!node->xmlChildrenNode) return FALSE;
 
     for (n = node->xmlChildrenNode; n; n = n->next)
     {
@@ -703,47 +699,61 @@ dom_tree_to_commodity_ref_no_engine (xmlNodePtr node, QofBook* book)
         case XML_ELEMENT_NODE:
             if (g_strcmp0 ("cmdty:space", (char*)n->name) == 0)
             {
-                if (space_str)
-                {
-                    return NULL;
-                }
-                else
-                {
-                    gchar* content = dom_tree_to_text (n);
-                    if (!content) return NULL;
-                    space_str = content;
-                }
+                if (*space_str)
+                    goto fail;
+                *space_str = dom_tree_to_text (n);
+                if (!*space_str)
+                    goto fail;
             }
             else if (g_strcmp0 ("cmdty:id", (char*)n->name) == 0)
             {
-                if (id_str)
-                {
-                    return NULL;
-                }
-                else
-                {
-                    gchar* content = dom_tree_to_text (n);
-                    if (!content) return NULL;
-                    id_str = content;
-                }
+                if (*id_str)
+                    goto fail;
+                *id_str = dom_tree_to_text (n);
+                if (!*id_str)
+                    goto fail;
             }
             break;
         default:
             PERR ("unexpected sub-node.");
-            return NULL;
-            break;
+            goto fail;
         }
     }
-    if (! (space_str && id_str))
-    {
-        c = NULL;
-    }
-    else
-    {
-        g_strstrip (space_str);
-        g_strstrip (id_str);
-        c = gnc_commodity_new (book, NULL, space_str, id_str, NULL, 0);
-    }
+    if (! (*space_str && *id_str))
+        goto fail;
+
+    g_strstrip (*space_str);
+    g_strstrip (*id_str);
+    return TRUE;
+
+fail:
+    g_free (*space_str);
+    g_free (*id_str);
+    *space_str = NULL;
+    *id_str = NULL;
+    return FALSE;
+}
+
+gnc_commodity*
+dom_tree_to_commodity_ref_no_engine (xmlNodePtr node, QofBook* book)
+{
+    /* Turn something like this
+
+       <currency>
+         <cmdty:space>NASDAQ</cmdty:space>
+         <cmdty:id>LNUX</cmdty:space>
+       </currency>
+
+       into a gnc_commodity*, returning NULL on failure. */
+
+    gnc_commodity* c;
+    gchar* space_str;
+    gchar* id_str;
+
+    if (!dom_tree_to_commodity_names (node, &space_str, &id_str))
+        return NULL;
+
+    c = gnc_commodity_new (book, NULL, space_str, id_str, NULL, 0);
 
     g_free (space_str);
     g_free (id_str);
@@ -751,24 +761,73 @@ dom_tree_to_commodity_ref_no_engine (xmlNodePtr node, QofBook* book)
     return c;
 }
 
+#define COMMODITY_INTERN_KEY "gnc-xml-commodity-intern"
+
+/* The commodities found by dom_tree_to_commodity_ref while a file is loaded,
+ * by "namespace::mnemonic". */
+using CommodityInternMap = std::unordered_map<std::string, gnc_commodity*>;
+
+void
+dom_tree_commodity_intern_begin (QofBook* book)
+{
+    g_return_if_fail (book != NULL);
+    dom_tree_commodity_intern_end (book);
+    qof_book_set_data (book, COMMODITY_INTERN_KEY, new CommodityInternMap);
+}
+
+void
+dom_tree_commodity_intern_end (QofBook* book)
+{
+    g_return_if_fail (book != NULL);
+    auto interned = static_cast<CommodityInternMap*>
+        (qof_book_get_data (book, COMMODITY_INTERN_KEY));
+    if (!interned)
+        return;
+    qof_book_set_data (book, COMMODITY_INTERN_KEY, NULL);
+    delete interned;
+}
+
+/* Looks the reference up by its names rather than building a temporary
+ * commodity to compare against the table. */
 gnc_commodity*
 dom_tree_to_commodity_ref (xmlNodePtr node, QofBook* book)
 {
-    gnc_commodity* daref;
     gnc_commodity* ret;
     gnc_commodity_table* table;
-
-    daref = dom_tree_to_commodity_ref_no_engine (node, book);
+    gchar* space_str;
+    gchar* id_str;
 
     table = gnc_commodity_table_get_table (book);
 
     g_return_val_if_fail (table != NULL, NULL);
 
-    ret =  gnc_commodity_table_lookup (table,
-                                       gnc_commodity_get_namespace (daref),
-                                       gnc_commodity_get_mnemonic (daref));
+    if (!dom_tree_to_commodity_names (node, &space_str, &id_str))
+    {
+        PERR ("invalid commodity reference.");
+        return NULL;
+    }
 
-    gnc_commodity_destroy (daref);
+    auto interned = static_cast<CommodityInternMap*>
+        (qof_book_get_data (book, COMMODITY_INTERN_KEY));
+    std::string key;
+    if (interned)
+    {
+        key = std::string{space_str} + "::" + id_str;
+        auto iter = interned->find (key);
+        if (iter != interned->end ())
+        {
+            g_free (space_str);
+            g_free (id_str);
+            return iter->second;
+        }
+    }
+
+    ret = gnc_commodity_table_lookup (table, space_str, id_str);
+    if (interned && ret)
+        interned->emplace (std::move (key), ret);
+
+    g_free (space_str);
+    g_free (id_str);
 
     g_return_val_if_fail (ret != NULL, NULL);
 
@@ -38,6 +38,11 @@ GncGUID* dom_tree_to_guid (xmlNodePtr node);
 
 gnc_commodity* dom_tree_to_commodity_ref (xmlNodePtr node, QofBook* book);
 gnc_commodity* dom_tree_to_commodity_ref_no_engine (xmlNodePtr node, QofBook*);
+/** Between these, dom_tree_to_commodity_ref() remembers each commodity it
+ *  finds in book's table, so that the many references to the same few
+ *  commodities in a file are looked up once each.  For use around a load. */
+void dom_tree_commodity_intern_begin (QofBook* book);
+void dom_tree_commodity_intern_end (QofBook* book);
 
 GList* dom_tree_freqSpec_to_recurrences (xmlNodePtr node, QofBook* book);
 Recurrence* dom_tree_to_recurrence (xmlNodePtr node);
@@ -41,6 +41,9 @@ extern "C"
 #include "sixtp-parsers.h"
 #include "sixtp-stack.h"
 
+#include <string>
+#include <vector>
+
 #undef G_LOG_DOMAIN
 #define G_LOG_DOMAIN "gnc.backend.file.sixtp"
 
@@ -383,12 +386,27 @@ sixtp_add_some_sub_parsers (sixtp* tochange, int cleanup, ...)
 
 /************************************************************************/
 
+static void sixtp_sax_start_at (sixtp_sax_data* pdata, const xmlChar* name,
+                                const xmlChar** attrs, int line, int col);
+
 void
 sixtp_sax_start_handler (void* user_data,
                          const xmlChar* name,
                          const xmlChar** attrs)
 {
     sixtp_sax_data* pdata = (sixtp_sax_data*) user_data;
+
+    sixtp_sax_start_at (pdata, name, attrs,
+                        xmlSAX2GetLineNumber (pdata->saxParserCtxt),
+                        xmlSAX2GetColumnNumber (pdata->saxParserCtxt));
+}
+
+/* The body of the start handler, taking the position in the document
+ * separately so that recorded events can be replayed. */
+static void
+sixtp_sax_start_at (sixtp_sax_data* pdata, const xmlChar* name,
+                    const xmlChar** attrs, int line, int col)
+{
     sixtp_stack_frame* current_frame = NULL;
     sixtp* current_parser = NULL;
     sixtp* next_parser = NULL;
@@ -452,8 +470,8 @@ sixtp_sax_start_handler (void* user_data,
     /* now allocate the new stack frame and shift to it */
     new_frame = sixtp_stack_frame_new (next_parser, g_strdup ((char*) name));
 
-    new_frame->line = xmlSAX2GetLineNumber (pdata->saxParserCtxt);
-    new_frame->col  = xmlSAX2GetColumnNumber (pdata->saxParserCtxt);
+    new_frame->line = line;
+    new_frame->col  = col;
 
     pdata->stack = g_slist_prepend (pdata->stack, (gpointer) new_frame);
 
@@ -780,6 +798,265 @@ sixtp_parser_read (void* context, char* buffer, int len)
     return ret;
 }
 
+/* Pipelined parsing.
+ *
+ * libxml2's tokenizing -- decoding, entity expansion, well-formedness
+ * checks -- is independent of what the sixtp handlers do with the
+ * elements, so sixtp_parse_fd runs it on a helper thread.  The thread
+ * records the SAX events into batches and the calling thread replays them
+ * through the usual handlers, which build the engine objects.  The engine
+ * is only ever touched from the calling thread.  A fixed set of batches is
+ * recycled between the two, which bounds the memory held by events the
+ * handlers haven't caught up with.  Together with the (de)compression
+ * thread behind a gzipped fd that makes three stages.
+ */
+
+#define SIXTP_EVENT_BATCH_SIZE (256 * 1024)
+#define SIXTP_EVENT_BATCHES 8
+
+enum class SaxEvent : char { START, CHARS, END };
+
+struct sixtp_event_batch
+{
+    std::string events;
+    /* Set on the batch that follows the end of the document. */
+    gboolean last;
+    int parse_ret;
+};
+
+struct sixtp_event_recorder
+{
+    xmlParserCtxtPtr context;
+    GAsyncQueue* full;
+    GAsyncQueue* empty;
+    sixtp_event_batch* batch;
+};
+
+static void
+recorder_put_int (std::string& events, int value)
+{
+    events.append (reinterpret_cast<const char*> (&value), sizeof (value));
+}
+
+static void
+recorder_put_string (std::string& events, const xmlChar* str)
+{
+    /* Keep the terminator so replay can point straight into the batch. */
+    events.append (reinterpret_cast<const char*> (str),
+                   strlen (reinterpret_cast<const char*> (str)) + 1);
+}
+
+static void
+recorder_maybe_flush (sixtp_event_recorder* rec)
+{
+    if (rec->batch->events.size () < SIXTP_EVENT_BATCH_SIZE)
+        return;
+    g_async_queue_push (rec->full, rec->batch);
+    rec->batch = static_cast<sixtp_event_batch*> (g_async_queue_pop (rec->empty));
+}
+
+static void
+recorder_start_handler (void* user_data, const xmlChar* name,
+                        const xmlChar** attrs)
+{
+    auto rec = static_cast<sixtp_event_recorder*> (user_data);
+    auto& events = rec->batch->events;
+    int n_attrs = 0;
+
+    for (auto atptr = attrs; atptr && *atptr; atptr += 2)
+        ++n_attrs;
+    events += static_cast<char> (SaxEvent::START);
+    recorder_put_int (events, xmlSAX2GetLineNumber (rec->context));
+    recorder_put_int (events, xmlSAX2GetColumnNumber (rec->context));
+    recorder_put_int (events, n_attrs);
+    recorder_put_string (events, name);
+    for (auto atptr = attrs; atptr && *atptr; atptr += 2)
+    {
+        recorder_put_string (events, atptr[0]);
+        recorder_put_string (events, atptr[1] ? atptr[1] : BAD_CAST "");
+    }
+    recorder_maybe_flush (rec);
+}
+
+static void
+recorder_characters_handler (void* user_data, const xmlChar* text, int len)
+{
+    auto rec = static_cast<sixtp_event_recorder*> (user_data);
+    auto& events = rec->batch->events;
+
+    events += static_cast<char> (SaxEvent::CHARS);
+    recorder_put_int (events, len);
+    events.append (reinterpret_cast<const char*> (text), len);
+    recorder_maybe_flush (rec);
+}
+
+static void
+recorder_end_handler (void* user_data, const xmlChar* name)
+{
+    auto rec = static_cast<sixtp_event_recorder*> (user_data);
+    auto& events = rec->batch->events;
+
+    events += static_cast<char> (SaxEvent::END);
+    recorder_put_string (events, name);
+    recorder_maybe_flush (rec);
+}
+
+static gpointer
+recorder_thread_func (gpointer data)
+{
+    auto rec = static_cast<sixtp_event_recorder*> (data);
+
+    rec->batch = static_cast<sixtp_event_batch*> (g_async_queue_pop (rec->empty));
+    auto parse_ret = xmlParseDocument (rec->context);
+    rec->batch->last = TRUE;
+    rec->batch->parse_ret = parse_ret;
+    g_async_queue_push (rec->full, rec->batch);
+    return NULL;
+}
+
+static int
+replay_get_int (const char** cursor)
+{
+    int value;
+    memcpy (&value, *cursor, sizeof (value));
+    *cursor += sizeof (value);
+    return value;
+}
+
+static const xmlChar*
+replay_get_string (const char** cursor)
+{
+    auto str = *cursor;
+    *cursor += strlen (str) + 1;
+    return BAD_CAST str;
+}
+
+static void
+replay_events (sixtp_sax_data* pdata, const std::string& events,
+               std::vector<const xmlChar*>& attrs)
+{
+    auto cursor = events.data ();
+    auto end = cursor + events.size ();
+
+    while (cursor < end)
+    {
+        switch (static_cast<SaxEvent> (*cursor++))
+        {
+        case SaxEvent::START:
+        {
+            auto line = replay_get_int (&cursor);
+            auto col = replay_get_int (&cursor);
+            auto n_attrs = replay_get_int (&cursor);
+            auto name = replay_get_string (&cursor);
+            attrs.clear ();
+            for (int i = 0; i < 2 * n_attrs; ++i)
+                attrs.push_back (replay_get_string (&cursor));
+            attrs.push_back (NULL);
+            sixtp_sax_start_at (pdata, name, n_attrs ? attrs.data () : NULL,
+                                line, col);
+            break;
+        }
+        case SaxEvent::CHARS:
+        {
+            auto len = replay_get_int (&cursor);
+            sixtp_sax_characters_handler (pdata, BAD_CAST cursor, len);
+            cursor += len;
+            break;
+        }
+        case SaxEvent::END:
+            sixtp_sax_end_handler (pdata, replay_get_string (&cursor));
+            break;
+        }
+    }
+}
+
+/* Runs xml_context, which the caller has created, on the helper thread. */
+static gboolean
+sixtp_parse_pipelined (sixtp* sixtp,
+                       xmlParserCtxtPtr xml_context,
+                       gpointer data_for_top_level,
+                       gpointer global_data,
+                       gpointer* parse_result)
+{
+    sixtp_parser_context* ctxt;
+    sixtp_event_recorder rec;
+    xmlSAXHandler handler;
+    sixtp_event_batch batches[SIXTP_EVENT_BATCHES];
+    std::vector<const xmlChar*> attrs;
+    int parse_ret = -1;
+
+    memset (&handler, 0, sizeof (handler));
+    handler.startElement = recorder_start_handler;
+    handler.endElement = recorder_end_handler;
+    handler.characters = recorder_characters_handler;
+    handler.getEntity = sixtp_sax_get_entity_handler;
+
+    if (!xml_context)
+    {
+        g_critical ("Unable to create the xml parser context");
+        return FALSE;
+    }
+    rec.context = xml_context;
+    rec.context->sax = &handler;
+    rec.context->userData = &rec;
+    rec.batch = NULL;
+    if (! (ctxt = sixtp_context_new (sixtp, global_data, data_for_top_level)))
+    {
+        g_critical ("sixtp_context_new returned null");
+        xmlFreeParserCtxt (rec.context);
+        return FALSE;
+    }
+
+    rec.full = g_async_queue_new ();
+    rec.empty = g_async_queue_new ();
+    for (auto& batch : batches)
+    {
+        batch.events.reserve (SIXTP_EVENT_BATCH_SIZE + BUFSIZ);
+        batch.last = FALSE;
+        g_async_queue_push (rec.empty, &batch);
+    }
+    /* sixtp_context_destroy frees it once both threads are done. */
+    ctxt->data.saxParserCtxt = rec.context;
+    ctxt->data.bad_xml_parser = sixtp_dom_parser_new (gnc_bad_xml_end_handler,
+                                                      NULL, NULL);
+
+    auto thread = g_thread_new ("xml_parse", recorder_thread_func, &rec);
+    while (TRUE)
+    {
+        auto batch = static_cast<sixtp_event_batch*> (g_async_queue_pop (rec.full));
+        replay_events (&ctxt->data, batch->events, attrs);
+        batch->events.clear ();
+        if (batch->last)
+        {
+            parse_ret = batch->parse_ret;
+            g_thread_join (thread);
+            break;
+        }
+        g_async_queue_push (rec.empty, batch);
+    }
+    g_async_queue_unref (rec.full);
+    g_async_queue_unref (rec.empty);
+
+    sixtp_context_run_end_handler (ctxt);
+
+    if (parse_ret == 0 && ctxt->data.parsing_ok)
+    {
+        if (parse_result)
+            *parse_result = ctxt->top_frame->frame_data;
+        sixtp_context_destroy (ctxt);
+        return TRUE;
+    }
+    else
+    {
+        if (parse_result)
+            *parse_result = NULL;
+        if (g_slist_length (ctxt->data.stack) > 1)
+            sixtp_handle_catastrophe (&ctxt->data);
+        sixtp_context_destroy (ctxt);
+        return FALSE;
+    }
+}
+
 gboolean
 sixtp_parse_fd (sixtp* sixtp,
                 FILE* fd,
@@ -787,12 +1064,55 @@ sixtp_parse_fd (sixtp* sixtp,
                 gpointer global_data,
                 gpointer* parse_result)
 {
-    gboolean ret;
     xmlParserCtxtPtr context = xmlCreateIOParserCtxt (NULL, NULL,
                                                       sixtp_parser_read, NULL /*no close */, fd,
                                                       XML_CHAR_ENCODING_NONE);
-    ret = sixtp_parse_file_common (sixtp, context, data_for_top_level,
-                                   global_data, parse_result);
+    return sixtp_parse_pipelined (sixtp, context, data_for_top_level,
+                                  global_data, parse_result);
+}
+
+gboolean
+sixtp_parse_mapped_file (sixtp* sixtp,
+                         const char* filename,
+                         gpointer data_for_top_level,
+                         gpointer global_data,
+                         gpointer* parse_result)
+{
+    GError* error = NULL;
+    gboolean ret;
+    auto mapped = g_mapped_file_new (filename, FALSE, &error);
+
+    /* libxml2 takes an int size; anything it can't map goes through
+     * stdio instead. */
+    if (!mapped || g_mapped_file_get_length (mapped) == 0 ||
+        g_mapped_file_get_length (mapped) > G_MAXINT)
+    {
+        if (error)
+        {
+            g_message ("Unable to map %s: %s", filename, error->message);
+            g_error_free (error);
+        }
+        if (mapped)
+            g_mapped_file_unref (mapped);
+
+        auto fd = g_fopen (filename, "rb");
+        if (!fd)
+        {
+            g_warning ("Unable to open %s", filename);
+            return FALSE;
+        }
+        ret = sixtp_parse_fd (sixtp, fd, data_for_top_level, global_data,
+                              parse_result);
+        fclose (fd);
+        return ret;
+    }
+    /* libxml2 reads straight from the mapping, so neither a read buffer
+     * nor the pipe through the FILE* is involved. */
+    auto context = xmlCreateMemoryParserCtxt (g_mapped_file_get_contents (mapped),
+                                              g_mapped_file_get_length (mapped));
+    ret = sixtp_parse_pipelined (sixtp, context, data_for_top_level,
+                                 global_data, parse_result);
+    g_mapped_file_unref (mapped);
     return ret;
 }
 
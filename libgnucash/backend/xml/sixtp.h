@@ -227,6 +227,11 @@ gboolean sixtp_parse_file (sixtp* sixtp, const char* filename,
 gboolean sixtp_parse_fd (sixtp* sixtp, FILE* fd,
                          gpointer data_for_top_level, gpointer global_data,
                          gpointer* parse_result);
+/** Parses an uncompressed file by mapping it into memory. */
+gboolean sixtp_parse_mapped_file (sixtp* sixtp, const char* filename,
+                                  gpointer data_for_top_level,
+                                  gpointer global_data,
+                                  gpointer* parse_result);
 gboolean sixtp_parse_buffer (sixtp* sixtp, char* bufp, int bufsz,
                              gpointer data_for_top_level, gpointer global_data,
                              gpointer* parse_result);
@@ -0,0 +1,120 @@
+/***************************************************************************
+ *            test-xml-journal.cpp
+ *
+ *  Tests that a session which doesn't hold the lock on a book leaves
+ *  the book's journal alone.
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *  02110-1301, USA.
+ */
+#include <glib.h>
+#include <glib/gstdio.h>
+
+extern "C"
+{
+#include <config.h>
+#include <stdlib.h>
+
+#include <cashobjects.h>
+#include <TransLog.h>
+#include <gnc-engine.h>
+}
+
+#include <test-stuff.h>
+
+#define GNC_LIB_NAME "gncmod-backend-xml"
+#define GNC_LIB_REL_PATH "xml"
+
+static const char* journal_text = "committed but not saved\n";
+
+static void
+open_and_end (const char* filename, SessionOpenMode mode, bool mark_readonly)
+{
+    auto session = qof_session_new (nullptr);
+    qof_session_begin (session, filename, mode);
+    if (qof_session_get_error (session) == ERR_BACKEND_NO_ERR)
+    {
+        qof_session_load (session, NULL);
+        /* As gnc-file.c does when the user picks "Open Read-Only". */
+        if (mark_readonly)
+            qof_book_mark_readonly (qof_session_get_book (session));
+    }
+    qof_session_end (session);
+    qof_session_destroy (session);
+}
+
+static void
+check_journal (const char* journal, const char* msg)
+{
+    char* contents = nullptr;
+    do_test (g_file_get_contents (journal, &contents, nullptr, nullptr) &&
+             g_strcmp0 (contents, journal_text) == 0, msg);
+    g_free (contents);
+}
+
+int
+main (int argc, char** argv)
+{
+    g_setenv ("GNC_UNINSTALLED", "1", TRUE);
+    const char* location = g_getenv ("GNC_TEST_FILES");
+    if (!location)
+        location = "test-files/xml2";
+
+    qof_init ();
+    cashobjects_register ();
+    do_test (qof_load_backend_library (GNC_LIB_REL_PATH, GNC_LIB_NAME),
+             " loading gnc-backend-xml GModule failed");
+    xaccLogDisable ();
+
+    auto source = g_build_filename (location, "abc.gml2", nullptr);
+    auto dir = g_dir_make_tmp ("test-xml-journal-XXXXXX", nullptr);
+    auto filename = g_build_filename (dir, "abc.gml2", nullptr);
+    auto journal = g_strconcat (filename, ".journal", nullptr);
+    auto lockfile = g_strconcat (filename, ".LCK", nullptr);
+    char* contents = nullptr;
+    gsize length = 0;
+
+    do_test (g_file_get_contents (source, &contents, &length, nullptr) &&
+             g_file_set_contents (filename, contents, length, nullptr),
+             "copy the test book");
+    g_free (contents);
+
+    /* A book left with a journal and a stale lock after a crash,
+     * opened read-only. */
+    g_file_set_contents (journal, journal_text, -1, nullptr);
+    g_file_set_contents (lockfile, "", 0, nullptr);
+    open_and_end (filename, SESSION_READ_ONLY, true);
+    check_journal (journal, "read-only session removed the journal");
+
+    /* Another instance holds the lock: opening normally fails. */
+    g_file_set_contents (lockfile, "", 0, nullptr);
+    open_and_end (filename, SESSION_NORMAL_OPEN, false);
+    check_journal (journal, "session refused the lock removed the journal");
+
+    g_unlink (journal);
+    g_unlink (lockfile);
+    g_unlink (filename);
+    g_rmdir (dir);
+    g_free (lockfile);
+    g_free (journal);
+    g_free (filename);
+    g_free (dir);
+    g_free (source);
+
+    print_test_results ();
+    qof_close ();
+    exit (get_rv ());
+}
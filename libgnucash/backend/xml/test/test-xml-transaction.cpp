@@ -54,6 +54,8 @@ extern "C"
 #include "../io-gncxml-gen.h"
 #include "test-file-stuff.h"
 #include <test-stuff.h>
+
+#include <string>
 static QofBook* book;
 
 extern gboolean gnc_transaction_xml_v2_testing;
@@ -371,6 +373,40 @@ test_add_transaction (const char* tag, gpointer globaldata, gpointer data)
     return retval;
 }
 
+static std::string
+file_contents (FILE* file)
+{
+    std::string contents;
+    char buf[4096];
+    size_t len;
+
+    rewind (file);
+    while ((len = fread (buf, 1, sizeof (buf), file)) > 0)
+        contents.append (buf, len);
+    fclose (file);
+    return contents;
+}
+
+/* The streaming writer must produce exactly what xmlElemDump does. */
+static gboolean
+stream_matches_dom (xmlNodePtr node, Transaction* trn)
+{
+    FILE* dom_file = tmpfile ();
+    FILE* stream_file = tmpfile ();
+
+    xmlElemDump (dom_file, NULL, node);
+    {
+        GncXmlWriter writer {stream_file};
+        gnc_transaction_xml_stream (writer, trn);
+    }
+    auto dom = file_contents (dom_file);
+    auto stream = file_contents (stream_file);
+    if (dom == stream)
+        return TRUE;
+    printf ("DOM:\n%s\nStream:\n%s\n", dom.c_str (), stream.c_str ());
+    return FALSE;
+}
+
 static void
 test_transaction (void)
 {
@@ -442,6 +478,9 @@ test_transaction (void)
             success_args ("transaction_xml", __FILE__, __LINE__, "%d", i);
         }
 
+        do_test_args (stream_matches_dom (test_node, ran_trn),
+                      "transaction_xml_stream", __FILE__, __LINE__, "%d", i);
+
         filename1 = g_strdup_printf ("test_file_XXXXXX");
 
         fd = g_mkstemp (filename1);
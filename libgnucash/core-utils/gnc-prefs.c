@@ -34,6 +34,7 @@ static gboolean extras_enabled    = FALSE;
 static gboolean use_compression   = TRUE; // This is also the default in the prefs backend
 static gint file_retention_policy = 1;    // 1 = "days", the default in the prefs backend
 static gint file_retention_days   = 30;   // This is also the default in the prefs backend
+static gint compression_level     = 6;    // This is also the default in the prefs backend
 
 
 /* Global variables used to remove the preference registered callbacks
@@ -95,6 +96,18 @@ gnc_prefs_set_file_save_compressed(gboolean compressed)
     use_compression = compressed;
 }
 
+gint
+gnc_prefs_get_file_compression_level(void)
+{
+    return compression_level;
+}
+
+void
+gnc_prefs_set_file_compression_level(gint level)
+{
+    compression_level = CLAMP(level, 1, 9);
+}
+
 gint
 gnc_prefs_get_file_retention_policy(void)
 {
@@ -27,6 +27,7 @@
 
 extern "C" {
 #include "gnc-prefs.h"
+#include "gnc-pricedb-p.h"
 }
 
 #include <glib.h>
@@ -47,17 +48,52 @@ extern "C" {
 #include "gnc-features.h"
 #include "guid.hpp"
 
+#include <algorithm>
 #include <numeric>
 #include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 static QofLogModule log_module = GNC_MOD_ACCOUNT;
 
+static QofStat *recompute_stat;
+static QofStat *recompute_full_stat;
+static QofStat *recompute_splits_stat;
+static QofStat *sort_splits_stat;
+
 /* The Canonical Account Separator.  Pre-Initialized. */
 static gchar account_separator[8] = ".";
 static gunichar account_uc_separator = ':';
 
 static bool imap_convert_bayes_to_flat_run = false;
 
+using AccountNameIndex = std::unordered_multimap<std::string, Account*>;
+
+/* Maps the full names and the (non-empty) codes of every account in a
+ * tree, except the root, to the accounts.  It hangs off the root and
+ * is kept up to date by the functions that rename, recode or reparent
+ * accounts once a lookup has created it.
+ *
+ * The online ids set by importers are indexed too, without a trailing
+ * space, along with the key each account is filed under.  They live in
+ * the KVP, which can be written behind the index's back, so lookups
+ * check what they find and a miss reads them all again if any KvpFrame
+ * has changed since online_ids_generation. */
+struct AccountLookupIndex
+{
+    std::string separator;      /* account separator of the full names */
+    AccountNameIndex by_full_name;
+    AccountNameIndex by_code;
+    AccountNameIndex by_online_id;
+    std::unordered_map<const Account*, std::string> online_ids;
+    uint64_t online_ids_generation;
+};
+
+/* Number of splits between two date checkpoints. */
+static const size_t GNC_ACCOUNT_CHECKPOINT_INTERVAL = 64;
+
 /* Predefined KVP paths */
 static const std::string KEY_ASSOC_INCOME_ACCOUNT("ofx/associated-income-account");
 static const std::string KEY_RECONCILE_INFO("reconcile-info");
@@ -71,7 +107,10 @@ static const std::string AB_ACCOUNT_UID("account-uid");
 static const std::string AB_BANK_CODE("bank-code");
 static const std::string AB_TRANS_RETRIEVAL("trans-retrieval");
 
-static gnc_numeric GetBalanceAsOfDate (Account *acc, time64 date, gboolean ignclosing);
+typedef gnc_numeric (*SplitBalanceFn) (const Split *split);
+
+static gnc_numeric GetBalanceAsOfDate (Account *acc, time64 date,
+                                       SplitBalanceFn split_balance);
 
 using FinalProbabilityVec=std::vector<std::pair<std::string, int32_t>>;
 using ProbabilityVec=std::vector<std::pair<std::string, struct AccountProbability>>;
@@ -327,6 +366,9 @@ gnc_account_init(Account* acc)
 
     priv->policy = xaccGetFIFOPolicy();
     priv->lots = NULL;
+    new (&priv->open_lots) std::map<guint64, GNCLot*> ();
+    new (&priv->lot_serials) std::map<const GNCLot*, guint64> ();
+    priv->next_lot_serial = 0;
 
     priv->commodity = NULL;
     priv->commodity_scu = 0;
@@ -341,9 +383,35 @@ gnc_account_init(Account* acc)
     priv->starting_cleared_balance = gnc_numeric_zero();
     priv->starting_reconciled_balance = gnc_numeric_zero();
     priv->balance_dirty = FALSE;
+    priv->balance_dirty_from = 0;
 
-    priv->splits = NULL;
+    /* GObject zero-fills the private struct; the split vector has to
+     * be constructed in place and is destroyed in finalize. */
+    new (&priv->splits) SplitsVec ();
+    new (&priv->date_checkpoints) std::vector<time64> ();
     priv->sort_dirty = FALSE;
+    priv->sorted_upto = 0;
+    priv->bulk_insert_level = 0;
+    new (&priv->splits_moving_out) std::unordered_set<const Split*> ();
+    new (&priv->unreconciled_splits) std::unordered_set<Split*> ();
+    priv->split_list = NULL;
+    priv->split_list_dirty = FALSE;
+    new (&priv->balance_rollups) std::map<BalanceRollupKey, gnc_numeric> ();
+    priv->balance_rollups_price_gen = 0;
+    priv->rollup_generation = 1;
+    priv->balance_generation = 1;
+    priv->projected_min_generation = 0;
+    priv->projected_min_today = 0;
+    priv->projected_min = gnc_numeric_zero ();
+    priv->lookup_index = NULL;
+    new (&priv->descendants) std::vector<Account*> ();
+    new (&priv->descendants_sorted) std::vector<Account*> ();
+    new (&priv->children_sorted) std::vector<Account*> ();
+    priv->descendants_valid = FALSE;
+    priv->descendants_sorted_valid = FALSE;
+    priv->kvp_flags_generation = 0;
+    priv->kvp_flags_loaded = 0;
+    priv->kvp_flags = 0;
 }
 
 static void
@@ -355,6 +423,21 @@ gnc_account_dispose (GObject *acctp)
 static void
 gnc_account_finalize(GObject* acctp)
 {
+    AccountPrivate *priv = GET_PRIVATE(acctp);
+
+    g_list_free (priv->split_list);
+    priv->split_list = NULL;
+    priv->splits.~SplitsVec();
+    priv->splits_moving_out.~unordered_set();
+    priv->unreconciled_splits.~unordered_set();
+    priv->date_checkpoints.~vector();
+    priv->open_lots.~map();
+    priv->lot_serials.~map();
+    priv->balance_rollups.~map();
+    delete priv->lookup_index;
+    priv->descendants.~vector();
+    priv->descendants_sorted.~vector();
+    priv->children_sorted.~vector();
     G_OBJECT_CLASS(gnc_account_parent_class)->finalize(acctp);
 }
 
@@ -489,8 +572,11 @@ gnc_account_get_property (GObject         *object,
         qof_instance_get_path_kvp (QOF_INSTANCE (account), value, {KEY_LOT_MGMT, "next-id"});
         break;
     case PROP_ONLINE_ACCOUNT:
-        qof_instance_get_path_kvp (QOF_INSTANCE (account), value, {KEY_ONLINE_ID});
+    {
+        static const KvpPath online_id_path {{KEY_ONLINE_ID.c_str ()}};
+        qof_instance_get_path_kvp (QOF_INSTANCE (account), value, online_id_path);
         break;
+    }
     case PROP_OFX_INCOME_ACCOUNT:
         qof_instance_get_path_kvp (QOF_INSTANCE (account), value, {KEY_ASSOC_INCOME_ACCOUNT});
         break;
@@ -618,8 +704,16 @@ gnc_account_set_property (GObject         *object,
         qof_instance_set_path_kvp (QOF_INSTANCE (account), value, {KEY_LOT_MGMT, "next-id"});
         break;
     case PROP_ONLINE_ACCOUNT:
+    {
+        auto index = GET_PRIVATE(account)->parent ?
+            GET_PRIVATE(gnc_account_get_root (account))->lookup_index : NULL;
+        if (index)
+            account_index_update_online_id (index, account, false);
         qof_instance_set_path_kvp (QOF_INSTANCE (account), value, {KEY_ONLINE_ID});
+        if (index)
+            account_index_update_online_id (index, account, true);
         break;
+    }
     case PROP_OFX_INCOME_ACCOUNT:
         qof_instance_set_path_kvp (QOF_INSTANCE (account), value, {KEY_ASSOC_INCOME_ACCOUNT});
         break;
@@ -1297,6 +1391,25 @@ xaccFreeOneChildAccount (Account *acc, gpointer dummy)
     xaccAccountDestroy(acc);
 }
 
+/* Forget the cached descendant lists of the account and its
+ * ancestors, or with order_only just the sorted ones.  An ancestor's
+ * lists are only ever valid if its descendants' are, so the walk can
+ * stop at the first one that is already invalid. */
+static void
+account_invalidate_descendants (AccountPrivate *priv, bool order_only)
+{
+    while (priv)
+    {
+        if (!priv->descendants_sorted_valid &&
+            (order_only || !priv->descendants_valid))
+            break;
+        priv->descendants_sorted_valid = FALSE;
+        if (!order_only)
+            priv->descendants_valid = FALSE;
+        priv = priv->parent ? GET_PRIVATE(priv->parent) : NULL;
+    }
+}
+
 static void
 xaccFreeAccountChildren (Account *acc)
 {
@@ -1313,6 +1426,7 @@ xaccFreeAccountChildren (Account *acc)
     if (priv->children)
         g_list_free(priv->children);
     priv->children = NULL;
+    account_invalidate_descendants (priv, false);
 }
 
 /* The xaccFreeAccount() routine releases memory associated with the
@@ -1352,30 +1466,30 @@ xaccFreeAccount (Account *acc)
         }
         g_list_free (priv->lots);
         priv->lots = NULL;
+        priv->open_lots.clear ();
+        priv->lot_serials.clear ();
     }
 
     /* Next, clean up the splits */
     /* NB there shouldn't be any splits by now ... they should
      * have been all been freed by CommitEdit().  We can remove this
      * check once we know the warning isn't occurring any more. */
-    if (priv->splits)
+    if (!priv->splits.empty())
     {
-        GList *slist;
         PERR (" instead of calling xaccFreeAccount(), please call\n"
               " xaccAccountBeginEdit(); xaccAccountDestroy();\n");
 
         qof_instance_reset_editlevel(acc);
 
-        slist = g_list_copy(priv->splits);
-        for (lp = slist; lp; lp = lp->next)
+        /* xaccSplitDestroy removes the split from priv->splits. */
+        auto slist = priv->splits;
+        for (auto s : slist)
         {
-            Split *s = (Split *) lp->data;
             g_assert(xaccSplitGetAccount(s) == acc);
             xaccSplitDestroy (s);
         }
-        g_list_free(slist);
-/* Nothing here (or in xaccAccountCommitEdit) NULLs priv->splits, so this asserts every time.
-        g_assert(priv->splits == NULL);
+/* Nothing here (or in xaccAccountCommitEdit) empties priv->splits, so this asserts every time.
+        g_assert(priv->splits.empty());
 */
     }
 
@@ -1389,6 +1503,7 @@ xaccFreeAccount (Account *acc)
 
     priv->parent = nullptr;
     priv->children = nullptr;
+    account_invalidate_descendants (priv, false);
 
     priv->balance  = gnc_numeric_zero();
     priv->noclosing_balance = gnc_numeric_zero();
@@ -1465,7 +1580,7 @@ xaccAccountCommitEdit (Account *acc)
     priv = GET_PRIVATE(acc);
     if (qof_instance_get_destroying(acc))
     {
-        GList *lp, *slist;
+        GList *lp;
         QofCollection *col;
 
         qof_instance_increase_editlevel(acc);
@@ -1482,18 +1597,15 @@ xaccAccountCommitEdit (Account *acc)
            themselves will be destroyed by the transaction code */
         if (!qof_book_shutting_down(book))
         {
-            slist = g_list_copy(priv->splits);
-            for (lp = slist; lp; lp = lp->next)
-            {
-                Split *s = static_cast<Split *>(lp->data);
+            auto slist = priv->splits;
+            for (auto s : slist)
                 xaccSplitDestroy (s);
-            }
-            g_list_free(slist);
         }
         else
         {
-            g_list_free(priv->splits);
-            priv->splits = NULL;
+            priv->splits.clear();
+            priv->date_checkpoints.clear();
+            priv->split_list_dirty = TRUE;
         }
 
         /* It turns out there's a case where this assertion does not hold:
@@ -1501,7 +1613,7 @@ xaccAccountCommitEdit (Account *acc)
            deleting all the splits in it.  The splits will just get
            recreated and put right back into the same account!
 
-           g_assert(priv->splits == NULL || qof_book_shutting_down(acc->inst.book));
+           g_assert(priv->splits.empty() || qof_book_shutting_down(acc->inst.book));
         */
 
         if (!qof_book_shutting_down(book))
@@ -1518,6 +1630,8 @@ xaccAccountCommitEdit (Account *acc)
         }
         g_list_free(priv->lots);
         priv->lots = NULL;
+        priv->open_lots.clear ();
+        priv->lot_serials.clear ();
 
         qof_instance_set_dirty(&acc->inst);
         qof_instance_decrease_editlevel(acc);
@@ -1804,39 +1918,32 @@ xaccAccountEqual(const Account *aa, const Account *ab, gboolean check_guids)
     /* no parent; always compare downwards. */
 
     {
-        GList *la = priv_aa->splits;
-        GList *lb = priv_ab->splits;
+        const auto& la = priv_aa->splits;
+        const auto& lb = priv_ab->splits;
 
-        if ((la && !lb) || (!la && lb))
+        if (la.empty() != lb.empty())
         {
             PWARN ("only one has splits");
             return FALSE;
         }
 
-        if (la && lb)
+        /* presume that the splits are in the same order */
+        auto ia = la.begin();
+        auto ib = lb.begin();
+        for (; ia != la.end() && ib != lb.end(); ++ia, ++ib)
         {
-            /* presume that the splits are in the same order */
-            while (la && lb)
-            {
-                Split *sa = (Split *) la->data;
-                Split *sb = (Split *) lb->data;
-
-                if (!xaccSplitEqual(sa, sb, check_guids, TRUE, FALSE))
-                {
-                    PWARN ("splits differ");
-                    return(FALSE);
-                }
-
-                la = la->next;
-                lb = lb->next;
-            }
-
-            if ((la != NULL) || (lb != NULL))
+            if (!xaccSplitEqual(*ia, *ib, check_guids, TRUE, FALSE))
             {
-                PWARN ("number of splits differs");
+                PWARN ("splits differ");
                 return(FALSE);
             }
         }
+
+        if (ia != la.end() || ib != lb.end())
+        {
+            PWARN ("number of splits differs");
+            return(FALSE);
+        }
     }
 
     if (!xaccAcctChildrenEqual(priv_aa->children, priv_ab->children, check_guids))
@@ -1850,6 +1957,55 @@ xaccAccountEqual(const Account *aa, const Account *ab, gboolean check_guids)
 
 /********************************************************************\
 \********************************************************************/
+
+/* Set while gnc_account_tree_bring_up_to_date runs accounts on
+ * several threads; it clears the sums of the whole tree afterwards. */
+static bool rollup_invalidation_deferred = false;
+
+/* Drop the memoized subtree balances of the account and of all its
+ * ancestors, since each of those sums includes this account. */
+static void
+account_invalidate_rollups (AccountPrivate *priv)
+{
+    if (rollup_invalidation_deferred)
+        return;
+    while (priv)
+    {
+        priv->balance_rollups.clear ();
+        priv->rollup_generation++;
+        priv = priv->parent ? GET_PRIVATE(priv->parent) : NULL;
+    }
+}
+
+/* Mark the running balances stale from the split at index from on;
+ * splits before it keep their cached balances. The date checkpoints
+ * at or after from go too, as those splits may have moved. */
+static void
+account_mark_balance_dirty (AccountPrivate *priv, size_t from)
+{
+    if (!priv->balance_dirty || from < priv->balance_dirty_from)
+        priv->balance_dirty_from = from;
+    priv->balance_dirty = TRUE;
+    priv->balance_generation++;
+    account_invalidate_rollups (priv);
+
+    auto keep = (from + GNC_ACCOUNT_CHECKPOINT_INTERVAL - 1) /
+        GNC_ACCOUNT_CHECKPOINT_INTERVAL;
+    if (keep < priv->date_checkpoints.size())
+        priv->date_checkpoints.resize (keep);
+}
+
+/* Mark the split order bad from index sorted_upto on; the splits
+ * before it are still in order and only need to be merged with the
+ * rest when sorting. */
+static void
+account_mark_sort_dirty (AccountPrivate *priv, size_t sorted_upto)
+{
+    if (!priv->sort_dirty || sorted_upto < priv->sorted_upto)
+        priv->sorted_upto = sorted_upto;
+    priv->sort_dirty = TRUE;
+}
+
 void
 gnc_account_set_sort_dirty (Account *acc)
 {
@@ -1861,7 +2017,7 @@ gnc_account_set_sort_dirty (Account *acc)
         return;
 
     priv = GET_PRIVATE(acc);
-    priv->sort_dirty = TRUE;
+    account_mark_sort_dirty (priv, 0);
 }
 
 void
@@ -1875,7 +2031,7 @@ gnc_account_set_balance_dirty (Account *acc)
         return;
 
     priv = GET_PRIVATE(acc);
-    priv->balance_dirty = TRUE;
+    account_mark_balance_dirty (priv, 0);
 }
 
 void gnc_account_set_defer_bal_computation (Account *acc, gboolean defer)
@@ -1900,41 +2056,113 @@ gboolean gnc_account_get_defer_bal_computation (Account *acc)
     return priv->defer_bal_computation;
 }
 
+void
+gnc_account_begin_bulk_insert (Account *acc)
+{
+    g_return_if_fail (GNC_IS_ACCOUNT (acc));
+
+    GET_PRIVATE (acc)->bulk_insert_level++;
+}
+
+void
+gnc_account_end_bulk_insert (Account *acc)
+{
+    AccountPrivate *priv;
+
+    g_return_if_fail (GNC_IS_ACCOUNT (acc));
+
+    priv = GET_PRIVATE (acc);
+    if (priv->bulk_insert_level == 0 || --priv->bulk_insert_level > 0)
+        return;
+
+    xaccAccountSortSplits (acc, TRUE);
+    xaccAccountRecomputeBalance (acc);
+}
+
 
 /********************************************************************\
 \********************************************************************/
 
+static bool
+split_order_less (const Split *a, const Split *b)
+{
+    return xaccSplitOrder (a, b) < 0;
+}
+
+/* Locate s in the account's split vector. While the vector is known
+ * to be sorted this is a binary search; a split whose sort key has
+ * changed since it was placed (or any split while sort_dirty is set)
+ * needs a linear scan, which is only done if allow_scan is true. */
+static SplitsVec::iterator
+account_find_split (AccountPrivate *priv, Split *s, bool allow_scan)
+{
+    auto& splits = priv->splits;
+    if (!priv->sort_dirty)
+    {
+        auto it = std::lower_bound (splits.begin(), splits.end(), s,
+                                    split_order_less);
+        if (it != splits.end() && *it == s)
+            return it;
+        if (!allow_scan)
+            return splits.end();
+    }
+    else if (!allow_scan)
+    {
+        /* Only the still sorted front can be searched quickly. */
+        auto sorted_end = splits.begin() +
+            std::min (priv->sorted_upto, splits.size());
+        auto it = std::lower_bound (splits.begin(), sorted_end, s,
+                                    split_order_less);
+        if (it != sorted_end && *it == s)
+            return it;
+        if (priv->bulk_insert_level > 0)
+            return splits.end();
+    }
+    return std::find (splits.begin(), splits.end(), s);
+}
+
+static void
+account_update_unreconciled (AccountPrivate *priv, Split *s)
+{
+    if (s->reconciled == YREC)
+        priv->unreconciled_splits.erase (s);
+    else
+        priv->unreconciled_splits.insert (s);
+}
+
 gboolean
 gnc_account_insert_split (Account *acc, Split *s)
 {
     AccountPrivate *priv;
-    GList *node;
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), FALSE);
     g_return_val_if_fail(GNC_IS_SPLIT(s), FALSE);
 
     priv = GET_PRIVATE(acc);
-    node = g_list_find(priv->splits, s);
-    if (node)
+    if (account_find_split (priv, s, false) != priv->splits.end())
         return FALSE;
 
-    if (qof_instance_get_editlevel(acc) == 0)
+    if (qof_instance_get_editlevel(acc) == 0 && priv->bulk_insert_level == 0)
     {
-        priv->splits = g_list_insert_sorted(priv->splits, s,
-                                            (GCompareFunc)xaccSplitOrder);
+        auto it = std::lower_bound (priv->splits.begin(), priv->splits.end(),
+                                    s, split_order_less);
+        account_mark_balance_dirty (priv, it - priv->splits.begin());
+        priv->splits.insert (it, s);
     }
     else
     {
-        priv->splits = g_list_prepend(priv->splits, s);
-        priv->sort_dirty = TRUE;
+        account_mark_balance_dirty (priv, priv->splits.size());
+        account_mark_sort_dirty (priv, priv->splits.size());
+        priv->splits.push_back (s);
     }
+    priv->split_list_dirty = TRUE;
+    account_update_unreconciled (priv, s);
 
     //FIXME: find better event
     qof_event_gen (&acc->inst, QOF_EVENT_MODIFY, NULL);
     /* Also send an event based on the account */
     qof_event_gen(&acc->inst, GNC_EVENT_ITEM_ADDED, s);
 
-    priv->balance_dirty = TRUE;
 //  DRH: Should the below be added? It is present in the delete path.
 //  xaccAccountRecomputeBalance(acc);
     return TRUE;
@@ -1944,23 +2172,35 @@ gboolean
 gnc_account_remove_split (Account *acc, Split *s)
 {
     AccountPrivate *priv;
-    GList *node;
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), FALSE);
     g_return_val_if_fail(GNC_IS_SPLIT(s), FALSE);
 
     priv = GET_PRIVATE(acc);
-    node = g_list_find(priv->splits, s);
-    if (NULL == node)
+    if (priv->splits_moving_out.erase (s))
+    {
+        priv->unreconciled_splits.erase (s);
+        qof_event_gen(&acc->inst, QOF_EVENT_MODIFY, NULL);
+        qof_event_gen(&acc->inst, GNC_EVENT_ITEM_REMOVED, s);
+        return TRUE;
+    }
+
+    auto it = account_find_split (priv, s, true);
+    if (it == priv->splits.end())
         return FALSE;
 
-    priv->splits = g_list_delete_link(priv->splits, node);
+    account_mark_balance_dirty (priv, it - priv->splits.begin());
+    if (priv->sort_dirty &&
+        static_cast<size_t>(it - priv->splits.begin()) < priv->sorted_upto)
+        priv->sorted_upto--;
+    priv->splits.erase (it);
+    priv->split_list_dirty = TRUE;
+    priv->unreconciled_splits.erase (s);
     //FIXME: find better event type
     qof_event_gen(&acc->inst, QOF_EVENT_MODIFY, NULL);
     // And send the account-based event, too
     qof_event_gen(&acc->inst, GNC_EVENT_ITEM_REMOVED, s);
 
-    priv->balance_dirty = TRUE;
     xaccAccountRecomputeBalance(acc);
     return TRUE;
 }
@@ -1973,11 +2213,74 @@ xaccAccountSortSplits (Account *acc, gboolean force)
     g_return_if_fail(GNC_IS_ACCOUNT(acc));
 
     priv = GET_PRIVATE(acc);
-    if (!priv->sort_dirty || (!force && qof_instance_get_editlevel(acc) > 0))
+    if (!priv->sort_dirty ||
+        (!force && (qof_instance_get_editlevel(acc) > 0 ||
+                    priv->bulk_insert_level > 0)))
         return;
-    priv->splits = g_list_sort(priv->splits, (GCompareFunc)xaccSplitOrder);
+    auto start = qof_stat_timer_start ();
+    /* Only the splits from the first one that moved need their
+     * running balances recomputed. */
+    auto old_splits = priv->splits;
+    auto& splits = priv->splits;
+    /* The front is still in order: sort the rest and merge them. */
+    auto sorted_end = splits.begin() + std::min (priv->sorted_upto,
+                                                 splits.size());
+    std::stable_sort (sorted_end, splits.end(), split_order_less);
+    std::inplace_merge (splits.begin(), sorted_end, splits.end(),
+                        split_order_less);
+    /* Bulk inserts don't check for a split that is already there. */
+    splits.erase (std::unique (splits.begin(), splits.end()), splits.end());
     priv->sort_dirty = FALSE;
-    priv->balance_dirty = TRUE;
+    priv->sorted_upto = 0;
+    auto moved = std::mismatch (old_splits.begin(), old_splits.end(),
+                                splits.begin(), splits.end());
+    if (moved.first != old_splits.end())
+    {
+        account_mark_balance_dirty (priv, moved.first - old_splits.begin());
+        priv->split_list_dirty = TRUE;
+    }
+    qof_stat_timer_stop (qof_stat_cached (&sort_splits_stat, "account.sort-splits"),
+                         start);
+}
+
+void
+gnc_account_split_changed (Account *acc, Split *split)
+{
+    AccountPrivate *priv;
+
+    g_return_if_fail(GNC_IS_ACCOUNT(acc));
+    g_return_if_fail(GNC_IS_SPLIT(split));
+
+    if (qof_instance_get_destroying(acc))
+        return;
+
+    priv = GET_PRIVATE(acc);
+    if (split->acc == acc)
+        account_update_unreconciled (priv, split);
+
+    auto it = account_find_split (priv, split, priv->bulk_insert_level == 0);
+    if (it == priv->splits.end())
+    {
+        /* Not worth a scan during a bulk insert; it could be anywhere. */
+        if (priv->bulk_insert_level > 0)
+        {
+            account_mark_sort_dirty (priv, 0);
+            account_mark_balance_dirty (priv, 0);
+        }
+        return;
+    }
+
+    /* Only a split in the ordered part can break the order. */
+    size_t pos = it - priv->splits.begin();
+    size_t sorted_end = priv->sort_dirty ?
+        std::min (priv->sorted_upto, priv->splits.size()) : priv->splits.size();
+    if (pos < sorted_end &&
+        ((pos > 0 && xaccSplitOrder (priv->splits[pos - 1], split) > 0) ||
+         (pos + 1 < sorted_end &&
+          xaccSplitOrder (split, priv->splits[pos + 1]) > 0)))
+        account_mark_sort_dirty (priv, pos);
+
+    account_mark_balance_dirty (priv, pos);
 }
 
 static void
@@ -1991,6 +2294,98 @@ xaccAccountBringUpToDate(Account *acc)
     xaccAccountRecomputeBalance(acc);
 }
 
+static void account_recompute_balance (Account *acc);
+
+static void
+account_bring_up_to_date_job (gpointer data, gpointer user_data)
+{
+    Account *acc = static_cast<Account*>(data);
+
+    xaccAccountSortSplits (acc, TRUE);
+    account_recompute_balance (acc);
+}
+
+void
+gnc_account_tree_bring_up_to_date (Account *root)
+{
+    QofBook *book;
+    GList *descendants;
+    std::vector<Account*> jobs;
+    GThreadPool *pool = NULL;
+
+    g_return_if_fail (GNC_IS_ACCOUNT (root));
+
+    book = gnc_account_get_book (root);
+    if (qof_book_shutting_down (book))
+        return;
+
+    descendants = gnc_account_get_descendants (root);
+    descendants = g_list_prepend (descendants, root);
+    for (GList *node = descendants; node; node = node->next)
+    {
+        Account *acc = static_cast<Account*>(node->data);
+        AccountPrivate *priv = GET_PRIVATE(acc);
+        if ((priv->sort_dirty || priv->balance_dirty) &&
+            !qof_instance_get_destroying (acc))
+            jobs.push_back (acc);
+    }
+    g_list_free (descendants);
+    if (jobs.empty ())
+        return;
+
+    /* Split ordering fills in some caches on the book and on the
+     * transactions, which the accounts share.  Fill them in now so that
+     * the jobs below only read them. */
+    qof_book_use_split_action_for_num_field (book);
+    for (auto acc : jobs)
+        for (auto s : GET_PRIVATE(acc)->splits)
+            xaccTransGetIsClosingTxn (xaccSplitGetParent (s));
+
+    /* Biggest first, so that no thread is left with a big one at the end. */
+    std::sort (jobs.begin (), jobs.end (), [](Account *a, Account *b)
+               {
+                   return GET_PRIVATE(a)->splits.size () >
+                       GET_PRIVATE(b)->splits.size ();
+               });
+
+    auto n_threads = std::min<size_t> (g_get_num_processors (), jobs.size ());
+    if (n_threads > 1)
+    {
+        GError *error = NULL;
+        pool = g_thread_pool_new (account_bring_up_to_date_job, NULL,
+                                  n_threads, TRUE, &error);
+        if (!pool)
+        {
+            PWARN ("Unable to create thread pool: %s", error->message);
+            g_error_free (error);
+        }
+    }
+
+    /* Each job only touches its own account and splits, except for the
+     * roll-ups of the ancestors, which are dealt with afterwards. */
+    rollup_invalidation_deferred = true;
+    if (pool)
+    {
+        for (auto acc : jobs)
+            g_thread_pool_push (pool, acc, NULL);
+        g_thread_pool_free (pool, FALSE, TRUE);
+    }
+    else
+    {
+        for (auto acc : jobs)
+            account_bring_up_to_date_job (acc, NULL);
+    }
+    rollup_invalidation_deferred = false;
+
+    /* Accounts being edited will send their event on commit. */
+    for (auto acc : jobs)
+    {
+        account_invalidate_rollups (GET_PRIVATE(acc));
+        if (qof_instance_get_editlevel (acc) == 0)
+            qof_event_gen (&acc->inst, QOF_EVENT_MODIFY, NULL);
+    }
+}
+
 /********************************************************************\
 \********************************************************************/
 
@@ -2086,6 +2481,57 @@ gnc_account_set_policy (Account *acc, GNCPolicy *policy)
 /********************************************************************\
 \********************************************************************/
 
+static void
+forget_lot (AccountPrivate *priv, const GNCLot *lot)
+{
+    auto it = priv->lot_serials.find (lot);
+    if (it == priv->lot_serials.end ())
+        return;
+    priv->open_lots.erase (it->second);
+    priv->lot_serials.erase (it);
+}
+
+void
+gnc_account_lot_changed (Account *acc, GNCLot *lot)
+{
+    g_return_if_fail (GNC_IS_ACCOUNT (acc));
+
+    auto priv = GET_PRIVATE (acc);
+    auto it = priv->lot_serials.find (lot);
+    if (it != priv->lot_serials.end ())
+        priv->open_lots[it->second] = lot;
+}
+
+gpointer
+gnc_account_foreach_open_lot (Account *acc,
+                              gpointer (*proc)(GNCLot *lot, gpointer user_data),
+                              gpointer user_data)
+{
+    g_return_val_if_fail (GNC_IS_ACCOUNT (acc), nullptr);
+    g_return_val_if_fail (proc, nullptr);
+
+    auto priv = GET_PRIVATE (acc);
+    /* Work on a copy: proc may move splits and so change lot states. */
+    std::vector<GNCLot*> lots;
+    lots.reserve (priv->open_lots.size ());
+    for (auto it = priv->open_lots.rbegin (); it != priv->open_lots.rend (); ++it)
+        lots.push_back (it->second);
+
+    for (auto lot : lots)
+    {
+        if (gnc_lot_is_closed (lot))
+        {
+            auto it = priv->lot_serials.find (lot);
+            if (it != priv->lot_serials.end ())
+                priv->open_lots.erase (it->second);
+            continue;
+        }
+        if (auto result = proc (lot, user_data))
+            return result;
+    }
+    return nullptr;
+}
+
 void
 xaccAccountRemoveLot (Account *acc, GNCLot *lot)
 {
@@ -2099,6 +2545,7 @@ xaccAccountRemoveLot (Account *acc, GNCLot *lot)
 
     ENTER ("(acc=%p, lot=%p)", acc, lot);
     priv->lots = g_list_remove(priv->lots, lot);
+    forget_lot (priv, lot);
     qof_event_gen (QOF_INSTANCE(lot), QOF_EVENT_REMOVE, NULL);
     qof_event_gen (&acc->inst, QOF_EVENT_MODIFY, NULL);
     LEAVE ("(acc=%p, lot=%p)", acc, lot);
@@ -2128,10 +2575,14 @@ xaccAccountInsertLot (Account *acc, GNCLot *lot)
         old_acc = lot_account;
         opriv = GET_PRIVATE(old_acc);
         opriv->lots = g_list_remove(opriv->lots, lot);
+        forget_lot (opriv, lot);
     }
 
     priv = GET_PRIVATE(acc);
     priv->lots = g_list_prepend(priv->lots, lot);
+    auto serial = priv->next_lot_serial++;
+    priv->lot_serials[lot] = serial;
+    priv->open_lots[serial] = lot;
     gnc_lot_set_account(lot, acc);
 
     /* Don't move the splits to the new account.  The caller will do this
@@ -2147,23 +2598,6 @@ xaccAccountInsertLot (Account *acc, GNCLot *lot)
 
 /********************************************************************\
 \********************************************************************/
-static void
-xaccPreSplitMove (Split *split, gpointer dummy)
-{
-    xaccTransBeginEdit (xaccSplitGetParent (split));
-}
-
-static void
-xaccPostSplitMove (Split *split, Account *accto)
-{
-    Transaction *trans;
-
-    xaccSplitSetAccount(split, accto);
-    xaccSplitSetAmount(split, split->amount);
-    trans = xaccSplitGetParent (split);
-    xaccTransCommitEdit (trans);
-}
-
 void
 xaccAccountMoveAllSplits (Account *accfrom, Account *accto)
 {
@@ -2175,7 +2609,7 @@ xaccAccountMoveAllSplits (Account *accfrom, Account *accto)
 
     /* optimizations */
     from_priv = GET_PRIVATE(accfrom);
-    if (!from_priv->splits || accfrom == accto)
+    if (from_priv->splits.empty() || accfrom == accto)
         return;
 
     /* check for book mix-up */
@@ -2184,28 +2618,66 @@ xaccAccountMoveAllSplits (Account *accfrom, Account *accto)
 
     xaccAccountBeginEdit(accfrom);
     xaccAccountBeginEdit(accto);
-    /* Begin editing both accounts and all transactions in accfrom. */
-    g_list_foreach(from_priv->splits, (GFunc)xaccPreSplitMove, NULL);
 
-    /* Concatenate accfrom's lists of splits and lots to accto's lists. */
-    //to_priv->splits = g_list_concat(to_priv->splits, from_priv->splits);
-    //to_priv->lots = g_list_concat(to_priv->lots, from_priv->lots);
+    /* Begin editing each transaction in accfrom once. */
+    std::vector<Transaction*> trans;
+    std::unordered_set<Transaction*> seen;
+    for (auto s : from_priv->splits)
+    {
+        auto t = xaccSplitGetParent (s);
+        if (seen.insert (t).second)
+        {
+            xaccTransBeginEdit (t);
+            trans.push_back (t);
+        }
+    }
 
-    /* Set appropriate flags. */
-    //from_priv->balance_dirty = TRUE;
-    //from_priv->sort_dirty = FALSE;
-    //to_priv->balance_dirty = TRUE;
-    //to_priv->sort_dirty = TRUE;
+    /* Empty accfrom in one go instead of erasing the splits one at a
+     * time as their transactions are committed.  accto appends them
+     * without looking for them first and sorts them in with one merge
+     * at the end of the bulk insert. */
+    gnc_account_begin_bulk_insert (accto);
+    auto splits = std::move (from_priv->splits);
+    from_priv->splits.clear();
+    from_priv->splits_moving_out.insert (splits.begin(), splits.end());
+    from_priv->sort_dirty = FALSE;
+    from_priv->sorted_upto = 0;
+    account_mark_balance_dirty (from_priv, 0);
+    from_priv->split_list_dirty = TRUE;
 
     /*
      * Change each split's account back pointer to accto.
      * Convert each split's amount to accto's commodity.
-     * Commit to editing each transaction.
      */
-    g_list_foreach(from_priv->splits, (GFunc)xaccPostSplitMove, (gpointer)accto);
+    for (auto s : splits)
+    {
+        xaccSplitSetAccount(s, accto);
+        xaccSplitSetAmount(s, s->amount);
+    }
+
+    /* Commit the transactions as one batch. One that can't go in the
+     * batch, because it was already open or fails its checks, gets the
+     * plain commit it always had. */
+    std::vector<GncTransCommitStatus> status (trans.size());
+    xaccTransCommitEditBatch (trans.data(), trans.size(), status.data());
+    for (size_t i = 0; i < trans.size(); i++)
+        if (status[i] != GNC_TRANS_COMMIT_OK &&
+            status[i] != GNC_TRANS_COMMIT_BACKEND_ERROR)
+            xaccTransCommitEdit (trans[i]);
+
+    /* Any split whose transaction is still open goes back until that
+     * transaction is committed. */
+    for (auto s : splits)
+        if (from_priv->splits_moving_out.count (s))
+        {
+            account_mark_sort_dirty (from_priv, from_priv->splits.size());
+            from_priv->splits.push_back (s);
+        }
+    from_priv->splits_moving_out.clear();
+    gnc_account_end_bulk_insert (accto);
 
     /* Finally empty accfrom. */
-    g_assert(from_priv->splits == NULL);
+    g_assert(from_priv->splits.empty());
     g_assert(from_priv->lots == NULL);
     xaccAccountCommitEdit(accfrom);
     xaccAccountCommitEdit(accto);
@@ -2242,34 +2714,50 @@ xaccAccountMoveAllSplits (Account *accfrom, Account *accto)
  * Return: void                                                     *
 \********************************************************************/
 
-void
-xaccAccountRecomputeBalance (Account * acc)
+/* The part of xaccAccountRecomputeBalance that doesn't care whether
+ * the account is being edited. */
+static void
+account_recompute_balance (Account *acc)
 {
     AccountPrivate *priv;
     gnc_numeric  balance;
     gnc_numeric  noclosing_balance;
     gnc_numeric  cleared_balance;
     gnc_numeric  reconciled_balance;
-    GList *lp;
-
-    if (NULL == acc) return;
 
     priv = GET_PRIVATE(acc);
-    if (qof_instance_get_editlevel(acc) > 0) return;
     if (!priv->balance_dirty || priv->defer_bal_computation) return;
     if (qof_instance_get_destroying(acc)) return;
     if (qof_book_shutting_down(qof_instance_get_book(acc))) return;
 
-    balance            = priv->starting_balance;
-    noclosing_balance  = priv->starting_noclosing_balance;
-    cleared_balance    = priv->starting_cleared_balance;
-    reconciled_balance = priv->starting_reconciled_balance;
+    auto start = qof_stat_timer_start ();
+    /* The splits before balance_dirty_from still hold correct running
+     * balances, so carry on from the last of them. */
+    auto from = std::min (priv->balance_dirty_from, priv->splits.size());
+    if (from == 0)
+    {
+        qof_stat_add (qof_stat_cached (&recompute_full_stat,
+                                       "account.recompute-balance.full"), 1);
+        balance            = priv->starting_balance;
+        noclosing_balance  = priv->starting_noclosing_balance;
+        cleared_balance    = priv->starting_cleared_balance;
+        reconciled_balance = priv->starting_reconciled_balance;
+    }
+    else
+    {
+        Split *prev = priv->splits[from - 1];
+        balance            = prev->balance;
+        noclosing_balance  = prev->noclosing_balance;
+        cleared_balance    = prev->cleared_balance;
+        reconciled_balance = prev->reconciled_balance;
+    }
 
-    PINFO ("acct=%s starting baln=%" G_GINT64_FORMAT "/%" G_GINT64_FORMAT,
-           priv->accountName, balance.num, balance.denom);
-    for (lp = priv->splits; lp; lp = lp->next)
+    PINFO ("acct=%s starting baln=%" G_GINT64_FORMAT "/%" G_GINT64_FORMAT
+           " at split %" G_GSIZE_FORMAT, priv->accountName,
+           balance.num, balance.denom, static_cast<gsize>(from));
+    for (auto it = priv->splits.begin() + from; it != priv->splits.end(); ++it)
     {
-        Split *split = (Split *) lp->data;
+        Split *split = *it;
         gnc_numeric amt = xaccSplitGetAmount (split);
 
         balance = gnc_numeric_add_fixed(balance, amt);
@@ -2301,6 +2789,24 @@ xaccAccountRecomputeBalance (Account * acc)
     priv->cleared_balance = cleared_balance;
     priv->reconciled_balance = reconciled_balance;
     priv->balance_dirty = FALSE;
+    priv->balance_dirty_from = 0;
+    priv->balance_generation++;
+    account_invalidate_rollups (priv);
+    qof_stat_add (qof_stat_cached (&recompute_splits_stat,
+                                   "account.recompute-balance.splits"),
+                  priv->splits.size() - from);
+    qof_stat_timer_stop (qof_stat_cached (&recompute_stat,
+                                          "account.recompute-balance"), start);
+}
+
+void
+xaccAccountRecomputeBalance (Account * acc)
+{
+    if (NULL == acc) return;
+
+    if (qof_instance_get_editlevel(acc) > 0) return;
+    if (GET_PRIVATE(acc)->bulk_insert_level > 0) return;
+    account_recompute_balance (acc);
 }
 
 /********************************************************************\
@@ -2384,6 +2890,166 @@ qof_xaccAccountOrder (const Account **aa, const Account **ab)
     return xaccAccountOrder(*aa, *ab);
 }
 
+/********************************************************************\
+ * Full name and code index                                         *
+\********************************************************************/
+
+static void
+account_index_update_entry (AccountNameIndex& map, const std::string& key,
+                            Account *acc, bool add)
+{
+    if (add)
+    {
+        map.emplace (key, acc);
+        return;
+    }
+
+    auto range = map.equal_range (key);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second == acc)
+        {
+            map.erase (it);
+            return;
+        }
+    }
+}
+
+static const char *
+account_online_id (const Account *acc)
+{
+    static const KvpPath online_id_path {{KEY_ONLINE_ID.c_str ()}};
+    auto frame = qof_instance_get_slots (QOF_INSTANCE (acc));
+    auto slot = frame ? frame->get_slot (online_id_path) : nullptr;
+
+    if (!slot || slot->get_type () != KvpValue::Type::STRING)
+        return nullptr;
+    return slot->get<const char*> ();
+}
+
+/* An online id as the import matcher compares them, without one
+ * trailing space. */
+static std::string
+account_online_id_key (const char *online_id)
+{
+    std::string key {online_id};
+    if (!key.empty () && key.back () == ' ')
+        key.pop_back ();
+    return key;
+}
+
+static void
+account_index_update_online_id (AccountLookupIndex *index, Account *acc,
+                                bool add)
+{
+    if (add)
+    {
+        auto online_id = account_online_id (acc);
+        if (!online_id)
+            return;
+        auto key = account_online_id_key (online_id);
+        index->by_online_id.emplace (key, acc);
+        index->online_ids[acc] = std::move (key);
+        return;
+    }
+
+    auto filed = index->online_ids.find (acc);
+    if (filed == index->online_ids.end ())
+        return;
+    account_index_update_entry (index->by_online_id, filed->second, acc, false);
+    index->online_ids.erase (filed);
+}
+
+/* Add or remove acc, whose full name is full_name, and all of its
+ * descendants. */
+static void
+account_index_update (AccountLookupIndex *index, Account *acc,
+                      const std::string& full_name, bool add)
+{
+    AccountPrivate *priv = GET_PRIVATE(acc);
+
+    if (priv->parent)
+    {
+        account_index_update_entry (index->by_full_name, full_name, acc, add);
+        if (priv->accountCode && *priv->accountCode)
+            account_index_update_entry (index->by_code, priv->accountCode,
+                                        acc, add);
+        account_index_update_online_id (index, acc, add);
+    }
+
+    for (GList *node = priv->children; node; node = node->next)
+    {
+        Account *child = static_cast<Account*>(node->data);
+        const char *name = GET_PRIVATE(child)->accountName;
+        std::string child_name = priv->parent ?
+            full_name + index->separator : std::string ();
+
+        child_name += name ? name : "";
+        account_index_update (index, child, child_name, add);
+    }
+}
+
+static std::string
+account_index_full_name (const AccountLookupIndex *index, const Account *acc)
+{
+    std::string full_name;
+
+    for (AccountPrivate *priv = GET_PRIVATE(acc); priv->parent;
+         priv = GET_PRIVATE(priv->parent))
+    {
+        std::string name = priv->accountName ? priv->accountName : "";
+        full_name = full_name.empty () ? name :
+            name + index->separator + full_name;
+    }
+    return full_name;
+}
+
+/* Add or remove acc and its descendants in the index of the tree it
+ * hangs in, if that tree has one. */
+static void
+account_index_update_subtree (Account *acc, bool add)
+{
+    Account *root = gnc_account_get_root (acc);
+    AccountPrivate *rpriv = GET_PRIVATE(root);
+
+    if (!rpriv->lookup_index)
+        return;
+    if (qof_book_shutting_down (gnc_account_get_book (root)))
+    {
+        delete rpriv->lookup_index;
+        rpriv->lookup_index = NULL;
+        return;
+    }
+    account_index_update (rpriv->lookup_index, acc,
+                          account_index_full_name (rpriv->lookup_index, acc),
+                          add);
+}
+
+/* Return the index of the tree that acc is in, building it if needed
+ * or if the account separator has changed since it was built. */
+static AccountLookupIndex *
+account_lookup_index (const Account *acc)
+{
+    Account *root = gnc_account_get_root ((Account*)acc);
+    AccountPrivate *rpriv = GET_PRIVATE(root);
+
+    if (rpriv->lookup_index &&
+        rpriv->lookup_index->separator != account_separator)
+    {
+        delete rpriv->lookup_index;
+        rpriv->lookup_index = NULL;
+    }
+    if (!rpriv->lookup_index)
+    {
+        rpriv->lookup_index = new AccountLookupIndex;
+        rpriv->lookup_index->separator = account_separator;
+        rpriv->lookup_index->online_ids_generation = KvpFrame::generation ();
+        account_index_update (rpriv->lookup_index, root, std::string (),
+                              true);
+    }
+    return rpriv->lookup_index;
+}
+
 /********************************************************************\
 \********************************************************************/
 
@@ -2402,8 +3068,14 @@ xaccAccountSetType (Account *acc, GNCAccountType tip)
         return;
 
     xaccAccountBeginEdit(acc);
+    /* xaccTransIsBalanced treats trading account splits separately. */
+    if (priv->type == ACCT_TYPE_TRADING || tip == ACCT_TYPE_TRADING)
+        for (auto s : priv->splits)
+            xaccTransBumpEditGeneration (s->parent);
     priv->type = tip;
-    priv->balance_dirty = TRUE; /* new type may affect balance computation */
+    account_mark_balance_dirty (priv, 0); /* new type may affect balance computation */
+    if (priv->parent)
+        account_invalidate_descendants (GET_PRIVATE(priv->parent), true);
     mark_account(acc);
     xaccAccountCommitEdit(acc);
 }
@@ -2423,7 +3095,15 @@ xaccAccountSetName (Account *acc, const char *str)
         return;
 
     xaccAccountBeginEdit(acc);
+    /* The full names of the whole subtree change. */
+    if (priv->parent)
+        account_index_update_subtree (acc, false);
     priv->accountName = qof_string_cache_replace(priv->accountName, str);
+    if (priv->parent)
+    {
+        account_index_update_subtree (acc, true);
+        account_invalidate_descendants (GET_PRIVATE(priv->parent), true);
+    }
     mark_account (acc);
     xaccAccountCommitEdit(acc);
 }
@@ -2432,6 +3112,7 @@ void
 xaccAccountSetCode (Account *acc, const char *str)
 {
     AccountPrivate *priv;
+    AccountLookupIndex *index;
 
     /* errors */
     g_return_if_fail(GNC_IS_ACCOUNT(acc));
@@ -2442,7 +3123,17 @@ xaccAccountSetCode (Account *acc, const char *str)
         return;
 
     xaccAccountBeginEdit(acc);
+    index = priv->parent ?
+        GET_PRIVATE(gnc_account_get_root (acc))->lookup_index : NULL;
+    if (index && priv->accountCode && *priv->accountCode)
+        account_index_update_entry (index->by_code, priv->accountCode,
+                                    acc, false);
     priv->accountCode = qof_string_cache_replace(priv->accountCode, str ? str : "");
+    if (index && *priv->accountCode)
+        account_index_update_entry (index->by_code, priv->accountCode,
+                                    acc, true);
+    if (priv->parent)
+        account_invalidate_descendants (GET_PRIVATE(priv->parent), true);
     mark_account (acc);
     xaccAccountCommitEdit(acc);
 }
@@ -2575,9 +3266,8 @@ xaccAccountSetCommodity (Account * acc, gnc_commodity * com)
     priv->non_standard_scu = FALSE;
 
     /* iterate over splits */
-    for (lp = priv->splits; lp; lp = lp->next)
+    for (auto s : priv->splits)
     {
-        Split *s = (Split *) lp->data;
         Transaction *trans = xaccSplitGetParent (s);
 
         xaccTransBeginEdit (trans);
@@ -2585,8 +3275,8 @@ xaccAccountSetCommodity (Account * acc, gnc_commodity * com)
         xaccTransCommitEdit (trans);
     }
 
-    priv->sort_dirty = TRUE;  /* Not needed. */
-    priv->balance_dirty = TRUE;
+    account_mark_sort_dirty (priv, 0);  /* Not needed. */
+    account_mark_balance_dirty (priv, 0);
     mark_account (acc);
 
     xaccAccountCommitEdit(acc);
@@ -2739,6 +3429,12 @@ gnc_account_append_child (Account *new_parent, Account *child)
     }
     cpriv->parent = new_parent;
     ppriv->children = g_list_append(ppriv->children, child);
+    account_invalidate_rollups (ppriv);
+    account_invalidate_descendants (ppriv, false);
+    /* The child is no longer a root, its subtree joins the new tree. */
+    delete cpriv->lookup_index;
+    cpriv->lookup_index = NULL;
+    account_index_update_subtree (child, true);
     qof_instance_set_dirty(&new_parent->inst);
     qof_instance_set_dirty(&child->inst);
 
@@ -2778,7 +3474,10 @@ gnc_account_remove_child (Account *parent, Account *child)
     ed.node = parent;
     ed.idx = g_list_index(ppriv->children, child);
 
+    account_index_update_subtree (child, false);
     ppriv->children = g_list_remove(ppriv->children, child);
+    account_invalidate_rollups (ppriv);
+    account_invalidate_descendants (ppriv, false);
 
     /* Now send the event. */
     qof_event_gen(&child->inst, QOF_EVENT_REMOVE, &ed);
@@ -2827,6 +3526,72 @@ gnc_account_get_children (const Account *account)
     return g_list_copy(GET_PRIVATE(account)->children);
 }
 
+static bool
+account_order_less (const Account *a, const Account *b)
+{
+    return xaccAccountOrder (a, b) < 0;
+}
+
+/* Return the cached pre-order list of the account's descendants,
+ * rebuilding it (and those of the descendants) if it is stale. */
+static const std::vector<Account*>&
+account_get_descendants_vec (const Account *account)
+{
+    AccountPrivate *priv = GET_PRIVATE(account);
+
+    if (!priv->descendants_valid)
+    {
+        priv->descendants.clear ();
+        for (GList *node = priv->children; node; node = node->next)
+        {
+            Account *child = static_cast<Account*>(node->data);
+            auto& below = account_get_descendants_vec (child);
+            priv->descendants.push_back (child);
+            priv->descendants.insert (priv->descendants.end (),
+                                      below.begin (), below.end ());
+        }
+        priv->descendants_valid = TRUE;
+    }
+    return priv->descendants;
+}
+
+/* As account_get_descendants_vec, sorting each set of children. */
+static const std::vector<Account*>&
+account_get_descendants_sorted_vec (const Account *account)
+{
+    AccountPrivate *priv = GET_PRIVATE(account);
+
+    if (!priv->descendants_sorted_valid)
+    {
+        priv->children_sorted.clear ();
+        for (GList *node = priv->children; node; node = node->next)
+            priv->children_sorted.push_back (static_cast<Account*>(node->data));
+        std::stable_sort (priv->children_sorted.begin (),
+                          priv->children_sorted.end (), account_order_less);
+
+        priv->descendants_sorted.clear ();
+        for (auto child : priv->children_sorted)
+        {
+            auto& below = account_get_descendants_sorted_vec (child);
+            priv->descendants_sorted.push_back (child);
+            priv->descendants_sorted.insert (priv->descendants_sorted.end (),
+                                             below.begin (), below.end ());
+        }
+        priv->descendants_sorted_valid = TRUE;
+    }
+    return priv->descendants_sorted;
+}
+
+static GList *
+account_vec_to_list (const std::vector<Account*>& accounts)
+{
+    GList *list = NULL;
+
+    for (auto it = accounts.rbegin (); it != accounts.rend (); ++it)
+        list = g_list_prepend (list, *it);
+    return list;
+}
+
 GList *
 gnc_account_get_children_sorted (const Account *account)
 {
@@ -2839,7 +3604,8 @@ gnc_account_get_children_sorted (const Account *account)
     priv = GET_PRIVATE(account);
     if (!priv->children)
         return NULL;
-    return g_list_sort(g_list_copy(priv->children), (GCompareFunc)xaccAccountOrder);
+    account_get_descendants_sorted_vec (account);
+    return account_vec_to_list (priv->children_sorted);
 }
 
 gint
@@ -2867,18 +3633,9 @@ gnc_account_nth_child (const Account *parent, gint num)
 gint
 gnc_account_n_descendants (const Account *account)
 {
-    AccountPrivate *priv;
-    GList *node;
-    gint count = 0;
-
     g_return_val_if_fail(GNC_IS_ACCOUNT(account), 0);
 
-    priv = GET_PRIVATE(account);
-    for (node = priv->children; node; node = g_list_next(node))
-    {
-        count += gnc_account_n_descendants(static_cast<Account*>(node->data)) + 1;
-    }
-    return count;
+    return account_get_descendants_vec (account).size ();
 }
 
 gint
@@ -2924,49 +3681,41 @@ gnc_account_get_tree_depth (const Account *account)
 GList *
 gnc_account_get_descendants (const Account *account)
 {
-    AccountPrivate *priv;
-    GList *child, *descendants;
-
     g_return_val_if_fail(GNC_IS_ACCOUNT(account), NULL);
 
-    priv = GET_PRIVATE(account);
-    if (!priv->children)
-        return NULL;
-
-    descendants = NULL;
-    for (child = priv->children; child; child = g_list_next(child))
-    {
-        descendants = g_list_append(descendants, child->data);
-        descendants = g_list_concat(descendants,
-                gnc_account_get_descendants(static_cast<Account const *>(child->data)));
-    }
-    return descendants;
+    return account_vec_to_list (account_get_descendants_vec (account));
 }
 
 GList *
 gnc_account_get_descendants_sorted (const Account *account)
 {
-    AccountPrivate *priv;
-    GList *child, *children, *descendants;
-
     /* errors */
     g_return_val_if_fail(GNC_IS_ACCOUNT(account), NULL);
 
-    /* optimizations */
-    priv = GET_PRIVATE(account);
-    if (!priv->children)
-        return NULL;
+    return account_vec_to_list (account_get_descendants_sorted_vec (account));
+}
 
-    descendants = NULL;
-    children = g_list_sort(g_list_copy(priv->children), (GCompareFunc)xaccAccountOrder);
-    for (child = children; child; child = g_list_next(child))
-    {
-        descendants = g_list_append(descendants, child->data);
-        descendants = g_list_concat(descendants,
-                gnc_account_get_descendants_sorted(static_cast<Account const *>(child->data)));
-    }
-    g_list_free(children);
-    return descendants;
+Account * const *
+gnc_account_get_descendants_array (const Account *account, gsize *n_accounts)
+{
+    g_return_val_if_fail(GNC_IS_ACCOUNT(account), NULL);
+    g_return_val_if_fail(n_accounts, NULL);
+
+    auto& descendants = account_get_descendants_vec (account);
+    *n_accounts = descendants.size ();
+    return descendants.data ();
+}
+
+Account * const *
+gnc_account_get_descendants_sorted_array (const Account *account,
+                                          gsize *n_accounts)
+{
+    g_return_val_if_fail(GNC_IS_ACCOUNT(account), NULL);
+    g_return_val_if_fail(n_accounts, NULL);
+
+    auto& descendants = account_get_descendants_sorted_vec (account);
+    *n_accounts = descendants.size ();
+    return descendants.data ();
 }
 
 Account *
@@ -3002,37 +3751,173 @@ gnc_account_lookup_by_name (const Account *parent, const char * name)
     return NULL;
 }
 
+static Account *
+account_lookup_by_code_walk (const Account *parent, const char * code)
+{
+    AccountPrivate *cpriv, *ppriv;
+    Account *child, *result;
+    GList *node;
+
+    /* first, look for accounts hanging off the current node */
+    ppriv = GET_PRIVATE(parent);
+    for (node = ppriv->children; node; node = node->next)
+    {
+        child = static_cast<Account*>(node->data);
+        cpriv = GET_PRIVATE(child);
+        if (g_strcmp0(cpriv->accountCode, code) == 0)
+            return child;
+    }
+
+    /* if we are still here, then we haven't found the account yet.
+     * Recursively search each of the child accounts next */
+    for (node = ppriv->children; node; node = node->next)
+    {
+        child = static_cast<Account*>(node->data);
+        result = account_lookup_by_code_walk (child, code);
+        if (result)
+            return result;
+    }
+
+    return NULL;
+}
+
+Account *
+gnc_account_lookup_by_code (const Account *parent, const char * code)
+{
+    AccountLookupIndex *index;
+    Account *found = NULL;
+
+    g_return_val_if_fail(GNC_IS_ACCOUNT(parent), NULL);
+    g_return_val_if_fail(code, NULL);
+
+    /* Empty codes are too common to be worth indexing. */
+    if (!*code)
+        return account_lookup_by_code_walk (parent, code);
+
+    index = account_lookup_index (parent);
+    auto range = index->by_code.equal_range (code);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second == parent || !xaccAccountHasAncestor (it->second, parent))
+            continue;
+        /* Several matches: the walk decides which one comes first. */
+        if (found)
+            return account_lookup_by_code_walk (parent, code);
+        found = it->second;
+    }
+
+    return found;
+}
+
+static void
+account_index_reload_online_ids (AccountLookupIndex *index, Account *acc)
+{
+    if (GET_PRIVATE(acc)->parent)
+        account_index_update_online_id (index, acc, true);
+    for (auto node = GET_PRIVATE(acc)->children; node; node = node->next)
+        account_index_reload_online_ids (index, static_cast<Account*>(node->data));
+}
+
+static gpointer
+account_online_id_is (Account *acc, gpointer data)
+{
+    auto online_id = account_online_id (acc);
+    if (online_id &&
+        account_online_id_key (online_id) == *static_cast<std::string*>(data))
+        return acc;
+    return nullptr;
+}
+
+/* Collect the descendants of root filed under key whose online id
+ * still says so.  Returns false if the index had a stale entry. */
+static bool
+account_online_id_candidates (AccountLookupIndex *index, const Account *root,
+                              const std::string& key,
+                              std::vector<Account*>& found)
+{
+    bool current = true;
+    auto range = index->by_online_id.equal_range (key);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        auto online_id = account_online_id (it->second);
+        if (!online_id || account_online_id_key (online_id) != key)
+            current = false;
+        else if (it->second != root && xaccAccountHasAncestor (it->second, root))
+            found.push_back (it->second);
+    }
+    return current;
+}
+
+static Account *
+account_lookup_by_online_id_index (AccountLookupIndex *index,
+                                   const Account *root, std::string key,
+                                   Account **partial, bool *current)
+{
+    std::vector<Account*> found;
+
+    *current = account_online_id_candidates (index, root, key, found);
+    if (found.size () == 1)
+        return found.front ();
+    /* Several matches: the first one in the tree wins. */
+    if (found.size () > 1)
+        return static_cast<Account*>(gnc_account_foreach_descendant_until
+                                     (root, account_online_id_is, &key));
+
+    if (!partial)
+        return nullptr;
+
+    /* The longest online id that key starts with is the best partial
+     * match, provided that only one account has it. */
+    while (!key.empty ())
+    {
+        key.pop_back ();
+        *current = account_online_id_candidates (index, root, key, found) &&
+            *current;
+        if (found.empty ())
+            continue;
+        if (found.size () == 1)
+            *partial = found.front ();
+        else
+            PERR("%zu accounts partially match with the online ID %s and none fully",
+                 found.size (), key.c_str ());
+        break;
+    }
+    return nullptr;
+}
+
 Account *
-gnc_account_lookup_by_code (const Account *parent, const char * code)
+gnc_account_lookup_by_online_id (const Account *root, const char *online_id,
+                                 Account **partial)
 {
-    AccountPrivate *cpriv, *ppriv;
-    Account *child, *result;
-    GList *node;
+    AccountLookupIndex *index;
+    Account *found;
+    bool current;
 
-    g_return_val_if_fail(GNC_IS_ACCOUNT(parent), NULL);
-    g_return_val_if_fail(code, NULL);
+    g_return_val_if_fail(GNC_IS_ACCOUNT(root), NULL);
+    g_return_val_if_fail(online_id, NULL);
 
-    /* first, look for accounts hanging off the current node */
-    ppriv = GET_PRIVATE(parent);
-    for (node = ppriv->children; node; node = node->next)
-    {
-        child = static_cast<Account*>(node->data);
-        cpriv = GET_PRIVATE(child);
-        if (g_strcmp0(cpriv->accountCode, code) == 0)
-            return child;
-    }
+    if (partial)
+        *partial = nullptr;
 
-    /* if we are still here, then we haven't found the account yet.
-     * Recursively search each of the child accounts next */
-    for (node = ppriv->children; node; node = node->next)
-    {
-        child = static_cast<Account*>(node->data);
-        result = gnc_account_lookup_by_code (child, code);
-        if (result)
-            return result;
-    }
+    auto key = account_online_id_key (online_id);
+    index = account_lookup_index (root);
+    found = account_lookup_by_online_id_index (index, root, key, partial,
+                                               &current);
+    if ((found && current) ||
+        index->online_ids_generation == KvpFrame::generation ())
+        return found;
 
-    return NULL;
+    /* Some KVP changed since the online ids were read; read them again. */
+    index->by_online_id.clear ();
+    index->online_ids.clear ();
+    account_index_reload_online_ids (index, gnc_account_get_root
+                                     (const_cast<Account*>(root)));
+    index->online_ids_generation = KvpFrame::generation ();
+
+    if (partial)
+        *partial = nullptr;
+    return account_lookup_by_online_id_index (index, root, key, partial,
+                                              &current);
 }
 
 static gpointer
@@ -3104,10 +3989,34 @@ gnc_account_lookup_by_full_name (const Account *any_acc,
     const Account *root;
     Account *found;
     gchar **names;
+    AccountLookupIndex *index;
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(any_acc), NULL);
     g_return_val_if_fail(name, NULL);
 
+    /* Any account the walk below would find is in the index, so a
+     * single match is the answer unless one of the names along its
+     * path contains the separator and so wouldn't match the split up
+     * name.  An empty name splits into no names at all. */
+    if (!*name)
+        return NULL;
+    index = account_lookup_index (any_acc);
+    auto range = index->by_full_name.equal_range (name);
+    if (range.first == range.second)
+        return NULL;
+    if (std::next (range.first) == range.second)
+    {
+        found = range.first->second;
+        for (rpriv = GET_PRIVATE(found); rpriv->parent;
+             rpriv = GET_PRIVATE(rpriv->parent))
+        {
+            if (strstr (rpriv->accountName, account_separator))
+                break;
+        }
+        if (!rpriv->parent)
+            return found;
+    }
+
     root = any_acc;
     rpriv = GET_PRIVATE(root);
     while (rpriv->parent)
@@ -3426,7 +4335,7 @@ gnc_account_set_start_balance (Account *acc, const gnc_numeric start_baln)
 
     priv = GET_PRIVATE(acc);
     priv->starting_balance = start_baln;
-    priv->balance_dirty = TRUE;
+    account_mark_balance_dirty (priv, 0);
 }
 
 void
@@ -3439,7 +4348,7 @@ gnc_account_set_start_cleared_balance (Account *acc,
 
     priv = GET_PRIVATE(acc);
     priv->starting_cleared_balance = start_baln;
-    priv->balance_dirty = TRUE;
+    account_mark_balance_dirty (priv, 0);
 }
 
 void
@@ -3452,7 +4361,7 @@ gnc_account_set_start_reconciled_balance (Account *acc,
 
     priv = GET_PRIVATE(acc);
     priv->starting_reconciled_balance = start_baln;
-    priv->balance_dirty = TRUE;
+    account_mark_balance_dirty (priv, 0);
 }
 
 gnc_numeric
@@ -3476,86 +4385,180 @@ xaccAccountGetReconciledBalance (const Account *acc)
     return GET_PRIVATE(acc)->reconciled_balance;
 }
 
-gnc_numeric
-xaccAccountGetProjectedMinimumBalance (const Account *acc)
+/* Walk the splits back from the last one until one posted by 'today'
+ * and return the lowest running balance on the way.  The result is
+ * cached until the balances change or the day moves on. */
+static gnc_numeric
+account_projected_minimum_balance (AccountPrivate *priv, time64 today)
 {
-    AccountPrivate *priv;
-    GList *node;
-    time64 today;
     gnc_numeric lowest = gnc_numeric_zero ();
-    int seen_a_transaction = 0;
 
-    g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
+    if (priv->projected_min_generation == priv->balance_generation &&
+        priv->projected_min_today == today)
+        return priv->projected_min;
 
-    priv = GET_PRIVATE(acc);
-    today = gnc_time64_get_today_end();
-    for (node = g_list_last(priv->splits); node; node = node->prev)
+    for (auto it = priv->splits.rbegin(); it != priv->splits.rend(); ++it)
     {
-        Split *split = static_cast<Split*>(node->data);
+        Split *split = *it;
 
-        if (!seen_a_transaction)
-        {
-            lowest = xaccSplitGetBalance (split);
-            seen_a_transaction = 1;
-        }
-        else if (gnc_numeric_compare(xaccSplitGetBalance (split), lowest) < 0)
-        {
-            lowest = xaccSplitGetBalance (split);
-        }
+        if (it == priv->splits.rbegin() ||
+            gnc_numeric_compare (split->balance, lowest) < 0)
+            lowest = split->balance;
 
-        if (xaccTransGetDate (xaccSplitGetParent (split)) <= today)
-            return lowest;
+        if (split->parent && xaccTransGetDate (split->parent) <= today)
+            break;
     }
 
+    priv->projected_min = lowest;
+    priv->projected_min_generation = priv->balance_generation;
+    priv->projected_min_today = today;
     return lowest;
 }
 
+gnc_numeric
+xaccAccountGetProjectedMinimumBalance (const Account *acc)
+{
+    g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
+
+    return account_projected_minimum_balance (GET_PRIVATE(acc),
+                                              gnc_time64_get_today_end ());
+}
+
+void
+gnc_account_get_projected_minimum_balances (Account * const *accounts,
+                                            gsize n_accounts,
+                                            gnc_numeric *balances)
+{
+    g_return_if_fail (accounts || n_accounts == 0);
+    g_return_if_fail (balances || n_accounts == 0);
+
+    auto today = gnc_time64_get_today_end ();
+    for (gsize i = 0; i < n_accounts; ++i)
+        balances[i] = GNC_IS_ACCOUNT(accounts[i]) ?
+            account_projected_minimum_balance (GET_PRIVATE(accounts[i]),
+                                               today) :
+            gnc_numeric_zero ();
+}
+
 
 /********************************************************************\
 \********************************************************************/
 
+static bool
+split_posted_before (const Split *s, time64 date)
+{
+    /* Splits without a parent sort last. */
+    return s->parent && xaccTransGetDate (s->parent) < date;
+}
+
+/* Find the first split posted at or after date. The splits must be
+ * sorted; xaccSplitOrder orders them by posted date first.  The
+ * search runs over the date checkpoints, extending them as needed,
+ * and then over at most one interval of splits. */
+static SplitsVec::const_iterator
+account_splits_lower_bound (AccountPrivate *priv, time64 date)
+{
+    auto& checkpoints = priv->date_checkpoints;
+    const auto& splits = priv->splits;
+
+    for (auto idx = checkpoints.size() * GNC_ACCOUNT_CHECKPOINT_INTERVAL;
+         idx < splits.size(); idx += GNC_ACCOUNT_CHECKPOINT_INTERVAL)
+    {
+        auto parent = splits[idx]->parent;
+        checkpoints.push_back (parent ? xaccTransGetDate (parent) : INT64_MAX);
+    }
+
+    /* The first split at or after date lies after the last checkpoint
+     * before date and no later than the next one. */
+    auto cp = std::lower_bound (checkpoints.begin(), checkpoints.end(), date);
+    size_t next = cp - checkpoints.begin();
+    size_t begin = next ? (next - 1) * GNC_ACCOUNT_CHECKPOINT_INTERVAL : 0;
+    size_t end = (cp == checkpoints.end()) ? splits.size() :
+        next * GNC_ACCOUNT_CHECKPOINT_INTERVAL;
+
+    return std::lower_bound (splits.begin() + begin, splits.begin() + end,
+                             date, split_posted_before);
+}
+
 static gnc_numeric
-GetBalanceAsOfDate (Account *acc, time64 date, gboolean ignclosing)
+GetBalanceAsOfDate (Account *acc, time64 date, SplitBalanceFn split_balance)
 {
-    /* Ideally this could use xaccAccountForEachSplit, but
-     * it doesn't exist yet and I'm uncertain of exactly how
-     * it would work at this time, since it differs from
-     * xaccAccountForEachTransaction by using gpointer return
-     * values rather than gints.
-     */
-    Split *latest = nullptr;
+    AccountPrivate *priv;
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
 
     xaccAccountSortSplits (acc, TRUE); /* just in case, normally a noop */
     xaccAccountRecomputeBalance (acc); /* just in case, normally a noop */
 
-    for (GList *lp = GET_PRIVATE(acc)->splits; lp; lp = lp->next)
-    {
-        if (xaccTransGetDate (xaccSplitGetParent ((Split *)lp->data)) >= date)
-            break;
-        latest = (Split *)lp->data;
-    }
-
-    if (!latest)
+    /* The running balance stored in the last split before date is the
+     * balance as of date. */
+    priv = GET_PRIVATE(acc);
+    auto it = account_splits_lower_bound (priv, date);
+    if (it == priv->splits.begin())
         return gnc_numeric_zero();
 
-    if (ignclosing)
-        return xaccSplitGetNoclosingBalance (latest);
-    else
-        return xaccSplitGetBalance (latest);
+    return split_balance (*(it - 1));
 }
 
 gnc_numeric
 xaccAccountGetBalanceAsOfDate (Account *acc, time64 date)
 {
-    return GetBalanceAsOfDate (acc, date, FALSE);
+    return GetBalanceAsOfDate (acc, date, xaccSplitGetBalance);
+}
+
+void
+gnc_account_get_balances_at_dates (Account * const *accounts,
+                                   gsize n_accounts,
+                                   const time64 *dates,
+                                   gsize n_dates,
+                                   gnc_numeric *balances)
+{
+    g_return_if_fail (accounts || n_accounts == 0);
+    g_return_if_fail (dates || n_dates == 0);
+    g_return_if_fail (balances || n_accounts == 0 || n_dates == 0);
+
+    for (gsize i = 0; i < n_accounts; ++i)
+    {
+        auto row = balances + i * n_dates;
+
+        if (!GNC_IS_ACCOUNT(accounts[i]))
+        {
+            std::fill (row, row + n_dates, gnc_numeric_zero ());
+            continue;
+        }
+
+        xaccAccountSortSplits (accounts[i], TRUE);
+        xaccAccountRecomputeBalance (accounts[i]);
+
+        auto priv = GET_PRIVATE(accounts[i]);
+        for (gsize j = 0; j < n_dates; ++j)
+        {
+            /* Splits posted at the date itself count. */
+            auto date = dates[j] < INT64_MAX ? dates[j] + 1 : dates[j];
+            auto it = account_splits_lower_bound (priv, date);
+
+            row[j] = (it == priv->splits.begin()) ? gnc_numeric_zero () :
+                xaccSplitGetBalance (*(it - 1));
+        }
+    }
 }
 
 static gnc_numeric
 xaccAccountGetNoclosingBalanceAsOfDate (Account *acc, time64 date)
 {
-    return GetBalanceAsOfDate (acc, date, TRUE);
+    return GetBalanceAsOfDate (acc, date, xaccSplitGetNoclosingBalance);
+}
+
+gnc_numeric
+xaccAccountGetClearedBalanceAsOfDate (Account *acc, time64 date)
+{
+    return GetBalanceAsOfDate (acc, date, xaccSplitGetClearedBalance);
+}
+
+gnc_numeric
+xaccAccountGetReconciledBalancePostedAsOfDate (Account *acc, time64 date)
+{
+    return GetBalanceAsOfDate (acc, date, xaccSplitGetReconciledBalance);
 }
 
 gnc_numeric
@@ -3565,9 +4568,8 @@ xaccAccountGetReconciledBalanceAsOfDate (Account *acc, time64 date)
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
 
-    for (GList *node = GET_PRIVATE(acc)->splits; node; node = node->next)
+    for (auto split : GET_PRIVATE(acc)->splits)
     {
-        Split *split = (Split*) node->data;
         if ((xaccSplitGetReconcile (split) == YREC) &&
             (xaccSplitGetDateReconciled (split) <= date))
             balance = gnc_numeric_add_fixed (balance, xaccSplitGetAmount (split));
@@ -3689,58 +4691,66 @@ xaccAccountGetXxxBalanceAsOfDateInCurrency(Account *acc, time64 date,
 }
 
 /*
- * Data structure used to pass various arguments into the following fn.
+ * Sum the balance of an account and all of its descendants in the
+ * given currency, extracting each account's balance with 'fn' or, if
+ * that is NULL, with 'asOfDateFn' at 'date'.  The sum is memoized on
+ * every account of the subtree, so that after a change only the
+ * accounts on the path up from it are summed again.  Cached sums are
+ * dropped by account_invalidate_rollups and whenever a price changes.
+ * The projected minimum balance depends on today's date, so that is
+ * part of its key.
  */
-typedef struct
-{
-    const gnc_commodity *currency;
+static gnc_numeric
+xaccAccountGetSubtreeBalance (Account *acc, xaccGetBalanceFn fn,
+                              xaccGetBalanceAsOfDateFn asOfDateFn,
+                              time64 date, const gnc_commodity *currency)
+{
+    AccountPrivate *priv = GET_PRIVATE(acc);
+    time64 key_date = 0;
+    if (!fn)
+        key_date = date;
+    else if (fn == xaccAccountGetProjectedMinimumBalance)
+        key_date = gnc_time64_get_today_end ();
+    BalanceRollupKey key (fn ? reinterpret_cast<uintptr_t>(fn) :
+                          reinterpret_cast<uintptr_t>(asOfDateFn),
+                          currency, key_date);
     gnc_numeric balance;
-    xaccGetBalanceFn fn;
-    xaccGetBalanceAsOfDateFn asOfDateFn;
-    time64 date;
-} CurrencyBalance;
 
+    auto price_gen = gnc_pricedb_get_generation ();
+    if (priv->balance_rollups_price_gen != price_gen)
+    {
+        priv->balance_rollups.clear ();
+        priv->balance_rollups_price_gen = price_gen;
+    }
+    auto cached = priv->balance_rollups.find (key);
+    if (cached != priv->balance_rollups.end ())
+        return cached->second;
 
-/*
- * A helper function for iterating over all the accounts in a list or
- * tree.  This function is called once per account, and sums up the
- * values of all these accounts.
- */
-static void
-xaccAccountBalanceHelper (Account *acc, gpointer data)
-{
-    CurrencyBalance *cb = static_cast<CurrencyBalance*>(data);
-    gnc_numeric balance;
+    if (fn)
+        balance = xaccAccountGetXxxBalanceInCurrency (acc, fn, currency);
+    else
+        balance = xaccAccountGetXxxBalanceAsOfDateInCurrency (acc, date,
+                                                              asOfDateFn,
+                                                              currency);
 
-    if (!cb->fn || !cb->currency)
-        return;
-    balance = xaccAccountGetXxxBalanceInCurrency (acc, cb->fn, cb->currency);
-    cb->balance = gnc_numeric_add (cb->balance, balance,
-                                   gnc_commodity_get_fraction (cb->currency),
+    for (GList *node = priv->children; node; node = node->next)
+    {
+        gnc_numeric child_balance =
+            xaccAccountGetSubtreeBalance (static_cast<Account*>(node->data),
+                                          fn, asOfDateFn, date, currency);
+        balance = gnc_numeric_add (balance, child_balance,
+                                   gnc_commodity_get_fraction (currency),
                                    GNC_HOW_RND_ROUND_HALF_UP);
-}
-
-static void
-xaccAccountBalanceAsOfDateHelper (Account *acc, gpointer data)
-{
-    CurrencyBalance *cb = static_cast<CurrencyBalance*>(data);
-    gnc_numeric balance;
-
-    g_return_if_fail (cb->asOfDateFn && cb->currency);
+    }
 
-    balance = xaccAccountGetXxxBalanceAsOfDateInCurrency (
-                  acc, cb->date, cb->asOfDateFn, cb->currency);
-    cb->balance = gnc_numeric_add (cb->balance, balance,
-                                   gnc_commodity_get_fraction (cb->currency),
-                                   GNC_HOW_RND_ROUND_HALF_UP);
+    priv->balance_rollups[key] = balance;
+    return balance;
 }
 
-
-
 /*
  * Common function that iterates recursively over all accounts below
- * the specified account.  It uses xaccAccountBalanceHelper to sum up
- * the balances of all its children, and uses the specified function
+ * the specified account.  It uses xaccAccountGetSubtreeBalance to sum
+ * up the balances of all its children, and uses the specified function
  * 'fn' for extracting the balance.  This function may extract the
  * current value, the reconciled value, etc.
  *
@@ -3753,35 +4763,19 @@ xaccAccountGetXxxBalanceInCurrencyRecursive (const Account *acc,
         const gnc_commodity *report_commodity,
         gboolean include_children)
 {
-    gnc_numeric balance;
-
     if (!acc) return gnc_numeric_zero ();
     if (!report_commodity)
         report_commodity = xaccAccountGetCommodity (acc);
     if (!report_commodity)
         return gnc_numeric_zero();
 
-    balance = xaccAccountGetXxxBalanceInCurrency (acc, fn, report_commodity);
-
     /* If needed, sum up the children converting to the *requested*
        commodity. */
     if (include_children)
-    {
-#ifdef _MSC_VER
-        /* MSVC compiler: Somehow, the struct initialization containing a
-           gnc_numeric doesn't work. As an exception, we hand-initialize
-           that member afterwards. */
-        CurrencyBalance cb = { report_commodity, { 0 }, fn, NULL, 0 };
-        cb.balance = balance;
-#else
-        CurrencyBalance cb = { report_commodity, balance, fn, NULL, 0 };
-#endif
-
-        gnc_account_foreach_descendant (acc, xaccAccountBalanceHelper, &cb);
-        balance = cb.balance;
-    }
+        return xaccAccountGetSubtreeBalance ((Account*)acc, fn, NULL, 0,
+                                             report_commodity);
 
-    return balance;
+    return xaccAccountGetXxxBalanceInCurrency (acc, fn, report_commodity);
 }
 
 static gnc_numeric
@@ -3789,36 +4783,20 @@ xaccAccountGetXxxBalanceAsOfDateInCurrencyRecursive (
     Account *acc, time64 date, xaccGetBalanceAsOfDateFn fn,
     const gnc_commodity *report_commodity, gboolean include_children)
 {
-    gnc_numeric balance;
-
     g_return_val_if_fail(acc, gnc_numeric_zero());
     if (!report_commodity)
         report_commodity = xaccAccountGetCommodity (acc);
     if (!report_commodity)
         return gnc_numeric_zero();
 
-    balance = xaccAccountGetXxxBalanceAsOfDateInCurrency(
-                  acc, date, fn, report_commodity);
-
     /* If needed, sum up the children converting to the *requested*
        commodity. */
     if (include_children)
-    {
-#ifdef _MSC_VER
-        /* MSVC compiler: Somehow, the struct initialization containing a
-           gnc_numeric doesn't work. As an exception, we hand-initialize
-           that member afterwards. */
-        CurrencyBalance cb = { report_commodity, 0, NULL, fn, date };
-        cb.balance = balance;
-#else
-        CurrencyBalance cb = { report_commodity, balance, NULL, fn, date };
-#endif
+        return xaccAccountGetSubtreeBalance (acc, NULL, fn, date,
+                                             report_commodity);
 
-        gnc_account_foreach_descendant (acc, xaccAccountBalanceAsOfDateHelper, &cb);
-        balance = cb.balance;
-    }
-
-    return balance;
+    return xaccAccountGetXxxBalanceAsOfDateInCurrency(
+               acc, date, fn, report_commodity);
 }
 
 gnc_numeric
@@ -3918,27 +4896,176 @@ xaccAccountGetNoclosingBalanceChangeForPeriod (Account *acc, time64 t1,
     return gnc_numeric_sub(b2, b1, GNC_DENOM_AUTO, GNC_HOW_DENOM_FIXED);
 }
 
+/* The balances without closing transactions of acc, and of its
+ * descendants if include_children, at each of n_times dates, converted
+ * to currency and summed the way xaccAccountGetSubtreeBalance does it.
+ * While the dates ascend each search starts from the split found for
+ * the date before, so the splits are walked once in order. */
+static void
+account_noclosing_balances_at (Account *acc, const time64 *times, gsize n_times,
+                               const gnc_commodity *currency,
+                               gboolean include_children, gnc_numeric *balances)
+{
+    auto priv = GET_PRIVATE(acc);
+
+    xaccAccountSortSplits (acc, TRUE);
+    xaccAccountRecomputeBalance (acc);
+
+    auto it = priv->splits.cbegin();
+    for (gsize j = 0; j < n_times; ++j)
+    {
+        if (j && times[j] >= times[j - 1])
+            it = std::lower_bound (it, priv->splits.cend(), times[j],
+                                   split_posted_before);
+        else
+            it = account_splits_lower_bound (priv, times[j]);
+
+        auto balance = (it == priv->splits.cbegin()) ? gnc_numeric_zero () :
+            xaccSplitGetNoclosingBalance (*(it - 1));
+        balances[j] = xaccAccountConvertBalanceToCurrencyAsOfDate
+            (acc, balance, priv->commodity, currency, times[j]);
+    }
+
+    if (!include_children || !priv->children)
+        return;
+
+    std::vector<gnc_numeric> child_balances (n_times);
+    for (auto node = priv->children; node; node = node->next)
+    {
+        account_noclosing_balances_at (static_cast<Account*>(node->data), times,
+                                       n_times, currency, TRUE,
+                                       child_balances.data());
+        for (gsize j = 0; j < n_times; ++j)
+            balances[j] = gnc_numeric_add (balances[j], child_balances[j],
+                                           gnc_commodity_get_fraction (currency),
+                                           GNC_HOW_RND_ROUND_HALF_UP);
+    }
+}
+
+void
+gnc_account_get_noclosing_balance_changes (Account *acc, const time64 *times,
+                                           gsize n_periods, gboolean recurse,
+                                           gnc_numeric *changes)
+{
+    g_return_if_fail (GNC_IS_ACCOUNT(acc));
+    g_return_if_fail (times || n_periods == 0);
+    g_return_if_fail (changes || n_periods == 0);
+
+    auto currency = xaccAccountGetCommodity (acc);
+    if (!currency)
+    {
+        std::fill (changes, changes + n_periods, gnc_numeric_zero ());
+        return;
+    }
+
+    std::vector<gnc_numeric> balances (2 * n_periods);
+    account_noclosing_balances_at (acc, times, 2 * n_periods, currency, recurse,
+                                   balances.data());
+    for (gsize i = 0; i < n_periods; ++i)
+        changes[i] = gnc_numeric_sub (balances[2 * i + 1], balances[2 * i],
+                                      GNC_DENOM_AUTO, GNC_HOW_DENOM_FIXED);
+}
+
+guint64
+gnc_account_get_subtree_generation (const Account *acc)
+{
+    g_return_val_if_fail (GNC_IS_ACCOUNT(acc), 0);
+    return GET_PRIVATE(acc)->rollup_generation;
+}
+
 
 /********************************************************************\
 \********************************************************************/
 
 /* THIS API NEEDS TO CHANGE.
  *
- * This code exposes the internal structure of the account object to
- * external callers by returning the actual list used by the object.
- * It should instead return a copy of the split list that the caller
- * is required to free.  That change would provide the freedom of
- * allowing the internal organization to change data structures if
- * necessary for whatever reason, while leaving the external API
- * unchanged. */
-/* XXX: violates the const'ness by forcing a sort before returning
- * the splitlist */
+ * The splits are held in a vector; for the benefit of existing callers
+ * a GList copy of it is cached in the account and rebuilt only when the
+ * set or order of splits has changed since it was last handed out.  It
+ * should instead return a copy of the split list that the caller is
+ * required to free. */
+/* XXX: violates the const'ness by forcing a sort and rebuilding the
+ * cached list before returning the splitlist */
 SplitList *
 xaccAccountGetSplitList (const Account *acc)
 {
+    AccountPrivate *priv;
+
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), NULL);
     xaccAccountSortSplits((Account*)acc, FALSE);  // normally a noop
-    return GET_PRIVATE(acc)->splits;
+
+    priv = GET_PRIVATE(acc);
+    if (priv->split_list_dirty)
+    {
+        g_list_free (priv->split_list);
+        priv->split_list = NULL;
+        for (auto it = priv->splits.rbegin(); it != priv->splits.rend(); ++it)
+            priv->split_list = g_list_prepend (priv->split_list, *it);
+        priv->split_list_dirty = FALSE;
+    }
+    return priv->split_list;
+}
+
+gint
+xaccAccountForEachSplitInRange (const Account *acc, time64 start, time64 end,
+                                SplitCallback proc, gpointer data)
+{
+    AccountPrivate *priv;
+
+    g_return_val_if_fail (GNC_IS_ACCOUNT(acc), 0);
+    g_return_val_if_fail (proc, 0);
+
+    /* The binary search needs the splits in order. */
+    xaccAccountSortSplits ((Account*)acc, TRUE);  // normally a noop
+
+    priv = GET_PRIVATE(acc);
+    for (auto it = account_splits_lower_bound (priv, start);
+         it != priv->splits.end(); ++it)
+    {
+        auto split = *it;
+        /* Splits without a parent sort last. */
+        if (!split->parent || xaccTransGetDate (split->parent) > end)
+            break;
+        if (auto result = proc (split, data))
+            return result;
+    }
+    return 0;
+}
+
+static gint
+prepend_split (Split *split, gpointer data)
+{
+    auto list = static_cast<SplitList**>(data);
+    *list = g_list_prepend (*list, split);
+    return 0;
+}
+
+SplitList *
+xaccAccountGetSplitsInRange (const Account *acc, time64 start, time64 end)
+{
+    SplitList *list = NULL;
+
+    g_return_val_if_fail (GNC_IS_ACCOUNT(acc), NULL);
+    xaccAccountForEachSplitInRange (acc, start, end, prepend_split, &list);
+    return g_list_reverse (list);
+}
+
+SplitList *
+xaccAccountGetUnreconciledSplits (const Account *acc)
+{
+    AccountPrivate *priv;
+
+    g_return_val_if_fail (GNC_IS_ACCOUNT(acc), NULL);
+
+    priv = GET_PRIVATE(acc);
+    std::vector<Split*> splits (priv->unreconciled_splits.begin(),
+                                priv->unreconciled_splits.end());
+    std::sort (splits.begin(), splits.end(), split_order_less);
+
+    SplitList *list = NULL;
+    for (auto it = splits.rbegin(); it != splits.rend(); ++it)
+        list = g_list_prepend (list, *it);
+    return list;
 }
 
 gint64
@@ -3952,7 +5079,7 @@ xaccAccountGetSplitList(account) == NULL instead. To test descendants \
 as well, use gnc_account_and_descendants_empty.");
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), 0);
 
-    nr = g_list_length(xaccAccountGetSplitList(acc));
+    nr = GET_PRIVATE(acc)->splits.size();
     if (include_children && (gnc_account_n_children(acc) != 0))
     {
         for (i=0; i < gnc_account_n_children(acc); i++)
@@ -3966,7 +5093,7 @@ as well, use gnc_account_and_descendants_empty.");
 gboolean gnc_account_and_descendants_empty (Account *acc)
 {
     g_return_val_if_fail (GNC_IS_ACCOUNT (acc), FALSE);
-    if (xaccAccountGetSplitList (acc)) return FALSE;
+    if (!GET_PRIVATE(acc)->splits.empty()) return FALSE;
     auto empty = TRUE;
     auto *children = gnc_account_get_children (acc);
     for (auto *n = children; n && empty; n = n->next)
@@ -4069,6 +5196,68 @@ boolean_from_key (const Account *acc, std::vector<std::string> const & path)
     return retval;
 }
 
+/* The boolean options cached in AccountPrivate::kvp_flags. */
+enum
+{
+    KVP_FLAG_TAX_RELATED = 1 << 0,
+    KVP_FLAG_PLACEHOLDER = 1 << 1,
+    KVP_FLAG_AUTO_INTEREST = 1 << 2,
+    KVP_FLAG_HIDDEN = 1 << 3,
+};
+
+static gboolean
+cached_boolean_from_key (const Account *acc, guint8 flag,
+                         std::vector<std::string> const & path)
+{
+    AccountPrivate *priv;
+    g_return_val_if_fail(GNC_IS_ACCOUNT(acc), FALSE);
+
+    priv = GET_PRIVATE(acc);
+    if (priv->kvp_flags_generation != KvpFrame::generation ())
+    {
+        priv->kvp_flags_loaded = 0;
+        priv->kvp_flags_generation = KvpFrame::generation ();
+    }
+    if (!(priv->kvp_flags_loaded & flag))
+    {
+        if (boolean_from_key (acc, path))
+            priv->kvp_flags |= flag;
+        else
+            priv->kvp_flags &= ~flag;
+        priv->kvp_flags_loaded |= flag;
+    }
+    return (priv->kvp_flags & flag) != 0;
+}
+
+static void
+set_cached_boolean_key (Account *acc, guint8 flag,
+                        std::vector<std::string> const & path, gboolean option)
+{
+    AccountPrivate *priv;
+    uint64_t generation;
+    g_return_if_fail(GNC_IS_ACCOUNT(acc));
+
+    priv = GET_PRIVATE(acc);
+    generation = KvpFrame::generation ();
+    if (priv->kvp_flags_generation != generation)
+        priv->kvp_flags_loaded = 0;
+    set_boolean_key (acc, path, option);
+
+    /* Unless something else wrote to a frame meanwhile, this write is
+     * the only change and the other flags are still good. */
+    if (KvpFrame::generation () != generation + 1)
+    {
+        priv->kvp_flags_loaded = 0;
+        return;
+    }
+    priv->kvp_flags_generation = generation + 1;
+    if (option)
+        priv->kvp_flags |= flag;
+    else
+        priv->kvp_flags &= ~flag;
+    priv->kvp_flags_loaded |= flag;
+}
+
 /********************************************************************\
 \********************************************************************/
 
@@ -4076,13 +5265,14 @@ boolean_from_key (const Account *acc, std::vector<std::string> const & path)
 gboolean
 xaccAccountGetTaxRelated (const Account *acc)
 {
-    return boolean_from_key(acc, {"tax-related"});
+    static const std::vector<std::string> path {"tax-related"};
+    return cached_boolean_from_key (acc, KVP_FLAG_TAX_RELATED, path);
 }
 
 void
 xaccAccountSetTaxRelated (Account *acc, gboolean tax_related)
 {
-    set_boolean_key(acc, {"tax-related"}, tax_related);
+    set_cached_boolean_key(acc, KVP_FLAG_TAX_RELATED, {"tax-related"}, tax_related);
 }
 
 const char *
@@ -4202,13 +5392,14 @@ const char *gnc_account_get_credit_string (GNCAccountType acct_type)
 gboolean
 xaccAccountGetPlaceholder (const Account *acc)
 {
-    return boolean_from_key(acc, {"placeholder"});
+    static const std::vector<std::string> path {"placeholder"};
+    return cached_boolean_from_key (acc, KVP_FLAG_PLACEHOLDER, path);
 }
 
 void
 xaccAccountSetPlaceholder (Account *acc, gboolean val)
 {
-    set_boolean_key(acc, {"placeholder"}, val);
+    set_cached_boolean_key(acc, KVP_FLAG_PLACEHOLDER, {"placeholder"}, val);
 }
 
 gboolean
@@ -4254,13 +5445,15 @@ xaccAccountGetDescendantPlaceholder (const Account *acc)
 gboolean
 xaccAccountGetAutoInterest (const Account *acc)
 {
-    return boolean_from_key (acc, {KEY_RECONCILE_INFO, "auto-interest-transfer"});
+    static const std::vector<std::string> path {KEY_RECONCILE_INFO, "auto-interest-transfer"};
+    return cached_boolean_from_key (acc, KVP_FLAG_AUTO_INTEREST, path);
 }
 
 void
 xaccAccountSetAutoInterest (Account *acc, gboolean val)
 {
-    set_boolean_key (acc, {KEY_RECONCILE_INFO, "auto-interest-transfer"}, val);
+    set_cached_boolean_key (acc, KVP_FLAG_AUTO_INTEREST,
+                            {KEY_RECONCILE_INFO, "auto-interest-transfer"}, val);
 }
 
 /********************************************************************\
@@ -4269,13 +5462,14 @@ xaccAccountSetAutoInterest (Account *acc, gboolean val)
 gboolean
 xaccAccountGetHidden (const Account *acc)
 {
-    return boolean_from_key (acc, {"hidden"});
+    static const std::vector<std::string> path {"hidden"};
+    return cached_boolean_from_key (acc, KVP_FLAG_HIDDEN, path);
 }
 
 void
 xaccAccountSetHidden (Account *acc, gboolean val)
 {
-    set_boolean_key (acc, {"hidden"}, val);
+    set_cached_boolean_key (acc, KVP_FLAG_HIDDEN, {"hidden"}, val);
 }
 
 gboolean
@@ -5085,7 +6279,6 @@ finder_help_function(const Account *acc, const char *description,
                      Split **split, Transaction **trans )
 {
     AccountPrivate *priv;
-    GList *slp;
 
     /* First, make sure we set the data to NULL BEFORE we start */
     if (split) *split = NULL;
@@ -5098,9 +6291,9 @@ finder_help_function(const Account *acc, const char *description,
      * list is in date order, and the most recent matches should be
      * returned!?  */
     priv = GET_PRIVATE(acc);
-    for (slp = g_list_last(priv->splits); slp; slp = slp->prev)
+    for (auto it = priv->splits.rbegin(); it != priv->splits.rend(); ++it)
     {
-        Split *lsplit = static_cast<Split*>(slp->data);
+        Split *lsplit = *it;
         Transaction *ltrans = xaccSplitGetParent(lsplit);
 
         if (g_strcmp0 (description, xaccTransGetDescription (ltrans)) == 0)
@@ -5217,8 +6410,8 @@ gnc_account_merge_children (Account *parent)
             gnc_account_merge_children (acc_a);
 
             /* consolidate transactions */
-            while (priv_b->splits)
-                xaccSplitSetAccount (static_cast <Split*> (priv_b->splits->data), acc_a);
+            while (!priv_b->splits.empty())
+                xaccSplitSetAccount (priv_b->splits.front(), acc_a);
 
             /* move back one before removal. next iteration around the loop
              * will get the node after node_b */
@@ -5260,7 +6453,13 @@ xaccAccountBeginStagedTransactionTraversals (const Account *account)
     if (!account)
         return;
     priv = GET_PRIVATE(account);
-    xaccSplitsBeginStagedTransactionTraversals(priv->splits);
+    for (auto s : priv->splits)
+    {
+        Transaction *trans = s->parent;
+
+        if (trans)
+            trans->marker = 0;
+    }
 }
 
 gboolean
@@ -5277,16 +6476,11 @@ xaccTransactionTraverse (Transaction *trans, int stage)
     return FALSE;
 }
 
-static void do_one_split (Split *s, gpointer data)
-{
-    Transaction *trans = s->parent;
-    trans->marker = 0;
-}
-
 static void do_one_account (Account *account, gpointer data)
 {
     AccountPrivate *priv = GET_PRIVATE(account);
-    g_list_foreach(priv->splits, (GFunc)do_one_split, NULL);
+    for (auto s : priv->splits)
+        s->parent->marker = 0;
 }
 
 /* Replacement for xaccGroupBeginStagedTransactionTraversals */
@@ -5307,8 +6501,6 @@ xaccAccountStagedTransactionTraversal (const Account *acc,
                                        void *cb_data)
 {
     AccountPrivate *priv;
-    GList *split_p;
-    GList *next;
     Transaction *trans;
     Split *s;
     int retval;
@@ -5316,15 +6508,9 @@ xaccAccountStagedTransactionTraversal (const Account *acc,
     if (!acc) return 0;
 
     priv = GET_PRIVATE(acc);
-    for (split_p = priv->splits; split_p; split_p = next)
+    for (size_t i = 0; i < priv->splits.size(); )
     {
-        /* Get the next element in the split list now, just in case some
-         * naughty thunk destroys the one we're using. This reduces, but
-         * does not eliminate, the possibility of undefined results if
-         * a thunk removes splits from this account. */
-        next = g_list_next(split_p);
-
-        s = static_cast <Split*> (split_p->data);
+        s = priv->splits[i];
         trans = s->parent;
         if (trans && (trans->marker < stage))
         {
@@ -5335,6 +6521,13 @@ xaccAccountStagedTransactionTraversal (const Account *acc,
                 if (retval) return retval;
             }
         }
+
+        /* A naughty thunk may have destroyed the split we're on, in
+         * which case the next one has moved down into its slot. This
+         * reduces, but does not eliminate, the possibility of undefined
+         * results if a thunk removes splits from this account. */
+        if (i < priv->splits.size() && priv->splits[i] == s)
+            ++i;
     }
 
     return 0;
@@ -5347,7 +6540,7 @@ gnc_account_tree_staged_transaction_traversal (const Account *acc,
         void *cb_data)
 {
     const AccountPrivate *priv;
-    GList *acc_p, *split_p;
+    GList *acc_p;
     Transaction *trans;
     Split *s;
     int retval;
@@ -5364,9 +6557,9 @@ gnc_account_tree_staged_transaction_traversal (const Account *acc,
     }
 
     /* Now this account */
-    for (split_p = priv->splits; split_p; split_p = g_list_next(split_p))
+    for (size_t i = 0; i < priv->splits.size(); )
     {
-        s = static_cast <Split*> (split_p->data);
+        s = priv->splits[i];
         trans = s->parent;
         if (trans && (trans->marker < stage))
         {
@@ -5377,6 +6570,10 @@ gnc_account_tree_staged_transaction_traversal (const Account *acc,
                 if (retval) return retval;
             }
         }
+
+        /* As above, don't skip a split if the thunk removed this one. */
+        if (i < priv->splits.size() && priv->splits[i] == s)
+            ++i;
     }
 
     return 0;
@@ -5444,11 +6641,11 @@ gnc_account_imap_find_account (GncImportMatchMap *imap,
     GncGUID * guid = NULL;
     Account *retval;
     if (!imap || !key) return NULL;
-    std::vector<std::string> path {IMAP_FRAME};
+    KvpPath::key_list keys {IMAP_FRAME};
     if (category)
-        path.push_back (category);
-    path.push_back (key);
-    qof_instance_get_path_kvp (QOF_INSTANCE (imap->acc), &v, path);
+        keys.push_back (category);
+    keys.push_back (key);
+    qof_instance_get_path_kvp (QOF_INSTANCE (imap->acc), &v, KvpPath {std::move (keys)});
     if (G_VALUE_HOLDS_BOXED (&v))
         guid = (GncGUID*)g_value_get_boxed (&v);
     retval = xaccAccountLookup (guid, imap->book);
@@ -5588,33 +6785,40 @@ static ProbabilityVec
 get_first_pass_probabilities(GncImportMatchMap * imap, GList * tokens)
 {
     ProbabilityVec ret;
+    /* Where each account already sits in ret, so that accounts matching
+     * several tokens are found without rescanning ret every time. */
+    std::unordered_map<std::string, size_t> positions;
+    TokenAccountsInfo tokenInfo{};
+    std::string path;
     /* find the probability for each account that contains any of the tokens
-     * in the input tokens list. */
+     * in the input tokens list. The slots are sorted, so each token costs a
+     * binary search plus the accounts recorded for it. */
     for (auto current_token = tokens; current_token; current_token = current_token->next)
     {
-        TokenAccountsInfo tokenInfo{};
-        auto path = std::string{IMAP_FRAME_BAYES "/"} + static_cast <char const *> (current_token->data) + "/";
+        tokenInfo.accounts.clear ();
+        tokenInfo.total_count = 0;
+        path.assign (IMAP_FRAME_BAYES "/");
+        path += static_cast <char const *> (current_token->data);
+        path += '/';
         qof_instance_foreach_slot_prefix (QOF_INSTANCE (imap->acc), path, &build_token_info, tokenInfo);
         for (auto const & current_account_token : tokenInfo.accounts)
         {
-            auto item = std::find_if(ret.begin(), ret.end(), [&current_account_token]
-                (std::pair<std::string, AccountProbability> const & a) {
-                    return current_account_token.account_guid == a.first;
-                });
-            if (item != ret.end())
+            auto token_probability = (double)current_account_token.token_count /
+                                     (double)tokenInfo.total_count;
+            auto spot = positions.find (current_account_token.account_guid);
+            if (spot != positions.end())
             {/* This account is already in the map */
-                item->second.product = ((double)current_account_token.token_count /
-                                      (double)tokenInfo.total_count) * item->second.product;
-                item->second.product_difference = ((double)1 - ((double)current_account_token.token_count /
-                                              (double)tokenInfo.total_count)) * item->second.product_difference;
+                auto & item = ret[spot->second].second;
+                item.product = token_probability * item.product;
+                item.product_difference = ((double)1 - token_probability) * item.product_difference;
             }
             else
             {
                 /* add a new entry */
                 AccountProbability new_probability;
-                new_probability.product = ((double)current_account_token.token_count /
-                                      (double)tokenInfo.total_count);
+                new_probability.product = token_probability;
                 new_probability.product_difference = 1 - (new_probability.product);
+                positions.emplace (current_account_token.account_guid, ret.size());
                 ret.push_back({current_account_token.account_guid, std::move(new_probability)});
             }
         } /* for all accounts in tokenInfo */
@@ -378,6 +378,24 @@ void gnc_account_set_sort_dirty (Account *acc);
  *  @param defer New value for the flag. */
 void gnc_account_set_defer_bal_computation (Account *acc, gboolean defer);
 
+/** Start a bulk insert on the account. Until the matching
+ *  gnc_account_end_bulk_insert, inserted splits are appended without
+ *  being sorted or checked against the splits added since, and the
+ *  balances aren't recomputed. Meant for backends and importers that
+ *  add many splits at once. Calls may be nested.
+ *
+ *  @param acc Start the bulk insert on this account. */
+void gnc_account_begin_bulk_insert (Account *acc);
+
+/** End a bulk insert on the account. The outermost call sorts the
+ *  appended splits once, merges them with the ones already there and
+ *  recomputes the balances (or leaves that to the commit if the
+ *  account is being edited). Does nothing if no bulk insert is in
+ *  progress.
+ *
+ *  @param acc End the bulk insert on this account. */
+void gnc_account_end_bulk_insert (Account *acc);
+
 /** Insert the given split from an account.
  *
  *  @param acc The account to which the split should be added.
@@ -428,6 +446,14 @@ gboolean gnc_account_get_defer_bal_computation (Account *acc);
  */
 void xaccAccountRecomputeBalance (Account *);
 
+/** Sort the splits and recompute the balances of the account and all
+ *  its descendants, spreading the accounts over a pool of threads.
+ *  This is meant for use after loading a book, so accounts that are
+ *  being edited or are in a bulk insert are brought up to date too.
+ *  Afterwards a QOF_EVENT_MODIFY is sent for each updated account
+ *  that isn't being edited; the others send theirs on commit. */
+void gnc_account_tree_bring_up_to_date (Account *root);
+
 /** The xaccAccountSortSplits() routine will resort the account's
  *  splits if the sort is dirty. If 'force' is true, the account
  *  is sorted even if the editlevel is not zero.
@@ -561,10 +587,42 @@ gnc_numeric xaccAccountGetClearedBalance (const Account *account);
 gnc_numeric xaccAccountGetReconciledBalance (const Account *account);
 gnc_numeric xaccAccountGetPresentBalance (const Account *account);
 gnc_numeric xaccAccountGetProjectedMinimumBalance (const Account *account);
+/** Get the projected minimum balance of each of 'n_accounts' accounts
+ *  into the matching slot of 'balances'.  Today's date is looked up
+ *  once for the whole batch and each account's result is cached
+ *  until its balances change, so redrawing a large account tree does
+ *  not rescan the splits of accounts that have not changed. */
+void gnc_account_get_projected_minimum_balances (Account * const *accounts,
+                                                 gsize n_accounts,
+                                                 gnc_numeric *balances);
 /** Get the balance of the account at the end of the day before the date specified. */
 gnc_numeric xaccAccountGetBalanceAsOfDate (Account *account,
         time64 date);
 
+/** Get the balance of each of 'n_accounts' accounts at each of
+ *  'n_dates' dates into 'balances', by account and then by date: the
+ *  balance of accounts[i] including every split posted at or before
+ *  dates[j] goes to balances[i * n_dates + j].  Each account's splits
+ *  are sorted and its running balances brought up to date once for
+ *  all the dates, and each date is then a binary search. */
+void gnc_account_get_balances_at_dates (Account * const *accounts,
+                                        gsize n_accounts,
+                                        const time64 *dates,
+                                        gsize n_dates,
+                                        gnc_numeric *balances);
+
+/** Get the cleared balance of the account at the end of the day before
+ *  the date specified, counting cleared splits posted before it. */
+gnc_numeric xaccAccountGetClearedBalanceAsOfDate (Account *account,
+        time64 date);
+
+/** Get the reconciled balance of the account at the end of the day
+ *  before the date specified, counting reconciled splits posted before
+ *  it.  Unlike xaccAccountGetReconciledBalanceAsOfDate() this ignores
+ *  the date the splits were reconciled on. */
+gnc_numeric xaccAccountGetReconciledBalancePostedAsOfDate (Account *account,
+        time64 date);
+
 /** Get the reconciled balance of the account at the end of the day of the date specified. */
 gnc_numeric xaccAccountGetReconciledBalanceAsOfDate (Account *account, time64 date);
 
@@ -621,6 +679,24 @@ gnc_numeric xaccAccountGetNoclosingBalanceChangeForPeriod (
 gnc_numeric xaccAccountGetBalanceChangeForPeriod (
     Account *acc, time64 date1, time64 date2, gboolean recurse);
 
+/** Get the change of the balance without closing transactions over
+ *  each of 'n_periods' periods into 'changes': period i runs from
+ *  times[2 * i] to times[2 * i + 1] and changes[i] is what
+ *  xaccAccountGetNoclosingBalanceChangeForPeriod() gives for those
+ *  dates.  The splits of each account are walked once for all the
+ *  periods when the times ascend. */
+void gnc_account_get_noclosing_balance_changes (Account *acc,
+                                                const time64 *times,
+                                                gsize n_periods,
+                                                gboolean recurse,
+                                                gnc_numeric *changes);
+
+/** A number that changes whenever a balance of the account or of one
+ *  of its descendants may have changed, or the descendants themselves
+ *  have.  It doesn't follow the prices used to convert the balances
+ *  of descendants in other commodities. */
+guint64 gnc_account_get_subtree_generation (const Account *acc);
+
 /** @} */
 
 /** @name Account Children and Parents.
@@ -786,6 +862,26 @@ GList * gnc_account_get_descendants (const Account *account);
  *  list with the g_list_free() function. */
 GList *gnc_account_get_descendants_sorted (const Account *account);
 
+/** Return the descendants of the specified account, in the order of
+ *  gnc_account_get_descendants(), without building a list.  The array
+ *  belongs to the account and is cached there; it stays valid until
+ *  an account is added to or removed from the tree below it.
+ *
+ *  @param account The account whose descendants should be returned.
+ *
+ *  @param n_accounts Set to the number of accounts in the array.
+ *
+ *  @return An array of account pointers, which may be NULL if there
+ *  are no descendants.  Don't free it. */
+Account * const *gnc_account_get_descendants_array (const Account *account,
+                                                    gsize *n_accounts);
+
+/** As gnc_account_get_descendants_array(), in the order of
+ *  gnc_account_get_descendants_sorted().  This array also becomes
+ *  invalid when the name, code or type of any descendant changes. */
+Account * const *gnc_account_get_descendants_sorted_array (const Account *account,
+                                                           gsize *n_accounts);
+
 /** Return the number of descendants of the specified account.  The
  *  returned number does not include the account itself.
  *
@@ -930,6 +1026,19 @@ Account *gnc_account_lookup_by_full_name (const Account *any_account,
 Account *gnc_account_lookup_by_code (const Account *parent,
                                      const char *code);
 
+/** Find the descendant of root whose online id, set by an importer,
+ *  is online_id.  A trailing space on either id is ignored.
+ *
+ *  @param partial If not NULL and nothing matches exactly, receives
+ *  the only account whose online id is the longest prefix of
+ *  online_id, or NULL if there is no such account or several.
+ *
+ *  @return The matching account, or NULL if none was found.
+ */
+Account *gnc_account_lookup_by_online_id (const Account *root,
+                                          const char *online_id,
+                                          Account **partial);
+
 /** Find the opening balance account for the currency.
  *
  *  @param account The account of which the sought-for account is a descendant.
@@ -1039,17 +1148,53 @@ gboolean xaccAccountIsEquityType(GNCAccountType t);
 
 /** The xaccAccountGetSplitList() routine returns a pointer to a GList of
  *    the splits in the account.
- * @note This GList is the account's internal
- *    data structure: do not delete it when done; treat it as a read-only
- *    structure.  Note that some routines (such as xaccAccountRemoveSplit())
- *    modify this list directly, and could leave you with a corrupted
- *    pointer.
+ * @note This GList is owned by the account: do not delete it when
+ *    done; treat it as a read-only structure.  It is a cached copy of
+ *    the account's internal split index and is only valid until the
+ *    splits of the account change and xaccAccountGetSplitList() is
+ *    called again.
  * @note This should be changed so that the returned value is a copy
  * of the list. No other part of the code should have access to the
  * internal data structure used by this object.
  */
 SplitList* xaccAccountGetSplitList (const Account *account);
 
+/** The xaccAccountForEachSplitInRange() routine calls @a proc on each
+ *    split in the account whose transaction was posted between @a start
+ *    and @a end inclusive, in split order.  It finds the first one with
+ *    a binary search instead of walking the whole split list.
+ *    Traversal stops as soon as @a proc returns non-zero, and that value
+ *    is returned; otherwise the result is 0.
+ *
+ * \warning @a proc must not add, remove or re-date splits of the
+ *    account.
+ *
+ * @param account the account whose splits are visited
+ * @param start the earliest posted date to include
+ * @param end the latest posted date to include
+ * @param proc the callback applied to each split
+ * @param data user data handed to @a proc
+ */
+gint xaccAccountForEachSplitInRange (const Account *account, time64 start,
+                                     time64 end, SplitCallback proc,
+                                     gpointer data);
+
+/** The xaccAccountGetSplitsInRange() routine returns a newly allocated
+ *    GList of the splits that xaccAccountForEachSplitInRange() would
+ *    visit.  This is meant for the bindings, which cannot pass a C
+ *    callback; the caller must free the list but not the splits.
+ */
+SplitList* xaccAccountGetSplitsInRange (const Account *account,
+                                        time64 start, time64 end);
+
+/** The xaccAccountGetUnreconciledSplits() routine returns a newly
+ *    allocated GList of the splits in the account that aren't
+ *    reconciled, in split order.  The account keeps an index of them,
+ *    so this doesn't walk the rest of its history.  The caller must
+ *    free the list but not the splits.
+ */
+SplitList* xaccAccountGetUnreconciledSplits (const Account *account);
+
 
 /** The xaccAccountCountSplits() routine returns the number of all
  *    the splits in the account. xaccAccountCountSplits is O(N). if
@@ -42,6 +42,19 @@
 #include "Account.h"
 
 #ifdef __cplusplus
+/* Many C++ files include this header inside an extern "C" block. */
+extern "C++" {
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+}
+
+using SplitsVec = std::vector<Split*>;
+/* (balance function, report commodity, date) of a memoized roll-up. */
+using BalanceRollupKey = std::tuple<uintptr_t, const gnc_commodity*, time64>;
+
 extern "C" {
 #endif
 
@@ -55,6 +68,9 @@ extern "C" {
  * No one outside of the engine should ever include this file.
 */
 
+/* The private data is only ever touched by C++ code; C sources that
+ * include this header only need the opaque type. */
+#ifdef __cplusplus
 /** \struct Account */
 typedef struct AccountPrivate
 {
@@ -115,11 +131,68 @@ typedef struct AccountPrivate
     gnc_numeric reconciled_balance;
 
     gboolean balance_dirty;     /* balances in splits incorrect */
+    size_t balance_dirty_from;  /* index of first split with a stale
+                                 * running balance, if balance_dirty */
 
-    GList *splits;              /* list of split pointers */
+    /* The splits, kept in xaccSplitOrder order (unless sort_dirty)
+     * in a contiguous array so that they can be binary searched. */
+    SplitsVec splits;
     gboolean sort_dirty;        /* sort order of splits is bad */
+    size_t sorted_upto;         /* splits before this index are still in
+                                 * order, if sort_dirty */
+    int bulk_insert_level;      /* gnc_account_begin_bulk_insert depth */
+    /* Splits xaccAccountMoveAllSplits has already taken out of splits,
+     * for gnc_account_remove_split to check off as their transactions
+     * are committed. */
+    std::unordered_set<const Split*> splits_moving_out;
+    /* The splits in splits that aren't reconciled, for the reconcile
+     * window.  Kept up to date by the insert and remove routines and
+     * gnc_account_split_changed. */
+    std::unordered_set<Split*> unreconciled_splits;
+
+    /* Posted date of every GNC_ACCOUNT_CHECKPOINT_INTERVAL'th split,
+     * so that date lookups search this short array and then only a
+     * few splits.  Built lazily and truncated at balance_dirty_from. */
+    std::vector<time64> date_checkpoints;
+
+    /* GList copy of splits handed out by xaccAccountGetSplitList;
+     * rebuilt lazily when split_list_dirty is set. */
+    GList *split_list;
+    gboolean split_list_dirty;
+
+    /* Memoized balances of this account plus all its descendants.
+     * Cleared here and in every ancestor whenever a balance below
+     * changes, and wholesale when the price generation moves on. */
+    std::map<BalanceRollupKey, gnc_numeric> balance_rollups;
+    guint64 balance_rollups_price_gen;
+    /* Bumped, with the generation of every ancestor, whenever the
+     * memoized subtree balances are dropped, so that caches outside the
+     * account can tell when a balance in the subtree has changed. */
+    guint64 rollup_generation;
+
+    /* Bumped whenever the running balances of the splits may have
+     * changed.  The projected minimum balance is cached against it
+     * and against the end of the day it was computed on. */
+    guint64 balance_generation;
+    guint64 projected_min_generation;
+    time64 projected_min_today;
+    gnc_numeric projected_min;
+
+    /* Boolean options read from the KVP, such as hidden and
+     * placeholder, kept while no KvpFrame has changed since
+     * kvp_flags_generation.  kvp_flags_loaded has a bit set for each
+     * of the flags whose value in kvp_flags has been read. */
+    guint64 kvp_flags_generation;
+    guint8 kvp_flags_loaded;
+    guint8 kvp_flags;
 
     LotList   *lots;		/* list of lot pointers */
+    /* The lots not known to be closed, keyed by the serial they got
+     * when inserted.  Lots are prepended to the list above, so walking
+     * this from the highest serial down visits them in list order. */
+    std::map<guint64, GNCLot*> open_lots;
+    std::map<const GNCLot*, guint64> lot_serials;
+    guint64 next_lot_serial;
     GNCPolicy *policy;		/* Cached pointer to policy method */
 
     /* The "mark" flag can be used by the user to mark this account
@@ -127,7 +200,24 @@ typedef struct AccountPrivate
      * account tree. */
     short mark;
     gboolean defer_bal_computation;
+
+    /* Pre-order lists of all descendants, the second one with every
+     * set of children in xaccAccountOrder order, and those sorted
+     * children themselves.  Rebuilt lazily when the flags are unset. */
+    std::vector<Account*> descendants;
+    std::vector<Account*> descendants_sorted;
+    std::vector<Account*> children_sorted;
+    gboolean descendants_valid;
+    gboolean descendants_sorted_valid;
+
+    /* Only on the root of a tree: full name and code index used by
+     * gnc_account_lookup_by_full_name and gnc_account_lookup_by_code.
+     * Built on first use, NULL until then. */
+    struct AccountLookupIndex *lookup_index;
 } AccountPrivate;
+#else
+typedef struct AccountPrivate AccountPrivate;
+#endif
 
 struct account_s
 {
@@ -142,6 +232,23 @@ void xaccAccountSetGUID (Account *account, const GncGUID *guid);
 /* Register Accounts with the engine */
 gboolean xaccAccountRegister (void);
 
+/* Tell the account that one of its splits has been edited.  The
+ * running balances are marked stale from that split onwards, and the
+ * account is marked sort-dirty only if the split is now out of order
+ * with its neighbours.  Its reconcile state is
+ * taken again for xaccAccountGetUnreconciledSplits. */
+void gnc_account_split_changed (Account *acc, Split *split);
+
+/* Tell the account that one of its lots may no longer be closed. */
+void gnc_account_lot_changed (Account *acc, GNCLot *lot);
+
+/* Like xaccAccountForEachLot, but only visits the lots that aren't
+ * closed.  Lots found closed on the way are dropped from the account's
+ * open set until gnc_account_lot_changed brings them back. */
+gpointer gnc_account_foreach_open_lot (Account *acc,
+                                       gpointer (*proc)(GNCLot *lot, gpointer user_data),
+                                       gpointer user_data);
+
 /* Structure for accessing static functions for testing */
 typedef struct
 {
@@ -395,6 +395,28 @@ recurrenceNthInstance(const Recurrence *r, guint n, GDate *date)
     }
 }
 
+void
+recurrenceGetInstances(const Recurrence *r, guint n, GDate *dates)
+{
+    guint i;
+
+    g_return_if_fail(r);
+    g_return_if_fail(dates || n == 0);
+
+    if (n == 0)
+        return;
+
+    dates[0] = r->start;
+    for (i = 1; i < n; i++)
+    {
+        /* A PERIOD_ONCE recurrence runs out after its first instance. */
+        if (g_date_valid(&dates[i - 1]))
+            recurrenceNextInstance(r, &dates[i - 1], &dates[i]);
+        else
+            g_date_clear(&dates[i], 1);
+    }
+}
+
 time64
 recurrenceGetPeriodTime(const Recurrence *r, guint period_num, gboolean end)
 {
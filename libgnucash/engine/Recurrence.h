@@ -134,6 +134,12 @@ void recurrenceNextInstance(const Recurrence *r, const GDate *refDate,
 /* Zero-based.  n == 1 gets the instance after the start date. */
 void recurrenceNthInstance(const Recurrence *r, guint n, GDate *date);
 
+/* Fill dates[0] to dates[n - 1] with the first n instances, dates[i]
+   being what recurrenceNthInstance(r, i, ...) gives. Takes one pass
+   rather than starting over from the start date for each one. Dates
+   past the last instance of a recurrence that ends are left invalid. */
+void recurrenceGetInstances(const Recurrence *r, guint n, GDate *dates);
+
 /* Get a time corresponding to the beginning (or end if 'end' is true)
    of the nth instance of the recurrence. Also zero-based. */
 time64 recurrenceGetPeriodTime(const Recurrence *r, guint n, gboolean end);
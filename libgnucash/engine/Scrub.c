@@ -52,6 +52,7 @@
 #include "gnc-commodity.h"
 #include "qofinstance-p.h"
 #include "gnc-session.h"
+#include "qofevent-p.h"
 
 #undef G_LOG_DOMAIN
 #define G_LOG_DOMAIN "gnc.engine.scrub"
@@ -88,21 +89,53 @@ gnc_get_ongoing_scrub (void)
 
 /* ================================================================ */
 
-void
-xaccAccountTreeScrubOrphans (Account *acc, QofPercentageFunc percentagefunc)
+/* A transaction with splits in several accounts of a tree only needs
+ * scrubbing once.  Returns TRUE the first time trans is seen. */
+static gboolean
+scrub_first_visit (GHashTable *seen, Transaction *trans)
 {
+    if (!trans || g_hash_table_contains (seen, trans))
+        return FALSE;
+    g_hash_table_add (seen, trans);
+    return TRUE;
+}
+
+static void scrub_account_orphans (Account *acc,
+                                   QofPercentageFunc percentagefunc,
+                                   GHashTable *seen);
+static void scrub_account_imbalance (Account *acc,
+                                     QofPercentageFunc percentagefunc,
+                                     GHashTable *seen);
+
+static void
+scrub_account_tree (Account *acc, QofPercentageFunc percentagefunc,
+                    void (*scrub)(Account*, QofPercentageFunc, GHashTable*))
+{
+    GHashTable *seen;
+    GList *descendants, *node;
+
     if (!acc) return;
 
     if (abort_now)
         (percentagefunc)(NULL, -1.0);
 
     scrub_depth ++;
-    xaccAccountScrubOrphans (acc, percentagefunc);
-    gnc_account_foreach_descendant(acc,
-                                   (AccountCb)xaccAccountScrubOrphans, percentagefunc);
+    seen = g_hash_table_new (g_direct_hash, g_direct_equal);
+    scrub (acc, percentagefunc, seen);
+    descendants = gnc_account_get_descendants (acc);
+    for (node = descendants; node; node = node->next)
+        scrub (node->data, percentagefunc, seen);
+    g_list_free (descendants);
+    g_hash_table_destroy (seen);
     scrub_depth--;
 }
 
+void
+xaccAccountTreeScrubOrphans (Account *acc, QofPercentageFunc percentagefunc)
+{
+    scrub_account_tree (acc, percentagefunc, scrub_account_orphans);
+}
+
 static void
 TransScrubOrphansFast (Transaction *trans, Account *root)
 {
@@ -138,6 +171,15 @@ TransScrubOrphansFast (Transaction *trans, Account *root)
 
 void
 xaccAccountScrubOrphans (Account *acc, QofPercentageFunc percentagefunc)
+{
+    GHashTable *seen = g_hash_table_new (g_direct_hash, g_direct_equal);
+    scrub_account_orphans (acc, percentagefunc, seen);
+    g_hash_table_destroy (seen);
+}
+
+static void
+scrub_account_orphans (Account *acc, QofPercentageFunc percentagefunc,
+                       GHashTable *seen)
 {
     GList *node, *splits;
     const char *str;
@@ -165,8 +207,9 @@ xaccAccountScrubOrphans (Account *acc, QofPercentageFunc percentagefunc)
             if (abort_now) break;
         }
 
-        TransScrubOrphansFast (xaccSplitGetParent (split),
-                               gnc_account_get_root (acc));
+        if (scrub_first_visit (seen, xaccSplitGetParent (split)))
+            TransScrubOrphansFast (xaccSplitGetParent (split),
+                                   gnc_account_get_root (acc));
         current_split++;
     }
     (percentagefunc)(NULL, -1.0);
@@ -334,20 +377,20 @@ xaccSplitScrub (Split *split)
 void
 xaccAccountTreeScrubImbalance (Account *acc, QofPercentageFunc percentagefunc)
 {
-    if (!acc) return;
-
-    if (abort_now)
-        (percentagefunc)(NULL, -1.0);
-
-    scrub_depth++;
-    xaccAccountScrubImbalance (acc, percentagefunc);
-    gnc_account_foreach_descendant(acc,
-                                   (AccountCb)xaccAccountScrubImbalance, percentagefunc);
-    scrub_depth--;
+    scrub_account_tree (acc, percentagefunc, scrub_account_imbalance);
 }
 
 void
 xaccAccountScrubImbalance (Account *acc, QofPercentageFunc percentagefunc)
+{
+    GHashTable *seen = g_hash_table_new (g_direct_hash, g_direct_equal);
+    scrub_account_imbalance (acc, percentagefunc, seen);
+    g_hash_table_destroy (seen);
+}
+
+static void
+scrub_account_imbalance (Account *acc, QofPercentageFunc percentagefunc,
+                         GHashTable *seen)
 {
     GList *node, *splits;
     const char *str;
@@ -379,12 +422,14 @@ xaccAccountScrubImbalance (Account *acc, QofPercentageFunc percentagefunc)
             g_free (progress_msg);
         }
 
-        TransScrubOrphansFast (xaccSplitGetParent (split),
-                               gnc_account_get_root (acc));
+        if (scrub_first_visit (seen, trans))
+        {
+            TransScrubOrphansFast (trans, gnc_account_get_root (acc));
 
-        xaccTransScrubCurrency(trans);
+            xaccTransScrubCurrency(trans);
 
-        xaccTransScrubImbalance (trans, gnc_account_get_root (acc), NULL);
+            xaccTransScrubImbalance (trans, gnc_account_get_root (acc), NULL);
+        }
 
         PINFO("Finished processing split %d of %d",
               curr_split_no + 1, split_count);
@@ -468,18 +513,117 @@ find_root_currency(void)
     return root_currency;
 }
 
-/* Get the trading split for a given commodity, creating it (and the
+/* The trading account of each commodity of a book, as found under the
+ * book's root by get_trading_account, and the number of dropped events
+ * when the cache was started. Adding, removing or destroying any account
+ * can change which account the lookup finds, so those events drop the
+ * whole cache; an account renamed or retyped since it was cached is
+ * caught by trading_account_still_matches. */
+#define GNC_TRADING_ACCOUNT_CACHE "gnc-trading-account-cache"
+
+typedef struct
+{
+    Account *root;
+    GHashTable *accounts;
+    guint dropped;
+} TradingAccountCache;
+
+static gint trading_account_cache_handler_id = 0;
+
+static void
+trading_account_cache_free (TradingAccountCache *cache)
+{
+    if (!cache) return;
+    g_hash_table_destroy (cache->accounts);
+    g_free (cache);
+}
+
+static void
+trading_account_cache_book_end (QofBook *book, gpointer key, gpointer user_data)
+{
+    trading_account_cache_free (user_data);
+}
+
+static void
+trading_account_cache_invalidate (QofBook *book)
+{
+    TradingAccountCache *cache = qof_book_get_data (book, GNC_TRADING_ACCOUNT_CACHE);
+
+    if (!cache) return;
+    qof_book_set_data (book, GNC_TRADING_ACCOUNT_CACHE, NULL);
+    trading_account_cache_free (cache);
+}
+
+static void
+trading_account_cache_handle_events (QofInstance *entity, QofEventId event_type,
+                                     gpointer user_data, gpointer event_data)
+{
+    if (!(event_type & (QOF_EVENT_ADD | QOF_EVENT_REMOVE | QOF_EVENT_DESTROY)))
+        return;
+    if (GNC_IS_ACCOUNT (entity))
+        trading_account_cache_invalidate (qof_instance_get_book (entity));
+}
+
+static TradingAccountCache *
+trading_account_cache_get (QofBook *book, Account *root)
+{
+    TradingAccountCache *cache = qof_book_get_data (book, GNC_TRADING_ACCOUNT_CACHE);
+
+    if (cache && cache->root == root &&
+        cache->dropped == qof_event_get_dropped_count ())
+        return cache;
+
+    trading_account_cache_invalidate (book);
+
+    if (trading_account_cache_handler_id == 0)
+        trading_account_cache_handler_id =
+            qof_event_register_handler (trading_account_cache_handle_events, NULL);
+
+    cache = g_new0 (TradingAccountCache, 1);
+    cache->root = root;
+    cache->accounts = g_hash_table_new (g_direct_hash, g_direct_equal);
+    cache->dropped = qof_event_get_dropped_count ();
+    qof_book_set_data_fin (book, GNC_TRADING_ACCOUNT_CACHE, cache,
+                           trading_account_cache_book_end);
+    return cache;
+}
+
+/* Whether a cached account is still where get_trading_account would
+ * find or make it: a trading account for the commodity, under one
+ * named for its namespace, under the top-level Trading account. */
+static gboolean
+trading_account_still_matches (Account *root, Account *account,
+                               gnc_commodity *commodity)
+{
+    Account *ns_account = gnc_account_get_parent (account);
+    Account *trading_account = ns_account ? gnc_account_get_parent (ns_account) : NULL;
+
+    return trading_account &&
+        xaccAccountGetType (account) == ACCT_TYPE_TRADING &&
+        gnc_commodity_equiv (xaccAccountGetCommodity (account), commodity) &&
+        xaccAccountGetType (ns_account) == ACCT_TYPE_TRADING &&
+        g_strcmp0 (xaccAccountGetName (ns_account),
+                   gnc_commodity_get_namespace (commodity)) == 0 &&
+        xaccAccountGetType (trading_account) == ACCT_TYPE_TRADING &&
+        g_strcmp0 (xaccAccountGetName (trading_account), _("Trading")) == 0 &&
+        gnc_account_get_parent (trading_account) == root;
+}
+
+/* Get the trading account for a given commodity, creating it (and the
    necessary parent accounts) if it doesn't exist. */
-static Split *
-get_trading_split (Transaction *trans, Account *base,
-                   gnc_commodity *commodity)
+static Account *
+get_trading_account (Account *root, gnc_commodity *commodity)
 {
-    Split *balance_split;
+    TradingAccountCache *cache;
     Account *trading_account;
     Account *ns_account;
     Account *account;
-    Account* root = gnc_book_get_root_account (xaccTransGetBook (trans));
-    gnc_commodity *root_currency = find_root_currency ();
+
+    g_return_val_if_fail (root, NULL);
+    cache = trading_account_cache_get (qof_instance_get_book (root), root);
+    account = g_hash_table_lookup (cache->accounts, commodity);
+    if (account && trading_account_still_matches (root, account, commodity))
+        return account;
 
     trading_account = xaccScrubUtilityGetOrMakeAccount (root,
                                                         NULL,
@@ -513,6 +657,25 @@ get_trading_split (Transaction *trans, Account *base,
         return NULL;
     }
 
+    /* Making the accounts may have dropped the cache */
+    cache = trading_account_cache_get (qof_instance_get_book (root), root);
+    g_hash_table_insert (cache->accounts, commodity, account);
+    return account;
+}
+
+/* Get the trading split for a given commodity, creating it (and the
+   necessary parent accounts) if it doesn't exist. */
+static Split *
+get_trading_split (Transaction *trans, Account *base,
+                   gnc_commodity *commodity)
+{
+    Split *balance_split;
+    Account *account;
+    Account* root = gnc_book_get_root_account (xaccTransGetBook (trans));
+
+    account = get_trading_account (root, commodity);
+    if (!account)
+        return NULL;
 
     balance_split = xaccTransFindSplitByAccount(trans, account);
 
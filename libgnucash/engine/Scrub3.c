@@ -179,20 +179,32 @@ xaccAccountScrubLots (Account *acc)
 
 /* ============================================================== */
 
-static void
-lot_scrub_cb (Account *acc, gpointer data)
-{
-    if (FALSE == xaccAccountHasTrades (acc)) return;
-    xaccAccountScrubLots (acc);
-}
-
 void
 xaccAccountTreeScrubLots (Account *acc)
 {
+    GList *descendants, *node;
     if (!acc) return;
 
-    gnc_account_foreach_descendant(acc, lot_scrub_cb, NULL);
+    ENTER ("(acc=%s)", xaccAccountGetName(acc));
+    /* Every gains split the scrub creates or edits lands in a gains
+     * account, usually somewhere in this tree.  Holding the whole tree
+     * open means each account is re-sorted, rebalanced and written
+     * back once at the end instead of after every gains split.  Gains
+     * accounts created on the way are left to commit themselves. */
+    descendants = gnc_account_get_descendants (acc);
+    xaccAccountBeginEdit (acc);
+    for (node = descendants; node; node = node->next)
+        xaccAccountBeginEdit (node->data);
+
+    for (node = descendants; node; node = node->next)
+        xaccAccountScrubLots (node->data);
     xaccAccountScrubLots (acc);
+
+    for (node = descendants; node; node = node->next)
+        xaccAccountCommitEdit (node->data);
+    xaccAccountCommitEdit (acc);
+    g_list_free (descendants);
+    LEAVE ("(acc=%s)", xaccAccountGetName(acc));
 }
 
 /* ========================== END OF FILE  ========================= */
@@ -56,6 +56,8 @@
 #include "gnc-lot.h"
 #include "gnc-event.h"
 #include "qofinstance-p.h"
+#include "qofquery-p.h"
+#include "qofquerycore-p.h"
 
 const char *void_former_amt_str = "void-former-amount";
 const char *void_former_val_str = "void-former-value";
@@ -110,6 +112,7 @@ gnc_split_init(Split* split)
     split->lot         = NULL;
 
     split->action      = CACHE_INSERT("");
+    gnc_num_sort_key_set (&split->action_sort_key, split->action);
     split->memo        = CACHE_INSERT("");
     split->reconciled  = NREC;
     split->amount      = gnc_numeric_zero();
@@ -504,6 +507,7 @@ xaccSplitReinit(Split * split)
     split->lot         = NULL;
 
     CACHE_REPLACE(split->action, "");
+    gnc_num_sort_key_set (&split->action_sort_key, split->action);
     CACHE_REPLACE(split->memo, "");
     split->reconciled  = NREC;
     split->amount      = gnc_numeric_zero();
@@ -546,10 +550,52 @@ xaccMallocSplit(QofBook *book)
  * Don't get duped!
  */
 
+/* Rollback copies are made and thrown away on every transaction edit,
+ * so a bounded number of thrown away ones is kept for reuse instead of
+ * going through g_object_new and finalize every time.  Each book keeps
+ * its own, so books used on different threads share nothing. */
+#define SPLIT_COPY_POOL_MAX 1024
+#define SPLIT_COPY_POOL_KEY "gnc-split-copy-pool"
+
+GncCopyPool *
+gnc_copy_pool_get (QofBook *book, const char *key, gboolean create)
+{
+    GncCopyPool *pool = qof_book_get_data (book, key);
+
+    if (!pool && create && book && !qof_book_shutting_down (book))
+    {
+        pool = g_new0 (GncCopyPool, 1);
+        qof_book_set_data (book, key, pool);
+    }
+    return pool;
+}
+
+void
+gnc_copy_pool_drain (QofBook *book, const char *key)
+{
+    GncCopyPool *pool = qof_book_get_data (book, key);
+
+    if (!pool) return;
+    qof_book_set_data (book, key, NULL);
+    g_slist_free_full (pool->items, g_object_unref);
+    g_free (pool);
+}
+
 Split *
 xaccDupeSplit (const Split *s)
 {
-    Split *split = g_object_new (GNC_TYPE_SPLIT, NULL);
+    GncCopyPool *pool = gnc_copy_pool_get (qof_instance_get_book (s),
+                                           SPLIT_COPY_POOL_KEY, FALSE);
+    Split *split;
+
+    if (pool && pool->items)
+    {
+        split = pool->items->data;
+        pool->items = g_slist_delete_link (pool->items, pool->items);
+        pool->size--;
+    }
+    else
+        split = g_object_new (GNC_TYPE_SPLIT, NULL);
 
     /* Trash the entity table. We don't want to mistake the cloned
      * splits as something official.  If we ever use this split, we'll
@@ -566,6 +612,7 @@ xaccDupeSplit (const Split *s)
 
     split->memo = CACHE_INSERT(s->memo);
     split->action = CACHE_INSERT(s->action);
+    gnc_num_sort_key_set (&split->action_sort_key, split->action);
 
     qof_instance_copy_kvp (QOF_INSTANCE (split), QOF_INSTANCE (s));
 
@@ -584,6 +631,44 @@ xaccDupeSplit (const Split *s)
     return split;
 }
 
+void
+xaccSplitFreeCopy (Split *split)
+{
+    GncCopyPool *pool;
+
+    if (!split) return;
+
+    pool = gnc_copy_pool_get (qof_instance_get_book (split),
+                              SPLIT_COPY_POOL_KEY, TRUE);
+    if (!pool || G_OBJECT (split)->ref_count != 1 ||
+        pool->size >= SPLIT_COPY_POOL_MAX)
+    {
+        xaccFreeSplit (split);
+        return;
+    }
+
+    CACHE_REMOVE (split->memo);
+    CACHE_REMOVE (split->action);
+    split->memo = NULL;
+    split->action = NULL;
+    split->parent = NULL;
+    split->acc = NULL;
+    split->orig_acc = NULL;
+    split->lot = NULL;
+    split->gains = GAINS_STATUS_UNKNOWN;
+    split->gains_split = NULL;
+    qof_instance_mark_clean (QOF_INSTANCE (split));
+
+    pool->items = g_slist_prepend (pool->items, split);
+    pool->size++;
+}
+
+void
+xaccSplitDrainCopyPool (QofBook *book)
+{
+    gnc_copy_pool_drain (book, SPLIT_COPY_POOL_KEY);
+}
+
 Split *
 xaccSplitCloneNoKvp (const Split *s)
 {
@@ -592,6 +677,7 @@ xaccSplitCloneNoKvp (const Split *s)
     split->parent              = NULL;
     split->memo                = CACHE_INSERT(s->memo);
     split->action              = CACHE_INSERT(s->action);
+    gnc_num_sort_key_set (&split->action_sort_key, split->action);
     split->reconciled          = s->reconciled;
     split->date_reconciled     = s->date_reconciled;
     split->value               = s->value;
@@ -725,13 +811,15 @@ xaccFreeSplit (Split *split)
 
 void mark_split (Split *s)
 {
-    if (s->acc)
-    {
-        g_object_set(s->acc, "sort-dirty", TRUE, "balance-dirty", TRUE, NULL);
-    }
+    /* A split that isn't committed to its account yet will be put in
+       place, with its balances marked stale, when it is inserted. */
+    if (s->acc && s->acc == s->orig_acc)
+        gnc_account_split_changed (s->acc, s);
 
     /* set dirty flag on lot too. */
     if (s->lot) gnc_lot_set_closed_unknown(s->lot);
+
+    xaccTransBumpEditGeneration (s->parent);
 }
 
 /*
@@ -946,6 +1034,7 @@ xaccSplitSetAccount (Split *s, Account *acc)
 
     s->acc = acc;
     qof_instance_set_dirty(QOF_INSTANCE(s));
+    xaccTransBumpEditGeneration (trans);
 
     if (trans)
         xaccTransCommitEdit(trans);
@@ -963,19 +1052,33 @@ xaccSplitCommitEdit(Split *s)
 {
     Account *acc = NULL;
     Account *orig_acc = NULL;
+    gboolean inserted = FALSE;
+    gboolean destroying;
+    gboolean teardown;
 
     g_return_if_fail(s);
     if (!qof_instance_is_dirty(QOF_INSTANCE(s)))
         return;
 
-    orig_acc = s->orig_acc;
+    /* s is freed by qof_commit_edit_part2 if it is being destroyed. */
+    destroying = qof_instance_get_destroying(s);
+
+    /* When the book is being destroyed the accounts and lots go on their
+       own and may already be gone, so don't unlink the split from them. */
+    teardown = destroying &&
+        qof_book_shutting_down(qof_instance_get_book(s));
 
-    if (GNC_IS_ACCOUNT(s->acc))
-        acc = s->acc;
+    if (!teardown)
+    {
+        orig_acc = s->orig_acc;
+        if (GNC_IS_ACCOUNT(s->acc))
+            acc = s->acc;
+    }
 
     /* Remove from lot (but only if it hasn't been moved to
        new lot already) */
-    if (s->lot && (gnc_lot_get_account(s->lot) != acc || qof_instance_get_destroying(s)))
+    if (s->lot && !teardown &&
+        (gnc_lot_get_account(s->lot) != acc || qof_instance_get_destroying(s)))
         gnc_lot_remove_split (s->lot, s);
 
     /* Possibly remove the split from the original account... */
@@ -992,6 +1095,7 @@ xaccSplitCommitEdit(Split *s)
     {
         if (gnc_account_insert_split(acc, s))
         {
+            inserted = TRUE;
             /* If the split's lot belonged to some other account, we
                leave it so. */
             if (s->lot && (NULL == gnc_lot_get_account(s->lot)))
@@ -1011,7 +1115,7 @@ xaccSplitCommitEdit(Split *s)
             qof_event_gen(&s->orig_parent->inst, QOF_EVENT_MODIFY,
                           NULL);
     }
-    if (s->lot)
+    if (s->lot && !teardown)
     {
         /* A change of value/amnt affects gains display, etc. */
         qof_event_gen (QOF_INSTANCE(s->lot), QOF_EVENT_MODIFY, NULL);
@@ -1028,7 +1132,11 @@ xaccSplitCommitEdit(Split *s)
 
     if (acc)
     {
-        g_object_set(acc, "sort-dirty", TRUE, "balance-dirty", TRUE, NULL);
+        /* A split that was just inserted is already in its sorted
+           place with its balances marked stale, and a destroyed one was
+           removed; an edited one may have to move. */
+        if (!inserted && !destroying)
+            gnc_account_split_changed (acc, s);
         xaccAccountRecomputeBalance(acc);
     }
 }
@@ -1042,7 +1150,10 @@ xaccSplitRollbackEdit(Split *s)
        only because we don't emit events for changing accounts until
        the final commit. */
     if (s->acc != s->orig_acc)
+    {
         s->acc = s->orig_acc;
+        xaccTransBumpEditGeneration (s->parent);
+    }
 
     /* Undestroy if needed */
     if (qof_instance_get_destroying(s) && s->parent)
@@ -1184,6 +1295,7 @@ qofSplitSetSharePrice (Split *split, gnc_numeric price)
     split->value = gnc_numeric_mul(xaccSplitGetAmount(split),
                                    price, get_currency_denom(split),
                                    GNC_HOW_RND_ROUND_HALF_UP);
+    xaccTransBumpEditGeneration (split->parent);
 }
 
 void
@@ -1217,6 +1329,7 @@ qofSplitSetAmount (Split *split, gnc_numeric amt)
     {
         split->amount = amt;
     }
+    xaccTransBumpEditGeneration (split->parent);
 }
 
 /* The amount of the split in the _account's_ commodity. */
@@ -1253,6 +1366,7 @@ qofSplitSetValue (Split *split, gnc_numeric amt)
     split->value = gnc_numeric_convert(amt,
                                        get_currency_denom(split), GNC_HOW_RND_ROUND_HALF_UP);
     g_assert(gnc_numeric_check (split->value) != GNC_ERROR_OK);
+    xaccTransBumpEditGeneration (split->parent);
 }
 
 /* The value of the split in the _transaction's_ currency. */
@@ -1471,8 +1585,10 @@ xaccSplitDestroy (Split *split)
 
     acc = split->acc;
     trans = split->parent;
-    if (acc && !qof_instance_get_destroying(acc)
-        && !qof_instance_get_destroying(trans)
+    /* Test the transaction first: while the book shuts down the
+       account may already have been freed. */
+    if (acc && !qof_instance_get_destroying(trans)
+        && !qof_instance_get_destroying(acc)
         && xaccTransGetReadOnly(trans))
         return FALSE;
 
@@ -1481,6 +1597,7 @@ xaccSplitDestroy (Split *split)
     ed.idx = xaccTransGetSplitIndex(trans, split);
     qof_instance_set_dirty(QOF_INSTANCE(split));
     qof_instance_set_destroying(split, TRUE);
+    xaccTransBumpEditGeneration (trans);
     qof_event_gen(&trans->inst, GNC_EVENT_ITEM_REMOVED, &ed);
     xaccTransCommitEdit(trans);
 
@@ -1497,6 +1614,7 @@ xaccSplitOrder (const Split *sa, const Split *sb)
     int comp;
     char *da, *db;
     gboolean action_for_num;
+    GncNumSortKey scratcha, scratchb;
 
     if (sa == sb) return 0;
     /* nothing is always less than something */
@@ -1507,24 +1625,30 @@ xaccSplitOrder (const Split *sa, const Split *sb)
      * according to book option */
     action_for_num = qof_book_use_split_action_for_num_field
         (xaccSplitGetBook (sa));
-    if (action_for_num)
-        retval = xaccTransOrder_num_action (sa->parent, sa->action,
-                                            sb->parent, sb->action);
+    if (action_for_num && sa->action && sb->action)
+        retval = xaccTransOrderBySortKey
+            (sa->parent,
+             gnc_num_sort_key_get (&sa->action_sort_key, sa->action,
+                                   &scratcha),
+             sb->parent,
+             gnc_num_sort_key_get (&sb->action_sort_key, sb->action,
+                                   &scratchb));
     else
         retval = xaccTransOrder (sa->parent, sb->parent);
     if (retval) return retval;
 
-    /* otherwise, sort on memo strings */
+    /* otherwise, sort on memo strings; they're interned in the string
+     * cache, so equal ones are usually the same pointer. */
     da = sa->memo ? sa->memo : "";
     db = sb->memo ? sb->memo : "";
-    retval = g_utf8_collate (da, db);
+    retval = da == db ? 0 : g_utf8_collate (da, db);
     if (retval)
         return retval;
 
     /* otherwise, sort on action strings */
     da = sa->action ? sa->action : "";
     db = sb->action ? sb->action : "";
-    retval = g_utf8_collate (da, db);
+    retval = da == db ? 0 : g_utf8_collate (da, db);
     if (retval != 0)
         return retval;
 
@@ -1735,6 +1859,7 @@ qofSplitSetAction (Split *split, const char *actn)
 {
     g_return_if_fail(split);
     CACHE_REPLACE(split->action, actn);
+    gnc_num_sort_key_set (&split->action_sort_key, split->action);
 }
 
 void
@@ -1744,6 +1869,7 @@ xaccSplitSetAction (Split *split, const char *actn)
     xaccTransBeginEdit (split->parent);
 
     CACHE_REPLACE(split->action, actn);
+    gnc_num_sort_key_set (&split->action_sort_key, split->action);
     qof_instance_set_dirty(QOF_INSTANCE(split));
     xaccTransCommitEdit(split->parent);
 
@@ -1852,6 +1978,7 @@ xaccSplitSetParent(Split *s, Transaction *t)
     }
     s->parent = t;
 
+    xaccTransBumpEditGeneration (old_trans);
     xaccTransCommitEdit(old_trans);
     qof_instance_set_dirty(QOF_INSTANCE(s));
 
@@ -1863,6 +1990,7 @@ xaccSplitSetParent(Split *s, Transaction *t)
         /* add ourselves to the new transaction's list of pending splits. */
         if (NULL == g_list_find(t->splits, s))
             t->splits = g_list_append(t->splits, s);
+        xaccTransBumpEditGeneration (t);
 
         ed.idx = -1; /* unused */
         qof_event_gen(&t->inst, GNC_EVENT_ITEM_ADDED, &ed);
@@ -2254,6 +2382,167 @@ qofSplitSetAccount(Split *s, QofInstance *ent)
     xaccSplitSetAccount(s, acc);
 }
 
+/* Query index for splits.  Register queries almost always carry an
+ * account match and usually a posted-date range; rather than test
+ * every split in the book, walk just those accounts' sorted split
+ * lists over the date range.  Queries that exclude reconciled splits,
+ * like the reconcile window's, walk only the accounts' unreconciled
+ * splits. */
+
+typedef struct
+{
+    QofInstanceForeachCB cb;
+    gpointer data;
+} SplitIndexData;
+
+static gint
+split_index_visit (Split *split, gpointer user_data)
+{
+    SplitIndexData *idata = user_data;
+    idata->cb (QOF_INSTANCE(split), idata->data);
+    return 0;
+}
+
+static gboolean
+param_path_is (QofQueryParamList *path, const char *first, const char *second)
+{
+    return path && path->next && !path->next->next &&
+           !g_strcmp0 (path->data, first) &&
+           !g_strcmp0 (path->next->data, second);
+}
+
+static gboolean
+param_path_is_one (QofQueryParamList *path, const char *name)
+{
+    return path && !path->next && !g_strcmp0 (path->data, name);
+}
+
+static gboolean
+split_query_index (QofQuery *q, QofBook *book, QofInstanceForeachCB cb,
+                   gpointer user_data)
+{
+    GList *accounts = NULL, *or_ptr, *and_ptr, *node;
+    time64 start = G_MAXINT64, end = G_MININT64;
+    gboolean unreconciled_only = TRUE;
+    SplitIndexData idata = { cb, user_data };
+
+    /* A split of an open transaction may already be in an account it
+     * isn't yet listed under, or have a different date or reconcile
+     * state than the one it's filed by, so scan the collection. */
+    if (xaccBookHasOpenTrans (book))
+        return FALSE;
+
+    /* Every OR branch has to pin the split to a set of accounts, or some
+     * matches could live outside the accounts we'd walk. */
+    for (or_ptr = qof_query_get_terms (q); or_ptr; or_ptr = or_ptr->next)
+    {
+        gboolean have_accounts = FALSE, branch_unreconciled = FALSE;
+        time64 branch_start = G_MININT64, branch_end = G_MAXINT64;
+
+        for (and_ptr = or_ptr->data; and_ptr; and_ptr = and_ptr->next)
+        {
+            QofQueryTerm *qt = and_ptr->data;
+            QofQueryParamList *path = qof_query_term_get_param_path (qt);
+            QofQueryPredData *pd = qof_query_term_get_pred_data (qt);
+
+            if (qof_query_term_is_inverted (qt))
+                continue;
+
+            if (!have_accounts &&
+                param_path_is (path, SPLIT_ACCOUNT, QOF_PARAM_GUID) &&
+                !g_strcmp0 (pd->type_name, QOF_TYPE_GUID) &&
+                ((query_guid_t)pd)->options == QOF_GUID_MATCH_ANY)
+            {
+                for (node = ((query_guid_t)pd)->guids; node; node = node->next)
+                {
+                    Account *acc = xaccAccountLookup (node->data, book);
+                    if (acc && !g_list_find (accounts, acc))
+                        accounts = g_list_prepend (accounts, acc);
+                }
+                have_accounts = TRUE;
+            }
+            else if (param_path_is (path, SPLIT_TRANS, TRANS_DATE_POSTED) &&
+                     !g_strcmp0 (pd->type_name, QOF_TYPE_DATE) &&
+                     ((query_date_t)pd)->options == QOF_DATE_MATCH_NORMAL)
+            {
+                time64 date = ((query_date_t)pd)->date;
+                switch (pd->how)
+                {
+                case QOF_COMPARE_GT:
+                case QOF_COMPARE_GTE:
+                    branch_start = MAX (branch_start, date);
+                    break;
+                case QOF_COMPARE_LT:
+                case QOF_COMPARE_LTE:
+                    branch_end = MIN (branch_end, date);
+                    break;
+                case QOF_COMPARE_EQUAL:
+                    branch_start = MAX (branch_start, date);
+                    branch_end = MIN (branch_end, date);
+                    break;
+                default:
+                    break;
+                }
+            }
+            else if (param_path_is_one (path, SPLIT_RECONCILE) &&
+                     !g_strcmp0 (pd->type_name, QOF_TYPE_CHAR) &&
+                     ((query_char_t)pd)->options == QOF_CHAR_MATCH_ANY &&
+                     !strchr (((query_char_t)pd)->char_list, YREC))
+                branch_unreconciled = TRUE;
+        }
+
+        if (!have_accounts)
+        {
+            g_list_free (accounts);
+            return FALSE;
+        }
+        start = MIN (start, branch_start);
+        end = MAX (end, branch_end);
+        unreconciled_only = unreconciled_only && branch_unreconciled;
+    }
+
+    /* A split has exactly one account, so no split is visited twice.
+     * Without a date bound walk the whole list: the range traversal
+     * skips splits that have no transaction yet. */
+    for (node = accounts; node; node = node->next)
+    {
+        if (unreconciled_only)
+        {
+            GList *splits = xaccAccountGetUnreconciledSplits (node->data);
+            GList *splits_node;
+            for (splits_node = splits; splits_node;
+                 splits_node = splits_node->next)
+                cb (splits_node->data, user_data);
+            g_list_free (splits);
+        }
+        else if (start == G_MININT64 && end == G_MAXINT64)
+        {
+            GList *splits;
+            for (splits = xaccAccountGetSplitList (node->data); splits;
+                 splits = splits->next)
+                cb (splits->data, user_data);
+        }
+        else
+            xaccAccountForEachSplitInRange (node->data, start, end,
+                                            split_index_visit, &idata);
+    }
+    g_list_free (accounts);
+    return TRUE;
+}
+
+/* A split matches on its transaction's fields, which are edited
+ * without modifying the split. */
+static void
+split_query_related (QofInstance *inst, QofInstanceForeachCB cb,
+                     gpointer user_data)
+{
+    GList *node;
+
+    for (node = xaccTransGetSplitList (GNC_TRANSACTION (inst)); node;
+         node = node->next)
+        cb (QOF_INSTANCE (node->data), user_data);
+}
+
 gboolean xaccSplitRegister (void)
 {
     static const QofParam params[] =
@@ -2353,6 +2642,8 @@ gboolean xaccSplitRegister (void)
                         NULL);
     qof_class_register (SPLIT_CORR_ACCT_CODE,
                         (QofSortFunc)xaccSplitCompareOtherAccountCodes, NULL);
+    qof_query_register_index (GNC_ID_SPLIT, split_query_index);
+    qof_query_register_related (GNC_ID_SPLIT, GNC_ID_TRANS, split_query_related);
 
     return qof_object_register (&split_object_def);
 }
@@ -68,6 +68,25 @@
 #define GAINS_STATUS_VDIRTY    (GAINS_STATUS_VALU_DIRTY)
 #define GAINS_STATUS_A_VDIRTY  (GAINS_STATUS_AMNT_DIRTY|GAINS_STATUS_VALU_DIRTY|GAINS_STATUS_LOT_DIRTY)
 
+/* A sort key for a num or action string: the leading integer that
+ * xaccTransOrder compares numerically, parsed once, and the text after
+ * it.  The key is valid while src is the string it was parsed from.
+ * The setters fill it, so that a freed and reused string cache entry
+ * can't be taken for the old one, and so that the comparators only
+ * read it: accounts sort their splits on several threads at once. */
+typedef struct
+{
+    const char *src;
+    guint64 value;
+    const char *rest;
+} GncNumSortKey;
+
+void gnc_num_sort_key_set (GncNumSortKey *key, const char *str);
+/* Returns key if it holds str, else parses str into scratch. */
+const GncNumSortKey *gnc_num_sort_key_get (const GncNumSortKey *key,
+                                           const char *str,
+                                           GncNumSortKey *scratch);
+
 struct split_s
 {
     QofInstance inst;
@@ -92,6 +111,7 @@ struct split_s
      * can be used to create custom reports or graphs of data.
      */
     char  * action;            /* Buy, Sell, Div, etc.                      */
+    GncNumSortKey action_sort_key;
 
     time64 date_reconciled;  /* date split was reconciled                 */
     char   reconciled;        /* The reconciled field                      */
@@ -150,7 +170,27 @@ void  xaccFreeSplit (Split *split);    /* frees memory */
 Split *xaccSplitCloneNoKvp (const Split *s);
 void xaccSplitCopyKvp (const Split *from, Split *to);
 
+/* A book's free list of thrown away rollback copies. */
+typedef struct
+{
+    GSList *items;
+    guint size;
+} GncCopyPool;
+
+/* The pool kept under key in book, made if create is set unless the
+ * book is being destroyed; NULL if there is none. */
+GncCopyPool *gnc_copy_pool_get (QofBook *book, const char *key,
+                                gboolean create);
+/* Unref everything in book's pool under key and drop the pool. */
+void gnc_copy_pool_drain (QofBook *book, const char *key);
+
 Split *xaccDupeSplit (const Split *s);
+/* Free a rollback copy made by xaccDupeSplit.  Unless something else
+ * still holds a reference to it, the copy is kept in its book for the
+ * next xaccDupeSplit to reuse.  xaccSplitDrainCopyPool frees the ones
+ * kept in book. */
+void xaccSplitFreeCopy (Split *split);
+void xaccSplitDrainCopyPool (QofBook *book);
 void mark_split (Split *s);
 
 void xaccSplitVoid(Split *split);
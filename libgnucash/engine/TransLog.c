@@ -85,6 +85,7 @@ static QofLogModule log_module = "gnc.translog";
 
 
 static int gen_logs = 1;
+static int log_batch = 0; /**< xaccLogBeginBatch nesting depth */
 static FILE * trans_log = NULL; /**< current log file handle */
 static char * trans_log_name = NULL; /**< current log file name */
 static char * log_base_name = NULL;
@@ -101,6 +102,17 @@ void xaccLogEnable  (void)
     gen_logs = 1;
 }
 
+void xaccLogBeginBatch (void)
+{
+    log_batch++;
+}
+void xaccLogEndBatch (void)
+{
+    g_return_if_fail (log_batch > 0);
+    if (--log_batch == 0 && trans_log)
+        fflush (trans_log);
+}
+
 /********************************************************************\
 \********************************************************************/
 
@@ -219,14 +231,38 @@ xaccCloseLog (void)
 /********************************************************************\
 \********************************************************************/
 
+/* The last time converted for one of the log's date columns. Over a
+ * bulk import the current time, the entry and post dates and the
+ * (usually unset) reconcile date repeat from one record to the next, so
+ * most of the conversions can be skipped. */
+typedef struct
+{
+    gboolean valid;
+    time64 time;
+    char str[100];
+} LogTimeCache;
+
+static const char *
+log_time_str (LogTimeCache *cache, time64 time)
+{
+    if (!cache->valid || cache->time != time)
+    {
+        gnc_time64_to_iso8601_buff (time, cache->str);
+        cache->time = time;
+        cache->valid = TRUE;
+    }
+    return cache->str;
+}
+
 void
 xaccTransWriteLog (Transaction *trans, char flag)
 {
+    static LogTimeCache now_cache, entered_cache, posted_cache, recn_cache;
     GList *node;
     char trans_guid_str[GUID_ENCODING_LENGTH + 1];
     char split_guid_str[GUID_ENCODING_LENGTH + 1];
     const char *trans_notes;
-    char dnow[100], dent[100], dpost[100], drecn[100];
+    const char *dnow, *dent, *dpost;
 
     if (!gen_logs)
     {
@@ -235,16 +271,15 @@ xaccTransWriteLog (Transaction *trans, char flag)
     }
     if (!trans_log) return;
 
-    gnc_time64_to_iso8601_buff (gnc_time(NULL), dnow);
-    gnc_time64_to_iso8601_buff (trans->date_entered, dent);
-    gnc_time64_to_iso8601_buff (trans->date_posted, dpost);
+    dnow = log_time_str (&now_cache, gnc_time (NULL));
+    dent = log_time_str (&entered_cache, trans->date_entered);
+    dpost = log_time_str (&posted_cache, trans->date_posted);
     guid_to_string_buff (xaccTransGetGUID(trans), trans_guid_str);
     trans_notes = xaccTransGetNotes(trans);
     fprintf (trans_log, "===== START\n");
 
     for (node = trans->splits; node; node = node->next)
     {
-        time64 time;
         Split *split = node->data;
         const char * accname = "";
         char acc_guid_str[GUID_ENCODING_LENGTH + 1];
@@ -261,8 +296,6 @@ xaccTransWriteLog (Transaction *trans, char flag)
             acc_guid_str[0] = '\0';
         }
 
-        gnc_time64_to_iso8601_buff (split->date_reconciled, drecn);
-
         guid_to_string_buff (xaccSplitGetGUID(split), split_guid_str);
         amt = xaccSplitGetAmount (split);
         val = xaccSplitGetValue (split);
@@ -291,13 +324,14 @@ xaccTransWriteLog (Transaction *trans, char flag)
                  gnc_numeric_num(val),
                  gnc_numeric_denom(val),
                  /* The next string always exists. No need to test it. */
-                 drecn);
+                 log_time_str (&recn_cache, split->date_reconciled));
     }
 
     fprintf (trans_log, "===== END\n");
 
-    /* get data out to the disk */
-    fflush (trans_log);
+    /* get data out to the disk, once per batch if there is one */
+    if (!log_batch)
+        fflush (trans_log);
 }
 
 /************************ END OF ************************************\
@@ -71,6 +71,12 @@ void    xaccLogEnable (void);
 /** document me */
 void    xaccLogDisable (void);
 
+/** Between xaccLogBeginBatch() and the matching xaccLogEndBatch() the
+ *  log entries are still written but only flushed to disk once, at the
+ *  end.  Calls may be nested. */
+void    xaccLogBeginBatch (void);
+void    xaccLogEndBatch (void);
+
 /** The xaccLogSetBaseName() method sets the base filepath and the
  *    root part of the journal file name.  If the journal file is
  *    already open, it will close it and reopen it with the new
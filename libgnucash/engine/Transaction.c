@@ -228,6 +228,65 @@ xaccTransStillHasSplit(const Transaction *trans, const Split *s)
         }                                                               \
     }
 
+static void
+trans_split_vec_clear (Transaction *trans)
+{
+    if (trans->split_vec != trans->split_vec_inline)
+        g_free (trans->split_vec);
+    trans->split_vec = NULL;
+    trans->split_vec_len = 0;
+    trans->split_vec_alloc = 0;
+    trans->split_vec_gen = 0;
+    trans->split_vec_head = NULL;
+}
+
+/* Return the transaction's live splits as an array, rebuilding it if
+ * the splits may have changed since it was last made. */
+static Split * const *
+trans_get_split_vec (const Transaction *t, guint *n_splits)
+{
+    Transaction *trans = (Transaction*)t;
+    guint n = 0;
+    GList *node;
+
+    if (trans->split_vec && trans->split_vec_gen == trans->edit_generation &&
+        trans->split_vec_head == trans->splits)
+    {
+        *n_splits = trans->split_vec_len;
+        return trans->split_vec;
+    }
+
+    for (node = trans->splits; node; node = node->next)
+        if (xaccTransStillHasSplit (trans, node->data))
+            n++;
+
+    if (n <= TRANS_INLINE_SPLITS)
+    {
+        if (trans->split_vec != trans->split_vec_inline)
+            g_free (trans->split_vec);
+        trans->split_vec = trans->split_vec_inline;
+        trans->split_vec_alloc = 0;
+    }
+    else if (n > trans->split_vec_alloc)
+    {
+        if (trans->split_vec != trans->split_vec_inline)
+            g_free (trans->split_vec);
+        trans->split_vec = g_new (Split*, n);
+        trans->split_vec_alloc = n;
+    }
+
+    n = 0;
+    for (node = trans->splits; node; node = node->next)
+        if (xaccTransStillHasSplit (trans, node->data))
+            trans->split_vec[n++] = node->data;
+
+    trans->split_vec_len = n;
+    trans->split_vec_gen = trans->edit_generation;
+    trans->split_vec_head = trans->splits;
+    *n_splits = n;
+    return trans->split_vec;
+}
+
 static inline void mark_trans (Transaction *trans);
 void mark_trans (Transaction *trans)
 {
@@ -264,6 +323,7 @@ gnc_transaction_init(Transaction* trans)
     ENTER ("trans=%p", trans);
     /* Fill in some sane defaults */
     trans->num         = CACHE_INSERT("");
+    gnc_num_sort_key_set (&trans->num_sort_key, trans->num);
     trans->description = CACHE_INSERT("");
     trans->common_currency = NULL;
     trans->splits = NULL;
@@ -274,6 +334,16 @@ gnc_transaction_init(Transaction* trans)
     trans->readonly_reason = NULL;
     trans->reason_cache_valid = FALSE;
     trans->isClosingTxn_cached = -1;
+    trans->edit_generation = 1;
+    trans->imbal_value_gen = 0;
+    trans->imbal_list_gen = 0;
+    trans->imbal_list_cached = NULL;
+    trans->balanced_gen = 0;
+    trans->split_vec = NULL;
+    trans->split_vec_len = 0;
+    trans->split_vec_alloc = 0;
+    trans->split_vec_gen = 0;
+    trans->split_vec_head = NULL;
     LEAVE (" ");
 }
 
@@ -589,6 +659,37 @@ xaccTransSortSplits (Transaction *trans)
 
 /********************************************************************\
 \********************************************************************/
+/* Rollback copies made by dupe_trans are thrown away by every commit,
+ * so free_trans_copy keeps a bounded number of them in their book for
+ * reuse instead of going through g_object_new and finalize every time. */
+#define TRANS_COPY_POOL_MAX 256
+#define TRANS_COPY_POOL_KEY "gnc-trans-copy-pool"
+
+/* The number of transactions in each book that are open for editing,
+ * i.e. that hold a rollback copy.  The data table is gone by the time
+ * a book that is shutting down frees its transactions, so those aren't
+ * counted. */
+#define TRANS_OPEN_COUNT_KEY "gnc-trans-open-count"
+
+static void
+trans_count_open (const Transaction *trans, gint delta)
+{
+    QofBook *book = qof_instance_get_book (trans);
+    gint count;
+
+    if (!book || qof_book_shutting_down (book)) return;
+    count = GPOINTER_TO_INT (qof_book_get_data (book, TRANS_OPEN_COUNT_KEY));
+    qof_book_set_data (book, TRANS_OPEN_COUNT_KEY,
+                       GINT_TO_POINTER (count + delta));
+}
+
+gboolean
+xaccBookHasOpenTrans (const QofBook *book)
+{
+    if (!book || qof_book_shutting_down (book)) return FALSE;
+    return GPOINTER_TO_INT (qof_book_get_data (book, TRANS_OPEN_COUNT_KEY)) > 0;
+}
+
 /* This routine is not exposed externally, since it does weird things,
  * like not really owning the splits correctly, and other weirdnesses.
  * This routine is prone to programmer snafu if not used correctly.
@@ -597,13 +698,23 @@ xaccTransSortSplits (Transaction *trans)
 static Transaction *
 dupe_trans (const Transaction *from)
 {
+    GncCopyPool *pool = gnc_copy_pool_get (qof_instance_get_book (from),
+                                           TRANS_COPY_POOL_KEY, FALSE);
     Transaction *to;
     GList *node;
 
-    to = g_object_new (GNC_TYPE_TRANSACTION, NULL);
+    if (pool && pool->items)
+    {
+        to = pool->items->data;
+        pool->items = g_slist_delete_link (pool->items, pool->items);
+        pool->size--;
+    }
+    else
+        to = g_object_new (GNC_TYPE_TRANSACTION, NULL);
 
     to->num         = CACHE_INSERT (from->num);
     to->description = CACHE_INSERT (from->description);
+    gnc_num_sort_key_set (&to->num_sort_key, to->num);
 
     to->splits = g_list_copy (from->splits);
     for (node = to->splits; node; node = node->next)
@@ -648,6 +759,7 @@ xaccTransCloneNoKvp (const Transaction *from)
     to->date_entered    = from->date_entered;
     to->date_posted     = from->date_posted;
     to->num             = CACHE_INSERT (from->num);
+    gnc_num_sort_key_set (&to->num_sort_key, to->num);
     to->description     = CACHE_INSERT (from->description);
     to->common_currency = from->common_currency;
     qof_instance_copy_version(to, from);
@@ -788,6 +900,59 @@ xaccTransCopyFromClipBoard(const Transaction *from_trans, Transaction *to_trans,
 /********************************************************************\
  Free the transaction.
 \********************************************************************/
+static void xaccFreeTransaction (Transaction *trans);
+
+/* Free a rollback copy made by dupe_trans, keeping it and its splits
+ * for reuse unless something else still holds a reference to it. */
+static void
+free_trans_copy (Transaction *orig)
+{
+    GncCopyPool *pool;
+    GList *node;
+
+    if (!orig) return;
+    pool = gnc_copy_pool_get (qof_instance_get_book (orig),
+                              TRANS_COPY_POOL_KEY, TRUE);
+    if (!pool || G_OBJECT (orig)->ref_count != 1 ||
+        pool->size >= TRANS_COPY_POOL_MAX)
+    {
+        xaccFreeTransaction (orig);
+        return;
+    }
+
+    for (node = orig->splits; node; node = node->next)
+        xaccSplitFreeCopy (node->data);
+    g_list_free (orig->splits);
+    orig->splits = NULL;
+
+    CACHE_REMOVE (orig->num);
+    CACHE_REMOVE (orig->description);
+    orig->num = NULL;
+    orig->description = NULL;
+    g_free (orig->readonly_reason);
+    orig->readonly_reason = NULL;
+    orig->reason_cache_valid = FALSE;
+    orig->isClosingTxn_cached = -1;
+    gnc_monetary_list_free (orig->imbal_list_cached);
+    orig->imbal_list_cached = NULL;
+    orig->imbal_value_gen = 0;
+    orig->imbal_list_gen = 0;
+    orig->balanced_gen = 0;
+    trans_split_vec_clear (orig);
+    orig->marker = 0;
+    qof_instance_mark_clean (QOF_INSTANCE (orig));
+
+    pool->items = g_slist_prepend (pool->items, orig);
+    pool->size++;
+}
+
+static void
+drain_trans_copy_pool (QofBook *book)
+{
+    gnc_copy_pool_drain (book, TRANS_COPY_POOL_KEY);
+    xaccSplitDrainCopyPool (book);
+}
+
 static void
 xaccFreeTransaction (Transaction *trans)
 {
@@ -813,6 +978,9 @@ xaccFreeTransaction (Transaction *trans)
     CACHE_REMOVE(trans->num);
     CACHE_REMOVE(trans->description);
     g_free (trans->readonly_reason);
+    gnc_monetary_list_free (trans->imbal_list_cached);
+    trans->imbal_list_cached = NULL;
+    trans_split_vec_clear (trans);
 
     /* Just in case someone looks up freed memory ... */
     trans->num         = (char *) 1;
@@ -823,6 +991,7 @@ xaccFreeTransaction (Transaction *trans)
     trans->reason_cache_valid = FALSE;
     if (trans->orig)
     {
+        trans_count_open (trans, -1);
         xaccFreeTransaction (trans->orig);
         trans->orig = NULL;
     }
@@ -1036,24 +1205,49 @@ xaccTransLookup (const GncGUID *guid, QofBook *book)
 /********************************************************************\
 \********************************************************************/
 
+void
+xaccTransBumpEditGeneration (Transaction *trans)
+{
+    if (!trans) return;
+    if (++trans->edit_generation == 0)
+        trans->edit_generation = 1;
+}
+
+static MonetaryList *
+monetary_list_copy (MonetaryList *list)
+{
+    MonetaryList *copy = NULL, *node;
+
+    for (node = g_list_last (list); node; node = node->prev)
+        copy = gnc_monetary_list_add_monetary (copy,
+                                               *(gnc_monetary*)node->data);
+    return copy;
+}
+
 gnc_numeric
 xaccTransGetImbalanceValue (const Transaction * trans)
 {
+    Transaction *trans_nonconst = (Transaction*) trans;
     gnc_numeric imbal = gnc_numeric_zero();
     if (!trans) return imbal;
 
+    if (trans->imbal_value_gen == trans->edit_generation)
+        return trans->imbal_value_cached;
+
     ENTER("(trans=%p)", trans);
     /* Could use xaccSplitsComputeValue, except that we want to use
        GNC_HOW_DENOM_EXACT */
     FOR_EACH_SPLIT(trans, imbal =
                        gnc_numeric_add(imbal, xaccSplitGetValue(s),
                                        GNC_DENOM_AUTO, GNC_HOW_DENOM_EXACT));
+    trans_nonconst->imbal_value_cached = imbal;
+    trans_nonconst->imbal_value_gen = trans->edit_generation;
     LEAVE("(trans=%p) imbal=%s", trans, gnc_num_dbg_to_string(imbal));
     return imbal;
 }
 
-MonetaryList *
-xaccTransGetImbalance (const Transaction * trans)
+static MonetaryList *
+trans_compute_imbalance (const Transaction * trans, gboolean trading_accts)
 {
     /* imbal_value is used if either (1) the transaction has a non currency
        split or (2) all the splits are in the same currency.  If there are
@@ -1061,14 +1255,9 @@ xaccTransGetImbalance (const Transaction * trans)
        imbal_list is used to compute the imbalance. */
     MonetaryList *imbal_list = NULL;
     gnc_numeric imbal_value = gnc_numeric_zero();
-    gboolean trading_accts;
-
-    if (!trans) return imbal_list;
 
     ENTER("(trans=%p)", trans);
 
-    trading_accts = xaccTransUseTradingAccounts (trans);
-
     /* If using trading accounts and there is at least one split that is not
        in the transaction currency or a split that has a price or exchange
        rate other than 1, then compute the balance in each commodity in the
@@ -1124,17 +1313,42 @@ xaccTransGetImbalance (const Transaction * trans)
     return imbal_list;
 }
 
-gboolean
-xaccTransIsBalanced (const Transaction *trans)
+/* Return the cached list of imbalances, computing it first if it is
+ * out of date.  The list stays owned by the transaction. */
+static MonetaryList *
+trans_get_cached_imbalance (const Transaction *trans, gboolean trading_accts)
+{
+    Transaction *trans_nonconst = (Transaction*) trans;
+
+    if (trans->imbal_list_gen != trans->edit_generation ||
+        trans->imbal_list_trading != trading_accts)
+    {
+        gnc_monetary_list_free (trans_nonconst->imbal_list_cached);
+        trans_nonconst->imbal_list_cached =
+            trans_compute_imbalance (trans, trading_accts);
+        trans_nonconst->imbal_list_gen = trans->edit_generation;
+        trans_nonconst->imbal_list_trading = trading_accts;
+    }
+    return trans->imbal_list_cached;
+}
+
+MonetaryList *
+xaccTransGetImbalance (const Transaction * trans)
+{
+    if (!trans) return NULL;
+
+    /* The caller owns the returned list, so hand out a copy. */
+    return monetary_list_copy (
+        trans_get_cached_imbalance (trans, xaccTransUseTradingAccounts (trans)));
+}
+
+static gboolean
+trans_compute_is_balanced (const Transaction *trans, gboolean trading_accts)
 {
-    MonetaryList *imbal_list;
-    gboolean result;
     gnc_numeric imbal = gnc_numeric_zero();
     gnc_numeric imbal_trading = gnc_numeric_zero();
 
-    if (trans == NULL) return FALSE;
-
-    if (xaccTransUseTradingAccounts(trans))
+    if (trading_accts)
     {
         /* Transaction is imbalanced if the value is imbalanced in either
            trading or non-trading splits.  One can't be used to balance
@@ -1161,13 +1375,30 @@ xaccTransIsBalanced (const Transaction *trans)
     if (! gnc_numeric_zero_p(imbal) || ! gnc_numeric_zero_p(imbal_trading))
         return FALSE;
 
-    if (!xaccTransUseTradingAccounts (trans))
+    if (!trading_accts)
         return TRUE;
 
-    imbal_list = xaccTransGetImbalance(trans);
-    result = imbal_list == NULL;
-    gnc_monetary_list_free(imbal_list);
-    return result;
+    return trans_get_cached_imbalance (trans, trading_accts) == NULL;
+}
+
+gboolean
+xaccTransIsBalanced (const Transaction *trans)
+{
+    Transaction *trans_nonconst = (Transaction*) trans;
+    gboolean trading_accts;
+
+    if (trans == NULL) return FALSE;
+
+    trading_accts = xaccTransUseTradingAccounts (trans);
+    if (trans->balanced_gen != trans->edit_generation ||
+        trans->balanced_trading != trading_accts)
+    {
+        trans_nonconst->balanced_cached =
+            trans_compute_is_balanced (trans, trading_accts);
+        trans_nonconst->balanced_gen = trans->edit_generation;
+        trans_nonconst->balanced_trading = trading_accts;
+    }
+    return trans->balanced_cached;
 }
 
 gnc_numeric
@@ -1415,6 +1646,7 @@ xaccTransSetCurrency (Transaction *trans, gnc_commodity *curr)
     xaccTransBeginEdit(trans);
 
     trans->common_currency = curr;
+    xaccTransBumpEditGeneration (trans);
     if (old_curr != NULL && trans->splits != NULL)
     {
         gnc_numeric rate = find_new_rate(trans, curr);
@@ -1453,6 +1685,7 @@ xaccTransBeginEdit (Transaction *trans)
     /* Make a clone of the transaction; we will use this
      * in case we need to roll-back the edit. */
     trans->orig = dupe_trans (trans);
+    trans_count_open (trans, 1);
 }
 
 /********************************************************************\
@@ -1559,8 +1792,13 @@ static gboolean was_trans_emptied(Transaction *trans)
     return TRUE;
 }
 
+/* The error of the last failed commit, for xaccTransCommitEditBatch. */
+static QofBackendError last_commit_error = ERR_BACKEND_NO_ERR;
+
 static void trans_on_error(Transaction *trans, QofBackendError errcode)
 {
+    last_commit_error = errcode;
+
     /* If the backend puked, then we must roll-back
      * at this point, and let the user know that we failed.
      * The GUI should check for error conditions ...
@@ -1620,7 +1858,9 @@ static void trans_cleanup_commit(Transaction *trans)
     /* Get rid of the copy we made. We won't be rolling back,
      * so we don't need it any more.  */
     PINFO ("get rid of rollback trans=%p", trans->orig);
-    xaccFreeTransaction (trans->orig);
+    if (trans->orig)
+        trans_count_open (trans, -1);
+    free_trans_copy (trans->orig);
     trans->orig = NULL;
 
     /* Sort the splits. Why do we need to do this ?? */
@@ -1651,6 +1891,7 @@ xaccTransCommitEdit (Transaction *trans)
      * so other functions don't result in a recursive
      * call to xaccTransCommitEdit. */
     qof_instance_increase_editlevel(trans);
+    xaccTransBumpEditGeneration (trans);
 
     if (was_trans_emptied(trans))
         qof_instance_set_destroying(trans, TRUE);
@@ -1699,6 +1940,116 @@ xaccTransCommitEdit (Transaction *trans)
     LEAVE ("(trans=%p)", trans);
 }
 
+static GncTransCommitStatus
+trans_batch_validate (const Transaction *trans)
+{
+    if (qof_instance_get_editlevel (trans) != 1)
+        return GNC_TRANS_COMMIT_NOT_OPEN;
+    if (qof_instance_get_destroying (trans) || was_trans_emptied ((Transaction*)trans))
+        return GNC_TRANS_COMMIT_OK;
+    if (!trans->common_currency)
+        return GNC_TRANS_COMMIT_NO_CURRENCY;
+    FOR_EACH_SPLIT (trans, if (!s->acc) return GNC_TRANS_COMMIT_NO_ACCOUNT);
+    return GNC_TRANS_COMMIT_OK;
+}
+
+static guint
+trans_commit_batch (Transaction **trans, guint n_trans,
+                    GncTransCommitStatus *status,
+                    QofPercentageFunc percentagefunc, const char *message)
+{
+    GHashTable *accounts;
+    GList *committed = NULL, *node;
+    QofBackend *be = NULL;
+    guint i, n_failed = 0;
+
+    if (!trans || n_trans == 0) return 0;
+    ENTER ("(n_trans=%u)", n_trans);
+
+    for (i = 0; i < n_trans && !be; i++)
+        if (trans[i])
+            be = qof_book_get_backend (xaccTransGetBook (trans[i]));
+
+    accounts = g_hash_table_new (g_direct_hash, g_direct_equal);
+    qof_event_suspend ();
+    xaccLogBeginBatch ();
+    qof_backend_begin_batch (be);
+    for (i = 0; i < n_trans; i++)
+    {
+        Transaction *t = trans[i];
+        GncTransCommitStatus result = GNC_TRANS_COMMIT_NOT_OPEN;
+        gboolean going;
+
+        if (percentagefunc && i % 10 == 0)
+            (percentagefunc)(message, (100.0 * i) / n_trans);
+
+        if (t)
+            result = trans_batch_validate (t);
+        if (result != GNC_TRANS_COMMIT_OK)
+        {
+            PINFO ("not committing trans=%p: status %d", t, result);
+            if (status) status[i] = result;
+            n_failed++;
+            continue;
+        }
+
+        /* A transaction that is going away is freed by its commit, so
+         * nothing may look at it afterwards. */
+        going = qof_instance_get_destroying (t) || was_trans_emptied (t);
+        FOR_EACH_SPLIT (t, if (s->acc) g_hash_table_add (accounts, s->acc));
+
+        last_commit_error = ERR_BACKEND_NO_ERR;
+        xaccTransCommitEdit (t);
+        if (last_commit_error != ERR_BACKEND_NO_ERR)
+        {
+            result = GNC_TRANS_COMMIT_BACKEND_ERROR;
+            n_failed++;
+        }
+        else if (!going)
+            committed = g_list_prepend (committed, t);
+        if (status) status[i] = result;
+    }
+    /* If the backend couldn't write the batch, nothing in it was
+     * saved, even what was committed without an error. */
+    if (!qof_backend_commit_batch (be))
+    {
+        PWARN ("The backend failed to write the batch");
+        for (i = 0; i < n_trans && status; i++)
+            if (status[i] == GNC_TRANS_COMMIT_OK)
+                status[i] = GNC_TRANS_COMMIT_BACKEND_ERROR;
+        for (node = committed; node; node = node->next)
+            qof_instance_set_dirty (QOF_INSTANCE (node->data));
+        n_failed = n_trans;
+    }
+    xaccLogEndBatch ();
+    qof_event_resume ();
+
+    /* The events suppressed above come out as one per transaction and
+     * one per account, instead of several for every split. */
+    for (node = committed; node; node = node->next)
+        qof_event_gen (QOF_INSTANCE (node->data), QOF_EVENT_MODIFY, NULL);
+    {
+        GHashTableIter iter;
+        gpointer acc;
+
+        g_hash_table_iter_init (&iter, accounts);
+        while (g_hash_table_iter_next (&iter, &acc, NULL))
+            qof_event_gen (QOF_INSTANCE (acc), QOF_EVENT_MODIFY, NULL);
+    }
+    g_list_free (committed);
+    g_hash_table_destroy (accounts);
+
+    LEAVE ("(n_failed=%u)", n_failed);
+    return n_failed;
+}
+
+guint
+xaccTransCommitEditBatch (Transaction **trans, guint n_trans,
+                          GncTransCommitStatus *status)
+{
+    return trans_commit_batch (trans, n_trans, status, NULL, NULL);
+}
+
 #define SWAP(a, b) do { gpointer tmp = (a); (a) = (b); (b) = tmp; } while (0);
 
 /* Ughhh. The Rollback function is terribly complex, and, what's worse,
@@ -1739,6 +2090,7 @@ xaccTransRollbackEdit (Transaction *trans)
 
     orig = trans->orig;
     SWAP(trans->num, orig->num);
+    gnc_num_sort_key_set (&trans->num_sort_key, trans->num);
     SWAP(trans->description, orig->description);
     trans->date_entered = orig->date_entered;
     trans->date_posted = orig->date_posted;
@@ -1772,12 +2124,18 @@ xaccTransRollbackEdit (Transaction *trans)
             s->reconciled = so->reconciled;
             s->amount = so->amount;
             s->value = so->value;
+            /* the lot's cached balance may include the edited amount */
+            if (s->lot) gnc_lot_set_closed_unknown (s->lot);
             s->lot = so->lot;
+            if (s->lot) gnc_lot_set_closed_unknown (s->lot);
             s->gains_split = so->gains_split;
             //SET_GAINS_A_VDIRTY(s);
             s->date_reconciled = so->date_reconciled;
+            /* the account indexes the reconcile state */
+            if (s->acc)
+                gnc_account_split_changed (s->acc, s);
             qof_instance_mark_clean(QOF_INSTANCE(s));
-            xaccFreeSplit(so);
+            xaccSplitFreeCopy(so);
         }
         else
         {
@@ -1806,6 +2164,7 @@ xaccTransRollbackEdit (Transaction *trans)
     g_list_free(slist);
     g_list_free(orig->splits);
     orig->splits = NULL;
+    xaccTransBumpEditGeneration (trans);
 
     /* Now that the engine copy is back to its original version,
      * get the backend to fix it in the database */
@@ -1852,7 +2211,9 @@ xaccTransRollbackEdit (Transaction *trans)
     if (!qof_book_is_readonly(qof_instance_get_book(trans)))
         xaccTransWriteLog (trans, 'R');
 
-    xaccFreeTransaction (trans->orig);
+    if (trans->orig)
+        trans_count_open (trans, -1);
+    free_trans_copy (trans->orig);
 
     trans->orig = NULL;
     qof_instance_set_destroying(trans, FALSE);
@@ -1891,22 +2252,40 @@ xaccTransOrder (const Transaction *ta, const Transaction *tb)
  * be ordered lexically.
  */
 
+void
+gnc_num_sort_key_set (GncNumSortKey *key, const char *str)
+{
+     char *end = NULL;
+
+     if (!str) str = "";
+     key->value = strtoull (str, &end, 10);
+     key->rest = end;
+     key->src = str;
+}
+
+const GncNumSortKey *
+gnc_num_sort_key_get (const GncNumSortKey *key, const char *str,
+                      GncNumSortKey *scratch)
+{
+     if ((str ? str : "") == key->src)
+          return key;
+     gnc_num_sort_key_set (scratch, str);
+     return scratch;
+}
+
 static int
-order_by_int64_or_string (const char* a, const char* b)
+order_by_num_sort_key (const GncNumSortKey *a, const GncNumSortKey *b)
 {
-     char *end_a = NULL, *end_b = NULL;
      int cmp = 0;
-     uint64_t na = strtoull(a, &end_a, 10);
-     uint64_t nb = strtoull(b, &end_b, 10);
-     if (na && nb)
+     if (a->value && b->value)
      {
-          if (na != nb)
-               return na < nb ? -1 : 1;
-          cmp = g_utf8_collate(end_a, end_b);
+          if (a->value != b->value)
+               return a->value < b->value ? -1 : 1;
+          cmp = strcmp (a->rest, b->rest) ? g_utf8_collate (a->rest, b->rest) : 0;
      }
      else
      {
-          cmp = g_utf8_collate(a, b);
+          cmp = strcmp (a->src, b->src) ? g_utf8_collate (a->src, b->src) : 0;
      }
      return cmp < 0 ? -1 : cmp > 0 ? 1 : 0;
 }
@@ -1915,9 +2294,26 @@ int
 xaccTransOrder_num_action (const Transaction *ta, const char *actna,
                             const Transaction *tb, const char *actnb)
 {
+    GncNumSortKey ka, kb;
+
+    /* The action strings aren't owned by the transactions, so they're
+     * parsed into throwaway keys. */
+    if (actna && actnb)
+    {
+        gnc_num_sort_key_set (&ka, actna);
+        gnc_num_sort_key_set (&kb, actnb);
+        return xaccTransOrderBySortKey (ta, &ka, tb, &kb);
+    }
+    return xaccTransOrderBySortKey (ta, NULL, tb, NULL);
+}
+
+int
+xaccTransOrderBySortKey (const Transaction *ta, const GncNumSortKey *keya,
+                         const Transaction *tb, const GncNumSortKey *keyb)
+{
+    GncNumSortKey scratcha, scratchb;
     char *da, *db;
     int retval;
-    int64_t na, nb;
 
     if ( ta && !tb ) return -1;
     if ( !ta && tb ) return +1;
@@ -1935,14 +2331,12 @@ xaccTransOrder_num_action (const Transaction *ta, const char *actna,
     }
 
     /* otherwise, sort on number string */
-    if (actna && actnb) /* split action string, if not NULL */
-    {
-         retval = order_by_int64_or_string (actna, actnb);
-    }
-    else                /* else transaction num string */
+    if (!keya || !keyb) /* no split action keys, use the transaction nums */
     {
-         retval = order_by_int64_or_string (ta->num, tb->num);
+         keya = gnc_num_sort_key_get (&ta->num_sort_key, ta->num, &scratcha);
+         keyb = gnc_num_sort_key_get (&tb->num_sort_key, tb->num, &scratchb);
     }
+    retval = order_by_num_sort_key (keya, keyb);
     if (retval)
          return retval;
 
@@ -1952,7 +2346,7 @@ xaccTransOrder_num_action (const Transaction *ta, const char *actna,
     /* otherwise, sort on description string */
     da = ta->description ? ta->description : "";
     db = tb->description ? tb->description : "";
-    retval = g_utf8_collate (da, db);
+    retval = da == db ? 0 : g_utf8_collate (da, db);
     if (retval)
         return retval;
 
@@ -2160,6 +2554,7 @@ xaccTransSetNum (Transaction *trans, const char *xnum)
     xaccTransBeginEdit(trans);
 
     CACHE_REPLACE(trans->num, xnum);
+    gnc_num_sort_key_set (&trans->num_sort_key, trans->num);
     qof_instance_set_dirty(QOF_INSTANCE(trans));
     mark_trans(trans);  /* Dirty balance of every account in trans */
     xaccTransCommitEdit(trans);
@@ -2257,20 +2652,25 @@ xaccTransSetIsClosingTxn (Transaction *trans, gboolean is_closing)
 Split *
 xaccTransGetSplit (const Transaction *trans, int i)
 {
-    int j = 0;
+    Split * const *splits;
+    guint n;
     if (!trans || i < 0) return NULL;
 
-    FOR_EACH_SPLIT(trans, { if (i == j) return s; j++; });
-    return NULL;
+    splits = trans_get_split_vec (trans, &n);
+    return (guint)i < n ? splits[i] : NULL;
 }
 
 int
 xaccTransGetSplitIndex(const Transaction *trans, const Split *split)
 {
-    int j = 0;
+    Split * const *splits;
+    guint j, n;
     g_return_val_if_fail(trans && split, -1);
 
-    FOR_EACH_SPLIT(trans, { if (s == split) return j; j++; });
+    splits = trans_get_split_vec (trans, &n);
+    for (j = 0; j < n; j++)
+        if (splits[j] == split)
+            return j;
     return -1;
 }
 
@@ -2360,10 +2760,10 @@ Split *xaccTransGetFirstAPARAcctSplit (const Transaction *trans, gboolean strict
 int
 xaccTransCountSplits (const Transaction *trans)
 {
-    gint i = 0;
+    guint n;
     g_return_val_if_fail (trans != NULL, 0);
-    FOR_EACH_SPLIT(trans, i++);
-    return i;
+    trans_get_split_vec (trans, &n);
+    return n;
 }
 
 const char *
@@ -2571,40 +2971,17 @@ xaccTransIsSXTemplate (const Transaction * trans)
 
 gboolean xaccTransIsReadonlyByPostedDate(const Transaction *trans)
 {
-    GDate *threshold_date;
-    GDate trans_date;
-    const QofBook *book = xaccTransGetBook (trans);
-    gboolean result;
     g_assert(trans);
 
-    if (!qof_book_uses_autoreadonly(book))
-    {
+    /* The posted date is kept as a neutral time on the posted day, so
+     * comparing it with the threshold compares their UTC dates. */
+    if (trans->date_posted >= qof_book_get_autoreadonly_time (xaccTransGetBook (trans)))
         return FALSE;
-    }
 
     if (xaccTransIsSXTemplate (trans))
 	return FALSE;
 
-    threshold_date = qof_book_get_autoreadonly_gdate(book);
-    g_assert(threshold_date); // ok because we checked uses_autoreadonly before
-    trans_date = xaccTransGetDatePostedGDate(trans);
-
-//    g_warning("there is auto-read-only with days=%d, trans_date_day=%d, threshold_date_day=%d",
-//              qof_book_get_num_days_autofreeze(book),
-//              g_date_get_day(&trans_date),
-//              g_date_get_day(threshold_date));
-
-    if (g_date_compare(&trans_date, threshold_date) < 0)
-    {
-        //g_warning("we are auto-read-only");
-        result = TRUE;
-    }
-    else
-    {
-        result = FALSE;
-    }
-    g_date_free(threshold_date);
-    return result;
+    return TRUE;
 }
 
 /*################## Added for Reg2 #################*/
@@ -2718,23 +3095,14 @@ gnc_book_count_transactions(QofBook *book)
 /********************************************************************\
 \********************************************************************/
 
-void
-xaccTransVoid(Transaction *trans, const char *reason)
+/* The part of voiding that happens inside the edit; void_time is the
+ * ISO 8601 time to record. */
+static void
+trans_void_in_edit (Transaction *trans, const char *reason,
+                    const char *void_time)
 {
     GValue v = G_VALUE_INIT;
-    char iso8601_str[ISO_DATELENGTH + 1] = "";
-
-    g_return_if_fail(trans && reason);
 
-    /* Prevent voiding transactions that are already marked
-     * read only, for example generated by the business features.
-     */
-    if (xaccTransGetReadOnly (trans))
-    {
-        PWARN ("Refusing to void a read-only transaction!");
-        return;
-    }
-    xaccTransBeginEdit(trans);
     qof_instance_get_kvp (QOF_INSTANCE (trans), &v, 1, trans_notes_str);
     if (G_VALUE_HOLDS_STRING (&v))
         qof_instance_set_kvp (QOF_INSTANCE (trans), &v, 1, void_former_notes_str);
@@ -2746,8 +3114,7 @@ xaccTransVoid(Transaction *trans, const char *reason)
     g_value_set_string (&v, reason);
     qof_instance_set_kvp (QOF_INSTANCE (trans), &v, 1, void_reason_str);
 
-    gnc_time64_to_iso8601_buff (gnc_time(NULL), iso8601_str);
-    g_value_set_string (&v, iso8601_str);
+    g_value_set_string (&v, void_time);
     qof_instance_set_kvp (QOF_INSTANCE (trans), &v, 1, void_time_str);
     g_value_unset (&v);
 
@@ -2755,9 +3122,76 @@ xaccTransVoid(Transaction *trans, const char *reason)
 
     /* Dirtying taken care of by SetReadOnly */
     xaccTransSetReadOnly(trans, _("Transaction Voided"));
+}
+
+void
+xaccTransVoid(Transaction *trans, const char *reason)
+{
+    char iso8601_str[ISO_DATELENGTH + 1] = "";
+
+    g_return_if_fail(trans && reason);
+
+    /* Prevent voiding transactions that are already marked
+     * read only, for example generated by the business features.
+     */
+    if (xaccTransGetReadOnly (trans))
+    {
+        PWARN ("Refusing to void a read-only transaction!");
+        return;
+    }
+    gnc_time64_to_iso8601_buff (gnc_time(NULL), iso8601_str);
+    xaccTransBeginEdit(trans);
+    trans_void_in_edit (trans, reason, iso8601_str);
     xaccTransCommitEdit(trans);
 }
 
+guint
+xaccTransVoidBatch (Transaction **trans, guint n_trans, const char *reason,
+                    QofPercentageFunc percentagefunc)
+{
+    char iso8601_str[ISO_DATELENGTH + 1] = "";
+    Transaction **batch;
+    guint i, n_batch = 0, n_failed, n_voided = 0;
+
+    g_return_val_if_fail (reason, 0);
+    if (!trans || n_trans == 0) return 0;
+
+    /* Every transaction of the batch gets the same void time. */
+    gnc_time64_to_iso8601_buff (gnc_time(NULL), iso8601_str);
+    batch = g_new (Transaction*, n_trans);
+    for (i = 0; i < n_trans; i++)
+    {
+        Transaction *t = trans[i];
+        if (!t) continue;
+        if (xaccTransGetReadOnly (t))
+        {
+            PWARN ("Refusing to void a read-only transaction!");
+            continue;
+        }
+        /* The caller's own edit will commit it. */
+        if (xaccTransIsOpen (t))
+        {
+            xaccTransVoid (t, reason);
+            n_voided++;
+            continue;
+        }
+        xaccTransBeginEdit (t);
+        trans_void_in_edit (t, reason, iso8601_str);
+        batch[n_batch++] = t;
+    }
+
+    n_failed = trans_commit_batch (batch, n_batch, NULL, percentagefunc,
+                                   _("Voiding transactions"));
+    /* Anything the batch refused is still open; don't leave it so. */
+    for (i = 0; i < n_batch; i++)
+        if (xaccTransIsOpen (batch[i]))
+            xaccTransRollbackEdit (batch[i]);
+    g_free (batch);
+    if (percentagefunc)
+        (percentagefunc)(NULL, -1.0);
+    return n_voided + n_batch - n_failed;
+}
+
 gboolean
 xaccTransGetVoidStatus(const Transaction *trans)
 {
@@ -2836,19 +3270,13 @@ xaccTransUnvoid (Transaction *trans)
     xaccTransCommitEdit(trans);
 }
 
-Transaction *
-xaccTransReverse (Transaction *orig)
+/* Clone orig into an open transaction holding its reverse, and point
+ * orig at it.  The caller commits the clone. */
+static Transaction *
+trans_reverse_open (Transaction *orig)
 {
     Transaction *trans;
     GValue v = G_VALUE_INIT;
-    g_return_val_if_fail(orig, NULL);
-
-    /* First edit, dirty, and commit orig to ensure that any trading
-     * splits are correctly balanced.
-     */
-    xaccTransBeginEdit (orig);
-    qof_instance_set_dirty (QOF_INSTANCE (orig));
-    xaccTransCommitEdit (orig);
 
     trans = xaccTransClone(orig);
     g_return_val_if_fail (trans, NULL);
@@ -2872,10 +3300,132 @@ xaccTransReverse (Transaction *orig)
     xaccTransClearReadOnly(trans);
 
     qof_instance_set_dirty(QOF_INSTANCE(trans));
+    return trans;
+}
+
+Transaction *
+xaccTransReverse (Transaction *orig)
+{
+    Transaction *trans;
+    g_return_val_if_fail(orig, NULL);
+
+    /* First edit, dirty, and commit orig to ensure that any trading
+     * splits are correctly balanced.
+     */
+    xaccTransBeginEdit (orig);
+    qof_instance_set_dirty (QOF_INSTANCE (orig));
+    xaccTransCommitEdit (orig);
+
+    trans = trans_reverse_open (orig);
+    g_return_val_if_fail (trans, NULL);
     xaccTransCommitEdit(trans);
     return trans;
 }
 
+guint
+xaccTransReverseBatch (Transaction **orig, guint n_trans,
+                       Transaction **reversed,
+                       QofPercentageFunc percentagefunc)
+{
+    Transaction **batch;
+    GncTransCommitStatus *status;
+    gboolean *refused;
+    QofBackend *be = NULL;
+    guint i, j, n_batch = 0, n_reversed = 0;
+
+    if (!orig || n_trans == 0) return 0;
+
+    for (i = 0; i < n_trans && !be; i++)
+        if (orig[i])
+            be = qof_book_get_backend (xaccTransGetBook (orig[i]));
+
+    batch = g_new0 (Transaction*, n_trans);
+    status = g_new (GncTransCommitStatus, n_trans);
+    refused = g_new0 (gboolean, n_trans);
+    /* Both passes go to the backend as one batch. */
+    xaccLogBeginBatch ();
+    qof_backend_begin_batch (be);
+
+    /* As in xaccTransReverse, commit the originals first so that their
+     * trading splits are balanced before they are cloned. */
+    for (i = 0; i < n_trans; i++)
+    {
+        if (!orig[i] || xaccTransIsOpen (orig[i])) continue;
+        xaccTransBeginEdit (orig[i]);
+        qof_instance_set_dirty (QOF_INSTANCE (orig[i]));
+        batch[n_batch++] = orig[i];
+    }
+    trans_commit_batch (batch, n_batch, status, NULL, NULL);
+    /* An original the batch refused is still open; leave it as it was
+     * and don't reverse it. */
+    for (i = 0, j = 0; i < n_trans && j < n_batch; i++)
+    {
+        if (orig[i] != batch[j]) continue;
+        if (status[j++] == GNC_TRANS_COMMIT_OK) continue;
+        PWARN ("Not reversing trans=%p, which couldn't be committed", orig[i]);
+        if (xaccTransIsOpen (orig[i]))
+            xaccTransRollbackEdit (orig[i]);
+        refused[i] = TRUE;
+    }
+
+    n_batch = 0;
+    for (i = 0; i < n_trans; i++)
+    {
+        Transaction *trans = NULL;
+        if (orig[i] && !refused[i] && !xaccTransIsOpen (orig[i]))
+            trans = trans_reverse_open (orig[i]);
+        if (reversed)
+            reversed[i] = trans;
+        if (trans)
+            batch[n_batch++] = trans;
+    }
+    trans_commit_batch (batch, n_batch, status, percentagefunc,
+                        _("Reversing transactions"));
+    for (i = 0; i < n_batch; i++)
+    {
+        if (status[i] == GNC_TRANS_COMMIT_OK)
+        {
+            n_reversed++;
+            continue;
+        }
+        /* Rolling back would leave an unreversed copy behind. */
+        if (xaccTransIsOpen (batch[i]))
+        {
+            xaccTransDestroy (batch[i]);
+            xaccTransCommitEdit (batch[i]);
+        }
+        /* Find the slot it was returned in. */
+        if (reversed)
+            for (j = 0; j < n_trans; j++)
+                if (reversed[j] == batch[i])
+                    reversed[j] = NULL;
+    }
+
+    /* The reversals stay in the engine, but unsaved, so they don't
+     * count as reversed. */
+    if (!qof_backend_commit_batch (be))
+    {
+        PWARN ("The backend failed to write the reversals");
+        for (i = 0; i < n_batch; i++)
+            if (status[i] == GNC_TRANS_COMMIT_OK)
+            {
+                status[i] = GNC_TRANS_COMMIT_BACKEND_ERROR;
+                qof_instance_set_dirty (QOF_INSTANCE (batch[i]));
+            }
+        n_reversed = 0;
+        for (i = 0; i < n_trans; i++)
+            if (orig[i] && !refused[i])
+                qof_instance_set_dirty (QOF_INSTANCE (orig[i]));
+    }
+    xaccLogEndBatch ();
+    g_free (refused);
+    g_free (status);
+    g_free (batch);
+    if (percentagefunc)
+        (percentagefunc)(NULL, -1.0);
+    return n_reversed;
+}
+
 Transaction *
 xaccTransGetReversedBy(const Transaction *trans)
 {
@@ -3120,6 +3670,7 @@ gnc_transaction_book_end(QofBook* book)
 
     col = qof_book_get_collection(book, GNC_ID_TRANS);
     qof_collection_foreach(col, destroy_tx_on_book_close, NULL);
+    drain_trans_copy_pool (book);
 }
 
 #ifdef _MSC_VER
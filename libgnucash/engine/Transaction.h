@@ -216,6 +216,36 @@ void          xaccTransCommitEdit (Transaction *trans);
     as well as restoring share quantities, memos, descriptions, etc. */
 void          xaccTransRollbackEdit (Transaction *trans);
 
+/** The outcome of committing one transaction of a batch. */
+typedef enum
+{
+    GNC_TRANS_COMMIT_OK = 0,
+    GNC_TRANS_COMMIT_NOT_OPEN,      /**< Not opened exactly once with
+                                     *   xaccTransBeginEdit() */
+    GNC_TRANS_COMMIT_NO_CURRENCY,   /**< The transaction has no currency */
+    GNC_TRANS_COMMIT_NO_ACCOUNT,    /**< One of the splits has no account */
+    GNC_TRANS_COMMIT_BACKEND_ERROR, /**< The backend refused the commit and
+                                     *   the edit was rolled back, or it
+                                     *   failed to write the batch, which
+                                     *   leaves the transaction committed
+                                     *   but dirty */
+} GncTransCommitStatus;
+
+/** The xaccTransCommitEditBatch() method commits 'n_trans' open
+    transactions of the same book as one batch.  Engine events are held
+    back until the end and then sent once per transaction and once per
+    account touched, the transaction log is flushed once, and the backend
+    gets the chance to write the whole batch in one go.
+
+    A transaction that fails the checks is left open and untouched, for
+    the caller to fix or to roll back, and the rest of the batch goes
+    ahead.  If 'status' is not NULL it receives the outcome for each
+    transaction.
+
+    @return The number of transactions that were not committed. */
+guint         xaccTransCommitEditBatch (Transaction **trans, guint n_trans,
+                                        GncTransCommitStatus *status);
+
 /** The xaccTransIsOpen() method returns TRUE if the transaction
     is open for editing. Otherwise, it returns false.
     XXX this routine should probably be deprecated.  its, umm,
@@ -684,6 +714,27 @@ time64        xaccTransRetDateDue (const Transaction *trans);
 void xaccTransVoid(Transaction *transaction,
                    const char *reason);
 
+/** xaccTransVoidBatch voids 'n_trans' transactions as a single
+ *  xaccTransCommitEditBatch: one flush of engine events and of the
+ *  transaction log, and one backend batch.  Read-only transactions are
+ *  skipped as in xaccTransVoid, and transactions that are already open
+ *  are voided within the caller's edit.
+ *
+ *  @param trans The transactions to void.
+ *
+ *  @param n_trans The number of transactions in trans.
+ *
+ *  @param reason The textual reason why they are being voided.
+ *
+ *  @param percentagefunc If not NULL, called with the progress of the
+ *  commit, and with (NULL, -1.0) when done.
+ *
+ *  @return The number of transactions voided.
+ */
+guint xaccTransVoidBatch (Transaction **trans, guint n_trans,
+                          const char *reason,
+                          QofPercentageFunc percentagefunc);
+
 /** xaccTransUnvoid restores a voided transaction to its original
  *  state.  At some point when gnucash is enhanced to support an audit
  *  trail (i.e. write only transactions) this command should be
@@ -706,6 +757,31 @@ void xaccTransUnvoid(Transaction *transaction);
  */
 Transaction * xaccTransReverse(Transaction *transaction);
 
+/** xaccTransReverseBatch is xaccTransReverse for 'n_trans'
+ *  transactions.  The originals and then the reversing transactions are
+ *  each committed with one xaccTransCommitEditBatch, both inside the
+ *  same backend batch.  Transactions that are open for editing are
+ *  skipped, and so are originals that can't be committed; those are
+ *  rolled back.
+ *
+ *  @param orig The transactions to reverse.
+ *
+ *  @param n_trans The number of transactions in orig.
+ *
+ *  @param reversed If not NULL, an array of n_trans that receives each
+ *  reversing transaction, or NULL where none was made.
+ *
+ *  @param percentagefunc If not NULL, called with the progress of the
+ *  commit, and with (NULL, -1.0) when done.
+ *
+ *  @return The number of transactions reversed.  If the backend fails
+ *  to write the batch none are counted; the reversals are left in the
+ *  engine, unsaved, and still returned in reversed.
+ */
+guint xaccTransReverseBatch (Transaction **orig, guint n_trans,
+                             Transaction **reversed,
+                             QofPercentageFunc percentagefunc);
+
 /** Returns the transaction that reversed the given transaction.
  *
  *  @param trans a Transaction that has been reversed
@@ -71,6 +71,9 @@
  * A "split" is more commonly referred to as an "entry" in a "transaction".
  */
 
+/* Most transactions have two to four splits. */
+#define TRANS_INLINE_SPLITS 4
+
 struct transaction_s
 {
     QofInstance inst;     /* glbally unique id */
@@ -124,6 +127,36 @@ struct transaction_s
      * cached from the KVP value because it is queried a lot. Tri-state value: -1
      * = uninitialized; 0 = FALSE, 1 = TRUE. */
     gint isClosingTxn_cached;
+
+    /* Parsed form of num for xaccTransOrder. */
+    GncNumSortKey num_sort_key;
+
+    /* edit_generation is bumped by xaccTransBumpEditGeneration whenever
+     * the splits, their values or amounts, or the currency change.  The
+     * imbalance results below are valid while their generation matches
+     * it and, because the answer depends on it, while the book's
+     * trading accounts option is still the one they were computed
+     * with.  0 is never a current generation. */
+    guint64 edit_generation;
+    guint64 imbal_value_gen;
+    gnc_numeric imbal_value_cached;
+    guint64 imbal_list_gen;
+    gboolean imbal_list_trading;
+    MonetaryList *imbal_list_cached;
+    guint64 balanced_gen;
+    gboolean balanced_trading;
+    gboolean balanced_cached;
+
+    /* The splits that xaccTransStillHasSplit accepts, in list order, for
+     * the indexed getters.  split_vec is rebuilt when edit_generation or
+     * the head of the splits list changes; it points at split_vec_inline
+     * unless the transaction has more than TRANS_INLINE_SPLITS of them. */
+    Split *split_vec_inline[TRANS_INLINE_SPLITS];
+    Split **split_vec;
+    guint split_vec_len;
+    guint split_vec_alloc;
+    guint64 split_vec_gen;
+    GList *split_vec_head;
 };
 
 struct _TransactionClass
@@ -181,6 +214,21 @@ void xaccDisableDataScrubbing(void);
 void xaccTransRemoveSplit (Transaction *trans, const Split *split);
 void check_open (const Transaction *trans);
 
+/* Drop the cached imbalance of the transaction.  Called by everything
+ * that changes what xaccTransGetImbalance would return. */
+void xaccTransBumpEditGeneration (Transaction *trans);
+
+/* TRUE if any transaction in the book is open for editing.  The
+ * accounts' split lists don't see such a transaction's changes until
+ * it is committed. */
+gboolean xaccBookHasOpenTrans (const QofBook *book);
+
+/* xaccTransOrder_num_action with the num (or split action) strings
+ * already parsed into sort keys.  If either key is NULL the
+ * transactions' own num keys are used. */
+int xaccTransOrderBySortKey (const Transaction *ta, const GncNumSortKey *keya,
+                             const Transaction *tb, const GncNumSortKey *keyb);
+
 /* Structure for accessing static functions for testing */
 typedef struct
 {
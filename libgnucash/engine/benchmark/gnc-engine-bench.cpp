@@ -0,0 +1,367 @@
+/********************************************************************
+ * gnc-engine-bench.cpp -- micro-benchmarks of the engine hot paths *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ *******************************************************************/
+
+/* Run with --benchmark_format=json (or the "bench" target, which
+ * writes gnc-engine-bench.json) for machine-readable results.  All
+ * the data comes from a generator with a fixed seed, so two runs
+ * measure the same work. */
+
+#include <benchmark/benchmark.h>
+#include <glib.h>
+
+extern "C"
+{
+#include <config.h>
+#include "qof.h"
+#include "cashobjects.h"
+#include "Account.h"
+#include "Query.h"
+#include "Split.h"
+#include "Transaction.h"
+#include "TransLog.h"
+#include "gnc-commodity.h"
+#include "gnc-pricedb.h"
+}
+
+#include <random>
+#include <vector>
+
+#include "gnc-numeric.hpp"
+#include "gnc-int128.hpp"
+#include "gnc-datetime.hpp"
+#include "kvp-frame.hpp"
+#include "guid.hpp"
+
+static constexpr unsigned bench_seed = 20210101;
+static constexpr time64 bench_start = INT64_C(1262304000); // 2010-01-01
+static constexpr time64 bench_span = INT64_C(10) * 365 * 86400;
+
+/* A book with one bank account and n transactions against an income
+ * account, posted at random times within bench_span of bench_start,
+ * and a daily price of a stock in the book's currency. */
+class BenchBook
+{
+public:
+    BenchBook (int n_trans) : m_book {qof_book_new ()}, m_rng {bench_seed}
+    {
+        auto table = gnc_commodity_table_get_table (m_book);
+        m_currency = gnc_commodity_table_lookup (table, GNC_COMMODITY_NS_CURRENCY, "USD");
+        m_stock = gnc_commodity_new (m_book, "Example Corp", "NYSE", "EXMP", "", 1000);
+        gnc_commodity_table_insert (table, m_stock);
+
+        auto root = gnc_account_create_root (m_book);
+        m_bank = make_account (root, ACCT_TYPE_BANK, "Bank");
+        m_income = make_account (root, ACCT_TYPE_INCOME, "Income");
+        for (int i = 0; i < n_trans; ++i)
+            add_transaction ();
+
+        auto pricedb = gnc_pricedb_get_db (m_book);
+        for (time64 t = bench_start; t < bench_start + bench_span; t += 86400)
+        {
+            auto price = gnc_price_create (m_book);
+            gnc_price_begin_edit (price);
+            gnc_price_set_commodity (price, m_stock);
+            gnc_price_set_currency (price, m_currency);
+            gnc_price_set_time64 (price, t);
+            gnc_price_set_source (price, PRICE_SOURCE_FQ);
+            gnc_price_set_value (price, random_numeric ());
+            gnc_price_commit_edit (price);
+            gnc_pricedb_add_price (pricedb, price);
+            gnc_price_unref (price);
+        }
+    }
+    ~BenchBook () { qof_book_destroy (m_book); }
+
+    time64 random_time ()
+    {
+        return bench_start + std::uniform_int_distribution<time64> {0, bench_span} (m_rng);
+    }
+
+    gnc_numeric random_numeric ()
+    {
+        return gnc_numeric_create (std::uniform_int_distribution<gint64> {1, 10000000} (m_rng), 100);
+    }
+
+    Transaction* add_transaction ()
+    {
+        auto trans = xaccMallocTransaction (m_book);
+        auto amount = random_numeric ();
+        xaccTransBeginEdit (trans);
+        xaccTransSetCurrency (trans, m_currency);
+        xaccTransSetDatePostedSecs (trans, random_time ());
+        add_split (trans, m_bank, amount);
+        add_split (trans, m_income, gnc_numeric_neg (amount));
+        xaccTransCommitEdit (trans);
+        return trans;
+    }
+
+    QofBook* book () const { return m_book; }
+    Account* bank () const { return m_bank; }
+    gnc_commodity* currency () const { return m_currency; }
+    gnc_commodity* stock () const { return m_stock; }
+
+private:
+    Account* make_account (Account* parent, GNCAccountType type, const char* name)
+    {
+        auto acc = xaccMallocAccount (m_book);
+        xaccAccountBeginEdit (acc);
+        xaccAccountSetType (acc, type);
+        xaccAccountSetName (acc, name);
+        xaccAccountSetCommodity (acc, m_currency);
+        gnc_account_append_child (parent, acc);
+        xaccAccountCommitEdit (acc);
+        return acc;
+    }
+
+    void add_split (Transaction* trans, Account* acc, gnc_numeric amount)
+    {
+        auto split = xaccMallocSplit (m_book);
+        xaccSplitSetParent (split, trans);
+        xaccSplitSetAccount (split, acc);
+        xaccSplitSetAmount (split, amount);
+        xaccSplitSetValue (split, amount);
+    }
+
+    QofBook* m_book;
+    std::mt19937_64 m_rng;
+    gnc_commodity* m_currency;
+    gnc_commodity* m_stock;
+    Account* m_bank;
+    Account* m_income;
+};
+
+static std::vector<GncNumeric>
+random_numerics (size_t n)
+{
+    std::mt19937_64 rng {bench_seed};
+    std::uniform_int_distribution<int64_t> num {-100000000, 100000000};
+    std::uniform_int_distribution<int> denom {0, 4};
+    static const int64_t denoms[] = {1, 100, 1000, 360, 10000000};
+    std::vector<GncNumeric> values;
+
+    values.reserve (n);
+    while (values.size () < n)
+        values.emplace_back (num (rng), denoms[denom (rng)]);
+    return values;
+}
+
+static void
+BM_numeric_add (benchmark::State& state)
+{
+    auto values = random_numerics (1024);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        auto sum = values[i % 1024] + values[(i + 1) % 1024];
+        benchmark::DoNotOptimize (sum);
+        ++i;
+    }
+}
+BENCHMARK(BM_numeric_add);
+
+static void
+BM_numeric_mul_convert (benchmark::State& state)
+{
+    auto values = random_numerics (1024);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        auto product = (values[i % 1024] * values[(i + 1) % 1024]).convert<RoundType::half_up> (100);
+        benchmark::DoNotOptimize (product);
+        ++i;
+    }
+}
+BENCHMARK(BM_numeric_mul_convert);
+
+static void
+BM_numeric_div (benchmark::State& state)
+{
+    auto values = random_numerics (1024);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        auto quotient = gnc_numeric_div (values[i % 1024], values[(i + 1) % 1024],
+                                         GNC_DENOM_AUTO, GNC_HOW_DENOM_REDUCE);
+        benchmark::DoNotOptimize (quotient);
+        ++i;
+    }
+}
+BENCHMARK(BM_numeric_div);
+
+static void
+BM_int128_mul_div (benchmark::State& state)
+{
+    std::mt19937_64 rng {bench_seed};
+    std::vector<GncInt128> values;
+    for (int i = 0; i < 1024; ++i)
+        values.emplace_back (static_cast<int64_t> (rng () >> 2));
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        auto result = values[i % 1024] * values[(i + 1) % 1024] / values[(i + 2) % 1024];
+        benchmark::DoNotOptimize (result);
+        ++i;
+    }
+}
+BENCHMARK(BM_int128_mul_div);
+
+static void
+BM_datetime_from_time64 (benchmark::State& state)
+{
+    std::mt19937_64 rng {bench_seed};
+    std::uniform_int_distribution<time64> dist {bench_start, bench_start + bench_span};
+    std::vector<time64> times (1024);
+    for (auto& t : times)
+        t = dist (rng);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        GncDateTime gdt {times[i++ % 1024]};
+        auto tm = static_cast<struct tm> (gdt);
+        benchmark::DoNotOptimize (tm);
+    }
+}
+BENCHMARK(BM_datetime_from_time64);
+
+static void
+BM_datetime_format (benchmark::State& state)
+{
+    GncDateTime gdt {bench_start};
+    for (auto _ : state)
+    {
+        auto str = gdt.format ("%Y-%m-%d %H:%M:%S");
+        benchmark::DoNotOptimize (str);
+    }
+}
+BENCHMARK(BM_datetime_format);
+
+static void
+BM_guid_new (benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        auto guid = gnc::GUID::create_random ();
+        benchmark::DoNotOptimize (guid);
+    }
+}
+BENCHMARK(BM_guid_new);
+
+static void
+BM_kvp_set_get (benchmark::State& state)
+{
+    KvpFrame frame;
+    static const KvpPath path {{"bench", "value"}};
+    int64_t n = 0;
+    for (auto _ : state)
+    {
+        delete frame.set_path ({"bench", "value"}, new KvpValue {n++});
+        auto value = frame.get_slot (path);
+        benchmark::DoNotOptimize (value);
+    }
+}
+BENCHMARK(BM_kvp_set_get);
+
+static void
+BM_split_insert (benchmark::State& state)
+{
+    BenchBook book {static_cast<int> (state.range (0))};
+    for (auto _ : state)
+        book.add_transaction ();
+    state.SetItemsProcessed (state.iterations ());
+}
+BENCHMARK(BM_split_insert)->Arg(1000)->Arg(100000);
+
+static void
+BM_split_sort (benchmark::State& state)
+{
+    BenchBook book {static_cast<int> (state.range (0))};
+    for (auto _ : state)
+        xaccAccountSortSplits (book.bank (), TRUE);
+    state.SetItemsProcessed (state.iterations () * state.range (0));
+}
+BENCHMARK(BM_split_sort)->Arg(1000)->Arg(100000);
+
+static void
+BM_balance_as_of_date (benchmark::State& state)
+{
+    BenchBook book {static_cast<int> (state.range (0))};
+    for (auto _ : state)
+    {
+        auto balance = xaccAccountGetBalanceAsOfDate (book.bank (), book.random_time ());
+        benchmark::DoNotOptimize (balance);
+    }
+}
+BENCHMARK(BM_balance_as_of_date)->Arg(1000)->Arg(100000);
+
+static void
+BM_pricedb_lookup_nearest (benchmark::State& state)
+{
+    BenchBook book {0};
+    auto pricedb = gnc_pricedb_get_db (book.book ());
+    for (auto _ : state)
+    {
+        auto price = gnc_pricedb_lookup_nearest_in_time64 (pricedb, book.stock (),
+                                                           book.currency (),
+                                                           book.random_time ());
+        benchmark::DoNotOptimize (price);
+        gnc_price_unref (price);
+    }
+}
+BENCHMARK(BM_pricedb_lookup_nearest);
+
+static void
+BM_query_run (benchmark::State& state)
+{
+    BenchBook book {static_cast<int> (state.range (0))};
+    auto query = qof_query_create_for (GNC_ID_SPLIT);
+    qof_query_set_book (query, book.book ());
+    xaccQueryAddDateMatchTT (query, TRUE, bench_start + bench_span / 4,
+                             TRUE, bench_start + bench_span / 2, QOF_QUERY_AND);
+    for (auto _ : state)
+    {
+        /* A fresh copy each time, so that no cached result is reused. */
+        auto q = qof_query_copy (query);
+        auto splits = qof_query_run (q);
+        benchmark::DoNotOptimize (splits);
+        qof_query_destroy (q);
+    }
+    qof_query_destroy (query);
+}
+BENCHMARK(BM_query_run)->Arg(1000)->Arg(100000);
+
+int
+main (int argc, char** argv)
+{
+    benchmark::Initialize (&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments (argc, argv))
+        return 1;
+
+    qof_init ();
+    if (!cashobjects_register ())
+        return 1;
+    xaccLogDisable ();
+
+    benchmark::RunSpecifiedBenchmarks ();
+
+    qof_close ();
+    return 0;
+}
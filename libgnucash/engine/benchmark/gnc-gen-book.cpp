@@ -0,0 +1,660 @@
+/********************************************************************
+ * gnc-gen-book.cpp -- build a reproducible synthetic book          *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ *******************************************************************/
+
+/* gnc-gen-book writes a book of made-up but plausible data -- a
+ * household and small business account tree, daily stock prices,
+ * security trades assigned to lots, scheduled transactions, customers,
+ * vendors, invoices and bills -- to any backend URI:
+ *
+ *   gnc-gen-book --splits 10000000 sqlite3:///tmp/reference.gnucash
+ *
+ * The same seed and options always give the same book, guids
+ * included, so a large book can be shared as a command line instead
+ * of a file.  The generator draws from std::mt19937_64 directly rather
+ * than through the <random> distributions, whose results differ
+ * between standard libraries.  The optional random KVP slots come from
+ * test-engine-stuff, which uses rand () and so are only reproducible
+ * with the same C library. */
+
+#include <glib.h>
+
+extern "C"
+{
+#include <config.h>
+#include "qof.h"
+#include "Account.h"
+#include "Recurrence.h"
+#include "SchedXaction.h"
+#include "SX-book.h"
+#include "SX-ttinfo.h"
+#include "Split.h"
+#include "Transaction.h"
+#include "TransLog.h"
+#include "cap-gains.h"
+#include "gnc-engine.h"
+#include "gnc-commodity.h"
+#include "gnc-lot.h"
+#include "gnc-pricedb.h"
+#include "gncCustomer.h"
+#include "gncEntry.h"
+#include "gncInvoice.h"
+#include "gncOwner.h"
+#include "gncVendor.h"
+#include "test-engine-stuff.h"
+}
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "kvp-frame.hpp"
+#include "qofinstance-p.h"
+
+static gint64 opt_seed = 1;
+static gint64 opt_splits = 100000;
+static gint opt_years = 10;
+static gint opt_stocks = 5;
+static gint opt_extra_accounts = 0;
+static gint opt_sxes = 20;
+static gint opt_customers = 20;
+static gint opt_vendors = 20;
+static gint opt_invoices = 200;
+static gint opt_kvp_percent = 0;
+
+static GOptionEntry options[] =
+{
+    { "seed", 's', 0, G_OPTION_ARG_INT64, &opt_seed,
+      "Seed of the generator [1]", "N" },
+    { "splits", 'n', 0, G_OPTION_ARG_INT64, &opt_splits,
+      "Number of splits in ordinary transactions [100000]", "N" },
+    { "years", 'y', 0, G_OPTION_ARG_INT, &opt_years,
+      "Years of history, starting 2010-01-01 [10]", "N" },
+    { "stocks", 0, 0, G_OPTION_ARG_INT, &opt_stocks,
+      "Number of securities traded and priced [5]", "N" },
+    { "extra-accounts", 0, 0, G_OPTION_ARG_INT, &opt_extra_accounts,
+      "Expense accounts to add to the standard tree [0]", "N" },
+    { "sxes", 0, 0, G_OPTION_ARG_INT, &opt_sxes,
+      "Number of monthly scheduled transactions [20]", "N" },
+    { "customers", 0, 0, G_OPTION_ARG_INT, &opt_customers,
+      "Number of customers [20]", "N" },
+    { "vendors", 0, 0, G_OPTION_ARG_INT, &opt_vendors,
+      "Number of vendors [20]", "N" },
+    { "invoices", 0, 0, G_OPTION_ARG_INT, &opt_invoices,
+      "Number of posted invoices and bills [200]", "N" },
+    { "kvp-percent", 0, 0, G_OPTION_ARG_INT, &opt_kvp_percent,
+      "Percentage of transactions given random KVP slots [0]", "N" },
+    { NULL }
+};
+
+static const char* payees[] =
+{
+    "Corner Grocery", "Gas & Go", "City Water", "Power Company",
+    "The Diner", "Hardware Store", "Pharmacy", "Book Shop",
+    "Cinema", "Airline", "Hotel", "Insurance Co."
+};
+
+/* The parts of the tree that transactions are written against. */
+struct GenAccounts
+{
+    Account* checking;
+    Account* savings;
+    Account* cash;
+    Account* receivable;
+    Account* credit_card;
+    Account* payable;
+    Account* salary;
+    Account* interest;
+    Account* dividends;
+    Account* sales;
+    Account* taxes;
+    Account* supplies;
+    std::vector<Account*> expenses;
+    std::vector<Account*> stocks;
+};
+
+struct GenStock
+{
+    gnc_commodity* commodity;
+    gint64 price;               // in cents, a random walk
+    gint64 shares;              // held, in thousandths
+};
+
+class BookGenerator
+{
+public:
+    BookGenerator (QofBook* book, guint64 seed) :
+        m_book {book}, m_rng {seed},
+        m_start {gnc_dmy2time64_neutral (1, 1, 2010)},
+        m_days {opt_years * 365}
+    {
+        auto table = gnc_commodity_table_get_table (m_book);
+        m_currency = gnc_commodity_table_lookup (table, GNC_COMMODITY_NS_CURRENCY, "USD");
+    }
+
+    void
+    run ()
+    {
+        make_accounts ();
+        make_stocks ();
+        make_transactions ();
+        make_sxes ();
+        make_business ();
+    }
+
+private:
+    /* An integer in [lo, hi]; the modulo bias is far below anything
+     * that matters here. */
+    gint64
+    uniform (gint64 lo, gint64 hi)
+    {
+        return lo + static_cast<gint64> (m_rng () % static_cast<guint64> (hi - lo + 1));
+    }
+
+    gboolean
+    percent (int p)
+    {
+        return uniform (0, 99) < p;
+    }
+
+    time64
+    day_time (gint64 day) const
+    {
+        return m_start + day * 86400;
+    }
+
+    Account*
+    make_account (Account* parent, const char* name, GNCAccountType type,
+                  gnc_commodity* commodity = nullptr)
+    {
+        auto acc = xaccMallocAccount (m_book);
+        xaccAccountBeginEdit (acc);
+        xaccAccountSetName (acc, name);
+        xaccAccountSetType (acc, type);
+        xaccAccountSetCommodity (acc, commodity ? commodity : m_currency);
+        gnc_account_append_child (parent, acc);
+        xaccAccountCommitEdit (acc);
+        return acc;
+    }
+
+    Account*
+    make_placeholder (Account* parent, const char* name, GNCAccountType type)
+    {
+        auto acc = make_account (parent, name, type);
+        xaccAccountSetPlaceholder (acc, TRUE);
+        return acc;
+    }
+
+    void
+    make_accounts ()
+    {
+        auto root = gnc_book_get_root_account (m_book);
+        if (!root)
+            root = gnc_account_create_root (m_book);
+
+        auto assets = make_placeholder (root, "Assets", ACCT_TYPE_ASSET);
+        auto current = make_placeholder (assets, "Current Assets", ACCT_TYPE_ASSET);
+        m_acc.checking = make_account (current, "Checking Account", ACCT_TYPE_BANK);
+        m_acc.savings = make_account (current, "Savings Account", ACCT_TYPE_BANK);
+        m_acc.cash = make_account (current, "Cash in Wallet", ACCT_TYPE_CASH);
+        m_acc.receivable = make_account (assets, "Accounts Receivable", ACCT_TYPE_RECEIVABLE);
+        m_investments = make_placeholder (assets, "Investments", ACCT_TYPE_ASSET);
+
+        auto liabilities = make_placeholder (root, "Liabilities", ACCT_TYPE_LIABILITY);
+        m_acc.credit_card = make_account (liabilities, "Credit Card", ACCT_TYPE_CREDIT);
+        m_acc.payable = make_account (liabilities, "Accounts Payable", ACCT_TYPE_PAYABLE);
+
+        auto income = make_placeholder (root, "Income", ACCT_TYPE_INCOME);
+        m_acc.salary = make_account (income, "Salary", ACCT_TYPE_INCOME);
+        m_acc.interest = make_account (income, "Interest Income", ACCT_TYPE_INCOME);
+        m_acc.dividends = make_account (income, "Dividend Income", ACCT_TYPE_INCOME);
+        m_acc.sales = make_account (income, "Sales", ACCT_TYPE_INCOME);
+
+        auto expenses = make_placeholder (root, "Expenses", ACCT_TYPE_EXPENSE);
+        m_acc.taxes = make_account (expenses, "Taxes", ACCT_TYPE_EXPENSE);
+        m_acc.supplies = make_account (expenses, "Supplies", ACCT_TYPE_EXPENSE);
+        for (auto name : {"Groceries", "Dining", "Rent", "Insurance",
+                          "Medical", "Entertainment", "Travel", "Books"})
+            m_acc.expenses.push_back (make_account (expenses, name, ACCT_TYPE_EXPENSE));
+        auto utilities = make_placeholder (expenses, "Utilities", ACCT_TYPE_EXPENSE);
+        for (auto name : {"Electric", "Water", "Gas", "Phone"})
+            m_acc.expenses.push_back (make_account (utilities, name, ACCT_TYPE_EXPENSE));
+        auto auto_acc = make_placeholder (expenses, "Auto", ACCT_TYPE_EXPENSE);
+        for (auto name : {"Fuel", "Repair", "Parking"})
+            m_acc.expenses.push_back (make_account (auto_acc, name, ACCT_TYPE_EXPENSE));
+        if (opt_extra_accounts > 0)
+        {
+            auto misc = make_placeholder (expenses, "Miscellaneous", ACCT_TYPE_EXPENSE);
+            for (int i = 0; i < opt_extra_accounts; ++i)
+            {
+                auto name = g_strdup_printf ("Category %06d", i);
+                m_acc.expenses.push_back (make_account (misc, name, ACCT_TYPE_EXPENSE));
+                g_free (name);
+            }
+        }
+
+        auto equity = make_placeholder (root, "Equity", ACCT_TYPE_EQUITY);
+        m_opening = make_account (equity, "Opening Balances", ACCT_TYPE_EQUITY);
+    }
+
+    /* Each stock gets an account under Investments and a closing price
+     * for every weekday, walking up or down by at most 2%. */
+    void
+    make_stocks ()
+    {
+        auto table = gnc_commodity_table_get_table (m_book);
+
+        for (int i = 0; i < opt_stocks; ++i)
+        {
+            auto mnemonic = g_strdup_printf ("GEN%03d", i);
+            auto fullname = g_strdup_printf ("Generated Corp %d", i);
+            auto commodity = gnc_commodity_new (m_book, fullname, "NYSE", mnemonic, "", 1000);
+            commodity = gnc_commodity_table_insert (table, commodity);
+            m_acc.stocks.push_back (make_account (m_investments, mnemonic,
+                                                  ACCT_TYPE_STOCK, commodity));
+            m_stocks.push_back ({commodity, uniform (1000, 20000), 0});
+            g_free (mnemonic);
+            g_free (fullname);
+        }
+
+        m_prices.resize (m_stocks.size () * m_days);
+        for (gint64 day = 0; day < m_days; ++day)
+        {
+            bool weekday = (day + 5) % 7 < 5;    // 2010-01-01 was a Friday
+            for (size_t i = 0; i < m_stocks.size (); ++i)
+            {
+                auto& stock = m_stocks[i];
+                if (weekday)
+                {
+                    auto step = stock.price / 50;
+                    stock.price = MAX (100, stock.price + uniform (-step, step));
+                    add_price (stock.commodity, day_time (day), stock.price);
+                }
+                m_prices[day * m_stocks.size () + i] = stock.price;
+            }
+        }
+    }
+
+    void
+    add_price (gnc_commodity* commodity, time64 time, gint64 cents)
+    {
+        auto price = gnc_price_create (m_book);
+        gnc_price_begin_edit (price);
+        gnc_price_set_commodity (price, commodity);
+        gnc_price_set_currency (price, m_currency);
+        gnc_price_set_time64 (price, time);
+        gnc_price_set_source (price, PRICE_SOURCE_FQ);
+        gnc_price_set_typestr (price, PRICE_TYPE_LAST);
+        gnc_price_set_value (price, gnc_numeric_create (cents, 100));
+        gnc_price_commit_edit (price);
+        gnc_pricedb_add_price (gnc_pricedb_get_db (m_book), price);
+        gnc_price_unref (price);
+    }
+
+    Split*
+    add_split (Transaction* trans, Account* acc, gnc_numeric amount,
+               gnc_numeric value)
+    {
+        auto split = xaccMallocSplit (m_book);
+        xaccSplitSetParent (split, trans);
+        xaccSplitSetAccount (split, acc);
+        xaccSplitSetAmount (split, amount);
+        xaccSplitSetValue (split, value);
+        ++m_split_count;
+        return split;
+    }
+
+    Split*
+    add_split (Transaction* trans, Account* acc, gint64 cents)
+    {
+        auto value = gnc_numeric_create (cents, 100);
+        return add_split (trans, acc, value, value);
+    }
+
+    Transaction*
+    begin_transaction (time64 date, const char* description)
+    {
+        auto trans = xaccMallocTransaction (m_book);
+        xaccTransBeginEdit (trans);
+        xaccTransSetCurrency (trans, m_currency);
+        xaccTransSetDatePostedSecs (trans, date);
+        xaccTransSetDateEnteredSecs (trans, date);
+        xaccTransSetDescription (trans, description);
+        if (opt_kvp_percent > 0 && percent (opt_kvp_percent))
+        {
+            auto slots = qof_instance_get_slots (QOF_INSTANCE (trans));
+            delete slots->set ({"gnc-gen-book"}, new KvpValue {get_random_kvp_frame ()});
+        }
+        return trans;
+    }
+
+    /* Buys more often than sells, a random number of shares at the
+     * day's price; each trade is assigned to a lot in date order. */
+    void
+    add_trade (time64 date, gint64 day)
+    {
+        auto index = uniform (0, m_stocks.size () - 1);
+        auto& stock = m_stocks[index];
+        auto price = m_prices[day * m_stocks.size () + index];
+        auto sell = stock.shares > 0 && percent (30);
+        auto shares = sell ? uniform (1, stock.shares) : uniform (1, 100) * 1000;
+        auto cents = gnc_numeric_create (shares * price / 1000, 100);
+        auto amount = gnc_numeric_create (shares, 1000);
+
+        auto trans = begin_transaction (date, sell ? "Sell" : "Buy");
+        Split* split;
+        if (sell)
+        {
+            split = add_split (trans, m_acc.stocks[index], gnc_numeric_neg (amount),
+                               gnc_numeric_neg (cents));
+            add_split (trans, m_acc.checking, cents, cents);
+            stock.shares -= shares;
+        }
+        else
+        {
+            split = add_split (trans, m_acc.stocks[index], amount, cents);
+            add_split (trans, m_acc.checking, gnc_numeric_neg (cents),
+                       gnc_numeric_neg (cents));
+            stock.shares += shares;
+        }
+        xaccSplitSetAction (split, sell ? "Sell" : "Buy");
+        xaccTransCommitEdit (trans);
+        xaccSplitAssign (split);
+    }
+
+    void
+    add_transaction (time64 date, gint64 day)
+    {
+        auto kind = uniform (0, 99);
+        Transaction* trans;
+
+        if (kind < 55)
+        {
+            auto from = percent (40) ? m_acc.credit_card :
+                        percent (10) ? m_acc.cash : m_acc.checking;
+            auto cents = uniform (100, 30000);
+            trans = begin_transaction (date, payees[uniform (0, G_N_ELEMENTS (payees) - 1)]);
+            add_split (trans, m_acc.expenses[uniform (0, m_acc.expenses.size () - 1)], cents);
+            add_split (trans, from, -cents);
+        }
+        else if (kind < 63)
+        {
+            auto gross = uniform (200000, 600000);
+            auto tax = gross * uniform (15, 35) / 100;
+            trans = begin_transaction (date, "Payroll");
+            add_split (trans, m_acc.checking, gross - tax);
+            add_split (trans, m_acc.taxes, tax);
+            add_split (trans, m_acc.salary, -gross);
+        }
+        else if (kind < 73)
+        {
+            auto cents = uniform (1000, 200000);
+            auto to = percent (50) ? m_acc.savings :
+                      percent (50) ? m_acc.credit_card : m_acc.cash;
+            trans = begin_transaction (date, "Transfer");
+            add_split (trans, to, cents);
+            add_split (trans, m_acc.checking, -cents);
+        }
+        else if (kind < 85 && !m_stocks.empty ())
+        {
+            add_trade (date, day);
+            return;
+        }
+        else if (kind < 90)
+        {
+            auto cents = uniform (100, 50000);
+            trans = begin_transaction (date, "Dividend");
+            add_split (trans, m_acc.checking, cents);
+            add_split (trans, m_acc.dividends, -cents);
+        }
+        else
+        {
+            auto cents = uniform (1, 5000);
+            trans = begin_transaction (date, "Interest");
+            add_split (trans, m_acc.savings, cents);
+            add_split (trans, m_acc.interest, -cents);
+        }
+        xaccTransCommitEdit (trans);
+    }
+
+    /* Transactions are spread evenly over the history in posting order,
+     * which keeps the lot assignment of the trades first-in first-out. */
+    void
+    make_transactions ()
+    {
+        auto trans = begin_transaction (day_time (0), "Opening Balance");
+        add_split (trans, m_acc.checking, 1000000);
+        add_split (trans, m_acc.savings, 5000000);
+        add_split (trans, m_opening, -6000000);
+        xaccTransCommitEdit (trans);
+
+        gint64 target = m_split_count + MAX (opt_splits, 0);
+        gint64 first = m_split_count;
+        while (m_split_count < target)
+        {
+            auto day = (m_split_count - first) * m_days / (target - first);
+            add_transaction (day_time (day), day);
+        }
+    }
+
+    void
+    make_sxes ()
+    {
+        auto sxes = gnc_book_get_schedxactions (m_book);
+        for (int i = 0; i < opt_sxes; ++i)
+        {
+            auto name = g_strdup_printf ("Monthly payment %d", i);
+            auto cents = uniform (1000, 200000);
+            auto expense = m_acc.expenses[uniform (0, m_acc.expenses.size () - 1)];
+            GDate start;
+            g_date_clear (&start, 1);
+            gnc_gdate_set_time64 (&start, day_time (uniform (0, m_days - 1)));
+
+            auto sx = xaccSchedXactionMalloc (m_book);
+            xaccSchedXactionSetName (sx, name);
+            xaccSchedXactionSetStartDate (sx, &start);
+            auto r = g_new0 (Recurrence, 1);
+            recurrenceSet (r, 1, PERIOD_MONTH, &start, WEEKEND_ADJ_NONE);
+            gnc_sx_set_schedule (sx, g_list_append (nullptr, r));
+
+            auto tti = gnc_ttinfo_malloc ();
+            gnc_ttinfo_set_description (tti, name);
+            gnc_ttinfo_set_currency (tti, m_currency);
+            auto debit = gnc_ttsplitinfo_malloc ();
+            gnc_ttsplitinfo_set_account (debit, expense);
+            gnc_ttsplitinfo_set_debit_formula_numeric (debit, gnc_numeric_create (cents, 100));
+            gnc_ttinfo_append_template_split (tti, debit);
+            auto credit = gnc_ttsplitinfo_malloc ();
+            gnc_ttsplitinfo_set_account (credit, m_acc.checking);
+            gnc_ttsplitinfo_set_credit_formula_numeric (credit, gnc_numeric_create (cents, 100));
+            gnc_ttinfo_append_template_split (tti, credit);
+            auto tt_list = g_list_append (nullptr, tti);
+            xaccSchedXactionSetTemplateTrans (sx, tt_list, m_book);
+            g_list_free_full (tt_list, (GDestroyNotify)gnc_ttinfo_free);
+
+            gnc_sxes_add_sx (sxes, sx);
+            g_free (name);
+        }
+    }
+
+    void
+    make_business ()
+    {
+        std::vector<GncOwner> customers (MAX (opt_customers, 0));
+        std::vector<GncOwner> vendors (MAX (opt_vendors, 0));
+
+        for (size_t i = 0; i < customers.size (); ++i)
+        {
+            auto id = g_strdup_printf ("C%06zu", i);
+            auto name = g_strdup_printf ("Customer %zu", i);
+            auto customer = gncCustomerCreate (m_book);
+            gncCustomerBeginEdit (customer);
+            gncCustomerSetID (customer, id);
+            gncCustomerSetName (customer, name);
+            gncCustomerSetCurrency (customer, m_currency);
+            gncCustomerCommitEdit (customer);
+            gncOwnerInitCustomer (&customers[i], customer);
+            g_free (id);
+            g_free (name);
+        }
+        for (size_t i = 0; i < vendors.size (); ++i)
+        {
+            auto id = g_strdup_printf ("V%06zu", i);
+            auto name = g_strdup_printf ("Vendor %zu", i);
+            auto vendor = gncVendorCreate (m_book);
+            gncVendorBeginEdit (vendor);
+            gncVendorSetID (vendor, id);
+            gncVendorSetName (vendor, name);
+            gncVendorSetCurrency (vendor, m_currency);
+            gncVendorCommitEdit (vendor);
+            gncOwnerInitVendor (&vendors[i], vendor);
+            g_free (id);
+            g_free (name);
+        }
+
+        /* Alternate invoices and bills, as far as there are owners for
+         * them, evenly over the history. */
+        for (int i = 0; i < opt_invoices; ++i)
+        {
+            bool bill = (i % 2 && !vendors.empty ()) || customers.empty ();
+            if (bill && vendors.empty ())
+                break;
+            auto& owners = bill ? vendors : customers;
+            auto date = day_time (static_cast<gint64> (i) * m_days / opt_invoices);
+            add_invoice (&owners[uniform (0, owners.size () - 1)], bill, i, date);
+        }
+    }
+
+    void
+    add_invoice (GncOwner* owner, bool bill, int number, time64 date)
+    {
+        auto id = g_strdup_printf ("%s%06d", bill ? "B" : "I", number);
+        auto invoice = gncInvoiceCreate (m_book);
+        gncInvoiceBeginEdit (invoice);
+        gncInvoiceSetID (invoice, id);
+        gncInvoiceSetOwner (invoice, owner);
+        gncInvoiceSetCurrency (invoice, m_currency);
+        gncInvoiceSetDateOpened (invoice, date);
+
+        for (auto n = uniform (1, 5); n > 0; --n)
+        {
+            auto price = gnc_numeric_create (uniform (500, 50000), 100);
+            auto entry = gncEntryCreate (m_book);
+            gncEntryBeginEdit (entry);
+            gncEntrySetDate (entry, date);
+            gncEntrySetDateEntered (entry, date);
+            gncEntrySetDescription (entry, bill ? "Supplies" : "Services");
+            gncEntrySetQuantity (entry, gnc_numeric_create (uniform (1, 20), 1));
+            if (bill)
+            {
+                gncEntrySetBillAccount (entry, m_acc.supplies);
+                gncEntrySetBillPrice (entry, price);
+                gncBillAddEntry (invoice, entry);
+            }
+            else
+            {
+                gncEntrySetInvAccount (entry, m_acc.sales);
+                gncEntrySetInvPrice (entry, price);
+                gncInvoiceAddEntry (invoice, entry);
+            }
+            gncEntryCommitEdit (entry);
+        }
+        gncInvoiceCommitEdit (invoice);
+
+        gncInvoicePostToAccount (invoice, bill ? m_acc.payable : m_acc.receivable,
+                                 date, date + 30 * 86400, id, TRUE, FALSE);
+        g_free (id);
+    }
+
+    QofBook* m_book;
+    std::mt19937_64 m_rng;
+    time64 m_start;
+    gint64 m_days;
+    gnc_commodity* m_currency;
+    GenAccounts m_acc;
+    Account* m_investments;
+    Account* m_opening;
+    std::vector<GenStock> m_stocks;
+    std::vector<gint64> m_prices; // by day, then stock
+    gint64 m_split_count = 0;
+};
+
+int
+main (int argc, char** argv)
+{
+    GError* error = nullptr;
+    auto context = g_option_context_new ("URI");
+    g_option_context_set_summary (context,
+                                  "Write a reproducible synthetic book to the "
+                                  "file or database URI.");
+    g_option_context_add_main_entries (context, options, nullptr);
+    if (!g_option_context_parse (context, &argc, &argv, &error) || argc != 2 ||
+        opt_years < 1)
+    {
+        if (error)
+            g_printerr ("%s\n", error->message);
+        auto help = g_option_context_get_help (context, TRUE, nullptr);
+        g_printerr ("%s", help);
+        g_free (help);
+        g_clear_error (&error);
+        g_option_context_free (context);
+        return 1;
+    }
+    g_option_context_free (context);
+
+    /* Seed everything that makes ids or data before the first object
+     * is created. */
+    guid_set_random_seed (opt_seed);
+    srand (static_cast<unsigned> (opt_seed));
+    set_max_kvp_depth (2);
+    set_max_kvp_frame_elements (4);
+
+    gnc_engine_init (0, nullptr);
+    xaccLogDisable ();
+
+    /* Build the book without a backend, so that nothing is written
+     * object by object, then hand it to a session on the URI to save
+     * in one go, as Save As does. */
+    auto book_session = qof_session_new (qof_book_new ());
+    qof_event_suspend ();
+    BookGenerator {qof_session_get_book (book_session), static_cast<guint64> (opt_seed)}.run ();
+    qof_event_resume ();
+
+    auto session = qof_session_new (qof_book_new ());
+    qof_session_begin (session, argv[1], SESSION_NEW_OVERWRITE);
+    auto err = qof_session_get_error (session);
+    if (err == ERR_BACKEND_NO_ERR)
+    {
+        qof_session_swap_data (book_session, session);
+        qof_book_mark_session_dirty (qof_session_get_book (session));
+        qof_session_save (session, nullptr);
+        err = qof_session_get_error (session);
+    }
+    if (err != ERR_BACKEND_NO_ERR)
+        g_printerr ("Could not write %s: %s\n", argv[1],
+                    qof_session_get_error_message (session));
+
+    qof_session_end (session);
+    qof_session_destroy (session);
+    qof_session_destroy (book_session);
+    gnc_engine_shutdown ();
+    return err == ERR_BACKEND_NO_ERR ? 0 : 1;
+}
@@ -182,7 +182,7 @@ xaccAccountFindOpenLot (Account *acc, gnc_numeric sign,
     if (gnc_numeric_positive_p(sign)) es.numeric_pred = gnc_numeric_negative_p;
     else es.numeric_pred = gnc_numeric_positive_p;
 
-    xaccAccountForEachLot (acc, finder_helper, &es);
+    gnc_account_foreach_open_lot (acc, finder_helper, &es);
     return es.lot;
 }
 
@@ -0,0 +1,234 @@
+/********************************************************************
+ * gnc-book-snapshot.cpp -- frozen copies of a book for other       *
+ *                          threads                                 *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ ********************************************************************/
+
+extern "C"
+{
+#include <config.h>
+#include "gnc-book-snapshot.h"
+#include "AccountP.h"
+#include "Split.h"
+#include "gnc-commodity.h"
+#include "gnc-engine.h"
+#include "gnc-lot.h"
+#include "qofinstance-p.h"
+}
+
+#include <algorithm>
+
+static QofLogModule log_module = GNC_MOD_ENGINE;
+
+static void
+copy_accounts (Account *from, Account *to, QofBook *copy_book)
+{
+    auto children = gnc_account_get_children (from);
+    for (auto node = children; node; node = node->next)
+    {
+        auto child = static_cast<Account*>(node->data);
+        auto copy = xaccCloneAccount (child, copy_book);
+
+        xaccAccountBeginEdit (copy);
+        qof_instance_set_guid (copy, qof_instance_get_guid (child));
+        gnc_account_append_child (to, copy);
+        copy_accounts (child, copy, copy_book);
+        xaccAccountCommitEdit (copy);
+    }
+    g_list_free (children);
+}
+
+static gboolean
+copy_commodity (gnc_commodity *com, gpointer data)
+{
+    gnc_commodity_obtain_twin (com, static_cast<QofBook*>(data));
+    return TRUE;
+}
+
+static GNCLot *
+copy_lot (GNCLot *lot, QofBook *copy_book)
+{
+    auto copy = gnc_lot_lookup (qof_instance_get_guid (lot), copy_book);
+    if (copy)
+        return copy;
+
+    copy = gnc_lot_new (copy_book);
+    gnc_lot_begin_edit (copy);
+    qof_instance_set_guid (copy, qof_instance_get_guid (lot));
+    qof_instance_copy_kvp (QOF_INSTANCE (copy), QOF_INSTANCE (lot));
+    gnc_lot_commit_edit (copy);
+    return copy;
+}
+
+static void
+copy_trans (Transaction *trans, QofBook *copy_book)
+{
+    auto copy = xaccMallocTransaction (copy_book);
+
+    xaccTransBeginEdit (copy);
+    qof_instance_set_guid (copy, qof_instance_get_guid (trans));
+    qof_instance_copy_kvp (QOF_INSTANCE (copy), QOF_INSTANCE (trans));
+    xaccTransSetCurrency (copy, gnc_commodity_obtain_twin (xaccTransGetCurrency (trans),
+                                                           copy_book));
+    xaccTransSetDatePostedSecs (copy, xaccTransGetDate (trans));
+    xaccTransSetDateEnteredSecs (copy, xaccTransGetDateEntered (trans));
+    xaccTransSetNum (copy, xaccTransGetNum (trans));
+    xaccTransSetDescription (copy, xaccTransGetDescription (trans));
+
+    for (auto node = xaccTransGetSplitList (trans); node; node = node->next)
+    {
+        auto split = static_cast<Split*>(node->data);
+        auto scopy = xaccMallocSplit (copy_book);
+        auto acc = xaccAccountLookup (qof_instance_get_guid (xaccSplitGetAccount (split)),
+                                      copy_book);
+
+        qof_instance_set_guid (scopy, qof_instance_get_guid (split));
+        qof_instance_copy_kvp (QOF_INSTANCE (scopy), QOF_INSTANCE (split));
+        xaccSplitSetParent (scopy, copy);
+        xaccSplitSetAccount (scopy, acc);
+        xaccSplitSetMemo (scopy, xaccSplitGetMemo (split));
+        xaccSplitSetAction (scopy, xaccSplitGetAction (split));
+        xaccSplitSetAmount (scopy, xaccSplitGetAmount (split));
+        xaccSplitSetValue (scopy, xaccSplitGetValue (split));
+        xaccSplitSetReconcile (scopy, xaccSplitGetReconcile (split));
+        xaccSplitSetDateReconciledSecs (scopy, xaccSplitGetDateReconciled (split));
+        if (auto lot = xaccSplitGetLot (split))
+            gnc_lot_add_split (copy_lot (lot, copy_book), scopy);
+    }
+    xaccTransCommitEdit (copy);
+}
+
+static void
+copy_price (GNCPrice *price, QofBook *copy_book)
+{
+    auto copy = gnc_price_create (copy_book);
+
+    gnc_price_begin_edit (copy);
+    qof_instance_set_guid (copy, qof_instance_get_guid (price));
+    gnc_price_set_commodity (copy, gnc_commodity_obtain_twin (gnc_price_get_commodity (price),
+                                                              copy_book));
+    gnc_price_set_currency (copy, gnc_commodity_obtain_twin (gnc_price_get_currency (price),
+                                                             copy_book));
+    gnc_price_set_time64 (copy, gnc_price_get_time64 (price));
+    gnc_price_set_source (copy, gnc_price_get_source (price));
+    gnc_price_set_typestr (copy, gnc_price_get_typestr (price));
+    gnc_price_set_value (copy, gnc_price_get_value (price));
+    gnc_price_commit_edit (copy);
+    gnc_pricedb_add_price (gnc_pricedb_get_db (copy_book), copy);
+    gnc_price_unref (copy);
+}
+
+QofBook *
+gnc_book_snapshot_copy (QofBook *book, const std::vector<Transaction*>& trans,
+                        const std::vector<GNCPrice*>& prices)
+{
+    auto copy_book = qof_book_new ();
+    qof_event_suspend ();
+    qof_instance_copy_kvp (QOF_INSTANCE (copy_book), QOF_INSTANCE (book));
+    gnc_commodity_table_foreach_commodity (gnc_commodity_table_get_table (book),
+                                           copy_commodity, copy_book);
+
+    auto root = gnc_book_get_root_account (book);
+    auto copy_root = gnc_account_create_root (copy_book);
+    xaccAccountBeginEdit (copy_root);
+    qof_instance_set_guid (copy_root, qof_instance_get_guid (root));
+    copy_accounts (root, copy_root, copy_book);
+    xaccAccountCommitEdit (copy_root);
+
+    /* Add in date order, so that the accounts and lots of the copy
+     * fill their split lists in order. */
+    auto sorted = trans;
+    std::sort (sorted.begin(), sorted.end(), [](Transaction *a, Transaction *b)
+               { return xaccTransOrder (a, b) < 0; });
+    auto accounts = gnc_account_get_descendants (copy_root);
+    for (auto node = accounts; node; node = node->next)
+        gnc_account_begin_bulk_insert (static_cast<Account*>(node->data));
+    for (auto t : sorted)
+        copy_trans (t, copy_book);
+    for (auto node = accounts; node; node = node->next)
+        gnc_account_end_bulk_insert (static_cast<Account*>(node->data));
+    g_list_free (accounts);
+
+    for (auto price : prices)
+        copy_price (price, copy_book);
+    qof_event_resume ();
+    return copy_book;
+}
+
+struct TransCollect
+{
+    Account *root;
+    std::vector<Transaction*> trans;
+};
+
+/* The template transactions of scheduled transactions have their
+ * splits in the template accounts, outside the account tree. */
+static void
+collect_trans (QofInstance *inst, gpointer data)
+{
+    auto collect = static_cast<TransCollect*>(data);
+    auto trans = GNC_TRANSACTION (inst);
+
+    for (auto node = xaccTransGetSplitList (trans); node; node = node->next)
+    {
+        auto acc = xaccSplitGetAccount (static_cast<Split*>(node->data));
+        if (!acc || gnc_account_get_root (acc) != collect->root)
+            return;
+    }
+    collect->trans.push_back (trans);
+}
+
+static gboolean
+collect_price (GNCPrice *price, gpointer data)
+{
+    static_cast<std::vector<GNCPrice*>*>(data)->push_back (price);
+    return TRUE;
+}
+
+QofBook *
+gnc_book_snapshot_new (QofBook *book)
+{
+    TransCollect collect;
+    std::vector<GNCPrice*> prices;
+
+    g_return_val_if_fail (QOF_IS_BOOK (book), NULL);
+    ENTER ("book=%p epoch=%" G_GUINT64_FORMAT, book, qof_book_get_epoch (book));
+
+    collect.root = gnc_book_get_root_account (book);
+    qof_collection_foreach (qof_book_get_collection (book, GNC_ID_TRANS),
+                            collect_trans, &collect);
+    gnc_pricedb_foreach_price (gnc_pricedb_get_db (book), collect_price,
+                               &prices, FALSE);
+    auto snapshot = gnc_book_snapshot_copy (book, collect.trans, prices);
+    qof_book_mark_frozen (snapshot, qof_book_get_epoch (book));
+
+    LEAVE ("snapshot=%p, %zu transactions, %zu prices", snapshot,
+           collect.trans.size(), prices.size());
+    return snapshot;
+}
+
+gboolean
+gnc_book_snapshot_is_current (const QofBook *snapshot, const QofBook *book)
+{
+    g_return_val_if_fail (snapshot && book, FALSE);
+
+    return qof_book_is_frozen (snapshot) &&
+        qof_book_get_epoch (snapshot) == qof_book_get_epoch (book);
+}
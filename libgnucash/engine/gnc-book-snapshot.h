@@ -0,0 +1,87 @@
+/********************************************************************
+ * gnc-book-snapshot.h -- frozen copies of a book for other threads *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ ********************************************************************/
+
+/** @addtogroup Engine
+ *     @{ */
+
+/** @addtogroup BookSnapshot Book Snapshots
+ *  A snapshot is a frozen copy of a book as it was at one epoch, for
+ *  reports and exports to read on a thread of their own while the
+ *  user goes on editing the book.
+ *
+ *  The engine's objects aren't safe to share between threads: reading
+ *  an account can sort its splits or recompute its balances, and
+ *  every change runs the event handlers.  So a snapshot shares no
+ *  object with its book.  It is made on the thread that owns the book
+ *  and holds copies, with the same GUIDs, of the account tree,
+ *  commodities, options, transactions, lots and prices.  Business
+ *  objects and scheduled transactions aren't copied.  Once made, the
+ *  snapshot can be handed to one other thread, which may read it;
+ *  being frozen, it never runs the event handlers.  Destroying a book
+ *  still touches state shared by every book, such as the string cache
+ *  and the registered book-end hooks, so hand the snapshot back and
+ *  destroy it with qof_book_destroy() on the thread that made it.
+ *     @{ */
+
+/** @file gnc-book-snapshot.h
+ *  @brief Frozen copies of a book for other threads
+ */
+
+#ifndef GNC_BOOK_SNAPSHOT_H
+#define GNC_BOOK_SNAPSHOT_H
+
+#include "qof.h"
+#include "Transaction.h"
+#include "gnc-pricedb.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Copy book into a new, frozen book holding its state at the current
+ *  epoch.  The caller owns the snapshot.  Call this on the thread that
+ *  owns book, while no edit is open, and destroy the snapshot on that
+ *  thread too. */
+QofBook *gnc_book_snapshot_new (QofBook *book);
+
+/** Whether book has had no change committed since snapshot was made
+ *  from it. */
+gboolean gnc_book_snapshot_is_current (const QofBook *snapshot,
+                                       const QofBook *book);
+
+#ifdef __cplusplus
+}
+
+#include <vector>
+
+/** Copy the options, account tree and commodities of book, and trans
+ *  and prices, into a new book, keeping their GUIDs.  The lots the
+ *  splits of trans are in come along.  The new book isn't frozen. */
+QofBook *gnc_book_snapshot_copy (QofBook *book,
+                                 const std::vector<Transaction*>& trans,
+                                 const std::vector<GNCPrice*>& prices);
+#endif
+
+#endif /* GNC_BOOK_SNAPSHOT_H */
+/** @} */
+/** @} */
@@ -35,6 +35,7 @@
 
 #include "gnc-budget.h"
 #include "gnc-commodity.h"
+#include "gnc-pricedb-p.h"
 
 static QofLogModule log_module = GNC_MOD_ENGINE;
 
@@ -58,6 +59,22 @@ typedef struct
     QofInstanceClass parent_class;
 } BudgetClass;
 
+/* The actual amounts of an account in each period, worked out at the
+ * given subtree and price generations. */
+typedef struct
+{
+    guint64     generation;
+    guint64     price_generation;
+    gnc_numeric values[];
+} PeriodActuals;
+
+/* One budgeted amount, as read from the budget's KVP. */
+typedef struct
+{
+    gnc_numeric value;
+    gboolean    is_set;
+} PeriodValue;
+
 typedef struct GncBudgetPrivate
 {
     /* The name is an arbitrary string assigned by the user. */
@@ -71,6 +88,20 @@ typedef struct GncBudgetPrivate
 
     /* Number of periods */
     guint  num_periods;
+
+    /* Budgeted amounts of each account read so far, a PeriodValue
+     * array of num_periods entries keyed by the account's GncGUID. The
+     * KVP remains the record; this only saves looking it up again. */
+    GHashTable *acct_values;
+
+    /* Start and end time of each period, num_periods pairs worked out
+     * from the recurrence on first use. NULL until then. */
+    time64 *period_times;
+
+    /* Actual amounts of each account asked for so far, a PeriodActuals
+     * keyed by the account's GncGUID. An entry is worked out again once
+     * the account's subtree generation or the prices have moved on. */
+    GHashTable *acct_actuals;
 } GncBudgetPrivate;
 
 #define GET_PRIVATE(o) \
@@ -99,6 +130,15 @@ gnc_budget_init(GncBudget* budget)
     g_date_subtract_days(date, g_date_get_day(date) - 1);
     recurrenceSet(&priv->recurrence, 1, PERIOD_MONTH, date, WEEKEND_ADJ_NONE);
     g_date_free (date);
+
+    priv->acct_values = g_hash_table_new_full (guid_hash_to_guint,
+                                               guid_g_hash_table_equal,
+                                               (GDestroyNotify)guid_free,
+                                               g_free);
+    priv->acct_actuals = g_hash_table_new_full (guid_hash_to_guint,
+                                                guid_g_hash_table_equal,
+                                                (GDestroyNotify)guid_free,
+                                                g_free);
 }
 
 static void
@@ -110,6 +150,15 @@ gnc_budget_dispose (GObject *budgetp)
 static void
 gnc_budget_finalize(GObject* budgetp)
 {
+    GncBudgetPrivate* priv = GET_PRIVATE(budgetp);
+
+    g_hash_table_destroy (priv->acct_values);
+    priv->acct_values = NULL;
+    g_hash_table_destroy (priv->acct_actuals);
+    priv->acct_actuals = NULL;
+    g_free (priv->period_times);
+    priv->period_times = NULL;
+
     G_OBJECT_CLASS(gnc_budget_parent_class)->finalize(budgetp);
 }
 
@@ -425,6 +474,9 @@ gnc_budget_set_recurrence(GncBudget *budget, const Recurrence *r)
 
     gnc_budget_begin_edit(budget);
     priv->recurrence = *r;
+    g_free (priv->period_times);
+    priv->period_times = NULL;
+    g_hash_table_remove_all (priv->acct_actuals);
     qof_instance_set_dirty(&budget->inst);
     gnc_budget_commit_edit(budget);
 
@@ -458,6 +510,10 @@ gnc_budget_set_num_periods(GncBudget* budget, guint num_periods)
 
     gnc_budget_begin_edit(budget);
     priv->num_periods = num_periods;
+    g_hash_table_remove_all (priv->acct_values);
+    g_hash_table_remove_all (priv->acct_actuals);
+    g_free (priv->period_times);
+    priv->period_times = NULL;
     qof_instance_set_dirty(&budget->inst);
     gnc_budget_commit_edit(budget);
 
@@ -481,6 +537,92 @@ make_period_path (const Account *account, guint period_num, char *path1, char *p
     g_sprintf (path2, "%d", period_num);
 }
 
+static gboolean
+read_period_value (const GncBudget *budget, const char *path1,
+                   guint period_num, gnc_numeric *value)
+{
+    gchar path_part_two [GNC_BUDGET_MAX_NUM_PERIODS_DIGITS];
+    GValue v = G_VALUE_INIT;
+    gnc_numeric *numeric = NULL;
+
+    g_sprintf (path_part_two, "%d", period_num);
+    qof_instance_get_kvp (QOF_INSTANCE (budget), &v, 2, path1, path_part_two);
+    if (G_VALUE_HOLDS_BOXED (&v))
+        numeric = (gnc_numeric*)g_value_get_boxed (&v);
+
+    *value = numeric ? *numeric : gnc_numeric_zero ();
+    g_value_unset (&v);
+    return (numeric != NULL);
+}
+
+/* All of the account's budgeted amounts, read in from the KVP on first
+ * use. */
+static PeriodValue*
+get_account_values (const GncBudget *budget, const Account *account)
+{
+    GncBudgetPrivate* priv = GET_PRIVATE(budget);
+    const GncGUID *guid = xaccAccountGetGUID (account);
+    PeriodValue *values;
+    gchar path_part_one [GUID_ENCODING_LENGTH + 1];
+    guint i;
+
+    values = g_hash_table_lookup (priv->acct_values, guid);
+    if (values)
+        return values;
+
+    values = g_new0 (PeriodValue, priv->num_periods);
+    guid_to_string_buff (guid, path_part_one);
+    for (i = 0; i < priv->num_periods; i++)
+        values[i].is_set = read_period_value (budget, path_part_one, i,
+                                              &values[i].value);
+
+    g_hash_table_insert (priv->acct_values, guid_copy (guid), values);
+    return values;
+}
+
+/* Keep an account's values, if they've been read, in step with the KVP. */
+static void
+update_account_value (GncBudget *budget, const Account *account,
+                      guint period_num, const gnc_numeric *val)
+{
+    GncBudgetPrivate* priv = GET_PRIVATE(budget);
+    PeriodValue *values;
+
+    if (period_num >= priv->num_periods)
+        return;
+
+    values = g_hash_table_lookup (priv->acct_values,
+                                  xaccAccountGetGUID (account));
+    if (!values)
+        return;
+
+    values[period_num].is_set = (val != NULL);
+    values[period_num].value = val ? *val : gnc_numeric_zero ();
+}
+
+static void
+store_period_value (GncBudget *budget, const Account *account,
+                    const char *path1, guint period_num, gnc_numeric val)
+{
+    gchar path_part_two [GNC_BUDGET_MAX_NUM_PERIODS_DIGITS];
+
+    g_sprintf (path_part_two, "%d", period_num);
+    if (gnc_numeric_check(val))
+    {
+        qof_instance_set_kvp (QOF_INSTANCE (budget), NULL, 2, path1, path_part_two);
+        update_account_value (budget, account, period_num, NULL);
+    }
+    else
+    {
+        GValue v = G_VALUE_INIT;
+        g_value_init (&v, GNC_TYPE_NUMERIC);
+        g_value_set_boxed (&v, &val);
+        qof_instance_set_kvp (QOF_INSTANCE (budget), &v, 2, path1, path_part_two);
+        g_value_unset (&v);
+        update_account_value (budget, account, period_num, &val);
+    }
+}
+
 /* period_num is zero-based */
 /* What happens when account is deleted, after we have an entry for it? */
 void
@@ -496,6 +638,7 @@ gnc_budget_unset_account_period_value(GncBudget *budget, const Account *account,
 
     gnc_budget_begin_edit(budget);
     qof_instance_set_kvp (QOF_INSTANCE (budget), NULL, 2, path_part_one, path_part_two);
+    update_account_value (budget, account, period_num, NULL);
     qof_instance_set_dirty(&budget->inst);
     gnc_budget_commit_edit(budget);
 
@@ -510,7 +653,6 @@ gnc_budget_set_account_period_value(GncBudget *budget, const Account *account,
                                     guint period_num, gnc_numeric val)
 {
     gchar path_part_one [GUID_ENCODING_LENGTH + 1];
-    gchar path_part_two [GNC_BUDGET_MAX_NUM_PERIODS_DIGITS];
 
     /* Watch out for an off-by-one error here:
      * period_num starts from 0 while num_periods starts from 1 */
@@ -523,24 +665,45 @@ gnc_budget_set_account_period_value(GncBudget *budget, const Account *account,
     g_return_if_fail (budget != NULL);
     g_return_if_fail (account != NULL);
 
-    make_period_path (account, period_num, path_part_one, path_part_two);
+    guid_to_string_buff (xaccAccountGetGUID (account), path_part_one);
 
     gnc_budget_begin_edit(budget);
-    if (gnc_numeric_check(val))
-        qof_instance_set_kvp (QOF_INSTANCE (budget), NULL, 2, path_part_one, path_part_two);
-    else
+    store_period_value (budget, account, path_part_one, period_num, val);
+    qof_instance_set_dirty(&budget->inst);
+    gnc_budget_commit_edit(budget);
+
+    qof_event_gen( &budget->inst, QOF_EVENT_MODIFY, NULL);
+
+}
+
+void
+gnc_budget_set_account_period_values(GncBudget *budget, const Account *account,
+                                     const gnc_numeric *values, guint n_values)
+{
+    gchar path_part_one [GUID_ENCODING_LENGTH + 1];
+    guint i;
+
+    g_return_if_fail (GNC_IS_BUDGET(budget));
+    g_return_if_fail (account != NULL);
+    g_return_if_fail (values != NULL || n_values == 0);
+
+    if (n_values > GET_PRIVATE(budget)->num_periods)
     {
-        GValue v = G_VALUE_INIT;
-        g_value_init (&v, GNC_TYPE_NUMERIC);
-        g_value_set_boxed (&v, &val);
-        qof_instance_set_kvp (QOF_INSTANCE (budget), &v, 2, path_part_one, path_part_two);
-        g_value_unset (&v);
+        PWARN("Period %i does not exist", GET_PRIVATE(budget)->num_periods);
+        n_values = GET_PRIVATE(budget)->num_periods;
     }
+    if (n_values == 0)
+        return;
+
+    guid_to_string_buff (xaccAccountGetGUID (account), path_part_one);
+
+    gnc_budget_begin_edit(budget);
+    for (i = 0; i < n_values; i++)
+        store_period_value (budget, account, path_part_one, i, values[i]);
     qof_instance_set_dirty(&budget->inst);
     gnc_budget_commit_edit(budget);
 
     qof_event_gen( &budget->inst, QOF_EVENT_MODIFY, NULL);
-
 }
 
 /* We don't need these here, but maybe they're useful somewhere else?
@@ -551,20 +714,17 @@ gnc_budget_is_account_period_value_set(const GncBudget *budget,
                                        const Account *account,
                                        guint period_num)
 {
-    GValue v = G_VALUE_INIT;
     gchar path_part_one [GUID_ENCODING_LENGTH + 1];
-    gchar path_part_two [GNC_BUDGET_MAX_NUM_PERIODS_DIGITS];
-    gconstpointer ptr = NULL;
+    gnc_numeric value;
 
     g_return_val_if_fail(GNC_IS_BUDGET(budget), FALSE);
     g_return_val_if_fail(account, FALSE);
 
-    make_period_path (account, period_num, path_part_one, path_part_two);
-    qof_instance_get_kvp (QOF_INSTANCE (budget), &v, 2, path_part_one, path_part_two);
-    if (G_VALUE_HOLDS_BOXED (&v))
-        ptr = g_value_get_boxed (&v);
-    g_value_unset (&v);
-    return (ptr != NULL);
+    if (period_num < GET_PRIVATE(budget)->num_periods)
+        return get_account_values (budget, account)[period_num].is_set;
+
+    guid_to_string_buff (xaccAccountGetGUID (account), path_part_one);
+    return read_period_value (budget, path_part_one, period_num, &value);
 }
 
 gnc_numeric
@@ -572,25 +732,42 @@ gnc_budget_get_account_period_value(const GncBudget *budget,
                                     const Account *account,
                                     guint period_num)
 {
-    gnc_numeric *numeric = NULL;
     gnc_numeric retval;
     gchar path_part_one [GUID_ENCODING_LENGTH + 1];
-    gchar path_part_two [GNC_BUDGET_MAX_NUM_PERIODS_DIGITS];
-    GValue v = G_VALUE_INIT;
 
     g_return_val_if_fail(GNC_IS_BUDGET(budget), gnc_numeric_zero());
     g_return_val_if_fail(account, gnc_numeric_zero());
 
-    make_period_path (account, period_num, path_part_one, path_part_two);
-    qof_instance_get_kvp (QOF_INSTANCE (budget), &v, 2, path_part_one, path_part_two);
-    if (G_VALUE_HOLDS_BOXED (&v))
-        numeric = (gnc_numeric*)g_value_get_boxed (&v);
+    if (period_num < GET_PRIVATE(budget)->num_periods)
+        return get_account_values (budget, account)[period_num].value;
 
-    retval = numeric ? *numeric : gnc_numeric_zero ();
-    g_value_unset (&v);
+    guid_to_string_buff (xaccAccountGetGUID (account), path_part_one);
+    read_period_value (budget, path_part_one, period_num, &retval);
     return retval;
 }
 
+guint
+gnc_budget_get_account_period_values(const GncBudget *budget,
+                                     const Account *account,
+                                     gnc_numeric *values, guint n_values)
+{
+    PeriodValue *acct_values;
+    guint i;
+
+    g_return_val_if_fail(GNC_IS_BUDGET(budget), 0);
+    g_return_val_if_fail(account, 0);
+    g_return_val_if_fail(values != NULL || n_values == 0, 0);
+
+    n_values = MIN (n_values, GET_PRIVATE(budget)->num_periods);
+    if (n_values == 0)
+        return 0;
+
+    acct_values = get_account_values (budget, account);
+    for (i = 0; i < n_values; i++)
+        values[i] = acct_values[i].value;
+    return n_values;
+}
+
 
 void
 gnc_budget_set_account_period_note(GncBudget *budget, const Account *account,
@@ -647,10 +824,47 @@ gnc_budget_get_account_period_note(const GncBudget *budget,
     return (G_VALUE_HOLDS_STRING(&v)) ? g_value_get_string(&v) : NULL;
 }
 
+/* The same times as recurrenceGetPeriodTime() gives, for every period
+ * at once: period n starts at the nth instance and ends the day before
+ * the next one. */
+static const time64*
+get_period_times (const GncBudget *budget)
+{
+    GncBudgetPrivate* priv = GET_PRIVATE(budget);
+    GDate *dates;
+    guint i;
+
+    if (priv->period_times || priv->num_periods == 0)
+        return priv->period_times;
+
+    dates = g_new (GDate, priv->num_periods + 1);
+    recurrenceGetInstances (&priv->recurrence, priv->num_periods + 1, dates);
+
+    priv->period_times = g_new (time64, 2 * priv->num_periods);
+    for (i = 0; i < priv->num_periods; i++)
+    {
+        GDate end = dates[i + 1];
+
+        priv->period_times[2 * i] =
+            gnc_dmy2time64 (g_date_get_day (&dates[i]),
+                            g_date_get_month (&dates[i]),
+                            g_date_get_year (&dates[i]));
+        g_date_subtract_days (&end, 1);
+        priv->period_times[2 * i + 1] =
+            gnc_dmy2time64_end (g_date_get_day (&end),
+                                g_date_get_month (&end),
+                                g_date_get_year (&end));
+    }
+    g_free (dates);
+    return priv->period_times;
+}
+
 time64
 gnc_budget_get_period_start_date(const GncBudget *budget, guint period_num)
 {
     g_return_val_if_fail (GNC_IS_BUDGET(budget), 0);
+    if (period_num < GET_PRIVATE(budget)->num_periods)
+        return get_period_times (budget)[2 * period_num];
     return recurrenceGetPeriodTime(&GET_PRIVATE(budget)->recurrence, period_num, FALSE);
 }
 
@@ -658,19 +872,76 @@ time64
 gnc_budget_get_period_end_date(const GncBudget *budget, guint period_num)
 {
     g_return_val_if_fail (GNC_IS_BUDGET(budget), 0);
+    if (period_num < GET_PRIVATE(budget)->num_periods)
+        return get_period_times (budget)[2 * period_num + 1];
     return recurrenceGetPeriodTime(&GET_PRIVATE(budget)->recurrence, period_num, TRUE);
 }
 
+/* All of the account's actual amounts, worked out in one pass over
+ * the splits of its subtree when first asked for or after a change. */
+static const gnc_numeric*
+get_account_actuals (const GncBudget *budget, Account *acc)
+{
+    GncBudgetPrivate* priv = GET_PRIVATE(budget);
+    const GncGUID *guid = xaccAccountGetGUID (acc);
+    guint64 generation = gnc_account_get_subtree_generation (acc);
+    guint64 price_generation = gnc_pricedb_get_generation ();
+    PeriodActuals *actuals;
+
+    actuals = g_hash_table_lookup (priv->acct_actuals, guid);
+    if (actuals && actuals->generation == generation &&
+        actuals->price_generation == price_generation)
+        return actuals->values;
+
+    if (!actuals)
+    {
+        actuals = g_malloc (sizeof (PeriodActuals) +
+                            priv->num_periods * sizeof (gnc_numeric));
+        g_hash_table_insert (priv->acct_actuals, guid_copy (guid), actuals);
+    }
+    gnc_account_get_noclosing_balance_changes (acc, get_period_times (budget),
+                                               priv->num_periods, TRUE,
+                                               actuals->values);
+    actuals->generation = generation;
+    actuals->price_generation = price_generation;
+    return actuals->values;
+}
+
 gnc_numeric
 gnc_budget_get_account_period_actual_value(
     const GncBudget *budget, Account *acc, guint period_num)
 {
     // FIXME: maybe zero is not best error return val.
     g_return_val_if_fail(GNC_IS_BUDGET(budget) && acc, gnc_numeric_zero());
+    if (period_num < GET_PRIVATE(budget)->num_periods)
+        return get_account_actuals (budget, acc)[period_num];
     return recurrenceGetAccountPeriodValue(&GET_PRIVATE(budget)->recurrence,
                                            acc, period_num);
 }
 
+guint
+gnc_budget_get_account_period_actual_values(const GncBudget *budget,
+                                            Account *acc,
+                                            gnc_numeric *values,
+                                            guint n_values)
+{
+    const gnc_numeric *actuals;
+    guint i;
+
+    g_return_val_if_fail(GNC_IS_BUDGET(budget), 0);
+    g_return_val_if_fail(acc, 0);
+    g_return_val_if_fail(values != NULL || n_values == 0, 0);
+
+    n_values = MIN (n_values, GET_PRIVATE(budget)->num_periods);
+    if (n_values == 0)
+        return 0;
+
+    actuals = get_account_actuals (budget, acc);
+    for (i = 0; i < n_values; i++)
+        values[i] = actuals[i];
+    return n_values;
+}
+
 GncBudget*
 gnc_budget_lookup (const GncGUID *guid, const QofBook *book)
 {
@@ -151,11 +151,34 @@ gboolean gnc_budget_is_account_period_value_set(
 gnc_numeric gnc_budget_get_account_period_value(
     const GncBudget *budget, const Account *account, guint period_num);
 
+/** Set the budgeted values of periods 0 to n_values - 1 in one edit,
+ * with a single modify event. An invalid gnc_numeric unsets its period.
+ * n_values may not exceed the number of periods. */
+void gnc_budget_set_account_period_values(
+    GncBudget *budget, const Account *account,
+    const gnc_numeric *values, guint n_values);
+
+/** Fill values with the budgeted values of the first n_values periods,
+ * zero for those not set.
+ * @return the number of values filled, at most the number of periods. */
+guint gnc_budget_get_account_period_values(
+    const GncBudget *budget, const Account *account,
+    gnc_numeric *values, guint n_values);
+
 /* get the budget account period's actual value, including children,
    excluding closing entries */
 gnc_numeric gnc_budget_get_account_period_actual_value(
     const GncBudget *budget, Account *account, guint period_num);
 
+/** Fill values with the actual values of the first n_values periods,
+ * as gnc_budget_get_account_period_actual_value() gives them. The
+ * actual values are cached in the budget until a balance under the
+ * account or a price changes.
+ * @return the number of values filled, at most the number of periods. */
+guint gnc_budget_get_account_period_actual_values(
+    const GncBudget *budget, Account *account,
+    gnc_numeric *values, guint n_values);
+
 void gnc_budget_set_account_period_note(GncBudget *budget,
     const Account *account, guint period_num, const gchar *note);
 const gchar *gnc_budget_get_account_period_note(const GncBudget *budget,
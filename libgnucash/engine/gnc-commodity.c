@@ -119,6 +119,12 @@ struct gnc_commodity_table_s
 {
     GHashTable * ns_table;
     GList      * ns_list;
+    /* Non-empty CUSIP -> GList of the commodities in the table that have
+     * it, in the order they were added.  Built by the first lookup. */
+    GHashTable * cusip_index;
+    /* "namespace::mnemonic" -> commodity, with the same entries as the
+     * namespaces' cm_tables, so that a lookup hashes one string. */
+    GHashTable * commodity_index;
 };
 
 struct gnc_new_iso_code
@@ -1301,6 +1307,63 @@ gnc_commodity_set_fullname(gnc_commodity * cm, const char * fullname)
     gnc_commodity_commit_edit(cm);
 }
 
+/********************************************************************
+ * CUSIP index of a commodity table
+ ********************************************************************/
+
+static void
+cusip_index_add (gnc_commodity_table *table, gnc_commodity *cm)
+{
+    const char *cusip = GET_PRIVATE(cm)->cusip;
+    GList *list;
+
+    if (!table || !table->cusip_index || !cusip || !*cusip)
+        return;
+
+    list = g_hash_table_lookup (table->cusip_index, cusip);
+    if (g_list_find (list, cm))
+        return;
+    list = g_list_append (list, cm);
+    g_hash_table_insert (table->cusip_index, g_strdup (cusip), list);
+}
+
+/* Returns whether cm was in the index. */
+static gboolean
+cusip_index_remove (gnc_commodity_table *table, gnc_commodity *cm)
+{
+    const char *cusip = GET_PRIVATE(cm)->cusip;
+    GList *list;
+
+    if (!table || !table->cusip_index || !cusip || !*cusip)
+        return FALSE;
+
+    list = g_hash_table_lookup (table->cusip_index, cusip);
+    if (!g_list_find (list, cm))
+        return FALSE;
+    list = g_list_remove (list, cm);
+    if (list)
+        g_hash_table_insert (table->cusip_index, g_strdup (cusip), list);
+    else
+        g_hash_table_remove (table->cusip_index, cusip);
+    return TRUE;
+}
+
+static void
+cusip_index_free_list (gpointer key, gpointer value, gpointer data)
+{
+    g_list_free (value);
+}
+
+static void
+cusip_index_destroy (gnc_commodity_table *table)
+{
+    if (!table->cusip_index)
+        return;
+    g_hash_table_foreach (table->cusip_index, cusip_index_free_list, NULL);
+    g_hash_table_destroy (table->cusip_index);
+    table->cusip_index = NULL;
+}
+
 /********************************************************************
  * gnc_commodity_set_cusip
  ********************************************************************/
@@ -1310,15 +1373,27 @@ gnc_commodity_set_cusip(gnc_commodity * cm,
                         const char * cusip)
 {
     gnc_commodityPrivate* priv;
+    gnc_commodity_table *table;
+    gboolean in_table;
 
     if (!cm) return;
 
     priv = GET_PRIVATE(cm);
     if (priv->cusip == cusip) return;
 
+    table = gnc_commodity_table_get_table (qof_instance_get_book (&cm->inst));
+    /* Only commodities in the table are indexed, whether or not they had
+     * a CUSIP before. */
+    in_table = table &&
+        gnc_commodity_table_lookup (table, gnc_commodity_get_namespace (cm),
+                                    gnc_commodity_get_mnemonic (cm)) == cm;
     gnc_commodity_begin_edit(cm);
+    if (in_table)
+        cusip_index_remove (table, cm);
     CACHE_REMOVE (priv->cusip);
     priv->cusip = CACHE_INSERT (cusip);
+    if (in_table)
+        cusip_index_add (table, cm);
     mark_commodity_dirty(cm);
     gnc_commodity_commit_edit(cm);
 }
@@ -1747,6 +1822,9 @@ gnc_commodity_table_new(void)
     gnc_commodity_table * retval = g_new0(gnc_commodity_table, 1);
     retval->ns_table = g_hash_table_new(&g_str_hash, &g_str_equal);
     retval->ns_list = NULL;
+    retval->cusip_index = NULL;
+    retval->commodity_index = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                     g_free, NULL);
     return retval;
 }
 
@@ -1816,6 +1894,68 @@ gnc_commodity_table_get_size(const gnc_commodity_table* tbl)
     return count;
 }
 
+/* The current code of a currency that has recently changed, or mnemonic. */
+static const char *
+new_iso_code (const char *mnemonic)
+{
+    guint i;
+    for (i = 0; i < GNC_NEW_ISO_CODES; i++)
+        if (strcmp (mnemonic, gnc_new_iso_codes[i].old_code) == 0)
+            return gnc_new_iso_codes[i].new_code;
+    return mnemonic;
+}
+
+#define COMMODITY_KEY_BUF_LEN 128
+
+/* Builds "name_space::mnemonic" in buf if it fits, else in a new string. */
+static gchar *
+commodity_index_key (const char *name_space, const char *mnemonic,
+                     gchar *buf, gsize buf_len)
+{
+    gsize ns_len = strlen (name_space);
+    gsize mn_len = strlen (mnemonic);
+    gsize len = ns_len + 2 + mn_len + 1;
+    gchar *key = len <= buf_len ? buf : g_malloc (len);
+
+    memcpy (key, name_space, ns_len);
+    memcpy (key + ns_len, "::", 2);
+    memcpy (key + ns_len + 2, mnemonic, mn_len + 1);
+    return key;
+}
+
+static gnc_commodity *
+commodity_index_lookup (const gnc_commodity_table *table,
+                        const char *name_space, const char *mnemonic)
+{
+    gchar buf[COMMODITY_KEY_BUF_LEN];
+    gchar *key = commodity_index_key (name_space, mnemonic, buf, sizeof (buf));
+    gnc_commodity *cm = g_hash_table_lookup (table->commodity_index, key);
+
+    if (key != buf)
+        g_free (key);
+    return cm;
+}
+
+static void
+commodity_index_add (gnc_commodity_table *table, const char *name_space,
+                     const char *mnemonic, gnc_commodity *cm)
+{
+    g_hash_table_insert (table->commodity_index,
+                         g_strconcat (name_space, "::", mnemonic, NULL), cm);
+}
+
+static void
+commodity_index_remove (gnc_commodity_table *table, const char *name_space,
+                        const char *mnemonic)
+{
+    gchar buf[COMMODITY_KEY_BUF_LEN];
+    gchar *key = commodity_index_key (name_space, mnemonic, buf, sizeof (buf));
+
+    g_hash_table_remove (table->commodity_index, key);
+    if (key != buf)
+        g_free (key);
+}
+
 /********************************************************************
  * gnc_commodity_table_lookup
  * locate a commodity by namespace and mnemonic.
@@ -1825,36 +1965,18 @@ gnc_commodity *
 gnc_commodity_table_lookup(const gnc_commodity_table * table,
                            const char * name_space, const char * mnemonic)
 {
-    gnc_commodity_namespace * nsp = NULL;
-    unsigned int i;
-
     if (!table || !name_space || !mnemonic) return NULL;
 
-    nsp = gnc_commodity_table_find_namespace(table, name_space);
+    name_space = gnc_commodity_table_map_namespace(name_space);
 
-    if (nsp)
-    {
-        /*
-         * Backward compatibility support for currencies that have
-         * recently changed.
-         */
-        if (nsp->iso4217)
-        {
-            for (i = 0; i < GNC_NEW_ISO_CODES; i++)
-            {
-                if (strcmp(mnemonic, gnc_new_iso_codes[i].old_code) == 0)
-                {
-                    mnemonic = gnc_new_iso_codes[i].new_code;
-                    break;
-                }
-            }
-        }
-        return g_hash_table_lookup(nsp->cm_table, (gpointer)mnemonic);
-    }
-    else
-    {
-        return NULL;
-    }
+    /*
+     * Backward compatibility support for currencies that have
+     * recently changed.
+     */
+    if (gnc_commodity_namespace_is_iso(name_space))
+        mnemonic = new_iso_code(mnemonic);
+
+    return commodity_index_lookup(table, name_space, mnemonic);
 }
 
 /********************************************************************
@@ -1868,18 +1990,26 @@ gnc_commodity_table_lookup_unique(const gnc_commodity_table *table,
 {
     char *name_space;
     char *mnemonic;
+    const char *sep;
     gnc_commodity *commodity;
 
     if (!table || !unique_name) return NULL;
 
-    name_space = g_strdup (unique_name);
-    mnemonic = strstr (name_space, "::");
-    if (!mnemonic)
-    {
-        g_free (name_space);
+    sep = strstr (unique_name, "::");
+    if (!sep)
         return NULL;
+
+    /* Most names are already the index's keys. The others use the old
+     * ISO namespace or an old currency code and need mapping first. */
+    if (new_iso_code (sep + 2) == sep + 2)
+    {
+        commodity = g_hash_table_lookup (table->commodity_index, unique_name);
+        if (commodity)
+            return commodity;
     }
 
+    name_space = g_strdup (unique_name);
+    mnemonic = name_space + (sep - unique_name);
     *mnemonic = '\0';
     mnemonic += 2;
 
@@ -1890,6 +2020,38 @@ gnc_commodity_table_lookup_unique(const gnc_commodity_table *table,
     return commodity;
 }
 
+/********************************************************************
+ * gnc_commodity_table_lookup_by_cusip
+ * locate a commodity by its CUSIP or other identifying code.
+ ********************************************************************/
+
+gnc_commodity *
+gnc_commodity_table_lookup_by_cusip(const gnc_commodity_table * table,
+                                    const char * cusip)
+{
+    gnc_commodity_table *t = (gnc_commodity_table *) table;
+    GList *list;
+
+    if (!table || !cusip || !*cusip) return NULL;
+
+    if (!t->cusip_index)
+    {
+        GList *ns_node, *cm_node;
+
+        t->cusip_index = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                g_free, NULL);
+        for (ns_node = t->ns_list; ns_node; ns_node = ns_node->next)
+        {
+            gnc_commodity_namespace *nsp = ns_node->data;
+            for (cm_node = nsp->cm_list; cm_node; cm_node = cm_node->next)
+                cusip_index_add (t, cm_node->data);
+        }
+    }
+
+    list = g_hash_table_lookup (t->cusip_index, cusip);
+    return list ? list->data : NULL;
+}
+
 /********************************************************************
  * gnc_commodity_table_find_full
  * locate a commodity by namespace and printable name
@@ -1999,7 +2161,9 @@ gnc_commodity_table_insert(gnc_commodity_table * table,
     g_hash_table_insert(nsp->cm_table,
                         CACHE_INSERT(priv->mnemonic),
                         (gpointer)comm);
+    commodity_index_add (table, nsp->name, priv->mnemonic, comm);
     nsp->cm_list = g_list_append(nsp->cm_list, comm);
+    cusip_index_add (table, comm);
 
     qof_event_gen (&comm->inst, QOF_EVENT_ADD, NULL);
     LEAVE ("(table=%p, comm=%p)", table, comm);
@@ -2023,6 +2187,10 @@ gnc_commodity_table_remove(gnc_commodity_table * table,
     if (!table) return;
     if (!comm) return;
 
+    /* Before the lookup: a namespace being deleted has already left
+     * the table when it destroys its commodities. */
+    cusip_index_remove (table, comm);
+
     priv = GET_PRIVATE(comm);
     ns_name = gnc_commodity_namespace_get_name(priv->name_space);
     c = gnc_commodity_table_lookup (table, ns_name, priv->mnemonic);
@@ -2035,6 +2203,7 @@ gnc_commodity_table_remove(gnc_commodity_table * table,
 
     nsp->cm_list = g_list_remove(nsp->cm_list, comm);
     g_hash_table_remove (nsp->cm_table, priv->mnemonic);
+    commodity_index_remove (table, nsp->name, priv->mnemonic);
     /* XXX minor mem leak, should remove the key as well */
 }
 
@@ -2361,6 +2530,8 @@ gnc_commodity_table_delete_namespace(gnc_commodity_table * table,
                                      const char * name_space)
 {
     gnc_commodity_namespace * ns;
+    GHashTableIter iter;
+    gpointer key;
 
     if (!table) return;
 
@@ -2368,6 +2539,10 @@ gnc_commodity_table_delete_namespace(gnc_commodity_table * table,
     if (!ns)
         return;
 
+    g_hash_table_iter_init (&iter, ns->cm_table);
+    while (g_hash_table_iter_next (&iter, &key, NULL))
+        commodity_index_remove (table, ns->name, key);
+
     qof_event_gen (&ns->inst, QOF_EVENT_REMOVE, NULL);
     g_hash_table_remove(table->ns_table, name_space);
     table->ns_list = g_list_remove(table->ns_list, ns);
@@ -2448,6 +2623,7 @@ gnc_commodity_table_destroy(gnc_commodity_table * t)
     if (!t) return;
     ENTER ("table=%p", t);
 
+    cusip_index_destroy (t);
     for (item = t->ns_list; item; item = next)
     {
         next = g_list_next(item);
@@ -2459,6 +2635,8 @@ gnc_commodity_table_destroy(gnc_commodity_table * t)
     t->ns_list = NULL;
     g_hash_table_destroy(t->ns_table);
     t->ns_table = NULL;
+    g_hash_table_destroy(t->commodity_index);
+    t->commodity_index = NULL;
     LEAVE ("table=%p", t);
     g_free(t);
 }
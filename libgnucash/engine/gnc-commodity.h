@@ -755,6 +755,15 @@ gnc_commodity * gnc_commodity_table_find_full(const gnc_commodity_table * t,
         const char * commodity_namespace,
         const char * fullname);
 
+/** Find the commodity in the table whose CUSIP (or other identifying
+ *  code) is cusip.  If several have it, the one added first is
+ *  returned.
+ *
+ *  @return The commodity, or NULL if cusip is empty or not found.
+ */
+gnc_commodity * gnc_commodity_table_lookup_by_cusip(const gnc_commodity_table * table,
+        const char * cusip);
+
 /*@ dependent @*/
 gnc_commodity * gnc_commodity_find_commodity_by_guid(const GncGUID *guid,
         QofBook *book);
@@ -118,7 +118,7 @@ gnc_localtime_r (const time64 *secs, struct tm* time)
 {
     try
     {
-        *time = static_cast<struct tm>(GncDateTime(*secs));
+        *time = GncDateTime::local_tm(*secs);
         return time;
     }
     catch(std::invalid_argument&)
@@ -232,9 +232,7 @@ gnc_mktime (struct tm* time)
     try
     {
         normalize_struct_tm (time);
-        GncDateTime gncdt(*time);
-        *time = static_cast<struct tm>(gncdt);
-        return static_cast<time64>(gncdt);
+        return GncDateTime::from_local_tm(*time);
     }
     catch(std::invalid_argument&)
     {
@@ -551,11 +549,93 @@ const gchar *qof_date_text_format_get_string(QofDateFormat df)
     return GNC_D_FMT;
 }
 
+static inline char*
+put_digits (char* p, int value, int width)
+{
+    for (auto q = p + width; q > p; value /= 10)
+        *--q = '0' + value % 10;
+    return p + width;
+}
+
+/* The numeric date formats are printed directly rather than through
+ * a locale's time facet: the output is the same and this is much
+ * faster. Returns 0 for the formats that do need the locale, for UTC
+ * if tm has no time of day and for years GncDate doesn't take; the
+ * caller then formats it. */
+static size_t
+print_fixed_date (char *buff, const size_t len, QofDateFormat df,
+                  const struct tm& tm, bool has_time)
+{
+    char str[MAX_DATE_LENGTH + 1];
+    auto year = tm.tm_year + 1900;
+    char* p = str;
+
+    if (year < 1400 || year > 9999 || len == 0)
+        return 0;
+    if (df == QOF_DATE_FORMAT_UTC && !has_time)
+        return 0;
+
+    switch (df)
+    {
+    case QOF_DATE_FORMAT_US:
+        p = put_digits (p, tm.tm_mon + 1, 2);
+        *p++ = '/';
+        p = put_digits (p, tm.tm_mday, 2);
+        *p++ = '/';
+        p = put_digits (p, year, 4);
+        break;
+    case QOF_DATE_FORMAT_UK:
+    case QOF_DATE_FORMAT_CE:
+        p = put_digits (p, tm.tm_mday, 2);
+        *p++ = df == QOF_DATE_FORMAT_UK ? '/' : '.';
+        p = put_digits (p, tm.tm_mon + 1, 2);
+        *p++ = df == QOF_DATE_FORMAT_UK ? '/' : '.';
+        p = put_digits (p, year, 4);
+        break;
+    case QOF_DATE_FORMAT_ISO:
+    case QOF_DATE_FORMAT_UTC:
+        p = put_digits (p, year, 4);
+        *p++ = '-';
+        p = put_digits (p, tm.tm_mon + 1, 2);
+        *p++ = '-';
+        p = put_digits (p, tm.tm_mday, 2);
+        if (df == QOF_DATE_FORMAT_ISO)
+            break;
+        *p++ = 'T';
+        p = put_digits (p, tm.tm_hour, 2);
+        *p++ = ':';
+        p = put_digits (p, tm.tm_min, 2);
+        *p++ = ':';
+        p = put_digits (p, tm.tm_sec, 2);
+        *p++ = 'Z';
+        break;
+    default:
+        return 0;
+    }
+
+    size_t length = p - str;
+    if (length >= len)
+        length = len - 1;
+    memcpy (buff, str, length);
+    buff[length] = '\0';
+    return length;
+}
+
 size_t
 qof_print_date_dmy_buff (char * buff, const size_t len, int day, int month, int year)
 {
     if (!buff) return 0;
 
+    if (g_date_valid_dmy (day, static_cast<GDateMonth>(month), year))
+    {
+        struct tm tm{};
+        tm.tm_mday = day;
+        tm.tm_mon = month - 1;
+        tm.tm_year = year - 1900;
+        if (auto length = print_fixed_date (buff, len, dateFormat, tm, false))
+            return length;
+    }
+
     try
     {
         GncDate date(year, month, day);
@@ -584,6 +664,10 @@ qof_print_date_buff (char * buff, const size_t len, time64 t)
 
     try
     {
+        if (auto length = print_fixed_date (buff, len, dateFormat,
+                                            GncDateTime::local_tm (t), true))
+            return length;
+
         GncDateTime gncdt(t);
         std::string str = gncdt.format(qof_date_format_get_string(dateFormat));
         strncpy(buff, str.c_str(), len);
@@ -1113,11 +1197,69 @@ gnc_date_timestamp (void)
  */
 
 #define ISO_DATE_FORMAT "%d-%d-%d %d:%d:%lf%s"
+/* Reads the given number of digits, or returns -1 if any isn't one. */
+static int
+iso8601_digits (const char *str, int n)
+{
+    int value = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        if (str[i] < '0' || str[i] > '9')
+            return -1;
+        value = value * 10 + (str[i] - '0');
+    }
+    return value;
+}
+
+/* The "YYYY-MM-DD HH:MM:SS +HHMM" form the XML backend writes for every
+ * date, converted without going through GncDateTime. Returns FALSE for
+ * anything else, including values the general parser might reject, so
+ * that it gets the final say on them. */
+static gboolean
+iso8601_canonical_to_time64 (const char *str, time64 *time)
+{
+    if (strlen (str) != 25 || str[4] != '-' || str[7] != '-' ||
+        str[10] != ' ' || str[13] != ':' || str[16] != ':' ||
+        str[19] != ' ' || (str[20] != '+' && str[20] != '-'))
+        return FALSE;
+
+    int year = iso8601_digits (str, 4), month = iso8601_digits (str + 5, 2);
+    int day = iso8601_digits (str + 8, 2), hour = iso8601_digits (str + 11, 2);
+    int min = iso8601_digits (str + 14, 2), sec = iso8601_digits (str + 17, 2);
+    int off_hour = iso8601_digits (str + 21, 2);
+    int off_min = iso8601_digits (str + 23, 2);
+    if (year < 1400 || month < 1 || month > 12 || day < 1 || hour < 0 ||
+        hour > 23 || min < 0 || min > 59 || sec < 0 || sec > 59 ||
+        off_hour < 0 || off_hour > 23 || off_min < 0 || off_min > 59)
+        return FALSE;
+
+    static const int mdays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (day > mdays[month - 1] + (month == 2 && leap))
+        return FALSE;
+
+    /* Days since 1970-01-01 in the proleptic Gregorian calendar, counting
+     * years from March so that the leap day comes last. */
+    int y = month <= 2 ? year - 1 : year;
+    int era = y / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    time64 days = static_cast<time64>(era) * 146097 + doe - 719468;
+
+    time64 offset = off_hour * 3600 + off_min * 60;
+    *time = days * 86400 + hour * 3600 + min * 60 + sec -
+        (str[20] == '-' ? -offset : offset);
+    return TRUE;
+}
+
 time64
 gnc_iso8601_to_time64_gmt(const char *cstr)
 {
     time64 time;
     if (!cstr) return INT64_MAX;
+    if (iso8601_canonical_to_time64 (cstr, &time))
+        return time;
     try
     {
         GncDateTime gncdt(cstr);
@@ -1172,8 +1314,7 @@ gnc_dmy2time64_internal (int day, int month, int year, DayPart day_part)
 {
     try
     {
-        auto date = GncDate(year, month, day);
-        return static_cast<time64>(GncDateTime (date, day_part));
+        return GncDateTime::day_part_time64 (year, month, day, day_part);
     }
     catch(const std::logic_error& err)
     {
@@ -1299,11 +1440,9 @@ time64
 gnc_time64_get_day_start (time64 time_val)
 {
     struct tm tm;
-    time64 new_time;
-
-    gnc_tm_get_day_start(&tm, time_val);
-    new_time = gnc_mktime(&tm);
-    return new_time;
+    gnc_localtime_r(&time_val, &tm);
+    return gnc_dmy2time64_internal(tm.tm_mday, tm.tm_mon + 1, tm.tm_year + 1900,
+                                   DayPart::start);
 }
 
 time64
@@ -1319,11 +1458,9 @@ time64
 gnc_time64_get_day_end (time64 time_val)
 {
     struct tm tm;
-    time64 new_time;
-
-    gnc_tm_get_day_end(&tm, time_val);
-    new_time = gnc_mktime(&tm);
-    return new_time;
+    gnc_localtime_r(&time_val, &tm);
+    return gnc_dmy2time64_internal(tm.tm_mday, tm.tm_mon + 1, tm.tm_year + 1900,
+                                   DayPart::end);
 }
 
 /* ======================================================== */
@@ -1428,35 +1565,62 @@ gnc_gdate_hash( gconstpointer gd )
 time64
 gnc_time64_get_day_start_gdate (const GDate *date)
 {
-    struct tm stm;
-    time64 secs;
-
-    /* First convert to a 'struct tm' */
-    g_date_to_struct_tm (date, &stm);
-
-    /* Then convert to number of seconds */
-    secs = gnc_mktime (&stm);
-    return secs;
+    return gnc_dmy2time64 (g_date_get_day (date), g_date_get_month (date),
+                           g_date_get_year (date));
 }
 
 time64
 gnc_time64_get_day_end_gdate (const GDate *date)
 {
-    struct tm stm;
-    time64 secs;
+    return gnc_dmy2time64_end (g_date_get_day (date), g_date_get_month (date),
+                               g_date_get_year (date));
+}
+
+/* The date idx periods of months months and days days after start,
+ * kept on the month end if start is on one. */
+static void
+period_start_gdate (const GDate *start, gint months, gint days, gsize idx,
+                    GDate *date)
+{
+    gint month = g_date_get_month (start) - 1 + months * static_cast<gint>(idx);
+    gint year = g_date_get_year (start) + month / 12;
+    gint day = g_date_get_day (start);
+    guint8 month_days;
+
+    month %= 12;
+    month_days = g_date_get_days_in_month (static_cast<GDateMonth>(month + 1),
+                                           year);
+    if (day > month_days || g_date_is_last_of_month (start))
+        day = month_days;
 
-    /* First convert to a 'struct tm' */
-    g_date_to_struct_tm(date, &stm);
+    g_date_clear (date, 1);
+    g_date_set_dmy (date, day, static_cast<GDateMonth>(month + 1), year);
+    g_date_add_days (date, static_cast<guint>(days * idx));
+}
+
+void
+gnc_time64_get_period_bounds_gdate (const GDate *start, gint months, gint days,
+                                    gsize n, time64 *starts, time64 *ends)
+{
+    GDate date;
 
-    /* Force to th last second of the day */
-    stm.tm_hour = 23;
-    stm.tm_min = 59;
-    stm.tm_sec = 59;
-    stm.tm_isdst = -1;
+    g_return_if_fail (start && g_date_valid (start));
+    g_return_if_fail (months >= 0 && days >= 0 && (months || days));
+    g_return_if_fail (n == 0 || starts || ends);
 
-    /* Then convert to number of seconds */
-    secs = gnc_mktime (&stm);
-    return secs;
+    period_start_gdate (start, months, days, 0, &date);
+    for (gsize i = 0; i < n; ++i)
+    {
+        if (starts)
+            starts[i] = gnc_time64_get_day_start_gdate (&date);
+        period_start_gdate (start, months, days, i + 1, &date);
+        if (ends)
+        {
+            GDate last = date;
+            g_date_subtract_days (&last, 1);
+            ends[i] = gnc_time64_get_day_end_gdate (&last);
+        }
+    }
 }
 
 /* ================================================= */
@@ -659,6 +659,25 @@ time64 gnc_time64_get_day_start_gdate (const GDate *date);
  */
 time64 gnc_time64_get_day_end_gdate (const GDate *date);
 
+/** Fill in the boundaries of n consecutive periods, each months months
+ *  plus days days long, the first of which begins on start. starts
+ *  gets the first second of each period and ends the last, which is
+ *  the last second of the day before the next period begins; either
+ *  may be NULL. Months are stepped the way the reports' date lists
+ *  step them: a day past the end of a shorter month gives its last
+ *  day, and a start on a month end keeps every period on a month end.
+ *
+ *  @param start The first day of the first period.
+ *  @param months The number of months in each period.
+ *  @param days The number of days in each period.
+ *  @param n The number of periods, and of elements in starts and ends.
+ *  @param starts The array for the first second of each period, or NULL.
+ *  @param ends The array for the last second of each period, or NULL.
+ */
+void gnc_time64_get_period_bounds_gdate (const GDate *start, gint months,
+                                         gint days, gsize n, time64 *starts,
+                                         time64 *ends);
+
 //@}
 
 /* ======================================================== */
@@ -34,11 +34,14 @@ extern "C"
 #include <boost/regex.hpp>
 #include <libintl.h>
 #include <locale.h>
+#include <atomic>
+#include <cstring>
 #include <map>
 #include <memory>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #ifdef __MINGW32__
 #include <codecvt>
@@ -269,16 +272,262 @@ LDT_from_struct_tm(const struct tm tm)
     }
 }
 
+/* Bumped when the provider changes, a new one may reuse the address */
+static std::atomic<unsigned> tzp_generation{0};
+
 void
 _set_tzp(TimeZoneProvider& new_tzp)
 {
     tzp = &new_tzp;
+    ++tzp_generation;
 }
 
 void
 _reset_tzp()
 {
     tzp = &ltzp;
+    ++tzp_generation;
+}
+
+/* Fast local time conversions.
+ *
+ * Building a local_date_time for every conversion is slow, and most of
+ * what it works out, the UTC offset, is the same for the whole year
+ * outside of the DST transition days. ZoneYear keeps what a conversion
+ * needs to know about the time zone in force in a year: the offsets
+ * and the local DST start and end days (as days since the epoch) of
+ * the years before, of and after it, as the local year can differ
+ * from the UTC one. Conversions that fall on a transition day, or
+ * outside the years boost handles, are left to the LDT functions above
+ * so that their handling of skipped and repeated hours is kept.
+ */
+struct ZoneYear
+{
+    int64_t base_offset;
+    int64_t dst_offset;
+    bool has_dst;
+    int64_t dst_start[3];
+    int64_t dst_end[3];
+};
+
+static constexpr int64_t secs_per_day = 86400;
+
+static inline int64_t
+floor_div(int64_t num, int64_t den)
+{
+    return num / den - ((num % den != 0) && ((num < 0) != (den < 0)));
+}
+
+/* Days since the epoch of a proleptic Gregorian date, and back. See
+ * http://howardhinnant.github.io/date_algorithms.html */
+static int64_t
+days_from_civil(int64_t year, unsigned month, unsigned day)
+{
+    year -= month <= 2;
+    auto era = floor_div(year, 400);
+    auto yoe = static_cast<unsigned>(year - era * 400);
+    auto doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    auto doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+static void
+civil_from_days(int64_t days, int64_t& year, unsigned& month, unsigned& day)
+{
+    days += 719468;
+    auto era = floor_div(days, 146097);
+    auto doe = static_cast<unsigned>(days - era * 146097);
+    auto yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    auto doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    auto mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<int64_t>(yoe) + era * 400 + (month <= 2);
+}
+
+static inline int64_t
+days_from_date(const Date& date)
+{
+    return (date - unix_epoch.date()).days();
+}
+
+static bool
+fast_path_year(int64_t year)
+{
+    return year > static_cast<int64_t>(TimeZoneProvider::min_year) &&
+        year < static_cast<int64_t>(TimeZoneProvider::max_year);
+}
+
+static const ZoneYear&
+zone_year(int year)
+{
+    thread_local unsigned generation = 0;
+    thread_local std::unordered_map<int, ZoneYear> zone_years;
+
+    if (generation != tzp_generation)
+    {
+        zone_years.clear();
+        generation = tzp_generation;
+    }
+
+    auto iter = zone_years.find(year);
+    if (iter != zone_years.end())
+        return iter->second;
+
+    auto tz = tzp->get(year);
+    ZoneYear zy{};
+    zy.base_offset = tz->base_utc_offset().total_seconds();
+    zy.has_dst = tz->has_dst();
+    if (zy.has_dst)
+    {
+        zy.dst_offset = tz->dst_offset().total_seconds();
+        for (auto i = 0; i < 3; ++i)
+        {
+            zy.dst_start[i] = days_from_date(tz->dst_local_start_time(year + i - 1).date());
+            zy.dst_end[i] = days_from_date(tz->dst_local_end_time(year + i - 1).date());
+        }
+    }
+    return zone_years.emplace(year, zy).first->second;
+}
+
+/* Whether a local standard-time day of a year (0 = the year before the
+ * ZoneYear's own, 1 = its own, 2 = the year after) is in DST, by the
+ * same date comparisons boost's dst_calculator makes. Returns false
+ * on a transition day, where the time of day matters. */
+static bool
+day_is_dst(const ZoneYear& zy, int64_t day, int which, bool& is_dst)
+{
+    is_dst = false;
+    if (!zy.has_dst)
+        return true;
+
+    auto start = zy.dst_start[which];
+    auto end = zy.dst_end[which];
+    if (day == start || day == end)
+        return false;
+    if (start < end)
+        is_dst = day > start && day < end;
+    else
+        is_dst = day > start || day < end;
+    return true;
+}
+
+static void
+fill_tm(int64_t local, bool is_dst, int64_t offset, struct tm& tm)
+{
+    auto days = floor_div(local, secs_per_day);
+    auto secs = local - days * secs_per_day;
+    int64_t year;
+    unsigned month, day;
+
+    civil_from_days(days, year, month, day);
+    memset(&tm, 0, sizeof(tm));
+    tm.tm_year = static_cast<int>(year - 1900);
+    tm.tm_mon = static_cast<int>(month - 1);
+    tm.tm_mday = static_cast<int>(day);
+    tm.tm_hour = static_cast<int>(secs / 3600);
+    tm.tm_min = static_cast<int>(secs % 3600 / 60);
+    tm.tm_sec = static_cast<int>(secs % 60);
+    tm.tm_wday = static_cast<int>(days - floor_div(days + 4, 7) * 7 + 4);
+    tm.tm_yday = static_cast<int>(days - days_from_civil(year, 1, 1));
+    tm.tm_isdst = is_dst ? 1 : 0;
+#if HAVE_STRUCT_TM_GMTOFF
+    tm.tm_gmtoff = offset;
+#endif
+}
+
+/* UTC to local time the way LDT_from_unix_local and to_tm do it: the
+ * zone is the one of the UTC year, DST is decided on the local
+ * standard-time date. */
+static bool
+fast_local_tm(time64 time, struct tm& tm)
+{
+    int64_t year, lyear;
+    unsigned month, day;
+    bool is_dst;
+
+    civil_from_days(floor_div(time, secs_per_day), year, month, day);
+    if (!fast_path_year(year))
+        return false;
+
+    auto& zy = zone_year(static_cast<int>(year));
+    auto std_days = floor_div(time + zy.base_offset, secs_per_day);
+    civil_from_days(std_days, lyear, month, day);
+    if (!day_is_dst(zy, std_days, static_cast<int>(lyear - year + 1), is_dst))
+        return false;
+
+    auto offset = zy.base_offset + (is_dst ? zy.dst_offset : 0);
+    fill_tm(time + offset, is_dst, offset, tm);
+    return true;
+}
+
+/* Local time to UTC the way LDT_from_struct_tm does it: the zone is
+ * the one of the local year. tm must be normalized. */
+static bool
+fast_local_time64(const struct tm& tm, time64& time)
+{
+    int64_t year = tm.tm_year + 1900, utc_year;
+    unsigned month, day;
+    bool is_dst;
+
+    if (!fast_path_year(year))
+        return false;
+
+    auto days = days_from_civil(year, tm.tm_mon + 1, tm.tm_mday);
+    auto& zy = zone_year(static_cast<int>(year));
+    if (!day_is_dst(zy, days, 1, is_dst))
+        return false;
+
+    time = days * secs_per_day + tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec
+        - zy.base_offset - (is_dst ? zy.dst_offset : 0);
+
+    /* Going back to a struct tm uses the zone of the UTC year */
+    civil_from_days(floor_div(time, secs_per_day), utc_year, month, day);
+    return utc_year == year;
+}
+
+/* The time64 of a part of a day the way LDT_from_date_daypart works
+ * it out, all in the zone of the date's year. */
+static bool
+fast_day_part_time64(int year, int month, int day, DayPart part, time64& time)
+{
+    static const unsigned char month_days[] =
+        {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool is_dst;
+
+    if (!fast_path_year(year) || month < 1 || month > 12 || day < 1 ||
+        day > month_days[month - 1])
+        return false;
+    if (month == 2 && day == 29 && !boost::gregorian::gregorian_calendar::is_leap_year(year))
+        return false;
+
+    auto days = days_from_civil(year, month, day);
+    auto& zy = zone_year(year);
+    if (part != DayPart::neutral)
+    {
+        if (!day_is_dst(zy, days, 1, is_dst))
+            return false;
+        time = days * secs_per_day - zy.base_offset - (is_dst ? zy.dst_offset : 0);
+        if (part == DayPart::end)
+            time += secs_per_day - 1;
+        return true;
+    }
+
+    /* 10:59 UTC, moved to keep the date for zones far from UTC */
+    time = days * secs_per_day + 10 * 3600 + 59 * 60;
+    auto std_days = floor_div(time + zy.base_offset, secs_per_day);
+    int64_t lyear;
+    unsigned lmonth, lday;
+    civil_from_days(std_days, lyear, lmonth, lday);
+    if (!day_is_dst(zy, std_days, static_cast<int>(lyear - year + 1), is_dst))
+        return false;
+
+    auto offset = zy.base_offset + (is_dst ? zy.dst_offset : 0);
+    if (offset < -10 * 3600)
+        time -= (offset / 3600 + 10) * 3600;
+    if (offset > 13 * 3600)
+        time += (13 - offset / 3600) * 3600;
+    return true;
 }
 
 class GncDateTimeImpl
@@ -571,7 +820,16 @@ GncDateImpl::GncDateImpl(const std::string str, const std::string fmt) :
     if (iter == GncDate::c_formats.cend())
         throw std::invalid_argument(N_("Unknown date format specifier passed as argument."));
 
-    boost::regex r(iter->m_re);
+    /* Compiling the regex costs far more than matching it, and importers
+     * parse whole columns of dates with the same format. */
+    static const std::vector<boost::regex> format_res = []()
+        {
+            std::vector<boost::regex> res;
+            for (const auto& format : GncDate::c_formats)
+                res.emplace_back (format.m_re);
+            return res;
+        }();
+    const auto& r = format_res[iter - GncDate::c_formats.cbegin()];
     boost::smatch what;
     if(!boost::regex_search(str, what, r))  // regex didn't find a match
         throw std::invalid_argument (N_("Value can't be parsed into a date using the selected date format."));
@@ -662,6 +920,35 @@ GncDateTime::operator struct tm() const
     return m_impl->operator struct tm();
 }
 
+struct tm
+GncDateTime::local_tm(const time64 time)
+{
+    struct tm tm;
+    if (fast_local_tm(time, tm))
+        return tm;
+    return static_cast<struct tm>(GncDateTime(time));
+}
+
+time64
+GncDateTime::from_local_tm(struct tm& tm)
+{
+    time64 time;
+    if (fast_local_time64(tm, time) && fast_local_tm(time, tm))
+        return time;
+    GncDateTime gncdt(tm);
+    tm = static_cast<struct tm>(gncdt);
+    return static_cast<time64>(gncdt);
+}
+
+time64
+GncDateTime::day_part_time64(int year, int month, int day, DayPart part)
+{
+    time64 time;
+    if (fast_day_part_time64(year, month, day, part, time))
+        return time;
+    return static_cast<time64>(GncDateTime(GncDate(year, month, day), part));
+}
+
 long
 GncDateTime::offset() const
 {
@@ -115,6 +115,33 @@ public:
 /** Cast the GncDateTime to a struct tm. Timezone field isn't filled.
  */
     explicit operator struct tm() const;
+/** Convert a time64 to a struct tm in the current timezone. The result
+ * is the same as casting GncDateTime(time) to a struct tm, but away
+ * from the days of DST transitions it is worked out from cached
+ * timezone offsets, which is much faster.
+ * @param time Seconds from the POSIX epoch.
+ * @exception std::invalid_argument if the year is outside the constraints.
+ */
+    static struct tm local_tm(const time64 time);
+/** Convert a normalized struct tm in the current timezone to a time64,
+ * filling in the rest of tm as casting GncDateTime(tm) back to a
+ * struct tm would. Like local_tm() this avoids boost::local_time
+ * away from DST transitions.
+ * @param tm A normalized struct tm; the timezone and offset are ignored.
+ * @exception std::invalid_argument if the year is outside the constraints.
+ */
+    static time64 from_local_tm(struct tm& tm);
+/** The time64 of GncDateTime(GncDate(year, month, day), part), worked
+ * out from cached timezone offsets away from DST transitions.
+ * @param year The year in the Common Era.
+ * @param month The month, where 1 is January and 12 is December.
+ * @param day The day of the month, beginning with 1.
+ * @param part The DayPart to convert, as in the GncDate constructor.
+ * @exception std::invalid_argument if the year is outside the constraints.
+ * Dates with an invalid month or day are handed to GncDate.
+ */
+    static time64 day_part_time64(int year, int month, int day,
+                                  DayPart part = DayPart::neutral);
 /** Obtain the UTC offset in seconds
  *  @return seconds difference between this local time and UTC. West
  *  is negative.
@@ -34,6 +34,13 @@ extern "C"
 #include <cstdio>
 #include <sstream>
 
+/* Compilers for 64-bit targets such as x86-64 and aarch64 provide a
+ * native 128-bit integer whose multiply and divide are much cheaper than
+ * the portable limb arithmetic below, which remains for everyone else. */
+#if defined(__SIZEOF_INT128__) && !defined(GNC_INT128_PORTABLE)
+#define GNC_INT128_NATIVE 1
+#endif
+
 /* All algorithms from Donald E. Knuth, "The Art of Computer
  * Programming, Volume 2: Seminumerical Algorithms", 3rd Ed.,
  * Addison-Wesley, 1998.
@@ -54,6 +61,14 @@ namespace {
         auto flag_part = static_cast<uint64_t>(flags) << upper_num_bits;
         return flag_part + (leg & nummask);
     }
+#ifdef GNC_INT128_NATIVE
+    /* The magnitude of a GncInt128 as a native integer; the flags in the
+     * upper leg must already have been stripped. */
+    static inline unsigned __int128 native_magnitude(uint64_t hi, uint64_t lo)
+    {
+        return (static_cast<unsigned __int128>(hi) << 64) | lo;
+    }
+#endif
     static inline uint8_t get_flags(uint64_t leg)
     {
         return (leg & flagmask) >> upper_num_bits;
@@ -526,6 +541,20 @@ GncInt128::operator*= (const GncInt128& b) noexcept
         return *this;
     }
 
+#ifdef GNC_INT128_NATIVE
+/* The checks above leave at most maxbits + 1 bits of product, well inside
+ * an unsigned __int128, so the compiler's 64x64->128 multiplies can do
+ * the work without risk of wrapping.
+ */
+    auto product = native_magnitude (hi, m_lo) * native_magnitude (bhi, b.m_lo);
+    m_lo = static_cast<uint64_t>(product);
+    hi = static_cast<uint64_t>(product >> legbits);
+    if (hi & flagmask)
+        flags |= overflow;
+    m_hi = set_flags(hi, flags);
+    return *this;
+#else
+
 /* This is Knuth's "classical" multi-precision multiplication algorithm
  * truncated to a GncInt128 result with the loop unrolled for clarity and with
  * overflow and zero checks beforehand to save time. See Donald Knuth, "The Art
@@ -587,6 +616,7 @@ GncInt128::operator*= (const GncInt128& b) noexcept
     }
     m_hi = set_flags(hi, flags);
     return *this;
+#endif
 }
 
 namespace {
@@ -793,6 +823,20 @@ GncInt128::div (const GncInt128& b, GncInt128& q, GncInt128& r) const noexcept
         return;
     }
 
+#ifdef GNC_INT128_NATIVE
+    {
+        auto dividend = native_magnitude (hi, m_lo);
+        auto divisor = native_magnitude (bhi, b.m_lo);
+        auto quotient = dividend / divisor;
+        auto remainder = dividend % divisor;
+        q.m_lo = static_cast<uint64_t>(quotient);
+        q.m_hi = set_flags(static_cast<uint64_t>(quotient >> legbits), qflags);
+        r.m_lo = static_cast<uint64_t>(remainder);
+        r.m_hi = set_flags(static_cast<uint64_t>(remainder >> legbits), rflags);
+        return;
+    }
+#endif
+
     uint64_t u[sublegs + 2] {(m_lo & sublegmask), (m_lo >> sublegbits),
             (hi & sublegmask), (hi >> sublegbits), 0, 0};
     uint64_t v[sublegs] {(b.m_lo & sublegmask), (b.m_lo >> sublegbits),
@@ -92,6 +92,11 @@ typedef struct GNCLotPrivate
     signed char is_closed;
 #define LOT_CLOSED_UNKNOWN (-1)
 
+    /* Sum of the split amounts, kept up to date as splits are added
+     * and removed. Only meaningful while balance_cached is set. */
+    gnc_numeric balance;
+    gboolean balance_cached;
+
     /* traversal marker, handy for preventing recursion */
     unsigned char marker;
 } GNCLotPrivate;
@@ -103,6 +108,17 @@ typedef struct GNCLotPrivate
 
 /* ============================================================= */
 
+/* Let the account put a lot that may have reopened back among its
+ * open lots. */
+static void
+gnc_lot_state_changed (GNCLot *lot, GNCLotPrivate *priv)
+{
+    if (priv->account && priv->is_closed != TRUE)
+        gnc_account_lot_changed (priv->account, lot);
+}
+
+/* ============================================================= */
+
 /* GObject Initialization */
 G_DEFINE_TYPE_WITH_PRIVATE(GNCLot, gnc_lot, QOF_TYPE_INSTANCE)
 
@@ -116,6 +132,8 @@ gnc_lot_init(GNCLot* lot)
     priv->splits = NULL;
     priv->cached_invoice = NULL;
     priv->is_closed = LOT_CLOSED_UNKNOWN;
+    priv->balance = gnc_numeric_zero ();
+    priv->balance_cached = FALSE;
     priv->marker = 0;
 }
 
@@ -186,6 +204,8 @@ gnc_lot_set_property (GObject* object,
     {
     case PROP_IS_CLOSED:
         priv->is_closed = g_value_get_int(value);
+        priv->balance_cached = FALSE;
+        gnc_lot_state_changed (lot, priv);
         break;
     case PROP_MARKER:
         priv->marker = g_value_get_int(value);
@@ -297,6 +317,7 @@ gnc_lot_free(GNCLot* lot)
 
     priv->account = NULL;
     priv->is_closed = TRUE;
+    priv->balance_cached = FALSE;
     /* qof_instance_release (&lot->inst); */
     g_object_unref (lot);
 
@@ -413,6 +434,8 @@ gnc_lot_set_closed_unknown(GNCLot* lot)
     {
         priv = GET_PRIVATE(lot);
         priv->is_closed = LOT_CLOSED_UNKNOWN;
+        priv->balance_cached = FALSE;
+        gnc_lot_state_changed (lot, priv);
     }
 }
 
@@ -488,6 +511,23 @@ gnc_lot_set_notes (GNCLot *lot, const char *str)
 
 /* ============================================================= */
 
+static void
+gnc_lot_cache_balance (GNCLotPrivate *priv, gnc_numeric baln)
+{
+    priv->balance = baln;
+    priv->balance_cached = TRUE;
+
+    /* cache a zero balance as a closed lot; an empty lot is open */
+    if (priv->splits && gnc_numeric_zero_p (baln))
+    {
+        priv->is_closed = TRUE;
+    }
+    else
+    {
+        priv->is_closed = FALSE;
+    }
+}
+
 gnc_numeric
 gnc_lot_get_balance (GNCLot *lot)
 {
@@ -498,11 +538,8 @@ gnc_lot_get_balance (GNCLot *lot)
     if (!lot) return zero;
 
     priv = GET_PRIVATE(lot);
-    if (!priv->splits)
-    {
-        priv->is_closed = FALSE;
-        return zero;
-    }
+    if (priv->balance_cached)
+        return priv->balance;
 
     /* Sum over splits; because they all belong to same account
      * they will have same denominator.
@@ -515,16 +552,7 @@ gnc_lot_get_balance (GNCLot *lot)
         g_assert (gnc_numeric_check (baln) == GNC_ERROR_OK);
     }
 
-    /* cache a zero balance as a closed lot */
-    if (gnc_numeric_equal (baln, zero))
-    {
-        priv->is_closed = TRUE;
-    }
-    else
-    {
-        priv->is_closed = FALSE;
-    }
-
+    gnc_lot_cache_balance (priv, baln);
     return baln;
 }
 
@@ -624,8 +652,14 @@ gnc_lot_add_split (GNCLot *lot, Split *split)
 
     priv->splits = g_list_append (priv->splits, split);
 
-    /* for recomputation of is-closed */
-    priv->is_closed = LOT_CLOSED_UNKNOWN;
+    /* keep the balance and is-closed up to date, or leave them for
+     * recomputation if they weren't known */
+    if (priv->balance_cached)
+        gnc_lot_cache_balance (priv, gnc_numeric_add_fixed
+                               (priv->balance, xaccSplitGetAmount (split)));
+    else
+        priv->is_closed = LOT_CLOSED_UNKNOWN;
+    gnc_lot_state_changed (lot, priv);
     gnc_lot_commit_edit(lot);
 
     qof_event_gen (QOF_INSTANCE(lot), QOF_EVENT_MODIFY, NULL);
@@ -644,7 +678,12 @@ gnc_lot_remove_split (GNCLot *lot, Split *split)
     qof_instance_set_dirty(QOF_INSTANCE(lot));
     priv->splits = g_list_remove (priv->splits, split);
     xaccSplitSetLot(split, NULL);
-    priv->is_closed = LOT_CLOSED_UNKNOWN;   /* force an is-closed computation */
+    if (priv->balance_cached)
+        gnc_lot_cache_balance (priv, gnc_numeric_sub_fixed
+                               (priv->balance, xaccSplitGetAmount (split)));
+    else
+        priv->is_closed = LOT_CLOSED_UNKNOWN;   /* force an is-closed computation */
+    gnc_lot_state_changed (lot, priv);
 
     if (NULL == priv->splits)
     {
@@ -24,6 +24,8 @@
 
 #include <glib.h>
 
+#include <algorithm>
+#include <charconv>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
@@ -113,6 +115,34 @@ GncNumeric::GncNumeric(double d) : m_num(0), m_den(1)
     m_den = r.denom();
 }
 
+/* Parse the "num/denom" form that gnc_numeric_to_string writes, which is
+ * what the backends store, without building any strings. Returns false
+ * for anything else so that the caller can fall back to the general
+ * parser. */
+static bool
+parse_rational_fast(const char* str, int64_t& num, int64_t& denom) noexcept
+{
+    auto end = str + strlen(str);
+    auto p = str;
+    while (p < end && (*p == ' ' || *p == '\t'))
+        ++p;
+    auto res = std::from_chars(p, end, num);
+    if (res.ec != std::errc{})
+        return false;
+    p = res.ptr;
+    while (p < end && (*p == ' ' || *p == '\t'))
+        ++p;
+    if (p == end || *p != '/')
+        return false;
+    ++p;
+    while (p < end && (*p == ' ' || *p == '\t'))
+        ++p;
+    if (p == end || *p == '-')
+        return false;
+    res = std::from_chars(p, end, denom);
+    return res.ec == std::errc{} && res.ptr == end;
+}
+
 using boost::regex;
 using boost::smatch;
 using boost::regex_search;
@@ -140,6 +170,14 @@ GncNumeric::GncNumeric(const std::string& str, bool autoround)
  */
     if (str.empty())
         throw std::invalid_argument("Can't construct a GncNumeric from an empty string.");
+    int64_t num, denom;
+    if (parse_rational_fast(str.c_str(), num, denom))
+    {
+        GncNumeric n(num, denom);
+        m_num = n.num();
+        m_den = n.denom();
+        return;
+    }
     if (regex_search(str, m, hex_rational))
     {
         GncNumeric n(stoll(m[1].str(), nullptr, 16),
@@ -484,6 +522,63 @@ operator/(GncNumeric a, GncNumeric b)
     return static_cast<GncNumeric>(rr);
 }
 
+/* Sum the numerators of count values that all have denominator den into
+ * total; returns false if any of them has another denominator.
+ *
+ * Each numerator is split into its signed upper and unsigned lower 32 bits
+ * and the halves are summed separately in 64 bits. Neither sum can overflow
+ * within a block of 2^30 values, so the inner loop needs no carries or
+ * overflow checks and can be vectorized; the halves are joined in 128 bits
+ * once per block.
+ */
+template <typename T, typename NumFn, typename DenFn> static bool
+sum_numerators(const T* values, size_t count, int64_t den,
+               NumFn num_of, DenFn den_of, GncInt128& total)
+{
+    constexpr size_t block_size = size_t{1} << 30;
+    const GncInt128 shift{INT64_C(1) << 32};
+    total = GncInt128{};
+    for (size_t start = 0; start < count; start += block_size)
+    {
+        auto end = std::min(count, start + block_size);
+        int64_t high = 0;
+        uint64_t low = 0;
+        bool same = true;
+        for (auto i = start; i < end; ++i)
+        {
+            auto num = num_of(values[i]);
+            high += num >> 32;
+            low += static_cast<uint64_t>(num) & UINT32_MAX;
+            same &= den_of(values[i]) == den;
+        }
+        if (!same)
+            return false;
+        total += GncInt128{high} * shift + GncInt128{low};
+    }
+    return true;
+}
+
+GncNumeric
+gnc_numeric_sum_array(const GncNumeric* values, size_t count)
+{
+    if (count == 0)
+        return GncNumeric{};
+    auto den = values[0].denom();
+    GncInt128 total;
+    if (sum_numerators(values, count, den,
+                       [](const GncNumeric& v) { return v.num(); },
+                       [](const GncNumeric& v) { return v.denom(); }, total))
+    {
+        if (total.isBig())
+            throw std::overflow_error("Sum of GncNumeric values exceeds 64 bits.");
+        return GncNumeric(static_cast<int64_t>(total), den);
+    }
+    auto sum = values[0];
+    for (size_t i = 1; i < count; ++i)
+        sum += values[i];
+    return sum;
+}
+
 template <typename T, typename I> T
 convert(T num, I new_denom, int how)
 {
@@ -744,6 +839,64 @@ denom_lcd(gnc_numeric a, gnc_numeric b, int64_t denom, int how)
     return denom;
 }
 
+/* Fast paths for add, sub and mul.
+ *
+ * For the operands the callers pass most often (same denominator for add
+ * and sub, an integer factor for mul), on a denominator setting whose
+ * conversion leaves the exact result alone, the answer is just 64-bit
+ * arithmetic on the numerators.  These helpers compute it when it can't
+ * overflow and return false otherwise, leaving the general code to
+ * produce the answer or the error.
+ */
+static inline bool
+fast_denom_ok (int64_t denom, int how, int64_t result_denom)
+{
+    auto dtype = how & GNC_NUMERIC_DENOM_MASK;
+    if (dtype != GNC_HOW_DENOM_LCD && dtype != GNC_HOW_DENOM_FIXED)
+        return false;
+    return denom == GNC_DENOM_AUTO || denom == result_denom;
+}
+
+static inline bool
+fast_add (gnc_numeric a, gnc_numeric b, int64_t denom, int how,
+          gnc_numeric *result)
+{
+    if (a.denom != b.denom || a.denom <= 0 ||
+        !fast_denom_ok (denom, how, a.denom))
+        return false;
+    if ((b.num > 0 && a.num > INT64_MAX - b.num) ||
+        (b.num < 0 && a.num <= INT64_MIN - b.num))
+        return false;
+    *result = gnc_numeric_create (a.num + b.num, a.denom);
+    return true;
+}
+
+static inline bool
+fast_mul (gnc_numeric a, gnc_numeric b, int64_t denom, int how,
+          gnc_numeric *result)
+{
+    if (a.denom <= 0 || b.denom <= 0 || (a.denom != 1 && b.denom != 1))
+        return false;
+    auto prod_denom = a.denom * b.denom;
+    if (!fast_denom_ok (denom, how, prod_denom))
+        return false;
+    if (a.num == 0 || b.num == 0)
+    {
+        /* GncNumeric's operator* answers 0/1, which a fixed automatic
+         * denominator keeps. */
+        auto zero_denom = (denom == GNC_DENOM_AUTO &&
+                           (how & GNC_NUMERIC_DENOM_MASK) == GNC_HOW_DENOM_FIXED) ?
+            1 : prod_denom;
+        *result = gnc_numeric_create (0, zero_denom);
+        return true;
+    }
+    if (a.num == INT64_MIN || b.num == INT64_MIN ||
+        std::llabs (a.num) > INT64_MAX / std::llabs (b.num))
+        return false;
+    *result = gnc_numeric_create (a.num * b.num, prod_denom);
+    return true;
+}
+
 /* *******************************************************************
  *  gnc_numeric_add
  ********************************************************************/
@@ -752,10 +905,13 @@ gnc_numeric
 gnc_numeric_add(gnc_numeric a, gnc_numeric b,
                 gint64 denom, gint how)
 {
+    gnc_numeric result;
     if (gnc_numeric_check(a) || gnc_numeric_check(b))
     {
         return gnc_numeric_error(GNC_ERROR_ARG);
     }
+    if (fast_add (a, b, denom, how, &result))
+        return result;
     denom = denom_lcd(a, b, denom, how);
     try
     {
@@ -805,11 +961,14 @@ gnc_numeric
 gnc_numeric_sub(gnc_numeric a, gnc_numeric b,
                 gint64 denom, gint how)
 {
-    gnc_numeric nb;
+    gnc_numeric result;
     if (gnc_numeric_check(a) || gnc_numeric_check(b))
     {
         return gnc_numeric_error(GNC_ERROR_ARG);
     }
+    if (b.num != INT64_MIN &&
+        fast_add (a, gnc_numeric_create (-b.num, b.denom), denom, how, &result))
+        return result;
     denom = denom_lcd(a, b, denom, how);
     try
     {
@@ -851,6 +1010,39 @@ gnc_numeric_sub(gnc_numeric a, gnc_numeric b,
     }
 }
 
+/* *******************************************************************
+ *  gnc_numeric_sum_array
+ ********************************************************************/
+
+gnc_numeric
+gnc_numeric_sum_array(const gnc_numeric *values, gsize n,
+                      gint64 denom, gint how)
+{
+    g_return_val_if_fail (values || n == 0, gnc_numeric_error(GNC_ERROR_ARG));
+    if (n == 0)
+        return denom > 0 ? gnc_numeric_create(0, denom) : gnc_numeric_zero();
+
+    auto den = values[0].denom;
+    GncInt128 total;
+    if (den > 0 && fast_denom_ok (denom, how, den) &&
+        sum_numerators(values, n, den,
+                       [](const gnc_numeric& v) { return v.num; },
+                       [](const gnc_numeric& v) { return v.denom; }, total))
+    {
+        if (total.isBig())
+            return gnc_numeric_error(GNC_ERROR_OVERFLOW);
+        return gnc_numeric_create(static_cast<int64_t>(total), den);
+    }
+
+    if (gnc_numeric_check(values[0]))
+        return gnc_numeric_error(GNC_ERROR_ARG);
+    auto sum = denom == GNC_DENOM_AUTO ? values[0] :
+        gnc_numeric_convert(values[0], denom, how);
+    for (gsize i = 1; i < n && !gnc_numeric_check(sum); ++i)
+        sum = gnc_numeric_add(sum, values[i], denom, how);
+    return sum;
+}
+
 /* *******************************************************************
  *  gnc_numeric_mul
  ********************************************************************/
@@ -859,10 +1051,13 @@ gnc_numeric
 gnc_numeric_mul(gnc_numeric a, gnc_numeric b,
                 gint64 denom, gint how)
 {
+    gnc_numeric result;
     if (gnc_numeric_check(a) || gnc_numeric_check(b))
     {
         return gnc_numeric_error(GNC_ERROR_ARG);
     }
+    if (fast_mul (a, b, denom, how, &result))
+        return result;
     denom = denom_lcd(a, b, denom, how);
     try
     {
@@ -1197,15 +1392,22 @@ gnc_numeric_error(GNCNumericErrorCode error_code)
  ********************************************************************/
 
 gchar *
-gnc_numeric_to_string(gnc_numeric n)
+gnc_numeric_to_string_buff(gnc_numeric n, gchar *buff)
 {
-    gchar *result;
-    gint64 tmpnum = n.num;
-    gint64 tmpdenom = n.denom;
-
-    result = g_strdup_printf("%" G_GINT64_FORMAT "/%" G_GINT64_FORMAT, tmpnum, tmpdenom);
+    auto end = buff + GNC_NUMERIC_STRING_LENGTH;
+    auto res = std::to_chars(buff, end, n.num);
+    *res.ptr++ = '/';
+    res = std::to_chars(res.ptr, end, n.denom);
+    *res.ptr = '\0';
+    return res.ptr;
+}
 
-    return result;
+gchar *
+gnc_numeric_to_string(gnc_numeric n)
+{
+    gchar buff[GNC_NUMERIC_STRING_LENGTH + 1];
+    gnc_numeric_to_string_buff(n, buff);
+    return g_strdup(buff);
 }
 
 gchar *
@@ -1227,6 +1429,12 @@ gnc_num_dbg_to_string(gnc_numeric n)
 gboolean
 string_to_gnc_numeric(const gchar* str, gnc_numeric *n)
 {
+    int64_t num, denom;
+    if (str && parse_rational_fast(str, num, denom) && denom != 0)
+    {
+        *n = gnc_numeric_create(num, denom);
+        return TRUE;
+    }
     try
     {
         GncNumeric an(str);
@@ -332,6 +332,18 @@ gdouble      gnc_numeric_to_double(gnc_numeric n);
  *  caller (it was allocated through g_strdup) */
 gchar *gnc_numeric_to_string(gnc_numeric n);
 
+/** The longest string gnc_numeric_to_string can produce, not counting
+ *  the terminating null: two 20-character gint64s and the slash. */
+#define GNC_NUMERIC_STRING_LENGTH 41
+
+/** Convert to string in the same form as gnc_numeric_to_string, writing
+ *  into buff, which must hold at least GNC_NUMERIC_STRING_LENGTH + 1
+ *  characters. Handy for avoiding a malloc/free cycle.
+ *
+ *  @return A pointer to the terminating null character of the string.
+ */
+gchar *gnc_numeric_to_string_buff(gnc_numeric n, gchar *buff);
+
 /** Convert to string. Uses a static, non-thread-safe buffer.
  *  For internal use only. */
 gchar * gnc_num_dbg_to_string(gnc_numeric n);
@@ -444,6 +456,23 @@ gnc_numeric gnc_numeric_sub_fixed(gnc_numeric a, gnc_numeric b)
     return gnc_numeric_sub(a, b, GNC_DENOM_AUTO,
                            GNC_HOW_DENOM_FIXED | GNC_HOW_RND_NEVER);
 }
+
+/** Return the sum of the n values in the array, as if they had been
+ *  added in order with gnc_numeric_add(sum, value, denom, how).
+ *
+ *  When all the values share one positive denominator and denom and how
+ *  would keep it (GNC_DENOM_AUTO or that denominator, with
+ *  GNC_HOW_DENOM_LCD or GNC_HOW_DENOM_FIXED) the numerators are summed
+ *  in 128 bits and the overflow check is made once on the total, so the
+ *  result is exact whenever the total fits. Other inputs are added one
+ *  at a time.
+ *
+ *  @param values The array to sum; may be NULL if n is 0.
+ *  @param n The number of values in the array.
+ *  @return The sum, zero for an empty array, or an error value.
+ */
+gnc_numeric gnc_numeric_sum_array(const gnc_numeric *values, gsize n,
+                                  gint64 denom, gint how);
 /** @} */
 
 
@@ -333,6 +333,19 @@ inline GncNumeric operator/(int64_t a, GncNumeric b)
     return b / GncNumeric(a, 1);
 }
 /** @} */
+/**
+ * Sum count values.
+ *
+ * If the values all have the same denominator the numerators are added in
+ * 128 bits and the result has that denominator; otherwise this is the same
+ * as adding them with operator+ in order.
+ *
+ * \param values Pointer to the first value; may be nullptr if count is 0.
+ * \param count The number of values.
+ * \return The sum, or 0 for no values.
+ * \throws std::overflow_error if the total doesn't fit in a GncNumeric.
+ */
+GncNumeric gnc_numeric_sum_array(const GncNumeric* values, size_t count);
 /**
  * std::stream output operator. Uses standard integer operator<< so should obey
  * locale rules. Numbers are presented as integers if the denominator is 1, as a
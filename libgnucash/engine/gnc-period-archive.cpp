@@ -0,0 +1,449 @@
+/********************************************************************
+ * gnc-period-archive.cpp -- move closed periods to an archive book *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ ********************************************************************/
+
+extern "C"
+{
+#include <config.h>
+#include <glib/gi18n.h>
+#include "gnc-period-archive.h"
+#include "gnc-book-snapshot.h"
+#include "AccountP.h"
+#include "Split.h"
+#include "Transaction.h"
+#include "gnc-engine.h"
+#include "gnc-event.h"
+#include "gnc-lot.h"
+#include "gnc-pricedb.h"
+#include "gncInvoice.h"
+#include "gncOwner.h"
+#include "qofinstance-p.h"
+}
+
+#include <map>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "kvp-frame.hpp"
+
+static QofLogModule log_module = GNC_MOD_ENGINE;
+
+static const char *KEY_ARCHIVE = "period-archive";
+static const char *KEY_URI = "uri";
+static const char *KEY_CUTOFF = "cutoff";
+
+using TransSet = std::unordered_set<Transaction*>;
+using LotSet = std::unordered_set<GNCLot*>;
+
+/* ================================================================ */
+/* Choosing what to archive */
+
+static gint
+collect_trans (Split *split, gpointer data)
+{
+    static_cast<TransSet*>(data)->insert (xaccSplitGetParent (split));
+    return 0;
+}
+
+/* The lots of business documents and payments stay with the
+ * documents, which aren't archived. */
+static gboolean
+lot_can_be_archived (GNCLot *lot, time64 cutoff)
+{
+    GncOwner owner;
+
+    if (!gnc_lot_is_closed (lot) || gncInvoiceGetInvoiceFromLot (lot) ||
+        gncOwnerGetOwnerFromLot (lot, &owner))
+        return FALSE;
+    for (auto node = gnc_lot_get_split_list (lot); node; node = node->next)
+    {
+        auto trans = xaccSplitGetParent (static_cast<Split*>(node->data));
+        if (!trans || xaccTransGetDate (trans) > cutoff)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+static gboolean
+trans_can_be_archived (Transaction *trans, time64 cutoff, LotSet& lots)
+{
+    if (xaccTransIsOpen (trans) || xaccTransGetTxnType (trans) != TXN_TYPE_NONE)
+        return FALSE;
+
+    for (auto node = xaccTransGetSplitList (trans); node; node = node->next)
+    {
+        auto split = static_cast<Split*>(node->data);
+        auto lot = xaccSplitGetLot (split);
+
+        if (!xaccSplitGetAccount (split))
+            return FALSE;
+        if (!lot)
+            continue;
+        if (!lots.count (lot))
+        {
+            if (!lot_can_be_archived (lot, cutoff))
+                return FALSE;
+            lots.insert (lot);
+        }
+    }
+    return TRUE;
+}
+
+/* A lot is archived whole or not at all, so a lot with a split whose
+ * transaction stays keeps all its transactions, which may in turn
+ * keep other lots; repeat until nothing changes. */
+static void
+archive_select (QofBook *book, time64 cutoff, TransSet& trans, LotSet& lots)
+{
+    TransSet candidates;
+    auto accounts = gnc_account_get_descendants (gnc_book_get_root_account (book));
+    for (auto node = accounts; node; node = node->next)
+        xaccAccountForEachSplitInRange (static_cast<Account*>(node->data),
+                                        G_MININT64, cutoff, collect_trans,
+                                        &candidates);
+    g_list_free (accounts);
+
+    for (auto t : candidates)
+        if (trans_can_be_archived (t, cutoff, lots))
+            trans.insert (t);
+
+    bool changed;
+    do
+    {
+        changed = false;
+        for (auto it = lots.begin(); it != lots.end();)
+        {
+            auto splits = gnc_lot_get_split_list (*it);
+            auto whole = true;
+            for (auto node = splits; node && whole; node = node->next)
+                whole = trans.count (xaccSplitGetParent (static_cast<Split*>(node->data)));
+            if (whole)
+            {
+                ++it;
+                continue;
+            }
+            for (auto node = splits; node; node = node->next)
+                trans.erase (xaccSplitGetParent (static_cast<Split*>(node->data)));
+            it = lots.erase (it);
+            changed = true;
+        }
+    }
+    while (changed);
+}
+
+using PriceKey = std::pair<const gnc_commodity*, const gnc_commodity*>;
+
+struct PriceSelect
+{
+    time64 cutoff;
+    std::map<PriceKey, GNCPrice*> latest;
+    std::vector<GNCPrice*> prices;
+};
+
+static gboolean
+select_price (GNCPrice *price, gpointer data)
+{
+    auto select = static_cast<PriceSelect*>(data);
+    auto time = gnc_price_get_time64 (price);
+
+    if (time > select->cutoff)
+        return TRUE;
+
+    PriceKey key {gnc_price_get_commodity (price), gnc_price_get_currency (price)};
+    auto it = select->latest.find (key);
+    if (it == select->latest.end())
+        select->latest.emplace (key, price);
+    else if (time > gnc_price_get_time64 (it->second))
+    {
+        select->prices.push_back (it->second);
+        it->second = price;
+    }
+    else
+        select->prices.push_back (price);
+    return TRUE;
+}
+
+QofBook *
+gnc_period_archive_new (QofBook *book, time64 cutoff)
+{
+    TransSet trans;
+    LotSet lots;
+    PriceSelect prices;
+
+    g_return_val_if_fail (QOF_IS_BOOK (book), NULL);
+    ENTER ("book=%p cutoff=%" G_GINT64_FORMAT, book, cutoff);
+
+    archive_select (book, cutoff, trans, lots);
+    prices.cutoff = cutoff;
+    gnc_pricedb_foreach_price (gnc_pricedb_get_db (book), select_price,
+                               &prices, FALSE);
+    if (trans.empty() && prices.prices.empty())
+    {
+        LEAVE ("nothing to archive");
+        return NULL;
+    }
+
+    std::vector<Transaction*> archived (trans.begin(), trans.end());
+    auto archive = gnc_book_snapshot_copy (book, archived, prices.prices);
+
+    LEAVE ("%zu transactions, %zu lots, %zu prices", trans.size(), lots.size(),
+           prices.prices.size());
+    return archive;
+}
+
+/* ================================================================ */
+/* Shrinking the working book */
+
+/* The currency, account and reconcile state of an opening split. */
+using BalanceKey = std::tuple<gnc_commodity*, Account*, char>;
+
+struct OpeningBalance
+{
+    gnc_numeric amount = gnc_numeric_zero ();
+    gnc_numeric value = gnc_numeric_zero ();
+    time64 date_reconciled = 0;
+};
+
+static void
+collect_trans_inst (QofInstance *inst, gpointer data)
+{
+    static_cast<std::vector<Transaction*>*>(data)->push_back (GNC_TRANSACTION (inst));
+}
+
+static void
+collect_inst (QofInstance *inst, gpointer data)
+{
+    static_cast<std::vector<QofInstance*>*>(data)->push_back (inst);
+}
+
+static gboolean
+account_is_income_expense (const Account *acc)
+{
+    auto type = xaccAccountGetType (acc);
+    return type == ACCT_TYPE_INCOME || type == ACCT_TYPE_EXPENSE;
+}
+
+/* Every archived transaction balances in its currency, so each
+ * currency's splits, summed account by account, make a balanced
+ * transaction too: that is the opening entry.  Each account's splits
+ * are summed by reconcile state, so that its reconciled and cleared
+ * balances carry forward.  The income and expense sums go to the
+ * equity account for the currency instead, if there is one, as
+ * unreconciled amounts. */
+static std::map<BalanceKey, OpeningBalance>
+archive_balances (QofBook *book, const std::vector<Transaction*>& archived,
+                  GncPeriodArchiveEquityFunc equity, gpointer user_data)
+{
+    std::map<BalanceKey, OpeningBalance> balances;
+    std::map<gnc_commodity*, Account*> equity_accounts;
+
+    for (auto trans : archived)
+    {
+        auto currency = gnc_commodity_obtain_twin (xaccTransGetCurrency (trans), book);
+        for (auto node = xaccTransGetSplitList (trans); node; node = node->next)
+        {
+            auto split = static_cast<Split*>(node->data);
+            auto acc = xaccAccountLookup (qof_instance_get_guid (xaccSplitGetAccount (split)),
+                                          book);
+            auto amount = xaccSplitGetAmount (split);
+            auto value = xaccSplitGetValue (split);
+            auto state = xaccSplitGetReconcile (split);
+
+            if (!acc)
+                continue;
+            if (equity && account_is_income_expense (acc))
+            {
+                auto it = equity_accounts.find (currency);
+                if (it == equity_accounts.end())
+                    it = equity_accounts.emplace (currency, equity (currency, user_data)).first;
+                if (it->second &&
+                    gnc_commodity_equiv (xaccAccountGetCommodity (it->second), currency))
+                {
+                    acc = it->second;
+                    amount = value;
+                    state = NREC;
+                }
+            }
+
+            auto& balance = balances[{currency, acc, state}];
+            balance.amount = gnc_numeric_add (balance.amount, amount,
+                                              GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
+            balance.value = gnc_numeric_add (balance.value, value,
+                                             GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
+            balance.date_reconciled = MAX (balance.date_reconciled,
+                                           xaccSplitGetDateReconciled (split));
+        }
+    }
+    return balances;
+}
+
+static void
+archive_add_opening (QofBook *book, time64 cutoff,
+                     const std::map<BalanceKey, OpeningBalance>& balances)
+{
+    Transaction *trans = NULL;
+    gnc_commodity *currency = NULL;
+
+    /* The map is ordered by currency first, so each currency's splits
+     * come together. */
+    for (const auto& entry : balances)
+    {
+        auto acc = std::get<1>(entry.first);
+        auto state = std::get<2>(entry.first);
+        const auto& balance = entry.second;
+
+        if (gnc_numeric_zero_p (balance.amount) && gnc_numeric_zero_p (balance.value))
+            continue;
+        if (std::get<0>(entry.first) != currency)
+        {
+            if (trans)
+                xaccTransCommitEdit (trans);
+            currency = std::get<0>(entry.first);
+            trans = xaccMallocTransaction (book);
+            xaccTransBeginEdit (trans);
+            xaccTransSetCurrency (trans, currency);
+            xaccTransSetDatePostedSecsNormalized (trans, cutoff);
+            xaccTransSetDateEnteredSecs (trans, gnc_time (NULL));
+            xaccTransSetDescription (trans, _("Opening Balance"));
+        }
+
+        auto split = xaccMallocSplit (book);
+        xaccTransAppendSplit (trans, split);
+        xaccAccountInsertSplit (acc, split);
+        xaccSplitSetAmount (split, balance.amount);
+        xaccSplitSetValue (split, balance.value);
+        if (state != NREC)
+        {
+            xaccSplitSetReconcile (split, state);
+            xaccSplitSetDateReconciledSecs (split, balance.date_reconciled);
+        }
+    }
+    if (trans)
+        xaccTransCommitEdit (trans);
+}
+
+/* The archive was made from a copy of the book's KVP, so it holds the
+ * link to the archive before it and the archives form a chain. */
+static void
+archive_set_link (QofBook *book, const char *uri, time64 cutoff)
+{
+    auto frame = qof_instance_get_slots (QOF_INSTANCE (book));
+
+    qof_book_begin_edit (book);
+    delete frame->set_path ({KEY_ARCHIVE, KEY_URI}, new KvpValue (g_strdup (uri)));
+    delete frame->set_path ({KEY_ARCHIVE, KEY_CUTOFF}, new KvpValue (Time64 {cutoff}));
+    qof_instance_set_dirty (QOF_INSTANCE (book));
+    qof_book_commit_edit (book);
+}
+
+gboolean
+gnc_period_archive_commit (QofBook *book, QofBook *archive, time64 cutoff,
+                           const char *uri, GncPeriodArchiveEquityFunc equity,
+                           gpointer user_data)
+{
+    std::vector<Transaction*> archived;
+    std::vector<QofInstance*> lots, prices;
+
+    g_return_val_if_fail (QOF_IS_BOOK (book), FALSE);
+    g_return_val_if_fail (QOF_IS_BOOK (archive), FALSE);
+    g_return_val_if_fail (uri, FALSE);
+    ENTER ("book=%p archive=%p uri=%s", book, archive, uri);
+
+    qof_collection_foreach (qof_book_get_collection (archive, GNC_ID_TRANS),
+                            collect_trans_inst, &archived);
+    /* A transaction being edited can't be destroyed under its editor. */
+    for (auto copy : archived)
+    {
+        auto trans = xaccTransLookup (qof_instance_get_guid (copy), book);
+        if (trans && xaccTransIsOpen (trans))
+        {
+            LEAVE ("transaction %p is open", trans);
+            return FALSE;
+        }
+    }
+    qof_collection_foreach (qof_book_get_collection (archive, GNC_ID_LOT),
+                            collect_inst, &lots);
+    qof_collection_foreach (qof_book_get_collection (archive, GNC_ID_PRICE),
+                            collect_inst, &prices);
+    auto balances = archive_balances (book, archived, equity, user_data);
+
+    /* The events aren't suspended: registers and the account tree must
+     * hear of every split destroyed.  The caller suspends the GUI
+     * refresh instead. */
+    auto accounts = gnc_account_get_descendants (gnc_book_get_root_account (book));
+    for (auto node = accounts; node; node = node->next)
+        xaccAccountBeginEdit (static_cast<Account*>(node->data));
+
+    for (auto copy : archived)
+    {
+        auto trans = xaccTransLookup (qof_instance_get_guid (copy), book);
+        if (!trans)
+            continue;
+        xaccTransBeginEdit (trans);
+        xaccTransDestroy (trans);
+        xaccTransCommitEdit (trans);
+    }
+    for (auto copy : lots)
+    {
+        auto lot = gnc_lot_lookup (qof_instance_get_guid (copy), book);
+        if (lot && !gnc_lot_get_split_list (lot))
+            gnc_lot_destroy (lot);
+    }
+    auto price_col = qof_book_get_collection (book, GNC_ID_PRICE);
+    for (auto copy : prices)
+    {
+        auto price = qof_collection_lookup_entity (price_col,
+                                                   qof_instance_get_guid (copy));
+        if (price)
+            gnc_pricedb_remove_price (gnc_pricedb_get_db (book), GNC_PRICE (price));
+    }
+
+    archive_add_opening (book, cutoff, balances);
+
+    for (auto node = accounts; node; node = node->next)
+        xaccAccountCommitEdit (static_cast<Account*>(node->data));
+    g_list_free (accounts);
+
+    archive_set_link (book, uri, cutoff);
+    LEAVE ("removed %zu transactions, %zu lots, %zu prices", archived.size(),
+           lots.size(), prices.size());
+    return TRUE;
+}
+
+const char *
+gnc_period_archive_get_uri (QofBook *book)
+{
+    g_return_val_if_fail (QOF_IS_BOOK (book), NULL);
+
+    auto slot = qof_instance_get_slots (QOF_INSTANCE (book))->get_slot ({KEY_ARCHIVE, KEY_URI});
+    return slot ? slot->get<const char*>() : NULL;
+}
+
+time64
+gnc_period_archive_get_cutoff (QofBook *book)
+{
+    g_return_val_if_fail (QOF_IS_BOOK (book), G_MININT64);
+
+    auto slot = qof_instance_get_slots (QOF_INSTANCE (book))->get_slot ({KEY_ARCHIVE, KEY_CUTOFF});
+    return slot ? slot->get<Time64>().t : G_MININT64;
+}
@@ -0,0 +1,110 @@
+/********************************************************************
+ * gnc-period-archive.h -- move closed periods to an archive book   *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ ********************************************************************/
+
+/** @addtogroup Engine
+ *     @{ */
+
+/** @addtogroup PeriodArchive Period Archive
+ *  Moving the transactions, lots and prices of closed periods out of
+ *  the working book into an archive book of their own, so that the
+ *  working book only holds the recent years.
+ *
+ *  Archiving is done in two steps.  gnc_period_archive_new() copies
+ *  what can be archived into a new book, keeping the GUIDs, and
+ *  leaves the working book alone.  Once the caller has saved that
+ *  book, gnc_period_archive_commit() removes the archived objects
+ *  from the working book, puts opening entries dated at the cutoff
+ *  in their place and records where the archive was saved, so that
+ *  reports can open it read-only for the older periods.
+ *
+ *  A transaction is archived if it was posted on or before the
+ *  cutoff, isn't a business transaction and all the lots it has
+ *  splits in are closed and are archived whole.  Prices on or before
+ *  the cutoff are archived except the latest one of each commodity
+ *  and currency, which stays to value the opening balances.
+ *     @{ */
+
+/** @file gnc-period-archive.h
+ *  @brief Move closed periods to an archive book
+ */
+
+#ifndef GNC_PERIOD_ARCHIVE_H
+#define GNC_PERIOD_ARCHIVE_H
+
+#include "qof.h"
+#include "Account.h"
+#include "gnc-commodity.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Returns the equity account that takes the balances of the income
+ *  and expense accounts in currency, or NULL to carry them forward in
+ *  their own accounts. */
+typedef Account * (*GncPeriodArchiveEquityFunc) (gnc_commodity *currency,
+                                                 gpointer user_data);
+
+/** Copy everything in book that can be archived at cutoff into a new
+ *  book, with its account tree, commodities and options.  book isn't
+ *  changed.  Returns NULL if there is nothing to archive; otherwise
+ *  the caller owns the new book. */
+QofBook *gnc_period_archive_new (QofBook *book, time64 cutoff);
+
+/** Remove from book the transactions, lots and prices held by
+ *  archive and carry their balances forward in one opening
+ *  transaction per currency, posted at cutoff.  Each account's
+ *  reconciled and cleared amounts get splits of their own in that
+ *  state.  Call this only after archive has been saved at uri, which
+ *  is recorded in book.  Every removal raises its events, so callers
+ *  with a GUI should suspend its refresh around the call.
+ *
+ *  @param book the working book
+ *  @param archive the book gnc_period_archive_new() returned for it
+ *  @param cutoff the cutoff archive was made for
+ *  @param uri where archive was saved
+ *  @param equity gives the account closing the income and expense
+ *         accounts, or NULL to carry those forward as well
+ *  @param user_data handed to equity
+ *  @return FALSE, changing nothing, if one of the transactions is
+ *          open for editing
+ */
+gboolean gnc_period_archive_commit (QofBook *book, QofBook *archive,
+                                    time64 cutoff, const char *uri,
+                                    GncPeriodArchiveEquityFunc equity,
+                                    gpointer user_data);
+
+/** The uri of the archive book was last archived to, or NULL. */
+const char *gnc_period_archive_get_uri (QofBook *book);
+
+/** The cutoff of the archive book was last archived to, or
+ *  INT64_MIN if it never was. */
+time64 gnc_period_archive_get_cutoff (QofBook *book);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNC_PERIOD_ARCHIVE_H */
+/** @} */
+/** @} */
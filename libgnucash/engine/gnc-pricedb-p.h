@@ -56,6 +56,21 @@ struct gnc_price_db_s
 {
     QofInstance inst;              /* globally unique object identifier */
     GHashTable *commodity_hash;
+    /* commodity -> currency -> GPtrArray copy of that price list, built
+     * on demand for the binary-searched lookups. */
+    GHashTable *series_hash;
+    /* PriceConversionKey -> gnc_numeric rate memoized by
+     * get_nearest_price. */
+    GHashTable *conversion_cache;
+    /* commodity -> currency -> PackedPriceSeries for the series that
+     * gnc_pricedb_compact has packed; such a series has no price list in
+     * commodity_hash until something needs its GNCPrices. */
+    GHashTable *packed_hash;
+    /* The type strings (from the string cache) that packed rows index. */
+    GPtrArray *packed_types;
+    /* Guards series_hash and conversion_cache, the only state that the
+     * lookups change, so that several threads can look prices up at once. */
+    GMutex cache_lock;
     gboolean bulk_update;		 /* TRUE while reading XML file, etc. */
     gboolean reset_nth_price_cache;
 };
@@ -96,4 +111,8 @@ gboolean gnc_pricedb_register (void);
 
 QofBackend * xaccPriceDBGetBackend (GNCPriceDB *prdb);
 
+/** Return a counter that changes whenever any price is added, removed
+ *  or modified, for callers caching values converted at those prices. */
+guint64 gnc_pricedb_get_generation (void);
+
 #endif
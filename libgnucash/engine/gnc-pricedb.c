@@ -40,6 +40,25 @@ static gboolean remove_price(GNCPriceDB *db, GNCPrice *p, gboolean cleanup);
 static GNCPrice *lookup_nearest_in_time(GNCPriceDB *db, const gnc_commodity *c,
                                         const gnc_commodity *currency,
                                         time64 t, gboolean sameday);
+static PriceList *pricedb_price_list_merge (PriceList *a, PriceList *b);
+static void pricedb_forget_conversions (GNCPriceDB *db,
+                                        const gnc_commodity *commodity,
+                                        const gnc_commodity *currency);
+static void pricedb_unpack_series (GNCPriceDB *db,
+                                   const gnc_commodity *commodity,
+                                   const gnc_commodity *currency);
+static void pricedb_unpack_commodity (GNCPriceDB *db,
+                                      const gnc_commodity *commodity);
+static void pricedb_unpack_all (GNCPriceDB *db);
+static void pricedb_unpack_guid (GNCPriceDB *db, const GncGUID *guid);
+static guint pricedb_packed_count (GNCPriceDB *db,
+                                   const gnc_commodity *commodity,
+                                   const gnc_commodity *currency);
+
+/* Bumped whenever a price is added, removed or changed, so that values
+ * cached from price conversions can tell when they have gone stale. */
+static guint64 price_generation = 0;
+
 static gboolean
 pricedb_pricelist_traversal(GNCPriceDB *db,
                             gboolean (*f)(GList *p, gpointer user_data),
@@ -323,6 +342,7 @@ static void
 gnc_price_destroy (GNCPrice *p)
 {
     ENTER("destroy price %p", p);
+    price_generation++;
     qof_event_gen (&p->inst, QOF_EVENT_DESTROY, NULL);
 
     if (p->type) CACHE_REMOVE(p->type);
@@ -336,21 +356,20 @@ void
 gnc_price_ref(GNCPrice *p)
 {
     if (!p) return;
-    p->refcount++;
+    /* Atomic, because concurrent lookups hand out references. */
+    g_atomic_int_inc ((gint*)&p->refcount);
 }
 
 void
 gnc_price_unref(GNCPrice *p)
 {
     if (!p) return;
-    if (p->refcount == 0)
+    if (g_atomic_int_get ((gint*)&p->refcount) == 0)
     {
         return;
     }
 
-    p->refcount--;
-
-    if (p->refcount <= 0)
+    if (g_atomic_int_dec_and_test ((gint*)&p->refcount))
     {
         if (NULL != p->db)
         {
@@ -458,9 +477,18 @@ gnc_pricedb_commit_edit (GNCPriceDB *pdb)
 /* ==================================================================== */
 /* setters */
 
+guint64
+gnc_pricedb_get_generation (void)
+{
+    return price_generation;
+}
+
 static void
 gnc_price_set_dirty (GNCPrice *p)
 {
+    price_generation++;
+    if (p->db)
+        pricedb_forget_conversions (p->db, p->commodity, p->currency);
     qof_instance_set_dirty(&p->inst);
     qof_event_gen(&p->inst, QOF_EVENT_MODIFY, NULL);
 }
@@ -589,10 +617,22 @@ GNCPrice *
 gnc_price_lookup (const GncGUID *guid, QofBook *book)
 {
     QofCollection *col;
+    GNCPrice *price;
 
     if (!guid || !book) return NULL;
     col = qof_book_get_collection (book, GNC_ID_PRICE);
-    return (GNCPrice *) qof_collection_lookup_entity (col, guid);
+    price = (GNCPrice *) qof_collection_lookup_entity (col, guid);
+    if (!price)
+    {
+        /* It may be in a series that gnc_pricedb_compact packed. */
+        GNCPriceDB *db = gnc_pricedb_get_db (book);
+        if (db && db->packed_hash && g_hash_table_size (db->packed_hash))
+        {
+            pricedb_unpack_guid (db, guid);
+            price = (GNCPrice *) qof_collection_lookup_entity (col, guid);
+        }
+    }
+    return price;
 }
 
 gnc_commodity *
@@ -840,7 +880,9 @@ QOF_GOBJECT_IMPL(gnc_pricedb, GNCPriceDB, QOF_TYPE_INSTANCE);
 static void
 gnc_pricedb_init(GNCPriceDB* pdb)
 {
-    pdb->reset_nth_price_cache = FALSE;
+    /* The nth price cache may hold the series of another pricedb. */
+    pdb->reset_nth_price_cache = TRUE;
+    g_mutex_init (&pdb->cache_lock);
 }
 
 static void
@@ -851,6 +893,104 @@ gnc_pricedb_dispose_real (GObject *pdbp)
 static void
 gnc_pricedb_finalize_real(GObject* pdbp)
 {
+    GNCPriceDB *pdb = GNC_PRICEDB (pdbp);
+    g_mutex_clear (&pdb->cache_lock);
+}
+
+/* Conversion cache.
+ *
+ * get_nearest_price memoizes the rates it finds, direct or through a
+ * common third commodity, by the arguments it was called with.  Either
+ * way the rate depends only on prices that have from or to as their
+ * commodity or currency, so a change to a price need only drop the
+ * entries that involve one of its two commodities.
+ */
+#define PRICE_CONVERSION_CACHE_MAX 10000
+
+typedef struct
+{
+    const gnc_commodity *from;
+    const gnc_commodity *to;
+    time64 t;
+    gboolean before;
+} PriceConversionKey;
+
+static guint
+conversion_key_hash (gconstpointer key)
+{
+    const PriceConversionKey *k = key;
+    return g_direct_hash (k->from) ^ (g_direct_hash (k->to) * 31) ^
+        g_int64_hash (&k->t) ^ (k->before ? 0x9e3779b9 : 0);
+}
+
+static gboolean
+conversion_key_equal (gconstpointer a, gconstpointer b)
+{
+    const PriceConversionKey *ka = a, *kb = b;
+    return ka->from == kb->from && ka->to == kb->to && ka->t == kb->t &&
+        !ka->before == !kb->before;
+}
+
+static gboolean
+conversion_key_uses (gpointer key, gpointer value, gpointer user_data)
+{
+    const PriceConversionKey *k = key;
+    const gnc_commodity **pair = user_data;
+    return k->from == pair[0] || k->from == pair[1] ||
+        k->to == pair[0] || k->to == pair[1];
+}
+
+static void
+pricedb_forget_conversions (GNCPriceDB *db, const gnc_commodity *commodity,
+                            const gnc_commodity *currency)
+{
+    const gnc_commodity *pair[2] = {commodity, currency};
+    if (!db->conversion_cache || !g_hash_table_size (db->conversion_cache))
+        return;
+    g_mutex_lock (&db->cache_lock);
+    g_hash_table_foreach_remove (db->conversion_cache, conversion_key_uses,
+                                 pair);
+    g_mutex_unlock (&db->cache_lock);
+}
+
+static gboolean
+pricedb_lookup_conversion (GNCPriceDB *db, const gnc_commodity *from,
+                           const gnc_commodity *to, time64 t,
+                           gboolean before, gnc_numeric *rate)
+{
+    PriceConversionKey key = {from, to, t, before};
+    gnc_numeric *cached;
+
+    if (!db || !db->conversion_cache) return FALSE;
+    g_mutex_lock (&db->cache_lock);
+    cached = g_hash_table_lookup (db->conversion_cache, &key);
+    if (cached)
+        *rate = *cached;
+    g_mutex_unlock (&db->cache_lock);
+    return cached != NULL;
+}
+
+static void
+pricedb_remember_conversion (GNCPriceDB *db, const gnc_commodity *from,
+                             const gnc_commodity *to, time64 t,
+                             gboolean before, gnc_numeric rate)
+{
+    PriceConversionKey *key;
+    gnc_numeric *value;
+
+    if (!db || !db->conversion_cache) return;
+    key = g_new (PriceConversionKey, 1);
+    key->from = from;
+    key->to = to;
+    key->t = t;
+    key->before = before;
+    value = g_new (gnc_numeric, 1);
+    *value = rate;
+    g_mutex_lock (&db->cache_lock);
+    if (g_hash_table_size (db->conversion_cache) >= PRICE_CONVERSION_CACHE_MAX)
+        g_hash_table_remove_all (db->conversion_cache);
+    g_hash_table_insert (db->conversion_cache, key, value);
+    g_mutex_unlock (&db->cache_lock);
 }
 
 static GNCPriceDB *
@@ -883,6 +1023,16 @@ gnc_pricedb_create(QofBook * book)
 
     result->commodity_hash = g_hash_table_new(NULL, NULL);
     g_return_val_if_fail (result->commodity_hash, NULL);
+    result->series_hash =
+        g_hash_table_new_full (NULL, NULL, NULL,
+                               (GDestroyNotify)g_hash_table_destroy);
+    result->conversion_cache =
+        g_hash_table_new_full (conversion_key_hash, conversion_key_equal,
+                               g_free, g_free);
+    result->packed_hash =
+        g_hash_table_new_full (NULL, NULL, NULL,
+                               (GDestroyNotify)g_hash_table_destroy);
+    result->packed_types = g_ptr_array_new ();
     return result;
 }
 
@@ -930,6 +1080,22 @@ gnc_pricedb_destroy(GNCPriceDB *db)
     }
     g_hash_table_destroy (db->commodity_hash);
     db->commodity_hash = NULL;
+    if (db->series_hash)
+        g_hash_table_destroy (db->series_hash);
+    db->series_hash = NULL;
+    if (db->conversion_cache)
+        g_hash_table_destroy (db->conversion_cache);
+    db->conversion_cache = NULL;
+    if (db->packed_hash)
+        g_hash_table_destroy (db->packed_hash);
+    db->packed_hash = NULL;
+    if (db->packed_types)
+    {
+        g_ptr_array_foreach (db->packed_types, (GFunc)qof_string_cache_remove,
+                             NULL);
+        g_ptr_array_free (db->packed_types, TRUE);
+    }
+    db->packed_types = NULL;
     /* qof_instance_release (&db->inst); */
     g_object_unref(db);
 }
@@ -975,11 +1141,11 @@ gnc_pricedb_get_db(QofBook *book)
 /* ==================================================================== */
 
 static gboolean
-num_prices_helper (GNCPrice *p, gpointer user_data)
+num_prices_helper (GList *price_list, gpointer user_data)
 {
     guint *count = user_data;
 
-    *count += 1;
+    *count += g_list_length (price_list);
 
     return TRUE;
 }
@@ -993,7 +1159,8 @@ gnc_pricedb_get_num_prices(GNCPriceDB *db)
 
     count = 0;
 
-    gnc_pricedb_foreach_price(db, num_prices_helper, &count, FALSE);
+    pricedb_pricelist_traversal(db, num_prices_helper, &count);
+    count += pricedb_packed_count (db, NULL, NULL);
 
     return count;
 }
@@ -1052,6 +1219,8 @@ gnc_pricedb_equal (GNCPriceDB *db1, GNCPriceDB *db2)
         return FALSE;
     }
 
+    pricedb_unpack_all (db1);
+    pricedb_unpack_all (db2);
     equal_data.equal = TRUE;
     equal_data.db2 = db2;
 
@@ -1066,6 +1235,461 @@ gnc_pricedb_equal (GNCPriceDB *db1, GNCPriceDB *db2)
 /* The add_price() function is a utility that only manages the
  * dual hash table insertion */
 
+/* Price series.
+ *
+ * Every price list in the commodity hash is mirrored on demand by a
+ * GPtrArray holding the same prices in the same newest-first order, so
+ * that the lookups for a single commodity and currency can binary search
+ * it instead of copying, merging and walking the lists.  add_price and
+ * remove_price drop the array for the list they change; the arrays hold
+ * no references of their own.  Since lookups build them, possibly several
+ * at once in different threads, series_hash is only touched under
+ * cache_lock; a built array is never changed, only dropped by a writer.
+ */
+static GPtrArray *
+pricedb_get_series (GNCPriceDB *db, const gnc_commodity *commodity,
+                    const gnc_commodity *currency)
+{
+    GHashTable *currency_hash, *series_hash;
+    GPtrArray *series;
+    GList *price_list, *node;
+
+    if (!db->commodity_hash || !db->series_hash) return NULL;
+    pricedb_unpack_series (db, commodity, currency);
+    currency_hash = g_hash_table_lookup (db->commodity_hash, commodity);
+    if (!currency_hash) return NULL;
+    price_list = g_hash_table_lookup (currency_hash, currency);
+    if (!price_list) return NULL;
+
+    g_mutex_lock (&db->cache_lock);
+    series_hash = g_hash_table_lookup (db->series_hash, commodity);
+    if (!series_hash)
+    {
+        series_hash = g_hash_table_new_full (NULL, NULL, NULL,
+                                             (GDestroyNotify)g_ptr_array_unref);
+        g_hash_table_insert (db->series_hash, (gpointer)commodity, series_hash);
+    }
+    series = g_hash_table_lookup (series_hash, currency);
+    if (!series)
+    {
+        series = g_ptr_array_sized_new (g_list_length (price_list));
+        for (node = price_list; node; node = node->next)
+            g_ptr_array_add (series, node->data);
+        g_hash_table_insert (series_hash, (gpointer)currency, series);
+    }
+    g_mutex_unlock (&db->cache_lock);
+    return series;
+}
+
+static void
+pricedb_invalidate_series (GNCPriceDB *db, const gnc_commodity *commodity,
+                           const gnc_commodity *currency)
+{
+    GHashTable *series_hash;
+
+    if (!db->series_hash) return;
+    series_hash = g_hash_table_lookup (db->series_hash, commodity);
+    if (series_hash)
+        g_hash_table_remove (series_hash, currency);
+}
+
+/* gnc_pricedb_compact packs a series into one PackedPriceSeries: a row per
+ * price, newest first like the price lists, kept in parallel columns so
+ * that a row costs about 48 bytes instead of a GNCPrice object with its
+ * instance data, collection entry and list node.  The prices come back as
+ * objects, with their GUIDs, the first time anything asks for the series
+ * rather than just counting it.  Type strings are stored as an index into
+ * db->packed_types plus one, zero standing for no type.
+ */
+typedef struct
+{
+    guint len;
+    GncGUID *guids;
+    time64 *times;
+    gnc_numeric *values;
+    guint8 *sources;
+    guint8 *types;
+} PackedPriceSeries;
+
+#define PACKED_PRICE_TYPES_MAX 255
+
+static void
+packed_price_series_free (PackedPriceSeries *packed)
+{
+    if (!packed) return;
+    g_free (packed->guids);
+    g_free (packed->times);
+    g_free (packed->values);
+    g_free (packed->sources);
+    g_free (packed->types);
+    g_free (packed);
+}
+
+/* A price can be packed only if the database holds the sole reference to
+ * it and it has nothing that the packed row can't carry. */
+static gboolean
+price_is_packable (GNCPriceDB *db, GNCPrice *p)
+{
+    return p->refcount == 1 && p->db == db &&
+        (guint)p->source <= G_MAXUINT8 &&
+        qof_instance_get_editlevel (p) == 0 &&
+        !qof_instance_get_dirty_flag (p) &&
+        !qof_instance_get_destroying (p) &&
+        qof_instance_get_book (p) == qof_instance_get_book (db) &&
+        !qof_instance_has_kvp (&p->inst);
+}
+
+/* Returns the packed type index for type, adding it to the table if need
+ * be, or -1 if the table is full. */
+static gint
+pricedb_packed_type_index (GNCPriceDB *db, const char *type)
+{
+    guint i;
+
+    if (!type) return 0;
+    for (i = 0; i < db->packed_types->len; i++)
+        if (g_ptr_array_index (db->packed_types, i) == type)
+            return i + 1;
+    if (db->packed_types->len >= PACKED_PRICE_TYPES_MAX)
+        return -1;
+    g_ptr_array_add (db->packed_types, CACHE_INSERT (type));
+    return db->packed_types->len;
+}
+
+/* Packs the series price_list for commodity in currency, if every price
+ * on it is packable.  Returns the number of prices packed. */
+static guint
+pricedb_pack_series (GNCPriceDB *db, gnc_commodity *commodity,
+                     gnc_commodity *currency, GList *price_list)
+{
+    PackedPriceSeries *packed;
+    GHashTable *currency_hash, *packed_currencies;
+    GList *node;
+    guint len, row;
+
+    len = g_list_length (price_list);
+    if (!len) return 0;
+    for (node = price_list; node; node = node->next)
+    {
+        GNCPrice *p = node->data;
+        if (!price_is_packable (db, p) ||
+            pricedb_packed_type_index (db, p->type) < 0)
+            return 0;
+    }
+
+    packed = g_new (PackedPriceSeries, 1);
+    packed->len = len;
+    packed->guids = g_new (GncGUID, len);
+    packed->times = g_new (time64, len);
+    packed->values = g_new (gnc_numeric, len);
+    packed->sources = g_new (guint8, len);
+    packed->types = g_new (guint8, len);
+    for (node = price_list, row = 0; node; node = node->next, row++)
+    {
+        GNCPrice *p = node->data;
+        packed->guids[row] = *gnc_price_get_guid (p);
+        packed->times[row] = p->tmspec;
+        packed->values[row] = p->value;
+        packed->sources[row] = p->source;
+        packed->types[row] = pricedb_packed_type_index (db, p->type);
+    }
+
+    currency_hash = g_hash_table_lookup (db->commodity_hash, commodity);
+    g_hash_table_remove (currency_hash, currency);
+    pricedb_invalidate_series (db, commodity, currency);
+    packed_currencies = g_hash_table_lookup (db->packed_hash, commodity);
+    if (!packed_currencies)
+    {
+        packed_currencies =
+            g_hash_table_new_full (NULL, NULL, NULL,
+                                   (GDestroyNotify)packed_price_series_free);
+        g_hash_table_insert (db->packed_hash, commodity, packed_currencies);
+    }
+    g_hash_table_insert (packed_currencies, currency, packed);
+
+    for (node = price_list; node; node = node->next)
+        ((GNCPrice*)node->data)->db = NULL;
+    gnc_price_list_destroy (price_list);
+    return len;
+}
+
+/* Turns the packed series for commodity in currency, if there is one,
+ * back into a price list.  The prices were in the database all along, so
+ * this neither dirties anything nor generates add events. */
+static void
+pricedb_unpack_series (GNCPriceDB *db, const gnc_commodity *commodity,
+                       const gnc_commodity *currency)
+{
+    GHashTable *packed_currencies, *currency_hash;
+    PackedPriceSeries *packed;
+    GList *price_list = NULL, *existing;
+    QofBook *book;
+    guint row;
+
+    if (!db->packed_hash || !g_hash_table_size (db->packed_hash)) return;
+    packed_currencies = g_hash_table_lookup (db->packed_hash, commodity);
+    if (!packed_currencies) return;
+    packed = g_hash_table_lookup (packed_currencies, currency);
+    if (!packed) return;
+    g_hash_table_steal (packed_currencies, currency);
+    if (!g_hash_table_size (packed_currencies))
+        g_hash_table_remove (db->packed_hash, commodity);
+
+    ENTER ("db=%p, %u prices of %s in %s", db, packed->len,
+           gnc_commodity_get_mnemonic (commodity),
+           gnc_commodity_get_mnemonic (currency));
+    book = qof_instance_get_book (db);
+    for (row = packed->len; row-- > 0;)
+    {
+        GNCPrice *p = gnc_price_create (book);
+        guint8 type = packed->types[row];
+
+        gnc_price_set_guid (p, &packed->guids[row]);
+        p->commodity = (gnc_commodity*)commodity;
+        p->currency = (gnc_commodity*)currency;
+        p->tmspec = packed->times[row];
+        p->value = packed->values[row];
+        p->source = packed->sources[row];
+        if (type)
+            p->type = CACHE_INSERT (g_ptr_array_index (db->packed_types,
+                                                       type - 1));
+        p->db = db;
+        price_list = g_list_prepend (price_list, p);
+    }
+    packed_price_series_free (packed);
+
+    currency_hash = g_hash_table_lookup (db->commodity_hash, commodity);
+    if (!currency_hash)
+    {
+        currency_hash = g_hash_table_new (NULL, NULL);
+        g_hash_table_insert (db->commodity_hash, (gpointer)commodity,
+                             currency_hash);
+    }
+    existing = g_hash_table_lookup (currency_hash, currency);
+    if (existing)
+    {
+        GList *merged = pricedb_price_list_merge (price_list, existing);
+        g_list_free (price_list);
+        g_list_free (existing);
+        price_list = merged;
+    }
+    g_hash_table_insert (currency_hash, (gpointer)currency, price_list);
+    pricedb_invalidate_series (db, commodity, currency);
+    db->reset_nth_price_cache = TRUE;
+    price_generation++;
+    LEAVE (" ");
+}
+
+static void
+pricedb_unpack_commodity (GNCPriceDB *db, const gnc_commodity *commodity)
+{
+    GHashTable *packed_currencies;
+    GList *currencies, *node;
+
+    if (!db->packed_hash) return;
+    packed_currencies = g_hash_table_lookup (db->packed_hash, commodity);
+    if (!packed_currencies) return;
+    currencies = g_hash_table_get_keys (packed_currencies);
+    for (node = currencies; node; node = node->next)
+        pricedb_unpack_series (db, commodity, node->data);
+    g_list_free (currencies);
+}
+
+/* Unpacks every series of commodity and every series priced in it. */
+static void
+pricedb_unpack_involving (GNCPriceDB *db, const gnc_commodity *commodity)
+{
+    GList *commodities, *node;
+
+    if (!db->packed_hash || !g_hash_table_size (db->packed_hash)) return;
+    pricedb_unpack_commodity (db, commodity);
+    commodities = g_hash_table_get_keys (db->packed_hash);
+    for (node = commodities; node; node = node->next)
+        pricedb_unpack_series (db, node->data, commodity);
+    g_list_free (commodities);
+}
+
+static void
+pricedb_unpack_all (GNCPriceDB *db)
+{
+    GList *commodities, *node;
+
+    if (!db->packed_hash || !g_hash_table_size (db->packed_hash)) return;
+    commodities = g_hash_table_get_keys (db->packed_hash);
+    for (node = commodities; node; node = node->next)
+        pricedb_unpack_commodity (db, node->data);
+    g_list_free (commodities);
+}
+
+/* The number of packed prices of commodity in currency; either may be
+ * NULL to count all of them. */
+static guint
+pricedb_packed_count (GNCPriceDB *db, const gnc_commodity *commodity,
+                      const gnc_commodity *currency)
+{
+    GHashTableIter iter, currency_iter;
+    gpointer key, value;
+    guint count = 0;
+
+    if (!db->packed_hash) return 0;
+    g_hash_table_iter_init (&iter, db->packed_hash);
+    while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+        if (commodity && key != commodity) continue;
+        g_hash_table_iter_init (&currency_iter, value);
+        while (g_hash_table_iter_next (&currency_iter, &key, &value))
+            if (!currency || key == currency)
+                count += ((PackedPriceSeries*)value)->len;
+    }
+    return count;
+}
+
+/* Finds the packed series holding the price with guid and unpacks it. */
+static void
+pricedb_unpack_guid (GNCPriceDB *db, const GncGUID *guid)
+{
+    GHashTableIter iter, currency_iter;
+    gpointer commodity, currency, value;
+
+    if (!db->packed_hash) return;
+    g_hash_table_iter_init (&iter, db->packed_hash);
+    while (g_hash_table_iter_next (&iter, &commodity, &value))
+    {
+        g_hash_table_iter_init (&currency_iter, value);
+        while (g_hash_table_iter_next (&currency_iter, &currency, &value))
+        {
+            PackedPriceSeries *packed = value;
+            guint row;
+            for (row = 0; row < packed->len; row++)
+                if (guid_equal (&packed->guids[row], guid))
+                {
+                    /* unpack_series changes the tables being iterated. */
+                    pricedb_unpack_series (db, commodity, currency);
+                    return;
+                }
+        }
+    }
+}
+
+typedef struct
+{
+    gnc_commodity *commodity;
+    gnc_commodity *currency;
+    GList *price_list;
+} PackCandidate;
+
+guint
+gnc_pricedb_compact (GNCPriceDB *db)
+{
+    GHashTableIter iter, currency_iter;
+    gpointer commodity, currency, value;
+    GList *candidates = NULL, *node;
+    guint count = 0;
+
+    if (!db || !db->commodity_hash || db->bulk_update) return 0;
+    ENTER ("db=%p", db);
+
+    /* Collect first: packing a series changes the tables. */
+    g_hash_table_iter_init (&iter, db->commodity_hash);
+    while (g_hash_table_iter_next (&iter, &commodity, &value))
+    {
+        g_hash_table_iter_init (&currency_iter, value);
+        while (g_hash_table_iter_next (&currency_iter, &currency, &value))
+        {
+            PackCandidate *candidate = g_new (PackCandidate, 1);
+            candidate->commodity = commodity;
+            candidate->currency = currency;
+            candidate->price_list = value;
+            candidates = g_list_prepend (candidates, candidate);
+        }
+    }
+
+    for (node = candidates; node; node = node->next)
+    {
+        PackCandidate *candidate = node->data;
+        count += pricedb_pack_series (db, candidate->commodity,
+                                      candidate->currency,
+                                      candidate->price_list);
+    }
+    g_list_free_full (candidates, g_free);
+
+    /* Drop the commodities that have only packed series left. */
+    g_hash_table_iter_init (&iter, db->commodity_hash);
+    while (g_hash_table_iter_next (&iter, &commodity, &value))
+        if (!g_hash_table_size (value))
+        {
+            g_hash_table_destroy (value);
+            g_hash_table_iter_remove (&iter);
+        }
+
+    if (count)
+    {
+        db->reset_nth_price_cache = TRUE;
+        price_generation++;
+    }
+    LEAVE ("db=%p, packed %u prices", db, count);
+    return count;
+}
+
+/* Returns the index of the first price in series that isn't newer than t,
+ * or series->len if they all are. */
+static guint
+price_series_index (GPtrArray *series, time64 t)
+{
+    guint lo = 0, hi = series->len;
+    while (lo < hi)
+    {
+        guint mid = lo + (hi - lo) / 2;
+        if (gnc_price_get_time64 (g_ptr_array_index (series, mid)) > t)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* Narrow *before to the newest price in series not newer than t and *after
+ * to the oldest price newer than t, keeping whichever of the old and new
+ * candidates comes first (for before) or last (for after) in the order of
+ * compare_prices_by_date, which is the order of the merged lists that
+ * pricedb_get_prices_internal returns. */
+static void
+price_series_bracket (GPtrArray *series, time64 t,
+                      GNCPrice **before, GNCPrice **after)
+{
+    guint index;
+
+    if (!series || !series->len) return;
+    index = price_series_index (series, t);
+    if (index < series->len)
+    {
+        GNCPrice *price = g_ptr_array_index (series, index);
+        if (!*before || compare_prices_by_date (price, *before) < 0)
+            *before = price;
+    }
+    if (index > 0)
+    {
+        GNCPrice *price = g_ptr_array_index (series, index - 1);
+        if (!*after || compare_prices_by_date (price, *after) > 0)
+            *after = price;
+    }
+}
+
+/* Find the prices either side of t among the prices of c in currency and
+ * of currency in c.  Returns FALSE if there are no such prices. */
+static gboolean
+pricedb_bracket_time (GNCPriceDB *db, const gnc_commodity *c,
+                      const gnc_commodity *currency, time64 t,
+                      GNCPrice **before, GNCPrice **after)
+{
+    *before = *after = NULL;
+    price_series_bracket (pricedb_get_series (db, c, currency), t,
+                          before, after);
+    price_series_bracket (pricedb_get_series (db, currency, c), t,
+                          before, after);
+    return *before || *after;
+}
+
 static gboolean
 add_price(GNCPriceDB *db, GNCPrice *p)
 {
@@ -1107,6 +1731,7 @@ add_price(GNCPriceDB *db, GNCPrice *p)
         LEAVE ("no commodity hash found ");
         return FALSE;
     }
+    pricedb_unpack_series (db, commodity, currency);
 /* Check for an existing price on the same day. If there is no existing price,
  * add this one. If this price is of equal or better precedence than the old
  * one, copy this one over the old one.
@@ -1148,7 +1773,10 @@ add_price(GNCPriceDB *db, GNCPrice *p)
     }
 
     g_hash_table_insert(currency_hash, currency, price_list);
+    pricedb_invalidate_series (db, commodity, currency);
+    pricedb_forget_conversions (db, commodity, currency);
     p->db = db;
+    price_generation++;
 
     qof_event_gen (&p->inst, QOF_EVENT_ADD, NULL);
 
@@ -1191,6 +1819,200 @@ gnc_pricedb_add_price(GNCPriceDB *db, GNCPrice *p)
     return TRUE;
 }
 
+static gboolean
+pricedb_contains_price (GNCPriceDB *db, GNCPrice *p)
+{
+    GPtrArray *series = pricedb_get_series (db, p->commodity, p->currency);
+    guint index;
+
+    if (!series) return FALSE;
+    for (index = price_series_index (series, p->tmspec); index < series->len;
+         ++index)
+    {
+        GNCPrice *price = g_ptr_array_index (series, index);
+        if (price == p)
+            return TRUE;
+        if (price->tmspec != p->tmspec)
+            break;
+    }
+    return FALSE;
+}
+
+/* Orders prices by the series they belong to and, within a series, the
+ * way the series lists are sorted. */
+static gint
+compare_prices_by_series (gconstpointer a, gconstpointer b)
+{
+    const GNCPrice *pa = a, *pb = b;
+    if (pa->commodity != pb->commodity)
+        return (guintptr)pa->commodity < (guintptr)pb->commodity ? -1 : 1;
+    if (pa->currency != pb->currency)
+        return (guintptr)pa->currency < (guintptr)pb->currency ? -1 : 1;
+    return compare_prices_by_date (a, b);
+}
+
+/* Applies the same-day rule of add_price to a run of new prices for one
+ * series, newest first: of several new prices on one day only the best
+ * sourced is kept, and a new price replaces a same-day price already in
+ * the database unless that one has the better source.  In bulk update
+ * mode, as in add_price, there are no such checks and only repeats of the
+ * same price are dropped.  Consumes run and returns the prices to merge;
+ * the prices they replace are prepended to *replaced, with a reference. */
+static GList *
+bulk_resolve_same_day (GNCPriceDB *db, GList *run, GList **replaced)
+{
+    GList *node, *keep = NULL;
+    GNCPrice *day_best = NULL;
+    time64 day = 0;
+
+    for (node = run; node; node = node->next)
+    {
+        GNCPrice *p = node->data;
+        time64 p_day = time64CanonicalDayTime (p->tmspec);
+        if (p == day_best)
+            continue;
+        if (day_best && p_day == day && !db->bulk_update)
+        {
+            if (p->source < day_best->source)
+                keep->data = day_best = p;
+            continue;
+        }
+        keep = g_list_prepend (keep, p);
+        day_best = p;
+        day = p_day;
+    }
+    g_list_free (run);
+    keep = g_list_reverse (keep);
+    if (db->bulk_update)
+        return keep;
+
+    node = keep;
+    while (node)
+    {
+        GList *next = node->next;
+        GNCPrice *p = node->data;
+        GNCPrice *old_price = gnc_pricedb_lookup_day_t64 (db, p->commodity,
+                                                          p->currency,
+                                                          p->tmspec);
+        if (old_price && p->source > old_price->source)
+        {
+            PINFO ("Better price already in DB for %s on %" G_GINT64_FORMAT,
+                   gnc_commodity_get_mnemonic (p->commodity), p->tmspec);
+            keep = g_list_delete_link (keep, node);
+            gnc_price_unref (old_price);
+        }
+        else if (old_price && g_list_find (*replaced, old_price))
+            /* Already replaced by a price for the reverse series. */
+            gnc_price_unref (old_price);
+        else if (old_price)
+            *replaced = g_list_prepend (*replaced, old_price);
+        node = next;
+    }
+    return keep;
+}
+
+/* Merges a newest-first run of prices for one series into the database in
+ * a single pass over the series list.  Returns the number merged. */
+static guint
+bulk_merge_series (GNCPriceDB *db, GList *run)
+{
+    gnc_commodity *commodity = gnc_price_get_commodity (run->data);
+    gnc_commodity *currency = gnc_price_get_currency (run->data);
+    GHashTable *currency_hash;
+    GList *price_list, *merged, *node;
+    guint count = 0;
+
+    pricedb_unpack_series (db, commodity, currency);
+    currency_hash = g_hash_table_lookup (db->commodity_hash, commodity);
+    if (!currency_hash)
+    {
+        currency_hash = g_hash_table_new (NULL, NULL);
+        g_hash_table_insert (db->commodity_hash, commodity, currency_hash);
+    }
+    for (node = run; node; node = node->next)
+    {
+        GNCPrice *p = node->data;
+        gnc_price_ref (p);
+        p->db = db;
+        ++count;
+    }
+    price_list = g_hash_table_lookup (currency_hash, currency);
+    merged = pricedb_price_list_merge (price_list, run);
+    g_list_free (price_list);
+    g_hash_table_insert (currency_hash, currency, merged);
+    pricedb_invalidate_series (db, commodity, currency);
+    pricedb_forget_conversions (db, commodity, currency);
+    return count;
+}
+
+guint
+gnc_pricedb_add_prices_bulk (GNCPriceDB *db, PriceList *prices)
+{
+    GList *sorted = NULL, *replaced = NULL, *runs = NULL, *node;
+    guint added = 0;
+
+    if (!db || !prices || !db->commodity_hash) return 0;
+    ENTER ("db=%p, %u prices", db, g_list_length (prices));
+
+    for (node = prices; node; node = node->next)
+    {
+        GNCPrice *p = node->data;
+        if (!p || !p->commodity || !p->currency ||
+            !qof_instance_books_equal (db, p))
+        {
+            PWARN ("skipping price %p without commodity, currency or book", p);
+            continue;
+        }
+        if (p->db == db && pricedb_contains_price (db, p))
+            continue;
+        sorted = g_list_prepend (sorted, p);
+    }
+    sorted = g_list_sort (sorted, compare_prices_by_series);
+
+    /* Split the batch into one run per series, resolving same-day
+     * conflicts against the database as it was before the batch. */
+    while (sorted)
+    {
+        GList *run = sorted, *end = sorted;
+        while (end->next &&
+               ((GNCPrice*)end->next->data)->commodity ==
+               ((GNCPrice*)run->data)->commodity &&
+               ((GNCPrice*)end->next->data)->currency ==
+               ((GNCPrice*)run->data)->currency)
+            end = end->next;
+        sorted = end->next;
+        end->next = NULL;
+        if (sorted)
+            sorted->prev = NULL;
+        run = bulk_resolve_same_day (db, run, &replaced);
+        if (run)
+            runs = g_list_prepend (runs, run);
+    }
+
+    gnc_pricedb_remove_prices (db, replaced);
+    g_list_free_full (replaced, (GDestroyNotify)gnc_price_unref);
+
+    for (node = runs; node; node = node->next)
+    {
+        added += bulk_merge_series (db, node->data);
+        g_list_free (node->data);
+    }
+    g_list_free (runs);
+    price_generation++;
+
+    /* One event for the whole batch rather than an add event per price. */
+    if (added)
+    {
+        db->reset_nth_price_cache = TRUE;
+        gnc_pricedb_begin_edit (db);
+        qof_instance_set_dirty (&db->inst);
+        gnc_pricedb_commit_edit (db);
+        qof_event_gen (&db->inst, QOF_EVENT_MODIFY, NULL);
+    }
+    LEAVE ("db=%p, added %u", db, added);
+    return added;
+}
+
 /* remove_price() is a utility; its only function is to remove the price
  * from the double-hash tables.
  */
@@ -1233,7 +2055,10 @@ remove_price(GNCPriceDB *db, GNCPrice *p, gboolean cleanup)
         return FALSE;
     }
 
+    price_generation++;
     qof_event_gen (&p->inst, QOF_EVENT_REMOVE, NULL);
+    pricedb_invalidate_series (db, commodity, currency);
+    pricedb_forget_conversions (db, commodity, currency);
     price_list = g_hash_table_lookup(currency_hash, currency);
     gnc_price_ref(p);
     if (!gnc_price_list_remove(&price_list, p))
@@ -1307,6 +2132,7 @@ gnc_pricedb_remove_price(GNCPriceDB *db, GNCPrice *p)
 typedef struct
 {
     GNCPriceDB *db;
+    gnc_commodity *commodity;
     time64 cutoff;
     gboolean delete_fq;
     gboolean delete_user;
@@ -1360,13 +2186,21 @@ pricedb_remove_foreach_pricelist (gpointer key,
                                   gpointer user_data)
 {
     GList *price_list = (GList *) val;
-    GList *node = price_list;
     remove_info *data = (remove_info *) user_data;
+    GPtrArray *series;
+    guint index;
 
     ENTER("key %p, value %p, data %p", key, val, user_data);
 
-    /* now check each item in the list */
-    g_list_foreach(node, (GFunc)check_one_price_date, data);
+    /* The series is newest first, so only the prices from the first one
+     * older than the cutoff onwards need checking. */
+    series = pricedb_get_series (data->db, data->commodity, key);
+    if (series)
+        for (index = price_series_index (series, data->cutoff - 1);
+             index < series->len; index++)
+            check_one_price_date (g_ptr_array_index (series, index), data);
+    else
+        g_list_foreach (price_list, (GFunc)check_one_price_date, data);
 
     LEAVE(" ");
 }
@@ -1492,11 +2326,13 @@ get_fiscal_quarter (GDate *date, GDateMonth fiscal_start)
     return q;
 }
 
-static void
+/* Works out which of the prices in data.list are to go given keep and
+ * returns them; the prices are still in the database. */
+static GSList *
 gnc_pricedb_process_removal_list (GNCPriceDB *db, GDate *fiscal_end_date,
                                   remove_info data, PriceRemoveKeepOptions keep)
 {
-    GSList *item;
+    GSList *item, *doomed = NULL;
     gboolean save_first_price = FALSE;
     gint saved_test_value = 0, next_test_value = 0;
     GNCPrice *cloned_price = NULL;
@@ -1523,7 +2359,7 @@ gnc_pricedb_process_removal_list (GNCPriceDB *db, GDate *fiscal_end_date,
         if (keep == PRICE_REMOVE_KEEP_NONE)
         {
             gnc_pricedb_remove_old_prices_pinfo (item->data, FALSE);
-            gnc_pricedb_remove_price (db, item->data);
+            doomed = g_slist_prepend (doomed, item->data);
             continue;
         }
 
@@ -1592,13 +2428,135 @@ gnc_pricedb_process_removal_list (GNCPriceDB *db, GDate *fiscal_end_date,
         if (saved_test_value == next_test_value)
         {
             gnc_pricedb_remove_old_prices_pinfo (item->data, FALSE);
-            gnc_pricedb_remove_price (db, item->data);
+            doomed = g_slist_prepend (doomed, item->data);
         }
         else
             clone_price (&cloned_price, item->data);
     }
     if (cloned_price)
         gnc_price_unref (cloned_price);
+    return doomed;
+}
+
+/* Removes prices from db in one pass.  Each series list is filtered once
+ * instead of being searched for every price, and rather than a database
+ * commit per price the db is committed once, the backend gets the deletes
+ * as one batch and a single QOF_EVENT_MODIFY on the db announces the
+ * change.  Each price still gets its QOF_EVENT_REMOVE, just before it is
+ * unlinked, because the price tree model needs them to delete its rows.
+ * Returns the number of prices removed. */
+static guint
+pricedb_remove_prices_batch (GNCPriceDB *db, GSList *prices)
+{
+    GHashTable *doomed;
+    GList *removed = NULL, *node;
+    GSList *item;
+    QofBackend *be;
+    guint count = 0;
+
+    if (!db || !prices || !db->commodity_hash) return 0;
+    ENTER ("db=%p", db);
+
+    doomed = g_hash_table_new (NULL, NULL);
+    for (item = prices; item; item = g_slist_next (item))
+        g_hash_table_add (doomed, item->data);
+
+    /* The first doomed price of each series filters that series' list and
+     * takes the rest of its doomed prices out of the set with it. */
+    for (item = prices; item; item = g_slist_next (item))
+    {
+        GNCPrice *p = item->data;
+        gnc_commodity *commodity, *currency;
+        GHashTable *currency_hash;
+        GList *price_list = NULL, *next;
+
+        if (!g_hash_table_contains (doomed, p)) continue;
+
+        commodity = gnc_price_get_commodity (p);
+        currency = gnc_price_get_currency (p);
+        currency_hash = g_hash_table_lookup (db->commodity_hash, commodity);
+        if (currency_hash)
+            price_list = g_hash_table_lookup (currency_hash, currency);
+        if (!price_list)
+        {
+            g_hash_table_remove (doomed, p);
+            continue;
+        }
+
+        for (node = price_list; node; node = next)
+        {
+            next = node->next;
+            if (!g_hash_table_remove (doomed, node->data)) continue;
+            qof_event_gen (&((GNCPrice*)node->data)->inst, QOF_EVENT_REMOVE,
+                           NULL);
+            /* removed takes over the reference the list held. */
+            removed = g_list_prepend (removed, node->data);
+            price_list = g_list_delete_link (price_list, node);
+        }
+
+        pricedb_invalidate_series (db, commodity, currency);
+        pricedb_forget_conversions (db, commodity, currency);
+        if (price_list)
+        {
+            g_hash_table_insert (currency_hash, currency, price_list);
+        }
+        else
+        {
+            g_hash_table_remove (currency_hash, currency);
+            if (0 == g_hash_table_size (currency_hash))
+            {
+                g_hash_table_remove (db->commodity_hash, commodity);
+                g_hash_table_destroy (currency_hash);
+            }
+        }
+    }
+    g_hash_table_destroy (doomed);
+
+    if (!removed)
+    {
+        LEAVE ("nothing removed");
+        return 0;
+    }
+    price_generation++;
+
+    be = qof_book_get_backend (qof_instance_get_book (db));
+    qof_backend_begin_batch (be);
+    gnc_pricedb_begin_edit (db);
+    qof_instance_set_dirty (&db->inst);
+    gnc_pricedb_commit_edit (db);
+
+    /* invoke the backend to delete the prices */
+    for (node = removed; node; node = node->next)
+    {
+        GNCPrice *p = node->data;
+        gnc_price_begin_edit (p);
+        qof_instance_set_destroying (p, TRUE);
+        gnc_price_commit_edit (p);
+        p->db = NULL;
+        gnc_price_unref (p);
+        count++;
+    }
+    qof_backend_commit_batch (be);
+    g_list_free (removed);
+
+    qof_event_gen (&db->inst, QOF_EVENT_MODIFY, NULL);
+    LEAVE ("db=%p, removed %u", db, count);
+    return count;
+}
+
+guint
+gnc_pricedb_remove_prices (GNCPriceDB *db, PriceList *prices)
+{
+    GSList *doomed = NULL;
+    GList *node;
+    guint count;
+
+    if (!db || !prices) return 0;
+    for (node = prices; node; node = node->next)
+        doomed = g_slist_prepend (doomed, node->data);
+    count = pricedb_remove_prices_batch (db, doomed);
+    g_slist_free (doomed);
+    return count;
 }
 
 gboolean
@@ -1609,10 +2567,12 @@ gnc_pricedb_remove_old_prices (GNCPriceDB *db, GList *comm_list,
 {
     remove_info data;
     GList *node;
+    GSList *doomed;
     char datebuff[MAX_DATE_LENGTH + 1];
     memset (datebuff, 0, sizeof(datebuff));
 
     data.db = db;
+    data.commodity = NULL;
     data.cutoff = cutoff;
     data.list = NULL;
     data.delete_fq = FALSE;
@@ -1634,7 +2594,10 @@ gnc_pricedb_remove_old_prices (GNCPriceDB *db, GList *comm_list,
     // Walk the list of commodities
     for (node = g_list_first (comm_list); node; node = g_list_next (node))
     {
-        GHashTable *currencies_hash = g_hash_table_lookup (db->commodity_hash, node->data);
+        GHashTable *currencies_hash;
+        pricedb_unpack_commodity (db, node->data);
+        currencies_hash = g_hash_table_lookup (db->commodity_hash, node->data);
+        data.commodity = node->data;
         g_hash_table_foreach (currencies_hash, pricedb_remove_foreach_pricelist, &data);
     }
 
@@ -1660,8 +2623,10 @@ gnc_pricedb_remove_old_prices (GNCPriceDB *db, GList *comm_list,
         g_date_clear (fiscal_end_date, 1);
         g_date_set_dmy (fiscal_end_date, 31, 12, year_now);
     }
-    gnc_pricedb_process_removal_list (db, fiscal_end_date, data, keep);
+    doomed = gnc_pricedb_process_removal_list (db, fiscal_end_date, data, keep);
+    pricedb_remove_prices_batch (db, doomed);
 
+    g_slist_free (doomed);
     g_slist_free (data.list);
     LEAVE(" ");
     return TRUE;
@@ -1670,8 +2635,6 @@ gnc_pricedb_remove_old_prices (GNCPriceDB *db, GList *comm_list,
 /* ==================================================================== */
 /* lookup/query functions */
 
-static PriceList *pricedb_price_list_merge (PriceList *a, PriceList *b);
-
 static void
 hash_values_helper(gpointer key, gpointer value, gpointer data)
 {
@@ -1750,6 +2713,14 @@ pricedb_get_prices_internal(GNCPriceDB *db, const gnc_commodity *commodity,
     PriceList *forward_list = NULL, *reverse_list = NULL;
     g_return_val_if_fail (db != NULL, NULL);
     g_return_val_if_fail (commodity != NULL, NULL);
+    if (currency)
+    {
+        pricedb_unpack_series (db, commodity, currency);
+        if (bidi)
+            pricedb_unpack_series (db, currency, commodity);
+    }
+    else
+        pricedb_unpack_commodity (db, commodity);
     forward_hash = g_hash_table_lookup(db->commodity_hash, commodity);
     if (currency && bidi)
         reverse_hash = g_hash_table_lookup(db->commodity_hash, currency);
@@ -1792,20 +2763,17 @@ GNCPrice *gnc_pricedb_lookup_latest(GNCPriceDB *db,
                           const gnc_commodity *commodity,
                           const gnc_commodity *currency)
 {
-    GList *price_list;
-    GNCPrice *result;
+    GNCPrice *result, *after;
 
     if (!db || !commodity || !currency) return NULL;
     ENTER ("db=%p commodity=%p currency=%p", db, commodity, currency);
 
-    price_list = pricedb_get_prices_internal(db, commodity, currency, TRUE);
-    if (!price_list) return NULL;
-    /* This works magically because prices are inserted in date-sorted
-     * order, and the latest date always comes first. So return the
-     * first in the list.  */
-    result = price_list->data;
+    /* Nothing is newer than INT64_MAX, so this finds the newest price in
+     * either direction. */
+    if (!pricedb_bracket_time (db, commodity, currency, INT64_MAX,
+                               &result, &after))
+        return NULL;
     gnc_price_ref(result);
-    g_list_free (price_list);
     LEAVE("price is %p", result);
     return result;
 }
@@ -1815,6 +2783,7 @@ typedef struct
     GList **list;
     const gnc_commodity *com;
     time64 t;
+    GNCPriceDB *db;
 } UsesCommodity;
 
 /* price_list_scan_any_currency is the helper function used with
@@ -1831,51 +2800,51 @@ static gboolean
 price_list_scan_any_currency(GList *price_list, gpointer data)
 {
     UsesCommodity *helper = (UsesCommodity*)data;
-    GList *node = price_list;
+    GPtrArray *series;
+    GNCPrice *price;
     gnc_commodity *com;
     gnc_commodity *cur;
+    guint index;
 
     if (!price_list)
         return TRUE;
 
-    com = gnc_price_get_commodity(node->data);
-    cur = gnc_price_get_currency(node->data);
+    com = gnc_price_get_commodity(price_list->data);
+    cur = gnc_price_get_currency(price_list->data);
 
     /* if this price list isn't for the commodity we are interested in,
        ignore it. */
     if (com != helper->com && cur != helper->com)
         return TRUE;
 
-    /* The price list is sorted in decreasing order of time.  Find the first
+    series = pricedb_get_series (helper->db, com, cur);
+    if (!series)
+        return TRUE;
+
+    /* The series is sorted in decreasing order of time.  Find the first
        price on it that is older than the requested time and add it and the
        previous price to the result list. */
-    while (node != NULL)
+    index = helper->t == INT64_MIN ? series->len :
+        price_series_index (series, helper->t - 1);
+    if (index == series->len)
     {
-        GNCPrice *price = node->data;
-        time64 price_t = gnc_price_get_time64(price);
-        if (price_t < helper->t)
-        {
-            /* If there is a previous price add it to the results. */
-            if (node->prev)
-            {
-                GNCPrice *prev_price = node->prev->data;
-                gnc_price_ref(prev_price);
-                *helper->list = g_list_prepend(*helper->list, prev_price);
-            }
-            /* Add the first price before the desired time */
-            gnc_price_ref(price);
-            *helper->list = g_list_prepend(*helper->list, price);
-            /* No point in looking further, they will all be older */
-            break;
-        }
-        else if (node->next == NULL)
-        {
-            /* The last price is later than given time, add it */
-            gnc_price_ref(price);
-            *helper->list = g_list_prepend(*helper->list, price);
-        }
-        node = node->next;
+        /* The last price is later than given time, add it */
+        price = g_ptr_array_index (series, series->len - 1);
+        gnc_price_ref(price);
+        *helper->list = g_list_prepend(*helper->list, price);
+        return TRUE;
     }
+    /* If there is a previous price add it to the results. */
+    if (index > 0)
+    {
+        GNCPrice *prev_price = g_ptr_array_index (series, index - 1);
+        gnc_price_ref(prev_price);
+        *helper->list = g_list_prepend(*helper->list, prev_price);
+    }
+    /* Add the first price before the desired time */
+    price = g_ptr_array_index (series, index);
+    gnc_price_ref(price);
+    *helper->list = g_list_prepend(*helper->list, price);
 
     return TRUE;
 }
@@ -2026,12 +2995,13 @@ gnc_pricedb_lookup_nearest_in_time_any_currency_t64(GNCPriceDB *db,
                                                     time64 t)
 {
     GList *prices = NULL, *result;
-    UsesCommodity helper = {&prices, commodity, t};
+    UsesCommodity helper = {&prices, commodity, t, db};
     result = NULL;
 
     if (!db || !commodity) return NULL;
     ENTER ("db=%p commodity=%p", db, commodity);
 
+    pricedb_unpack_involving (db, commodity);
     pricedb_pricelist_traversal(db, price_list_scan_any_currency, &helper);
     prices = g_list_sort(prices, compare_prices_by_date);
     result = nearest_to(prices, commodity, t);
@@ -2046,12 +3016,13 @@ gnc_pricedb_lookup_nearest_before_any_currency_t64(GNCPriceDB *db,
                                                    time64 t)
 {
     GList *prices = NULL, *result;
-    UsesCommodity helper = {&prices, commodity, t};
+    UsesCommodity helper = {&prices, commodity, t, db};
     result = NULL;
 
     if (!db || !commodity) return NULL;
     ENTER ("db=%p commodity=%p", db, commodity);
 
+    pricedb_unpack_involving (db, commodity);
     pricedb_pricelist_traversal(db, price_list_scan_any_currency,
                                        &helper);
     prices = g_list_sort(prices, compare_prices_by_date);
@@ -2076,6 +3047,11 @@ gnc_pricedb_has_prices(GNCPriceDB *db,
 
     if (!db || !commodity) return FALSE;
     ENTER ("db=%p commodity=%p currency=%p", db, commodity, currency);
+    if (pricedb_packed_count (db, commodity, currency))
+    {
+        LEAVE("yes, packed");
+        return TRUE;
+    }
     currency_hash = g_hash_table_lookup(db->commodity_hash, commodity);
     if (!currency_hash)
     {
@@ -2150,80 +3126,127 @@ gnc_pricedb_num_prices(GNCPriceDB *db,
     {
         g_hash_table_foreach(currency_hash, price_count_helper,  (gpointer)&result);
     }
+    result += pricedb_packed_count (db, c, NULL);
 
     LEAVE ("count=%d", result);
     return result;
 }
 
-/* Helper function for combining the price lists in gnc_pricedb_nth_price. */
-static void
-list_combine (gpointer element, gpointer data)
+/* gnc_pricedb_nth_price and gnc_pricedb_nth_price_index are used by
+ * gnc-tree-model-price.c to present the prices of a commodity, in all its
+ * currencies, as one indexed list of rows for the pricedb dialog's
+ * GtkTreeView.  gtk-tree-view-price.c sorts the rows itself, so the rows
+ * are simply each currency's series in turn, newest first.  Looking a row
+ * up in the series is constant time, however many prices there are, and
+ * finding a price's row is a binary search of its series.
+ *
+ * The series of the last commodity asked about are kept, referenced, until
+ * gnc_pricedb_nth_price_reset_cache is called, so that the tree model
+ * keeps seeing the rows it was told about while it signals a change.  A
+ * change to one series only means fetching the others from series_hash
+ * again.  Since this is a GUI-driven function there is no concern about
+ * concurrency.
+ */
+static GPtrArray *
+pricedb_nth_price_series (GNCPriceDB *db, const gnc_commodity *c)
 {
-    GList *list = *(GList**)data;
-    if (list == NULL)
-        *(GList**)data = g_list_copy (element);
-    else
+    static const gnc_commodity *last_c = NULL;
+    static GPtrArray *last_series = NULL;
+    GHashTable *currency_hash;
+
+    if (last_c && last_series && last_c == c && db->reset_nth_price_cache == FALSE)
+        return last_series;
+
+    last_c = c;
+    if (last_series)
+        g_ptr_array_unref (last_series);
+    last_series = g_ptr_array_new_with_free_func ((GDestroyNotify)g_ptr_array_unref);
+    db->reset_nth_price_cache = FALSE;
+
+    pricedb_unpack_commodity (db, c);
+    currency_hash = g_hash_table_lookup (db->commodity_hash, c);
+    if (currency_hash)
     {
-        GList *new_list = g_list_concat ((GList *)list, g_list_copy (element));
-        *(GList**)data = new_list;
+        GList *currencies = g_hash_table_get_keys (currency_hash);
+        GList *node;
+
+        for (node = currencies; node; node = node->next)
+        {
+            GPtrArray *series = pricedb_get_series (db, c, node->data);
+            if (series)
+                g_ptr_array_add (last_series, g_ptr_array_ref (series));
+        }
+        g_list_free (currencies);
     }
+    return last_series;
 }
 
-/* This function is used by gnc-tree-model-price.c for iterating through the
- * prices when building or filtering the pricedb dialog's
- * GtkTreeView. gtk-tree-view-price.c sorts the results after it has obtained
- * the values so there's nothing gained by sorting. However, for very large
- * collections of prices in multiple currencies (here commodity is the one being
- * priced and currency the one in which the price is denominated; note that they
- * may both be currencies or not) just concatenating the price lists together
- * can be expensive because the receiving list must be traversed to obtain its
- * end. To avoid that cost n times we cache the commodity and merged price list.
- * Since this is a GUI-driven function there is no concern about concurrency.
- */
-
 GNCPrice *
 gnc_pricedb_nth_price (GNCPriceDB *db,
                        const gnc_commodity *c,
                        const int n)
 {
-    static const gnc_commodity *last_c = NULL;
-    static GList *prices = NULL;
-
     GNCPrice *result = NULL;
-    GHashTable *currency_hash;
+    GPtrArray *all_series;
+    guint i, index;
     g_return_val_if_fail (GNC_IS_COMMODITY (c), NULL);
 
     if (!db || !c || n < 0) return NULL;
     ENTER ("db=%p commodity=%s index=%d", db, gnc_commodity_get_mnemonic(c), n);
 
-    if (last_c && prices && last_c == c && db->reset_nth_price_cache == FALSE)
+    all_series = pricedb_nth_price_series (db, c);
+    for (i = 0, index = n; i < all_series->len; i++)
     {
-        result = g_list_nth_data (prices, n);
-        LEAVE ("price=%p", result);
-        return result;
+        GPtrArray *series = g_ptr_array_index (all_series, i);
+        if (index < series->len)
+        {
+            result = g_ptr_array_index (series, index);
+            break;
+        }
+        index -= series->len;
     }
 
-    last_c = c;
+    LEAVE ("price=%p", result);
+    return result;
+}
 
-    if (prices)
-    {
-        g_list_free (prices);
-        prices = NULL;
-    }
+int
+gnc_pricedb_nth_price_index (GNCPriceDB *db, const GNCPrice *p)
+{
+    GPtrArray *all_series;
+    guint i, index, offset = 0;
 
-    db->reset_nth_price_cache = FALSE;
+    if (!db || !p || !p->commodity) return -1;
+    ENTER ("db=%p price=%p", db, p);
 
-    currency_hash = g_hash_table_lookup (db->commodity_hash, c);
-    if (currency_hash)
+    all_series = pricedb_nth_price_series (db, p->commodity);
+    for (i = 0; i < all_series->len; i++)
     {
-        GList *currencies = g_hash_table_get_values (currency_hash);
-        g_list_foreach (currencies, list_combine, &prices);
-        result = g_list_nth_data (prices, n);
-        g_list_free (currencies);
+        GPtrArray *series = g_ptr_array_index (all_series, i);
+        GNCPrice *first = g_ptr_array_index (series, 0);
+
+        if (first->currency != p->currency)
+        {
+            offset += series->len;
+            continue;
+        }
+        for (index = price_series_index (series, p->tmspec);
+             index < series->len; index++)
+        {
+            GNCPrice *price = g_ptr_array_index (series, index);
+            if (price == p)
+            {
+                LEAVE ("index=%u", offset + index);
+                return offset + index;
+            }
+            if (price->tmspec != p->tmspec)
+                break;
+        }
+        break;
     }
 
-    LEAVE ("price=%p", result);
-    return result;
+    LEAVE ("not found");
+    return -1;
 }
 
 void
@@ -2248,27 +3271,18 @@ gnc_pricedb_lookup_at_time64(GNCPriceDB *db,
                              const gnc_commodity *currency,
                              time64 t)
 {
-    GList *price_list;
-    GList *item = NULL;
+    GNCPrice *before, *after;
 
     if (!db || !c || !currency) return NULL;
     ENTER ("db=%p commodity=%p currency=%p", db, c, currency);
-    price_list = pricedb_get_prices_internal (db, c, currency, TRUE);
-    item = price_list;
-    while (item)
+    /* Prices at t are the newest not newer than t. */
+    if (pricedb_bracket_time (db, c, currency, t, &before, &after) &&
+        before && gnc_price_get_time64 (before) == t)
     {
-        GNCPrice *p = item->data;
-        time64 price_time = gnc_price_get_time64(p);
-        if (price_time == t)
-        {
-            gnc_price_ref(p);
-            g_list_free (price_list);
-            LEAVE("price is %p", p);
-            return p;
-        }
-        item = item->next;
+        gnc_price_ref(before);
+        LEAVE("price is %p", before);
+        return before;
     }
-    g_list_free (price_list);
     LEAVE (" ");
     return NULL;
 }
@@ -2280,36 +3294,20 @@ lookup_nearest_in_time(GNCPriceDB *db,
                        time64 t,
                        gboolean sameday)
 {
-    GList *price_list;
     GNCPrice *current_price = NULL;
     GNCPrice *next_price = NULL;
     GNCPrice *result = NULL;
-    GList *item = NULL;
 
     if (!db || !c || !currency) return NULL;
     if (t == INT64_MAX) return NULL;
     ENTER ("db=%p commodity=%p currency=%p", db, c, currency);
-    price_list = pricedb_get_prices_internal (db, c, currency, TRUE);
-    if (!price_list) return NULL;
-    item = price_list;
 
-    /* default answer */
-    current_price = item->data;
-
-    /* find the first candidate past the one we want.  Remember that
-       prices are in most-recent-first order. */
-    while (!next_price && item)
-    {
-        GNCPrice *p = item->data;
-        time64 price_time = gnc_price_get_time64(p);
-        if (price_time <= t)
-        {
-            next_price = item->data;
-            break;
-        }
-        current_price = item->data;
-        item = item->next;
-    }
+    /* next_price is the newest price not newer than t and current_price the
+     * oldest one newer than it or, if there is none, next_price again. */
+    if (!pricedb_bracket_time (db, c, currency, t, &next_price, &current_price))
+        return NULL;
+    if (!current_price)
+        current_price = next_price;
 
     if (current_price)      /* How can this be null??? */
     {
@@ -2381,7 +3379,6 @@ lookup_nearest_in_time(GNCPriceDB *db,
     }
 
     gnc_price_ref(result);
-    g_list_free (price_list);
     LEAVE (" ");
     return result;
 }
@@ -2402,32 +3399,91 @@ gnc_pricedb_lookup_nearest_before_t64 (GNCPriceDB *db,
                                        const gnc_commodity *currency,
                                        time64 t)
 {
-    GList *price_list;
     GNCPrice *current_price = NULL;
-    /*  GNCPrice *next_price = NULL;
-        GNCPrice *result = NULL;*/
-    GList *item = NULL;
-    time64 price_time;
+    GNCPrice *next_price = NULL;
 
     if (!db || !c || !currency) return NULL;
     ENTER ("db=%p commodity=%p currency=%p", db, c, currency);
-    price_list = pricedb_get_prices_internal (db, c, currency, TRUE);
-    if (!price_list) return NULL;
-    item = price_list;
-    do
-    {
-        price_time = gnc_price_get_time64 (item->data);
-        if (price_time <= t)
-            current_price = item->data;
-        item = item->next;
-    }
-    while (price_time > t && item);
+    if (!pricedb_bracket_time (db, c, currency, t, &current_price, &next_price))
+        return NULL;
     gnc_price_ref(current_price);
-    g_list_free (price_list);
     LEAVE (" ");
     return current_price;
 }
 
+GNCPrice **
+gnc_pricedb_lookup_nearest_before_matrix_t64 (GNCPriceDB *db,
+                                              CommodityList *commodities,
+                                              const gnc_commodity *currency,
+                                              const time64 *times,
+                                              guint n_times)
+{
+    GNCPrice **matrix;
+    GList *node;
+    guint n_commodities, row;
+
+    if (!db || !currency || !times || !n_times) return NULL;
+    n_commodities = g_list_length (commodities);
+    if (!n_commodities) return NULL;
+    ENTER ("db=%p, %u commodities, %u times", db, n_commodities, n_times);
+
+    matrix = g_new0 (GNCPrice*, n_commodities * n_times);
+    /* Get the two series of each commodity once and search them for
+     * every time, as gnc_pricedb_lookup_nearest_before_t64 does. */
+    for (node = commodities, row = 0; node; node = node->next, row++)
+    {
+        const gnc_commodity *c = node->data;
+        GPtrArray *forward, *reverse;
+        guint col;
+
+        if (!c) continue;
+        forward = pricedb_get_series (db, c, currency);
+        reverse = pricedb_get_series (db, currency, c);
+        if (!forward && !reverse) continue;
+        for (col = 0; col < n_times; col++)
+        {
+            GNCPrice *before = NULL, *after = NULL;
+            price_series_bracket (forward, times[col], &before, &after);
+            price_series_bracket (reverse, times[col], &before, &after);
+            gnc_price_ref (before);
+            matrix[row * n_times + col] = before;
+        }
+    }
+    LEAVE (" ");
+    return matrix;
+}
+
+void
+gnc_price_matrix_destroy (GNCPrice **matrix, guint n_prices)
+{
+    guint i;
+
+    if (!matrix) return;
+    for (i = 0; i < n_prices; i++)
+        gnc_price_unref (matrix[i]);
+    g_free (matrix);
+}
+
+PriceList *
+gnc_pricedb_lookup_nearest_before_commodities_t64 (GNCPriceDB *db,
+                                                   CommodityList *commodities,
+                                                   const gnc_commodity *currency,
+                                                   time64 t)
+{
+    GNCPrice **prices;
+    PriceList *result = NULL;
+    guint n_commodities = g_list_length (commodities), i;
+
+    prices = gnc_pricedb_lookup_nearest_before_matrix_t64 (db, commodities,
+                                                           currency, &t, 1);
+    if (!prices) return NULL;
+    /* The list keeps the references the matrix took. */
+    for (i = n_commodities; i-- > 0;)
+        result = g_list_prepend (result, prices[i]);
+    g_free (prices);
+    return result;
+}
+
 
 typedef struct
 {
@@ -2585,10 +3641,14 @@ get_nearest_price (GNCPriceDB *pdb,
                    gboolean before)
 {
     gnc_numeric price;
+    gboolean indirect = FALSE;
 
     if (gnc_commodity_equiv (orig_curr, new_curr))
         return gnc_numeric_create (1, 1);
 
+    if (pricedb_lookup_conversion (pdb, orig_curr, new_curr, t, before, &price))
+        return price;
+
     /* Look for a direct price. */
     price = direct_price_conversion (pdb, orig_curr, new_curr, t, before);
 
@@ -2596,9 +3656,17 @@ get_nearest_price (GNCPriceDB *pdb,
      * no direct price found, try find a price in another currency
      */
     if (gnc_numeric_zero_p (price))
+    {
         price = indirect_price_conversion (pdb, orig_curr, new_curr, t, before);
+        indirect = TRUE;
+    }
 
-    return gnc_numeric_reduce (price);
+    price = gnc_numeric_reduce (price);
+    /* The indirect lookup of the latest price depends on the time of day,
+     * since it ignores prices dated in the future. */
+    if (!(indirect && t == INT64_MAX))
+        pricedb_remember_conversion (pdb, orig_curr, new_curr, t, before, price);
+    return price;
 }
 
 gnc_numeric
@@ -2877,6 +3945,8 @@ gnc_pricedb_foreach_price(GNCPriceDB *db,
                           gboolean stable_order)
 {
     ENTER ("db=%p f=%p", db, f);
+    if (db)
+        pricedb_unpack_all (db);
     if (stable_order)
     {
         LEAVE (" stable order found");
@@ -3097,6 +4167,7 @@ void_unstable_price_traversal(GNCPriceDB *db,
     foreach_data.func = f;
     foreach_data.user_data = user_data;
 
+    pricedb_unpack_all (db);
     g_hash_table_foreach(db->commodity_hash,
                          void_pricedb_foreach_currencies_hash,
                          &foreach_data);
@@ -3205,6 +4276,77 @@ static QofObject pricedb_object_def =
     DI(.version_cmp       = ) NULL,
 };
 
+/* ==================================================================== */
+/* Memory report.  The GNCPrice objects themselves are counted with the
+ * book's price collection; this adds what the database keeps around
+ * them. */
+
+/* A GHashTable entry is a key, a value and a hash, in three arrays. */
+#define PRICEDB_HASH_ENTRY_BYTES (2 * sizeof (gpointer) + sizeof (guint))
+
+static void
+pricedb_memory_source (QofBook *book, QofMemoryCB cb, gpointer user_data)
+{
+    GNCPriceDB *db = book ? gnc_pricedb_get_db (book) : NULL;
+    GHashTableIter iter, currency_iter;
+    gpointer key, value;
+    guint64 series = 0, listed = 0, packed_series = 0, packed = 0;
+    guint64 cached_series = 0, cached_prices = 0, conversions = 0;
+
+    if (!db) return;
+
+    g_hash_table_iter_init (&iter, db->commodity_hash);
+    while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+        g_hash_table_iter_init (&currency_iter, value);
+        while (g_hash_table_iter_next (&currency_iter, &key, &value))
+        {
+            series++;
+            listed += g_list_length (value);
+        }
+    }
+    cb ("price lists", series,
+        series * PRICEDB_HASH_ENTRY_BYTES + listed * sizeof (GList), user_data);
+
+    if (db->packed_hash)
+    {
+        g_hash_table_iter_init (&iter, db->packed_hash);
+        while (g_hash_table_iter_next (&iter, &key, &value))
+        {
+            g_hash_table_iter_init (&currency_iter, value);
+            while (g_hash_table_iter_next (&currency_iter, &key, &value))
+            {
+                packed_series++;
+                packed += ((PackedPriceSeries*)value)->len;
+            }
+        }
+    }
+    cb ("packed prices", packed,
+        packed_series * (sizeof (PackedPriceSeries) + PRICEDB_HASH_ENTRY_BYTES) +
+        packed * (sizeof (GncGUID) + sizeof (time64) + sizeof (gnc_numeric) + 2),
+        user_data);
+
+    g_mutex_lock (&db->cache_lock);
+    g_hash_table_iter_init (&iter, db->series_hash);
+    while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+        g_hash_table_iter_init (&currency_iter, value);
+        while (g_hash_table_iter_next (&currency_iter, &key, &value))
+        {
+            cached_series++;
+            cached_prices += ((GPtrArray*)value)->len;
+        }
+    }
+    conversions = g_hash_table_size (db->conversion_cache);
+    g_mutex_unlock (&db->cache_lock);
+    cb ("price lookup series", cached_series,
+        cached_series * (sizeof (GPtrArray) + PRICEDB_HASH_ENTRY_BYTES) +
+        cached_prices * sizeof (gpointer), user_data);
+    cb ("price conversion cache", conversions,
+        conversions * (sizeof (PriceConversionKey) + sizeof (gnc_numeric) +
+                       PRICEDB_HASH_ENTRY_BYTES), user_data);
+}
+
 gboolean
 gnc_pricedb_register (void)
 {
@@ -3220,6 +4362,7 @@ gnc_pricedb_register (void)
     };
 
     qof_class_register (GNC_ID_PRICE, NULL, params);
+    qof_memory_register_source (pricedb_memory_source);
 
     if (!qof_object_register (&price_object_def))
         return FALSE;
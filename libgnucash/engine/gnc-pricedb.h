@@ -324,6 +324,13 @@ gboolean gnc_price_list_equal(PriceList *prices1, PriceList *prices2);
   or in a price list, the price will have had a ref added for you, so
   you only need to unref the price(s) when you're finished with
   it/them.
+
+  Several threads may use the lookup functions (gnc_pricedb_lookup_*,
+  gnc_pricedb_get_*_price, gnc_pricedb_get_prices and
+  gnc_pricedb_convert_balance_*) on one pricedb at the same time, and
+  may ref and unref the prices they return, as long as no thread is
+  changing the pricedb meanwhile and it hasn't been compacted with
+  gnc_pricedb_compact(), since unpacking a series is a change.
   @{
 */
 /** Data type */
@@ -361,6 +368,25 @@ void gnc_pricedb_commit_edit (GNCPriceDB *);
  */
 void gnc_pricedb_set_bulk_update(GNCPriceDB *db, gboolean bulk_update);
 
+/** @brief Pack the prices of the pricedb into a compact store.
+ *
+ * Each commodity/currency price series whose prices are held only by the
+ * pricedb, and are clean and not being edited, is packed into columns of
+ * time, value, source and type, and its GNCPrice objects are freed. That
+ * takes a fraction of the memory, which matters for books with many
+ * prices. A packed series is turned back into GNCPrices, with their
+ * original GUIDs, the first time something looks up or walks its prices;
+ * counting them (gnc_pricedb_num_prices(), gnc_pricedb_get_num_prices(),
+ * gnc_pricedb_has_prices()) does not.
+ *
+ * Nothing is dirtied and there are no add or remove events, as the
+ * prices stay in the pricedb, so don't call this while code is holding
+ * GNCPrice pointers it hasn't referenced.
+ * @param db The pricedb
+ * @return The number of prices packed.
+ */
+guint gnc_pricedb_compact(GNCPriceDB *db);
+
 /** @brief Add a price to the pricedb.
  *
  * You may drop your reference to the price (i.e. call unref) after this
@@ -371,12 +397,48 @@ void gnc_pricedb_set_bulk_update(GNCPriceDB *db, gboolean bulk_update);
  */
 gboolean     gnc_pricedb_add_price(GNCPriceDB *db, GNCPrice *p);
 
+/** @brief Add a batch of prices to the pricedb.
+ *
+ * The prices are sorted and merged into each commodity/currency price
+ * list in one pass, which is much faster than adding them one at a time
+ * when importing many prices. The same rules as gnc_pricedb_add_price()
+ * apply: unless bulk update is set, a price replaces one already in the
+ * database for the same day unless that one has a better source, and of
+ * several prices in the batch for the same day only the one with the best
+ * source is added.
+ *
+ * Instead of an add event for each price, a single QOF_EVENT_MODIFY is
+ * generated for the pricedb.
+ *
+ * The pricedb takes its own reference to each price it adds; the caller
+ * should drop its references when done with the prices.
+ * @param db The pricedb
+ * @param prices The GNCPrices to add.
+ * @return The number of prices added.
+ */
+guint gnc_pricedb_add_prices_bulk(GNCPriceDB *db, PriceList *prices);
+
 /** @brief Remove a price from the pricedb and unref the price.
  * @param db The Pricedb
  * @param p The price to remove.
  */
 gboolean     gnc_pricedb_remove_price(GNCPriceDB *db, GNCPrice *p);
 
+/** @brief Remove a batch of prices from the pricedb and unref them.
+ *
+ * Each price list is filtered once for all the prices in it, the backend
+ * gets the deletes as one batch and the pricedb is committed once. Each
+ * price still gets its QOF_EVENT_REMOVE, and a QOF_EVENT_MODIFY on the
+ * pricedb follows them. Prices that aren't in the pricedb, or appear in
+ * the batch more than once, are only removed once.
+ *
+ * The caller keeps, and must drop, any references it holds itself.
+ * @param db The pricedb
+ * @param prices The GNCPrices to remove.
+ * @return The number of prices removed.
+ */
+guint        gnc_pricedb_remove_prices(GNCPriceDB *db, PriceList *prices);
+
 typedef enum
 {
     PRICE_REMOVE_SOURCE_FQ = 1,   // this flag is set when added by F:Q checked
@@ -543,6 +605,50 @@ GNCPrice * gnc_pricedb_lookup_nearest_before_t64 (GNCPriceDB *db,
                                                   const gnc_commodity *currency,
                                                   time64 t);
 
+/** @brief Do gnc_pricedb_lookup_nearest_before_t64() for each of a list of
+ * commodities at each of several times in one call.
+ *
+ * @param db The pricedb
+ * @param commodities The commodities to find prices for
+ * @param currency The commodity to find their prices in
+ * @param times The times before which to find the prices
+ * @param n_times The number of times
+ * @return A newly allocated array of g_list_length(commodities) * n_times
+ * prices, by commodity and then by time: the price of the i'th commodity
+ * nearest before times[j] is at i * n_times + j, NULL if there is none.
+ * Free it with gnc_price_matrix_destroy(). NULL if either list is empty.
+ */
+GNCPrice ** gnc_pricedb_lookup_nearest_before_matrix_t64 (GNCPriceDB *db,
+                                                          CommodityList *commodities,
+                                                          const gnc_commodity *currency,
+                                                          const time64 *times,
+                                                          guint n_times);
+
+/** @brief Unref the prices of an array from
+ * gnc_pricedb_lookup_nearest_before_matrix_t64() and free it.
+ * @param matrix The array
+ * @param n_prices The number of entries in it
+ */
+void gnc_price_matrix_destroy (GNCPrice **matrix, guint n_prices);
+
+/** @brief Do gnc_pricedb_lookup_nearest_before_t64() for each of a list of
+ * commodities in one call.
+ *
+ * This is the form of gnc_pricedb_lookup_nearest_before_matrix_t64() for
+ * the Scheme and Python bindings, which can call it once per date.
+ * @param db The pricedb
+ * @param commodities The commodities to find prices for
+ * @param currency The commodity to find their prices in
+ * @param t The time before which to find the prices
+ * @return A list with the price for each commodity, in the same order and
+ * NULL where there is none. Unref the prices and free the list with
+ * gnc_price_list_destroy() when done.
+ */
+PriceList * gnc_pricedb_lookup_nearest_before_commodities_t64 (GNCPriceDB *db,
+                                                               CommodityList *commodities,
+                                                               const gnc_commodity *currency,
+                                                               time64 t);
+
 /** @brief Return the nearest price between the given commodity and any other
  * before the given time.
  *
@@ -688,6 +794,20 @@ gnc_pricedb_nth_price (GNCPriceDB *db,
                        const gnc_commodity *c,
                        const int n);
 
+/** @brief Get the index of a price among the prices of its commodity
+ * @param db The pricedb
+ * @param p The price
+ * @return The n for which gnc_pricedb_nth_price() returns p for the
+ * commodity of p, or -1 if it isn't there
+ */
+int gnc_pricedb_nth_price_index (GNCPriceDB *db, const GNCPrice *p);
+
+/** @brief Make gnc_pricedb_nth_price() and gnc_pricedb_nth_price_index()
+ * see the prices added to or removed from the commodity they were last
+ * called for.  Until this is called they go on seeing its prices as they
+ * were then.
+ * @param db The pricedb
+ */
 void gnc_pricedb_nth_price_reset_cache (GNCPriceDB *db);
 
 /* The following two convenience functions are used to test the xml backend */
@@ -36,6 +36,7 @@
 #include "gncEntryP.h"
 #include "gnc-features.h"
 #include "gncInvoice.h"
+#include "gncInvoiceP.h"
 #include "gncOrder.h"
 
 struct _gncEntry
@@ -203,6 +204,9 @@ gboolean gncEntryPaymentStringToType (const char *str, GncEntryPaymentType *type
 static inline void mark_entry (GncEntry *entry);
 void mark_entry (GncEntry *entry)
 {
+    /* Any change can alter the totals of the documents the entry is on */
+    gncInvoiceMarkTotalsDirty (entry->invoice);
+    gncInvoiceMarkTotalsDirty (entry->bill);
     qof_instance_set_dirty(&entry->inst);
     qof_event_gen (&entry->inst, QOF_EVENT_MODIFY, NULL);
 }
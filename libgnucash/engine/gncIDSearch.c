@@ -22,11 +22,14 @@
 **********************************************************************/
 
 #include "gncIDSearch.h"
+#include "qofevent-p.h"
 
 typedef enum
 {   UNDEFINED,
     CUSTOMER,
     VENDOR,
+    EMPLOYEE,
+    JOB,
     INVOICE,
     BILL
 }GncSearchType;
@@ -79,85 +82,235 @@ gnc_search_vendor_on_id (QofBook * book, const gchar *id)
     return vendor;
 }
 
+GncEmployee *
+gnc_search_employee_on_id (QofBook * book, const gchar *id)
+{
+    GncEmployee *employee =  NULL;
+    GncSearchType type = EMPLOYEE;
+    employee = (GncEmployee*)search(book, id, employee, type);
+    return employee;
+}
+
+GncJob *
+gnc_search_job_on_id (QofBook * book, const gchar *id)
+{
+    GncJob *job =  NULL;
+    GncSearchType type = JOB;
+    job = (GncJob*)search(book, id, job, type);
+    return job;
+}
+
 
 /******************************************************************
- * Generic search called after setting up stuff
- * DO NOT call directly but type tests should fail anyway
+ * Index of the business objects of a book by their ID.
+ *
+ * Each ID maps to the GUIDs of the objects that had it when they were
+ * seen, whatever their type: invoices and bills can share an ID.
+ * Objects are added when the index is built and when an event reports
+ * them created or changed. Entries are checked against the object when
+ * looked up, so an object that was destroyed or given another ID is
+ * just not found. If events were suspended and dropped in the
+ * meantime the index is built again.
  ****************************************************************/
-static void * search(QofBook * book, const gchar *id, void * object, GncSearchType type)
+
+#define GNC_ID_SEARCH_INDEX "gnc-id-search-index"
+
+typedef struct
 {
-    void *c;
-    GList *result;
-    QofQuery *q;
-    gint len;
-    QofQueryPredData* string_pred_data;
-    
-    PINFO("Type = %d", type);
-    g_return_val_if_fail (type, NULL);
-    g_return_val_if_fail (id, NULL);
-    g_return_val_if_fail (book, NULL);
+    GHashTable *ids;
+    guint dropped;
+} IDSearchIndex;
+
+static gint id_index_handler_id = 0;
+
+static const QofIdTypeConst id_index_types[] =
+{
+    GNC_ID_CUSTOMER, GNC_ID_VENDOR, GNC_ID_EMPLOYEE, GNC_ID_JOB,
+    GNC_ID_INVOICE, NULL
+};
+
+static const gchar *
+instance_id (QofInstance *inst)
+{
+    if (GNC_IS_CUSTOMER (inst))
+        return gncCustomerGetID (GNC_CUSTOMER (inst));
+    if (GNC_IS_VENDOR (inst))
+        return gncVendorGetID (GNC_VENDOR (inst));
+    if (GNC_IS_EMPLOYEE (inst))
+        return gncEmployeeGetID (GNC_EMPLOYEE (inst));
+    if (GNC_IS_JOB (inst))
+        return gncJobGetID (GNC_JOB (inst));
+    if (GNC_IS_INVOICE (inst))
+        return gncInvoiceGetID (GNC_INVOICE (inst));
+    return NULL;
+}
+
+static void
+free_guid_list (gpointer key, gpointer value, gpointer user_data)
+{
+    g_list_free_full (value, (GDestroyNotify)guid_free);
+}
+
+static void
+id_index_free (IDSearchIndex *index)
+{
+    if (!index) return;
+    g_hash_table_foreach (index->ids, free_guid_list, NULL);
+    g_hash_table_destroy (index->ids);
+    g_free (index);
+}
+
+static void
+id_index_book_end (QofBook *book, gpointer key, gpointer user_data)
+{
+    id_index_free (user_data);
+}
+
+static void
+id_index_add (QofInstance *inst, gpointer user_data)
+{
+    GHashTable *ids = user_data;
+    const gchar *id = instance_id (inst);
+    const GncGUID *guid = qof_instance_get_guid (inst);
+    GList *guids, *node;
+
+    if (!id || !*id)
+        return;
 
-    // Build the query
-    q = qof_query_create ();
-    qof_query_set_book (q, book);
-    // Search only the id field
-    string_pred_data = qof_query_string_predicate (QOF_COMPARE_EQUAL, id, QOF_STRING_MATCH_NORMAL, FALSE);
-    if (type == CUSTOMER)
+    guids = g_hash_table_lookup (ids, id);
+    for (node = guids; node; node = node->next)
+        if (guid_equal (node->data, guid))
+            return;
+
+    /* Insert behind the head so that the table's value stays valid */
+    if (guids)
+        g_list_insert (guids, guid_copy (guid), 1);
+    else
+        g_hash_table_insert (ids, g_strdup (id),
+                             g_list_prepend (NULL, guid_copy (guid)));
+}
+
+static void
+id_index_handle_events (QofInstance *entity, QofEventId event_type,
+                        gpointer user_data, gpointer event_data)
+{
+    IDSearchIndex *index;
+
+    if (!(event_type & (QOF_EVENT_CREATE | QOF_EVENT_MODIFY)))
+        return;
+    if (!instance_id (entity))
+        return;
+
+    index = qof_book_get_data (qof_instance_get_book (entity),
+                               GNC_ID_SEARCH_INDEX);
+    if (index)
+        id_index_add (entity, index->ids);
+}
+
+static IDSearchIndex *
+id_index_get (QofBook *book)
+{
+    IDSearchIndex *index = qof_book_get_data (book, GNC_ID_SEARCH_INDEX);
+    const QofIdTypeConst *type;
+
+    if (index && index->dropped == qof_event_get_dropped_count ())
+        return index;
+
+    if (index)
     {
-        qof_query_search_for(q,GNC_CUSTOMER_MODULE_NAME);
-        qof_query_add_term (q, qof_query_build_param_list("CUSTOMER_ID"), string_pred_data, QOF_QUERY_AND);
+        qof_book_set_data (book, GNC_ID_SEARCH_INDEX, NULL);
+        id_index_free (index);
     }
-    else if (type ==  INVOICE || type ==  BILL)
+
+    if (id_index_handler_id == 0)
+        id_index_handler_id =
+            qof_event_register_handler (id_index_handle_events, NULL);
+
+    index = g_new0 (IDSearchIndex, 1);
+    index->ids = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    index->dropped = qof_event_get_dropped_count ();
+
+    for (type = id_index_types; *type; ++type)
+        qof_collection_foreach (qof_book_get_collection (book, *type),
+                                id_index_add, index->ids);
+
+    qof_book_set_data_fin (book, GNC_ID_SEARCH_INDEX, index,
+                           id_index_book_end);
+    return index;
+}
+
+static QofIdTypeConst
+search_id_type (GncSearchType type)
+{
+    switch (type)
     {
-        qof_query_search_for(q,GNC_INVOICE_MODULE_NAME);
-        qof_query_add_term (q, qof_query_build_param_list("INVOICE_ID"), string_pred_data, QOF_QUERY_AND);
+    case CUSTOMER:
+        return GNC_ID_CUSTOMER;
+    case VENDOR:
+        return GNC_ID_VENDOR;
+    case EMPLOYEE:
+        return GNC_ID_EMPLOYEE;
+    case JOB:
+        return GNC_ID_JOB;
+    default:
+        return GNC_ID_INVOICE;
     }
-    else if (type == VENDOR)
+}
+
+static gboolean
+search_match (QofInstance *inst, const gchar *id, GncSearchType type)
+{
+    if (g_strcmp0 (id, instance_id (inst)) != 0)
+        return FALSE;
+
+    switch (type)
     {
-        qof_query_search_for(q,GNC_VENDOR_MODULE_NAME);
-        qof_query_add_term (q, qof_query_build_param_list("VENDOR_ID"), string_pred_data, QOF_QUERY_AND);
+    case CUSTOMER:
+        return GNC_IS_CUSTOMER (inst);
+    case VENDOR:
+        return GNC_IS_VENDOR (inst);
+    case EMPLOYEE:
+        return GNC_IS_EMPLOYEE (inst);
+    case JOB:
+        return GNC_IS_JOB (inst);
+    case INVOICE:
+        return GNC_IS_INVOICE (inst) &&
+            gncInvoiceGetType (GNC_INVOICE (inst)) == GNC_INVOICE_CUST_INVOICE;
+    case BILL:
+        return GNC_IS_INVOICE (inst) &&
+            gncInvoiceGetType (GNC_INVOICE (inst)) == GNC_INVOICE_VEND_INVOICE;
+    default:
+        return FALSE;
     }
+}
 
+/******************************************************************
+ * Generic search called after setting up stuff
+ * DO NOT call directly but type tests should fail anyway
+ ****************************************************************/
+static void * search(QofBook * book, const gchar *id, void * object, GncSearchType type)
+{
+    IDSearchIndex *index;
+    QofCollection *col;
+    GList *node;
 
-    // Run the query
-    result = qof_query_run (q);
+    PINFO("Type = %d", type);
+    g_return_val_if_fail (type, NULL);
+    g_return_val_if_fail (id, NULL);
+    g_return_val_if_fail (book, NULL);
 
-    // now compare _exactly_
-    len = g_list_length (result);
-    if (result && (len > 0))
+    col = qof_book_get_collection (book, search_id_type (type));
+    index = id_index_get (book);
+    for (node = g_hash_table_lookup (index->ids, id); node; node = node->next)
     {
-        result = g_list_first (result);
+        QofInstance *inst = qof_collection_lookup_entity (col, node->data);
 
-        while (result)
+        /* Not found if destroyed, given another ID or of another type */
+        if (inst && search_match (inst, id, type))
         {
-            c = result->data;
-            
-            if (type == CUSTOMER && strcmp(id, gncCustomerGetID(c)) == 0)
-            {
-                // correct id found
-                object = c;
-                break;
-            }
-            else if (type == INVOICE && strcmp(id, gncInvoiceGetID(c)) == 0 
-                        && gncInvoiceGetType(c) == GNC_INVOICE_CUST_INVOICE)
-            {
-                object = c;
-                break;
-            }
-            else if (type == BILL && strcmp(id, gncInvoiceGetID(c)) == 0 
-                        && gncInvoiceGetType(c) == GNC_INVOICE_VEND_INVOICE)
-            {
-                object = c;
-                break;
-            }
-            else if (type == VENDOR && strcmp(id, gncVendorGetID(c)) == 0)
-            {
-                object = c;
-                break;
-            }
-            result = g_list_next (result);
+            object = inst;
+            break;
         }
     }
-    qof_query_destroy (q);
     return object;
 }
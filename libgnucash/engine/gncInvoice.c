@@ -44,8 +44,22 @@
 #include "gncInvoice.h"
 #include "gncInvoiceP.h"
 #include "gncOwnerP.h"
+#include "gncTaxTableP.h"
 #include "engine-helpers.h"
 
+/* The entry totals of an invoice: the sum of their rounded net values
+ * and their tax values per tax account, rounded per account. */
+typedef struct
+{
+    gnc_numeric       net;
+    AccountValueList *taxes;
+} InvoiceTotals;
+
+/* Totals for all entries and, indexed by GncEntryPaymentType, for
+ * those of one bill payment type */
+#define INVOICE_TOTALS_ALL 0
+#define INVOICE_TOTALS_COUNT (GNC_PAYMENT_CARD + 1)
+
 struct _gncInvoice
 {
     QofInstance   inst;
@@ -72,6 +86,15 @@ struct _gncInvoice
     Account       *posted_acc;
     Transaction   *posted_txn;
     GNCLot        *posted_lot;
+
+    /* Cached totals, see invoice_get_totals. They also depend on
+     * things that aren't the invoice's own, which are remembered to
+     * see whether they still hold. */
+    gboolean      totals_dirty;
+    gboolean      totals_is_cust_doc;
+    gboolean      totals_is_cn;
+    guint         totals_taxtable_mods;
+    InvoiceTotals totals[INVOICE_TOTALS_COUNT];
 };
 
 struct _gncInvoiceClass
@@ -100,6 +123,7 @@ static void mark_invoice (GncInvoice *invoice);
 static void
 mark_invoice (GncInvoice *invoice)
 {
+    invoice->totals_dirty = TRUE;
     qof_instance_set_dirty (&invoice->inst);
     qof_event_gen (&invoice->inst, QOF_EVENT_MODIFY, NULL);
 }
@@ -140,6 +164,8 @@ gnc_invoice_init (GncInvoice* inv)
 {
     inv->date_posted = INT64_MAX;
     inv->date_opened = INT64_MAX;
+    /* Nothing is cached until the totals are first computed. */
+    inv->totals_dirty = TRUE;
 }
 
 static void
@@ -331,6 +357,7 @@ GncInvoice *gncInvoiceCreate (QofBook *book)
     invoice->active = TRUE;
 
     invoice->to_charge_amount = gnc_numeric_zero ();
+    invoice->totals_dirty = TRUE;
 
     qof_event_gen (&invoice->inst, QOF_EVENT_CREATE, NULL);
 
@@ -417,6 +444,8 @@ void gncInvoiceDestroy (GncInvoice *invoice)
 
 static void gncInvoiceFree (GncInvoice *invoice)
 {
+    int i;
+
     if (!invoice) return;
 
     qof_event_gen (&invoice->inst, QOF_EVENT_DESTROY, NULL);
@@ -426,6 +455,8 @@ static void gncInvoiceFree (GncInvoice *invoice)
     CACHE_REMOVE (invoice->billing_id);
     g_list_free (invoice->entries);
     g_list_free (invoice->prices);
+    for (i = 0; i < INVOICE_TOTALS_COUNT; i++)
+        gncAccountValueDestroy (invoice->totals[i].taxes);
 
     if (invoice->printname) g_free (invoice->printname);
 
@@ -905,18 +936,84 @@ static gnc_numeric gncInvoiceSumTaxesInternal (AccountValueList *taxes)
     return tt;
 }
 
-static gnc_numeric gncInvoiceGetNetAndTaxesInternal (GncInvoice *invoice, gboolean use_value,
-                                                     AccountValueList **taxes,
-                                                     gboolean use_payment_type,
-                                                     GncEntryPaymentType type)
+void gncInvoiceMarkTotalsDirty (GncInvoice *invoice)
+{
+    if (!invoice) return;
+    invoice->totals_dirty = TRUE;
+}
+
+static void gncInvoiceComputeTotals (GncInvoice *invoice, gboolean is_cust_doc,
+                                     gboolean is_cn)
 {
     GList *node;
-    gnc_numeric net_total = gnc_numeric_zero ();
-    gboolean is_cust_doc, is_cn;
-    AccountValueList *tv_list = NULL;
     int denom = gnc_commodity_get_fraction (gncInvoiceGetCurrency (invoice));
+    int i;
+
+    for (i = 0; i < INVOICE_TOTALS_COUNT; i++)
+    {
+        invoice->totals[i].net = gnc_numeric_zero ();
+        gncAccountValueDestroy (invoice->totals[i].taxes);
+        invoice->totals[i].taxes = NULL;
+    }
 
-    g_return_val_if_fail (invoice, net_total);
+    for (node = gncInvoiceGetEntries (invoice); node; node = node->next)
+    {
+        GncEntry *entry = node->data;
+        GncEntryPaymentType type = gncEntryGetBillPayment (entry);
+        InvoiceTotals *all = &invoice->totals[INVOICE_TOTALS_ALL];
+        InvoiceTotals *of_type = NULL;
+        AccountValueList *entrytaxes;
+        gnc_numeric value;
+
+        if (type == GNC_PAYMENT_CASH || type == GNC_PAYMENT_CARD)
+            of_type = &invoice->totals[type];
+
+        // Always use rounded net values to prevent creating imbalanced transactions on posting
+        // https://bugs.gnucash.org/show_bug.cgi?id=628903
+        value = gncEntryGetDocValue (entry, TRUE, is_cust_doc, is_cn);
+        if (gnc_numeric_check (value) == GNC_ERROR_OK)
+        {
+            all->net = gnc_numeric_add (all->net, value, GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
+            if (of_type)
+                of_type->net = gnc_numeric_add (of_type->net, value, GNC_DENOM_AUTO,
+                                                GNC_HOW_DENOM_LCD);
+        }
+        else
+            g_warning ("bad value in our entry");
+
+        entrytaxes = gncEntryGetDocTaxValues (entry, is_cust_doc, is_cn);
+        all->taxes = gncAccountValueAddList (all->taxes, entrytaxes);
+        if (of_type)
+            of_type->taxes = gncAccountValueAddList (of_type->taxes, entrytaxes);
+        gncAccountValueDestroy (entrytaxes);
+    }
+
+    // Round tax totals (accumulated per tax account) to prevent creating imbalanced transactions on posting
+    // which could otherwise happen when using a tax table with multiple tax rates
+    for (i = 0; i < INVOICE_TOTALS_COUNT; i++)
+    {
+        for (node = invoice->totals[i].taxes; node; node = node->next)
+        {
+            GncAccountValue *acc_val = node->data;
+            acc_val->value = gnc_numeric_convert (acc_val->value,
+                                  denom, GNC_HOW_DENOM_EXACT | GNC_HOW_RND_ROUND_HALF_UP);
+        }
+    }
+}
+
+/* The totals are worked out for all payment types at once and kept
+ * until the invoice or one of its entries is changed (see
+ * gncInvoiceMarkTotalsDirty), a tax table changes, or the document
+ * type they were computed for no longer holds. Returns NULL for an
+ * unknown payment type. */
+static InvoiceTotals *invoice_get_totals (GncInvoice *invoice,
+                                          gboolean use_payment_type,
+                                          GncEntryPaymentType type)
+{
+    gboolean is_cust_doc, is_cn;
+
+    if (use_payment_type && type != GNC_PAYMENT_CASH && type != GNC_PAYMENT_CARD)
+        return NULL;
 
     /* Is the current document an invoice/credit note related to a customer or a vendor/employee ?
      * The GncEntry code needs to know to return the proper entry amounts
@@ -924,49 +1021,49 @@ static gnc_numeric gncInvoiceGetNetAndTaxesInternal (GncInvoice *invoice, gboole
     is_cust_doc = (gncInvoiceGetOwnerType (invoice) == GNC_OWNER_CUSTOMER);
     is_cn = gncInvoiceGetIsCreditNote (invoice);
 
-
-    for (node = gncInvoiceGetEntries (invoice); node; node = node->next)
+    if (invoice->totals_dirty || invoice->totals_is_cust_doc != is_cust_doc
+        || invoice->totals_is_cn != is_cn
+        || invoice->totals_taxtable_mods != gncTaxTableGetModCount ())
     {
-        GncEntry *entry = node->data;
-        gnc_numeric value, tax;
+        gncInvoiceComputeTotals (invoice, is_cust_doc, is_cn);
+        invoice->totals_dirty = FALSE;
+        invoice->totals_is_cust_doc = is_cust_doc;
+        invoice->totals_is_cn = is_cn;
+        invoice->totals_taxtable_mods = gncTaxTableGetModCount ();
+    }
 
-        if (use_payment_type && gncEntryGetBillPayment (entry) != type)
-            continue;
+    return &invoice->totals[use_payment_type ? type : INVOICE_TOTALS_ALL];
+}
 
-        if (use_value)
-        {
-            // Always use rounded net values to prevent creating imbalanced transactions on posting
-            // https://bugs.gnucash.org/show_bug.cgi?id=628903
-            value = gncEntryGetDocValue (entry, TRUE, is_cust_doc, is_cn);
-            if (gnc_numeric_check (value) == GNC_ERROR_OK)
-                net_total = gnc_numeric_add (net_total, value, GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
-            else
-                g_warning ("bad value in our entry");
-        }
+/* The caller owns the list returned in taxes */
+static gnc_numeric gncInvoiceGetNetAndTaxesInternal (GncInvoice *invoice, gboolean use_value,
+                                                     AccountValueList **taxes,
+                                                     gboolean use_payment_type,
+                                                     GncEntryPaymentType type)
+{
+    InvoiceTotals *totals;
+    GList *node;
 
-        if (taxes)
-        {
-            AccountValueList *entrytaxes = gncEntryGetDocTaxValues (entry, is_cust_doc, is_cn);
-            tv_list = gncAccountValueAddList (tv_list, entrytaxes);
-            gncAccountValueDestroy (entrytaxes);
-        }
-    }
+    if (taxes)
+        *taxes = NULL;
+    g_return_val_if_fail (invoice, gnc_numeric_zero ());
+
+    totals = invoice_get_totals (invoice, use_payment_type, type);
+    if (!totals)
+        return gnc_numeric_zero ();
 
     if (taxes)
     {
-        GList *node;
-        // Round tax totals (accumulated per tax account) to prevent creating imbalanced transactions on posting
-        // which could otherwise happen when using a tax table with multiple tax rates
-        for (node = tv_list; node; node=node->next)
+        for (node = totals->taxes; node; node = node->next)
         {
-            GncAccountValue *acc_val = node->data;
-            acc_val->value = gnc_numeric_convert (acc_val->value,
-                                  denom, GNC_HOW_DENOM_EXACT | GNC_HOW_RND_ROUND_HALF_UP);
+            GncAccountValue *acc_val = g_new (GncAccountValue, 1);
+            *acc_val = *(GncAccountValue*)node->data;
+            *taxes = g_list_prepend (*taxes, acc_val);
         }
-        *taxes = tv_list;
+        *taxes = g_list_reverse (*taxes);
     }
 
-    return net_total;
+    return use_value ? totals->net : gnc_numeric_zero ();
 }
 
 static gnc_numeric gncInvoiceGetTotalInternal (GncInvoice *invoice, gboolean use_value,
@@ -45,5 +45,8 @@ void gncInvoiceAttachToLot (GncInvoice *invoice, GNCLot *lot);
 void gncInvoiceDetachFromLot (GNCLot *lot);
 void gncInvoiceAttachToTxn (GncInvoice *invoice, Transaction *txn);
 
+/** Forget the cached totals, for entries to call when they change. */
+void gncInvoiceMarkTotalsDirty (GncInvoice *invoice);
+
 #define gncInvoiceSetGUID(I,G) qof_instance_set_guid(QOF_INSTANCE(I),(G))
 #endif /* GNC_INVOICEP_H_ */
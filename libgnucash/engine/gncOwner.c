@@ -35,6 +35,7 @@
 #include <glib/gi18n.h>
 #include <string.h>		/* for memcpy() */
 #include <qofinstance-p.h>
+#include <qofevent-p.h>
 
 #include "gncCustomerP.h"
 #include "gncEmployeeP.h"
@@ -747,6 +748,152 @@ gncOwnerLotsSortFunc (GNCLot *lotA, GNCLot *lotB)
     return (da > db) - (da < db);
 }
 
+/*********************************************************************/
+/* Owner to lots index                                               */
+
+#define GNC_OWNER_LOT_INDEX "gnc-owner-lot-index"
+
+/* The lots of each end owner in a book, keyed by the owner's instance,
+ * and the number of dropped events when it was built: an event for a
+ * lot changed while events were suspended never reaches us. */
+typedef struct
+{
+    GHashTable *lots;
+    guint dropped;
+} OwnerLotIndex;
+
+static gint owner_lot_index_handler_id = 0;
+
+static void
+free_lot_list (gpointer key, gpointer value, gpointer user_data)
+{
+    g_list_free (value);
+}
+
+static void
+owner_lot_index_free (OwnerLotIndex *index)
+{
+    if (!index) return;
+    g_hash_table_foreach (index->lots, free_lot_list, NULL);
+    g_hash_table_destroy (index->lots);
+    g_free (index);
+}
+
+static void
+owner_lot_index_book_end (QofBook *book, gpointer key, gpointer user_data)
+{
+    owner_lot_index_free (user_data);
+}
+
+static void
+owner_lot_index_invalidate (QofBook *book)
+{
+    OwnerLotIndex *index = qof_book_get_data (book, GNC_OWNER_LOT_INDEX);
+
+    if (!index) return;
+    qof_book_set_data (book, GNC_OWNER_LOT_INDEX, NULL);
+    owner_lot_index_free (index);
+}
+
+/* Any change to a lot can change its owner or its account, an invoice
+ * or job can be given another owner and a destroyed owner's instance
+ * must not be found again, so all of them drop the index. */
+static void
+owner_lot_index_handle_events (QofInstance *entity, QofEventId event_type,
+                               gpointer user_data, gpointer event_data)
+{
+    if (GNC_IS_LOT (entity) || GNC_IS_INVOICE (entity) || GNC_IS_JOB (entity)
+        || GNC_IS_CUSTOMER (entity) || GNC_IS_VENDOR (entity)
+        || GNC_IS_EMPLOYEE (entity))
+        owner_lot_index_invalidate (qof_instance_get_book (entity));
+}
+
+static void
+owner_lot_index_add (QofInstance *ent, gpointer user_data)
+{
+    GHashTable *index = user_data;
+    GNCLot *lot = GNC_LOT (ent);
+    GncInvoice *invoice = gncInvoiceGetInvoiceFromLot (lot);
+    GncOwner lot_owner;
+    const GncOwner *end_owner;
+    gpointer key;
+
+    /* Same owner as gncOwnerLotMatchOwnerFunc finds for the lot */
+    if (invoice)
+        end_owner = gncOwnerGetEndOwner (gncInvoiceGetOwner (invoice));
+    else if (gncOwnerGetOwnerFromLot (lot, &lot_owner))
+        end_owner = gncOwnerGetEndOwner (&lot_owner);
+    else
+        return;
+
+    key = qofOwnerGetOwner (end_owner);
+    if (!key)
+        return;
+
+    /* The table has no value destroy function: replacing a list by its
+     * new head must not free the old one. */
+    g_hash_table_insert (index, key,
+                         g_list_prepend (g_hash_table_lookup (index, key), lot));
+}
+
+static OwnerLotIndex *
+owner_lot_index_get (QofBook *book)
+{
+    OwnerLotIndex *index = qof_book_get_data (book, GNC_OWNER_LOT_INDEX);
+
+    if (index && index->dropped == qof_event_get_dropped_count ())
+        return index;
+
+    owner_lot_index_invalidate (book);
+
+    if (owner_lot_index_handler_id == 0)
+        owner_lot_index_handler_id =
+            qof_event_register_handler (owner_lot_index_handle_events, NULL);
+
+    index = g_new0 (OwnerLotIndex, 1);
+    index->lots = g_hash_table_new (g_direct_hash, g_direct_equal);
+    index->dropped = qof_event_get_dropped_count ();
+
+    qof_collection_foreach (qof_book_get_collection (book, GNC_ID_LOT),
+                            owner_lot_index_add, index->lots);
+
+    qof_book_set_data_fin (book, GNC_OWNER_LOT_INDEX, index,
+                           owner_lot_index_book_end);
+    return index;
+}
+
+LotList *
+gncOwnerGetLots (const GncOwner *owner, const Account *account,
+                 gboolean open_only)
+{
+    QofInstance *inst;
+    OwnerLotIndex *index;
+    GList *lot_node, *retval = NULL;
+
+    inst = qofOwnerGetOwner (owner);
+    if (!inst) return NULL;
+
+    index = owner_lot_index_get (qof_instance_get_book (inst));
+    for (lot_node = g_hash_table_lookup (index->lots, inst); lot_node;
+         lot_node = lot_node->next)
+    {
+        GNCLot *lot = lot_node->data;
+
+        if (account && gnc_lot_get_account (lot) != account)
+            continue;
+        if (open_only && gnc_lot_is_closed (lot))
+            continue;
+
+        /* The key is the instance only, the owner type must match too */
+        if (!gncOwnerLotMatchOwnerFunc (lot, (gpointer)owner))
+            continue;
+
+        retval = g_list_prepend (retval, lot);
+    }
+
+    return g_list_sort (retval, (GCompareFunc)gncOwnerLotsSortFunc);
+}
+
 GNCLot *
 gncOwnerCreatePaymentLotSecs (const GncOwner *owner, Transaction **preset_txn,
                               Account *posted_acc, Account *xfer_acc,
@@ -1428,8 +1575,7 @@ gncOwnerApplyPaymentSecs (const GncOwner *owner, Transaction **preset_txn,
     if (lots)
         selected_lots = lots;
     else if (auto_pay)
-        selected_lots = xaccAccountFindOpenLots (posted_acc, gncOwnerLotMatchOwnerFunc,
-                        (gpointer)owner, NULL);
+        selected_lots = gncOwnerGetLots (owner, posted_acc, TRUE);
 
     /* And link the selected lots and the payment lot together as well as possible.
      * If the payment was bigger than the selected documents/overpayments, only
@@ -1471,6 +1617,149 @@ gncOwnerGetCommoditiesList (const GncOwner *owner)
 /*********************************************************************/
 /* Owner balance calculation routines                                */
 
+/* Work out the open balance of a single owner the slow way, by asking
+ * every suitable account for the owner's open lots. */
+static gnc_numeric
+owner_compute_balance (const GncOwner *owner, QofBook *book)
+{
+    gnc_numeric balance = gnc_numeric_zero ();
+    gnc_commodity *owner_currency = gncOwnerGetCurrency (owner);
+    GList *acct_list  = gnc_account_get_descendants (gnc_book_get_root_account (book));
+    GList *acct_types = gncOwnerGetAccountTypesList (owner);
+    GList *acct_node;
+
+    /* For each account */
+    for (acct_node = acct_list; acct_node; acct_node = acct_node->next)
+    {
+        Account *account = acct_node->data;
+        GList *lot_list = NULL, *lot_node;
+
+        /* Check if this account can have lots for the owner, otherwise skip to next */
+        if (g_list_index (acct_types, (gpointer)xaccAccountGetType (account))
+                == -1)
+            continue;
+
+
+        if (!gnc_commodity_equal (owner_currency, xaccAccountGetCommodity (account)))
+            continue;
+
+        /* Get a list of open lots for this owner and account */
+        lot_list = xaccAccountFindOpenLots (account, gncOwnerLotMatchOwnerFunc,
+                                            (gpointer)owner, NULL);
+        /* For each lot */
+        for (lot_node = lot_list; lot_node; lot_node = lot_node->next)
+        {
+            GNCLot *lot = lot_node->data;
+            gnc_numeric lot_balance = gnc_lot_get_balance (lot);
+            GncInvoice *invoice = gncInvoiceGetInvoiceFromLot(lot);
+            if (invoice)
+            balance = gnc_numeric_add (balance, lot_balance,
+                                        gnc_commodity_get_fraction (owner_currency), GNC_HOW_RND_ROUND_HALF_UP);
+        }
+        g_list_free (lot_list);
+    }
+    g_list_free (acct_list);
+    g_list_free (acct_types);
+
+    return balance;
+}
+
+/* Add the open invoice lots of one account to the balances of their
+ * owners, under the same rules as owner_compute_balance. */
+static void
+accumulate_owner_balances (Account *account, GHashTable *balances)
+{
+    gnc_commodity *acct_commodity = xaccAccountGetCommodity (account);
+    GNCAccountType acct_type = xaccAccountGetType (account);
+    GList *lot_list, *lot_node;
+
+    if (acct_type != ACCT_TYPE_RECEIVABLE && acct_type != ACCT_TYPE_PAYABLE)
+        return;
+
+    lot_list = xaccAccountFindOpenLots (account, NULL, NULL, NULL);
+    for (lot_node = lot_list; lot_node; lot_node = lot_node->next)
+    {
+        GNCLot *lot = lot_node->data;
+        GncInvoice *invoice = gncInvoiceGetInvoiceFromLot (lot);
+        const GncOwner *end_owner;
+        gnc_commodity *owner_currency;
+        GList *acct_types;
+        gnc_numeric *balance;
+        gboolean type_ok;
+
+        /* Only invoice lots count towards the balance */
+        if (!invoice)
+            continue;
+
+        end_owner = gncOwnerGetEndOwner (gncInvoiceGetOwner (invoice));
+        if (!end_owner || !qofOwnerGetOwner (end_owner))
+            continue;
+
+        acct_types = gncOwnerGetAccountTypesList (end_owner);
+        type_ok = (g_list_index (acct_types, (gpointer)acct_type) != -1);
+        g_list_free (acct_types);
+        if (!type_ok)
+            continue;
+
+        owner_currency = gncOwnerGetCurrency (end_owner);
+        if (!gnc_commodity_equal (owner_currency, acct_commodity))
+            continue;
+
+        balance = g_hash_table_lookup (balances, qofOwnerGetOwner (end_owner));
+        if (!balance)
+        {
+            balance = g_new0 (gnc_numeric, 1);
+            *balance = gnc_numeric_zero ();
+            g_hash_table_insert (balances, qofOwnerGetOwner (end_owner), balance);
+        }
+        *balance = gnc_numeric_add (*balance, gnc_lot_get_balance (lot),
+                                    gnc_commodity_get_fraction (owner_currency),
+                                    GNC_HOW_RND_ROUND_HALF_UP);
+    }
+    g_list_free (lot_list);
+}
+
+static void
+set_missing_cached_balance (QofInstance *ent, gpointer user_data)
+{
+    GHashTable *balances = user_data;
+    gnc_numeric zero = gnc_numeric_zero ();
+    gnc_numeric *balance;
+    GncOwner owner;
+
+    qofOwnerSetEntity (&owner, ent);
+    if (gncOwnerGetCachedBalance (&owner))
+        return;
+
+    balance = g_hash_table_lookup (balances, ent);
+    gncOwnerSetCachedBalance (&owner, balance ? balance : &zero);
+}
+
+/* Walking the lots once for one owner costs as much as walking them
+ * once for all of them, so fill in the cached balance of every
+ * customer, vendor and employee that doesn't have one. */
+static void
+cache_owner_balances (QofBook *book)
+{
+    GHashTable *balances = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                                  NULL, g_free);
+    GList *acct_list = gnc_account_get_descendants (gnc_book_get_root_account (book));
+    GList *acct_node;
+
+    for (acct_node = acct_list; acct_node; acct_node = acct_node->next)
+        accumulate_owner_balances (acct_node->data, balances);
+    g_list_free (acct_list);
+
+    qof_collection_foreach (qof_book_get_collection (book, GNC_ID_CUSTOMER),
+                            set_missing_cached_balance, balances);
+    qof_collection_foreach (qof_book_get_collection (book, GNC_ID_VENDOR),
+                            set_missing_cached_balance, balances);
+    qof_collection_foreach (qof_book_get_collection (book, GNC_ID_EMPLOYEE),
+                            set_missing_cached_balance, balances);
+
+    g_hash_table_destroy (balances);
+}
+
 /*
  * Given an owner, extract the open balance from the owner and then
  * convert it to the desired currency.
@@ -1491,51 +1780,27 @@ gncOwnerGetBalanceInCurrency (const GncOwner *owner,
     owner_currency = gncOwnerGetCurrency (owner);
 
     cached_balance = gncOwnerGetCachedBalance (owner);
-    if (cached_balance)
-        balance = *cached_balance;
-    else
+    if (!cached_balance)
     {
         /* No valid cache value found for balance. Let's recalculate */
-        GList *acct_list  = gnc_account_get_descendants (gnc_book_get_root_account (book));
-        GList *acct_types = gncOwnerGetAccountTypesList (owner);
-        GList *acct_node;
-
-        /* For each account */
-        for (acct_node = acct_list; acct_node; acct_node = acct_node->next)
+        switch (gncOwnerGetType (owner))
         {
-            Account *account = acct_node->data;
-            GList *lot_list = NULL, *lot_node;
-
-            /* Check if this account can have lots for the owner, otherwise skip to next */
-            if (g_list_index (acct_types, (gpointer)xaccAccountGetType (account))
-                    == -1)
-                continue;
-
-
-            if (!gnc_commodity_equal (owner_currency, xaccAccountGetCommodity (account)))
-                continue;
-
-            /* Get a list of open lots for this owner and account */
-            lot_list = xaccAccountFindOpenLots (account, gncOwnerLotMatchOwnerFunc,
-                                                (gpointer)owner, NULL);
-            /* For each lot */
-            for (lot_node = lot_list; lot_node; lot_node = lot_node->next)
-            {
-                GNCLot *lot = lot_node->data;
-                gnc_numeric lot_balance = gnc_lot_get_balance (lot);
-                GncInvoice *invoice = gncInvoiceGetInvoiceFromLot(lot);
-                if (invoice)
-                balance = gnc_numeric_add (balance, lot_balance,
-                                            gnc_commodity_get_fraction (owner_currency), GNC_HOW_RND_ROUND_HALF_UP);
-            }
-            g_list_free (lot_list);
+        case GNC_OWNER_CUSTOMER:
+        case GNC_OWNER_VENDOR:
+        case GNC_OWNER_EMPLOYEE:
+            cache_owner_balances (book);
+            cached_balance = gncOwnerGetCachedBalance (owner);
+            break;
+        default:
+            break;
         }
-        g_list_free (acct_list);
-        g_list_free (acct_types);
-
-        gncOwnerSetCachedBalance (owner, &balance);
     }
 
+    if (cached_balance)
+        balance = *cached_balance;
+    else
+        balance = owner_compute_balance (owner, book);
+
     pdb = gnc_pricedb_get_db (book);
 
     if (report_currency)
@@ -192,6 +192,21 @@ gboolean gncOwnerLotMatchOwnerFunc (GNCLot *lot, gpointer user_data);
  */
 gint gncOwnerLotsSortFunc (GNCLot *lotA, GNCLot *lotB);
 
+/** Get the lots for which gncOwnerLotMatchOwnerFunc would return TRUE,
+ * without looking at every lot in the book. If account is not NULL
+ * only the lots in that account are returned, and if open_only is TRUE
+ * closed lots are left out. The lots are sorted with
+ * gncOwnerLotsSortFunc, oldest first.
+ *
+ * The lots are looked up in an index kept with the book, which is
+ * built on first use and dropped whenever a lot, invoice, job or owner
+ * changes.
+ *
+ * @return a list the caller must free with g_list_free.
+ */
+LotList * gncOwnerGetLots (const GncOwner *owner, const Account *account,
+                           gboolean open_only);
+
 /** Get the owner from the lot.  If an owner is found in the lot,
  * fill in "owner" and return TRUE.  Otherwise return FALSE.
  */
@@ -162,10 +162,14 @@ maybe_resort_list (GncTaxTable *table)
     bi->tables = g_list_sort (bi->tables, (GCompareFunc)gncTaxTableCompare);
 }
 
+/* Bumped with every modtime, which only has a resolution of seconds */
+static guint table_mod_count = 0;
+
 static inline void
 mod_table (GncTaxTable *table)
 {
     table->modtime = gnc_time (NULL);
+    table_mod_count++;
 }
 
 static inline void addObj (GncTaxTable *table)
@@ -790,6 +794,11 @@ time64 gncTaxTableLastModifiedSecs (const GncTaxTable *table)
     return table->modtime;
 }
 
+guint gncTaxTableGetModCount (void)
+{
+    return table_mod_count;
+}
+
 gboolean gncTaxTableGetInvisible (const GncTaxTable *table)
 {
     if (!table) return FALSE;
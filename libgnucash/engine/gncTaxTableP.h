@@ -40,6 +40,10 @@ void gncTaxTableMakeInvisible (GncTaxTable *table);
 
 gboolean gncTaxTableGetInvisible (const GncTaxTable *table);
 
+/** The number of times the entries of any tax table have changed.
+ * Anything computed with tax tables is stale once this changes. */
+guint gncTaxTableGetModCount (void);
+
 GncTaxTable* gncTaxTableEntryGetTable( const GncTaxTableEntry* entry );
 
 #define gncTaxTableSetGUID(E,G) qof_instance_set_guid(QOF_INSTANCE(E),(G))
@@ -50,12 +50,25 @@ extern "C"
 #ifdef HAVE_UNISTD_H
 # include <unistd.h>
 #endif
+#ifdef HAVE_GETRANDOM
+# include <sys/random.h>
+#endif
+#include <errno.h>
+#ifndef G_OS_WIN32
+# include <pthread.h>
+#endif
 #include "qof.h"
 
 }
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <array>
 #include <sstream>
 #include <string>
 
@@ -139,13 +152,188 @@ guid_assign (GncGUID & target, gnc::GUID const & source)
     memcpy (&target, &source, sizeof (GncGUID));
 }
 
+/* New GUIDs are cut from a per-thread buffer of random bytes that is
+ * refilled from the system's CSPRNG a few hundred GUIDs at a time,
+ * instead of making one generator call (with current boost, one system
+ * call) per GUID.  Bytes are wiped from the buffer as they're handed
+ * out.  A forked child would hand out the same bytes as its parent, so
+ * a fork handler bumps a generation that the buffer is checked against;
+ * asking getpid() each time would cost a system call per GUID. */
+#define GUID_RANDOM_BUFFER_GUIDS 256
+
+struct GuidRandomBuffer
+{
+    unsigned char bytes[GUID_RANDOM_BUFFER_GUIDS * GUID_DATA_SIZE];
+    size_t used = sizeof (bytes);
+    unsigned int fork_generation = 0;
+};
+
+static std::atomic<unsigned int> guid_fork_generation {0};
+
+#ifndef G_OS_WIN32
+static void
+guid_forked_child (void)
+{
+    guid_fork_generation.fetch_add (1);
+}
+#endif
+
+static void
+guid_watch_forks (void)
+{
+#ifndef G_OS_WIN32
+    static std::once_flag registered;
+    std::call_once (registered, [] {
+        pthread_atfork (nullptr, nullptr, guid_forked_child);
+    });
+#endif
+}
+
+/* Set by guid_set_random_seed for tools that need reproducible
+ * output; NULL, the normal case, means use the system's source. */
+thread_local static std::unique_ptr<std::mt19937_64> guid_seeded_gen;
+thread_local static GuidRandomBuffer guid_buffer;
+
+static void
+guid_random_refill (GuidRandomBuffer& buf)
+{
+    guid_watch_forks ();
+    if (guid_seeded_gen)
+    {
+        for (size_t i = 0; i < sizeof (buf.bytes); i += sizeof (uint64_t))
+        {
+            uint64_t word = (*guid_seeded_gen) ();
+            memcpy (buf.bytes + i, &word, sizeof (word));
+        }
+        buf.used = 0;
+        buf.fork_generation = guid_fork_generation.load ();
+        return;
+    }
+    size_t filled = 0;
+#ifdef HAVE_GETRANDOM
+    while (filled < sizeof (buf.bytes))
+    {
+        auto got = getrandom (buf.bytes + filled, sizeof (buf.bytes) - filled, 0);
+        if (got < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            /* Not in this kernel, say; fall back to random_device. */
+            break;
+        }
+        filled += got;
+    }
+#endif
+    if (filled < sizeof (buf.bytes))
+    {
+        thread_local std::random_device device;
+        for (; filled < sizeof (buf.bytes); filled += sizeof (unsigned int))
+        {
+            unsigned int word = device ();
+            memcpy (buf.bytes + filled, &word,
+                    std::min (sizeof (word), sizeof (buf.bytes) - filled));
+        }
+    }
+    buf.used = 0;
+    buf.fork_generation = guid_fork_generation.load ();
+}
+
+static void
+guid_fill_random (GncGUID *guids, size_t n)
+{
+    auto& buf = guid_buffer;
+
+    if (buf.fork_generation != guid_fork_generation.load ())
+        buf.used = sizeof (buf.bytes);
+    while (n)
+    {
+        if (buf.used == sizeof (buf.bytes))
+            guid_random_refill (buf);
+
+        auto take = std::min (n, (sizeof (buf.bytes) - buf.used) / GUID_DATA_SIZE);
+        memcpy (guids, buf.bytes + buf.used, take * GUID_DATA_SIZE);
+        memset (buf.bytes + buf.used, 0, take * GUID_DATA_SIZE);
+        buf.used += take * GUID_DATA_SIZE;
+
+        /* Mark them as RFC 4122 version 4 (random) UUIDs, like boost's
+         * random_generator does. */
+        for (size_t i = 0; i < take; ++i)
+        {
+            guids[i].reserved[6] = (guids[i].reserved[6] & 0x0F) | 0x40;
+            guids[i].reserved[8] = (guids[i].reserved[8] & 0x3F) | 0x80;
+        }
+        guids += take;
+        n -= take;
+    }
+}
+
+void
+guid_set_random_seed (guint64 seed)
+{
+    guid_seeded_gen.reset (new std::mt19937_64 {seed});
+    /* Drop anything already drawn from the system's source. */
+    guid_buffer.used = sizeof (guid_buffer.bytes);
+}
+
 /*Takes an allocated guid pointer and constructs it in place*/
 void
 guid_replace (GncGUID *guid)
 {
     if (!guid) return;
-    gnc::GUID temp_random {gnc::GUID::create_random ()};
-    guid_assign (*guid, temp_random);
+    guid_fill_random (guid, 1);
+}
+
+void
+guid_replace_many (GncGUID *guids, guint n)
+{
+    if (!guids) return;
+    guid_fill_random (guids, n);
+}
+
+/* Table-driven hex encoding and decoding of the 32 character form. */
+static const char guid_hex_digits[] = "0123456789abcdef";
+
+static constexpr auto guid_hex_values = []
+{
+    std::array<signed char, 256> values {};
+    for (auto& v : values)
+        v = -1;
+    for (int c = '0'; c <= '9'; ++c)
+        values[c] = c - '0';
+    for (int c = 'a'; c <= 'f'; ++c)
+        values[c] = c - 'a' + 10;
+    for (int c = 'A'; c <= 'F'; ++c)
+        values[c] = c - 'A' + 10;
+    return values;
+}();
+
+static void
+guid_encode_hex (const unsigned char *bytes, char *out)
+{
+    for (int i = 0; i < GUID_DATA_SIZE; ++i)
+    {
+        *out++ = guid_hex_digits[bytes[i] >> 4];
+        *out++ = guid_hex_digits[bytes[i] & 0x0F];
+    }
+    *out = '\0';
+}
+
+/* Decode exactly GUID_ENCODING_LENGTH hex digits followed by the end of
+ * the string; anything else is left to boost's more lenient parser. */
+static bool
+guid_decode_hex (const char *str, size_t len, unsigned char *bytes)
+{
+    if (len != GUID_ENCODING_LENGTH)
+        return false;
+    for (int i = 0; i < GUID_DATA_SIZE; ++i)
+    {
+        auto hi = guid_hex_values[static_cast<unsigned char>(str[2 * i])];
+        auto lo = guid_hex_values[static_cast<unsigned char>(str[2 * i + 1])];
+        if (hi < 0 || lo < 0)
+            return false;
+        bytes[i] = (hi << 4) | lo;
+    }
+    return true;
 }
 
 GncGUID *
@@ -165,9 +353,9 @@ gchar *
 guid_to_string (const GncGUID * guid)
 {
     if (!guid) return nullptr;
-    gnc::GUID temp {*guid};
-    auto temp_str = temp.to_string ();
-    return g_strdup (temp_str.c_str ());
+    auto str = static_cast<gchar*>(g_malloc (GUID_ENCODING_LENGTH + 1));
+    guid_encode_hex (guid->reserved, str);
+    return str;
 }
 
 gchar *
@@ -175,13 +363,8 @@ guid_to_string_buff (const GncGUID * guid, gchar *str)
 {
     if (!str || !guid) return NULL;
 
-    gnc::GUID temp {*guid};
-    auto val = temp.to_string ();
-    /*We need to be sure to copy the terminating null character.
-     * The standard guarantees that std::basic_string::c_str ()
-     * returns with a terminating null character, too.*/
-    std::copy (val.c_str (), val.c_str () + val.size () + 1, str);
-    return str + val.size ();
+    guid_encode_hex (guid->reserved, str);
+    return str + GUID_ENCODING_LENGTH;
 }
 
 gboolean
@@ -189,6 +372,13 @@ string_to_guid (const char * str, GncGUID * guid)
 {
     if (!guid || !str) return false;
 
+    GncGUID temp;
+    if (guid_decode_hex (str, strnlen (str, GUID_ENCODING_LENGTH + 1), temp.reserved))
+    {
+        *guid = temp;
+        return true;
+    }
+
     try
     {
         guid_assign (*guid, gnc::GUID::from_string (str));
@@ -318,8 +508,9 @@ namespace gnc
 GUID
 GUID::create_random () noexcept
 {
-    static boost::uuids::random_generator gen;
-    return {gen ()};
+    GncGUID guid;
+    guid_fill_random (&guid, 1);
+    return guid;
 }
 
 GUID::GUID (boost::uuids::uuid const & other) noexcept
@@ -336,17 +527,18 @@ GUID::null_guid () noexcept
 std::string
 GUID::to_string () const noexcept
 {
-    auto const & val = boost::uuids::to_string (implementation);
-    std::string ret;
-    std::for_each (val.begin (), val.end (), [&ret] (char a) {
-        if (a != '-') ret.push_back (a);
-    });
-    return ret;
+    char buf[GUID_ENCODING_LENGTH + 1];
+    guid_encode_hex (implementation.data, buf);
+    return buf;
 }
 
 GUID
 GUID::from_string (std::string const & str)
 {
+    GncGUID guid;
+    if (guid_decode_hex (str.c_str (), str.size (), guid.reserved))
+        return guid;
+
     try
     {
         static boost::uuids::string_generator strgen;
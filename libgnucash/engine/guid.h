@@ -90,6 +90,26 @@ const GncGUID* gnc_value_get_guid (const GValue *value);
  */
 void guid_replace (GncGUID *guid);
 
+/** Generate n new guids at once, for callers creating many objects.
+ *
+ *  @param guids An array of at least n guids, all of which are
+ *  replaced with new values.
+ *
+ *  @param n The number of guids to generate.
+ */
+void guid_replace_many (GncGUID *guids, guint n);
+
+/** Make the guids generated on the calling thread come from a
+ *  pseudo-random sequence started from seed, so that a program that
+ *  creates the same objects in the same order gets the same guids each
+ *  time it runs.  This is only for tools that build reproducible test
+ *  data, like gnc-gen-book: the guids are no longer unique between runs
+ *  with the same seed.
+ *
+ *  @param seed The start of the sequence.
+ */
+void guid_set_random_seed (guint64 seed);
+
 /** Generate a new id.
  *
  * @return guid A data structure containing a copy of a newly constructed GncGUID.
@@ -85,15 +85,42 @@
 #define GNC_KVP_FRAME_TYPE
 
 #include "kvp-value.hpp"
+#include <atomic>
 #include <map>
 #include <string>
 #include <vector>
 #include <cstring>
 #include <algorithm>
 #include <iostream>
+#include <utility>
 using Path = std::vector<std::string>;
 using KvpEntry = std::pair <std::vector <std::string>, KvpValue*>;
 
+/** A path of keys resolved once, typically held in a function-local
+ *  static, so that hot lookups don't build a Path of std::strings on every
+ *  access:
+ *
+ *      static const KvpPath path {{"import-map", "online_id"}};
+ *      auto slot = frame->get_slot (path);
+ *
+ *  The handle only borrows the keys, so they must outlive it; string
+ *  literals are the usual case.
+ */
+class KvpPath
+{
+public:
+    using key_list = std::vector<const char *>;
+
+    KvpPath (key_list && keys) noexcept : m_keys {std::move (keys)} {}
+
+    key_list::const_iterator begin () const noexcept { return m_keys.begin (); }
+    key_list::const_iterator end () const noexcept { return m_keys.end (); }
+    bool empty () const noexcept { return m_keys.empty (); }
+
+private:
+    key_list m_keys;
+};
+
 /** Implements KvpFrame.
  *  It's a struct because QofInstance needs to use the typename to declare a
  *  KvpFrame* member, and QofInstance's API is C until its children are all
@@ -108,6 +135,11 @@ using KvpEntry = std::pair <std::vector <std::string>, KvpValue*>;
  */
 struct KvpFrameImpl
 {
+    /* Slots are kept in a vector sorted by key, which is much lighter than
+     * a tree for the handful of slots a typical frame holds. Keys are
+     * interned in the qof_string_cache. */
+    using map_type = std::vector<std::pair<const char *, KvpValue*>>;
+
     class cstring_comparer
     {
     public:
@@ -117,8 +149,11 @@ struct KvpFrameImpl
 		auto ret = std::strcmp(one, two) < 0;
 		return ret;
 	    }
+	bool operator()(const map_type::value_type & one, const char * two) const
+	    {
+		return std::strcmp(one.first, two) < 0;
+	    }
     };
-    using map_type = std::map<const char *, KvpValue*, cstring_comparer>;
 
     public:
     KvpFrameImpl() noexcept {};
@@ -193,6 +228,13 @@ struct KvpFrameImpl
      */
     KvpValue* get_slot(Path keys) noexcept;
 
+    /** Get the value at the end of a precompiled path or nullptr if it
+     * doesn't exist. Unlike the Path overload this allocates nothing.
+     * @param path: Handle for the path of keys leading to the value.
+     * @return The value at the key or nullptr.
+     */
+    KvpValue* get_slot(KvpPath const & path) const noexcept;
+
     /** The function should be of the form:
      * <anything> func (char const *, KvpValue *, data_type &);
      * Do not pass nullptr as the function.
@@ -226,9 +268,20 @@ struct KvpFrameImpl
     bool empty() const noexcept { return m_valuemap.empty(); }
     friend int compare(const KvpFrameImpl&, const KvpFrameImpl&) noexcept;
 
+    /** A count of the changes made to any frame, which lets values read
+     * from a frame be cached until it moves on. Setting a slot bumps it;
+     * code that attaches or replaces a whole frame must call changed().
+     * Books on other threads bump it too, so it is atomic.
+     */
+    static uint64_t generation() noexcept { return s_generation.load(); }
+    static void changed() noexcept { s_generation.fetch_add(1); }
+
     private:
     map_type m_valuemap;
+    static std::atomic<uint64_t> s_generation;
 
+    map_type::iterator find_slot (const char *) noexcept;
+    map_type::const_iterator find_slot (const char *) const noexcept;
     KvpFrame * get_child_frame_or_nullptr (Path const &) noexcept;
     KvpFrame * get_child_frame_or_create (Path const &) noexcept;
     void flatten_kvp_impl(std::vector <std::string>, std::vector <KvpEntry> &) const noexcept;
@@ -239,14 +292,15 @@ template<typename func_type, typename data_type>
 void KvpFrame::for_each_slot_prefix(std::string const & prefix,
         func_type const & func, data_type & data) const noexcept
 {
-    std::for_each (m_valuemap.begin(), m_valuemap.end(),
-        [&prefix,&func,&data](const KvpFrameImpl::map_type::value_type & a)
-        {
-            /* Testing for prefix matching */
-            if (strncmp(a.first, prefix.c_str(), prefix.size()) == 0)
-                func (&a.first[prefix.size()], a.second, data);
-        }
-    );
+    /* The slots are sorted, so the keys sharing the prefix are contiguous. */
+    auto spot = std::lower_bound (m_valuemap.begin(), m_valuemap.end(),
+                                  prefix.c_str(), cstring_comparer{});
+    for (; spot != m_valuemap.end(); ++spot)
+    {
+        if (strncmp(spot->first, prefix.c_str(), prefix.size()) != 0)
+            break;
+        func (&spot->first[prefix.size()], spot->second, data);
+    }
 }
 
 template <typename func_type>
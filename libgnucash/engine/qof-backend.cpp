@@ -171,6 +171,20 @@ qof_backend_rollback_instance (QofBackend* qof_be, QofInstance* inst)
     ((QofBackend*)qof_be)->rollback(inst);
 }
 
+void
+qof_backend_begin_batch (QofBackend* qof_be)
+{
+    if (qof_be == nullptr) return;
+    qof_be->begin_batch();
+}
+
+gboolean
+qof_backend_commit_batch (QofBackend* qof_be)
+{
+    if (qof_be == nullptr) return TRUE;
+    return qof_be->commit_batch();
+}
+
 gboolean
 qof_load_backend_library (const char *directory, const char* module_name)
 {
@@ -225,6 +225,15 @@ public:
  *    Revert changes in the engine and unlock the backend.
  */
     virtual void rollback(QofInstance*) {}
+/**
+ *    Bracket a batch of commit() calls.  A database backend can use this
+ *    to write the whole batch in one database transaction instead of one
+ *    per instance.  Calls may be nested.  commit_batch returns false,
+ *    having set the error, if the outermost batch couldn't be written:
+ *    none of the instances committed in it were saved.
+ */
+    virtual void begin_batch() {}
+    virtual bool commit_batch() { return true; }
 /**
  *    Synchronizes the engine contents to the backend.
  *    This should done by using version numbers (hack alert -- the engine
@@ -43,64 +43,99 @@ static QofLogModule log_module = QOF_MOD_UTIL;
 /* =================================================================== */
 /* The QOF string cache                                                */
 /*                                                                     */
-/* The cache is a GHashTable where a copy of the string is the key,    */
-/* and a ref count is the value                                        */
+/* The cache is split into shards chosen by the string's hash. Each    */
+/* shard is a GHashTable where a copy of the string is the key, and a  */
+/* ref count is the value, guarded by a reader-writer lock. Finding a  */
+/* string that is already cached only takes the read lock and bumps    */
+/* the count atomically, so threads interning common strings don't     */
+/* serialize; the write lock is taken only to add or drop a string.    */
 /* =================================================================== */
 
-static GHashTable* qof_string_cache = NULL;
+#define QOF_STRING_CACHE_SHARDS 16
 
+struct StringCacheShard
+{
+    GRWLock lock;
+    GHashTable *table;
+};
+
+/* Static GRWLocks need no initialization. */
+static StringCacheShard qof_string_cache[QOF_STRING_CACHE_SHARDS];
+
+static StringCacheShard*
+string_cache_shard (const char * key)
+{
+    return &qof_string_cache[g_str_hash (key) % QOF_STRING_CACHE_SHARDS];
+}
+
+/* Call with the shard's write lock held. */
 static GHashTable*
-qof_get_string_cache(void)
+string_cache_shard_table (StringCacheShard *shard)
 {
-    if (!qof_string_cache)
+    if (!shard->table)
     {
-        qof_string_cache = g_hash_table_new_full(
-                               g_str_hash,               /* hash_func          */
-                               g_str_equal,              /* key_equal_func     */
-                               g_free,                   /* key_destroy_func   */
-                               g_free);                  /* value_destroy_func */
+        shard->table = g_hash_table_new_full(
+                           g_str_hash,               /* hash_func          */
+                           g_str_equal,              /* key_equal_func     */
+                           g_free,                   /* key_destroy_func   */
+                           g_free);                  /* value_destroy_func */
     }
-    return qof_string_cache;
+    return shard->table;
 }
 
 void
 qof_string_cache_init(void)
 {
-    (void)qof_get_string_cache();
+    for (auto& shard : qof_string_cache)
+    {
+        g_rw_lock_writer_lock (&shard.lock);
+        (void)string_cache_shard_table (&shard);
+        g_rw_lock_writer_unlock (&shard.lock);
+    }
 }
 
 void
 qof_string_cache_destroy (void)
 {
-    if (qof_string_cache)
+    for (auto& shard : qof_string_cache)
     {
-        g_hash_table_destroy(qof_string_cache);
+        g_rw_lock_writer_lock (&shard.lock);
+        if (shard.table)
+            g_hash_table_destroy (shard.table);
+        shard.table = NULL;
+        g_rw_lock_writer_unlock (&shard.lock);
     }
-    qof_string_cache = NULL;
 }
 
-/* If the key exists in the cache, check the refcount.  If 1, just
- * remove the key.  Otherwise, decrement the refcount */
+/* If the key exists in the cache, decrement the refcount. If that was
+ * the last reference, remove the key. */
 void
 qof_string_cache_remove(const char * key)
 {
     if (key)
     {
-        GHashTable* cache = qof_get_string_cache();
+        auto shard = string_cache_shard (key);
         gpointer value;
         gpointer cache_key;
-        if (g_hash_table_lookup_extended(cache, key, &cache_key, &value))
-        {
-            guint* refcount = (guint*)value;
-            if (*refcount == 1)
-            {
-                g_hash_table_remove(cache, key);
-            }
-            else
-            {
-                --(*refcount);
-            }
-        }
+        gboolean last = FALSE;
+
+        g_rw_lock_reader_lock (&shard->lock);
+        if (shard->table &&
+            g_hash_table_lookup_extended(shard->table, key, &cache_key, &value))
+            last = g_atomic_int_dec_and_test (static_cast<gint*>(value));
+        g_rw_lock_reader_unlock (&shard->lock);
+
+        if (!last)
+            return;
+
+        /* Someone may have picked the string up again between the two
+         * locks; only drop it if it is still unreferenced. */
+        g_rw_lock_writer_lock (&shard->lock);
+        if (shard->table &&
+            g_hash_table_lookup_extended(shard->table, key, &cache_key, &value) &&
+            g_atomic_int_get (static_cast<gint*>(value)) == 0)
+            g_hash_table_remove(shard->table, key);
+        g_rw_lock_writer_unlock (&shard->lock);
     }
 }
 
@@ -111,23 +146,37 @@ qof_string_cache_insert(const char * key)
 {
     if (key)
     {
-        GHashTable* cache = qof_get_string_cache();
+        auto shard = string_cache_shard (key);
         gpointer value;
         gpointer cache_key;
-        if (g_hash_table_lookup_extended(cache, key, &cache_key, &value))
+
+        g_rw_lock_reader_lock (&shard->lock);
+        if (shard->table &&
+            g_hash_table_lookup_extended(shard->table, key, &cache_key, &value))
         {
-            guint* refcount = (guint*)value;
-            ++(*refcount);
+            g_atomic_int_inc (static_cast<gint*>(value));
+            g_rw_lock_reader_unlock (&shard->lock);
             return static_cast <char *> (cache_key);
         }
+        g_rw_lock_reader_unlock (&shard->lock);
+
+        /* Not there: look again under the write lock, since another
+         * thread may have added it in the meantime. */
+        g_rw_lock_writer_lock (&shard->lock);
+        auto cache = string_cache_shard_table (shard);
+        if (g_hash_table_lookup_extended(cache, key, &cache_key, &value))
+        {
+            g_atomic_int_inc (static_cast<gint*>(value));
+        }
         else
         {
-            gpointer new_key = g_strdup(static_cast<const char*>(key));
-            guint* refcount = static_cast<unsigned int*>(g_malloc(sizeof(guint)));
+            cache_key = g_strdup(static_cast<const char*>(key));
+            gint* refcount = g_new (gint, 1);
             *refcount = 1;
-            g_hash_table_insert(cache, new_key, refcount);
-            return static_cast <char *> (new_key);
+            g_hash_table_insert(cache, cache_key, refcount);
         }
+        g_rw_lock_writer_unlock (&shard->lock);
+        return static_cast <char *> (cache_key);
     }
     return NULL;
 }
@@ -139,4 +188,31 @@ qof_string_cache_replace(char const * dst, char const * src)
     qof_string_cache_remove (dst);
     return tmp;
 }
+
+void
+qof_string_cache_get_usage(guint64 *count, guint64 *bytes)
+{
+    g_return_if_fail (count && bytes);
+    *count = *bytes = 0;
+    for (auto& shard : qof_string_cache)
+    {
+        GHashTableIter iter;
+        gpointer key;
+
+        g_rw_lock_reader_lock (&shard.lock);
+        if (shard.table)
+        {
+            g_hash_table_iter_init (&iter, shard.table);
+            while (g_hash_table_iter_next (&iter, &key, nullptr))
+            {
+                /* The string, its reference count and its table entry */
+                *bytes += strlen (static_cast<const char*>(key)) + 1 +
+                    sizeof (gint) + 2 * sizeof (gpointer) + sizeof (guint);
+                ++*count;
+            }
+        }
+        g_rw_lock_reader_unlock (&shard.lock);
+    }
+}
+
 /* ************************ END OF FILE ***************************** */
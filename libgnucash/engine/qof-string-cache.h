@@ -66,7 +66,9 @@ extern "C"
  * Note that all the work is done when inserting or removing.  Once
  * cached the strings are just plain C strings.
  *
- * The string cache is demand-created on first use.
+ * The string cache is demand-created on first use. Inserting and
+ * removing strings is safe from several threads at once; creating
+ * and destroying the cache is not.
  *
  **/
 
@@ -90,6 +92,11 @@ char * qof_string_cache_insert(const char * key);
  */
 char * qof_string_cache_replace(const char * dst, const char * src);
 
+/** Sets *count to the number of strings in the cache and *bytes to an
+    estimate of the memory they and the cache's tables take.
+*/
+void qof_string_cache_get_usage(guint64 *count, guint64 *bytes);
+
 #define CACHE_INSERT(str) qof_string_cache_insert((str))
 #define CACHE_REMOVE(str) qof_string_cache_remove((str))
 
@@ -88,6 +88,9 @@ extern "C++" {
 #include "qofquery.h"
 #include "qofquerycore.h"
 #include "qofsession.h"
+#include "qofstats.h"
+#include "qoftrace.h"
+#include "qofmemory.h"
 #include "qofchoice.h"
 #include "qof-string-cache.h"
 
@@ -137,6 +137,8 @@ typedef struct QofBackend QofBackend;
 /* Temporary wrapper so that we don't have to expose qof-backend.hpp to Transaction.c */
     gboolean qof_backend_can_rollback (QofBackend*);
     void qof_backend_rollback_instance (QofBackend*, QofInstance*);
+    void qof_backend_begin_batch (QofBackend*);
+    gboolean qof_backend_commit_batch (QofBackend*);
 
 /** \brief Load a QOF-compatible backend shared library.
 
@@ -59,6 +59,12 @@ void qof_book_set_backend (QofBook *book, QofBackend *be);
 /* Register books with the engine */
 gboolean qof_book_register (void);
 
+/** Add or remove an instance from the book's set of dirty instances.
+ *    Called by QofInstance whenever its dirty flag changes; nobody else
+ *    should need to call this. */
+void qof_book_track_dirty_instance (QofBook *book, QofInstance *inst,
+                                    gboolean dirty);
+
 /** @deprecated use qof_instance_set_guid instead but only in
 backends (when reading the GncGUID from the data source). */
 #define qof_book_set_guid(book,guid)    \
@@ -136,13 +136,17 @@ qof_book_init (QofBook *book)
 
     book->data_tables = g_hash_table_new (g_str_hash, g_str_equal);
     book->data_table_finalizers = g_hash_table_new (g_str_hash, g_str_equal);
+    book->dirty_instances = g_hash_table_new (g_direct_hash, g_direct_equal);
 
     book->book_open = 'y';
     book->read_only = FALSE;
     book->session_dirty = FALSE;
     book->version = 0;
+    book->epoch = 0;
+    book->frozen = FALSE;
     book->cached_num_field_source_isvalid = FALSE;
     book->cached_num_days_autoreadonly_isvalid = FALSE;
+    book->cached_autoreadonly_time_isvalid = FALSE;
 
     // Register a callback on this NUM_FIELD_SOURCE property of that object
     // because it gets called quite a lot, so that its value must be stored in
@@ -419,6 +423,7 @@ void
 qof_book_destroy (QofBook *book)
 {
     GHashTable* cols;
+    GHashTable* dirty;
 
     if (!book) return;
     ENTER ("book=%p", book);
@@ -446,9 +451,11 @@ qof_book_destroy (QofBook *book)
      * been destroyed.
      */
     cols = book->hash_of_collections;
+    dirty = book->dirty_instances;
     g_object_unref (book);
     g_hash_table_destroy (cols);
     /*book->hash_of_collections = NULL;*/
+    g_hash_table_destroy (dirty);
 
     LEAVE ("book=%p", book);
 }
@@ -481,6 +488,8 @@ qof_book_mark_session_saved (QofBook *book)
 void qof_book_mark_session_dirty (QofBook *book)
 {
     if (!book) return;
+    if (!book->frozen)
+        ++book->epoch;
     if (!book->session_dirty)
     {
         /* Set the session dirty upfront, because the callback will check. */
@@ -496,8 +505,8 @@ qof_book_print_dirty (const QofBook *book)
 {
     if (qof_book_session_not_saved(book))
         PINFO("book is dirty.");
-    qof_book_foreach_collection
-    (book, (QofCollectionForeachCB)qof_collection_print_dirty, NULL);
+    qof_book_foreach_dirty_instance
+    (book, (QofInstanceForeachCB)qof_instance_print_dirty, NULL);
 }
 
 time64
@@ -506,6 +515,47 @@ qof_book_get_session_dirty_time (const QofBook *book)
     return book->dirty_time;
 }
 
+void
+qof_book_track_dirty_instance (QofBook *book, QofInstance *inst,
+                               gboolean dirty)
+{
+    if (!book || !inst || !book->dirty_instances) return;
+    /* Instances torn down with the book have nothing left to save. */
+    if (book->shutting_down) return;
+    if (dirty)
+        g_hash_table_add (book->dirty_instances, inst);
+    else
+        g_hash_table_remove (book->dirty_instances, inst);
+}
+
+void
+qof_book_foreach_dirty_instance (const QofBook *book,
+                                 QofInstanceForeachCB cb, gpointer user_data)
+{
+    GList *list, *node;
+
+    g_return_if_fail (book);
+    g_return_if_fail (cb);
+    if (!book->dirty_instances) return;
+
+    /* Walk a snapshot so the callback can clean or destroy instances;
+     * anything removed from the set since is skipped. */
+    list = g_hash_table_get_keys (book->dirty_instances);
+    for (node = list; node; node = node->next)
+    {
+        if (g_hash_table_contains (book->dirty_instances, node->data))
+            cb (QOF_INSTANCE (node->data), user_data);
+    }
+    g_list_free (list);
+}
+
+guint
+qof_book_count_dirty_instances (const QofBook *book)
+{
+    if (!book || !book->dirty_instances) return 0;
+    return g_hash_table_size (book->dirty_instances);
+}
+
 void
 qof_book_set_dirty_cb(QofBook *book, QofBookDirtyCB cb, gpointer user_data)
 {
@@ -590,6 +640,29 @@ qof_book_mark_readonly(QofBook *book)
     book->read_only = TRUE;
 }
 
+guint64
+qof_book_get_epoch (const QofBook *book)
+{
+    g_return_val_if_fail (book != NULL, 0);
+    return book->epoch;
+}
+
+void
+qof_book_mark_frozen (QofBook *book, guint64 epoch)
+{
+    g_return_if_fail (book != NULL);
+    book->read_only = TRUE;
+    book->frozen = TRUE;
+    book->epoch = epoch;
+}
+
+gboolean
+qof_book_is_frozen (const QofBook *book)
+{
+    if (!book) return FALSE;
+    return book->frozen;
+}
+
 gboolean
 qof_book_empty(const QofBook *book)
 {
@@ -1125,6 +1198,34 @@ GDate* qof_book_get_autoreadonly_gdate (const QofBook *book)
     return result;
 }
 
+/* g_date_get_julian() of 1970-01-01 */
+#define EPOCH_JULIAN 719163
+
+time64 qof_book_get_autoreadonly_time (const QofBook *book)
+{
+    time64 now = gnc_time (NULL);
+
+    g_assert(book);
+    if (!book->cached_autoreadonly_time_isvalid ||
+        now > book->cached_autoreadonly_expiry)
+    {
+        auto mbook = const_cast<QofBook*>(book);
+        GDate *date = qof_book_get_autoreadonly_gdate (book);
+
+        if (date)
+        {
+            mbook->cached_autoreadonly_time =
+                (static_cast<time64>(g_date_get_julian (date)) - EPOCH_JULIAN) * 86400;
+            g_date_free (date);
+        }
+        else
+            mbook->cached_autoreadonly_time = INT64_MIN;
+        mbook->cached_autoreadonly_expiry = gnc_time64_get_day_end (now);
+        mbook->cached_autoreadonly_time_isvalid = TRUE;
+    }
+    return book->cached_autoreadonly_time;
+}
+
 // The callback that is called when the KVP option value of
 // "autoreadonly-days" changes, so that we mark the cached value as
 // invalid.
@@ -1136,6 +1237,7 @@ qof_book_option_num_autoreadonly_changed_cb (GObject *gobject,
     QofBook *book = reinterpret_cast<QofBook*>(user_data);
     g_return_if_fail(QOF_IS_BOOK(book));
     book->cached_num_days_autoreadonly_isvalid = FALSE;
+    book->cached_autoreadonly_time_isvalid = FALSE;
 }
 
 /* Note: this will fail if the book slots we're looking for here are flattened at some point !
@@ -1226,8 +1328,9 @@ qof_book_get_features (QofBook *book)
     KvpFrame *frame = qof_instance_get_slots (QOF_INSTANCE (book));
     GHashTable *features = g_hash_table_new_full (g_str_hash, g_str_equal,
                                                   NULL, g_free);
+    static const KvpPath features_path {{GNC_FEATURES}};
 
-    auto slot = frame->get_slot({GNC_FEATURES});
+    auto slot = frame->get_slot(features_path);
     if (slot != nullptr)
     {
         frame = slot->get<KvpFrame*>();
@@ -1241,11 +1344,12 @@ qof_book_set_feature (QofBook *book, const gchar *key, const gchar *descr)
 {
     KvpFrame *frame = qof_instance_get_slots (QOF_INSTANCE (book));
     KvpValue* feature = nullptr;
-    auto feature_slot = frame->get_slot({GNC_FEATURES});
+    static const KvpPath features_path {{GNC_FEATURES}};
+    auto feature_slot = frame->get_slot(features_path);
     if (feature_slot)
     {
         auto feature_frame = feature_slot->get<KvpFrame*>();
-        feature = feature_frame->get_slot({key});
+        feature = feature_frame->get_slot(KvpPath {{key}});
     }
     if (feature == nullptr || g_strcmp0 (feature->get<const char*>(), descr))
     {
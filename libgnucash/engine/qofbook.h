@@ -162,6 +162,27 @@ struct _QofBook
     gint cached_num_days_autoreadonly;
     /* Whether the above cached value is valid. */
     gboolean cached_num_days_autoreadonly_isvalid;
+
+    /* The time64 form of the auto-read-only threshold date, which
+     * depends on today's date as well as the option, and the time
+     * after which today is over and it has to be worked out again. */
+    time64 cached_autoreadonly_time;
+    time64 cached_autoreadonly_expiry;
+    /* Whether the above cached values are valid. */
+    gboolean cached_autoreadonly_time_isvalid;
+
+    /* The set of instances in this book whose dirty flag is set, so
+     * that savers don't have to scan every collection to find them. */
+    GHashTable *dirty_instances;
+
+    /* Counts the commits that changed the book, so that a copy can
+     * tell whether it is still up to date.  A frozen book keeps the
+     * epoch of the book it was copied from. */
+    guint64 epoch;
+
+    /* A frozen book is a read-only copy that another thread may be
+     * reading; it never runs the event handlers. */
+    gboolean frozen;
 };
 
 struct _QofBookClass
@@ -259,6 +280,18 @@ gboolean qof_book_is_readonly(const QofBook *book);
 /** Mark the book as read only. */
 void qof_book_mark_readonly(QofBook *book);
 
+/** The number of commits that have changed the book.  For a frozen
+ *  book, the epoch of the book it was copied from. */
+guint64 qof_book_get_epoch (const QofBook *book);
+
+/** Mark the book, a copy of another book made at epoch, as frozen:
+ *  read only, and never running the event handlers, so that it can be
+ *  read by a thread other than the one owning the handlers. */
+void qof_book_mark_frozen (QofBook *book, guint64 epoch);
+
+/** Return whether the book is frozen. */
+gboolean qof_book_is_frozen (const QofBook *book);
+
 /** Check if the book has had anything loaded into it. */
 gboolean qof_book_empty(const QofBook *book);
 
@@ -307,6 +340,15 @@ gint qof_book_get_num_days_autoreadonly (const QofBook *book);
  * g_date_free() the object afterwards. */
 GDate* qof_book_get_autoreadonly_gdate (const QofBook *book);
 
+/** Returns the threshold for auto-read-only as a time64: midnight UTC
+ * at the start of the date returned by qof_book_get_autoreadonly_gdate(),
+ * so that a txn whose posted date (a neutral time on its posted day) is
+ * lesser than it should be considered read-only.
+ *
+ * The value is cached until the option changes or the day is over. If
+ * the auto-read-only feature is not used INT64_MIN is returned. */
+time64 qof_book_get_autoreadonly_time (const QofBook *book);
+
 /** Returns TRUE if this book uses split action field as the 'Num' field, FALSE
  *  if it uses transaction number field */
 gboolean qof_book_use_split_action_for_num_field (const QofBook *book);
@@ -342,6 +384,22 @@ void qof_book_mark_session_dirty(QofBook *book);
 /** Retrieve the earliest modification time on the book. */
 time64 qof_book_get_session_dirty_time(const QofBook *book);
 
+/** Invoke the callback on every instance in the book that is marked
+ *    dirty, in no particular order.  The callback may mark the instance
+ *    clean or destroy it; instances dirtied during the walk are not
+ *    visited.
+ *
+ *    It is meant for a backend that saves only what changed.  None does
+ *    yet: the XML backend rewrites the whole file on every save, and the
+ *    SQL backend writes each instance as it is committed, so its sync
+ *    is only used to fill a new database. */
+void qof_book_foreach_dirty_instance (const QofBook *book,
+                                      QofInstanceForeachCB cb,
+                                      gpointer user_data);
+
+/** Return the number of instances in the book that are marked dirty. */
+guint qof_book_count_dirty_instances (const QofBook *book);
+
 /** Set the function to call when a book transitions from clean to
  *    dirty, or vice versa.
  */
@@ -37,6 +37,11 @@ void qof_class_shutdown (void);
 
 QofSortFunc qof_class_get_default_sort (QofIdTypeConst obj_name);
 
+/** Counter bumped whenever a class is registered or the registry is
+ *  shut down; lets callers caching QofParam pointers notice that the
+ *  registry changed underneath them. */
+guint qof_class_get_generation (void);
+
 /* @} */
 /* @} */
 /* @} */
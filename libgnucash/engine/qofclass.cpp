@@ -32,6 +32,7 @@ static QofLogModule log_module = QOF_MOD_CLASS;
 static GHashTable *classTable = NULL;
 static GHashTable *sortTable = NULL;
 static gboolean initialized = FALSE;
+static guint class_generation = 0;
 
 static gboolean clear_table (gpointer key, gpointer value, gpointer user_data)
 {
@@ -65,6 +66,7 @@ qof_class_shutdown (void)
 {
     if (!initialized) return;
     initialized = FALSE;
+    class_generation++;
 
     g_hash_table_foreach_remove (classTable, clear_table, NULL);
     g_hash_table_destroy (classTable);
@@ -79,6 +81,12 @@ qof_class_get_default_sort (QofIdTypeConst obj_name)
 							      obj_name));
 }
 
+guint
+qof_class_get_generation (void)
+{
+    return class_generation;
+}
+
 /* *******************************************************************/
 /* PUBLISHED API FUNCTIONS */
 
@@ -93,6 +101,7 @@ qof_class_register (QofIdTypeConst obj_name,
     if (!obj_name) return;
     if (!check_init()) return;
 
+    class_generation++;
     if (default_sort_function)
     {
         g_hash_table_insert (sortTable, (char *)obj_name,
@@ -27,16 +27,36 @@
 #include "qofevent.h"
 #include "qofid.h"
 
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
 /* for backwards compatibility - to be moved back to qofevent.c in libqof2 */
 typedef struct
 {
     QofEventHandler handler;
+    QofEventBatchHandler batch_handler;
     gpointer user_data;
 
+    /* Set for handlers registered with a filter; they live in the
+     * per-type table as well as the handler list. */
+    QofIdTypeConst entity_type;
+    QofEventId event_mask;
+
     gint handler_id;
 } HandlerInfo;
 
 /* generates an event even when events are suspended! */
 void qof_event_force (QofInstance *entity, QofEventId event_id, gpointer event_data);
 
+/* The number of events dropped so far because events were suspended;
+ * anything caching state from events has to start over when it
+ * changes. */
+guint qof_event_get_dropped_count (void);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
@@ -28,16 +28,33 @@
 #include "qof.h"
 #include "qofevent-p.h"
 
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 /* Static Variables ************************************************/
 static guint   suspend_counter   = 0;
 static gint    next_handler_id   = 1;
 static guint   handler_run_level = 0;
 static guint   pending_deletes   = 0;
+static guint   dropped_events    = 0;
+static guint   batch_handlers    = 0;
 static GList   *handlers  =   NULL;
+/* Filtered handlers by entity type, each a GList of HandlerInfo* that
+ * are also in handlers, which owns them. */
+static GHashTable *typed_handlers = NULL;
+
+/* Events queued for the batch handlers while events are suspended, and
+ * for each entity the mask of event ids already in the queue. */
+static std::vector<QofEventBatchItem> queued_events;
+static std::unordered_map<QofInstance*, QofEventId> queued_masks;
 
 /* This static indicates the debugging module that this .o belongs to.  */
 static QofLogModule log_module = QOF_MOD_ENGINE;
 
+static QofStat *dispatch_stat;
+static QofStat *handler_calls_stat;
+
 /* Implementations *************************************************/
 
 static gint
@@ -69,10 +86,33 @@ find_next_handler_id(void)
     return handler_id;
 }
 
+static gint
+register_handler_info (QofEventHandler handler,
+                       QofEventBatchHandler batch_handler, gpointer user_data)
+{
+    HandlerInfo *hi;
+    gint handler_id;
+
+    /* look for a free handler id */
+    handler_id = find_next_handler_id();
+
+    /* Found one, add the handler */
+    hi = g_new0 (HandlerInfo, 1);
+
+    hi->handler = handler;
+    hi->batch_handler = batch_handler;
+    hi->user_data = user_data;
+    hi->handler_id = handler_id;
+
+    if (batch_handler)
+        batch_handlers++;
+    handlers = g_list_prepend (handlers, hi);
+    return handler_id;
+}
+
 gint
 qof_event_register_handler (QofEventHandler handler, gpointer user_data)
 {
-    HandlerInfo *hi;
     gint handler_id;
 
     ENTER ("(handler=%p, data=%p)", handler, user_data);
@@ -84,21 +124,83 @@ qof_event_register_handler (QofEventHandler handler, gpointer user_data)
         return 0;
     }
 
-    /* look for a free handler id */
-    handler_id = find_next_handler_id();
+    handler_id = register_handler_info (handler, NULL, user_data);
+    LEAVE ("(handler=%p, data=%p) handler_id=%d", handler, user_data, handler_id);
+    return handler_id;
+}
 
-    /* Found one, add the handler */
-    hi = g_new0 (HandlerInfo, 1);
+gint
+qof_event_register_handler_filtered (QofEventHandler handler,
+                                     gpointer user_data,
+                                     QofIdTypeConst entity_type,
+                                     QofEventId event_mask)
+{
+    HandlerInfo *hi;
+    gint handler_id;
+    GList *list;
 
-    hi->handler = handler;
-    hi->user_data = user_data;
-    hi->handler_id = handler_id;
+    ENTER ("(handler=%p, data=%p, type=%s, mask=%x)", handler, user_data,
+           entity_type ? entity_type : "(null)", event_mask);
+
+    /* sanity check */
+    if (!handler || !entity_type)
+    {
+        PERR ("no handler or entity type specified");
+        return 0;
+    }
+
+    handler_id = register_handler_info (handler, NULL, user_data);
+    hi = static_cast<HandlerInfo*>(handlers->data);
+    hi->entity_type = static_cast<QofIdTypeConst>(qof_string_cache_insert (entity_type));
+    hi->event_mask = event_mask;
+
+    if (!typed_handlers)
+        typed_handlers = g_hash_table_new (g_str_hash, g_str_equal);
+    list = static_cast<GList*>(g_hash_table_lookup (typed_handlers, hi->entity_type));
+    g_hash_table_insert (typed_handlers, (gpointer)hi->entity_type,
+                         g_list_prepend (list, hi));
 
-    handlers = g_list_prepend (handlers, hi);
     LEAVE ("(handler=%p, data=%p) handler_id=%d", handler, user_data, handler_id);
     return handler_id;
 }
 
+gint
+qof_event_register_batch_handler (QofEventBatchHandler handler,
+                                  gpointer user_data)
+{
+    gint handler_id;
+
+    ENTER ("(handler=%p, data=%p)", handler, user_data);
+
+    /* sanity check */
+    if (!handler)
+    {
+        PERR ("no handler specified");
+        return 0;
+    }
+
+    handler_id = register_handler_info (NULL, handler, user_data);
+    LEAVE ("(handler=%p, data=%p) handler_id=%d", handler, user_data, handler_id);
+    return handler_id;
+}
+
+static void
+free_handler_info (HandlerInfo *hi)
+{
+    if (hi->entity_type)
+    {
+        auto list = static_cast<GList*>(g_hash_table_lookup (typed_handlers,
+                                                             hi->entity_type));
+        list = g_list_remove (list, hi);
+        if (list)
+            g_hash_table_insert (typed_handlers, (gpointer)hi->entity_type, list);
+        else
+            g_hash_table_remove (typed_handlers, hi->entity_type);
+        qof_string_cache_remove (hi->entity_type);
+    }
+    g_free (hi);
+}
+
 void
 qof_event_unregister_handler (gint handler_id)
 {
@@ -117,18 +219,22 @@ qof_event_unregister_handler (gint handler_id)
            of a generated event, such as QOF_EVENT_DESTROY.  In that case,
            we're in the middle of walking the GList and it is wrong to
            modify the list. So, instead, we just NULL the handler. */
-        if (hi->handler)
+        if (hi->handler || hi->batch_handler)
             LEAVE ("(handler_id=%d) handler=%p data=%p", handler_id,
-                   hi->handler, hi->user_data);
+                   hi->handler ? (gpointer)hi->handler : (gpointer)hi->batch_handler,
+                   hi->user_data);
 
         /* safety -- clear the handler in case we're running events now */
+        if (hi->batch_handler)
+            batch_handlers--;
         hi->handler = NULL;
+        hi->batch_handler = NULL;
 
         if (handler_run_level == 0)
         {
             handlers = g_list_remove_link (handlers, node);
             g_list_free_1 (node);
-            g_free (hi);
+            free_handler_info (hi);
         }
         else
         {
@@ -141,6 +247,56 @@ qof_event_unregister_handler (gint handler_id)
     PERR ("no such handler: %d", handler_id);
 }
 
+/* If we're the outermost event runner and we have pending deletes
+ * then go delete the handlers now.
+ */
+static void
+purge_pending_deletes (void)
+{
+    GList *node;
+    GList *next_node = NULL;
+
+    if (handler_run_level != 0 || !pending_deletes)
+        return;
+
+    for (node = handlers; node; node = next_node)
+    {
+        HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
+        next_node = node->next;
+        if (hi->handler == NULL && hi->batch_handler == NULL)
+        {
+            /* remove this node from the list, then free this node */
+            handlers = g_list_remove_link (handlers, node);
+            g_list_free_1 (node);
+            free_handler_info (hi);
+        }
+    }
+    pending_deletes = 0;
+}
+
+static void
+deliver_batch (const QofEventBatchItem *events, guint n_events)
+{
+    GList *node;
+    GList *next_node = NULL;
+
+    handler_run_level++;
+    for (node = handlers; node; node = next_node)
+    {
+        HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
+
+        next_node = node->next;
+        if (hi->batch_handler)
+        {
+            PINFO("id=%d hi=%p han=%p events=%u", hi->handler_id, hi,
+                  hi->batch_handler, n_events);
+            hi->batch_handler (events, n_events, hi->user_data);
+        }
+    }
+    handler_run_level--;
+    purge_pending_deletes ();
+}
+
 void
 qof_event_suspend (void)
 {
@@ -152,6 +308,12 @@ qof_event_suspend (void)
     }
 }
 
+guint
+qof_event_get_dropped_count (void)
+{
+    return dropped_events;
+}
+
 void
 qof_event_resume (void)
 {
@@ -162,6 +324,30 @@ qof_event_resume (void)
     }
 
     suspend_counter--;
+
+    if (suspend_counter == 0 && !queued_events.empty ())
+    {
+        /* Take the queue first: the handlers may suspend and generate
+         * events of their own. */
+        auto events = std::move (queued_events);
+        queued_events.clear ();
+        queued_masks.clear ();
+        deliver_batch (events.data (), events.size ());
+    }
+}
+
+static void
+queue_event (QofInstance *entity, QofEventId event_id)
+{
+    auto& mask = queued_masks[entity];
+    if ((mask & event_id) == event_id)
+        return;
+    mask |= event_id;
+    queued_events.push_back ({entity, event_id, NULL});
+    /* The address may be reused by a new entity before we resume; don't
+     * let that one's events fold into this one's. */
+    if (event_id & QOF_EVENT_DESTROY)
+        queued_masks.erase (entity);
 }
 
 static void
@@ -182,40 +368,58 @@ qof_event_generate_internal (QofInstance *entity, QofEventId event_id,
     }
     }
 
+    auto start = qof_stat_timer_start ();
+    guint64 calls = 0;
     handler_run_level++;
     for (node = handlers; node; node = next_node)
     {
         HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
 
         next_node = node->next;
+        /* Filtered handlers are reached through typed_handlers below. */
+        if (hi->entity_type)
+            continue;
         if (hi->handler)
         {
             PINFO("id=%d hi=%p han=%p data=%p", hi->handler_id, hi,
                   hi->handler, event_data);
             hi->handler (entity, event_id, hi->user_data, event_data);
+            calls++;
+        }
+        else if (hi->batch_handler)
+        {
+            QofEventBatchItem item {entity, event_id, event_data};
+            PINFO("id=%d hi=%p han=%p data=%p", hi->handler_id, hi,
+                  hi->batch_handler, event_data);
+            hi->batch_handler (&item, 1, hi->user_data);
+            calls++;
         }
     }
-    handler_run_level--;
-
-    /* If we're the outermost event runner and we have pending deletes
-     * then go delete the handlers now.
-     */
-    if (handler_run_level == 0 && pending_deletes)
+    /* Unregistering only clears a handler while events run, so the
+     * per-type lists stay intact while we walk them. */
+    if (typed_handlers && entity->e_type)
     {
-        for (node = handlers; node; node = next_node)
+        auto list = static_cast<GList*>(g_hash_table_lookup (typed_handlers,
+                                                             entity->e_type));
+        for (node = list; node; node = next_node)
         {
             HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
+
             next_node = node->next;
-            if (hi->handler == NULL)
+            if (hi->handler && (hi->event_mask & event_id))
             {
-                /* remove this node from the list, then free this node */
-                handlers = g_list_remove_link (handlers, node);
-                g_list_free_1 (node);
-                g_free (hi);
+                PINFO("id=%d hi=%p han=%p data=%p", hi->handler_id, hi,
+                      hi->handler, event_data);
+                hi->handler (entity, event_id, hi->user_data, event_data);
+                calls++;
             }
         }
-        pending_deletes = 0;
     }
+    handler_run_level--;
+
+    purge_pending_deletes ();
+    qof_stat_add (qof_stat_cached (&handler_calls_stat, "event.handler-calls"), calls);
+    qof_stat_timer_stop (qof_stat_cached (&dispatch_stat, "event.dispatch"), start);
 }
 
 void
@@ -224,6 +428,10 @@ qof_event_force (QofInstance *entity, QofEventId event_id, gpointer event_data)
     if (!entity)
         return;
 
+    /* A frozen book may be in use on another thread. */
+    if (qof_book_is_frozen (qof_instance_get_book (entity)))
+        return;
+
     qof_event_generate_internal (entity, event_id, event_data);
 }
 
@@ -233,8 +441,25 @@ qof_event_gen (QofInstance *entity, QofEventId event_id, gpointer event_data)
     if (!entity)
         return;
 
+    /* Once a book is being destroyed its own DESTROY event has gone out
+     * and nobody can be interested in the objects it frees. Don't run
+     * the handlers, or queue for them, once for each. */
+    auto book = qof_instance_get_book (entity);
+    if (qof_book_shutting_down (book))
+        return;
+
+    /* Nor for a frozen book, which another thread may be reading while
+     * the handlers belong to the main one. */
+    if (qof_book_is_frozen (book))
+        return;
+
     if (suspend_counter)
+    {
+        dropped_events++;
+        if (batch_handlers && event_id != QOF_EVENT_NONE)
+            queue_event (entity, event_id);
         return;
+    }
 
     qof_event_generate_internal (entity, event_id, event_data);
 }
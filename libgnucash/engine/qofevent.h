@@ -98,6 +98,67 @@ typedef void (*QofEventHandler) (QofInstance *ent,  QofEventId event_type,
  */
 gint qof_event_register_handler (QofEventHandler handler, gpointer handler_data);
 
+/** \brief Register a handler for some events only.
+ *
+ * The handler is invoked only for entities of the given type and only
+ * for events in the mask, so handlers interested in one kind of object
+ * aren't called for every change to every other kind. Unregister it
+ * with qof_event_unregister_handler.
+ *
+ * @param handler:   handler to register
+ * @param handler_data: data provided when handler is invoked
+ * @param entity_type: the QofIdType of the entities of interest
+ * @param event_mask: the events of interest, e.g.
+ *                    QOF_EVENT_MODIFY | QOF_EVENT_DESTROY
+ *
+ * @return id identifying handler
+ */
+gint qof_event_register_handler_filtered (QofEventHandler handler,
+                                          gpointer handler_data,
+                                          QofIdTypeConst entity_type,
+                                          QofEventId event_mask);
+
+/** One event in a batch delivered to a QofEventBatchHandler. */
+typedef struct
+{
+    QofInstance *entity;
+    QofEventId event_type;
+    /** The event_data given to qof_event_gen, or NULL for events that
+     * were coalesced while events were suspended. */
+    gpointer event_data;
+} QofEventBatchItem;
+
+/** \brief Handler invoked with a batch of events.
+ *
+ * Events generated while events are suspended are queued, with repeats
+ * of the same (entity, event type) pair collapsed into the first one,
+ * and handed over in one batch when the outermost qof_event_resume is
+ * called. Events generated otherwise arrive in batches of one.
+ *
+ * An entity whose QOF_EVENT_DESTROY is in the batch may already have
+ * been freed: such pointers may be compared but not dereferenced.
+ *
+ * @param events:  the events, in the order in which they were generated.
+ * @param n_events: the number of events.
+ * @param handler_data: data supplied when the handler was registered.
+ */
+typedef void (*QofEventBatchHandler) (const QofEventBatchItem *events,
+                                      guint n_events, gpointer handler_data);
+
+/** \brief Register a handler for batches of events.
+ *
+ * Unlike a QofEventHandler, which misses everything generated while
+ * events are suspended, a batch handler sees each change once when
+ * events resume.  Unregister it with qof_event_unregister_handler.
+ *
+ * @param handler:   handler to register
+ * @param handler_data: data provided when handler is invoked
+ *
+ * @return id identifying handler
+ */
+gint qof_event_register_batch_handler (QofEventBatchHandler handler,
+                                       gpointer handler_data);
+
 /** \brief Unregister an event handler.
  *
  * @param handler_id: the id of the handler to unregister
@@ -30,18 +30,137 @@ extern "C"
 #include <string.h>
 }
 
+#include <vector>
+
 #include "qof.h"
 #include "qofid-p.h"
 #include "qofinstance-p.h"
 
 static QofLogModule log_module = QOF_MOD_ENGINE;
 
+/* Map from GUID to entity position, by open addressing with linear
+ * probing over slots that hold the 16 GUID bytes inline.  GUIDs are
+ * mostly random already, but still get mixed since those read from
+ * files or made by tests need not be.  Deletion shifts the following
+ * run back, so there are no tombstones. */
+class GuidPositionMap
+{
+public:
+    GuidPositionMap () : m_slots (16) {}
+
+    /* The position stored for guid, or 0 if there is none. */
+    guint32 lookup (const GncGUID *guid) const
+    {
+        for (auto i = home (guid); ; i = (i + 1) & mask ())
+        {
+            const auto& slot = m_slots[i];
+            if (!slot.pos || guid_equal (&slot.guid, guid))
+                return slot.pos;
+        }
+    }
+
+    void assign (const GncGUID *guid, guint32 pos)
+    {
+        if ((m_size + 1) * 4 > m_slots.size () * 3)
+            grow ();
+        auto i = home (guid);
+        for (; m_slots[i].pos; i = (i + 1) & mask ())
+            if (guid_equal (&m_slots[i].guid, guid))
+            {
+                m_slots[i].pos = pos;
+                return;
+            }
+        m_slots[i] = { *guid, pos };
+        m_size++;
+    }
+
+    void erase (const GncGUID *guid)
+    {
+        auto i = home (guid);
+        for (; m_slots[i].pos; i = (i + 1) & mask ())
+            if (guid_equal (&m_slots[i].guid, guid))
+                break;
+        if (!m_slots[i].pos)
+            return;
+
+        /* Pull back every later entry of the run that may live in the
+         * freed slot, i.e. whose home isn't between it and its slot. */
+        for (auto j = (i + 1) & mask (); m_slots[j].pos; j = (j + 1) & mask ())
+        {
+            auto k = home (&m_slots[j].guid);
+            if (((j - k) & mask ()) >= ((j - i) & mask ()))
+            {
+                m_slots[i] = m_slots[j];
+                i = j;
+            }
+        }
+        m_slots[i].pos = 0;
+        m_size--;
+    }
+
+    size_t size () const { return m_size; }
+
+    /* Make room for n entries without any further rehashing. */
+    void reserve (size_t n)
+    {
+        auto slots = m_slots.size ();
+        while (n * 4 > slots * 3)
+            slots *= 2;
+        if (slots != m_slots.size ())
+            rehash (slots);
+    }
+
+private:
+    struct Slot
+    {
+        GncGUID guid;
+        guint32 pos;            /* 0 marks an empty slot */
+    };
+
+    size_t mask () const { return m_slots.size () - 1; }
+
+    size_t home (const GncGUID *guid) const
+    {
+        guint64 a, b;
+        memcpy (&a, guid->reserved, sizeof (a));
+        memcpy (&b, guid->reserved + sizeof (a), sizeof (b));
+        return ((a ^ b) * G_GUINT64_CONSTANT (0x9E3779B97F4A7C15)) >> 32 & mask ();
+    }
+
+    void grow ()
+    {
+        rehash (m_slots.size () * 2);
+    }
+
+    void rehash (size_t n_slots)
+    {
+        std::vector<Slot> old (n_slots);
+        old.swap (m_slots);
+        m_size = 0;
+        for (const auto& slot : old)
+            if (slot.pos)
+                assign (&slot.guid, slot.pos);
+    }
+
+    std::vector<Slot> m_slots;
+    size_t m_size = 0;
+};
+
 struct QofCollection_s
 {
     QofIdType    e_type;
     gboolean     is_dirty;
 
-    GHashTable * hash_of_entities;
+    /* The entities, densely packed so that traversals are a plain walk,
+     * and a map from GUID to entity position (plus one). */
+    std::vector<QofInstance*> entities;
+    GuidPositionMap positions;
+
+    /* While a foreach is running, removed entities leave holes that are
+     * squeezed out once the outermost one is done. */
+    guint        iterating;
+    gboolean     has_holes;
+
     gpointer     data;       /* place where object class can hang arbitrary data */
 };
 
@@ -51,9 +170,8 @@ QofCollection *
 qof_collection_new (QofIdType type)
 {
     QofCollection *col;
-    col = g_new0(QofCollection, 1);
+    col = new QofCollection_s ();
     col->e_type = static_cast<QofIdType>(CACHE_INSERT (type));
-    col->hash_of_entities = guid_hash_table_new();
     col->data = NULL;
     return col;
 }
@@ -62,11 +180,73 @@ void
 qof_collection_destroy (QofCollection *col)
 {
     CACHE_REMOVE (col->e_type);
-    g_hash_table_destroy(col->hash_of_entities);
     col->e_type = NULL;
-    col->hash_of_entities = NULL;
     col->data = NULL;   /** XXX there should be a destroy notifier for this */
-    g_free (col);
+    delete col;
+}
+
+/* =============================================================== */
+/* The dense entity vector */
+
+static inline size_t
+collection_position (const QofCollection *col, const GncGUID *guid)
+{
+    return col->positions.lookup (guid);
+}
+
+/* Add ent under guid, or put it in the place of the entity that had
+ * that guid before. */
+static void
+collection_put (QofCollection *col, const GncGUID *guid, QofInstance *ent)
+{
+    auto pos = collection_position (col, guid);
+    if (pos)
+    {
+        col->entities[pos - 1] = ent;
+        return;
+    }
+    col->entities.push_back (ent);
+    col->positions.assign (guid, col->entities.size ());
+}
+
+/* Remove the entity at guid.  Outside traversals the last entity is
+ * moved into its place; during one the slot is just emptied. */
+static void
+collection_take (QofCollection *col, const GncGUID *guid)
+{
+    auto pos = collection_position (col, guid);
+    if (!pos) return;
+
+    col->positions.erase (guid);
+    if (col->iterating)
+    {
+        col->entities[pos - 1] = NULL;
+        col->has_holes = TRUE;
+        return;
+    }
+
+    auto last = col->entities.back ();
+    col->entities.pop_back ();
+    if (pos - 1 < col->entities.size ())
+    {
+        col->entities[pos - 1] = last;
+        col->positions.assign (qof_instance_get_guid (last), pos);
+    }
+}
+
+static void
+collection_squeeze (QofCollection *col)
+{
+    size_t out = 0;
+
+    for (auto ent : col->entities)
+    {
+        if (!ent) continue;
+        col->entities[out++] = ent;
+        col->positions.assign (qof_instance_get_guid (ent), out);
+    }
+    col->entities.resize (out);
+    col->has_holes = FALSE;
 }
 
 /* =============================================================== */
@@ -90,7 +270,7 @@ qof_collection_remove_entity (QofInstance *ent)
     col = qof_instance_get_collection(ent);
     if (!col) return;
     guid = qof_instance_get_guid(ent);
-    g_hash_table_remove (col->hash_of_entities, guid);
+    collection_take (col, guid);
     qof_instance_set_collection(ent, NULL);
 }
 
@@ -104,7 +284,7 @@ qof_collection_insert_entity (QofCollection *col, QofInstance *ent)
     if (guid_equal(guid, guid_null())) return;
     g_return_if_fail (col->e_type == ent->e_type);
     qof_collection_remove_entity (ent);
-    g_hash_table_insert (col->hash_of_entities, (gpointer)guid, ent);
+    collection_put (col, guid, ent);
     qof_instance_set_collection(ent, col);
 }
 
@@ -130,7 +310,7 @@ qof_collection_add_entity (QofCollection *coll, QofInstance *ent)
     {
         return FALSE;
     }
-    g_hash_table_insert (coll->hash_of_entities, (gpointer)guid, ent);
+    collection_put (coll, guid, ent);
     return TRUE;
 }
 
@@ -217,8 +397,8 @@ qof_collection_lookup_entity (const QofCollection *col, const GncGUID * guid)
     QofInstance *ent;
     g_return_val_if_fail (col, NULL);
     if (guid == NULL) return NULL;
-    ent = static_cast<QofInstance*>(g_hash_table_lookup (col->hash_of_entities,
-							 guid));
+    auto pos = collection_position (col, guid);
+    ent = pos ? col->entities[pos - 1] : NULL;
     return ent;
 }
 
@@ -242,12 +422,20 @@ qof_collection_from_glist (QofIdType type, const GList *glist)
     return coll;
 }
 
+void
+qof_collection_reserve (QofCollection *col, guint n)
+{
+    g_return_if_fail (col);
+    col->entities.reserve (n);
+    col->positions.reserve (n);
+}
+
 guint
 qof_collection_count (const QofCollection *col)
 {
     guint c;
 
-    c = g_hash_table_size(col->hash_of_entities);
+    c = col->positions.size ();
     return c;
 }
 
@@ -304,40 +492,29 @@ qof_collection_set_data (QofCollection *col, gpointer user_data)
 
 /* =============================================================== */
 
-struct _qofid_iterate
-{
-    QofInstanceForeachCB      fcn;
-    gpointer                data;
-};
-
-static void
-foreach_cb (gpointer item, gpointer arg)
-{
-    struct _qofid_iterate *iter = static_cast<_qofid_iterate*>(arg);
-    QofInstance *ent = static_cast<QofInstance*>(item);
-
-    iter->fcn (ent, iter->data);
-}
-
+/* Walk the entity vector in place.  Entities added by cb_func are not
+ * visited, and entities removed by it before their turn are skipped;
+ * removal only empties their slot until the walk is done. */
 void
 qof_collection_foreach (const QofCollection *col, QofInstanceForeachCB cb_func,
                         gpointer user_data)
 {
-    struct _qofid_iterate iter;
-    GList *entries;
+    QofCollection *mcol = const_cast<QofCollection*>(col);
 
     g_return_if_fail (col);
     g_return_if_fail (cb_func);
 
-    iter.fcn = cb_func;
-    iter.data = user_data;
-
-    PINFO("Hash Table size of %s before is %d", col->e_type, g_hash_table_size(col->hash_of_entities));
+    PINFO("Hash Table size of %s before is %d", col->e_type, (int)col->positions.size ());
 
-    entries = g_hash_table_get_values (col->hash_of_entities);
-    g_list_foreach (entries, foreach_cb, &iter);
-    g_list_free (entries);
+    mcol->iterating++;
+    for (size_t i = 0, n = col->entities.size (); i < n; ++i)
+    {
+        if (auto ent = col->entities[i])
+            cb_func (ent, user_data);
+    }
+    if (--mcol->iterating == 0 && col->has_holes)
+        collection_squeeze (mcol);
 
-    PINFO("Hash Table size of %s after is %d", col->e_type, g_hash_table_size(col->hash_of_entities));
+    PINFO("Hash Table size of %s after is %d", col->e_type, (int)col->positions.size ());
 }
 /* =============================================================== */
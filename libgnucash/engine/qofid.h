@@ -132,6 +132,10 @@ QofCollection * qof_collection_new (QofIdType type);
 /** return the number of entities in the collection. */
 guint qof_collection_count (const QofCollection *col);
 
+/** Make room for n entities, for callers that know in advance how many
+ * they are about to insert. */
+void qof_collection_reserve (QofCollection *col, guint n);
+
 /** destroy the collection */
 void qof_collection_destroy (QofCollection *col);
 
@@ -163,6 +163,9 @@ void qof_instance_foreach_slot (const QofInstance *inst, const char *head,
 
 void qof_instance_get_path_kvp (QofInstance *, GValue *, std::vector<std::string> const &);
 
+/** As above, for a path compiled once into a KvpPath. */
+void qof_instance_get_path_kvp (QofInstance *, GValue *, KvpPath const &);
+
 void qof_instance_set_path_kvp (QofInstance *, GValue const *, std::vector<std::string> const &);
 
 bool qof_instance_has_path_slot (QofInstance const *, std::vector<std::string> const &);
@@ -183,7 +186,8 @@ template<typename func_type, typename data_type>
 void qof_instance_foreach_slot_prefix(QofInstance const * inst, std::string const & path_prefix,
         func_type const & func, data_type & data)
 {
-    inst->kvp_data->for_each_slot_prefix(path_prefix, func, data);
+    if (inst->kvp_data)
+        inst->kvp_data->for_each_slot_prefix(path_prefix, func, data);
 }
 
 #endif
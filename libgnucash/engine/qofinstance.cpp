@@ -254,6 +254,32 @@ static void qof_instance_class_init(QofInstanceClass *klass)
                         G_PARAM_READWRITE));
 }
 
+/* Every change of the dirty flag goes through here so that the book's
+ * dirty set stays in step with the flags. */
+static void
+instance_set_dirty_flag (QofInstance *inst, gboolean dirty)
+{
+    QofInstancePrivate *priv = GET_PRIVATE(inst);
+
+    if (priv->dirty == dirty) return;
+    priv->dirty = dirty;
+    qof_book_track_dirty_instance (priv->book, inst, dirty);
+}
+
+static void
+instance_move_book (QofInstance *inst, QofBook *book)
+{
+    QofInstancePrivate *priv = GET_PRIVATE(inst);
+
+    if (priv->book == book) return;
+    if (priv->dirty)
+    {
+        qof_book_track_dirty_instance (priv->book, inst, FALSE);
+        qof_book_track_dirty_instance (book, inst, TRUE);
+    }
+    priv->book = book;
+}
+
 static void
 qof_instance_init (QofInstance *inst)
 {
@@ -261,7 +287,7 @@ qof_instance_init (QofInstance *inst)
 
     priv = GET_PRIVATE(inst);
     priv->book = NULL;
-    inst->kvp_data = new KvpFrame;
+    inst->kvp_data = nullptr;
     priv->last_update = 0;
     priv->editlevel = 0;
     priv->do_free = FALSE;
@@ -319,6 +345,7 @@ qof_instance_dispose (GObject *instp)
     QofInstance* inst = QOF_INSTANCE(instp);
 
     priv = GET_PRIVATE(instp);
+    instance_set_dirty_flag (inst, FALSE);
     if (!priv->collection)
         return;
     qof_collection_remove_entity(inst);
@@ -543,7 +570,7 @@ void
 qof_instance_set_book (gconstpointer inst, QofBook *book)
 {
     g_return_if_fail(QOF_IS_INSTANCE(inst));
-    GET_PRIVATE(inst)->book = book;
+    instance_move_book (QOF_INSTANCE(inst), book);
 }
 
 void
@@ -552,7 +579,7 @@ qof_instance_copy_book (gpointer ptr1, gconstpointer ptr2)
     g_return_if_fail(QOF_IS_INSTANCE(ptr1));
     g_return_if_fail(QOF_IS_INSTANCE(ptr2));
 
-    GET_PRIVATE(ptr1)->book = GET_PRIVATE(ptr2)->book;
+    instance_move_book (QOF_INSTANCE(ptr1), GET_PRIVATE(ptr2)->book);
 }
 
 gboolean
@@ -569,12 +596,38 @@ qof_instance_books_equal (gconstpointer ptr1, gconstpointer ptr2)
     return (priv1->book == priv2->book);
 }
 
+/* Most instances (splits in particular) never carry any slots, so the
+ * frame is only allocated the first time something is written to it.
+ * Readers go through instance_kvp_slot, which treats a missing frame as
+ * an empty one.
+ */
+static KvpFrame*
+instance_kvp_frame (const QofInstance *inst)
+{
+    auto mutable_inst = const_cast<QofInstance*>(inst);
+    if (!mutable_inst->kvp_data)
+        mutable_inst->kvp_data = new KvpFrame;
+    return mutable_inst->kvp_data;
+}
+
+static KvpValue*
+instance_kvp_slot (const QofInstance *inst, Path const & path)
+{
+    return inst->kvp_data ? inst->kvp_data->get_slot (path) : nullptr;
+}
+
+static KvpValue*
+instance_kvp_slot (const QofInstance *inst, KvpPath const & path)
+{
+    return inst->kvp_data ? inst->kvp_data->get_slot (path) : nullptr;
+}
+
 /* Watch out: This function is still used (as a "friend") in src/import-export/aqb/gnc-ab-kvp.c */
 KvpFrame*
 qof_instance_get_slots (const QofInstance *inst)
 {
     if (!inst) return NULL;
-    return inst->kvp_data;
+    return instance_kvp_frame (inst);
 }
 
 void
@@ -590,8 +643,9 @@ qof_instance_set_slots (QofInstance *inst, KvpFrame *frm)
         delete inst->kvp_data;
     }
 
-    priv->dirty = TRUE;
+    instance_set_dirty_flag (inst, TRUE);
     inst->kvp_data = frm;
+    KvpFrame::changed ();
 }
 
 void
@@ -666,14 +720,14 @@ void
 qof_instance_set_dirty_flag (gconstpointer inst, gboolean flag)
 {
     g_return_if_fail(QOF_IS_INSTANCE(inst));
-    GET_PRIVATE(inst)->dirty = flag;
+    instance_set_dirty_flag (QOF_INSTANCE(inst), flag);
 }
 
 void
 qof_instance_mark_clean (QofInstance *inst)
 {
     if (!inst) return;
-    GET_PRIVATE(inst)->dirty = FALSE;
+    instance_set_dirty_flag (inst, FALSE);
 }
 
 void
@@ -712,7 +766,7 @@ qof_instance_set_dirty(QofInstance* inst)
     QofCollection *coll;
 
     priv = GET_PRIVATE(inst);
-    priv->dirty = TRUE;
+    instance_set_dirty_flag (inst, TRUE);
 }
 
 gboolean
@@ -965,7 +1019,7 @@ qof_begin_edit (QofInstance *inst)
     if (be)
         be->begin(inst);
     else
-        priv->dirty = TRUE;
+        instance_set_dirty_flag (inst, TRUE);
 
     return TRUE;
 }
@@ -1054,7 +1108,10 @@ qof_instance_has_kvp (QofInstance *inst)
 
 void qof_instance_set_path_kvp (QofInstance * inst, GValue const * value, std::vector<std::string> const & path)
 {
-    delete inst->kvp_data->set_path (path, kvp_value_from_gvalue (value));
+    /* Clearing a slot on an instance without a frame is a no-op. */
+    if (!value && !inst->kvp_data)
+        return;
+    delete instance_kvp_frame (inst)->set_path (path, kvp_value_from_gvalue (value));
 }
 
 void
@@ -1066,12 +1123,15 @@ qof_instance_set_kvp (QofInstance * inst, GValue const * value, unsigned count,
     for (unsigned i{0}; i < count; ++i)
         path.push_back (va_arg (args, char const *));
     va_end (args);
-    delete inst->kvp_data->set_path (path, kvp_value_from_gvalue (value));
+    if (!value && !inst->kvp_data)
+        return;
+    delete instance_kvp_frame (inst)->set_path (path, kvp_value_from_gvalue (value));
 }
 
-void qof_instance_get_path_kvp (QofInstance * inst, GValue * value, std::vector<std::string> const & path)
+static void
+instance_slot_to_gvalue (KvpValue *slot, GValue *value)
 {
-    auto temp = gvalue_from_kvp_value (inst->kvp_data->get_slot (path));
+    auto temp = gvalue_from_kvp_value (slot);
     if (G_IS_VALUE (temp))
     {
         if (G_IS_VALUE (value))
@@ -1082,49 +1142,62 @@ void qof_instance_get_path_kvp (QofInstance * inst, GValue * value, std::vector<
     }
 }
 
+void qof_instance_get_path_kvp (QofInstance * inst, GValue * value, std::vector<std::string> const & path)
+{
+    instance_slot_to_gvalue (instance_kvp_slot (inst, path), value);
+}
+
+void qof_instance_get_path_kvp (QofInstance * inst, GValue * value, KvpPath const & path)
+{
+    instance_slot_to_gvalue (instance_kvp_slot (inst, path), value);
+}
+
 void
 qof_instance_get_kvp (QofInstance * inst, GValue * value, unsigned count, ...)
 {
-    std::vector<std::string> path;
+    /* The keys are only borrowed for the lookup, so there's no need to
+     * copy them into std::strings. */
+    KvpPath::key_list keys;
+    keys.reserve (count);
     va_list args;
     va_start (args, count);
     for (unsigned i{0}; i < count; ++i)
-        path.push_back (va_arg (args, char const *));
+        keys.push_back (va_arg (args, char const *));
     va_end (args);
-    auto temp = gvalue_from_kvp_value (inst->kvp_data->get_slot (path));
-    if (G_IS_VALUE (temp))
-    {
-        if (G_IS_VALUE (value))
-            g_value_unset (value);
-        g_value_init (value, G_VALUE_TYPE (temp));
-        g_value_copy (temp, value);
-        gnc_gvalue_free (temp);
-    }
+    instance_slot_to_gvalue (instance_kvp_slot (inst, KvpPath {std::move (keys)}),
+                             value);
 }
 
 void
 qof_instance_copy_kvp (QofInstance *to, const QofInstance *from)
 {
     delete to->kvp_data;
-    to->kvp_data = new KvpFrame(*from->kvp_data);
+    to->kvp_data = from->kvp_data ? new KvpFrame(*from->kvp_data) : nullptr;
+    KvpFrame::changed ();
 }
 
 void
 qof_instance_swap_kvp (QofInstance *a, QofInstance *b)
 {
     std::swap(a->kvp_data, b->kvp_data);
+    KvpFrame::changed ();
 }
 
 int
 qof_instance_compare_kvp (const QofInstance *a, const QofInstance *b)
 {
-    return compare(a->kvp_data, b->kvp_data);
+    /* A frame that was never allocated compares equal to an empty one. */
+    static const KvpFrame empty_frame;
+    return compare(a->kvp_data ? a->kvp_data : &empty_frame,
+                   b->kvp_data ? b->kvp_data : &empty_frame);
 }
 
 char*
 qof_instance_kvp_as_string (const QofInstance *inst)
 {
     //The std::string is a local temporary and doesn't survive this function.
+    if (!inst->kvp_data)
+        return g_strdup("");
     return g_strdup(inst->kvp_data->to_string().c_str());
 }
 
@@ -1133,13 +1206,13 @@ qof_instance_kvp_add_guid (const QofInstance *inst, const char* path,
                            time64 time, const char *key,
                            const GncGUID *guid)
 {
-    g_return_if_fail (inst->kvp_data != NULL);
+    g_return_if_fail (inst != NULL);
 
     auto container = new KvpFrame;
     Time64 t{time};
     container->set({key}, new KvpValue(const_cast<GncGUID*>(guid)));
     container->set({"date"}, new KvpValue(t));
-    delete inst->kvp_data->set_path({path}, new KvpValue(container));
+    delete instance_kvp_frame (inst)->set_path({path}, new KvpValue(container));
 }
 
 inline static gboolean
@@ -1160,10 +1233,10 @@ gboolean
 qof_instance_kvp_has_guid (const QofInstance *inst, const char *path,
                            const char* key, const GncGUID *guid)
 {
-    g_return_val_if_fail (inst->kvp_data != NULL, FALSE);
+    g_return_val_if_fail (inst != NULL, FALSE);
     g_return_val_if_fail (guid != NULL, FALSE);
 
-    auto v = inst->kvp_data->get_slot({path});
+    auto v = instance_kvp_slot (inst, {path});
     if (v == nullptr) return FALSE;
 
     switch (v->get_type())
@@ -1195,10 +1268,10 @@ void
 qof_instance_kvp_remove_guid (const QofInstance *inst, const char *path,
                           const char *key, const GncGUID *guid)
 {
-    g_return_if_fail (inst->kvp_data != NULL);
+    g_return_if_fail (inst != NULL);
     g_return_if_fail (guid != NULL);
 
-    auto v = inst->kvp_data->get_slot({path});
+    auto v = instance_kvp_slot (inst, {path});
     if (v == NULL) return;
 
     switch (v->get_type())
@@ -1244,14 +1317,14 @@ qof_instance_kvp_merge_guids (const QofInstance *target,
     auto v = donor->kvp_data->get_slot({path});
     if (v == NULL) return;
 
-    auto target_val = target->kvp_data->get_slot({path});
+    auto target_val = instance_kvp_slot (target, {path});
     switch (v->get_type())
     {
     case KvpValue::Type::FRAME:
         if (target_val)
             target_val->add(v);
         else
-            target->kvp_data->set_path({path}, v);
+            instance_kvp_frame (target)->set_path({path}, v);
         donor->kvp_data->set({path}, nullptr); //Contents moved, Don't delete!
         break;
     case KvpValue::Type::GLIST:
@@ -1262,7 +1335,7 @@ qof_instance_kvp_merge_guids (const QofInstance *target,
             target_val->set(list);
         }
         else
-            target->kvp_data->set({path}, v);
+            instance_kvp_frame (target)->set({path}, v);
         donor->kvp_data->set({path}, nullptr); //Contents moved, Don't delete!
         break;
     default:
@@ -1273,29 +1346,31 @@ qof_instance_kvp_merge_guids (const QofInstance *target,
 
 bool qof_instance_has_path_slot (QofInstance const * inst, std::vector<std::string> const & path)
 {
-    return inst->kvp_data->get_slot (path) != nullptr;
+    return instance_kvp_slot (inst, path) != nullptr;
 }
 
 gboolean
 qof_instance_has_slot (const QofInstance *inst, const char *path)
 {
-    return inst->kvp_data->get_slot({path}) != NULL;
+    return instance_kvp_slot (inst, {path}) != NULL;
 }
 
 void qof_instance_slot_path_delete (QofInstance const * inst, std::vector<std::string> const & path)
 {
-    delete inst->kvp_data->set (path, nullptr);
+    if (inst->kvp_data)
+        delete inst->kvp_data->set (path, nullptr);
 }
 
 void
 qof_instance_slot_delete (QofInstance const *inst, char const * path)
 {
-    delete inst->kvp_data->set ({path}, nullptr);
+    if (inst->kvp_data)
+        delete inst->kvp_data->set ({path}, nullptr);
 }
 
 void qof_instance_slot_path_delete_if_empty (QofInstance const * inst, std::vector<std::string> const & path)
 {
-    auto slot = inst->kvp_data->get_slot (path);
+    auto slot = instance_kvp_slot (inst, path);
     if (slot)
     {
         auto frame = slot->get <KvpFrame*> ();
@@ -1307,7 +1382,7 @@ void qof_instance_slot_path_delete_if_empty (QofInstance const * inst, std::vect
 void
 qof_instance_slot_delete_if_empty (QofInstance const *inst, char const * path)
 {
-    auto slot = inst->kvp_data->get_slot ({path});
+    auto slot = instance_kvp_slot (inst, {path});
     if (slot)
     {
         auto frame = slot->get <KvpFrame*> ();
@@ -1320,6 +1395,8 @@ std::vector <std::pair <std::string, KvpValue*>>
 qof_instance_get_slots_prefix (QofInstance const * inst, std::string const & prefix)
 {
     std::vector <std::pair <std::string, KvpValue*>> ret;
+    if (!inst->kvp_data)
+        return ret;
     inst->kvp_data->for_each_slot_temp ([&prefix, &ret] (std::string const & key, KvpValue * val) {
         if (key.find (prefix) == 0)
             ret.emplace_back (key, val);
@@ -1359,7 +1436,7 @@ qof_instance_foreach_slot (const QofInstance *inst, const char* head, const char
     if (category)
         path.emplace_back (category);
 
-    auto slot = inst->kvp_data->get_slot(path);
+    auto slot = instance_kvp_slot (inst, path);
     if (slot == nullptr || slot->get_type() != KvpValue::Type::FRAME)
         return;
     auto frame = slot->get<KvpFrame*>();
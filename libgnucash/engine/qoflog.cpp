@@ -71,6 +71,9 @@ static GLogFunc previous_handler = NULL;
 static gchar* qof_logger_format = NULL;
 static QofLogModule log_module = "qof";
 
+/* Starts at 1 so that a call site's zeroed cache is stale. */
+gint qof_log_generation = 1;
+
 using StrVec = std::vector<std::string>;
 
 struct ModuleEntry;
@@ -279,6 +282,7 @@ qof_log_shutdown (void)
     if (_modules != NULL)
     {
         _modules = nullptr;
+        g_atomic_int_inc (&qof_log_generation);
     }
 
     if (previous_handler != NULL)
@@ -315,6 +319,7 @@ qof_log_set_level(QofLogModule log_module, QofLogLevel level)
         }
     }
     module->m_level = level;
+    g_atomic_int_inc (&qof_log_generation);
 }
 
 
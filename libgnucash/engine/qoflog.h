@@ -173,6 +173,39 @@ gboolean qof_log_check(QofLogModule log_module, QofLogLevel log_level);
 /** Set the default level for QOF-related log paths. **/
 void qof_log_set_default(QofLogLevel log_level);
 
+/** Bumped whenever the log levels change, so that the results of
+ *  qof_log_check() cached by qof_log_check_site() go stale.  Private;
+ *  read it only through qof_log_check_site(). **/
+extern gint qof_log_generation;
+
+/** qof_log_check() for one call site that always asks about the same
+ * @a log_module and @a log_level, caching the answer in @a site until
+ * the log levels next change.  @a site must be a static gint
+ * initialized to 0.  While the levels stay the same this is two loads
+ * and a well-predicted compare, which is what keeps ENTER and LEAVE
+ * cheap in the engine's hot functions when debug logging is off.
+ *
+ * The cache holds the generation it was filled in in its high bits
+ * and the answer in its lowest, so that it is read and written in one
+ * piece when several threads log from the same site. **/
+static inline gboolean
+qof_log_check_site (gint *site, QofLogModule log_module, QofLogLevel log_level)
+{
+    gint generation = g_atomic_int_get (&qof_log_generation);
+    gint cached = g_atomic_int_get (site);
+    gboolean enabled;
+    if (G_LIKELY ((cached >> 1) == generation))
+        return cached & 1;
+    enabled = qof_log_check (log_module, log_level);
+    g_atomic_int_set (site, (generation << 1) | (enabled ? 1 : 0));
+    return enabled;
+}
+
+/** Declares a call site's cache and tests it; the head of ENTER and LEAVE. **/
+#define QOF_LOG_SITE_CHECK(level) \
+    static gint qof_log_site_ = 0; \
+    if (qof_log_check_site (&qof_log_site_, log_module, (QofLogLevel)(level)))
+
 #define PRETTY_FUNC_NAME qof_log_prettify(G_STRFUNC)
 
 #ifdef _MSC_VER
@@ -216,7 +249,7 @@ void qof_log_set_default(QofLogLevel log_level);
 
 /** Print a function entry debugging message */
 #define ENTER(format, ...) do { \
-    if (qof_log_check(log_module, (QofLogLevel)G_LOG_LEVEL_DEBUG)) { \
+    QOF_LOG_SITE_CHECK (G_LOG_LEVEL_DEBUG) { \
       g_log (log_module, G_LOG_LEVEL_DEBUG, \
         "[enter %s:%s()] " format, __FILE__, \
         PRETTY_FUNC_NAME , __VA_ARGS__); \
@@ -226,7 +259,7 @@ void qof_log_set_default(QofLogLevel log_level);
 
 /** Print a function exit debugging message. **/
 #define LEAVE(format, ...) do { \
-    if (qof_log_check(log_module, (QofLogLevel)G_LOG_LEVEL_DEBUG)) { \
+    QOF_LOG_SITE_CHECK (G_LOG_LEVEL_DEBUG) { \
       qof_log_dedent(); \
       g_log (log_module, G_LOG_LEVEL_DEBUG, \
         "[leave %s()] " format, \
@@ -268,7 +301,7 @@ void qof_log_set_default(QofLogLevel log_level);
 
 /** Print a function entry debugging message */
 #define ENTER(format, args...) do { \
-    if (qof_log_check(log_module, (QofLogLevel)G_LOG_LEVEL_DEBUG)) { \
+    QOF_LOG_SITE_CHECK (G_LOG_LEVEL_DEBUG) { \
       g_log (log_module, G_LOG_LEVEL_DEBUG, \
         "[enter %s:%s()] " format, __FILE__, \
         PRETTY_FUNC_NAME , ## args); \
@@ -278,7 +311,7 @@ void qof_log_set_default(QofLogLevel log_level);
 
 /** Print a function exit debugging message. **/
 #define LEAVE(format, args...) do { \
-    if (qof_log_check(log_module, (QofLogLevel)G_LOG_LEVEL_DEBUG)) { \
+    QOF_LOG_SITE_CHECK (G_LOG_LEVEL_DEBUG) { \
       qof_log_dedent(); \
       g_log (log_module, G_LOG_LEVEL_DEBUG, \
         "[leave %s()] " format, \
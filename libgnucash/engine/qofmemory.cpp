@@ -0,0 +1,211 @@
+/********************************************************************
+ * qofmemory.cpp -- estimates of the memory a book holds, by type   *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ ********************************************************************/
+
+extern "C"
+{
+#include <config.h>
+#include "qof.h"
+#include "qofmemory.h"
+}
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "kvp-frame.hpp"
+
+struct MemoryUsage
+{
+    guint64 count = 0;
+    guint64 bytes = 0;
+};
+
+/* A GHashTable entry is a key, a value and a hash, in three arrays. */
+static constexpr guint64 hash_entry_bytes = 2 * sizeof (gpointer) + sizeof (guint);
+
+static std::mutex sources_mutex;
+
+static std::vector<QofMemorySource>&
+memory_sources ()
+{
+    static std::vector<QofMemorySource> sources;
+    return sources;
+}
+
+void
+qof_memory_register_source (QofMemorySource source)
+{
+    g_return_if_fail (source);
+    std::lock_guard<std::mutex> lock {sources_mutex};
+    auto& sources = memory_sources ();
+    if (std::find (sources.begin (), sources.end (), source) == sources.end ())
+        sources.push_back (source);
+}
+
+/* The instance and its private data; the private data sits just
+ * before the instance, at a negative offset. */
+static guint64
+instance_size (GType type)
+{
+    GTypeQuery query;
+    g_type_query (type, &query);
+    guint64 size = query.instance_size;
+    auto klass = g_type_class_peek (type);
+    if (klass)
+        size += std::max (0, -g_type_class_get_instance_private_offset (klass));
+    return size;
+}
+
+static void kvp_frame_usage (const KvpFrame *frame, MemoryUsage& usage);
+
+/* Values own their strings and GUIDs; keys are in the string cache and
+ * counted there. */
+static void
+kvp_value_usage (const KvpValue *value, MemoryUsage& usage)
+{
+    usage.bytes += sizeof (KvpValue);
+    switch (value->get_type ())
+    {
+    case KvpValue::Type::STRING:
+    {
+        auto str = value->get<const char*> ();
+        usage.bytes += str ? strlen (str) + 1 : 0;
+        break;
+    }
+    case KvpValue::Type::GUID:
+        usage.bytes += sizeof (GncGUID);
+        break;
+    case KvpValue::Type::GLIST:
+        for (auto node = value->get<GList*> (); node; node = g_list_next (node))
+        {
+            usage.bytes += sizeof (GList);
+            kvp_value_usage (static_cast<KvpValue*> (node->data), usage);
+        }
+        break;
+    case KvpValue::Type::FRAME:
+        kvp_frame_usage (value->get<KvpFrame*> (), usage);
+        break;
+    default:
+        break;
+    }
+}
+
+static void
+kvp_frame_usage (const KvpFrame *frame, MemoryUsage& usage)
+{
+    if (!frame) return;
+    usage.bytes += sizeof (KvpFrame);
+    frame->for_each_slot_temp ([&usage] (const char *, const KvpValue *value)
+    {
+        ++usage.count;
+        usage.bytes += sizeof (std::pair<const char*, KvpValue*>);
+        if (value)
+            kvp_value_usage (value, usage);
+    });
+}
+
+struct CollectionUsage
+{
+    MemoryUsage objects;
+    MemoryUsage slots;
+};
+
+using CollectionMap = std::map<std::string, CollectionUsage>;
+
+static void
+instance_usage_cb (QofInstance *inst, gpointer data)
+{
+    auto usage = static_cast<CollectionUsage*> (data);
+    ++usage->objects.count;
+    usage->objects.bytes += instance_size (G_OBJECT_TYPE (inst)) + hash_entry_bytes;
+    kvp_frame_usage (inst->kvp_data, usage->slots);
+}
+
+static void
+collection_usage_cb (QofCollection *col, gpointer data)
+{
+    auto collections = static_cast<CollectionMap*> (data);
+    auto& usage = (*collections)[qof_collection_get_type (col)];
+    qof_collection_foreach (col, instance_usage_cb, &usage);
+}
+
+void
+qof_memory_foreach (QofBook *book, QofMemoryCB cb, gpointer user_data)
+{
+    g_return_if_fail (cb);
+
+    if (book)
+    {
+        CollectionMap collections;
+        qof_book_foreach_collection (book, collection_usage_cb, &collections);
+        for (const auto& entry : collections)
+        {
+            auto name = entry.first;
+            cb (name.c_str (), entry.second.objects.count,
+                entry.second.objects.bytes, user_data);
+            name += " kvp slots";
+            cb (name.c_str (), entry.second.slots.count,
+                entry.second.slots.bytes, user_data);
+        }
+    }
+
+    guint64 count, bytes;
+    qof_string_cache_get_usage (&count, &bytes);
+    cb ("string cache", count, bytes, user_data);
+
+    std::vector<QofMemorySource> sources;
+    {
+        std::lock_guard<std::mutex> lock {sources_mutex};
+        sources = memory_sources ();
+    }
+    for (auto source : sources)
+        source (book, cb, user_data);
+}
+
+struct MemoryReport
+{
+    GString *str;
+    guint64 total;
+};
+
+static void
+memory_report_cb (const char *name, guint64 count, guint64 bytes, gpointer data)
+{
+    auto report = static_cast<MemoryReport*> (data);
+    g_string_append_printf (report->str, "%-40s %12" G_GUINT64_FORMAT " %12.1f\n",
+                            name, count, bytes / 1024.0);
+    report->total += bytes;
+}
+
+gchar *
+qof_memory_report (QofBook *book)
+{
+    MemoryReport report {g_string_new (nullptr), 0};
+    g_string_append_printf (report.str, "%-40s %12s %12s\n", "entry", "count", "KiB");
+    qof_memory_foreach (book, memory_report_cb, &report);
+    g_string_append_printf (report.str, "%-40s %12s %12.1f\n", "total", "",
+                            report.total / 1024.0);
+    return g_string_free (report.str, FALSE);
+}
@@ -0,0 +1,82 @@
+/********************************************************************
+ * qofmemory.h -- estimates of the memory a book holds, by type     *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ ********************************************************************/
+
+/** @addtogroup Memory Memory Usage
+    @ingroup QOF
+
+    Counts of what a book holds and estimates of the bytes it takes,
+    to tell which kind of data is responsible when a book uses too
+    much memory.  Every collection in the book gives two entries: its
+    objects, sized from their GObject type, and the KVP slots hanging
+    off them.  The string cache adds one, and other modules add their
+    own by registering a source: the price database reports its price
+    lists and lookup caches and the quickfills report their trees.
+
+    The byte figures are estimates from the sizes of the structures
+    involved and leave out the allocator's own overhead, so they are
+    for comparing entries, not for matching the process's RSS.
+@{
+*/
+/** @file qofmemory.h
+    @brief Estimates of the memory a book holds, by type
+*/
+
+#ifndef QOF_MEMORY_H
+#define QOF_MEMORY_H
+
+#include "qofbook.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Receives one entry of the report: what it is, how many of them
+ *  there are and the bytes they are estimated to take. */
+typedef void (*QofMemoryCB) (const char *name, guint64 count,
+                             guint64 bytes, gpointer user_data);
+
+/** Reports the memory held by one module by calling cb for each of its
+ *  entries.  book is the book being reported on, for sources that
+ *  keep data per book. */
+typedef void (*QofMemorySource) (QofBook *book, QofMemoryCB cb,
+                                 gpointer user_data);
+
+/** Add source to those reported by qof_memory_foreach().  Registering
+ *  the same source again does nothing. */
+void qof_memory_register_source (QofMemorySource source);
+
+/** Call cb for the objects and KVP slots in each of book's
+ *  collections, in type name order, then for the string cache and
+ *  each registered source. */
+void qof_memory_foreach (QofBook *book, QofMemoryCB cb, gpointer user_data);
+
+/** The report as text, one entry per line with its count and size in
+ *  kilobytes, and a total.  The caller must g_free the result. */
+gchar *qof_memory_report (QofBook *book);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QOF_MEMORY_H */
+/** @} */
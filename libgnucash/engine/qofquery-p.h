@@ -71,6 +71,47 @@ QofQueryParamList * qof_query_sort_get_param_path (const QofQuerySort *querysort
 gint qof_query_sort_get_sort_options (const QofQuerySort *querysort);
 gboolean qof_query_sort_get_increasing (const QofQuerySort *querysort);
 
+/* Index-driven execution.
+ *
+ * By default qof_query_run() hands every object in the book's
+ * collection to the predicates.  An object module that keeps its own
+ * index can register a QofQueryIndexFunc for its type: it is given the
+ * query and a book and should call cb on a superset of the matching
+ * objects, each exactly once, and return TRUE.  The predicates are
+ * still applied to whatever it visits.  Returning FALSE (without having
+ * called cb) means the index can't serve this query, and the full
+ * collection scan is used instead.
+ */
+typedef gboolean (*QofQueryIndexFunc) (QofQuery *q, QofBook *book,
+                                       QofInstanceForeachCB cb,
+                                       gpointer user_data);
+
+void qof_query_register_index (QofIdTypeConst obj_type,
+                               QofQueryIndexFunc func);
+
+/* Live queries and related objects.
+ *
+ * A live query re-tests the objects of its type that have events.  An
+ * object module whose objects match on fields of another type's
+ * objects (a split on its transaction's date, say) can register a
+ * QofQueryRelatedFunc for that type: it is given a modified instance of
+ * changed_type and should call cb on each object of obj_type whose
+ * matching that may change.
+ */
+typedef void (*QofQueryRelatedFunc) (QofInstance *inst,
+                                     QofInstanceForeachCB cb,
+                                     gpointer user_data);
+
+void qof_query_register_related (QofIdTypeConst obj_type,
+                                 QofIdTypeConst changed_type,
+                                 QofQueryRelatedFunc func);
+
+/* The smallest collection a query set with qof_query_set_parallel()
+ * scans on several threads.  Tests lower it to get the threaded scan on
+ * a small book; 0 restores the default.
+ */
+void qof_query_set_parallel_min_objects (guint n_objects);
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,15 +32,25 @@ extern "C"
 #include <string.h>
 }
 
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vector>
+
 #include "qof.h"
 #include "qof-backend.hpp"
 #include "qofbook-p.h"
+#include "qofevent-p.h"
 #include "qofclass-p.h"
 #include "qofquery-p.h"
 #include "qofquerycore-p.h"
 
 static QofLogModule log_module = QOF_MOD_QUERY;
 
+static QofStat *index_stat;
+static QofStat *scan_stat;
+static QofStat *parallel_scan_stat;
+
 struct _QofQueryTerm
 {
     QofQueryParamList *     param_list;
@@ -93,6 +103,19 @@ struct _QofQuery
     /* The maximum number of results to return */
     gint              max_results;
 
+    /* Whether a full collection scan may run on several threads */
+    gboolean          parallel;
+
+    /* Live results, see qof_query_set_live(): the event handler id (0
+     * when not live), the objects changed since the results were last
+     * brought up to date, whether the results are from qof_query_run()
+     * and may be updated in place, and the number of events dropped
+     * while suspended as of then. */
+    gint              live_handler_id;
+    GHashTable *      live_pending;
+    gboolean          live_valid;
+    guint             live_dropped;
+
     /* list of books that will be participating in the query */
     GList *           books;
 
@@ -420,11 +443,59 @@ check_object (const QofQuery *q, gpointer object)
     return 0;
 }
 
+/* Compiled parameter paths, shared by every query.  The register
+ * rebuilds near-identical queries on each refresh, so the same
+ * (search_for, param path) pairs get compiled over and over; cache
+ * the resolved QofParam chain keyed by "search_for\x1fparam\x1f...".
+ * The whole cache is dropped whenever the class registry changes.
+ * Queries run on books owned by other threads too, so the cache is
+ * only touched with compiled_paths_mutex held.
+ */
+typedef struct
+{
+    GSList *fcns;               /* owned; callers get a copy */
+    const QofParam *final;      /* NULL if the first parameter was bad */
+} QofQueryCompiledPath;
+
+static GHashTable *index_funcs = NULL;
+static GHashTable *compiled_paths = NULL;
+static guint compiled_paths_generation = 0;
+static std::mutex compiled_paths_mutex;
+
+static void
+compiled_path_free (gpointer data)
+{
+    QofQueryCompiledPath *path = static_cast<QofQueryCompiledPath*>(data);
+    g_slist_free (path->fcns);
+    g_free (path);
+}
+
+static void
+compiled_paths_clear (void)
+{
+    if (compiled_paths)
+        g_hash_table_destroy (compiled_paths);
+    compiled_paths = NULL;
+}
+
+static gchar *
+compiled_path_key (QofQueryParamList *param_list, QofIdType start_obj)
+{
+    GString *key = g_string_new (start_obj);
+    for (; param_list; param_list = param_list->next)
+    {
+        g_string_append_c (key, '\x1f');
+        g_string_append (key, static_cast<const char*>(param_list->data));
+    }
+    return g_string_free (key, FALSE);
+}
+
 /* walk the list of parameters, starting with the given object, and
  * compile the list of parameter get-functions.  Save the last valid
  * parameter definition in "final" and return the list of functions.
  *
  * returns NULL if the first parameter is bad (and final is unchanged).
+ * The returned list belongs to the caller.
  */
 static GSList *
 compile_params (QofQueryParamList *param_list, QofIdType start_obj,
@@ -432,12 +503,35 @@ compile_params (QofQueryParamList *param_list, QofIdType start_obj,
 {
     const QofParam *objDef = NULL;
     GSList *fcns = NULL;
+    QofQueryCompiledPath *cached;
+    gchar *key;
 
     ENTER ("param_list=%p id=%s", param_list, start_obj);
     g_return_val_if_fail (param_list, NULL);
     g_return_val_if_fail (start_obj, NULL);
     g_return_val_if_fail (final, NULL);
 
+    std::lock_guard<std::mutex> lock {compiled_paths_mutex};
+    if (compiled_paths_generation != qof_class_get_generation ())
+    {
+        compiled_paths_clear ();
+        compiled_paths_generation = qof_class_get_generation ();
+    }
+    if (!compiled_paths)
+        compiled_paths = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                g_free, compiled_path_free);
+
+    key = compiled_path_key (param_list, start_obj);
+    cached = static_cast<QofQueryCompiledPath*>(g_hash_table_lookup (compiled_paths, key));
+    if (cached)
+    {
+        g_free (key);
+        if (cached->final)
+            *final = cached->final;
+        LEAVE ("cached fcns=%p", cached->fcns);
+        return g_slist_copy (cached->fcns);
+    }
+
     for (; param_list; param_list = param_list->next)
     {
         QofIdType param_name = static_cast<QofIdType>(param_list->data);
@@ -455,9 +549,15 @@ compile_params (QofQueryParamList *param_list, QofIdType start_obj,
         /* And reset for the next parameter */
         start_obj = (QofIdType) objDef->param_type;
     }
+    fcns = g_slist_reverse (fcns);
+
+    cached = g_new0 (QofQueryCompiledPath, 1);
+    cached->fcns = g_slist_copy (fcns);
+    cached->final = fcns ? *final : NULL;
+    g_hash_table_insert (compiled_paths, key, cached);
 
     LEAVE ("fcns=%p", fcns);
-    return (g_slist_reverse (fcns));
+    return fcns;
 }
 
 static void
@@ -536,7 +636,12 @@ static void compile_terms (QofQuery *q)
              */
 
             if (qt->param_fcns && resObj)
-                qt->pred_fcn = qof_query_core_get_predicate (resObj->param_type);
+            {
+                qt->pred_fcn = qof_query_core_get_kernel (resObj->param_type,
+                                                          resObj, qt->pdata);
+                if (!qt->pred_fcn)
+                    qt->pred_fcn = qof_query_core_get_predicate (resObj->param_type);
+            }
             else
                 qt->pred_fcn = NULL;
         }
@@ -723,6 +828,39 @@ void qof_query_purge_terms (QofQuery *q, QofQueryParamList *param_list)
     }
 }
 
+/* Sort only as much as max_results keeps.  The crop below keeps the
+ * last max_results objects, so select those with nth_element and sort
+ * just that tail: O(n + k log k) instead of O(n log n).  Ties are
+ * broken on the original position so the result is exactly what the
+ * stable full sort would produce.  Consumes objects.
+ */
+static GList *
+sort_top_n (GList *objects, guint count, QofQuery *q)
+{
+    using SortItem = std::pair<gpointer, guint>;
+    std::vector<SortItem> items;
+    GList *result = NULL;
+    guint idx = 0;
+
+    items.reserve (count);
+    for (GList *node = objects; node; node = node->next)
+        items.emplace_back (node->data, idx++);
+    g_list_free (objects);
+
+    auto less = [q](const SortItem& a, const SortItem& b)
+    {
+        auto rv = sort_func (a.first, b.first, q);
+        return rv ? rv < 0 : a.second < b.second;
+    };
+    auto first = items.end() - q->max_results;
+    std::nth_element (items.begin(), first, items.end(), less);
+    std::sort (first, items.end(), less);
+
+    for (auto it = items.rbegin(); it != std::make_reverse_iterator (first); ++it)
+        result = g_list_prepend (result, it->first);
+    return result;
+}
+
 static GList * qof_query_run_internal (QofQuery *q,
                                        void(*run_cb)(QofQueryCB*, gpointer),
                                        gpointer cb_arg)
@@ -746,8 +884,10 @@ static GList * qof_query_run_internal (QofQuery *q,
     }
 
     /* Maybe log this sucker */
-    if (qof_log_check (log_module, QOF_LOG_DEBUG))
-        qof_query_print (q);
+    {
+        QOF_LOG_SITE_CHECK (QOF_LOG_DEBUG)
+            qof_query_print (q);
+    }
 
     /* Now run the query over all the objects and save the results */
     {
@@ -776,7 +916,14 @@ static GList * qof_query_run_internal (QofQuery *q,
     if (q->primary_sort.comp_fcn || q->primary_sort.obj_cmp ||
             (q->primary_sort.use_default && q->defaultSort))
     {
-        matching_objects = g_list_sort_with_data(matching_objects, sort_func, q);
+        if (q->max_results > 0 && object_count > q->max_results)
+        {
+            matching_objects = sort_top_n (matching_objects, object_count, q);
+            object_count = q->max_results;
+        }
+        else
+            matching_objects = g_list_sort_with_data(matching_objects,
+                                                     sort_func, q);
     }
 
     /* Crop the list to limit the number of splits. */
@@ -814,6 +961,132 @@ static GList * qof_query_run_internal (QofQuery *q,
     return matching_objects;
 }
 
+void
+qof_query_register_index (QofIdTypeConst obj_type, QofQueryIndexFunc func)
+{
+    g_return_if_fail (obj_type);
+
+    if (!index_funcs)
+        index_funcs = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                             g_free, NULL);
+    if (func)
+        g_hash_table_insert (index_funcs, g_strdup (obj_type),
+                             reinterpret_cast<gpointer>(func));
+    else
+        g_hash_table_remove (index_funcs, obj_type);
+}
+
+static gboolean
+run_index (QofQuery *q, QofBook *book, QofQueryCB *qcb)
+{
+    QofQueryIndexFunc func;
+
+    /* No terms means "match everything"; nothing to narrow down. */
+    if (!index_funcs || !q->terms) return FALSE;
+
+    func = reinterpret_cast<QofQueryIndexFunc>(g_hash_table_lookup (index_funcs,
+                                                                    q->search_for));
+    if (!func) return FALSE;
+
+    if (!func (q, book, (QofInstanceForeachCB) check_item_cb, qcb))
+        return FALSE;
+
+    PINFO ("query %p served by the %s index", q, q->search_for);
+    return TRUE;
+}
+
+/* Full scans of at least this many objects are split across threads
+ * when the query allows it; below that the thread start-up costs more
+ * than it saves. */
+#define QOF_QUERY_PARALLEL_MIN_OBJECTS 20000
+
+static guint parallel_min_objects = QOF_QUERY_PARALLEL_MIN_OBJECTS;
+
+typedef struct
+{
+    const QofQuery *query;
+    const std::vector<gpointer> *objects;
+    std::vector<char> *matched;
+    size_t begin, end;
+} QofQueryScanChunk;
+
+static void
+collect_object_cb (QofInstance *inst, gpointer user_data)
+{
+    static_cast<std::vector<gpointer>*>(user_data)->push_back (inst);
+}
+
+static void
+scan_chunk_job (gpointer data, gpointer user_data)
+{
+    auto chunk = static_cast<QofQueryScanChunk*>(data);
+
+    for (auto i = chunk->begin; i < chunk->end; ++i)
+        (*chunk->matched)[i] = check_object (chunk->query,
+                                             (*chunk->objects)[i]) ? 1 : 0;
+}
+
+/* Evaluate the terms over the book's collection on a thread pool.
+ * Each job only writes its own slice of the match flags; the matches
+ * are then gathered in collection order, so the result is the same as
+ * the serial scan's.  Returns FALSE when the collection is too small to
+ * bother, without having visited anything. */
+static gboolean
+run_parallel_scan (QofQueryCB *qcb, QofBook *book)
+{
+    QofCollection *col = qof_book_get_collection (book, qcb->query->search_for);
+    std::vector<gpointer> objects;
+    std::vector<QofQueryScanChunk> chunks;
+    GThreadPool *pool;
+    GError *error = NULL;
+    guint n_threads = g_get_num_processors ();
+
+    if (n_threads < 2 || qof_collection_count (col) < parallel_min_objects)
+        return FALSE;
+
+    objects.reserve (qof_collection_count (col));
+    qof_object_foreach (qcb->query->search_for, book, collect_object_cb, &objects);
+    std::vector<char> matched (objects.size ());
+
+    /* A few chunks per thread, so that a slow stretch doesn't hold
+     * everything up. */
+    auto n_chunks = n_threads * 4;
+    auto chunk_size = (objects.size () + n_chunks - 1) / n_chunks;
+    for (size_t begin = 0; begin < objects.size (); begin += chunk_size)
+        chunks.push_back ({qcb->query, &objects, &matched, begin,
+                           std::min (begin + chunk_size, objects.size ())});
+
+    pool = g_thread_pool_new (scan_chunk_job, NULL, n_threads, TRUE, &error);
+    if (!pool)
+    {
+        PWARN ("Unable to create thread pool: %s", error->message);
+        g_error_free (error);
+        for (auto& chunk : chunks)
+            scan_chunk_job (&chunk, NULL);
+    }
+    else
+    {
+        for (auto& chunk : chunks)
+            g_thread_pool_push (pool, &chunk, NULL);
+        g_thread_pool_free (pool, FALSE, TRUE);
+    }
+
+    for (size_t i = 0; i < objects.size (); ++i)
+    {
+        if (!matched[i]) continue;
+        qcb->list = g_list_prepend (qcb->list, objects[i]);
+        qcb->count++;
+    }
+    PINFO ("scanned %zu objects on %u threads", objects.size (), n_threads);
+    return TRUE;
+}
+
+void
+qof_query_set_parallel_min_objects (guint n_objects)
+{
+    parallel_min_objects = n_objects ? n_objects : QOF_QUERY_PARALLEL_MIN_OBJECTS;
+}
+
 static void qof_query_run_cb(QofQueryCB* qcb, gpointer cb_arg)
 {
     GList *node;
@@ -839,16 +1112,208 @@ static void qof_query_run_cb(QofQueryCB* qcb, gpointer cb_arg)
             }
         }
 #endif
-        /* And then iterate over all the objects */
-        qof_object_foreach (qcb->query->search_for, book,
-                            (QofInstanceForeachCB) check_item_cb, qcb);
+        /* And then iterate over all the objects, or over the subset an
+         * index says could match. */
+        auto start = qof_stat_timer_start ();
+        if (run_index (qcb->query, book, qcb))
+            qof_stat_timer_stop (qof_stat_cached (&index_stat, "query.index"), start);
+        else if (qcb->query->parallel && run_parallel_scan (qcb, book))
+            qof_stat_timer_stop (qof_stat_cached (&parallel_scan_stat,
+                                                  "query.parallel-scan"), start);
+        else
+        {
+            qof_object_foreach (qcb->query->search_for, book,
+                                (QofInstanceForeachCB) check_item_cb, qcb);
+            qof_stat_timer_stop (qof_stat_cached (&scan_stat, "query.full-scan"), start);
+        }
+    }
+}
+
+/* Live queries ==================================================== */
+
+/* What the event handler records for each changed object. */
+#define LIVE_CHANGED GUINT_TO_POINTER (1)
+#define LIVE_GONE    GUINT_TO_POINTER (2)
+
+struct LiveRelation
+{
+    char *obj_type;
+    char *changed_type;
+    QofQueryRelatedFunc func;
+};
+
+static std::vector<LiveRelation> live_relations;
+
+void
+qof_query_register_related (QofIdTypeConst obj_type, QofIdTypeConst changed_type,
+                            QofQueryRelatedFunc func)
+{
+    g_return_if_fail (obj_type && changed_type && func);
+
+    for (const auto& rel : live_relations)
+        if (!g_strcmp0 (rel.obj_type, obj_type) &&
+            !g_strcmp0 (rel.changed_type, changed_type) && rel.func == func)
+            return;
+    live_relations.push_back ({g_strdup (obj_type), g_strdup (changed_type), func});
+}
+
+static void
+live_relations_clear (void)
+{
+    for (auto& rel : live_relations)
+    {
+        g_free (rel.obj_type);
+        g_free (rel.changed_type);
+    }
+    live_relations.clear ();
+}
+
+/* A related object's change doesn't undo a destroy seen before it. */
+static void
+live_mark_related (QofInstance *inst, gpointer data)
+{
+    QofQuery *q = static_cast<QofQuery*>(data);
+
+    if (!g_hash_table_contains (q->live_pending, inst))
+        g_hash_table_insert (q->live_pending, inst, LIVE_CHANGED);
+}
+
+static void
+live_query_event_cb (QofInstance *ent, QofEventId event_type,
+                     gpointer handler_data, gpointer event_data)
+{
+    QofQuery *q = static_cast<QofQuery*>(handler_data);
+
+    if (!q->live_valid || !ent) return;
+    /* A book's objects are freed without events of their own. */
+    if (QOF_IS_BOOK (ent) && (event_type & QOF_EVENT_DESTROY))
+    {
+        if (g_list_find (q->books, ent))
+            q->live_valid = FALSE;
+        return;
+    }
+    if (!(event_type & (QOF_EVENT_CREATE | QOF_EVENT_MODIFY | QOF_EVENT_ADD |
+                        QOF_EVENT_REMOVE | QOF_EVENT_DESTROY)))
+        return;
+    if (!g_list_find (q->books, qof_instance_get_book (ent))) return;
+    if (g_strcmp0 (ent->e_type, q->search_for))
+    {
+        /* Editing, say, a transaction's date changes which of its
+         * splits match without modifying them. */
+        if (event_type & QOF_EVENT_MODIFY)
+            for (const auto& rel : live_relations)
+                if (!g_strcmp0 (rel.obj_type, q->search_for) &&
+                    !g_strcmp0 (rel.changed_type, ent->e_type))
+                    rel.func (ent, live_mark_related, q);
+        return;
+    }
+
+    g_hash_table_insert (q->live_pending, ent,
+                         event_type == QOF_EVENT_DESTROY ? LIVE_GONE : LIVE_CHANGED);
+}
+
+/* Merge two lists that are each sorted by sort_func.  Consumes both. */
+static GList *
+live_merge_sorted (GList *a, GList *b, QofQuery *q)
+{
+    GList *result = NULL;
+
+    while (a && b)
+    {
+        GList **from = sort_func (b->data, a->data, q) < 0 ? &b : &a;
+        GList *link = *from;
+        *from = g_list_remove_link (*from, link);
+        result = g_list_concat (link, result);
+    }
+    result = g_list_reverse (result);
+    return g_list_concat (result, a ? a : b);
+}
+
+/* Bring the results of a live query up to date from the objects that
+ * changed since the last run, without scanning the book.  Returns FALSE
+ * if the query has to be run in full instead. */
+static gboolean
+live_query_update (QofQuery *q)
+{
+    GHashTableIter iter;
+    gpointer key, value;
+    GList *added = NULL;
+    guint n_added = 0;
+
+    if (!q->live_valid || q->changed || q->max_results >= 0 ||
+        q->live_dropped != qof_event_get_dropped_count ())
+        return FALSE;
+    if (!g_hash_table_size (q->live_pending))
+        return TRUE;
+
+    /* Take every changed object out; the ones that still match go back. */
+    for (GList *node = q->results, *next; node; node = next)
+    {
+        next = node->next;
+        if (g_hash_table_contains (q->live_pending, node->data))
+            q->results = g_list_delete_link (q->results, node);
+    }
+
+    g_hash_table_iter_init (&iter, q->live_pending);
+    while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+        if (value == LIVE_CHANGED && check_object (q, key))
+        {
+            added = g_list_prepend (added, key);
+            n_added++;
+        }
+    }
+    g_hash_table_remove_all (q->live_pending);
+
+    if (q->primary_sort.comp_fcn || q->primary_sort.obj_cmp ||
+            (q->primary_sort.use_default && q->defaultSort))
+    {
+        added = g_list_sort_with_data (added, sort_func, q);
+        q->results = live_merge_sorted (q->results, added, q);
+    }
+    else
+        q->results = g_list_concat (q->results, added);
+
+    PINFO ("live query %p updated, %u changed objects match", q, n_added);
+    return TRUE;
+}
+
+void
+qof_query_set_live (QofQuery *q, gboolean live)
+{
+    if (!q) return;
+
+    if (live && !q->live_handler_id)
+    {
+        q->live_pending = g_hash_table_new (g_direct_hash, g_direct_equal);
+        q->live_handler_id = qof_event_register_handler (live_query_event_cb, q);
+    }
+    else if (!live && q->live_handler_id)
+    {
+        qof_event_unregister_handler (q->live_handler_id);
+        g_hash_table_destroy (q->live_pending);
+        q->live_handler_id = 0;
+        q->live_pending = NULL;
     }
+    q->live_valid = FALSE;
 }
 
 GList * qof_query_run (QofQuery *q)
 {
-    /* Just a wrapper */
-    return qof_query_run_internal(q, qof_query_run_cb, NULL);
+    GList *results;
+
+    if (q && q->live_handler_id && live_query_update (q))
+        return q->results;
+
+    results = qof_query_run_internal(q, qof_query_run_cb, NULL);
+
+    if (q && q->live_handler_id)
+    {
+        g_hash_table_remove_all (q->live_pending);
+        q->live_valid = TRUE;
+        q->live_dropped = qof_event_get_dropped_count ();
+    }
+    return results;
 }
 
 static void qof_query_run_subq_cb(QofQueryCB* qcb, gpointer cb_arg)
@@ -872,6 +1337,7 @@ qof_query_run_subquery (QofQuery *subq, const QofQuery* primaryq)
                          NULL);
 
     /* Perform the subquery */
+    subq->live_valid = FALSE;
     return qof_query_run_internal(subq, qof_query_run_subq_cb,
                                   (gpointer)primaryq);
 }
@@ -992,6 +1458,7 @@ GSList * qof_query_get_term_type (QofQuery *q, QofQueryParamList *term_param)
 void qof_query_destroy (QofQuery *q)
 {
     if (!q) return;
+    qof_query_set_live (q, FALSE);
     free_members (q);
     query_clear_compiles (q);
     g_hash_table_destroy (q->be_compiled);
@@ -1011,6 +1478,9 @@ QofQuery * qof_query_copy (QofQuery *q)
     memcpy (copy, q, sizeof (QofQuery));
 
     copy->be_compiled = ht;
+    copy->live_handler_id = 0;
+    copy->live_pending = NULL;
+    copy->live_valid = FALSE;
     copy->terms = copy_or_terms (q->terms);
     copy->books = g_list_copy (q->books);
     copy->results = g_list_copy (q->results);
@@ -1232,6 +1702,7 @@ qof_query_set_sort_order (QofQuery *q,
                           QofQueryParamList *params1, QofQueryParamList *params2, QofQueryParamList *params3)
 {
     if (!q) return;
+    q->live_valid = FALSE;
     if (q->primary_sort.param_list)
         g_slist_free (q->primary_sort.param_list);
     q->primary_sort.param_list = params1;
@@ -1254,6 +1725,7 @@ void qof_query_set_sort_options (QofQuery *q, gint prim_op, gint sec_op,
                                  gint tert_op)
 {
     if (!q) return;
+    q->live_valid = FALSE;
     q->primary_sort.options = prim_op;
     q->secondary_sort.options = sec_op;
     q->tertiary_sort.options = tert_op;
@@ -1263,6 +1735,7 @@ void qof_query_set_sort_increasing (QofQuery *q, gboolean prim_inc,
                                     gboolean sec_inc, gboolean tert_inc)
 {
     if (!q) return;
+    q->live_valid = FALSE;
     q->primary_sort.increasing = prim_inc;
     q->secondary_sort.increasing = sec_inc;
     q->tertiary_sort.increasing = tert_inc;
@@ -1271,9 +1744,16 @@ void qof_query_set_sort_increasing (QofQuery *q, gboolean prim_inc,
 void qof_query_set_max_results (QofQuery *q, int n)
 {
     if (!q) return;
+    q->live_valid = FALSE;
     q->max_results = n;
 }
 
+void qof_query_set_parallel (QofQuery *q, gboolean parallel)
+{
+    if (!q) return;
+    q->parallel = parallel;
+}
+
 void qof_query_add_guid_list_match (QofQuery *q, QofQueryParamList *param_list,
                                     GList *guid_list, QofGuidMatch options,
                                     QofQueryOp op)
@@ -1349,6 +1829,14 @@ void qof_query_init (void)
 
 void qof_query_shutdown (void)
 {
+    {
+        std::lock_guard<std::mutex> lock {compiled_paths_mutex};
+        compiled_paths_clear ();
+    }
+    live_relations_clear ();
+    if (index_funcs)
+        g_hash_table_destroy (index_funcs);
+    index_funcs = NULL;
     qof_class_shutdown ();
     qof_query_core_shutdown ();
 }
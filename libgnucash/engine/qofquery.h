@@ -360,6 +360,38 @@ void qof_query_set_sort_increasing (QofQuery *q, gboolean prim_inc,
  */
 void qof_query_set_max_results (QofQuery *q, int n);
 
+/** Allow qof_query_run() to evaluate the query's terms on several
+ * threads when it has to scan a large collection.  Matches are
+ * gathered in the same order as the serial scan, so the results are
+ * identical.
+ *
+ * Only set this when every parameter getter the terms use is a plain
+ * read of committed data.  Some getters (a transaction's imbalance, for
+ * instance) fill in caches on the object and must not run
+ * concurrently.  Defaults to FALSE.
+ */
+void qof_query_set_parallel (QofQuery *q, gboolean parallel);
+
+/** Keep the query's results up to date from engine events.
+ *
+ * A live query watches the create, modify and destroy events for the
+ * type it searches for.  When qof_query_run() is called again and
+ * nothing but objects have changed, only those objects are re-tested
+ * and merged into the previous results instead of searching the whole
+ * book again.  Changing the terms, sort or book, setting max_results,
+ * or events having been suspended and dropped in between makes the
+ * next run a full one.
+ *
+ * The searched-for objects' own events are followed, and the modify
+ * events of the types their object module registered as related: a
+ * committed edit to a transaction re-tests all its splits, so a split
+ * query sees a changed date posted, num, description or void state.
+ * Other related objects aren't followed, so renaming the account a
+ * split query sorts on will not be seen until it also modifies the
+ * splits.
+ */
+void qof_query_set_live (QofQuery *q, gboolean live);
+
 /** Compare two queries for equality.
  * Query terms are compared each to each.
  * This is a simplistic
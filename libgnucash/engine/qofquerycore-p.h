@@ -49,6 +49,14 @@ typedef gint (*QofQueryPredicateFunc) (gpointer object,
 QofQueryPredicateFunc qof_query_core_get_predicate (gchar const *type);
 QofCompareFunc qof_query_core_get_compare (gchar const *type);
 
+/* A predicate specialized for this predicate data, for use in place of
+ * qof_query_core_get_predicate (type) when compiling a query term.
+ * Returns NULL if there is no specialized version; the caller then uses
+ * the generic one. */
+QofQueryPredicateFunc qof_query_core_get_kernel (gchar const *type,
+                                                 const QofParam *getter,
+                                                 const QofQueryPredData *pd);
+
 /* Compare two predicates */
 gboolean qof_query_core_predicate_equal (const QofQueryPredData *p1, const QofQueryPredData *p2);
 
@@ -69,6 +77,11 @@ typedef struct
     gboolean		is_regex;
     gchar *		matchstring;
     regex_t		compiled;
+    /* For case-insensitive matching: matchstring case folded, and
+     * case folded and normalized, computed once up front. */
+    gchar *		folded;
+    gchar *		folded_normalized;
+    gboolean		folded_is_ascii;
 } query_string_def, *query_string_t;
 
 typedef struct
@@ -125,6 +125,55 @@ static GHashTable *predEqualTable = NULL;
 
 /* QOF_TYPE_STRING */
 
+static gboolean
+string_is_ascii (const char *s)
+{
+    for (; *s; ++s)
+        if (static_cast<guchar>(*s) & 0x80)
+            return FALSE;
+    return TRUE;
+}
+
+/* Case-insensitive substring search with the needle already folded
+ * and normalized.  ASCII text folds to lower case and normalizes to
+ * itself, so plain ASCII haystacks are searched in place. */
+static gboolean
+string_contains_nocase (const char *s, const query_string_t pdata)
+{
+    if (string_is_ascii (s))
+    {
+        const char *needle = pdata->folded_normalized;
+        size_t len;
+
+        /* A normalized non-ASCII needle can't occur in ASCII text. */
+        if (!pdata->folded_is_ascii)
+            return FALSE;
+        len = strlen (needle);
+        for (; *s; ++s)
+            if (!g_ascii_strncasecmp (s, needle, len))
+                return TRUE;
+        return len == 0;
+    }
+
+    auto casefold = g_utf8_casefold (s, -1);
+    auto normalized = g_utf8_normalize (casefold, -1, G_NORMALIZE_ALL);
+    auto found = normalized && strstr (normalized, pdata->folded_normalized);
+    g_free (casefold);
+    g_free (normalized);
+    return found;
+}
+
+/* What safe_strcasecmp (s, matchstring) == 0 tests, with the
+ * matchstring folded only once. */
+static gboolean
+string_equal_nocase (const char *s, const query_string_t pdata)
+{
+    auto casefold = g_utf8_casefold (s, -1);
+    auto equal = g_utf8_collate (casefold, pdata->folded) == 0;
+    g_free (casefold);
+    return equal;
+}
+
 static int
 string_match_predicate (gpointer object,
                         QofParam *getter,
@@ -152,12 +201,12 @@ string_match_predicate (gpointer object,
         {
             if (pd->how == QOF_COMPARE_CONTAINS || pd->how == QOF_COMPARE_NCONTAINS)
             {
-                if (qof_utf8_substr_nocase (s, pdata->matchstring)) //uses strstr
+                if (string_contains_nocase (s, pdata)) //uses strstr
                     ret = 1;
             }
             else
             {
-                 if (safe_strcasecmp (s, pdata->matchstring) == 0) //uses collate
+                 if (string_equal_nocase (s, pdata)) //uses collate
                     ret = 1;
             }
         }
@@ -249,6 +298,8 @@ string_free_pdata (QofQueryPredData *pd)
         regfree (&pdata->compiled);
 
     g_free (pdata->matchstring);
+    g_free (pdata->folded);
+    g_free (pdata->folded_normalized);
     g_free (pdata);
 }
 
@@ -309,6 +360,15 @@ qof_query_string_predicate (QofQueryCompare how,
         }
         pdata->is_regex = TRUE;
     }
+    else if (options == QOF_STRING_MATCH_CASEINSENSITIVE)
+    {
+        pdata->folded = g_utf8_casefold (str, -1);
+        pdata->folded_normalized = g_utf8_normalize (pdata->folded, -1,
+                                                     G_NORMALIZE_ALL);
+        if (!pdata->folded_normalized)
+            pdata->folded_normalized = g_strdup (pdata->folded);
+        pdata->folded_is_ascii = string_is_ascii (pdata->folded_normalized);
+    }
 
     return ((QofQueryPredData*)pdata);
 }
@@ -1752,6 +1812,147 @@ qof_query_core_get_predicate (QofType type)
     return reinterpret_cast<QofQueryPredicateFunc>(g_hash_table_lookup (predTable, type));
 }
 
+/* Typed predicate kernels.
+ *
+ * The registered predicates re-check their arguments and switch on the
+ * comparison (and options) for every object.  For the plain scalar core
+ * types, qof_query_core_get_kernel picks an instantiation with those
+ * resolved at compile time; the checks are done once, when the query
+ * term is compiled.
+ */
+template <QofQueryCompare how, typename T> static inline int
+compare_how (T a, T b)
+{
+    if constexpr (how == QOF_COMPARE_LT) return a < b;
+    else if constexpr (how == QOF_COMPARE_LTE) return a <= b;
+    else if constexpr (how == QOF_COMPARE_EQUAL) return a == b;
+    else if constexpr (how == QOF_COMPARE_GT) return a > b;
+    else if constexpr (how == QOF_COMPARE_GTE) return a >= b;
+    else return a != b;
+}
+
+template <typename Getter, typename PData>
+struct ScalarKernel
+{
+    template <QofQueryCompare how> static int
+    match (gpointer object, QofParam *getter, QofQueryPredData *pd)
+    {
+        auto val = ((Getter)getter->param_getfcn) (object, getter);
+        return compare_how<how> (val, ((PData)pd)->val);
+    }
+};
+
+using Int32Kernel = ScalarKernel<query_int32_getter, query_int32_t>;
+using Int64Kernel = ScalarKernel<query_int64_getter, query_int64_t>;
+using DoubleKernel = ScalarKernel<query_double_getter, query_double_t>;
+
+template <bool by_day>
+struct DateKernel
+{
+    template <QofQueryCompare how> static int
+    match (gpointer object, QofParam *getter, QofQueryPredData *pd)
+    {
+        time64 t = ((query_date_getter)getter->param_getfcn) (object, getter);
+        time64 date = ((query_date_t)pd)->date;
+        if constexpr (by_day)
+        {
+            t = time64CanonicalDayTime (t);
+            date = time64CanonicalDayTime (date);
+        }
+        return compare_how<how> (t, date);
+    }
+};
+
+/* Only the ordering comparisons; EQUAL and NEQ use an epsilon and stay
+ * with numeric_match_predicate. */
+template <QofNumericMatch sign>
+struct NumericKernel
+{
+    template <QofQueryCompare how> static int
+    match (gpointer object, QofParam *getter, QofQueryPredData *pd)
+    {
+        gnc_numeric val = ((query_numeric_getter)getter->param_getfcn) (object, getter);
+        if constexpr (sign == QOF_NUMERIC_MATCH_CREDIT)
+        {
+            if (gnc_numeric_positive_p (val)) return 0;
+        }
+        else if constexpr (sign == QOF_NUMERIC_MATCH_DEBIT)
+        {
+            if (gnc_numeric_negative_p (val)) return 0;
+        }
+        return compare_how<how> (gnc_numeric_compare (gnc_numeric_abs (val),
+                                                      ((query_numeric_t)pd)->amount), 0);
+    }
+};
+
+template <typename Kernel> static QofQueryPredicateFunc
+kernel_for (QofQueryCompare how)
+{
+    switch (how)
+    {
+    case QOF_COMPARE_LT:
+        return Kernel::template match<QOF_COMPARE_LT>;
+    case QOF_COMPARE_LTE:
+        return Kernel::template match<QOF_COMPARE_LTE>;
+    case QOF_COMPARE_EQUAL:
+        return Kernel::template match<QOF_COMPARE_EQUAL>;
+    case QOF_COMPARE_GT:
+        return Kernel::template match<QOF_COMPARE_GT>;
+    case QOF_COMPARE_GTE:
+        return Kernel::template match<QOF_COMPARE_GTE>;
+    case QOF_COMPARE_NEQ:
+        return Kernel::template match<QOF_COMPARE_NEQ>;
+    default:
+        return NULL;
+    }
+}
+
+template <typename Kernel> static QofQueryPredicateFunc
+ordering_kernel_for (QofQueryCompare how)
+{
+    if (how == QOF_COMPARE_EQUAL || how == QOF_COMPARE_NEQ)
+        return NULL;
+    return kernel_for<Kernel> (how);
+}
+
+QofQueryPredicateFunc
+qof_query_core_get_kernel (QofType type, const QofParam *getter,
+                           const QofQueryPredData *pd)
+{
+    if (!type || !getter || !getter->param_getfcn || !pd || !pd->type_name)
+        return NULL;
+    if (g_strcmp0 (type, pd->type_name))
+        return NULL;
+
+    /* The kernels stand in for the built-in predicates only. */
+    auto pred = qof_query_core_get_predicate (type);
+    if (pred == int64_match_predicate)
+        return kernel_for<Int64Kernel> (pd->how);
+    if (pred == int32_match_predicate)
+        return kernel_for<Int32Kernel> (pd->how);
+    if (pred == double_match_predicate)
+        return kernel_for<DoubleKernel> (pd->how);
+    if (pred == date_match_predicate)
+    {
+        if (((const query_date_def*)pd)->options == QOF_DATE_MATCH_DAY)
+            return kernel_for<DateKernel<true>> (pd->how);
+        return kernel_for<DateKernel<false>> (pd->how);
+    }
+    if (pred == numeric_match_predicate)
+    {
+        switch (((const query_numeric_def*)pd)->options)
+        {
+        case QOF_NUMERIC_MATCH_CREDIT:
+            return ordering_kernel_for<NumericKernel<QOF_NUMERIC_MATCH_CREDIT>> (pd->how);
+        case QOF_NUMERIC_MATCH_DEBIT:
+            return ordering_kernel_for<NumericKernel<QOF_NUMERIC_MATCH_DEBIT>> (pd->how);
+        default:
+            return ordering_kernel_for<NumericKernel<QOF_NUMERIC_MATCH_ANY>> (pd->how);
+        }
+    }
+    return NULL;
+}
+
 QofCompareFunc
 qof_query_core_get_compare (QofType type)
 {
@@ -51,6 +51,7 @@ extern "C"
 
 #include "qof.h"
 #include "qofobject-p.h"
+#include "gnc-uri-utils.h"
 
 static QofLogModule log_module = QOF_MOD_SESSION;
 } //extern 'C'
@@ -198,6 +199,18 @@ QofSessionImpl::load_backend (std::string access_method) noexcept
     LEAVE (" ");
 }
 
+/* The session's URI for a trace span, without any password in it. */
+static std::string
+trace_uri (const std::string& uri)
+{
+    if (!qof_trace_is_recording () || uri.empty ())
+        return {};
+    auto normalized = gnc_uri_normalize_uri (uri.c_str (), FALSE);
+    std::string result {normalized ? normalized : ""};
+    g_free (normalized);
+    return result;
+}
+
 void
 QofSessionImpl::load (QofPercentageFunc percentage_func) noexcept
 {
@@ -206,6 +219,7 @@ QofSessionImpl::load (QofPercentageFunc percentage_func) noexcept
 
     if (!m_uri.size ()) return;
     ENTER ("sess=%p uri=%s", this, m_uri.c_str ());
+    QofTraceSpan span {"session", "load", trace_uri (m_uri).c_str ()};
 
     /* At this point, we should are supposed to have a valid book
      * id and a lock on the file. */
@@ -444,6 +458,7 @@ QofSessionImpl::save (QofPercentageFunc percentage_func) noexcept
         return;
     m_saving = true;
     ENTER ("sess=%p uri=%s", this, m_uri.c_str ());
+    QofTraceSpan span {"session", "save", trace_uri (m_uri).c_str ()};
 
     /* If there is a backend, the book is dirty, and the backend is reachable
      * (i.e. we can communicate with it), then synchronize with the backend.  If
@@ -482,6 +497,7 @@ void
 QofSessionImpl::safe_save (QofPercentageFunc percentage_func) noexcept
 {
     if (!(m_backend && m_book)) return;
+    QofTraceSpan span {"session", "safe-save", trace_uri (m_uri).c_str ()};
     if (qof_book_get_backend (m_book) != m_backend)
         qof_book_set_backend (m_book, m_backend);
     m_backend->set_percentage(percentage_func);
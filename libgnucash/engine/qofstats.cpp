@@ -0,0 +1,148 @@
+/********************************************************************
+ * qofstats.cpp -- counters and timers for the engine's hot paths   *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ ********************************************************************/
+
+extern "C"
+{
+#include <config.h>
+#include "qofstats.h"
+}
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+struct QofStat
+{
+    std::atomic<guint64> count {0};
+    std::atomic<gint64> usecs {0};
+};
+
+using QofStatMap = std::map<std::string, std::unique_ptr<QofStat>>;
+
+static std::mutex stats_mutex;
+
+/* Never freed: stats are bumped and dumped from atexit handlers and
+ * static destructors, after a function-local static would be gone. */
+static QofStatMap&
+stats_map ()
+{
+    static auto map = new QofStatMap;
+    return *map;
+}
+
+QofStat *
+qof_stat_lookup (const char *name)
+{
+    g_return_val_if_fail (name, nullptr);
+    std::lock_guard<std::mutex> lock {stats_mutex};
+    auto& stat = stats_map ()[name];
+    if (!stat)
+        stat.reset (new QofStat);
+    return stat.get ();
+}
+
+void
+qof_stat_add (QofStat *stat, guint64 n)
+{
+    if (stat)
+        stat->count.fetch_add (n, std::memory_order_relaxed);
+}
+
+gint64
+qof_stat_timer_start (void)
+{
+    return g_get_monotonic_time ();
+}
+
+void
+qof_stat_timer_stop (QofStat *stat, gint64 start)
+{
+    if (!stat) return;
+    stat->count.fetch_add (1, std::memory_order_relaxed);
+    stat->usecs.fetch_add (g_get_monotonic_time () - start,
+                           std::memory_order_relaxed);
+}
+
+static const QofStat *
+find_stat (const char *name)
+{
+    if (!name) return nullptr;
+    std::lock_guard<std::mutex> lock {stats_mutex};
+    auto it = stats_map ().find (name);
+    return it == stats_map ().end () ? nullptr : it->second.get ();
+}
+
+guint64
+qof_stat_get_count (const char *name)
+{
+    auto stat = find_stat (name);
+    return stat ? stat->count.load (std::memory_order_relaxed) : 0;
+}
+
+gint64
+qof_stat_get_usecs (const char *name)
+{
+    auto stat = find_stat (name);
+    return stat ? stat->usecs.load (std::memory_order_relaxed) : 0;
+}
+
+void
+qof_stat_foreach (QofStatForeachCB cb, gpointer user_data)
+{
+    g_return_if_fail (cb);
+    std::lock_guard<std::mutex> lock {stats_mutex};
+    for (const auto& entry : stats_map ())
+        cb (entry.first.c_str (),
+            entry.second->count.load (std::memory_order_relaxed),
+            entry.second->usecs.load (std::memory_order_relaxed),
+            user_data);
+}
+
+static void
+dump_stat_cb (const char *name, guint64 count, gint64 usecs, gpointer user_data)
+{
+    auto str = static_cast<GString*>(user_data);
+    g_string_append_printf (str, "%-40s %12" G_GUINT64_FORMAT " %12.3f\n",
+                            name, count, usecs / 1000.0);
+}
+
+gchar *
+qof_stat_dump (void)
+{
+    auto str = g_string_new (nullptr);
+    g_string_append_printf (str, "%-40s %12s %12s\n", "stat", "count", "ms");
+    qof_stat_foreach (dump_stat_cb, str);
+    return g_string_free (str, FALSE);
+}
+
+void
+qof_stat_reset (void)
+{
+    std::lock_guard<std::mutex> lock {stats_mutex};
+    for (auto& entry : stats_map ())
+    {
+        entry.second->count.store (0, std::memory_order_relaxed);
+        entry.second->usecs.store (0, std::memory_order_relaxed);
+    }
+}
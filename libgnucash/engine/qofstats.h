@@ -0,0 +1,125 @@
+/********************************************************************
+ * qofstats.h -- counters and timers for the engine's hot paths     *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ ********************************************************************/
+
+/** @addtogroup Stats Statistics
+    @ingroup QOF
+
+    Named counters, each with a total of the time spent in what it
+    counts, that the engine and backends bump on their expensive paths:
+    full balance recomputations, split sorts, query scans, event
+    dispatches, SQL commits and the like.  They are always on; a count
+    is one relaxed atomic add and a timed event two reads of the
+    monotonic clock, so they can be left in production builds and read
+    when a session is slow.
+
+    Names are dotted, subsystem first, e.g. "account.recompute-balance".
+@{
+*/
+/** @file qofstats.h
+    @brief Counters and timers for the engine's hot paths
+*/
+
+#ifndef QOF_STATS_H
+#define QOF_STATS_H
+
+#include <glib.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct QofStat QofStat;
+
+/** Find the stat called name, creating it at zero if it doesn't exist
+ *  yet.  The result is valid for the life of the program, so callers
+ *  can keep it; see qof_stat_cached(). */
+QofStat *qof_stat_lookup (const char *name);
+
+/** Add n to the stat's count. */
+void qof_stat_add (QofStat *stat, guint64 n);
+
+/** Returns a starting time for qof_stat_timer_stop(). */
+gint64 qof_stat_timer_start (void);
+
+/** Count one event on the stat and add the time since start, from
+ *  qof_stat_timer_start(), to its total. */
+void qof_stat_timer_stop (QofStat *stat, gint64 start);
+
+/** The stat's count, or 0 if there is no stat called name. */
+guint64 qof_stat_get_count (const char *name);
+
+/** The microseconds timed on the stat, or 0 if there is no stat
+ *  called name or it isn't timed. */
+gint64 qof_stat_get_usecs (const char *name);
+
+typedef void (*QofStatForeachCB) (const char *name, guint64 count,
+                                  gint64 usecs, gpointer user_data);
+
+/** Call cb for every stat, in name order. */
+void qof_stat_foreach (QofStatForeachCB cb, gpointer user_data);
+
+/** All the stats as text, one per line: the name, the count and the
+ *  milliseconds timed.  The caller must g_free the result. */
+gchar *qof_stat_dump (void);
+
+/** Set every count and time back to zero. */
+void qof_stat_reset (void);
+
+/** Returns *cache, first setting it to the stat called name if it is
+ *  NULL, so that a call site looks its stat up only once:
+ *
+ *  @code
+ *  static QofStat *sort_stat;
+ *  auto start = qof_stat_timer_start ();
+ *  ...
+ *  qof_stat_timer_stop (qof_stat_cached (&sort_stat, "account.sort-splits"), start);
+ *  @endcode
+ */
+static inline QofStat *
+qof_stat_cached (QofStat **cache, const char *name)
+{
+    if (G_UNLIKELY (!*cache))
+        *cache = qof_stat_lookup (name);
+    return *cache;
+}
+
+#ifdef __cplusplus
+}
+
+/** Times the rest of the enclosing scope on a stat, for functions with
+ *  several ways out. */
+class QofStatTimer
+{
+public:
+    QofStatTimer (QofStat *stat) : m_stat {stat}, m_start {qof_stat_timer_start ()} {}
+    ~QofStatTimer () { qof_stat_timer_stop (m_stat, m_start); }
+    QofStatTimer (const QofStatTimer&) = delete;
+    QofStatTimer& operator= (const QofStatTimer&) = delete;
+private:
+    QofStat *m_stat;
+    gint64 m_start;
+};
+#endif
+
+#endif /* QOF_STATS_H */
+/** @} */
@@ -0,0 +1,209 @@
+/********************************************************************
+ * qoftrace.cpp -- timed spans exported as Chrome trace JSON        *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ ********************************************************************/
+
+extern "C"
+{
+#include <config.h>
+#include "qoftrace.h"
+}
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct TraceSpan
+{
+    std::string category;
+    std::string name;
+    std::string detail;
+    gint64 start;
+    gint64 duration;
+    int thread;
+};
+
+/* A span still open on this thread.  depth is the nesting level it
+ * was opened at, so that qof_trace_end() can tell whether the span it
+ * closes was opened while recording. */
+struct OpenSpan
+{
+    guint depth;
+    TraceSpan span;
+};
+
+/* Enough for a very long session; past it spans are counted, not kept. */
+static constexpr size_t max_spans = 1 << 20;
+
+static std::atomic<bool> recording {false};
+static std::atomic<int> next_thread {1};
+static std::mutex trace_mutex;
+static gint64 trace_origin;
+static guint dropped_spans;
+
+thread_local static guint span_depth;
+thread_local static std::vector<OpenSpan> open_spans;
+thread_local static int this_thread;
+
+/* Never freed, so that a trace can be written from an atexit handler. */
+static std::vector<TraceSpan>&
+trace_spans ()
+{
+    static auto spans = new std::vector<TraceSpan>;
+    return *spans;
+}
+
+void
+qof_trace_start (void)
+{
+    std::lock_guard<std::mutex> lock {trace_mutex};
+    trace_spans ().clear ();
+    dropped_spans = 0;
+    trace_origin = g_get_monotonic_time ();
+    recording.store (true, std::memory_order_release);
+}
+
+void
+qof_trace_stop (void)
+{
+    recording.store (false, std::memory_order_release);
+}
+
+gboolean
+qof_trace_is_recording (void)
+{
+    return recording.load (std::memory_order_acquire);
+}
+
+void
+qof_trace_begin (const char *category, const char *name, const char *detail)
+{
+    ++span_depth;
+    if (!recording.load (std::memory_order_acquire))
+        return;
+    if (!this_thread)
+        this_thread = next_thread++;
+    open_spans.push_back ({span_depth,
+            {category ? category : "", name ? name : "",
+             detail ? detail : "", g_get_monotonic_time (), 0, this_thread}});
+}
+
+void
+qof_trace_end (void)
+{
+    g_return_if_fail (span_depth > 0);
+    if (!open_spans.empty () && open_spans.back ().depth == span_depth)
+    {
+        auto span = std::move (open_spans.back ().span);
+        open_spans.pop_back ();
+        span.duration = g_get_monotonic_time () - span.start;
+        if (recording.load (std::memory_order_acquire))
+        {
+            std::lock_guard<std::mutex> lock {trace_mutex};
+            if (trace_spans ().size () < max_spans)
+                trace_spans ().push_back (std::move (span));
+            else
+                ++dropped_spans;
+        }
+    }
+    --span_depth;
+}
+
+guint
+qof_trace_get_count (void)
+{
+    std::lock_guard<std::mutex> lock {trace_mutex};
+    return trace_spans ().size ();
+}
+
+void
+qof_trace_clear (void)
+{
+    std::lock_guard<std::mutex> lock {trace_mutex};
+    trace_spans ().clear ();
+    dropped_spans = 0;
+}
+
+static void
+write_json_string (std::ostream& out, const std::string& str)
+{
+    out << '"';
+    for (auto c : str)
+    {
+        switch (c)
+        {
+        case '"':  out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\t': out << "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char buf[8];
+                g_snprintf (buf, sizeof (buf), "\\u%04x", c);
+                out << buf;
+            }
+            else
+                out << c;
+        }
+    }
+    out << '"';
+}
+
+/* The spans become complete ("X") events with times in microseconds
+ * from qof_trace_start(); the format is described in Google's "Trace
+ * Event Format" document. */
+gboolean
+qof_trace_write (const char *filename)
+{
+    g_return_val_if_fail (filename, FALSE);
+    std::ofstream out {filename, std::ios::out | std::ios::trunc};
+    if (!out)
+        return FALSE;
+
+    std::lock_guard<std::mutex> lock {trace_mutex};
+    out << "{\"displayTimeUnit\": \"ms\",\n"
+        << " \"otherData\": {\"dropped_spans\": " << dropped_spans << "},\n"
+        << " \"traceEvents\": [\n"
+        << "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, "
+        << "\"args\": {\"name\": \"" PACKAGE_NAME "\"}}";
+    for (const auto& span : trace_spans ())
+    {
+        out << ",\n  {\"name\": ";
+        write_json_string (out, span.name);
+        out << ", \"cat\": ";
+        write_json_string (out, span.category);
+        out << ", \"ph\": \"X\", \"ts\": " << span.start - trace_origin
+            << ", \"dur\": " << span.duration
+            << ", \"pid\": 1, \"tid\": " << span.thread;
+        if (!span.detail.empty ())
+        {
+            out << ", \"args\": {\"detail\": ";
+            write_json_string (out, span.detail);
+            out << "}";
+        }
+        out << "}";
+    }
+    out << "\n]}\n";
+    out.close ();
+    return !out.fail ();
+}
@@ -0,0 +1,101 @@
+/********************************************************************
+ * qoftrace.h -- timed spans exported as Chrome trace JSON          *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ ********************************************************************/
+
+/** @addtogroup Trace Tracing
+    @ingroup QOF
+
+    Spans with a start and a duration around the long-running steps of
+    the program: loading and saving a session, the backend's phases,
+    running a report, loading a register, the stages of an import.
+    Spans nest per thread.  Nothing is recorded until qof_trace_start()
+    is called; until then a span costs one check of a flag.  The
+    recorded spans are kept in memory and qof_trace_write() saves them
+    in the Chrome Trace Event format, which chrome://tracing, Perfetto
+    and speedscope can show as a timeline.
+
+    Categories name the subsystem, e.g. "session", "backend", "report";
+    the span name says what was done and the optional detail which
+    object it was done to.
+@{
+*/
+/** @file qoftrace.h
+    @brief Timed spans exported as Chrome trace JSON
+*/
+
+#ifndef QOF_TRACE_H
+#define QOF_TRACE_H
+
+#include <glib.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Start recording spans, discarding any recorded before. */
+void qof_trace_start (void);
+
+/** Stop recording.  What has been recorded is kept for qof_trace_write(). */
+void qof_trace_stop (void);
+
+/** TRUE between qof_trace_start() and qof_trace_stop(). */
+gboolean qof_trace_is_recording (void);
+
+/** Open a span on the calling thread.  Every call must be matched by
+ *  a qof_trace_end() on the same thread, whether or not tracing is
+ *  recording.  detail may be NULL. */
+void qof_trace_begin (const char *category, const char *name,
+                      const char *detail);
+
+/** Close the calling thread's innermost open span. */
+void qof_trace_end (void);
+
+/** The number of spans recorded since qof_trace_start(). */
+guint qof_trace_get_count (void);
+
+/** Write the recorded spans to filename as Chrome trace JSON.
+ *  Returns FALSE if the file couldn't be written. */
+gboolean qof_trace_write (const char *filename);
+
+/** Discard the recorded spans. */
+void qof_trace_clear (void);
+
+#ifdef __cplusplus
+}
+
+/** A span over the rest of the enclosing scope. */
+class QofTraceSpan
+{
+public:
+    QofTraceSpan (const char *category, const char *name,
+                  const char *detail = nullptr)
+    {
+        qof_trace_begin (category, name, detail);
+    }
+    ~QofTraceSpan () { qof_trace_end (); }
+    QofTraceSpan (const QofTraceSpan&) = delete;
+    QofTraceSpan& operator= (const QofTraceSpan&) = delete;
+};
+#endif
+
+#endif /* QOF_TRACE_H */
+/** @} */
@@ -543,6 +543,82 @@ TEST(gnc_datetime_constructors, test_neutral_across_timezones)
     EXPECT_EQ(ten_days, static_cast<time64>(etime_la) - static_cast<time64>(btime_la));
 }
 
+static ::testing::AssertionResult
+same_tm(const struct tm& a, const struct tm& b, time64 time)
+{
+    if (a.tm_year == b.tm_year && a.tm_mon == b.tm_mon &&
+        a.tm_mday == b.tm_mday && a.tm_hour == b.tm_hour &&
+        a.tm_min == b.tm_min && a.tm_sec == b.tm_sec &&
+        a.tm_wday == b.tm_wday && a.tm_yday == b.tm_yday &&
+        a.tm_isdst == b.tm_isdst)
+        return ::testing::AssertionSuccess();
+    return ::testing::AssertionFailure() << "at " << time << " "
+        << a.tm_year << "-" << a.tm_mon << "-" << a.tm_mday << " "
+        << a.tm_hour << ":" << a.tm_min << ":" << a.tm_sec
+        << " isdst " << a.tm_isdst;
+}
+
+/* local_tm and from_local_tm take a shortcut away from DST
+ * transitions, they must agree with the full conversion everywhere,
+ * in both hemispheres and across the turn of the year. */
+TEST(gnc_datetime_functions, test_local_tm)
+{
+#ifdef __MINGW32__
+    TimeZoneProvider tzp_can{"A.U.S Eastern Standard Time"};
+    TimeZoneProvider tzp_la{"Pacific Standard Time"};
+#else
+    TimeZoneProvider tzp_can("Australia/Canberra");
+    TimeZoneProvider tzp_la("America/Los_Angeles");
+#endif
+    for (auto tzp : {&tzp_la, &tzp_can})
+    {
+        _set_tzp(*tzp);
+        // 2019-12-01 to 2021-02-01 in steps of 1h 47m 13s
+        for (time64 time = 1575158400; time < 1612137600; time += 6433)
+        {
+            auto full = static_cast<struct tm>(GncDateTime(time));
+            auto fast = GncDateTime::local_tm(time);
+            EXPECT_TRUE(same_tm(fast, full, time));
+
+            /* The repeated hour at the end of DST can't round trip */
+            GncDateTime back{full};
+            auto tm = full;
+            EXPECT_EQ(static_cast<time64>(back), GncDateTime::from_local_tm(tm));
+            EXPECT_TRUE(same_tm(tm, static_cast<struct tm>(back), time));
+        }
+        _reset_tzp();
+    }
+}
+
+TEST(gnc_datetime_functions, test_day_part_time64)
+{
+#ifdef __MINGW32__
+    TimeZoneProvider tzp_can{"A.U.S Eastern Standard Time"};
+    TimeZoneProvider tzp_la{"Pacific Standard Time"};
+    TimeZoneProvider tzp_kir{"Line Islands Standard Time"};
+#else
+    TimeZoneProvider tzp_can("Australia/Canberra");
+    TimeZoneProvider tzp_la("America/Los_Angeles");
+    TimeZoneProvider tzp_kir("Pacific/Kiritimati");
+#endif
+    for (auto tzp : {&tzp_la, &tzp_can, &tzp_kir})
+    {
+        _set_tzp(*tzp);
+        const int month_days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        for (int year : {2019, 2020})
+            for (int month = 1; month <= 12; ++month)
+                for (int day = 1; day <= month_days[month - 1] +
+                         (year == 2020 && month == 2); ++day)
+                {
+                    GncDate date(year, month, day);
+                    for (auto part : {DayPart::start, DayPart::neutral, DayPart::end})
+                        EXPECT_EQ(static_cast<time64>(GncDateTime(date, part)),
+                                  GncDateTime::day_part_time64(year, month, day, part));
+                }
+        _reset_tzp();
+    }
+}
+
 TEST(gnc_datetime_functions, test_format)
 {
     GncDateTime atime(2394187200); //2045-11-13 12:00:00 Z
@@ -338,6 +338,24 @@ TEST(gncnumeric_operators, test_subtraction)
     EXPECT_EQ(12, c.denom());
 }
 
+TEST(gncnumeric_operators, test_sum_array)
+{
+    GncNumeric r;
+    EXPECT_NO_THROW(r = gnc_numeric_sum_array(nullptr, 0));
+    EXPECT_EQ(0, r.num());
+    EXPECT_EQ(1, r.denom());
+    GncNumeric same[] {{INT64_MAX, 100}, {-12345, 100}, {INT64_MIN, 100},
+                       {12344, 100}};
+    EXPECT_NO_THROW(r = gnc_numeric_sum_array(same, 4));
+    EXPECT_EQ(-2, r.num());
+    EXPECT_EQ(100, r.denom());
+    GncNumeric big[] {{INT64_MAX, 100}, {1, 100}};
+    EXPECT_THROW(r = gnc_numeric_sum_array(big, 2), std::overflow_error);
+    GncNumeric mixed[] {{1, 2}, {1, 3}, {1, 6}};
+    EXPECT_NO_THROW(r = gnc_numeric_sum_array(mixed, 3));
+    EXPECT_EQ(r.num(), r.denom());
+}
+
 TEST(gncnumeric_operators, test_multiplication)
 {
     GncNumeric a(123456789987654321, 1000000000);
@@ -0,0 +1,71 @@
+/********************************************************************
+ * gtest-qoflog.cpp -- Unit tests for the cached log level checks   *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ ********************************************************************/
+
+#include <config.h>
+#include <glib.h>
+#include "../qoflog.h"
+#include <gtest/gtest.h>
+
+static QofLogModule log_module = "test.qoflog";
+
+TEST(qof_log, site_follows_set_level)
+{
+    static gint site = 0;
+    qof_log_set_level (log_module, QOF_LOG_WARNING);
+    EXPECT_FALSE (qof_log_check_site (&site, log_module, QOF_LOG_DEBUG));
+    EXPECT_FALSE (qof_log_check_site (&site, log_module, QOF_LOG_DEBUG));
+
+    qof_log_set_level (log_module, QOF_LOG_DEBUG);
+    EXPECT_TRUE (qof_log_check_site (&site, log_module, QOF_LOG_DEBUG));
+    EXPECT_TRUE (qof_log_check_site (&site, log_module, QOF_LOG_DEBUG));
+
+    /* Any module's change invalidates every site. */
+    qof_log_set_level ("test.other", QOF_LOG_ERROR);
+    EXPECT_EQ (qof_log_check (log_module, QOF_LOG_DEBUG),
+               qof_log_check_site (&site, log_module, QOF_LOG_DEBUG));
+}
+
+TEST(qof_log, site_follows_shutdown)
+{
+    static gint site = 0;
+    qof_log_set_level (log_module, QOF_LOG_DEBUG);
+    EXPECT_TRUE (qof_log_check_site (&site, log_module, QOF_LOG_DEBUG));
+    qof_log_shutdown ();
+    EXPECT_FALSE (qof_log_check_site (&site, log_module, QOF_LOG_DEBUG));
+}
+
+static int
+enter_and_leave (void)
+{
+    ENTER ("%d", 1);
+    LEAVE ("%d", 2);
+    return 0;
+}
+
+TEST(qof_log, enter_and_leave)
+{
+    qof_log_set_level (log_module, QOF_LOG_WARNING);
+    EXPECT_EQ (0, enter_and_leave ());
+    qof_log_set_level (log_module, QOF_LOG_DEBUG);
+    EXPECT_EQ (0, enter_and_leave ());
+    qof_log_shutdown ();
+}
@@ -0,0 +1,121 @@
+/********************************************************************
+ * gtest-qofmemory.cpp -- Unit tests for the memory usage report    *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ ********************************************************************/
+
+extern "C"
+{
+#include <config.h>
+#include "../Account.h"
+#include <qof.h>
+}
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+
+using Usage = std::map<std::string, std::pair<guint64, guint64>>;
+
+static void
+collect_cb (const char *name, guint64 count, guint64 bytes, gpointer data)
+{
+    (*static_cast<Usage*> (data))[name] = {count, bytes};
+}
+
+static int source_calls;
+
+static void
+test_source (QofBook *book, QofMemoryCB cb, gpointer user_data)
+{
+    ++source_calls;
+    cb ("test source", 3, 300, user_data);
+}
+
+class QofMemoryTest : public testing::Test
+{
+protected:
+    void SetUp ()
+    {
+        m_book = qof_book_new ();
+        auto root = gnc_account_create_root (m_book);
+        for (auto i = 0; i < 4; ++i)
+        {
+            auto acc = xaccMallocAccount (m_book);
+            gnc_account_append_child (root, acc);
+        }
+    }
+    void TearDown ()
+    {
+        qof_book_destroy (m_book);
+    }
+    QofBook *m_book;
+};
+
+TEST_F (QofMemoryTest, counts_collections)
+{
+    Usage usage;
+    qof_memory_foreach (m_book, collect_cb, &usage);
+    ASSERT_EQ (1u, usage.count (GNC_ID_ACCOUNT));
+    /* The root and its four children. */
+    EXPECT_EQ (5u, usage[GNC_ID_ACCOUNT].first);
+    EXPECT_GE (usage[GNC_ID_ACCOUNT].second, 5 * sizeof (QofInstance));
+    EXPECT_EQ (1u, usage.count (std::string {GNC_ID_ACCOUNT} + " kvp slots"));
+    EXPECT_EQ (1u, usage.count ("string cache"));
+}
+
+TEST_F (QofMemoryTest, counts_kvp_slots)
+{
+    Usage before;
+    qof_memory_foreach (m_book, collect_cb, &before);
+
+    auto acc = gnc_account_get_children (gnc_book_get_root_account (m_book));
+    xaccAccountSetNotes (static_cast<Account*> (acc->data), "A fairly long note");
+    g_list_free (acc);
+
+    Usage after;
+    qof_memory_foreach (m_book, collect_cb, &after);
+    auto slots = std::string {GNC_ID_ACCOUNT} + " kvp slots";
+    EXPECT_EQ (before[slots].first + 1, after[slots].first);
+    EXPECT_GT (after[slots].second, before[slots].second + strlen ("A fairly long note"));
+}
+
+TEST_F (QofMemoryTest, sources_are_registered_once)
+{
+    qof_memory_register_source (test_source);
+    qof_memory_register_source (test_source);
+    source_calls = 0;
+    Usage usage;
+    qof_memory_foreach (m_book, collect_cb, &usage);
+    EXPECT_EQ (1, source_calls);
+    EXPECT_EQ (3u, usage["test source"].first);
+    EXPECT_EQ (300u, usage["test source"].second);
+}
+
+TEST_F (QofMemoryTest, report_has_a_total)
+{
+    auto report = qof_memory_report (m_book);
+    std::string text {report};
+    g_free (report);
+    EXPECT_NE (std::string::npos, text.find (GNC_ID_ACCOUNT));
+    EXPECT_NE (std::string::npos, text.find ("string cache"));
+    EXPECT_NE (std::string::npos, text.find ("\ntotal"));
+}
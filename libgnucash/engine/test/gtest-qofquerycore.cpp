@@ -194,3 +194,129 @@ TEST(qof_query_core_predicate_get_date, numeric)
 
     EXPECT_FALSE (qof_query_date_predicate_get_date(pdata, &date));
 }
+
+static gint64 kernel_test_int64;
+static gnc_numeric kernel_test_numeric;
+
+static gint64
+get_test_int64 (gpointer object, QofParam *getter)
+{
+    return kernel_test_int64;
+}
+
+static gnc_numeric
+get_test_numeric (gpointer object, QofParam *getter)
+{
+    return kernel_test_numeric;
+}
+
+TEST(qof_query_core_get_kernel, int64_matches_predicate)
+{
+    qof_query_core_init();
+    QofParam param = { "test", QOF_TYPE_INT64, (QofAccessFunc)get_test_int64, NULL };
+    auto generic = qof_query_core_get_predicate (QOF_TYPE_INT64);
+
+    for (int how = QOF_COMPARE_LT; how <= QOF_COMPARE_NEQ; ++how)
+    {
+        auto pdata = qof_query_int64_predicate (static_cast<QofQueryCompare>(how), 5);
+        auto kernel = qof_query_core_get_kernel (QOF_TYPE_INT64, &param, pdata);
+        ASSERT_NE (nullptr, kernel);
+        for (kernel_test_int64 = 3; kernel_test_int64 < 8; ++kernel_test_int64)
+            EXPECT_EQ (generic (NULL, &param, pdata), kernel (NULL, &param, pdata));
+        qof_query_core_predicate_free (pdata);
+    }
+}
+
+TEST(qof_query_core_get_kernel, numeric_matches_predicate)
+{
+    qof_query_core_init();
+    QofParam param = { "test", QOF_TYPE_NUMERIC, (QofAccessFunc)get_test_numeric, NULL };
+    auto generic = qof_query_core_get_predicate (QOF_TYPE_NUMERIC);
+    gint64 values[] = { -700, -500, 0, 500, 700 };
+
+    for (int how = QOF_COMPARE_LT; how <= QOF_COMPARE_GTE; ++how)
+    {
+        if (how == QOF_COMPARE_EQUAL)
+        {
+            auto pdata = qof_query_numeric_predicate (QOF_COMPARE_EQUAL,
+                                                      QOF_NUMERIC_MATCH_ANY,
+                                                      { 500, 100 });
+            EXPECT_EQ (nullptr, qof_query_core_get_kernel (QOF_TYPE_NUMERIC,
+                                                           &param, pdata));
+            qof_query_core_predicate_free (pdata);
+            continue;
+        }
+        for (auto sign : { QOF_NUMERIC_MATCH_DEBIT, QOF_NUMERIC_MATCH_CREDIT,
+                           QOF_NUMERIC_MATCH_ANY })
+        {
+            auto pdata = qof_query_numeric_predicate (static_cast<QofQueryCompare>(how),
+                                                      sign, { 500, 100 });
+            auto kernel = qof_query_core_get_kernel (QOF_TYPE_NUMERIC, &param, pdata);
+            ASSERT_NE (nullptr, kernel);
+            for (auto v : values)
+            {
+                kernel_test_numeric = gnc_numeric_create (v, 100);
+                EXPECT_EQ (generic (NULL, &param, pdata), kernel (NULL, &param, pdata));
+            }
+            qof_query_core_predicate_free (pdata);
+        }
+    }
+}
+
+TEST(qof_query_core_get_kernel, type_mismatch)
+{
+    qof_query_core_init();
+    QofParam param = { "test", QOF_TYPE_INT64, (QofAccessFunc)get_test_int64, NULL };
+    auto pdata = qof_query_int32_predicate (QOF_COMPARE_LT, 5);
+
+    EXPECT_EQ (nullptr, qof_query_core_get_kernel (QOF_TYPE_INT64, &param, pdata));
+    qof_query_core_predicate_free (pdata);
+}
+
+static const char *string_test_value;
+
+static const char *
+get_test_string (gpointer object, QofParam *getter)
+{
+    return string_test_value;
+}
+
+TEST(qof_query_core_string_predicate, case_insensitive)
+{
+    qof_query_core_init();
+    QofParam param = { "test", QOF_TYPE_STRING, (QofAccessFunc)get_test_string, NULL };
+    auto pred = qof_query_core_get_predicate (QOF_TYPE_STRING);
+    auto contains = qof_query_string_predicate (QOF_COMPARE_CONTAINS, "GrOcEr",
+                                                QOF_STRING_MATCH_CASEINSENSITIVE,
+                                                FALSE);
+    auto equal = qof_query_string_predicate (QOF_COMPARE_EQUAL, "Straße",
+                                             QOF_STRING_MATCH_CASEINSENSITIVE,
+                                             FALSE);
+    auto ligature = qof_query_string_predicate (QOF_COMPARE_CONTAINS, "\xef\xac\x81le",
+                                                QOF_STRING_MATCH_CASEINSENSITIVE,
+                                                FALSE);
+
+    string_test_value = "Weekly groceries";
+    EXPECT_TRUE (pred (NULL, &param, contains));
+    string_test_value = "Weekly GROCERIES";
+    EXPECT_TRUE (pred (NULL, &param, contains));
+    string_test_value = "Gro\xc3\x9f" "e Grocer";
+    EXPECT_TRUE (pred (NULL, &param, contains));
+    string_test_value = "Rent";
+    EXPECT_FALSE (pred (NULL, &param, contains));
+    string_test_value = NULL;
+    EXPECT_FALSE (pred (NULL, &param, contains));
+
+    string_test_value = "STRASSE";
+    EXPECT_TRUE (pred (NULL, &param, equal));
+    string_test_value = "Strasbourg";
+    EXPECT_FALSE (pred (NULL, &param, equal));
+
+    /* The needle normalizes to ASCII "file". */
+    string_test_value = "Profile";
+    EXPECT_TRUE (pred (NULL, &param, ligature));
+
+    qof_query_core_predicate_free (contains);
+    qof_query_core_predicate_free (equal);
+    qof_query_core_predicate_free (ligature);
+}
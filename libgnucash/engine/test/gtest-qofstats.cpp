@@ -0,0 +1,102 @@
+/********************************************************************
+ * gtest-qofstats.cpp -- Unit tests for the qofstats counters       *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ ********************************************************************/
+
+#include <config.h>
+#include <glib.h>
+#include "../qofstats.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(qof_stats, lookup_is_stable)
+{
+    auto stat = qof_stat_lookup ("test.lookup");
+    EXPECT_EQ (stat, qof_stat_lookup ("test.lookup"));
+    EXPECT_NE (stat, qof_stat_lookup ("test.other"));
+}
+
+TEST(qof_stats, count_and_reset)
+{
+    static QofStat *cache;
+    auto stat = qof_stat_cached (&cache, "test.count");
+    EXPECT_EQ (stat, cache);
+    qof_stat_add (stat, 3);
+    qof_stat_add (qof_stat_cached (&cache, "test.count"), 2);
+    EXPECT_EQ (5u, qof_stat_get_count ("test.count"));
+    EXPECT_EQ (0u, qof_stat_get_count ("test.never-created"));
+
+    qof_stat_reset ();
+    EXPECT_EQ (0u, qof_stat_get_count ("test.count"));
+    EXPECT_EQ (stat, qof_stat_lookup ("test.count"));
+}
+
+TEST(qof_stats, timer)
+{
+    qof_stat_reset ();
+    auto stat = qof_stat_lookup ("test.timer");
+    auto start = qof_stat_timer_start ();
+    g_usleep (2000);
+    qof_stat_timer_stop (stat, start);
+    {
+        QofStatTimer timer {stat};
+    }
+    EXPECT_EQ (2u, qof_stat_get_count ("test.timer"));
+    EXPECT_GE (qof_stat_get_usecs ("test.timer"), 2000);
+}
+
+TEST(qof_stats, threads)
+{
+    qof_stat_reset ();
+    auto stat = qof_stat_lookup ("test.threads");
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+        threads.emplace_back ([stat]{ for (int j = 0; j < 10000; ++j) qof_stat_add (stat, 1); });
+    for (auto& thread : threads)
+        thread.join ();
+    EXPECT_EQ (40000u, qof_stat_get_count ("test.threads"));
+}
+
+static void
+collect_cb (const char *name, guint64 count, gint64 usecs, gpointer user_data)
+{
+    static_cast<std::vector<std::string>*>(user_data)->push_back (name);
+}
+
+TEST(qof_stats, foreach_and_dump)
+{
+    qof_stat_lookup ("test.b");
+    qof_stat_lookup ("test.a");
+    std::vector<std::string> names;
+    qof_stat_foreach (collect_cb, &names);
+    auto a = std::find (names.begin (), names.end (), "test.a");
+    auto b = std::find (names.begin (), names.end (), "test.b");
+    ASSERT_NE (names.end (), a);
+    ASSERT_NE (names.end (), b);
+    EXPECT_LT (a, b);
+
+    auto dump = qof_stat_dump ();
+    EXPECT_NE (nullptr, strstr (dump, "test.a"));
+    g_free (dump);
+}
@@ -0,0 +1,99 @@
+/********************************************************************
+ * gtest-qoftrace.cpp -- Unit tests for the qoftrace spans          *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ ********************************************************************/
+
+#include <config.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include "../qoftrace.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+static std::string
+write_trace ()
+{
+    auto path = g_build_filename (g_get_tmp_dir (), "gtest-qoftrace.json", nullptr);
+    EXPECT_TRUE (qof_trace_write (path));
+    gchar *contents = nullptr;
+    EXPECT_TRUE (g_file_get_contents (path, &contents, nullptr, nullptr));
+    std::string json {contents ? contents : ""};
+    g_unlink (path);
+    g_free (contents);
+    g_free (path);
+    return json;
+}
+
+TEST(qof_trace, nothing_without_start)
+{
+    qof_trace_stop ();
+    qof_trace_clear ();
+    qof_trace_begin ("test", "ignored", nullptr);
+    qof_trace_end ();
+    EXPECT_FALSE (qof_trace_is_recording ());
+    EXPECT_EQ (0u, qof_trace_get_count ());
+}
+
+TEST(qof_trace, nested_spans)
+{
+    qof_trace_start ();
+    {
+        QofTraceSpan outer {"test", "outer", "some \"file\""};
+        qof_trace_begin ("test", "inner", nullptr);
+        qof_trace_end ();
+    }
+    qof_trace_stop ();
+    EXPECT_EQ (2u, qof_trace_get_count ());
+
+    auto json = write_trace ();
+    EXPECT_NE (std::string::npos, json.find ("\"traceEvents\""));
+    EXPECT_NE (std::string::npos, json.find ("\"name\": \"outer\""));
+    EXPECT_NE (std::string::npos, json.find ("\"name\": \"inner\""));
+    EXPECT_NE (std::string::npos, json.find ("\"detail\": \"some \\\"file\\\"\""));
+    EXPECT_NE (std::string::npos, json.find ("\"ph\": \"X\""));
+}
+
+/* A span opened before recording starts isn't recorded, but the spans
+ * inside it are, and its end doesn't close any of them. */
+TEST(qof_trace, start_inside_span)
+{
+    qof_trace_stop ();
+    qof_trace_begin ("test", "before", nullptr);
+    qof_trace_start ();
+    qof_trace_begin ("test", "during", nullptr);
+    qof_trace_end ();
+    qof_trace_end ();
+    qof_trace_stop ();
+    EXPECT_EQ (1u, qof_trace_get_count ());
+    auto json = write_trace ();
+    EXPECT_EQ (std::string::npos, json.find ("\"before\""));
+    EXPECT_NE (std::string::npos, json.find ("\"during\""));
+}
+
+TEST(qof_trace, threads)
+{
+    qof_trace_start ();
+    QofTraceSpan main_span {"test", "main"};
+    std::thread worker {[]{ QofTraceSpan span {"test", "worker"}; }};
+    worker.join ();
+    EXPECT_EQ (1u, qof_trace_get_count ());
+    qof_trace_stop ();
+}
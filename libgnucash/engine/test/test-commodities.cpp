@@ -181,6 +181,91 @@ test_commodity(void)
         }
     }
 
+    {
+        QofBook *book = qof_book_new ();
+        gnc_commodity_table *tbl = gnc_commodity_table_get_table (book);
+        gnc_commodity *foo, *bar, *baz, *stray;
+
+        foo = gnc_commodity_new (book, "Foo Inc", "NASDAQ", "FOO",
+                                 "US0000000001", 100);
+        bar = gnc_commodity_new (book, "Bar Inc", "NASDAQ", "BAR",
+                                 "US0000000002", 100);
+        gnc_commodity_table_insert (tbl, foo);
+        do_test (gnc_commodity_table_lookup_by_cusip (tbl, "US0000000001") == foo,
+                 "lookup by cusip");
+        gnc_commodity_table_insert (tbl, bar);
+        do_test (gnc_commodity_table_lookup_by_cusip (tbl, "US0000000002") == bar,
+                 "lookup by cusip after insert");
+        do_test (gnc_commodity_table_lookup_by_cusip (tbl, "") == NULL,
+                 "lookup by empty cusip");
+
+        gnc_commodity_set_cusip (foo, "US0000000003");
+        do_test (gnc_commodity_table_lookup_by_cusip (tbl, "US0000000001") == NULL,
+                 "lookup by old cusip");
+        do_test (gnc_commodity_table_lookup_by_cusip (tbl, "US0000000003") == foo,
+                 "lookup by new cusip");
+
+        gnc_commodity_table_remove (tbl, bar);
+        do_test (gnc_commodity_table_lookup_by_cusip (tbl, "US0000000002") == NULL,
+                 "lookup by cusip after remove");
+        gnc_commodity_destroy (bar);
+
+        /* A commodity in the table that gets its first CUSIP, as the
+         * importer does to the one the user picks. */
+        baz = gnc_commodity_new (book, "Baz Inc", "NASDAQ", "BAZ",
+                                 NULL, 100);
+        gnc_commodity_table_insert (tbl, baz);
+        gnc_commodity_set_cusip (baz, "US0000000004");
+        do_test (gnc_commodity_table_lookup_by_cusip (tbl, "US0000000004") == baz,
+                 "lookup by first cusip");
+
+        /* One that isn't in the table stays out of the index. */
+        stray = gnc_commodity_new (book, "Stray Inc", "NASDAQ", "STRAY",
+                                   NULL, 100);
+        gnc_commodity_set_cusip (stray, "US0000000005");
+        do_test (gnc_commodity_table_lookup_by_cusip (tbl, "US0000000005") == NULL,
+                 "lookup by cusip of a commodity not in the table");
+        gnc_commodity_destroy (stray);
+
+        qof_book_destroy (book);
+    }
+
+    {
+        QofBook *book = qof_book_new ();
+        gnc_commodity_table *tbl = gnc_commodity_table_get_table (book);
+        gnc_commodity *foo, *rub;
+
+        foo = gnc_commodity_new (book, "Foo Inc", "NASDAQ", "FOO", NULL, 100);
+        rub = gnc_commodity_new (book, "Russian Ruble", GNC_COMMODITY_NS_CURRENCY,
+                                 "RUB", NULL, 100);
+        gnc_commodity_table_insert (tbl, foo);
+        gnc_commodity_table_insert (tbl, rub);
+        do_test (gnc_commodity_table_lookup_unique (tbl, "NASDAQ::FOO") == foo,
+                 "lookup unique");
+        do_test (gnc_commodity_table_lookup_unique (tbl, "NASDAQ::BAR") == NULL,
+                 "lookup unique missing");
+        do_test (gnc_commodity_table_lookup_unique (tbl, "NASDAQ") == NULL,
+                 "lookup unique without separator");
+        do_test (gnc_commodity_table_lookup_unique (tbl, "ISO4217::RUB") == rub,
+                 "lookup unique in old ISO namespace");
+        do_test (gnc_commodity_table_lookup_unique (tbl, "CURRENCY::RUR") == rub,
+                 "lookup unique by old currency code");
+
+        gnc_commodity_table_remove (tbl, foo);
+        do_test (gnc_commodity_table_lookup_unique (tbl, "NASDAQ::FOO") == NULL,
+                 "lookup unique after remove");
+        do_test (gnc_commodity_table_lookup (tbl, "NASDAQ", "FOO") == NULL,
+                 "lookup after remove");
+        gnc_commodity_destroy (foo);
+
+        gnc_commodity_table_delete_namespace (tbl, GNC_COMMODITY_NS_CURRENCY);
+        do_test (gnc_commodity_table_lookup (tbl, GNC_COMMODITY_NS_CURRENCY,
+                                             "RUB") == NULL,
+                 "lookup after deleting namespace");
+
+        qof_book_destroy (book);
+    }
+
 }
 
 int
@@ -35,6 +35,8 @@ extern void test_suite_split();
 extern void test_suite_engine_kvp_properties (void);
 extern void test_suite_gnc_pricedb();
 extern void test_suite_gnc_uri_utils(void);
+extern void test_suite_gnc_book_snapshot(void);
+extern void test_suite_gnc_period_archive(void);
 
 int
 main (int   argc,
@@ -57,6 +59,8 @@ main (int   argc,
     test_suite_engine_kvp_properties ();
     test_suite_gnc_pricedb();
     test_suite_gnc_uri_utils();
+    test_suite_gnc_book_snapshot();
+    test_suite_gnc_period_archive();
 
     return g_test_run( );
 }
@@ -660,6 +660,10 @@ test_qof_print_date_dmy_buff (void)
     memset ((gpointer)buff, 0, sizeof (buff));
     g_assert_cmpint (qof_print_date_dmy_buff (buff, MAX_DATE_LENGTH, 16, 6, 2045), ==, strlen (buff));
     g_assert_cmpstr (buff, ==, "16/06/2045");
+    /* A short buffer gets as much as fits */
+    memset ((gpointer)buff, 0, sizeof (buff));
+    g_assert_cmpint (qof_print_date_dmy_buff (buff, 5, 16, 6, 2045), ==, 4);
+    g_assert_cmpstr (buff, ==, "16/0");
 
     qof_date_format_set (QOF_DATE_FORMAT_CE);
     memset ((gpointer)buff, 0, sizeof (buff));
@@ -1390,6 +1394,25 @@ test_gnc_iso8601_to_time64_gmt (FixtureA *f, gconstpointer pData)
 
     t = gnc_iso8601_to_time64_gmt ("2061-01-25 23:21:19.0 -05:00");
     g_assert_cmpint (t, ==, f->t5);
+
+    /* The form the XML backend writes takes a shortcut. */
+    t = gnc_iso8601_to_time64_gmt ("1989-03-27 13:43:27 +0000");
+    g_assert_cmpint (t, ==, f->t1);
+
+    t = gnc_iso8601_to_time64_gmt ("2020-11-07 06:21:19 -0500");
+    g_assert_cmpint (t, ==, f->t2);
+
+    t = gnc_iso8601_to_time64_gmt ("2012-07-04 19:27:44 +0840");
+    g_assert_cmpint (t, ==, f->t3);
+
+    t = gnc_iso8601_to_time64_gmt ("1961-09-22 17:53:19 -0500");
+    g_assert_cmpint (t, ==, f->t4);
+
+    t = gnc_iso8601_to_time64_gmt ("2061-01-25 23:21:19 -0500");
+    g_assert_cmpint (t, ==, f->t5);
+
+    t = gnc_iso8601_to_time64_gmt ("2000-02-29 00:00:00 +0000");
+    g_assert_cmpint (t, ==, 951782400);
 }
 /* gnc_time64_to_iso8601_buff
 char *
@@ -1816,6 +1839,37 @@ test_gnc_time64_get_day_end (FixtureA *f, gconstpointer pData)
     g_assert_cmpint (t_time, ==, r_time);
 
 }
+/* gnc_time64_get_period_bounds_gdate
+void
+gnc_time64_get_period_bounds_gdate (const GDate *start, gint months, gint days,
+                                    gsize n, time64 *starts, time64 *ends)
+*/
+static void
+test_gnc_time64_get_period_bounds_gdate (void)
+{
+    GDate *start = g_date_new_dmy (31, G_DATE_JANUARY, 2020);
+    time64 starts[4], ends[4];
+    const gint start_days[] = {31, 29, 31, 30};
+    const gint end_days[] = {28, 30, 29, 30};
+    gint i;
+
+    /* Monthly from a month end stays on the month ends */
+    gnc_time64_get_period_bounds_gdate (start, 1, 0, 4, starts, ends);
+    for (i = 0; i < 4; ++i)
+    {
+        g_assert_cmpint (starts[i], ==,
+                         gnc_dmy2time64 (start_days[i], i + 1, 2020));
+        g_assert_cmpint (ends[i], ==,
+                         gnc_dmy2time64_end (end_days[i], i + 2, 2020));
+    }
+
+    /* Weekly, across the end of a leap February */
+    g_date_set_dmy (start, 26, G_DATE_FEBRUARY, 2020);
+    gnc_time64_get_period_bounds_gdate (start, 0, 7, 2, NULL, ends);
+    g_assert_cmpint (ends[0], ==, gnc_dmy2time64_end (3, 3, 2020));
+    g_assert_cmpint (ends[1], ==, gnc_dmy2time64_end (10, 3, 2020));
+    g_date_free (start);
+}
 /* gnc_tm_get_today_start
 void
 gnc_tm_get_today_start (struct tm *tm)// C: 3 in 3  Local: 0:0:0
@@ -1922,6 +1976,7 @@ test_suite_gnc_date (void)
 // GNC_TEST_ADD_FUNC (suitename, "gnc tm get day end", test_gnc_tm_get_day_end);
     GNC_TEST_ADD (suitename, "gnc time64 get day start", FixtureA, NULL, setup, test_gnc_time64_get_day_start, NULL);
     GNC_TEST_ADD (suitename, "gnc time64 get day end", FixtureA, NULL, setup, test_gnc_time64_get_day_end, NULL);
+    GNC_TEST_ADD_FUNC (suitename, "gnc time64 get period bounds gdate", test_gnc_time64_get_period_bounds_gdate);
 // GNC_TEST_ADD_FUNC (suitename, "gnc tm get today start", test_gnc_tm_get_today_start);
 // GNC_TEST_ADD_FUNC (suitename, "gnc timet get today start", test_gnc_time64_get_today_start);
 // GNC_TEST_ADD_FUNC (suitename, "gnc timet get today end", test_gnc_time64_get_today_end);
@@ -32,6 +32,7 @@ extern "C"
 {
 #include <config.h>
 #include <ctype.h>
+#include <string.h>
 #include "cashobjects.h"
 #include "test-stuff.h"
 #include "test-engine-stuff.h"
@@ -53,6 +54,51 @@ static void test_null_guid(void)
     guid_free(gp);
 }
 
+static void test_guid_strings_and_batches (void)
+{
+    GncGUID guids[300], parsed;
+    char buff[GUID_ENCODING_LENGTH + 1];
+    int i, j;
+
+    guid_replace_many (guids, 300);
+    for (i = 0; i < 300; i++)
+    {
+        guid_to_string_buff (&guids[i], buff);
+        do_test ((strlen (buff) == GUID_ENCODING_LENGTH), "guid string length");
+        do_test (string_to_guid (buff, &parsed), "guid string parses");
+        do_test (guid_equal (&parsed, &guids[i]), "guid string round trip");
+        do_test (((guids[i].reserved[6] & 0xF0) == 0x40), "guid is version 4");
+        for (j = 0; j < i; j++)
+            if (guid_equal (&guids[i], &guids[j]))
+                break;
+        do_test ((j == i), "batched guids are distinct");
+    }
+
+    do_test (string_to_guid ("0123456789ABCDEFfedcba9876543210", &parsed),
+             "upper case guid string");
+    guid_to_string_buff (&parsed, buff);
+    do_test ((strcmp (buff, "0123456789abcdeffedcba9876543210") == 0),
+             "guid string is lower case");
+    do_test (!string_to_guid ("0123456789abcdeffedcba987654321g", &parsed),
+             "bad hex digit rejected");
+}
+
+static void
+remove_every_other_cb (QofInstance *ent, gpointer data)
+{
+    int *count = static_cast<int*>(data);
+    if ((*count)++ % 2 == 0)
+        qof_collection_remove_entity (ent);
+}
+
+static void
+check_lookup_cb (QofInstance *ent, gpointer data)
+{
+    QofCollection *col = static_cast<QofCollection*>(data);
+    do_test ((ent == qof_collection_lookup_entity (col, qof_instance_get_guid (ent))),
+             "entity not found after removals");
+}
+
 static void
 run_test (void)
 {
@@ -70,6 +116,7 @@ run_test (void)
 
     col = qof_book_get_collection (book, "asdf");
     type = qof_collection_get_type (col);
+    qof_collection_reserve (col, NENT);
 
     for (i = 0; i < NENT; i++)
     {
@@ -85,6 +132,14 @@ run_test (void)
                  "guid not found");
     }
 
+    /* Removing entities while walking the collection. */
+    i = 0;
+    qof_collection_foreach (col, remove_every_other_cb, &i);
+    do_test ((i == NENT), "foreach didn't visit each entity once");
+    do_test ((qof_collection_count (col) == NENT / 2),
+             "wrong count after removals");
+    qof_collection_foreach (col, check_lookup_cb, col);
+
     /* Make valgrind happy -- destroy the session. */
     qof_session_destroy(sess);
 }
@@ -96,6 +151,7 @@ main (int argc, char **argv)
     if (cashobjects_register())
     {
         test_null_guid();
+        test_guid_strings_and_batches ();
         run_test ();
         print_test_results();
     }
@@ -27,6 +27,7 @@ extern "C"
 {
 #include <config.h>
 #include <ctype.h>
+#include <string.h>
 #include "cashobjects.h"
 #include "test-stuff.h"
 #include "test-engine-stuff.h"
@@ -665,6 +666,84 @@ check_add_subtract_overflow (void)
 /* ======================================================= */
 
 
+/* The same-denominator and integer-factor cases take a shortcut; make
+ * sure it gives the general code's answers, denominators included, and
+ * steps aside on overflow. */
+static void
+check_fast_paths (void)
+{
+    gnc_numeric a = gnc_numeric_create (12345, 100);
+    gnc_numeric b = gnc_numeric_create (-2345, 100);
+    gnc_numeric n = gnc_numeric_create (3, 1);
+    gnc_numeric z = gnc_numeric_create (0, 1);
+    gnc_numeric big = gnc_numeric_create (INT64_MAX - 10, 100);
+    gnc_numeric r;
+
+    check_binary_op (gnc_numeric_create (10000, 100),
+                     gnc_numeric_add (a, b, GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD),
+                     a, b, "expected %s got %s = %s + %s for fast add lcd");
+    check_binary_op (gnc_numeric_create (10000, 100),
+                     gnc_numeric_add_fixed (a, b),
+                     a, b, "expected %s got %s = %s + %s for fast add fixed");
+    check_binary_op (gnc_numeric_create (14690, 100),
+                     gnc_numeric_sub (a, b, 100, GNC_HOW_DENOM_FIXED),
+                     a, b, "expected %s got %s = %s - %s for fast sub fixed");
+    /* A different requested denominator still converts */
+    check_binary_op (gnc_numeric_create (1000, 10),
+                     gnc_numeric_add (a, b, 10, GNC_HOW_RND_ROUND),
+                     a, b, "expected %s got %s = %s + %s for add to 10ths");
+    check_binary_op (gnc_numeric_create (37035, 100),
+                     gnc_numeric_mul (a, n, GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD),
+                     a, n, "expected %s got %s = %s * %s for fast mul lcd");
+    check_binary_op (gnc_numeric_create (0, 1),
+                     gnc_numeric_mul (a, z, GNC_DENOM_AUTO,
+                                      GNC_HOW_DENOM_FIXED | GNC_HOW_RND_NEVER),
+                     a, z, "expected %s got %s = %s * %s for fast mul zero");
+
+    /* Whatever the general code makes of these, it mustn't have wrapped */
+    r = gnc_numeric_add (big, big, GNC_DENOM_AUTO,
+                         GNC_HOW_DENOM_FIXED | GNC_HOW_RND_NEVER);
+    do_test (gnc_numeric_check (r) || gnc_numeric_positive_p (r),
+             "expected no wrap-around adding large numbers");
+    r = gnc_numeric_mul (big, n, GNC_DENOM_AUTO,
+                         GNC_HOW_DENOM_FIXED | GNC_HOW_RND_NEVER);
+    do_test (gnc_numeric_check (r) || gnc_numeric_positive_p (r),
+             "expected no wrap-around multiplying large numbers");
+}
+
+static void
+check_sum_array (void)
+{
+    gnc_numeric same[] = {gnc_numeric_create (INT64_MAX, 100),
+                          gnc_numeric_create (-12345, 100),
+                          gnc_numeric_create (INT64_MIN, 100),
+                          gnc_numeric_create (12344, 100)};
+    gnc_numeric mixed[] = {gnc_numeric_create (1, 2),
+                           gnc_numeric_create (1, 3),
+                           gnc_numeric_create (1, 6)};
+    gnc_numeric big[] = {gnc_numeric_create (INT64_MAX, 100),
+                         gnc_numeric_create (1, 100)};
+    gnc_numeric r;
+
+    r = gnc_numeric_sum_array (NULL, 0, GNC_DENOM_AUTO, GNC_HOW_DENOM_FIXED);
+    do_test (gnc_numeric_zero_p (r), "expected zero summing no values");
+
+    /* An intermediate of the sum overflows, but the total doesn't. */
+    r = gnc_numeric_sum_array (same, 4, GNC_DENOM_AUTO, GNC_HOW_DENOM_FIXED);
+    do_test (gnc_numeric_same (r, gnc_numeric_create (-2, 100)),
+             "expected -2/100 summing same-denominator values");
+    r = gnc_numeric_sum_array (same + 1, 1, 10, GNC_HOW_RND_ROUND_HALF_UP);
+    do_test (gnc_numeric_same (r, gnc_numeric_create (-1235, 10)),
+             "expected a single value converted to the requested denominator");
+
+    r = gnc_numeric_sum_array (mixed, 3, GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
+    do_test (gnc_numeric_eq (r, gnc_numeric_create (1, 1)),
+             "expected 1 summing mixed-denominator values");
+    r = gnc_numeric_sum_array (big, 2, GNC_DENOM_AUTO, GNC_HOW_DENOM_FIXED);
+    do_test (gnc_numeric_check (r) == GNC_ERROR_OVERFLOW,
+             "expected overflow summing past INT64_MAX");
+}
+
 static void
 check_mult_div (void)
 {
@@ -884,6 +963,36 @@ check_mult_div (void)
                      "expected %s got %s = %s / %s for mult sigfigs");
 
 }
+static void
+check_string_conversion (void)
+{
+    gnc_numeric extremes = gnc_numeric_create (INT64_MIN, INT64_MIN);
+    gnc_numeric a = gnc_numeric_create (-123456, 100);
+    gnc_numeric r;
+    gchar buff[GNC_NUMERIC_STRING_LENGTH + 1];
+    gchar *end, *str;
+
+    end = gnc_numeric_to_string_buff (extremes, buff);
+    do_test (g_strcmp0 (buff, "-9223372036854775808/-9223372036854775808") == 0,
+             "expected the widest value to fit the buffer");
+    do_test (end == buff + strlen (buff), "expected a pointer to the end");
+
+    str = gnc_numeric_to_string (a);
+    do_test (g_strcmp0 (str, "-123456/100") == 0, "expected num/denom");
+    do_test (string_to_gnc_numeric (str, &r) && gnc_numeric_same (r, a),
+             "expected the string to read back");
+    g_free (str);
+
+    do_test (string_to_gnc_numeric (" 7 / 3", &r) &&
+             gnc_numeric_same (r, gnc_numeric_create (7, 3)),
+             "expected spaces around the slash to be skipped");
+    do_test (string_to_gnc_numeric ("0x10/3", &r) &&
+             gnc_numeric_same (r, gnc_numeric_create (16, 3)),
+             "expected hex to still go through the general parser");
+    do_test (string_to_gnc_numeric ("12.5", &r) &&
+             gnc_numeric_eq (r, gnc_numeric_create (25, 2)),
+             "expected decimals to still go through the general parser");
+}
 
 /* ======================================================= */
 
@@ -898,7 +1007,10 @@ run_test (void)
     check_neg();
     check_add_subtract();
     check_add_subtract_overflow ();
+    check_fast_paths ();
+    check_sum_array ();
     check_mult_div ();
+    check_string_conversion ();
 }
 
 int
@@ -77,8 +77,46 @@ test_qof_string_cache( void )
     g_assert(str1_1 != str1_4);
 }
 
+#define THREAD_ROUNDS 10000
+
+static gpointer
+string_cache_thread (gpointer data)
+{
+    const gchar *keys[] = { "alpha", "beta", "gamma", "delta" };
+    const gchar *expected = data;
+    guint i;
+
+    for (i = 0; i < THREAD_ROUNDS; ++i)
+    {
+        const gchar *key = keys[i % G_N_ELEMENTS (keys)];
+        gchar *cached = qof_string_cache_insert (key);
+        if (g_strcmp0 (cached, key) != 0)
+            return GINT_TO_POINTER (FALSE);
+        qof_string_cache_remove (cached);
+    }
+    /* The caller holds a reference, so this one must not move. */
+    return GINT_TO_POINTER (qof_string_cache_insert ("alpha") == expected);
+}
+
+static void
+test_qof_string_cache_threads( void )
+{
+    GThread *threads[4];
+    gchar *alpha;
+    guint i;
+
+    alpha = qof_string_cache_insert ("alpha");
+    for (i = 0; i < G_N_ELEMENTS (threads); ++i)
+        threads[i] = g_thread_new ("string-cache", string_cache_thread, alpha);
+    for (i = 0; i < G_N_ELEMENTS (threads); ++i)
+        g_assert (GPOINTER_TO_INT (g_thread_join (threads[i])));
+    for (i = 0; i <= G_N_ELEMENTS (threads); ++i)
+        qof_string_cache_remove (alpha);
+}
+
 void
 test_suite_qof_string_cache ( void )
 {
     GNC_TEST_ADD_FUNC( suitename, "string-cache", test_qof_string_cache);
+    GNC_TEST_ADD_FUNC( suitename, "string-cache threads", test_qof_string_cache_threads);
 }
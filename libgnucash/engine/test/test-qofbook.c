@@ -292,6 +292,46 @@ test_book_session_not_saved( Fixture *fixture, gconstpointer pData )
     g_assert( qof_book_session_not_saved( fixture->book ) );
 }
 
+static void
+mock_dirty_instance_cb (QofInstance *inst, gpointer user_data)
+{
+    GList **seen = (GList **) user_data;
+    *seen = g_list_prepend (*seen, inst);
+    /* Cleaning from inside the walk must be safe. */
+    qof_instance_mark_clean (inst);
+}
+
+static void
+test_book_dirty_instances( Fixture *fixture, gconstpointer pData )
+{
+    Account *acc;
+    GList *seen = NULL;
+    guint base;
+
+    g_assert( fixture->book != NULL );
+    acc = xaccMallocAccount (fixture->book);
+    qof_instance_mark_clean (QOF_INSTANCE (acc));
+    base = qof_book_count_dirty_instances (fixture->book);
+
+    qof_instance_set_dirty (QOF_INSTANCE (acc));
+    g_assert_cmpuint( qof_book_count_dirty_instances (fixture->book), == , base + 1 );
+    qof_instance_set_dirty (QOF_INSTANCE (acc));
+    g_assert_cmpuint( qof_book_count_dirty_instances (fixture->book), == , base + 1 );
+
+    qof_book_foreach_dirty_instance (fixture->book, mock_dirty_instance_cb, &seen);
+    g_assert( g_list_find (seen, acc) != NULL );
+    g_assert_cmpuint( g_list_length (seen), == , base + 1 );
+    g_assert_cmpuint( qof_book_count_dirty_instances (fixture->book), == , 0 );
+    g_assert( !qof_instance_get_dirty_flag (acc) );
+    g_list_free (seen);
+
+    qof_instance_set_dirty_flag (acc, TRUE);
+    g_assert_cmpuint( qof_book_count_dirty_instances (fixture->book), == , 1 );
+    xaccAccountBeginEdit (acc);
+    xaccAccountDestroy (acc);
+    g_assert_cmpuint( qof_book_count_dirty_instances (fixture->book), == , 0 );
+}
+
 static void
 test_book_mark_session_saved( Fixture *fixture, gconstpointer pData )
 {
@@ -582,6 +622,7 @@ test_book_get_num_days_autofreeze( Fixture *fixture, gconstpointer pData )
 		      NULL);
     g_assert( qof_book_uses_autoreadonly( fixture-> book ) == FALSE );
     g_assert( qof_book_get_num_days_autoreadonly( fixture-> book ) == 0 );
+    g_assert_cmpint( qof_book_get_autoreadonly_time( fixture-> book ), ==, INT64_MIN );
 
     qof_instance_set (QOF_INSTANCE (fixture->book),
 		      "autoreadonly-days", (gdouble)32,
@@ -589,6 +630,16 @@ test_book_get_num_days_autofreeze( Fixture *fixture, gconstpointer pData )
     g_assert( qof_book_uses_autoreadonly( fixture-> book ) == TRUE );
     g_assert( qof_book_get_num_days_autoreadonly( fixture-> book ) == 32 );
 
+    g_test_message( "Testing the threshold time follows the option" );
+    {
+        GDate *threshold = qof_book_get_autoreadonly_gdate( fixture-> book );
+        time64 neutral = gdate_to_time64( *threshold );
+        time64 time = qof_book_get_autoreadonly_time( fixture-> book );
+        g_assert_cmpint( time, <=, neutral );
+        g_assert_cmpint( neutral - time, <, 86400 );
+        g_date_free( threshold );
+    }
+
     qof_book_commit_edit (fixture->book);
 }
 
@@ -918,6 +969,44 @@ test_book_new_destroy( void )
     g_assert( test_struct.called );
 }
 
+static struct
+{
+    guint book_destroyed;
+    guint other_events;
+} teardown_events;
+
+static void
+teardown_event_cb( QofInstance *ent, QofEventId event_type,
+                   gpointer handler_data, gpointer event_data )
+{
+    if ( QOF_IS_BOOK( ent ) && event_type == QOF_EVENT_DESTROY )
+        teardown_events.book_destroyed++;
+    else
+        teardown_events.other_events++;
+}
+
+static void
+test_book_destroy_events( void )
+{
+    QofBook *book;
+    Account *root, *acct;
+    gint handler_id;
+
+    book = qof_book_new();
+    root = gnc_account_create_root( book );
+    acct = xaccMallocAccount( book );
+    gnc_account_append_child( root, acct );
+
+    g_test_message( "Testing that only the book announces its destruction" );
+    teardown_events.book_destroyed = 0;
+    teardown_events.other_events = 0;
+    handler_id = qof_event_register_handler( teardown_event_cb, NULL );
+    qof_book_destroy( book );
+    qof_event_unregister_handler( handler_id );
+    g_assert_cmpuint( teardown_events.book_destroyed, == , 1 );
+    g_assert_cmpuint( teardown_events.other_events, == , 0 );
+}
+
 void
 test_suite_qofbook ( void )
 {
@@ -938,10 +1027,12 @@ test_suite_qofbook ( void )
     GNC_TEST_ADD( suitename, "session dirty time", Fixture, NULL, setup, test_book_get_session_dirty_time, teardown );
     GNC_TEST_ADD( suitename, "set dirty callback", Fixture, NULL, setup, test_book_set_dirty_cb, teardown );
     GNC_TEST_ADD( suitename, "shutting down", Fixture, NULL, setup, test_book_shutting_down, teardown );
+    GNC_TEST_ADD( suitename, "dirty instances", Fixture, NULL, setup, test_book_dirty_instances, teardown );
     GNC_TEST_ADD( suitename, "set get data", Fixture, NULL, setup, test_book_set_get_data, teardown );
     GNC_TEST_ADD( suitename, "get collection", Fixture, NULL, setup, test_book_get_collection, teardown );
     GNC_TEST_ADD( suitename, "foreach collection", Fixture, NULL, setup, test_book_foreach_collection, teardown );
     GNC_TEST_ADD_FUNC( suitename, "set data finalizers", test_book_set_data_fin );
     GNC_TEST_ADD( suitename, "mark closed", Fixture, NULL, setup, test_book_mark_closed, teardown );
     GNC_TEST_ADD_FUNC( suitename, "book new and destroy", test_book_new_destroy );
+    GNC_TEST_ADD_FUNC( suitename, "book destroy events", test_book_destroy_events );
 }
@@ -31,6 +31,7 @@ extern "C"
 }
 #include "../qof-backend.hpp"
 #include "../kvp-frame.hpp"
+#include "../qofinstance-p.h"
 static const gchar *suitename = "/qof/qofinstance";
 extern "C" void test_suite_qofinstance ( void );
 static gchar* error_message;
@@ -219,6 +220,10 @@ test_instance_new_destroy( void )
     g_assert( qof_instance_get_guid( inst ) );
     g_assert( !qof_instance_get_collection( inst ) );
     g_assert( qof_instance_get_book( inst ) == NULL );
+    /* the slots frame is only allocated when it's first asked for */
+    g_assert( !inst->kvp_data );
+    g_assert( !qof_instance_has_kvp( inst ) );
+    g_assert( qof_instance_get_slots( inst ) );
     g_assert( inst->kvp_data );
     g_object_get( inst, "last-update", &time_priv, NULL);
     g_assert_cmpint( time_priv->t, == , 0 );
@@ -26,6 +26,7 @@ extern "C"
 {
 #include <config.h>
 #include "qof.h"
+#include "qofquery-p.h"
 #include "cashobjects.h"
 #include "Transaction.h"
 #include "TransLog.h"
@@ -68,6 +69,215 @@ test_trans_query (Transaction *trans, gpointer data)
     return 0;
 }
 
+/* A single-account, date-bounded query is answered from the account's
+ * split index; it must find exactly the splits the account's own range
+ * traversal finds. */
+static void
+test_account_date_query (Account *acc, gpointer data)
+{
+    QofBook *book = QOF_BOOK(data);
+    GList *splits = xaccAccountGetSplitList (acc);
+    GList *expected, *list;
+    time64 start, end;
+    QofQuery *q;
+
+    if (!splits)
+        return;
+    start = xaccTransGetDate (xaccSplitGetParent (GNC_SPLIT(splits->data)));
+    end = xaccTransGetDate (xaccSplitGetParent
+                            (GNC_SPLIT(g_list_last (splits)->data)));
+    start += (end - start) / 4;
+    end -= (end - start) / 4;
+
+    q = qof_query_create_for (GNC_ID_SPLIT);
+    qof_query_set_book (q, book);
+    xaccQueryAddSingleAccountMatch (q, acc, QOF_QUERY_AND);
+    xaccQueryAddDateMatchTT (q, TRUE, start, TRUE, end, QOF_QUERY_AND);
+
+    expected = xaccAccountGetSplitsInRange (acc, start, end);
+    list = qof_query_run (q);
+    if (g_list_length (list) != g_list_length (expected))
+        failure_args ("account date query", __FILE__, __LINE__,
+                      "query found %d splits, account range has %d",
+                      g_list_length (list), g_list_length (expected));
+    else
+        success ("account date query");
+
+    g_list_free (expected);
+    qof_query_destroy (q);
+}
+
+/* With max_results set only the kept tail is sorted; it has to be the
+ * same tail a full sort followed by the crop gives. */
+static void
+test_max_results_query (QofBook *book)
+{
+    QofQuery *q = qof_query_create_for (GNC_ID_SPLIT);
+    GList *full, *top, *tail;
+    guint n;
+
+    qof_query_set_book (q, book);
+    qof_query_set_sort_order (q,
+                              qof_query_build_param_list (SPLIT_TRANS,
+                                                          TRANS_DATE_POSTED, NULL),
+                              qof_query_build_param_list (QUERY_DEFAULT_SORT, NULL),
+                              NULL);
+    full = g_list_copy (qof_query_run (q));
+    n = g_list_length (full);
+
+    qof_query_set_max_results (q, n / 3);
+    top = qof_query_run (q);
+    tail = g_list_nth (full, n - n / 3);
+    for (; tail && top; tail = tail->next, top = top->next)
+        if (tail->data != top->data)
+            break;
+
+    if (tail || top)
+        failure ("max_results query doesn't match the cropped full sort");
+    else
+        success ("max_results query");
+
+    g_list_free (full);
+    qof_query_destroy (q);
+}
+
+/* A live query updated from events has to end up with the same
+ * splits as a fresh run after a transaction goes away. */
+static void
+test_live_query (Account *acc, QofBook *book)
+{
+    QofQuery *live, *fresh;
+    GList *splits;
+    Transaction *trans;
+
+    if (!acc || !(splits = xaccAccountGetSplitList (acc)))
+        return;
+
+    live = qof_query_create_for (GNC_ID_SPLIT);
+    qof_query_set_book (live, book);
+    xaccQueryAddSingleAccountMatch (live, acc, QOF_QUERY_AND);
+    fresh = qof_query_copy (live);
+    qof_query_set_live (live, TRUE);
+    qof_query_run (live);
+
+    trans = xaccSplitGetParent (GNC_SPLIT(splits->data));
+    xaccTransBeginEdit (trans);
+    xaccTransDestroy (trans);
+    xaccTransCommitEdit (trans);
+
+    if (g_list_length (qof_query_run (live)) !=
+        g_list_length (qof_query_run (fresh)))
+        failure ("live query results differ from a fresh run");
+    else
+        success ("live query");
+
+    qof_query_destroy (live);
+    qof_query_destroy (fresh);
+}
+
+/* A transaction's date is edited without modifying its splits, but a
+ * live split query matching on it has to follow the edit. */
+static void
+test_live_date_query (Account *acc, QofBook *book)
+{
+    QofQuery *live, *fresh;
+    GList *splits, *a, *b;
+    Transaction *trans;
+    time64 cutoff;
+
+    if (!acc || !(splits = xaccAccountGetSplitList (acc)))
+        return;
+
+    trans = xaccSplitGetParent (GNC_SPLIT(splits->data));
+    cutoff = xaccTransGetDate (trans);
+    live = qof_query_create_for (GNC_ID_SPLIT);
+    qof_query_set_book (live, book);
+    xaccQueryAddSingleAccountMatch (live, acc, QOF_QUERY_AND);
+    xaccQueryAddDateMatchTT (live, FALSE, 0, TRUE, cutoff, QOF_QUERY_AND);
+    fresh = qof_query_copy (live);
+    qof_query_set_live (live, TRUE);
+    qof_query_run (live);
+
+    xaccTransBeginEdit (trans);
+    xaccTransSetDatePostedSecs (trans, cutoff + 10 * 86400);
+    xaccTransCommitEdit (trans);
+
+    a = qof_query_run (live);
+    b = qof_query_run (fresh);
+    for (; a && b; a = a->next, b = b->next)
+        if (a->data != b->data)
+            break;
+    if (a || b)
+        failure ("live query missed a transaction's date change");
+    else
+        success ("live date query");
+
+    qof_query_destroy (live);
+    qof_query_destroy (fresh);
+}
+
+/* A split moved by a transaction that is still open isn't in its new
+ * account's split list yet, but a query on that account has to find it. */
+static void
+test_open_trans_query (Account *from, Account *to, QofBook *book)
+{
+    QofQuery *q;
+    GList *splits;
+    Split *split;
+    Transaction *trans;
+
+    if (!from || !to || from == to || !(splits = xaccAccountGetSplitList (from)))
+        return;
+
+    split = GNC_SPLIT(splits->data);
+    trans = xaccSplitGetParent (split);
+    xaccTransBeginEdit (trans);
+    xaccSplitSetAccount (split, to);
+
+    q = qof_query_create_for (GNC_ID_SPLIT);
+    qof_query_set_book (q, book);
+    xaccQueryAddSingleAccountMatch (q, to, QOF_QUERY_AND);
+    if (!g_list_find (qof_query_run (q), split))
+        failure ("account query missed a split of an open transaction");
+    else
+        success ("open transaction query");
+
+    xaccTransRollbackEdit (trans);
+    qof_query_destroy (q);
+}
+
+/* The threaded scan has to find the same splits, in the same order,
+ * as the serial one. */
+static void
+test_parallel_query (QofBook *book)
+{
+    QofQuery *serial, *parallel;
+    GList *a, *b;
+
+    serial = qof_query_create_for (GNC_ID_SPLIT);
+    qof_query_set_book (serial, book);
+    xaccQueryAddDateMatchTT (serial, FALSE, 0, TRUE, gnc_time (NULL),
+                             QOF_QUERY_AND);
+    parallel = qof_query_copy (serial);
+    qof_query_set_parallel (parallel, TRUE);
+
+    qof_query_set_parallel_min_objects (1);
+    a = qof_query_run (serial);
+    b = qof_query_run (parallel);
+    qof_query_set_parallel_min_objects (0);
+
+    for (; a && b; a = a->next, b = b->next)
+        if (a->data != b->data)
+            break;
+    if (a || b)
+        failure ("parallel query results differ from the serial scan");
+    else
+        success ("parallel query");
+
+    qof_query_destroy (serial);
+    qof_query_destroy (parallel);
+}
+
 static void
 run_test (void)
 {
@@ -82,6 +292,13 @@ run_test (void)
     add_random_transactions_to_book (book, 20);
 
     xaccAccountTreeForEachTransaction (root, test_trans_query, book);
+    gnc_account_foreach_descendant (root, test_account_date_query, book);
+    test_max_results_query (book);
+    test_live_query (gnc_account_nth_child (root, 0), book);
+    test_live_date_query (gnc_account_nth_child (root, 0), book);
+    test_open_trans_query (gnc_account_nth_child (root, 0),
+                           gnc_account_nth_child (root, 1), book);
+    test_parallel_query (book);
 
     qof_session_end (session);
 }
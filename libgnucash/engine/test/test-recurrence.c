@@ -398,6 +398,33 @@ static void test_some()
     test_specific(PERIOD_DAY, 7,    4, 1, 2000,    4, 8, 2000,  4, 15, 2000);
 }
 
+static void test_instances()
+{
+    PeriodType pt;
+    Recurrence r;
+    GDate start, nth, dates[40];
+    guint i;
+
+    g_date_set_dmy(&start, 31, 1, 2005);
+    for (pt = PERIOD_ONCE; pt < NUM_PERIOD_TYPES; pt++)
+    {
+        recurrenceSet(&r, 2, pt, &start, WEEKEND_ADJ_BACK);
+        recurrenceGetInstances(&r, 40, dates);
+        for (i = 0; i < 40; i++)
+        {
+            recurrenceNthInstance(&r, i, &nth);
+            if (!g_date_valid(&nth))
+            {
+                do_test(!g_date_valid(&dates[i]), "instance past the end");
+                break;
+            }
+            if (!test_equal(&dates[i], &nth))
+                return;
+        }
+    }
+    success("instances match nth instance");
+}
+
 static void test_use()
 {
     Recurrence *r;
@@ -416,6 +443,8 @@ static void test_main()
 
     test_some();
 
+    test_instances();
+
     test_all();
 
     qof_book_destroy (book);
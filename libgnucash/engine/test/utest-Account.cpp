@@ -890,7 +890,7 @@ test_xaccFreeAccount (Fixture *fixture, gconstpointer pData)
     /* Check that we've got children, lots, and splits to remove */
     g_assert (p_priv->children != NULL);
     g_assert (p_priv->lots != NULL);
-    g_assert (p_priv->splits != NULL);
+    g_assert (!p_priv->splits.empty());
     g_assert (p_priv->parent != NULL);
     g_assert (p_priv->commodity != NULL);
     g_assert_cmpint (check1->hits, ==, 0);
@@ -1005,7 +1005,7 @@ test_xaccAccountCommitEdit (Fixture *fixture, gconstpointer pData)
     /* Check that we've got children, lots, and splits to remove */
     g_assert (p_priv->children != NULL);
     g_assert (p_priv->lots != NULL);
-    g_assert (p_priv->splits != NULL);
+    g_assert (!p_priv->splits.empty());
     g_assert (p_priv->parent != NULL);
     g_assert (p_priv->commodity != NULL);
     g_assert_cmpint (check1->hits, ==, 0);
@@ -1021,7 +1021,7 @@ test_xaccAccountCommitEdit (Fixture *fixture, gconstpointer pData)
     test_signal_assert_hits (sig2, 0);
     g_assert (p_priv->children != NULL);
     g_assert (p_priv->lots != NULL);
-    g_assert (p_priv->splits != NULL);
+    g_assert (!p_priv->splits.empty());
     g_assert (p_priv->parent != NULL);
     g_assert (p_priv->commodity != NULL);
     g_assert_cmpint (check1->hits, ==, 0);
@@ -1105,19 +1105,19 @@ test_gnc_account_insert_remove_split (Fixture *fixture, gconstpointer pData)
 
     /* Check that the call fails with invalid account and split (throws) */
     g_assert (!gnc_account_insert_split (NULL, split1));
-    g_assert_cmpuint (g_list_length (priv->splits), == , 0);
+    g_assert_cmpuint (priv->splits.size(), == , 0);
     g_assert (!priv->sort_dirty);
     g_assert (!priv->balance_dirty);
     test_signal_assert_hits (sig1, 0);
     test_signal_assert_hits (sig2, 0);
     g_assert (!gnc_account_insert_split (fixture->acct, NULL));
-    g_assert_cmpuint (g_list_length (priv->splits), == , 0);
+    g_assert_cmpuint (priv->splits.size(), == , 0);
     g_assert (!priv->sort_dirty);
     g_assert (!priv->balance_dirty);
     test_signal_assert_hits (sig1, 0);
     test_signal_assert_hits (sig2, 0);
     /* g_assert (!gnc_account_insert_split (fixture->acct, (Split*)priv)); */
-    /* g_assert_cmpuint (g_list_length (priv->splits), == , 0); */
+    /* g_assert_cmpuint (priv->splits.size(), == , 0); */
     /* g_assert (!priv->sort_dirty); */
     /* g_assert (!priv->balance_dirty); */
     /* test_signal_assert_hits (sig1, 0); */
@@ -1130,7 +1130,7 @@ test_gnc_account_insert_remove_split (Fixture *fixture, gconstpointer pData)
 
     /* Check that it works the first time */
     g_assert (gnc_account_insert_split (fixture->acct, split1));
-    g_assert_cmpuint (g_list_length (priv->splits), == , 1);
+    g_assert_cmpuint (priv->splits.size(), == , 1);
     g_assert (!priv->sort_dirty);
     g_assert (priv->balance_dirty);
     test_signal_assert_hits (sig1, 1);
@@ -1142,7 +1142,7 @@ test_gnc_account_insert_remove_split (Fixture *fixture, gconstpointer pData)
     sig3 = test_signal_new (&fixture->acct->inst, GNC_EVENT_ITEM_ADDED, split2);
     /* Now add a second split to the account and check that sort_dirty isn't set. We have to bump the editlevel to force this. */
     g_assert (gnc_account_insert_split (fixture->acct, split2));
-    g_assert_cmpuint (g_list_length (priv->splits), == , 2);
+    g_assert_cmpuint (priv->splits.size(), == , 2);
     g_assert (!priv->sort_dirty);
     g_assert (priv->balance_dirty);
     test_signal_assert_hits (sig1, 2);
@@ -1153,7 +1153,7 @@ test_gnc_account_insert_remove_split (Fixture *fixture, gconstpointer pData)
     qof_instance_increase_editlevel (fixture->acct);
     g_assert (gnc_account_insert_split (fixture->acct, split3));
     qof_instance_decrease_editlevel (fixture->acct);
-    g_assert_cmpuint (g_list_length (priv->splits), == , 3);
+    g_assert_cmpuint (priv->splits.size(), == , 3);
     g_assert (priv->sort_dirty);
     g_assert (priv->balance_dirty);
     test_signal_assert_hits (sig1, 3);
@@ -1164,7 +1164,7 @@ test_gnc_account_insert_remove_split (Fixture *fixture, gconstpointer pData)
     sig3 = test_signal_new (&fixture->acct->inst, GNC_EVENT_ITEM_REMOVED,
                             split3);
     g_assert (gnc_account_remove_split (fixture->acct, split3));
-    g_assert_cmpuint (g_list_length (priv->splits), == , 2);
+    g_assert_cmpuint (priv->splits.size(), == , 2);
     g_assert (priv->sort_dirty);
     g_assert (!priv->balance_dirty);
     test_signal_assert_hits (sig1, 4);
@@ -1172,11 +1172,19 @@ test_gnc_account_insert_remove_split (Fixture *fixture, gconstpointer pData)
     /* And do it again to make sure that it fails when the split has
      * already been removed */
     g_assert (!gnc_account_remove_split (fixture->acct, split3));
-    g_assert_cmpuint (g_list_length (priv->splits), == , 2);
+    g_assert_cmpuint (priv->splits.size(), == , 2);
     g_assert (priv->sort_dirty);
     g_assert (!priv->balance_dirty);
     test_signal_assert_hits (sig1, 4);
     test_signal_assert_hits (sig3, 1);
+    /* The GList handed out to C callers mirrors the sorted vector. */
+    auto list = xaccAccountGetSplitList (fixture->acct);
+    g_assert (!priv->sort_dirty);
+    g_assert_cmpuint (g_list_length (list), == , 2);
+    g_assert (g_list_find (list, split1) != NULL);
+    g_assert (g_list_find (list, split2) != NULL);
+    g_assert (xaccSplitOrder (static_cast<Split*>(list->data),
+                              static_cast<Split*>(list->next->data)) < 0);
 
     /* Clean up the handlers */
     test_signal_free (sig3);
@@ -1283,21 +1291,135 @@ test_xaccAccountInsertRemoveLot (Fixture *fixture, gconstpointer pData)
     test_signal_free (sig4);
 
 }
-/*
+/* xaccAccountMoveAllSplits
+void
+xaccAccountMoveAllSplits (Account *accfrom, Account *accto)// C: 5 in 3 */
 static void
-xaccPreSplitMove (Split *split, gpointer dummy)// 2
+test_xaccAccountMoveAllSplits ()
+{
+    auto book = qof_book_new ();
+    auto curr = gnc_commodity_new (book, "US Dollar", "CURRENCY", "USD", "0", 100);
+    auto from = xaccMallocAccount (book);
+    auto to = xaccMallocAccount (book);
+    auto other = xaccMallocAccount (book);
+    AccountTestFunctions *func = _utest_account_fill_functions ();
+    auto from_priv = func->get_private (from);
+    auto to_priv = func->get_private (to);
+    auto start = gnc_dmy2time64_neutral (1, 1, 2020);
+    const time64 day = 24 * 3600;
+    auto one = gnc_numeric_create (1, 1);
+
+    xaccAccountSetCommodity (from, curr);
+    xaccAccountSetCommodity (to, curr);
+    xaccAccountSetCommodity (other, curr);
+    /* Even days in from, odd ones in to; day 4 has both its splits in
+     * from, so that transaction is begun and committed only once. */
+    for (int i = 0; i < 8; i++)
+    {
+        auto txn = xaccMallocTransaction (book);
+        auto s1 = xaccMallocSplit (book);
+        auto s2 = xaccMallocSplit (book);
+        xaccTransBeginEdit (txn);
+        xaccTransSetCurrency (txn, curr);
+        xaccTransSetDatePostedSecsNormalized (txn, start + i * day);
+        xaccSplitSetParent (s1, txn);
+        xaccSplitSetParent (s2, txn);
+        xaccSplitSetAccount (s1, i % 2 ? to : from);
+        xaccSplitSetAccount (s2, i == 4 ? from : other);
+        xaccSplitSetAmount (s1, one);
+        xaccSplitSetValue (s1, one);
+        xaccSplitSetAmount (s2, gnc_numeric_neg (one));
+        xaccSplitSetValue (s2, gnc_numeric_neg (one));
+        xaccTransCommitEdit (txn);
+    }
+    g_assert_cmpint (from_priv->splits.size (), ==, 5);
+    g_assert_cmpint (to_priv->splits.size (), ==, 4);
+
+    xaccAccountMoveAllSplits (from, to);
+    g_assert_true (from_priv->splits.empty ());
+    g_assert_true (from_priv->splits_moving_out.empty ());
+    g_assert_true (gnc_numeric_zero_p (xaccAccountGetBalance (from)));
+    g_assert_cmpint (to_priv->splits.size (), ==, 9);
+    for (size_t i = 1; i < to_priv->splits.size (); ++i)
+        g_assert_cmpint (xaccSplitOrder (to_priv->splits[i - 1],
+                                         to_priv->splits[i]), <, 0);
+    for (auto s : to_priv->splits)
+        g_assert_true (xaccSplitGetAccount (s) == to);
+    g_assert_cmpint (xaccAccountGetBalance (to).num, ==, 7);
+    g_assert_cmpint (g_list_length (xaccAccountGetSplitList (to)), ==, 9);
+
+    g_free (func);
+    qof_book_destroy (book);
+}
+
 static void
-xaccPostSplitMove (Split *split, Account *accto)// 2
-void
-xaccAccountMoveAllSplits (Account *accfrom, Account *accto)// C: 5 in 3
-
-* All of the work is done in other classes which in turn call other
-* Account functions (gnc_account_add_split and
-* gnc_account_remove_split). Mock classes with the functions that call
-* those wouldn't really achieve anything, since the actual functions
-* could break by failing to call gnc_account_*_split and the test
-* wouldn't know.
-*/
+test_xaccAccountGetUnreconciledSplits ()
+{
+    auto book = qof_book_new ();
+    auto curr = gnc_commodity_new (book, "US Dollar", "CURRENCY", "USD", "0", 100);
+    auto acc = xaccMallocAccount (book);
+    auto other = xaccMallocAccount (book);
+    auto start = gnc_dmy2time64_neutral (1, 1, 2020);
+    const time64 day = 24 * 3600;
+    auto one = gnc_numeric_create (1, 1);
+    const char states[] = { NREC, YREC, CREC, YREC, NREC, YREC };
+    Split *splits[6];
+
+    xaccAccountSetCommodity (acc, curr);
+    xaccAccountSetCommodity (other, curr);
+    /* Created latest first, so the index has to sort them. */
+    for (int i = 5; i >= 0; i--)
+    {
+        auto txn = xaccMallocTransaction (book);
+        auto s1 = xaccMallocSplit (book);
+        auto s2 = xaccMallocSplit (book);
+        xaccTransBeginEdit (txn);
+        xaccTransSetCurrency (txn, curr);
+        xaccTransSetDatePostedSecsNormalized (txn, start + i * day);
+        xaccSplitSetParent (s1, txn);
+        xaccSplitSetParent (s2, txn);
+        xaccSplitSetAccount (s1, acc);
+        xaccSplitSetAccount (s2, other);
+        xaccSplitSetAmount (s1, one);
+        xaccSplitSetValue (s1, one);
+        xaccSplitSetAmount (s2, gnc_numeric_neg (one));
+        xaccSplitSetValue (s2, gnc_numeric_neg (one));
+        xaccSplitSetReconcile (s1, states[i]);
+        xaccTransCommitEdit (txn);
+        splits[i] = s1;
+    }
+
+    auto list = xaccAccountGetUnreconciledSplits (acc);
+    g_assert_cmpint (g_list_length (list), ==, 3);
+    g_assert_true (g_list_nth_data (list, 0) == splits[0]);
+    g_assert_true (g_list_nth_data (list, 1) == splits[2]);
+    g_assert_true (g_list_nth_data (list, 2) == splits[4]);
+    g_list_free (list);
+
+    /* Reconciling, unreconciling and moving splits update the index;
+     * a rolled back change is undone in it too. */
+    xaccSplitSetReconcile (splits[0], YREC);
+    xaccSplitSetReconcile (splits[3], CREC);
+    auto txn = xaccSplitGetParent (splits[2]);
+    xaccTransBeginEdit (txn);
+    xaccSplitSetReconcile (splits[2], YREC);
+    xaccTransRollbackEdit (txn);
+    xaccSplitSetAccount (splits[4], other);
+
+    list = xaccAccountGetUnreconciledSplits (acc);
+    g_assert_cmpint (g_list_length (list), ==, 2);
+    g_assert_true (g_list_nth_data (list, 0) == splits[2]);
+    g_assert_true (g_list_nth_data (list, 1) == splits[3]);
+    g_list_free (list);
+
+    xaccAccountMoveAllSplits (acc, other);
+    g_assert_null (xaccAccountGetUnreconciledSplits (acc));
+    list = xaccAccountGetUnreconciledSplits (other);
+    g_assert_cmpint (g_list_length (list), ==, 9);
+    g_list_free (list);
+
+    qof_book_destroy (book);
+}
 
 /* xaccAccountRecomputeBalance
 void
@@ -1330,6 +1452,20 @@ test_xaccAccountRecomputeBalance (Fixture *fixture, gconstpointer pData)
     g_assert (gnc_numeric_eq (priv->cleared_balance, clr_bal));
     g_assert (gnc_numeric_eq (priv->reconciled_balance, rec_bal));
     g_assert (!priv->balance_dirty);
+
+    /* Changing the last split leaves the earlier running balances alone. */
+    auto first = priv->splits.front();
+    auto first_bal = first->balance;
+    g_assert (!gnc_numeric_zero_p (first_bal));
+    first->balance = gnc_numeric_zero ();
+    gnc_account_split_changed (fixture->acct, priv->splits.back());
+    g_assert (priv->balance_dirty);
+    g_assert_cmpuint (priv->balance_dirty_from, ==, priv->splits.size() - 1);
+    xaccAccountRecomputeBalance (fixture->acct);
+    g_assert (gnc_numeric_zero_p (first->balance));
+    g_assert (gnc_numeric_eq (priv->balance, bal));
+    g_assert (!priv->balance_dirty);
+    first->balance = first_bal;
 }
 
 /* xaccAccountOrder
@@ -1641,6 +1777,53 @@ test_gnc_account_get_descendants_sorted (Fixture *fixture, gconstpointer pData)
     g_assert_cmpint (g_list_index (list, fixture->acct), == , 10);
     g_list_free (list);
 }
+/* gnc_account_get_descendants_array
+   gnc_account_get_descendants_sorted_array */
+static void
+test_gnc_account_get_descendants_array (Fixture *fixture, gconstpointer pData)
+{
+    Account *root = gnc_account_get_root (fixture->acct);
+    Account *income = gnc_account_lookup_by_full_name (root, "income");
+    Account *exempt = gnc_account_lookup_by_full_name (root, "income:exempt");
+    gsize n = 0, n_sorted = 0;
+    GList *list, *node;
+    gsize i;
+
+    auto accts = gnc_account_get_descendants_array (root, &n);
+    list = gnc_account_get_descendants (root);
+    g_assert_cmpuint (n, == , g_list_length (list));
+    for (node = list, i = 0; node; node = node->next, ++i)
+        g_assert (accts[i] == node->data);
+    g_list_free (list);
+    auto sorted = gnc_account_get_descendants_sorted_array (root, &n_sorted);
+    g_assert_cmpuint (n_sorted, == , 34);
+    g_assert (sorted[10] == fixture->acct);
+
+    /* Adding an account shows up all the way up. */
+    auto acc = xaccMallocAccount (gnc_account_get_book (root));
+    xaccAccountSetCode (acc, "4200");
+    gnc_account_append_child (exempt, acc);
+    g_assert_cmpint (gnc_account_n_descendants (root), == , 35);
+    g_assert_cmpint (gnc_account_n_descendants (income), == , 14);
+    list = gnc_account_get_children_sorted (exempt);
+    g_assert (list->data == acc);
+    g_list_free (list);
+
+    /* Changing its code changes the sorted order only. */
+    xaccAccountSetCode (acc, "4299");
+    list = gnc_account_get_children_sorted (exempt);
+    g_assert (g_list_last (list)->data == acc);
+    g_list_free (list);
+    sorted = gnc_account_get_descendants_sorted_array (income, &n_sorted);
+    accts = gnc_account_get_descendants_array (income, &n);
+    g_assert_cmpuint (n, == , n_sorted);
+    g_assert (accts[n - 1] == acc);
+
+    gnc_account_remove_child (exempt, acc);
+    g_assert_cmpint (gnc_account_n_descendants (root), == , 34);
+    xaccAccountBeginEdit (acc);
+    xaccAccountDestroy (acc);
+}
 /* gnc_account_lookup_by_name
 Account *
 gnc_account_lookup_by_name (const Account *parent, const char * name)// C: 22 in 12 */
@@ -1746,6 +1929,46 @@ test_gnc_account_lookup_by_full_name (Fixture *fixture, gconstpointer pData)
     g_assert (target == NULL);
     g_free (code);
 }
+/* The index behind gnc_account_lookup_by_full_name and
+ * gnc_account_lookup_by_code has to follow renames, recodes and
+ * reparenting, and duplicates have to resolve as the walk does. */
+static void
+test_gnc_account_lookup_index (Fixture *fixture, gconstpointer pData)
+{
+    Account *root = gnc_account_get_root (fixture->acct);
+    Account *taxable, *exempt, *interest, *target;
+
+    taxable = gnc_account_lookup_by_full_name (root, "income:taxable");
+    exempt = gnc_account_lookup_by_full_name (root, "income:exempt");
+    interest = gnc_account_lookup_by_full_name (root, "income:taxable:int");
+    g_assert (taxable && exempt && interest);
+    g_assert (gnc_account_lookup_by_full_name (root, "") == NULL);
+    /* Both div and div1 have code 4140, div comes first. */
+    target = gnc_account_lookup_by_code (root, "4140");
+    g_assert_cmpstr (xaccAccountGetName (target), == , "div");
+    g_assert (gnc_account_get_parent (target) == taxable);
+
+    xaccAccountSetName (taxable, "taxed");
+    g_assert (gnc_account_lookup_by_full_name (root, "income:taxable:int") == NULL);
+    g_assert (gnc_account_lookup_by_full_name (root, "income:taxed:int") == interest);
+
+    xaccAccountSetCode (interest, "4161");
+    g_assert (gnc_account_lookup_by_code (root, "4160") == NULL);
+    g_assert (gnc_account_lookup_by_code (root, "4161") == interest);
+    g_assert (gnc_account_lookup_by_code (exempt, "4161") == NULL);
+
+    /* Now there are two income:exempt:int, the original one wins. */
+    gnc_account_append_child (exempt, interest);
+    g_assert (gnc_account_lookup_by_full_name (root, "income:taxed:int") == NULL);
+    target = gnc_account_lookup_by_full_name (root, "income:exempt:int");
+    g_assert (target != interest);
+    g_assert_cmpstr (xaccAccountGetCode (target), == , "4210");
+    g_assert (gnc_account_lookup_by_code (exempt, "4161") == interest);
+
+    gnc_account_remove_child (exempt, interest);
+    g_assert (gnc_account_lookup_by_code (root, "4161") == NULL);
+    gnc_account_append_child (taxable, interest);
+}
 
 static void
 thunk (Account *s, gpointer data)
@@ -1907,6 +2130,80 @@ test_xaccAccountGetProjectedMinimumBalance (Fixture *fixture, gconstpointer pDat
     dval = gnc_numeric_to_double (val);
     g_assert_cmpfloat (dval, == , dbal);
 }
+/* gnc_account_get_projected_minimum_balances
+void
+gnc_account_get_projected_minimum_balances (Account * const *accounts,
+                                            gsize n_accounts,
+                                            gnc_numeric *balances) */
+static void
+test_gnc_account_get_projected_minimum_balances (Fixture *fixture,
+                                                 gconstpointer pData)
+{
+    Account *root = gnc_account_get_root (fixture->acct);
+    gsize n = 0;
+    auto accts = gnc_account_get_descendants_array (root, &n);
+    std::vector<gnc_numeric> mins (n);
+
+    for (gsize i = 0; i < n; ++i)
+        xaccAccountRecomputeBalance (accts[i]);
+    gnc_account_get_projected_minimum_balances (accts, n, mins.data ());
+    for (gsize i = 0; i < n; ++i)
+        g_assert (gnc_numeric_equal (mins[i],
+                  xaccAccountGetProjectedMinimumBalance (accts[i])));
+
+    /* A new starting balance moves every running balance, and the
+     * cached minimum with them. */
+    auto start = gnc_numeric_create (1000, 1);
+    auto before = xaccAccountGetProjectedMinimumBalance (fixture->acct);
+    gnc_account_set_start_balance (fixture->acct, start);
+    xaccAccountRecomputeBalance (fixture->acct);
+    Account *acct = fixture->acct;
+    gnc_numeric after;
+    gnc_account_get_projected_minimum_balances (&acct, 1, &after);
+    g_assert (gnc_numeric_equal (after, gnc_numeric_add_fixed (before, start)));
+}
+static gint
+count_split_cb (Split *split, gpointer data)
+{
+    auto count = static_cast<guint*>(data);
+    return ++*count == 2 ? 42 : 0;
+}
+
+static void
+test_xaccAccountForEachSplitInRange (Fixture *fixture, gconstpointer pData)
+{
+    auto splits = xaccAccountGetSplitList (fixture->acct);
+    auto n_splits = g_list_length (splits);
+    g_assert_cmpuint (n_splits, >, 2);
+    auto t0 = xaccTransGetDate (xaccSplitGetParent (static_cast<Split*>(g_list_nth_data (splits, 1))));
+    auto t1 = xaccTransGetDate (xaccSplitGetParent (static_cast<Split*>(g_list_nth_data (splits, n_splits - 2))));
+    GList *expected = NULL;
+
+    for (auto node = splits; node; node = node->next)
+    {
+        auto date = xaccTransGetDate (xaccSplitGetParent (static_cast<Split*>(node->data)));
+        if (date >= t0 && date <= t1)
+            expected = g_list_prepend (expected, node->data);
+    }
+    expected = g_list_reverse (expected);
+
+    auto range = xaccAccountGetSplitsInRange (fixture->acct, t0, t1);
+    g_assert_cmpuint (g_list_length (range), ==, g_list_length (expected));
+    for (GList *r = range, *e = expected; r && e; r = r->next, e = e->next)
+        g_assert (r->data == e->data);
+    g_list_free (range);
+    g_list_free (expected);
+
+    g_assert (xaccAccountGetSplitsInRange (fixture->acct, t1 + 1, t0 - 1) == NULL);
+
+    /* Traversal stops at the first non-zero result and returns it. */
+    guint count = 0;
+    g_assert_cmpint (xaccAccountForEachSplitInRange (fixture->acct, INT64_MIN,
+                                                     INT64_MAX, count_split_cb,
+                                                     &count),
+                     ==, 42);
+    g_assert_cmpuint (count, ==, 2);
+}
 /* xaccAccountGetBalanceAsOfDate
 gnc_numeric
 xaccAccountGetBalanceAsOfDate (Account *acc, time64 date)// C: 12 in 7 SCM: 4 in 4*/
@@ -1934,6 +2231,148 @@ test_xaccAccountGetBalanceAsOfDate (Fixture *fixture, gconstpointer pData)
                                          (gnc_time (NULL) - offset));
     dval = gnc_numeric_to_double (val);
     g_assert_cmpfloat (dval, == , dbal);
+    /* Only the second transaction is cleared. */
+    val = xaccAccountGetClearedBalanceAsOfDate (fixture->acct,
+                                                (gnc_time (NULL) - offset));
+    g_assert (gnc_numeric_equal (val, t_arr[1].splits[1].amount));
+    /* Nothing is posted before the first transaction. */
+    val = xaccAccountGetBalanceAsOfDate (fixture->acct,
+                                         (gnc_time (NULL) - 4 * offset));
+    g_assert (gnc_numeric_zero_p (val));
+}
+/* Enough splits to span several date checkpoints, one per day. */
+static void
+test_xaccAccountGetBalanceAsOfDate_checkpoints ()
+{
+    auto book = qof_book_new ();
+    auto curr = gnc_commodity_new (book, "US Dollar", "CURRENCY", "USD", "0", 100);
+    auto acc = xaccMallocAccount (book);
+    auto other = xaccMallocAccount (book);
+    auto start = gnc_dmy2time64_neutral (1, 1, 2020);
+    const time64 day = 24 * 3600;
+    const int num_txns = 200;
+    auto one = gnc_numeric_create (1, 1);
+
+    xaccAccountSetCommodity (acc, curr);
+    xaccAccountSetCommodity (other, curr);
+    for (int i = 0; i < num_txns; ++i)
+    {
+        auto txn = xaccMallocTransaction (book);
+        auto s1 = xaccMallocSplit (book);
+        auto s2 = xaccMallocSplit (book);
+        xaccTransBeginEdit (txn);
+        xaccTransSetCurrency (txn, curr);
+        xaccTransSetDatePostedSecsNormalized (txn, start + i * day);
+        xaccSplitSetParent (s1, txn);
+        xaccSplitSetParent (s2, txn);
+        xaccSplitSetAccount (s1, acc);
+        xaccSplitSetAccount (s2, other);
+        xaccSplitSetAmount (s1, one);
+        xaccSplitSetValue (s1, one);
+        xaccSplitSetAmount (s2, gnc_numeric_neg (one));
+        xaccSplitSetValue (s2, gnc_numeric_neg (one));
+        xaccTransCommitEdit (txn);
+    }
+
+    for (int i : {0, 1, 63, 64, 65, 127, 128, 150, 199, 200, 250})
+    {
+        auto expected = std::min (i, num_txns);
+        auto bal = xaccAccountGetBalanceAsOfDate (acc, start + i * day);
+        g_assert_cmpint (bal.num, ==, expected);
+        bal = xaccAccountGetBalanceAsOfDate (acc, start + i * day + 1);
+        g_assert_cmpint (bal.num, ==, std::min (i + 1, num_txns));
+    }
+    /* The batch form counts the splits posted at each date. */
+    std::vector<time64> dates;
+    for (int i : {-1, 0, 63, 64, 199, 250})
+        dates.push_back (start + i * day);
+    Account *accts[] = { acc, other };
+    std::vector<gnc_numeric> bals (2 * dates.size ());
+    gnc_account_get_balances_at_dates (accts, 2, dates.data (), dates.size (),
+                                       bals.data ());
+    for (size_t j = 0; j < dates.size (); ++j)
+    {
+        auto bal = xaccAccountGetBalanceAsOfDate (acc, dates[j] + 1);
+        g_assert (gnc_numeric_equal (bals[j], bal));
+        g_assert (gnc_numeric_equal (bals[dates.size () + j],
+                                     gnc_numeric_neg (bal)));
+    }
+    g_assert_cmpint (bals[0].num, ==, 0);
+    g_assert_cmpint (bals[2].num, ==, 64);
+    /* Going back in time drops the checkpoints after the edited split. */
+    auto split = static_cast<Split*>(g_list_nth_data (xaccAccountGetSplitList (acc), 150));
+    auto txn = xaccSplitGetParent (split);
+    xaccTransBeginEdit (txn);
+    xaccTransSetDatePostedSecsNormalized (txn, start - day);
+    xaccTransCommitEdit (txn);
+    g_assert_cmpint (xaccAccountGetBalanceAsOfDate (acc, start).num, ==, 1);
+    g_assert_cmpint (xaccAccountGetBalanceAsOfDate (acc, start + 151 * day).num, ==, 151);
+    g_assert_cmpint (xaccAccountGetBalanceAsOfDate (acc, start + 150 * day).num, ==, 151);
+    g_assert_cmpint (xaccAccountGetBalanceAsOfDate (acc, start + 149 * day).num, ==, 150);
+
+    qof_book_destroy (book);
+}
+/* gnc_account_begin_bulk_insert
+   gnc_account_end_bulk_insert */
+static void
+test_gnc_account_bulk_insert ()
+{
+    auto book = qof_book_new ();
+    auto curr = gnc_commodity_new (book, "US Dollar", "CURRENCY", "USD", "0", 100);
+    auto acc = xaccMallocAccount (book);
+    auto other = xaccMallocAccount (book);
+    AccountTestFunctions *func = _utest_account_fill_functions ();
+    auto priv = func->get_private (acc);
+    auto start = gnc_dmy2time64_neutral (1, 1, 2020);
+    const time64 day = 24 * 3600;
+    auto one = gnc_numeric_create (1, 1);
+    Split *first = nullptr;
+
+    xaccAccountSetCommodity (acc, curr);
+    xaccAccountSetCommodity (other, curr);
+    /* Days 0, 10, 20, ... go in sorted, then the odd days in bulk. */
+    for (int i : {0, 10, 20, 30, 25, 5, 15, 35})
+    {
+        if (i == 25)
+            gnc_account_begin_bulk_insert (acc);
+        auto txn = xaccMallocTransaction (book);
+        auto s1 = xaccMallocSplit (book);
+        auto s2 = xaccMallocSplit (book);
+        xaccTransBeginEdit (txn);
+        xaccTransSetCurrency (txn, curr);
+        xaccTransSetDatePostedSecsNormalized (txn, start + i * day);
+        xaccSplitSetParent (s1, txn);
+        xaccSplitSetParent (s2, txn);
+        xaccSplitSetAccount (s1, acc);
+        xaccSplitSetAccount (s2, other);
+        xaccSplitSetAmount (s1, one);
+        xaccSplitSetValue (s1, one);
+        xaccSplitSetAmount (s2, gnc_numeric_neg (one));
+        xaccSplitSetValue (s2, gnc_numeric_neg (one));
+        xaccTransCommitEdit (txn);
+        if (!first)
+            first = s1;
+    }
+    g_assert_true (priv->sort_dirty);
+    g_assert_cmpint (priv->sorted_upto, ==, 4);
+    g_assert_cmpint (priv->splits.size (), ==, 8);
+    g_assert_cmpint (priv->balance.num, ==, 4);
+    /* Re-inserting a split during a bulk insert isn't caught until the end. */
+    g_assert_true (gnc_account_insert_split (acc, priv->splits.back ()));
+    g_assert_false (gnc_account_insert_split (acc, first));
+
+    gnc_account_end_bulk_insert (acc);
+    g_assert_false (priv->sort_dirty);
+    g_assert_cmpint (priv->splits.size (), ==, 8);
+    for (size_t i = 1; i < priv->splits.size (); ++i)
+        g_assert_cmpint (xaccSplitOrder (priv->splits[i - 1], priv->splits[i]), <, 0);
+    g_assert_cmpint (priv->balance.num, ==, 8);
+    g_assert_cmpint (xaccSplitGetBalance (priv->splits[2]).num, ==, 3);
+    /* Ending a bulk insert that isn't there does nothing. */
+    gnc_account_end_bulk_insert (acc);
+
+    g_free (func);
+    qof_book_destroy (book);
 }
 /* xaccAccountGetPresentBalance
 gnc_numeric
@@ -1974,8 +2413,7 @@ test_xaccAccountGetPresentBalance (Fixture *fixture, gconstpointer pData)
  *
  * xaccAccountGetXxxBalanceInCurrency
  * xaccAccountGetXxxBalanceAsOfDateInCurrency
- * xaccAccountBalanceHelper
- * xaccAccountBalanceAsOfDateHelper
+ * xaccAccountGetSubtreeBalance
  * xaccAccountGetXxxBalanceInCurrencyRecursive
  * xaccAccountGetXxxBalanceAsOfDateInCurrencyRecursive
  * xaccAccountGetBalanceInCurrency
@@ -1985,7 +2423,135 @@ test_xaccAccountGetPresentBalance (Fixture *fixture, gconstpointer pData)
  * xaccAccountGetProjectedMinimumBalanceInCurrency
  * xaccAccountGetBalanceAsOfDateInCurrency
  * xaccAccountGetBalanceChangeForPeriod
+ *
+ * The memoization done by xaccAccountGetSubtreeBalance is tested here.
  */
+static void
+add_rollup_txn (QofBook *book, gnc_commodity *curr, Account *acc,
+                Account *other, gint64 amount)
+{
+    auto txn = xaccMallocTransaction (book);
+    auto s1 = xaccMallocSplit (book);
+    auto s2 = xaccMallocSplit (book);
+    auto amt = gnc_numeric_create (amount, 1);
+    xaccTransBeginEdit (txn);
+    xaccTransSetCurrency (txn, curr);
+    xaccTransSetDatePostedSecsNormalized (txn, gnc_time (NULL));
+    xaccSplitSetParent (s1, txn);
+    xaccSplitSetParent (s2, txn);
+    xaccSplitSetAccount (s1, acc);
+    xaccSplitSetAccount (s2, other);
+    xaccSplitSetAmount (s1, amt);
+    xaccSplitSetValue (s1, amt);
+    xaccSplitSetAmount (s2, gnc_numeric_neg (amt));
+    xaccSplitSetValue (s2, gnc_numeric_neg (amt));
+    xaccTransCommitEdit (txn);
+}
+
+static void
+test_xaccAccountGetBalanceInCurrency_rollup ()
+{
+    auto book = qof_book_new ();
+    auto curr = gnc_commodity_new (book, "US Dollar", "CURRENCY", "USD", "0", 100);
+    auto top = xaccMallocAccount (book);
+    auto child1 = xaccMallocAccount (book);
+    auto child2 = xaccMallocAccount (book);
+    auto other = xaccMallocAccount (book);
+    AccountTestFunctions *func = _utest_account_fill_functions ();
+    auto top_priv = func->get_private (top);
+    auto child1_priv = func->get_private (child1);
+    auto child2_priv = func->get_private (child2);
+
+    for (auto acc : {top, child1, child2, other})
+        xaccAccountSetCommodity (acc, curr);
+    gnc_account_append_child (top, child1);
+    gnc_account_append_child (top, child2);
+    add_rollup_txn (book, curr, child1, other, 3);
+    add_rollup_txn (book, curr, child2, other, 5);
+
+    auto bal = xaccAccountGetBalanceInCurrency (top, curr, TRUE);
+    g_assert_cmpint (bal.num, ==, 8);
+    g_assert_cmpint (top_priv->balance_rollups.size (), ==, 1);
+    g_assert_cmpint (child1_priv->balance_rollups.size (), ==, 1);
+    g_assert_cmpint (child2_priv->balance_rollups.size (), ==, 1);
+    /* Not recursing doesn't touch the cache. */
+    bal = xaccAccountGetBalanceInCurrency (top, curr, FALSE);
+    g_assert_cmpint (bal.num, ==, 0);
+    g_assert_cmpint (top_priv->balance_rollups.size (), ==, 1);
+
+    /* A change in one child drops only the sums that include it. */
+    add_rollup_txn (book, curr, child1, other, 4);
+    g_assert_true (top_priv->balance_rollups.empty ());
+    g_assert_true (child1_priv->balance_rollups.empty ());
+    g_assert_cmpint (child2_priv->balance_rollups.size (), ==, 1);
+    bal = xaccAccountGetBalanceInCurrency (top, curr, TRUE);
+    g_assert_cmpint (bal.num, ==, 12);
+
+    /* So does moving a subtree. */
+    gnc_account_remove_child (top, child2);
+    g_assert_true (top_priv->balance_rollups.empty ());
+    bal = xaccAccountGetBalanceInCurrency (top, curr, TRUE);
+    g_assert_cmpint (bal.num, ==, 7);
+
+    g_free (func);
+    qof_book_destroy (book);
+}
+/* gnc_account_tree_bring_up_to_date */
+static void
+test_gnc_account_tree_bring_up_to_date ()
+{
+    auto book = qof_book_new ();
+    auto curr = gnc_commodity_new (book, "US Dollar", "CURRENCY", "USD", "0", 100);
+    auto root = gnc_account_create_root (book);
+    auto other = xaccMallocAccount (book);
+    AccountTestFunctions *func = _utest_account_fill_functions ();
+    std::vector<Account*> accts;
+
+    xaccAccountSetCommodity (other, curr);
+    gnc_account_append_child (root, other);
+    for (int i = 0; i < 4; ++i)
+    {
+        auto acc = xaccMallocAccount (book);
+        xaccAccountSetCommodity (acc, curr);
+        gnc_account_append_child (root, acc);
+        accts.push_back (acc);
+    }
+    for (auto acc : accts)
+        gnc_account_begin_bulk_insert (acc);
+    gnc_account_begin_bulk_insert (other);
+    for (int i = 1; i <= 50; ++i)
+        add_rollup_txn (book, curr, accts[i % accts.size ()], other, i);
+    /* Prime a roll-up, it has to be dropped. */
+    auto root_priv = func->get_private (root);
+    root_priv->balance_rollups[BalanceRollupKey (0, curr, 0)] = gnc_numeric_zero ();
+
+    gnc_account_tree_bring_up_to_date (root);
+    g_assert_true (root_priv->balance_rollups.empty ());
+    gint64 total = 0;
+    for (auto acc : accts)
+    {
+        auto priv = func->get_private (acc);
+        g_assert_false (priv->sort_dirty);
+        g_assert_false (priv->balance_dirty);
+        gint64 running = 0;
+        for (size_t i = 0; i < priv->splits.size (); ++i)
+        {
+            if (i > 0)
+                g_assert_cmpint (xaccSplitOrder (priv->splits[i - 1], priv->splits[i]), <, 0);
+            running += xaccSplitGetAmount (priv->splits[i]).num;
+            g_assert_cmpint (xaccSplitGetBalance (priv->splits[i]).num, ==, running);
+        }
+        g_assert_cmpint (priv->balance.num, ==, running);
+        total += running;
+        gnc_account_end_bulk_insert (acc);
+    }
+    g_assert_cmpint (total, ==, 50 * 51 / 2);
+    g_assert_cmpint (xaccAccountGetBalance (other).num, ==, -total);
+    gnc_account_end_bulk_insert (other);
+
+    g_free (func);
+    qof_book_destroy (book);
+}
 /*
  * Yet more getters & setters:
  * xaccAccountGetSplitList
@@ -2081,6 +2647,35 @@ test_xaccAccountForEachLot (Fixture *fixture, gconstpointer pData)
  * xaccAccountSetHidden
  * xaccAccountIsHidden
 */
+/* The boolean ones are cached in the account, so check that the cache
+ * follows both the setters and writes straight to the KVP. */
+static void
+test_xaccAccountGetHidden (Fixture *fixture, gconstpointer pData)
+{
+    Account *acc = fixture->acct;
+    GValue v = G_VALUE_INIT;
+
+    g_assert (!xaccAccountGetHidden (acc));
+    g_assert (!xaccAccountGetPlaceholder (acc));
+    xaccAccountSetHidden (acc, TRUE);
+    g_assert (xaccAccountGetHidden (acc));
+    g_assert (!xaccAccountGetPlaceholder (acc));
+    xaccAccountSetPlaceholder (acc, TRUE);
+    g_assert (xaccAccountGetHidden (acc));
+    g_assert (xaccAccountGetPlaceholder (acc));
+
+    g_value_init (&v, G_TYPE_STRING);
+    g_value_set_string (&v, "false");
+    xaccAccountBeginEdit (acc);
+    qof_instance_set_kvp (QOF_INSTANCE (acc), &v, 1, "hidden");
+    xaccAccountCommitEdit (acc);
+    g_value_unset (&v);
+    g_assert (!xaccAccountGetHidden (acc));
+    g_assert (xaccAccountGetPlaceholder (acc));
+
+    xaccAccountSetPlaceholder (acc, FALSE);
+    g_assert (!xaccAccountGetPlaceholder (acc));
+}
 /* xaccAccountHasAncestor
 gboolean
 xaccAccountHasAncestor (const Account *acc, const Account * ancestor)// C: 5 in 3 */
@@ -2561,6 +3156,8 @@ test_suite_account (void)
 // GNC_TEST_ADD (suitename, "xaccAccountEqual", Fixture, NULL, setup, test_xaccAccountEqual,  teardown );
     GNC_TEST_ADD (suitename, "gnc account insert & remove split", Fixture, NULL, setup, test_gnc_account_insert_remove_split,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccount Insert and Remove Lot", Fixture, &good_data, setup, test_xaccAccountInsertRemoveLot,  teardown );
+    GNC_TEST_ADD_FUNC (suitename, "xaccAccountMoveAllSplits", test_xaccAccountMoveAllSplits);
+    GNC_TEST_ADD_FUNC (suitename, "xaccAccountGetUnreconciledSplits", test_xaccAccountGetUnreconciledSplits);
     GNC_TEST_ADD (suitename, "xaccAccountRecomputeBalance", Fixture, &some_data, setup, test_xaccAccountRecomputeBalance,  teardown );
     GNC_TEST_ADD_FUNC (suitename, "xaccAccountOrder", test_xaccAccountOrder );
     GNC_TEST_ADD (suitename, "qofAccountSetParent", Fixture, &some_data, setup, test_qofAccountSetParent,  teardown );
@@ -2570,20 +3167,29 @@ test_suite_account (void)
     GNC_TEST_ADD (suitename, "gnc account get tree depth", Fixture, &complex, setup, test_gnc_account_get_tree_depth,  teardown );
     GNC_TEST_ADD (suitename, "gnc account get descendants", Fixture, &complex, setup, test_gnc_account_get_descendants,  teardown );
     GNC_TEST_ADD (suitename, "gnc account get descendants sorted", Fixture, &complex, setup, test_gnc_account_get_descendants_sorted,  teardown );
+    GNC_TEST_ADD (suitename, "gnc account get descendants array", Fixture, &complex, setup, test_gnc_account_get_descendants_array,  teardown );
     GNC_TEST_ADD (suitename, "gnc account lookup by name", Fixture, &complex, setup, test_gnc_account_lookup_by_name,  teardown );
     GNC_TEST_ADD (suitename, "gnc account lookup by code", Fixture, &complex, setup, test_gnc_account_lookup_by_code,  teardown );
     GNC_TEST_ADD (suitename, "gnc account lookup by full name helper", Fixture, &complex, setup, test_gnc_account_lookup_by_full_name_helper,  teardown );
     GNC_TEST_ADD (suitename, "gnc account lookup by full name", Fixture, &complex, setup, test_gnc_account_lookup_by_full_name,  teardown );
+    GNC_TEST_ADD (suitename, "gnc account lookup index", Fixture, &complex, setup, test_gnc_account_lookup_index,  teardown );
     GNC_TEST_ADD (suitename, "gnc account foreach child", Fixture, &complex, setup, test_gnc_account_foreach_child,  teardown );
     GNC_TEST_ADD (suitename, "gnc account foreach descendant", Fixture, &complex, setup, test_gnc_account_foreach_descendant,  teardown );
     GNC_TEST_ADD (suitename, "gnc account foreach descendant until", Fixture, &complex, setup, test_gnc_account_foreach_descendant_until,  teardown );
     GNC_TEST_ADD (suitename, "gnc account get full name", Fixture, &good_data, setup, test_gnc_account_get_full_name,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetProjectedMinimumBalance", Fixture, &some_data, setup, test_xaccAccountGetProjectedMinimumBalance,  teardown );
+    GNC_TEST_ADD (suitename, "gnc account get projected minimum balances", Fixture, &some_data, setup, test_gnc_account_get_projected_minimum_balances,  teardown );
+    GNC_TEST_ADD (suitename, "xaccAccountForEachSplitInRange", Fixture, &some_data, setup, test_xaccAccountForEachSplitInRange,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetBalanceAsOfDate", Fixture, &some_data, setup, test_xaccAccountGetBalanceAsOfDate,  teardown );
+    GNC_TEST_ADD_FUNC (suitename, "xaccAccountGetBalanceAsOfDate checkpoints", test_xaccAccountGetBalanceAsOfDate_checkpoints);
+    GNC_TEST_ADD_FUNC (suitename, "gnc account bulk insert", test_gnc_account_bulk_insert);
     GNC_TEST_ADD (suitename, "xaccAccountGetPresentBalance", Fixture, &some_data, setup, test_xaccAccountGetPresentBalance,  teardown );
+    GNC_TEST_ADD_FUNC (suitename, "xaccAccountGetBalanceInCurrency rollup", test_xaccAccountGetBalanceInCurrency_rollup);
+    GNC_TEST_ADD_FUNC (suitename, "gnc account tree bring up to date", test_gnc_account_tree_bring_up_to_date);
     GNC_TEST_ADD (suitename, "xaccAccountFindOpenLots", Fixture, &complex_data, setup, test_xaccAccountFindOpenLots,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountForEachLot", Fixture, &complex_data, setup, test_xaccAccountForEachLot,  teardown );
 
+    GNC_TEST_ADD (suitename, "xaccAccountGetHidden", Fixture, NULL, setup, test_xaccAccountGetHidden,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountHasAncestor", Fixture, &complex, setup, test_xaccAccountHasAncestor,  teardown );
     GNC_TEST_ADD_FUNC (suitename, "AccountType Stuff", test_xaccAccountType_Stuff );
     GNC_TEST_ADD_FUNC (suitename, "AccountType Compatibility", test_xaccAccountType_Compatibility);
@@ -26,6 +26,10 @@
 #include <gnc-event.h>
 /* Add specific headers for this class */
 #include "gnc-budget.h"
+#include "Account.h"
+#include "Split.h"
+#include "Transaction.h"
+#include "cashobjects.h"
 
 static const gchar *suitename = "/engine/Budget";
 void test_suite_budget(void);
@@ -156,6 +160,154 @@ test_gnc_set_budget_account_period_value()
     qof_book_destroy(book);
 }
 
+static void
+test_gnc_budget_account_period_values()
+{
+    QofBook *book = qof_book_new();
+    GncBudget* budget = gnc_budget_new(book);
+    Account *acc;
+    gnc_numeric values[12], read[12];
+    guint i;
+
+    acc = gnc_account_create_root(book);
+
+    for (i = 0; i < 12; ++i)
+        values[i] = gnc_numeric_create(i * 10, 1);
+    values[3] = gnc_numeric_error(GNC_ERROR_ARG);
+    gnc_budget_set_account_period_values(budget, acc, values, 12);
+
+    for (i = 0; i < 12; ++i)
+    {
+        if (i == 3)
+        {
+            g_assert(!gnc_budget_is_account_period_value_set(budget, acc, i));
+            g_assert(gnc_numeric_zero_p(gnc_budget_get_account_period_value(budget, acc, i)));
+            continue;
+        }
+        g_assert(gnc_budget_is_account_period_value_set(budget, acc, i));
+        g_assert(gnc_numeric_equal(gnc_budget_get_account_period_value(budget, acc, i),
+                                   values[i]));
+    }
+
+    gnc_budget_set_account_period_value(budget, acc, 3, gnc_numeric_create(7, 1));
+    gnc_budget_unset_account_period_value(budget, acc, 5);
+    g_assert_cmpint(gnc_budget_get_account_period_values(budget, acc, read, 12), ==, 12);
+    g_assert(gnc_numeric_equal(read[3], gnc_numeric_create(7, 1)));
+    g_assert(gnc_numeric_zero_p(read[5]));
+    g_assert(!gnc_budget_is_account_period_value_set(budget, acc, 5));
+    g_assert(gnc_numeric_equal(read[11], gnc_numeric_create(110, 1)));
+
+    /* Shrinking and regrowing the budget keeps the stored values. */
+    gnc_budget_set_num_periods(budget, 6);
+    g_assert_cmpint(gnc_budget_get_account_period_values(budget, acc, read, 12), ==, 6);
+    gnc_budget_set_num_periods(budget, 12);
+    g_assert(gnc_budget_is_account_period_value_set(budget, acc, 11));
+    g_assert(gnc_numeric_equal(gnc_budget_get_account_period_value(budget, acc, 11),
+                               gnc_numeric_create(110, 1)));
+
+    gnc_budget_destroy(budget);
+    qof_book_destroy(book);
+}
+
+static void
+add_budget_txn (QofBook *book, gnc_commodity *usd, Account *from, Account *to,
+                time64 date, gint64 amount)
+{
+    Transaction *txn = xaccMallocTransaction (book);
+    Split *s1 = xaccMallocSplit (book);
+    Split *s2 = xaccMallocSplit (book);
+    gnc_numeric value = gnc_numeric_create (amount, 1);
+
+    xaccTransBeginEdit (txn);
+    xaccTransSetCurrency (txn, usd);
+    xaccTransSetDatePostedSecsNormalized (txn, date);
+    xaccSplitSetParent (s1, txn);
+    xaccSplitSetParent (s2, txn);
+    xaccSplitSetAccount (s1, to);
+    xaccSplitSetAccount (s2, from);
+    xaccSplitSetAmount (s1, value);
+    xaccSplitSetValue (s1, value);
+    xaccSplitSetAmount (s2, gnc_numeric_neg (value));
+    xaccSplitSetValue (s2, gnc_numeric_neg (value));
+    xaccTransCommitEdit (txn);
+}
+
+static Account *
+make_budget_account (QofBook *book, Account *parent, gnc_commodity *usd,
+                     const char *name, GNCAccountType type)
+{
+    Account *acc = xaccMallocAccount (book);
+    xaccAccountBeginEdit (acc);
+    xaccAccountSetName (acc, name);
+    xaccAccountSetType (acc, type);
+    xaccAccountSetCommodity (acc, usd);
+    gnc_account_append_child (parent, acc);
+    xaccAccountCommitEdit (acc);
+    return acc;
+}
+
+static void
+test_gnc_budget_account_period_actual_values()
+{
+    QofBook *book;
+    GncBudget *budget;
+    gnc_commodity *usd;
+    Account *root, *bank, *food, *groceries;
+    Recurrence r;
+    GDate date;
+    gnc_numeric read[4];
+    guint i;
+
+    cashobjects_register ();
+    book = qof_book_new ();
+    usd = gnc_commodity_table_insert (
+        gnc_commodity_table_get_table (book),
+        gnc_commodity_new (book, "US Dollar", "CURRENCY", "USD", "840", 100));
+    root = gnc_account_create_root (book);
+    bank = make_budget_account (book, root, usd, "Bank", ACCT_TYPE_BANK);
+    food = make_budget_account (book, root, usd, "Food", ACCT_TYPE_EXPENSE);
+    groceries = make_budget_account (book, food, usd, "Groceries", ACCT_TYPE_EXPENSE);
+
+    budget = gnc_budget_new (book);
+    g_date_set_dmy (&date, 1, 1, 2020);
+    recurrenceSet (&r, 1, PERIOD_MONTH, &date, WEEKEND_ADJ_NONE);
+    gnc_budget_set_recurrence (budget, &r);
+    gnc_budget_set_num_periods (budget, 4);
+
+    add_budget_txn (book, usd, bank, food, gnc_dmy2time64_neutral (5, 1, 2020), 10);
+    add_budget_txn (book, usd, bank, groceries, gnc_dmy2time64_neutral (20, 1, 2020), 30);
+    add_budget_txn (book, usd, bank, groceries, gnc_dmy2time64_neutral (3, 3, 2020), 5);
+
+    g_assert_cmpint (gnc_budget_get_account_period_actual_values (budget, food, read, 6), ==, 4);
+    g_assert_cmpint (gnc_numeric_compare (read[0], gnc_numeric_create (40, 1)), ==, 0);
+    g_assert (gnc_numeric_zero_p (read[1]));
+    g_assert_cmpint (gnc_numeric_compare (read[2], gnc_numeric_create (5, 1)), ==, 0);
+    for (i = 0; i < 4; ++i)
+    {
+        gnc_numeric expected = xaccAccountGetNoclosingBalanceChangeForPeriod
+            (food, gnc_budget_get_period_start_date (budget, i),
+             gnc_budget_get_period_end_date (budget, i), TRUE);
+        g_assert (gnc_numeric_equal (read[i], expected));
+        g_assert (gnc_numeric_equal (gnc_budget_get_account_period_actual_value
+                                     (budget, food, i), expected));
+    }
+
+    /* A new split below the account is seen on the next call. */
+    add_budget_txn (book, usd, bank, groceries, gnc_dmy2time64_neutral (10, 2, 2020), 7);
+    g_assert_cmpint (gnc_numeric_compare (gnc_budget_get_account_period_actual_value
+                                          (budget, food, 1),
+                                          gnc_numeric_create (7, 1)), ==, 0);
+    g_assert_cmpint (gnc_numeric_compare (gnc_budget_get_account_period_actual_value
+                                          (budget, groceries, 1),
+                                          gnc_numeric_create (7, 1)), ==, 0);
+    g_assert_cmpint (gnc_numeric_compare (gnc_budget_get_account_period_actual_value
+                                          (budget, bank, 1),
+                                          gnc_numeric_create (-7, 1)), ==, 0);
+
+    gnc_budget_destroy (budget);
+    qof_book_destroy (book);
+}
+
 void
 test_suite_budget(void)
 {
@@ -165,5 +317,7 @@ test_suite_budget(void)
     GNC_TEST_ADD_FUNC(suitename, "gnc_budget_set_num_periods()", test_gnc_set_budget_num_periods);
     GNC_TEST_ADD_FUNC(suitename, "gnc_budget_set_recurrence()", test_gnc_set_budget_recurrence);
     GNC_TEST_ADD_FUNC(suitename, "gnc_budget_set_account_period_value()", test_gnc_set_budget_account_period_value);
+    GNC_TEST_ADD_FUNC(suitename, "gnc_budget_set_account_period_values()", test_gnc_budget_account_period_values);
+    GNC_TEST_ADD_FUNC(suitename, "gnc_budget_get_account_period_actual_values()", test_gnc_budget_account_period_actual_values);
 
 }
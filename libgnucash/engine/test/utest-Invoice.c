@@ -25,6 +25,8 @@
 #include <qof.h>
 #include <unittest-support.h>
 #include "../gncInvoice.h"
+#include "../gncOwner.h"
+#include "../gncIDSearch.h"
 
 static const gchar *suitename = "/engine/gncInvoice";
 void test_suite_gncInvoice ( void );
@@ -208,11 +210,117 @@ test_invoice_posted_trans ( Fixture *fixture, gconstpointer pData )
     }
 }
 
+static void
+test_invoice_empty_totals ( Fixture *fixture, gconstpointer pData )
+{
+    /* Nothing has been computed yet, so nothing cached may be returned */
+    gnc_numeric total = gncInvoiceGetTotal(fixture->invoice);
+
+    g_assert_cmpint(gnc_numeric_check(total), ==, GNC_ERROR_OK);
+    g_assert(gnc_numeric_zero_p(total));
+    g_assert(gnc_numeric_zero_p(gncInvoiceGetTotalSubtotal(fixture->invoice)));
+    g_assert(gnc_numeric_zero_p(gncInvoiceGetTotalTax(fixture->invoice)));
+}
+
+static void
+test_invoice_totals_follow_entries ( Fixture *fixture, gconstpointer pData )
+{
+    const InvoiceData *data = (InvoiceData*) pData;
+    GncEntry *entry = gncInvoiceGetEntries(fixture->invoice)->data;
+    gnc_numeric value;
+
+    g_assert(gnc_numeric_zero_p(gncInvoiceGetTotal(fixture->invoice)));
+
+    /* The totals cached above have to follow changes to the entry */
+    if (data->is_cust_doc)
+        gncEntrySetInvPrice(entry, data->price);
+    else
+        gncEntrySetBillPrice(entry, data->price);
+    value = gncEntryGetDocValue(entry, TRUE, data->is_cust_doc, data->is_cn);
+    g_assert(!gnc_numeric_zero_p(value));
+    g_assert(gnc_numeric_equal(gncInvoiceGetTotal(fixture->invoice), value));
+    g_assert(gnc_numeric_equal(gncInvoiceGetTotalOf(fixture->invoice, GNC_PAYMENT_CASH), value));
+    g_assert(gnc_numeric_zero_p(gncInvoiceGetTotalOf(fixture->invoice, GNC_PAYMENT_CARD)));
+
+    gncEntrySetBillPayment(entry, GNC_PAYMENT_CARD);
+    g_assert(gnc_numeric_zero_p(gncInvoiceGetTotalOf(fixture->invoice, GNC_PAYMENT_CASH)));
+    g_assert(gnc_numeric_equal(gncInvoiceGetTotalOf(fixture->invoice, GNC_PAYMENT_CARD), value));
+
+    /* and to the document turning into a credit note */
+    gncInvoiceSetIsCreditNote(fixture->invoice, !data->is_cn);
+    g_assert(gnc_numeric_equal(gncInvoiceGetTotal(fixture->invoice),
+                               gncEntryGetDocValue(entry, TRUE, data->is_cust_doc, !data->is_cn)));
+    gncInvoiceSetIsCreditNote(fixture->invoice, data->is_cn);
+}
+
+static void
+test_invoice_owner_lots ( Fixture *fixture, gconstpointer pData )
+{
+    GNCLot *posted_lot = gncInvoiceGetPostedLot(fixture->invoice);
+    GNCLot *pay_lot;
+    GList *lots;
+
+    lots = gncOwnerGetLots(&fixture->owner, NULL, TRUE);
+    g_assert_cmpint(g_list_length(lots), ==, 1);
+    g_assert(lots->data == posted_lot);
+    g_list_free(lots);
+
+    g_assert(gncOwnerGetLots(&fixture->owner, fixture->account, FALSE) == NULL);
+
+    /* A lot given to the owner after the lookup is found too */
+    pay_lot = gnc_lot_new(fixture->book);
+    xaccAccountBeginEdit(fixture->account2);
+    xaccAccountInsertLot(fixture->account2, pay_lot);
+    xaccAccountCommitEdit(fixture->account2);
+    gncOwnerAttachToLot(&fixture->owner, pay_lot);
+
+    lots = gncOwnerGetLots(&fixture->owner, fixture->account2, FALSE);
+    g_assert_cmpint(g_list_length(lots), ==, 2);
+    g_assert(g_list_find(lots, posted_lot));
+    g_assert(g_list_find(lots, pay_lot));
+    g_list_free(lots);
+
+    /* and is forgotten once it is destroyed */
+    gnc_lot_destroy(pay_lot);
+    lots = gncOwnerGetLots(&fixture->owner, fixture->account2, FALSE);
+    g_assert_cmpint(g_list_length(lots), ==, 1);
+    g_assert(lots->data == posted_lot);
+    g_list_free(lots);
+}
+
+static void
+test_invoice_search_on_id ( Fixture *fixture, gconstpointer pData )
+{
+    QofBook *book = fixture->book;
+
+    g_assert(gnc_search_invoice_on_id(book, "INV-1") == NULL);
+
+    /* Looking up builds the index, later IDs are picked up from events */
+    gncInvoiceSetID(fixture->invoice, "INV-1");
+    g_assert(gnc_search_invoice_on_id(book, "INV-1") == fixture->invoice);
+    g_assert(gnc_search_bill_on_id(book, "INV-1") == NULL);
+
+    gncInvoiceSetID(fixture->invoice, "INV-2");
+    g_assert(gnc_search_invoice_on_id(book, "INV-1") == NULL);
+    g_assert(gnc_search_invoice_on_id(book, "INV-2") == fixture->invoice);
+
+    gncCustomerSetID(fixture->customer, "CUST-1");
+    g_assert(gnc_search_customer_on_id(book, "CUST-1") == fixture->customer);
+    g_assert(gnc_search_vendor_on_id(book, "CUST-1") == NULL);
+
+    /* An ID change missed while events were suspended */
+    qof_event_suspend();
+    gncCustomerSetID(fixture->customer, "CUST-2");
+    qof_event_resume();
+    g_assert(gnc_search_customer_on_id(book, "CUST-2") == fixture->customer);
+}
+
 void
 test_suite_gncInvoice ( void )
 {
     static InvoiceData pData = { FALSE, FALSE, { 1000, 100 }, { 2000, 100 } };  // Vendor bill
     GNC_TEST_ADD( suitename, "post/unpost", Fixture, &pData, setup, test_invoice_post, teardown );
+    GNC_TEST_ADD( suitename, "empty invoice totals", Fixture, &pData, setup, test_invoice_empty_totals, teardown );
 
     GNC_TEST_ADD( suitename, "post trans - vendor bill", Fixture, &pData, setup_with_invoice, test_invoice_posted_trans, teardown_with_invoice );
     pData.is_cn = TRUE;   // Vendor credit note
@@ -221,4 +329,7 @@ test_suite_gncInvoice ( void )
     GNC_TEST_ADD( suitename, "post trans - customer creditnote", Fixture, &pData, setup_with_invoice, test_invoice_posted_trans, teardown_with_invoice );
     pData.is_cn = FALSE;   // Customer invoice
     GNC_TEST_ADD( suitename, "post trans - customer invoice", Fixture, &pData, setup_with_invoice, test_invoice_posted_trans, teardown_with_invoice );
+    GNC_TEST_ADD( suitename, "totals follow entries", Fixture, &pData, setup_with_invoice, test_invoice_totals_follow_entries, teardown_with_invoice );
+    GNC_TEST_ADD( suitename, "owner lots", Fixture, &pData, setup_with_invoice, test_invoice_owner_lots, teardown_with_invoice );
+    GNC_TEST_ADD( suitename, "search on id", Fixture, &pData, setup_with_invoice, test_invoice_search_on_id, teardown_with_invoice );
 }
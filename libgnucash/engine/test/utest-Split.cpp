@@ -35,6 +35,7 @@ extern "C"
 #include <Transaction.h>
 #include <TransactionP.h>
 #include <gnc-lot.h>
+#include <cap-gains.h>
 #include <gnc-event.h>
 
 #if defined(__clang__) && (__clang_major__ == 5 || (__clang_major__ == 3 && __clang_minor__ < 5))
@@ -141,8 +142,11 @@ test_gnc_split_init ()
     g_assert (gnc_numeric_zero_p (split->reconciled_balance));
     g_assert_cmpint (split->gains, ==, GAINS_STATUS_UNKNOWN);
     g_assert (split->gains_split == NULL);
-    /* Make sure that the parent's init has been run */
-    g_assert (split->inst.kvp_data != NULL);
+    /* The parent's init leaves the slots frame to be allocated on demand */
+    g_assert (split->inst.kvp_data == NULL);
+    g_assert (!qof_instance_has_kvp (QOF_INSTANCE (split)));
+    g_assert (!qof_instance_has_slot (QOF_INSTANCE (split), "gains-source"));
+    g_assert (split->inst.kvp_data == NULL);
 
     g_object_unref (split);
 }
@@ -302,7 +306,7 @@ test_xaccDupeSplit (Fixture *fixture, gconstpointer pData)
     g_assert (split->lot == f_split->lot);
     g_assert_cmpstr (split->memo, ==, f_split->memo);
     g_assert_cmpstr (split->action, ==, f_split->action);
-    g_assert (compare (split->inst.kvp_data, f_split->inst.kvp_data) == 0);
+    g_assert (qof_instance_compare_kvp (QOF_INSTANCE (split), QOF_INSTANCE (f_split)) == 0);
     g_assert_cmpint (split->reconciled, ==, f_split->reconciled);
     g_assert_cmpint (split->date_reconciled, ==, f_split->date_reconciled);
     g_assert (gnc_numeric_equal (split->value, f_split->value));
@@ -337,7 +341,7 @@ test_xaccSplitCloneNoKvp (Fixture *fixture, gconstpointer pData)
     g_assert (split->lot == f_split->lot);
     g_assert_cmpstr (split->memo, ==, f_split->memo);
     g_assert_cmpstr (split->action, ==, f_split->action);
-    g_assert (split->inst.kvp_data->empty());
+    g_assert (!qof_instance_has_kvp (QOF_INSTANCE (split)));
     g_assert_cmpint (split->reconciled, ==, f_split->reconciled);
     g_assert_cmpint (split->date_reconciled, == , f_split->date_reconciled);
     g_assert (gnc_numeric_equal (split->value, f_split->value));
@@ -360,13 +364,16 @@ Not testable and wrong besides.
 */
 /* mark_split
 void mark_split (Split *s)// C: 2 in 2 SCM: 10 in 1 Local: 8:0:0
-OK, weird. Doesn't mark the split, marks the account sort-dirty and balance-dirty parameters.
+OK, weird. Doesn't mark the split, marks the account balance-dirty
+parameter, and sort-dirty if the split is now out of order. Splits not
+yet committed to their account are left alone.
 */
 static void
 test_mark_split (Fixture *fixture, gconstpointer pData)
 {
     gboolean sort_dirty, balance_dirty;
-    g_object_get (fixture->split->acc,
+    Account *acc = fixture->split->acc;
+    g_object_get (acc,
                   "sort-dirty", &sort_dirty,
                   "balance-dirty", &balance_dirty,
                   NULL);
@@ -375,13 +382,84 @@ test_mark_split (Fixture *fixture, gconstpointer pData)
 
     mark_split (fixture->split);
 
-    g_object_get (fixture->split->acc,
+    g_object_get (acc,
+                  "sort-dirty", &sort_dirty,
+                  "balance-dirty", &balance_dirty,
+                  NULL);
+    g_assert_cmpint (sort_dirty, ==, FALSE);
+    g_assert_cmpint (balance_dirty, ==, FALSE);
+
+    gnc_account_insert_split (acc, fixture->split);
+    fixture->split->orig_acc = acc;
+    xaccAccountRecomputeBalance (acc);
+
+    mark_split (fixture->split);
+
+    g_object_get (acc,
                   "sort-dirty", &sort_dirty,
                   "balance-dirty", &balance_dirty,
                   NULL);
-    g_assert_cmpint (sort_dirty, ==, TRUE);
+    g_assert_cmpint (sort_dirty, ==, FALSE);
     g_assert_cmpint (balance_dirty, ==, TRUE);
 }
+/* The lot keeps its balance and closed state up to date as splits come
+ * and go, and drops them when a split's amount is edited.
+ */
+static void
+test_gnc_lot_balance_cache (void)
+{
+    auto book = qof_book_new ();
+    auto curr = gnc_commodity_new (book, "Gnu Rand", "CURRENCY", "GNR", "", 240);
+    auto acc = xaccMallocAccount (book);
+    auto lot = gnc_lot_new (book);
+    Split *splits[2];
+    gnc_numeric amounts[2] = { gnc_numeric_create (5, 1),
+                               gnc_numeric_create (-5, 1) };
+    auto sell = gnc_numeric_create (-1, 1);
+
+    xaccAccountSetCommodity (acc, curr);
+    for (int i = 0; i < 2; ++i)
+    {
+        auto txn = xaccMallocTransaction (book);
+        splits[i] = xaccMallocSplit (book);
+        xaccTransBeginEdit (txn);
+        xaccTransSetCurrency (txn, curr);
+        xaccSplitSetParent (splits[i], txn);
+        xaccSplitSetAccount (splits[i], acc);
+        xaccSplitSetAmount (splits[i], amounts[i]);
+        xaccSplitSetValue (splits[i], amounts[i]);
+        xaccTransCommitEdit (txn);
+    }
+
+    g_assert (gnc_numeric_zero_p (gnc_lot_get_balance (lot)));
+    g_assert (!gnc_lot_is_closed (lot));
+    gnc_lot_add_split (lot, splits[0]);
+    g_assert (gnc_numeric_equal (gnc_lot_get_balance (lot), amounts[0]));
+    g_assert (!gnc_lot_is_closed (lot));
+    gnc_lot_add_split (lot, splits[1]);
+    g_assert (gnc_numeric_zero_p (gnc_lot_get_balance (lot)));
+    g_assert (gnc_lot_is_closed (lot));
+    g_assert (xaccAccountFindEarliestOpenLot (acc, sell, nullptr) == nullptr);
+
+    auto txn = xaccSplitGetParent (splits[1]);
+    xaccTransBeginEdit (txn);
+    xaccSplitSetAmount (splits[1], gnc_numeric_create (-3, 1));
+    xaccSplitSetValue (splits[1], gnc_numeric_create (-3, 1));
+    g_assert (!gnc_lot_is_closed (lot));
+    g_assert_cmpint (gnc_lot_get_balance (lot).num, ==, 2);
+    xaccTransRollbackEdit (txn);
+    g_assert (gnc_lot_is_closed (lot));
+
+    gnc_lot_remove_split (lot, splits[1]);
+    g_assert (gnc_numeric_equal (gnc_lot_get_balance (lot), amounts[0]));
+    g_assert (!gnc_lot_is_closed (lot));
+    /* The closed lot was dropped from the account's open lots; reopening
+     * it brings it back. */
+    g_assert (xaccAccountFindEarliestOpenLot (acc, sell, nullptr) == lot);
+
+    qof_book_destroy (book);
+}
+
 // Not Used
 /* xaccSplitEqualCheckBal
 static gboolean
@@ -589,11 +667,12 @@ test_xaccSplitCommitEdit (Fixture *fixture, gconstpointer pData)
 
     xaccSplitCommitEdit (fixture->split);
 
+    /* The split was inserted in order, so the account needn't resort. */
     g_object_get (fixture->split->acc,
                   "sort-dirty", &sort_dirty,
                   "balance-dirty", &balance_dirty,
                   NULL);
-    g_assert_cmpint (sort_dirty, ==, TRUE);
+    g_assert_cmpint (sort_dirty, ==, FALSE);
     g_assert_cmpint (balance_dirty, ==, FALSE);
     g_assert (qof_instance_is_dirty (QOF_INSTANCE (fixture->split->parent)));
     g_assert (qof_instance_is_dirty (QOF_INSTANCE (fixture->split)));
@@ -616,11 +695,12 @@ test_xaccSplitCommitEdit (Fixture *fixture, gconstpointer pData)
 
     qof_instance_set_dirty (QOF_INSTANCE (fixture->split));
     xaccSplitCommitEdit (fixture->split);
+    /* The only split in the account can't be out of order. */
     g_object_get (fixture->split->acc,
                   "sort-dirty", &sort_dirty,
                   "balance-dirty", &balance_dirty,
                   NULL);
-    g_assert_cmpint (sort_dirty, ==, TRUE);
+    g_assert_cmpint (sort_dirty, ==, FALSE);
     g_assert_cmpint (balance_dirty, ==, FALSE);
     g_assert (!qof_instance_is_dirty (QOF_INSTANCE (fixture->split->parent)));
     g_assert (qof_instance_is_dirty (QOF_INSTANCE (fixture->split)));
@@ -737,12 +817,12 @@ test_xaccSplitDetermineGainStatus (Fixture *fixture, gconstpointer pData)
 
     fixture->split->gains = GAINS_STATUS_UNKNOWN;
     fixture->split->gains_split = NULL;
-    g_assert (fixture->split->inst.kvp_data->get_slot({"gains_source"}) == NULL);
+    g_assert (qof_instance_get_slots (QOF_INSTANCE (fixture->split))->get_slot({"gains_source"}) == NULL);
     xaccSplitDetermineGainStatus (fixture->split);
     g_assert (fixture->split->gains_split == NULL);
     g_assert_cmpint (fixture->split->gains, ==, GAINS_STATUS_A_VDIRTY | GAINS_STATUS_DATE_DIRTY);
 
-    fixture->split->inst.kvp_data->set({"gains-source"}, new KvpValue(guid_copy(g_guid)));
+    qof_instance_get_slots (QOF_INSTANCE (fixture->split))->set({"gains-source"}, new KvpValue(guid_copy(g_guid)));
     g_assert (fixture->split->gains_split == NULL);
     fixture->split->gains = GAINS_STATUS_UNKNOWN;
     xaccSplitDetermineGainStatus (fixture->split);
@@ -1799,7 +1879,7 @@ test_xaccSplitGetOtherSplit (Fixture *fixture, gconstpointer pData)
     g_assert (xaccSplitGetOtherSplit (split1) == NULL);
 
     g_assert (xaccTransUseTradingAccounts (txn) == FALSE);
-    g_assert (split->inst.kvp_data->get_slot({"lot-split"}) == NULL);
+    g_assert (qof_instance_get_slots (QOF_INSTANCE (split))->get_slot({"lot-split"}) == NULL);
     g_assert_cmpint (xaccTransCountSplits (txn), !=, 2);
     g_assert (xaccSplitGetOtherSplit (split) == NULL);
 
@@ -1810,18 +1890,18 @@ test_xaccSplitGetOtherSplit (Fixture *fixture, gconstpointer pData)
     xaccSplitSetParent (split2, txn);
     g_assert (xaccSplitGetOtherSplit (split) == NULL);
 
-    split->inst.kvp_data->set({"lot-split"}, kvpnow);
-    g_assert (split->inst.kvp_data->get_slot({"lot-split"}));
+    qof_instance_get_slots (QOF_INSTANCE (split))->set({"lot-split"}, kvpnow);
+    g_assert (qof_instance_get_slots (QOF_INSTANCE (split))->get_slot({"lot-split"}));
     g_assert (xaccSplitGetOtherSplit (split) == NULL);
 
-    split1->inst.kvp_data->set({"lot-split"}, kvpnow);
-    g_assert (split1->inst.kvp_data->get_slot({"lot-split"}));
+    qof_instance_get_slots (QOF_INSTANCE (split1))->set({"lot-split"}, kvpnow);
+    g_assert (qof_instance_get_slots (QOF_INSTANCE (split1))->get_slot({"lot-split"}));
     g_assert (xaccSplitGetOtherSplit (split) == split2);
 
-    split->inst.kvp_data->set({"lot-split"}, NULL);
-    g_assert (split->inst.kvp_data->get_slot({"lot-split"}) == NULL);
-    split1->inst.kvp_data->set({"lot-split"}, NULL);
-    g_assert (split1->inst.kvp_data->get_slot({"lot-split"}) == NULL);
+    qof_instance_get_slots (QOF_INSTANCE (split))->set({"lot-split"}, NULL);
+    g_assert (qof_instance_get_slots (QOF_INSTANCE (split))->get_slot({"lot-split"}) == NULL);
+    qof_instance_get_slots (QOF_INSTANCE (split1))->set({"lot-split"}, NULL);
+    g_assert (qof_instance_get_slots (QOF_INSTANCE (split1))->get_slot({"lot-split"}) == NULL);
     qof_book_begin_edit (book);
     qof_instance_set (QOF_INSTANCE (book),
 		      "trading-accts", "t",
@@ -1907,6 +1987,7 @@ test_suite_split (void)
     GNC_TEST_ADD (suitename, "xaccDupeSplit", Fixture, NULL, setup, test_xaccDupeSplit, teardown);
     GNC_TEST_ADD (suitename, "xaccSplitCloneNoKvp", Fixture, NULL, setup, test_xaccSplitCloneNoKvp, teardown);
     GNC_TEST_ADD (suitename, "mark split", Fixture, NULL, setup, test_mark_split, teardown);
+    GNC_TEST_ADD_FUNC (suitename, "gnc lot balance cache", test_gnc_lot_balance_cache);
     GNC_TEST_ADD (suitename, "xaccSplitEqualCheckBal", Fixture, NULL, setup, test_xaccSplitEqualCheckBal, teardown);
     GNC_TEST_ADD (suitename, "xaccSplitEqual", Fixture, NULL, setup, test_xaccSplitEqual, teardown);
     GNC_TEST_ADD (suitename, "xaccSplitCommitEdit", Fixture, NULL, setup, test_xaccSplitCommitEdit, teardown);
@@ -106,12 +106,23 @@ public:
         set_error(m_result_err);
         m_last_call = "rollback";
     }
+    void begin_batch() override {
+        m_last_call = "begin_batch";
+        ++m_batch_depth;
+    }
+    /* Only the outermost batch writes, so only it can fail. */
+    bool commit_batch() override {
+        m_last_call = "commit_batch";
+        return --m_batch_depth > 0 || m_batch_ok;
+    }
     void inject_error(QofBackendError err) {
         m_result_err = err;
     }
     std::string m_last_call;
+    bool m_batch_ok = true;
 private:
     QofBackendError m_result_err;
+    int m_batch_depth = 0;
 };
 
 static void
@@ -274,7 +285,7 @@ test_xaccTransStillHasSplit (Fixture *fixture, gconstpointer pData)
 /* mark_trans
 void mark_trans (Transaction *trans)// Local: 3:0:0
 */
-#define check_split_dirty(xsplit, test)                \
+#define check_split_dirty(xsplit, sort_test, balance_test) \
 {                                                      \
     gboolean sort_dirty, balance_dirty;                \
     auto split = xsplit;                             \
@@ -282,8 +293,8 @@ void mark_trans (Transaction *trans)// Local: 3:0:0
 		  "sort-dirty", &sort_dirty,           \
 		  "balance-dirty", &balance_dirty,     \
 		  NULL);                               \
-    g_assert_cmpint (sort_dirty, ==, test);            \
-    g_assert_cmpint (balance_dirty, ==, test);         \
+    g_assert_cmpint (sort_dirty, ==, sort_test);       \
+    g_assert_cmpint (balance_dirty, ==, balance_test); \
 }
 
 static void
@@ -296,7 +307,7 @@ test_mark_trans (Fixture *fixture, gconstpointer pData)
     {
         if (!splits->data) continue;
         g_assert (!qof_instance_get_dirty_flag (splits->data));
-        check_split_dirty (static_cast<Split*>(splits->data), FALSE);
+        check_split_dirty (static_cast<Split*>(splits->data), FALSE, FALSE);
     }
     fixture->func->mark_trans (fixture->txn);
     g_assert (!qof_instance_get_dirty_flag (fixture->txn));
@@ -304,7 +315,8 @@ test_mark_trans (Fixture *fixture, gconstpointer pData)
     {
         if (!splits->data) continue;
         g_assert (!qof_instance_get_dirty_flag (splits->data));
-        check_split_dirty (static_cast<Split*>(splits->data), TRUE);
+        /* Each account holds just the one split, which stays in order. */
+        check_split_dirty (static_cast<Split*>(splits->data), FALSE, TRUE);
     }
 }
 /* gen_event_trans
@@ -557,7 +569,7 @@ test_dupe_trans (Fixture *fixture, gconstpointer pData)
 
     oldtxn->date_posted = posted;
     oldtxn->date_entered = entered;
-    oldtxn->inst.kvp_data->set({"foo", "bar", "baz"},
+    qof_instance_get_slots (QOF_INSTANCE (oldtxn))->set({"foo", "bar", "baz"},
                                new KvpValue(g_strdup ("The Great Waldo Pepper")));
 
     newtxn = fixture->func->dupe_trans (oldtxn);
@@ -986,6 +998,66 @@ test_xaccTransGetImbalanceValue (Fixture *fixture, gconstpointer pData)
                                  split1->value));
     xaccTransCommitEdit (fixture->txn);
 }
+static void
+test_xaccTransGetImbalanceValue_cached (Fixture *fixture, gconstpointer pData)
+{
+    auto split = static_cast<Split*>(fixture->txn->splits->data);
+    auto value = xaccSplitGetValue (split);
+    auto gen = fixture->txn->edit_generation;
+
+    g_assert (xaccTransIsBalanced (fixture->txn));
+    g_assert (gnc_numeric_zero_p (xaccTransGetImbalanceValue (fixture->txn)));
+    g_assert_cmpuint (fixture->txn->imbal_value_gen, ==, gen);
+    g_assert_cmpuint (fixture->txn->balanced_gen, ==, gen);
+    /* Asking again just returns the cached results. */
+    g_assert (gnc_numeric_zero_p (xaccTransGetImbalanceValue (fixture->txn)));
+    g_assert_cmpuint (fixture->txn->edit_generation, ==, gen);
+
+    /* Changing a value through the setter drops them. */
+    xaccTransBeginEdit (fixture->txn);
+    xaccSplitSetValue (split, gnc_numeric_add_fixed (value, value));
+    g_assert_cmpuint (fixture->txn->edit_generation, >, gen);
+    g_assert (gnc_numeric_equal (xaccTransGetImbalanceValue (fixture->txn),
+                                 value));
+    g_assert (!xaccTransIsBalanced (fixture->txn));
+    xaccSplitSetValue (split, value);
+    g_assert (xaccTransIsBalanced (fixture->txn));
+    xaccTransCommitEdit (fixture->txn);
+}
+static void
+test_xaccTransGetSplit_vector (Fixture *fixture, gconstpointer pData)
+{
+    auto txn = fixture->txn;
+    QofBook *book = qof_instance_get_book (QOF_INSTANCE (txn));
+    auto split0 = static_cast<Split*>(txn->splits->data);
+    auto n_orig = xaccTransCountSplits (txn);
+    Split *extra[TRANS_INLINE_SPLITS];
+
+    /* A small transaction's splits are kept inline */
+    g_assert (xaccTransGetSplit (txn, 0) == split0);
+    g_assert (txn->split_vec == txn->split_vec_inline);
+    g_assert_cmpint (xaccTransGetSplitIndex (txn, split0), ==, 0);
+    g_assert (xaccTransGetSplit (txn, n_orig) == NULL);
+
+    xaccTransBeginEdit (txn);
+    for (auto i = 0; i < TRANS_INLINE_SPLITS; ++i)
+    {
+        extra[i] = xaccMallocSplit (book);
+        xaccSplitSetParent (extra[i], txn);
+    }
+    g_assert_cmpint (xaccTransCountSplits (txn), ==, n_orig + TRANS_INLINE_SPLITS);
+    g_assert (txn->split_vec != txn->split_vec_inline);
+    g_assert (xaccTransGetSplit (txn, n_orig) == extra[0]);
+    g_assert_cmpint (xaccTransGetSplitIndex (txn, extra[1]), ==, n_orig + 1);
+
+    /* Destroyed splits drop out of the indexing straight away */
+    for (auto i = 0; i < TRANS_INLINE_SPLITS; ++i)
+        xaccSplitDestroy (extra[i]);
+    g_assert_cmpint (xaccTransCountSplits (txn), ==, n_orig);
+    g_assert (txn->split_vec == txn->split_vec_inline);
+    g_assert_cmpint (xaccTransGetSplitIndex (txn, extra[0]), ==, -1);
+    xaccTransCommitEdit (txn);
+}
 /* xaccTransGetImbalance
 MonetaryList *
 xaccTransGetImbalance (const Transaction * trans)// C: 15 in 6  Local: 1:0:0
@@ -1061,13 +1133,17 @@ test_xaccTransGetImbalance_trading (Fixture *fixture,
     mlist = xaccTransGetImbalance (fixture->txn);
     g_assert_cmpint (g_list_length (mlist), ==, 1);
     gnc_monetary_list_free (mlist);
+    /* Setting the fields directly bypasses the setters, which would
+     * otherwise drop the cached imbalance. */
     split2->amount = gnc_numeric_create (3000, 240);
     split2->value = gnc_numeric_create (3000, 240);
+    xaccTransBumpEditGeneration (fixture->txn);
     mlist = xaccTransGetImbalance (fixture->txn);
     g_assert_cmpint (g_list_length (mlist), ==, 1);
     gnc_monetary_list_free (mlist);
     split2->amount = gnc_numeric_create (3200, 240);
     split2->value = gnc_numeric_create (3200, 240);
+    xaccTransBumpEditGeneration (fixture->txn);
     mlist = xaccTransGetImbalance (fixture->txn);
     g_assert_cmpint (g_list_length (mlist), ==, 0);
     gnc_monetary_list_free (mlist);
@@ -1138,11 +1214,15 @@ test_xaccTransIsBalanced_trading (Fixture *fixture, gconstpointer pData)
     g_assert (!xaccTransIsBalanced (fixture->txn));
     xaccSplitSetParent (split2, fixture->txn);
     g_assert (!xaccTransIsBalanced (fixture->txn));
+    /* Setting the fields directly bypasses the setters, which would
+     * otherwise drop the cached result. */
     split2->amount = gnc_numeric_create (-11000, 100);
     split2->value = gnc_numeric_create (-3200, 240);
+    xaccTransBumpEditGeneration (fixture->txn);
     g_assert (!xaccTransIsBalanced (fixture->txn));
     split2->amount = gnc_numeric_create (-10000, 100);
     split2->value = gnc_numeric_create (-3200, 240);
+    xaccTransBumpEditGeneration (fixture->txn);
     g_assert (xaccTransIsBalanced (fixture->txn));
     xaccTransRollbackEdit (fixture->txn);
 
@@ -1712,6 +1792,117 @@ test_xaccTransRollbackEdit (Fixture *fixture, gconstpointer pData)
     g_object_unref (orig);
 
 }
+/* xaccTransCommitEditBatch
+guint
+xaccTransCommitEditBatch (Transaction **trans, guint n_trans,
+                          GncTransCommitStatus *status)
+*/
+static void
+test_xaccTransCommitEditBatch (Fixture *fixture, gconstpointer pData)
+{
+    auto book = qof_instance_get_book (QOF_INSTANCE (fixture->txn));
+    auto mbe = static_cast<TransMockBackend*>(qof_book_get_backend (book));
+    auto no_curr = xaccMallocTransaction (book);
+    auto not_open = xaccMallocTransaction (book);
+    auto split = xaccMallocSplit (book);
+    Transaction *batch[] = { fixture->txn, no_curr, not_open, NULL };
+    GncTransCommitStatus status[4];
+    auto sig_acc = test_signal_new (QOF_INSTANCE (fixture->acc1),
+                                    QOF_EVENT_MODIFY, NULL);
+    auto sig_txn = test_signal_new (QOF_INSTANCE (fixture->txn),
+                                    QOF_EVENT_MODIFY, NULL);
+
+    xaccTransBeginEdit (fixture->txn);
+    xaccTransSetDescription (fixture->txn, "Batched");
+    xaccTransBeginEdit (no_curr);
+    xaccSplitSetParent (split, no_curr);
+    xaccSplitSetAccount (split, fixture->acc1);
+
+    g_assert_cmpuint (xaccTransCommitEditBatch (batch, 4, status), ==, 3);
+    g_assert_cmpint (status[0], ==, GNC_TRANS_COMMIT_OK);
+    g_assert_cmpint (status[1], ==, GNC_TRANS_COMMIT_NO_CURRENCY);
+    g_assert_cmpint (status[2], ==, GNC_TRANS_COMMIT_NOT_OPEN);
+    g_assert_cmpint (status[3], ==, GNC_TRANS_COMMIT_NOT_OPEN);
+    g_assert_cmpstr (mbe->m_last_call.c_str(), ==, "commit_batch");
+    g_assert (!xaccTransIsOpen (fixture->txn));
+    g_assert_cmpstr (xaccTransGetDescription (fixture->txn), ==, "Batched");
+    /* The failed transaction is left open for the caller. */
+    g_assert (xaccTransIsOpen (no_curr));
+    /* One event for the transaction and one for its account. */
+    test_signal_assert_hits (sig_txn, 1);
+    test_signal_assert_hits (sig_acc, 1);
+
+    xaccTransDestroy (no_curr);
+    xaccTransCommitEdit (no_curr);
+    test_signal_free (sig_acc);
+    test_signal_free (sig_txn);
+}
+/* A batch the backend fails to write saved nothing, so none of it may
+ * be reported as committed. */
+static void
+test_xaccTransCommitEditBatch_backend_fails (Fixture *fixture,
+                                             gconstpointer pData)
+{
+    auto book = qof_instance_get_book (QOF_INSTANCE (fixture->txn));
+    auto mbe = static_cast<TransMockBackend*>(qof_book_get_backend (book));
+    Transaction *batch[] = { fixture->txn };
+    GncTransCommitStatus status[1];
+
+    mbe->m_batch_ok = false;
+    xaccTransBeginEdit (fixture->txn);
+    xaccTransSetDescription (fixture->txn, "Batched");
+    g_assert_cmpuint (xaccTransCommitEditBatch (batch, 1, status), ==, 1);
+    g_assert_cmpint (status[0], ==, GNC_TRANS_COMMIT_BACKEND_ERROR);
+    g_assert (!xaccTransIsOpen (fixture->txn));
+    g_assert (qof_instance_is_dirty (QOF_INSTANCE (fixture->txn)));
+    mbe->m_batch_ok = true;
+}
+/* free_trans_copy and xaccSplitFreeCopy keep the rollback copies for
+ * the next edit. */
+static void
+test_xaccTransBeginEdit_reuses_copy (Fixture *fixture, gconstpointer pData)
+{
+    auto txn = fixture->txn;
+
+    xaccTransBeginEdit (txn);
+    auto orig = txn->orig;
+    auto orig_split = static_cast<Split*>(orig->splits->data);
+    xaccTransCommitEdit (txn);
+
+    xaccTransBeginEdit (txn);
+    g_assert (txn->orig == orig);
+    g_assert_cmpstr (orig->description, ==, "Waldo Pepper");
+    g_assert_cmpuint (g_list_length (orig->splits), ==, 2);
+    g_assert (g_list_find (orig->splits, orig_split));
+    g_assert (xaccSplitEqual (static_cast<Split*>(orig->splits->data),
+                              static_cast<Split*>(txn->splits->data),
+                              TRUE, FALSE, FALSE));
+    xaccTransRollbackEdit (txn);
+    g_assert_cmpstr (xaccTransGetDescription (txn), ==, "Waldo Pepper");
+}
+/* Each book keeps its own copies, so books used on different threads
+ * share none. */
+static void
+test_xaccTransBeginEdit_copy_per_book (Fixture *fixture, gconstpointer pData)
+{
+    auto txn = fixture->txn;
+    auto book = qof_book_new ();
+    auto other = xaccMallocTransaction (book);
+
+    xaccTransBeginEdit (txn);
+    auto orig = txn->orig;
+    xaccTransCommitEdit (txn);
+
+    xaccTransBeginEdit (other);
+    g_assert (other->orig != orig);
+    g_assert (qof_instance_get_book (other->orig) == book);
+    xaccTransCommitEdit (other);
+    qof_book_destroy (book);
+
+    xaccTransBeginEdit (txn);
+    g_assert (txn->orig == orig);
+    xaccTransRollbackEdit (txn);
+}
 /* A second xaccTransRollbackEdit test to check the backend error handling */
 static void
 test_xaccTransRollbackEdit_BackendErrors (Fixture *fixture, gconstpointer pData)
@@ -1777,6 +1968,40 @@ test_xaccTransOrder_num_action (Fixture *fixture, gconstpointer pData)
 
     fixture->func->xaccFreeTransaction (txnB);
 }
+
+static void
+test_xaccTransOrder_num_sort_key (Fixture *fixture, gconstpointer pData)
+{
+    Transaction *txnA = fixture->txn;
+    Transaction *txnB = fixture->func->dupe_trans (txnA);
+
+    xaccTransSetNum (txnA, "12a");
+    /* Setting the num parses it, so comparing only reads the key */
+    g_assert (txnA->num_sort_key.src == txnA->num);
+    g_assert_cmpuint (txnA->num_sort_key.value, ==, 12);
+    g_assert_cmpstr (txnA->num_sort_key.rest, ==, "a");
+    /* A num set behind the setter's back is parsed on the fly */
+    txnB->num = static_cast<char*>(CACHE_INSERT ("101"));
+    g_assert_cmpint (xaccTransOrder (txnA, txnB), ==, -1);
+    g_assert (txnB->num_sort_key.src != txnB->num);
+    g_assert_cmpint (xaccTransOrder (txnB, txnA), ==, 1);
+
+    xaccTransSetNum (txnA, "102");
+    g_assert_cmpuint (txnA->num_sort_key.value, ==, 102);
+    g_assert_cmpint (xaccTransOrder (txnA, txnB), ==, 1);
+
+    /* Rolling back an edit restores the key with the num */
+    xaccTransBeginEdit (txnA);
+    xaccTransSetNum (txnA, "7");
+    g_assert_cmpint (xaccTransOrder (txnA, txnB), ==, -1);
+    xaccTransRollbackEdit (txnA);
+    g_assert_cmpstr (txnA->num, ==, "102");
+    g_assert (txnA->num_sort_key.src == txnA->num);
+    g_assert_cmpuint (txnA->num_sort_key.value, ==, 102);
+    g_assert_cmpint (xaccTransOrder (txnA, txnB), ==, 1);
+
+    fixture->func->xaccFreeTransaction (txnB);
+}
 /* xaccTransSetDateInternal Local: 7:0:0
  * set_gains_date_dirty Local: 4:0:0
  * xaccTransSetDatePostedSecs C: 17 in 13  Local: 0:0:0
@@ -1889,6 +2114,39 @@ test_xaccTransVoid (Fixture *fixture, gconstpointer pData)
     g_free (txn_notes);
 
 }
+static guint batch_progress_hits = 0;
+static gboolean batch_progress_done = FALSE;
+static void
+batch_progress_cb (const char *message, double percent)
+{
+    if (percent < 0)
+        batch_progress_done = TRUE;
+    else
+        ++batch_progress_hits;
+}
+
+static void
+test_xaccTransVoidBatch (Fixture *fixture, gconstpointer pData)
+{
+    Transaction *batch[] = { fixture->txn, NULL };
+
+    batch_progress_hits = 0;
+    batch_progress_done = FALSE;
+    g_assert_cmpuint (xaccTransVoidBatch (batch, 2, "Voided for Unit Test",
+                                          batch_progress_cb), ==, 1);
+    g_assert (xaccTransGetVoidStatus (fixture->txn));
+    g_assert (!xaccTransIsOpen (fixture->txn));
+    g_assert_cmpstr (xaccTransGetVoidReason (fixture->txn), ==,
+                     "Voided for Unit Test");
+    g_assert_cmpuint (batch_progress_hits, >, 0);
+    g_assert (batch_progress_done);
+
+    /* Voided transactions are read-only, so a second pass skips them. */
+    g_assert_cmpuint (xaccTransVoidBatch (batch, 1, "Again", NULL), ==, 0);
+    g_assert_cmpstr (xaccTransGetVoidReason (fixture->txn), ==,
+                     "Voided for Unit Test");
+    xaccTransUnvoid (fixture->txn);
+}
 /* xaccTransReverse
 Transaction *
 xaccTransReverse (Transaction *orig)// C: 2 in 2  Local: 0:0:0
@@ -1923,6 +2181,79 @@ test_xaccTransReverse (Fixture *fixture, gconstpointer pData)
 
     fixture->func->xaccFreeTransaction (rev);
 }
+
+static void
+test_xaccTransReverseBatch (Fixture *fixture, gconstpointer pData)
+{
+    Transaction *batch[] = { fixture->txn, NULL };
+    Transaction *rev[2];
+
+    g_assert_cmpuint (xaccTransReverseBatch (batch, 2, rev, NULL), ==, 1);
+    g_assert (rev[1] == NULL);
+    g_assert (rev[0] != NULL);
+    g_assert (!xaccTransIsOpen (rev[0]));
+    g_assert (xaccTransGetReversedBy (fixture->txn) == rev[0]);
+    g_assert_cmpint (xaccTransCountSplits (rev[0]), ==,
+                     xaccTransCountSplits (fixture->txn));
+    auto acc = xaccSplitGetAccount (xaccTransGetSplit (fixture->txn, 0));
+    g_assert (gnc_numeric_zero_p (gnc_numeric_add_fixed
+                                  (xaccTransGetAccountValue (rev[0], acc),
+                                   xaccTransGetAccountValue (fixture->txn, acc))));
+
+    fixture->func->xaccFreeTransaction (rev[0]);
+}
+/* An original the batch can't commit, here an unbalanced one whose
+ * split has no account, is rolled back and not reversed. */
+static void
+test_xaccTransReverseBatch_refused (Fixture *fixture, gconstpointer pData)
+{
+    auto book = qof_instance_get_book (QOF_INSTANCE (fixture->txn));
+    auto bad = xaccMallocTransaction (book);
+    auto split = xaccMallocSplit (book);
+    Transaction *batch[] = { bad, fixture->txn };
+    Transaction *rev[2];
+
+    bad->common_currency = fixture->curr;
+    split->value = gnc_numeric_create (3200, 240);
+    split->amount = gnc_numeric_create (3200, 240);
+    split->parent = bad;
+    bad->splits = g_list_append (bad->splits, split);
+    qof_instance_mark_clean (QOF_INSTANCE (split));
+    qof_instance_mark_clean (QOF_INSTANCE (bad));
+
+    g_assert_cmpuint (xaccTransReverseBatch (batch, 2, rev, NULL), ==, 1);
+    g_assert (rev[0] == NULL);
+    g_assert (!xaccTransIsOpen (bad));
+    g_assert (xaccTransGetReversedBy (bad) == NULL);
+    g_assert (rev[1] != NULL);
+    g_assert (xaccTransGetReversedBy (fixture->txn) == rev[1]);
+
+    fixture->func->xaccFreeTransaction (rev[1]);
+    xaccTransBeginEdit (bad);
+    xaccTransDestroy (bad);
+    xaccTransCommitEdit (bad);
+}
+/* If the backend can't write the batch the reversal stays in the
+ * engine, unsaved, and isn't counted. */
+static void
+test_xaccTransReverseBatch_backend_fails (Fixture *fixture,
+                                          gconstpointer pData)
+{
+    auto book = qof_instance_get_book (QOF_INSTANCE (fixture->txn));
+    auto mbe = static_cast<TransMockBackend*>(qof_book_get_backend (book));
+    Transaction *batch[] = { fixture->txn };
+    Transaction *rev[1];
+
+    mbe->m_batch_ok = false;
+    g_assert_cmpuint (xaccTransReverseBatch (batch, 1, rev, NULL), ==, 0);
+    g_assert (rev[0] != NULL);
+    g_assert (!xaccTransIsOpen (rev[0]));
+    g_assert (qof_instance_is_dirty (QOF_INSTANCE (rev[0])));
+    g_assert (xaccTransGetReversedBy (fixture->txn) == rev[0]);
+    mbe->m_batch_ok = true;
+
+    fixture->func->xaccFreeTransaction (rev[0]);
+}
 /* xaccTransGetReversedBy C: 2 in 2  Local: 0:0:0
  * Trivial getter.
  */
@@ -2022,6 +2353,8 @@ test_suite_transaction (void)
     GNC_TEST_ADD (suitename, "xaccTransEqual", Fixture, NULL, setup, test_xaccTransEqual, teardown);
     GNC_TEST_ADD (suitename, "xaccTransLookup", Fixture, NULL, setup, test_xaccTransLookup, teardown);
     GNC_TEST_ADD (suitename, "xaccTransGetImbalanceValue", Fixture, NULL, setup, test_xaccTransGetImbalanceValue, teardown);
+    GNC_TEST_ADD (suitename, "xaccTransGetImbalanceValue cached", Fixture, NULL, setup, test_xaccTransGetImbalanceValue_cached, teardown);
+    GNC_TEST_ADD (suitename, "xaccTransGetSplit vector", Fixture, NULL, setup, test_xaccTransGetSplit_vector, teardown);
     GNC_TEST_ADD (suitename, "xaccTransGetImbalance", Fixture, NULL, setup, test_xaccTransGetImbalance, teardown);
     GNC_TEST_ADD (suitename, "xaccTransGetImbalance Trading Accounts", Fixture, NULL, setup, test_xaccTransGetImbalance_trading, teardown);
     GNC_TEST_ADD (suitename, "xaccTransIsBalanced", Fixture, NULL, setup, test_xaccTransIsBalanced, teardown);
@@ -2043,10 +2376,19 @@ test_suite_transaction (void)
     GNC_TEST_ADD_FUNC (suitename, "xaccTransCommitEdit", test_xaccTransCommitEdit);
     GNC_TEST_ADD (suitename, "xaccTransRollbackEdit", Fixture, NULL, setup, test_xaccTransRollbackEdit, teardown);
     GNC_TEST_ADD (suitename, "xaccTransRollbackEdit - Backend Errors", Fixture, NULL, setup, test_xaccTransRollbackEdit_BackendErrors, teardown);
+    GNC_TEST_ADD (suitename, "xaccTransCommitEditBatch", Fixture, NULL, setup, test_xaccTransCommitEditBatch, teardown);
+    GNC_TEST_ADD (suitename, "xaccTransCommitEditBatch backend fails", Fixture, NULL, setup, test_xaccTransCommitEditBatch_backend_fails, teardown);
+    GNC_TEST_ADD (suitename, "xaccTransBeginEdit reuses copy", Fixture, NULL, setup, test_xaccTransBeginEdit_reuses_copy, teardown);
+    GNC_TEST_ADD (suitename, "xaccTransBeginEdit copy per book", Fixture, NULL, setup, test_xaccTransBeginEdit_copy_per_book, teardown);
     GNC_TEST_ADD (suitename, "xaccTransOrder_num_action", Fixture, NULL, setup, test_xaccTransOrder_num_action, teardown);
+    GNC_TEST_ADD (suitename, "xaccTransOrder_num_sort_key", Fixture, NULL, setup, test_xaccTransOrder_num_sort_key, teardown);
     GNC_TEST_ADD (suitename, "xaccTransGetTxnType", Fixture, NULL, setup, test_xaccTransGetTxnType, teardown);
     GNC_TEST_ADD (suitename, "xaccTransVoid", Fixture, NULL, setup, test_xaccTransVoid, teardown);
+    GNC_TEST_ADD (suitename, "xaccTransVoidBatch", Fixture, NULL, setup, test_xaccTransVoidBatch, teardown);
     GNC_TEST_ADD (suitename, "xaccTransReverse", Fixture, NULL, setup, test_xaccTransReverse, teardown);
+    GNC_TEST_ADD (suitename, "xaccTransReverseBatch", Fixture, NULL, setup, test_xaccTransReverseBatch, teardown);
+    GNC_TEST_ADD (suitename, "xaccTransReverseBatch refused", Fixture, NULL, setup, test_xaccTransReverseBatch_refused, teardown);
+    GNC_TEST_ADD (suitename, "xaccTransReverseBatch backend fails", Fixture, NULL, setup, test_xaccTransReverseBatch_backend_fails, teardown);
     GNC_TEST_ADD (suitename, "xaccTransScrubGainsDate_no_dirty", GainsFixture, NULL, setup_with_gains, test_xaccTransScrubGainsDate_no_dirty, teardown_with_gains);
     GNC_TEST_ADD (suitename, "xaccTransScrubGainsDate_base_dirty", GainsFixture, NULL, setup_with_gains, test_xaccTransScrubGainsDate_base_dirty, teardown_with_gains);
     GNC_TEST_ADD (suitename, "xaccTransScrubGainsDate_gains_dirty", GainsFixture, NULL, setup_with_gains, test_xaccTransScrubGainsDate_gains_dirty, teardown_with_gains);
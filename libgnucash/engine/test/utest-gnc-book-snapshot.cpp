@@ -0,0 +1,214 @@
+/********************************************************************
+ * utest-gnc-book-snapshot.cpp: GLib g_test test suite for          *
+ * gnc-book-snapshot.cpp.                                           *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ ********************************************************************/
+extern "C"
+{
+#include <config.h>
+#include <glib.h>
+#include <unittest-support.h>
+#include "../gnc-book-snapshot.h"
+#include "../Account.h"
+#include "../Split.h"
+#include "../Transaction.h"
+#include "../gnc-pricedb.h"
+#include "../cashobjects.h"
+}
+
+static const gchar *suitename = "/engine/gnc-book-snapshot";
+extern "C" void test_suite_gnc_book_snapshot (void);
+
+typedef struct
+{
+    QofBook *book;
+    gnc_commodity *usd;
+    gnc_commodity *foo;
+    Account *checking;
+    Account *income;
+    Transaction *trans;
+} Fixture;
+
+static Account *
+make_account (Fixture *fixture, const char *name, GNCAccountType type)
+{
+    auto acc = xaccMallocAccount (fixture->book);
+    xaccAccountBeginEdit (acc);
+    xaccAccountSetName (acc, name);
+    xaccAccountSetType (acc, type);
+    xaccAccountSetCommodity (acc, fixture->usd);
+    gnc_account_append_child (gnc_book_get_root_account (fixture->book), acc);
+    xaccAccountCommitEdit (acc);
+    return acc;
+}
+
+static Transaction *
+make_trans (Fixture *fixture, gint64 amount)
+{
+    auto trans = xaccMallocTransaction (fixture->book);
+    auto s1 = xaccMallocSplit (fixture->book);
+    auto s2 = xaccMallocSplit (fixture->book);
+    auto value = gnc_numeric_create (amount, 1);
+
+    xaccTransBeginEdit (trans);
+    xaccTransSetCurrency (trans, fixture->usd);
+    xaccTransSetDatePostedSecsNormalized (trans, gnc_dmy2time64_neutral (1, 3, 2020));
+    xaccSplitSetParent (s1, trans);
+    xaccSplitSetParent (s2, trans);
+    xaccSplitSetAccount (s1, fixture->checking);
+    xaccSplitSetAccount (s2, fixture->income);
+    xaccSplitSetAmount (s1, value);
+    xaccSplitSetValue (s1, value);
+    xaccSplitSetAmount (s2, gnc_numeric_neg (value));
+    xaccSplitSetValue (s2, gnc_numeric_neg (value));
+    xaccTransCommitEdit (trans);
+    return trans;
+}
+
+static void
+setup (Fixture *fixture, gconstpointer pData)
+{
+    cashobjects_register ();
+    fixture->book = qof_book_new ();
+    auto table = gnc_commodity_table_get_table (fixture->book);
+    fixture->usd = gnc_commodity_table_insert (
+        table, gnc_commodity_new (fixture->book, "US Dollar", "CURRENCY",
+                                  "USD", "840", 100));
+    fixture->foo = gnc_commodity_table_insert (
+        table, gnc_commodity_new (fixture->book, "Foo Inc", "NASDAQ",
+                                  "FOO", NULL, 100));
+    gnc_account_create_root (fixture->book);
+    fixture->checking = make_account (fixture, "Checking", ACCT_TYPE_BANK);
+    fixture->income = make_account (fixture, "Income", ACCT_TYPE_INCOME);
+    fixture->trans = make_trans (fixture, 100);
+    make_trans (fixture, 25);
+
+    auto price = gnc_price_create (fixture->book);
+    gnc_price_begin_edit (price);
+    gnc_price_set_commodity (price, fixture->foo);
+    gnc_price_set_currency (price, fixture->usd);
+    gnc_price_set_time64 (price, gnc_dmy2time64_neutral (1, 3, 2020));
+    gnc_price_set_value (price, gnc_numeric_create (10, 1));
+    gnc_price_commit_edit (price);
+    gnc_pricedb_add_price (gnc_pricedb_get_db (fixture->book), price);
+    gnc_price_unref (price);
+}
+
+static void
+teardown (Fixture *fixture, gconstpointer pData)
+{
+    qof_book_destroy (fixture->book);
+}
+
+static void
+test_gnc_book_snapshot_new (Fixture *fixture, gconstpointer pData)
+{
+    auto snapshot = gnc_book_snapshot_new (fixture->book);
+
+    g_assert_true (qof_book_is_frozen (snapshot));
+    g_assert_true (qof_book_is_readonly (snapshot));
+    g_assert_false (qof_book_is_frozen (fixture->book));
+    g_assert_true (gnc_book_snapshot_is_current (snapshot, fixture->book));
+
+    g_assert_cmpint (qof_collection_count (qof_book_get_collection (snapshot, GNC_ID_TRANS)),
+                     ==, 2);
+    g_assert_nonnull (xaccTransLookup (qof_instance_get_guid (fixture->trans), snapshot));
+    auto checking = xaccAccountLookup (qof_instance_get_guid (fixture->checking), snapshot);
+    g_assert_nonnull (checking);
+    g_assert_true (checking != fixture->checking);
+    g_assert_cmpint (xaccAccountGetBalance (checking).num, ==, 125);
+    auto foo = gnc_commodity_table_lookup (gnc_commodity_table_get_table (snapshot),
+                                           "NASDAQ", "FOO");
+    g_assert_nonnull (foo);
+    auto price = gnc_pricedb_lookup_latest (gnc_pricedb_get_db (snapshot), foo,
+                                            gnc_commodity_obtain_twin (fixture->usd,
+                                                                       snapshot));
+    g_assert_nonnull (price);
+    gnc_price_unref (price);
+
+    /* Editing the book leaves the snapshot as it was. */
+    xaccTransBeginEdit (fixture->trans);
+    xaccTransDestroy (fixture->trans);
+    xaccTransCommitEdit (fixture->trans);
+    g_assert_false (gnc_book_snapshot_is_current (snapshot, fixture->book));
+    g_assert_cmpint (xaccAccountGetBalance (fixture->checking).num, ==, 25);
+    g_assert_cmpint (xaccAccountGetBalance (checking).num, ==, 125);
+
+    qof_book_destroy (snapshot);
+}
+
+static void
+event_cb (QofInstance *ent, QofEventId event_type, gpointer handler_data,
+          gpointer event_data)
+{
+    ++*static_cast<int*>(handler_data);
+}
+
+static void
+test_gnc_book_snapshot_events (Fixture *fixture, gconstpointer pData)
+{
+    int events = 0;
+    auto snapshot = gnc_book_snapshot_new (fixture->book);
+    auto checking = xaccAccountLookup (qof_instance_get_guid (fixture->checking), snapshot);
+    auto handler = qof_event_register_handler (event_cb, &events);
+
+    qof_event_gen (QOF_INSTANCE (checking), QOF_EVENT_MODIFY, NULL);
+    qof_book_destroy (snapshot);
+    g_assert_cmpint (events, ==, 0);
+
+    qof_event_gen (QOF_INSTANCE (fixture->checking), QOF_EVENT_MODIFY, NULL);
+    g_assert_cmpint (events, ==, 1);
+    qof_event_unregister_handler (handler);
+}
+
+static gpointer
+balance_thread (gpointer data)
+{
+    auto snapshot = static_cast<QofBook*>(data);
+    auto root = gnc_book_get_root_account (snapshot);
+    auto checking = gnc_account_lookup_by_name (root, "Checking");
+    auto balance = xaccAccountGetBalance (checking);
+
+    return GINT_TO_POINTER (balance.num);
+}
+
+static void
+test_gnc_book_snapshot_thread (Fixture *fixture, gconstpointer pData)
+{
+    auto snapshot = gnc_book_snapshot_new (fixture->book);
+    auto thread = g_thread_new ("snapshot", balance_thread, snapshot);
+
+    /* Go on editing meanwhile. */
+    make_trans (fixture, 5);
+    g_assert_cmpint (GPOINTER_TO_INT (g_thread_join (thread)), ==, 125);
+    g_assert_cmpint (xaccAccountGetBalance (fixture->checking).num, ==, 130);
+    /* Back on the thread that made it. */
+    qof_book_destroy (snapshot);
+}
+
+void
+test_suite_gnc_book_snapshot (void)
+{
+    GNC_TEST_ADD (suitename, "gnc_book_snapshot_new", Fixture, NULL, setup,
+                  test_gnc_book_snapshot_new, teardown);
+    GNC_TEST_ADD (suitename, "gnc_book_snapshot_events", Fixture, NULL, setup,
+                  test_gnc_book_snapshot_events, teardown);
+    GNC_TEST_ADD (suitename, "gnc_book_snapshot_thread", Fixture, NULL, setup,
+                  test_gnc_book_snapshot_thread, teardown);
+}
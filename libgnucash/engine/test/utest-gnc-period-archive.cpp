@@ -0,0 +1,295 @@
+/********************************************************************
+ * utest-gnc-period-archive.cpp: GLib g_test test suite for         *
+ * gnc-period-archive.cpp.                                          *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ ********************************************************************/
+extern "C"
+{
+#include <config.h>
+#include <glib.h>
+#include <unittest-support.h>
+#include "../gnc-period-archive.h"
+#include "../Account.h"
+#include "../Split.h"
+#include "../Transaction.h"
+#include "../gnc-lot.h"
+#include "../gnc-pricedb.h"
+#include "../cashobjects.h"
+}
+
+static const gchar *suitename = "/engine/gnc-period-archive";
+extern "C" void test_suite_gnc_period_archive (void);
+
+typedef struct
+{
+    QofBook *book;
+    gnc_commodity *usd;
+    Account *checking;
+    Account *income;
+    Account *equity;
+    Transaction *trans[3];
+    time64 cutoff;
+} Fixture;
+
+static Account *
+make_account (Fixture *fixture, const char *name, GNCAccountType type)
+{
+    auto acc = xaccMallocAccount (fixture->book);
+    xaccAccountBeginEdit (acc);
+    xaccAccountSetName (acc, name);
+    xaccAccountSetType (acc, type);
+    xaccAccountSetCommodity (acc, fixture->usd);
+    gnc_account_append_child (gnc_book_get_root_account (fixture->book), acc);
+    xaccAccountCommitEdit (acc);
+    return acc;
+}
+
+static Transaction *
+make_trans (Fixture *fixture, time64 date, gint64 amount)
+{
+    auto trans = xaccMallocTransaction (fixture->book);
+    auto s1 = xaccMallocSplit (fixture->book);
+    auto s2 = xaccMallocSplit (fixture->book);
+    auto value = gnc_numeric_create (amount, 1);
+
+    xaccTransBeginEdit (trans);
+    xaccTransSetCurrency (trans, fixture->usd);
+    xaccTransSetDatePostedSecsNormalized (trans, date);
+    xaccSplitSetParent (s1, trans);
+    xaccSplitSetParent (s2, trans);
+    xaccSplitSetAccount (s1, fixture->checking);
+    xaccSplitSetAccount (s2, fixture->income);
+    xaccSplitSetAmount (s1, value);
+    xaccSplitSetValue (s1, value);
+    xaccSplitSetAmount (s2, gnc_numeric_neg (value));
+    xaccSplitSetValue (s2, gnc_numeric_neg (value));
+    xaccTransCommitEdit (trans);
+    return trans;
+}
+
+static void
+add_price (Fixture *fixture, gnc_commodity *com, time64 date)
+{
+    auto price = gnc_price_create (fixture->book);
+    gnc_price_begin_edit (price);
+    gnc_price_set_commodity (price, com);
+    gnc_price_set_currency (price, fixture->usd);
+    gnc_price_set_time64 (price, date);
+    gnc_price_set_value (price, gnc_numeric_create (10, 1));
+    gnc_price_commit_edit (price);
+    gnc_pricedb_add_price (gnc_pricedb_get_db (fixture->book), price);
+    gnc_price_unref (price);
+}
+
+static void
+setup (Fixture *fixture, gconstpointer pData)
+{
+    /* The commodity table and the price database */
+    cashobjects_register ();
+    fixture->book = qof_book_new ();
+    auto table = gnc_commodity_table_get_table (fixture->book);
+    fixture->usd = gnc_commodity_table_insert (
+        table, gnc_commodity_new (fixture->book, "US Dollar", "CURRENCY",
+                                  "USD", "840", 100));
+    auto foo = gnc_commodity_table_insert (
+        table, gnc_commodity_new (fixture->book, "Foo Inc", "NASDAQ",
+                                  "FOO", NULL, 100));
+    gnc_account_create_root (fixture->book);
+    fixture->checking = make_account (fixture, "Checking", ACCT_TYPE_BANK);
+    fixture->income = make_account (fixture, "Income", ACCT_TYPE_INCOME);
+    fixture->equity = make_account (fixture, "Equity", ACCT_TYPE_EQUITY);
+
+    fixture->trans[0] = make_trans (fixture, gnc_dmy2time64_neutral (1, 3, 2019), 100);
+    fixture->trans[1] = make_trans (fixture, gnc_dmy2time64_neutral (1, 6, 2019), 50);
+    fixture->trans[2] = make_trans (fixture, gnc_dmy2time64_neutral (10, 1, 2021), 10);
+    add_price (fixture, foo, gnc_dmy2time64_neutral (1, 1, 2019));
+    add_price (fixture, foo, gnc_dmy2time64_neutral (1, 6, 2019));
+    add_price (fixture, foo, gnc_dmy2time64_neutral (1, 1, 2021));
+    fixture->cutoff = gnc_dmy2time64_end (31, 12, 2020);
+}
+
+static void
+teardown (Fixture *fixture, gconstpointer pData)
+{
+    qof_book_destroy (fixture->book);
+}
+
+static Account *
+equity_cb (gnc_commodity *currency, gpointer user_data)
+{
+    return static_cast<Fixture*>(user_data)->equity;
+}
+
+static guint
+count_instances (QofBook *book, QofIdTypeConst type)
+{
+    return qof_collection_count (qof_book_get_collection (book, type));
+}
+
+static void
+test_gnc_period_archive_new (Fixture *fixture, gconstpointer pData)
+{
+    auto archive = gnc_period_archive_new (fixture->book, fixture->cutoff);
+    g_assert_nonnull (archive);
+
+    /* The two old transactions and the older of the two old prices. */
+    g_assert_cmpint (count_instances (archive, GNC_ID_TRANS), ==, 2);
+    g_assert_cmpint (count_instances (archive, GNC_ID_PRICE), ==, 1);
+    g_assert_nonnull (xaccTransLookup (qof_instance_get_guid (fixture->trans[0]),
+                                       archive));
+    g_assert_null (xaccTransLookup (qof_instance_get_guid (fixture->trans[2]),
+                                    archive));
+    auto checking = xaccAccountLookup (qof_instance_get_guid (fixture->checking),
+                                       archive);
+    g_assert_nonnull (checking);
+    g_assert_cmpstr (xaccAccountGetName (checking), ==, "Checking");
+    g_assert_cmpint (xaccAccountGetBalance (checking).num, ==, 150);
+
+    /* The working book is left alone. */
+    g_assert_cmpint (count_instances (fixture->book, GNC_ID_TRANS), ==, 3);
+    g_assert_cmpint (xaccAccountGetBalance (fixture->checking).num, ==, 160);
+
+    qof_book_destroy (archive);
+
+    g_assert_null (gnc_period_archive_new (fixture->book,
+                                           gnc_dmy2time64_end (31, 12, 2018)));
+}
+
+static void
+test_gnc_period_archive_commit (Fixture *fixture, gconstpointer pData)
+{
+    g_assert_null (gnc_period_archive_get_uri (fixture->book));
+    g_assert_cmpint (gnc_period_archive_get_cutoff (fixture->book), ==, G_MININT64);
+
+    auto archive = gnc_period_archive_new (fixture->book, fixture->cutoff);
+    g_assert_true (gnc_period_archive_commit (fixture->book, archive, fixture->cutoff,
+                                              "file:///tmp/archive.gnucash",
+                                              equity_cb, fixture));
+    qof_book_destroy (archive);
+
+    g_assert_cmpstr (gnc_period_archive_get_uri (fixture->book), ==,
+                     "file:///tmp/archive.gnucash");
+    g_assert_cmpint (gnc_period_archive_get_cutoff (fixture->book), ==,
+                     fixture->cutoff);
+
+    /* The third transaction and the opening entry remain; the income
+     * closed into equity. */
+    g_assert_cmpint (count_instances (fixture->book, GNC_ID_TRANS), ==, 2);
+    g_assert_cmpint (count_instances (fixture->book, GNC_ID_PRICE), ==, 2);
+    g_assert_cmpint (xaccAccountGetBalance (fixture->checking).num, ==, 160);
+    g_assert_cmpint (xaccAccountGetBalance (fixture->income).num, ==, -10);
+    g_assert_cmpint (xaccAccountGetBalance (fixture->equity).num, ==, -150);
+    g_assert_cmpint (xaccAccountGetBalanceAsOfDate (fixture->checking,
+                                                    fixture->cutoff).num, ==, 150);
+}
+
+static void
+test_gnc_period_archive_reconciled (Fixture *fixture, gconstpointer pData)
+{
+    auto reconciled = xaccTransFindSplitByAccount (fixture->trans[0], fixture->checking);
+    auto cleared = xaccTransFindSplitByAccount (fixture->trans[1], fixture->checking);
+    auto date = gnc_dmy2time64_neutral (5, 3, 2019);
+
+    xaccTransBeginEdit (fixture->trans[0]);
+    xaccSplitSetReconcile (reconciled, YREC);
+    xaccSplitSetDateReconciledSecs (reconciled, date);
+    xaccTransCommitEdit (fixture->trans[0]);
+    xaccTransBeginEdit (fixture->trans[1]);
+    xaccSplitSetReconcile (cleared, CREC);
+    xaccTransCommitEdit (fixture->trans[1]);
+
+    auto archive = gnc_period_archive_new (fixture->book, fixture->cutoff);
+    g_assert_true (gnc_period_archive_commit (fixture->book, archive, fixture->cutoff,
+                                              "file:///tmp/archive.gnucash",
+                                              equity_cb, fixture));
+    qof_book_destroy (archive);
+
+    /* The reconciled and cleared amounts open in splits of their own. */
+    g_assert_cmpint (xaccAccountGetReconciledBalance (fixture->checking).num, ==, 100);
+    g_assert_cmpint (xaccAccountGetClearedBalance (fixture->checking).num, ==, 150);
+    g_assert_cmpint (xaccAccountGetBalance (fixture->checking).num, ==, 160);
+    auto found = false;
+    for (auto node = xaccAccountGetSplitList (fixture->checking); node; node = node->next)
+    {
+        auto split = static_cast<Split*>(node->data);
+        if (xaccSplitGetReconcile (split) != YREC)
+            continue;
+        g_assert_cmpint (xaccSplitGetDateReconciled (split), ==, date);
+        found = true;
+    }
+    g_assert_true (found);
+}
+
+static void
+test_gnc_period_archive_open_trans (Fixture *fixture, gconstpointer pData)
+{
+    auto archive = gnc_period_archive_new (fixture->book, fixture->cutoff);
+
+    /* A transaction opened for editing after the archive was made
+     * stops the commit before anything changes. */
+    xaccTransBeginEdit (fixture->trans[0]);
+    g_assert_false (gnc_period_archive_commit (fixture->book, archive, fixture->cutoff,
+                                               "file:///tmp/archive.gnucash",
+                                               equity_cb, fixture));
+    xaccTransCommitEdit (fixture->trans[0]);
+    qof_book_destroy (archive);
+
+    g_assert_null (gnc_period_archive_get_uri (fixture->book));
+    g_assert_cmpint (count_instances (fixture->book, GNC_ID_TRANS), ==, 3);
+    g_assert_cmpint (xaccAccountGetBalance (fixture->income).num, ==, -160);
+}
+
+static void
+test_gnc_period_archive_open_lot (Fixture *fixture, gconstpointer pData)
+{
+    /* A lot that is still open keeps its transaction in the book. */
+    auto lot = gnc_lot_new (fixture->book);
+    auto split = xaccTransFindSplitByAccount (fixture->trans[1], fixture->checking);
+    gnc_lot_add_split (lot, split);
+
+    auto archive = gnc_period_archive_new (fixture->book, fixture->cutoff);
+    g_assert_cmpint (count_instances (archive, GNC_ID_TRANS), ==, 1);
+    g_assert_cmpint (count_instances (archive, GNC_ID_LOT), ==, 0);
+
+    gnc_period_archive_commit (fixture->book, archive, fixture->cutoff,
+                               "file:///tmp/archive.gnucash", NULL, NULL);
+    qof_book_destroy (archive);
+
+    g_assert_nonnull (xaccTransLookup (qof_instance_get_guid (fixture->trans[1]),
+                                       fixture->book));
+    g_assert_true (gnc_lot_get_split_list (lot) != NULL);
+    /* Without an equity account the income is carried forward. */
+    g_assert_cmpint (xaccAccountGetBalance (fixture->checking).num, ==, 160);
+    g_assert_cmpint (xaccAccountGetBalance (fixture->income).num, ==, -160);
+}
+
+void
+test_suite_gnc_period_archive (void)
+{
+    GNC_TEST_ADD (suitename, "gnc_period_archive_new", Fixture, NULL, setup,
+                  test_gnc_period_archive_new, teardown);
+    GNC_TEST_ADD (suitename, "gnc_period_archive_commit", Fixture, NULL, setup,
+                  test_gnc_period_archive_commit, teardown);
+    GNC_TEST_ADD (suitename, "gnc_period_archive_reconciled", Fixture, NULL, setup,
+                  test_gnc_period_archive_reconciled, teardown);
+    GNC_TEST_ADD (suitename, "gnc_period_archive_open_trans", Fixture, NULL, setup,
+                  test_gnc_period_archive_open_trans, teardown);
+    GNC_TEST_ADD (suitename, "gnc_period_archive_open_lot", Fixture, NULL, setup,
+                  test_gnc_period_archive_open_lot, teardown);
+}
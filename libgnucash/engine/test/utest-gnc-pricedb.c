@@ -1064,6 +1064,49 @@ test_gnc_pricedb_get_prices (PriceDBFixture *fixture, gconstpointer pData)
     g_assert_cmpint(g_list_length(prices), ==, 5);
     gnc_price_list_destroy(prices);
 }
+/* gnc_pricedb_nth_price
+GNCPrice *
+gnc_pricedb_nth_price (GNCPriceDB *db,// C: 4 in 1  Local: 0:0:0
+*/
+static void
+test_gnc_pricedb_nth_price (PriceDBFixture *fixture, gconstpointer pData)
+{
+    gnc_commodity *usd = fixture->com->usd;
+    int num = gnc_pricedb_num_prices(fixture->pricedb, usd);
+    GNCPrice *price, *first;
+    int n;
+
+    g_assert_cmpint(num, >, 0);
+    for (n = 0; n < num; n++)
+    {
+        price = gnc_pricedb_nth_price(fixture->pricedb, usd, n);
+        g_assert(price != NULL);
+        g_assert(gnc_price_get_commodity(price) == usd);
+        g_assert_cmpint(gnc_pricedb_nth_price_index(fixture->pricedb, price),
+                        ==, n);
+    }
+    g_assert(gnc_pricedb_nth_price(fixture->pricedb, usd, num) == NULL);
+
+    /* A new price shows once the cache is reset. */
+    first = gnc_pricedb_nth_price(fixture->pricedb, usd, 0);
+    price = gnc_price_create(qof_instance_get_book(fixture->pricedb));
+    gnc_price_begin_edit(price);
+    gnc_price_set_commodity(price, usd);
+    gnc_price_set_currency(price, gnc_price_get_currency(first));
+    gnc_price_set_time64(price, gnc_dmy2time64(1, 1, 2030));
+    gnc_price_set_value(price, gnc_numeric_create(1, 1));
+    gnc_price_commit_edit(price);
+    gnc_pricedb_add_price(fixture->pricedb, price);
+    g_assert(gnc_pricedb_nth_price(fixture->pricedb, usd, num) == NULL);
+    g_assert_cmpint(gnc_pricedb_nth_price_index(fixture->pricedb, price), ==, -1);
+
+    gnc_pricedb_nth_price_reset_cache(fixture->pricedb);
+    g_assert(gnc_pricedb_nth_price(fixture->pricedb, usd, num) != NULL);
+    n = gnc_pricedb_nth_price_index(fixture->pricedb, price);
+    g_assert_cmpint(n, >=, 0);
+    g_assert(gnc_pricedb_nth_price(fixture->pricedb, usd, n) == price);
+    gnc_price_unref(price);
+}
 /* gnc_pricedb_lookup_day_t64
 GNCPrice *
 gnc_pricedb_lookup_day_t64(GNCPriceDB *db,// C: 4 in 2 SCM: 2 in 1 Local: 1:0:0
@@ -1095,11 +1138,240 @@ test_gnc_pricedb_lookup_day_t64 (PriceDBFixture *fixture, gconstpointer pData)
     g_log_set_default_handler (hdlr, 0);
 }
 
-// Not Used
+/* gnc_pricedb_add_prices_bulk
+guint
+gnc_pricedb_add_prices_bulk (GNCPriceDB *db, PriceList *prices)
+*/
+static void
+test_gnc_pricedb_add_prices_bulk (PriceDBFixture *fixture, gconstpointer pData)
+{
+    QofBook *book = qof_instance_get_book (fixture->pricedb);
+    Commodities *c = fixture->com;
+    time64 d1 = gnc_dmy2time64(3, 2, 2014), d2 = gnc_dmy2time64(4, 2, 2014);
+    time64 replaced_day = gnc_dmy2time64(25, 7, 2011);
+    time64 kept_day = gnc_dmy2time64(19, 11, 2012);
+    guint num_prices = gnc_pricedb_get_num_prices (fixture->pricedb);
+    GNCPrice *kept = gnc_pricedb_lookup_day_t64 (fixture->pricedb, c->amzn,
+                                                 c->usd, kept_day);
+    GNCPrice *worse = construct_price(book, c->amzn, c->eur, d1,
+                                      PRICE_SOURCE_USER_PRICE,
+                                      gnc_numeric_create(1, 1));
+    GNCPrice *better = construct_price(book, c->amzn, c->eur, d1 + 3600,
+                                       PRICE_SOURCE_FQ,
+                                       gnc_numeric_create(2, 1));
+    GNCPrice *next_day = construct_price(book, c->amzn, c->eur, d2,
+                                         PRICE_SOURCE_FQ,
+                                         gnc_numeric_create(3, 1));
+    GNCPrice *replacement = construct_price(book, c->amzn, c->usd, replaced_day,
+                                            PRICE_SOURCE_EDIT_DLG,
+                                            gnc_numeric_create(22300, 100));
+    GNCPrice *rejected = construct_price(book, c->amzn, c->usd, kept_day,
+                                         PRICE_SOURCE_USER_PRICE,
+                                         gnc_numeric_create(24000, 100));
+    PriceList *batch = NULL;
+    GNCPrice *price;
+
+    batch = g_list_prepend (batch, rejected);
+    batch = g_list_prepend (batch, replacement);
+    batch = g_list_prepend (batch, next_day);
+    batch = g_list_prepend (batch, better);
+    batch = g_list_prepend (batch, worse);
+    g_assert_cmpuint (gnc_pricedb_add_prices_bulk (fixture->pricedb, batch),
+                      ==, 3);
+    g_assert_cmpuint (gnc_pricedb_get_num_prices (fixture->pricedb), ==,
+                      num_prices + 2);
+
+    price = gnc_pricedb_lookup_day_t64 (fixture->pricedb, c->amzn, c->eur, d1);
+    g_assert (price == better);
+    gnc_price_unref (price);
+    price = gnc_pricedb_lookup_latest (fixture->pricedb, c->amzn, c->eur);
+    g_assert (price == next_day);
+    gnc_price_unref (price);
+    price = gnc_pricedb_lookup_day_t64 (fixture->pricedb, c->amzn, c->usd,
+                                        replaced_day);
+    g_assert (price == replacement);
+    gnc_price_unref (price);
+    price = gnc_pricedb_lookup_day_t64 (fixture->pricedb, c->amzn, c->usd,
+                                        kept_day);
+    g_assert (price == kept);
+    gnc_price_unref (price);
+
+    /* Adding the same prices again changes nothing. */
+    g_assert_cmpuint (gnc_pricedb_add_prices_bulk (fixture->pricedb, batch),
+                      ==, 0);
+    g_assert_cmpuint (gnc_pricedb_get_num_prices (fixture->pricedb), ==,
+                      num_prices + 2);
+
+    gnc_price_unref (kept);
+    g_list_free_full (batch, (GDestroyNotify)gnc_price_unref);
+}
+
+/* gnc_pricedb_remove_prices
+guint
+gnc_pricedb_remove_prices (GNCPriceDB *db, PriceList *prices)
+*/
+static void
+test_gnc_pricedb_remove_prices (PriceDBFixture *fixture, gconstpointer pData)
+{
+    Commodities *c = fixture->com;
+    time64 day1 = gnc_dmy2time64(25, 7, 2011);
+    time64 day2 = gnc_dmy2time64(19, 11, 2012);
+    guint num_prices = gnc_pricedb_get_num_prices (fixture->pricedb);
+    GNCPrice *p1 = gnc_pricedb_lookup_day_t64 (fixture->pricedb, c->amzn,
+                                               c->usd, day1);
+    GNCPrice *p2 = gnc_pricedb_lookup_day_t64 (fixture->pricedb, c->amzn,
+                                               c->usd, day2);
+    PriceList *doomed = NULL;
+
+    g_assert (p1 != NULL && p2 != NULL);
+    doomed = g_list_prepend (doomed, p1);
+    doomed = g_list_prepend (doomed, p2);
+    doomed = g_list_prepend (doomed, p1);
+    g_assert_cmpuint (gnc_pricedb_remove_prices (fixture->pricedb, doomed),
+                      ==, 2);
+    g_assert_cmpuint (gnc_pricedb_get_num_prices (fixture->pricedb), ==,
+                      num_prices - 2);
+    g_assert (gnc_pricedb_lookup_day_t64 (fixture->pricedb, c->amzn, c->usd,
+                                          day1) == NULL);
+    g_assert (gnc_pricedb_lookup_day_t64 (fixture->pricedb, c->amzn, c->usd,
+                                          day2) == NULL);
+
+    /* They're gone already. */
+    g_assert_cmpuint (gnc_pricedb_remove_prices (fixture->pricedb, doomed),
+                      ==, 0);
+    g_list_free (doomed);
+    gnc_price_unref (p1);
+    gnc_price_unref (p2);
+}
+
+/* gnc_pricedb_compact
+guint
+gnc_pricedb_compact (GNCPriceDB *db)
+*/
+static void
+test_gnc_pricedb_compact (PriceDBFixture *fixture, gconstpointer pData)
+{
+    QofBook *book = qof_instance_get_book (fixture->pricedb);
+    Commodities *c = fixture->com;
+    time64 t1 = gnc_dmy2time64(3, 2, 2014), t2 = gnc_dmy2time64(4, 3, 2014);
+    guint num_prices = gnc_pricedb_get_num_prices (fixture->pricedb);
+    GNCPrice *p1 = construct_price(book, c->bgn, c->dkk, t1, PRICE_SOURCE_FQ,
+                                   gnc_numeric_create(38051, 10000));
+    GNCPrice *p2 = construct_price(book, c->bgn, c->dkk, t2,
+                                   PRICE_SOURCE_USER_PRICE,
+                                   gnc_numeric_create(38107, 10000));
+    GncGUID guid1 = *gnc_price_get_guid (p1), guid2 = *gnc_price_get_guid (p2);
+    GNCPrice *price;
+
+    gnc_price_set_typestr (p2, "nav");
+    g_assert (gnc_pricedb_add_price (fixture->pricedb, p1));
+    g_assert (gnc_pricedb_add_price (fixture->pricedb, p2));
+    gnc_price_unref (p1);
+    gnc_price_unref (p2);
+    /* The fixture's prices are dirty, so only the new series is packed. */
+    qof_instance_mark_clean (QOF_INSTANCE (p1));
+    qof_instance_mark_clean (QOF_INSTANCE (p2));
+
+    g_assert_cmpuint (gnc_pricedb_compact (fixture->pricedb), ==, 2);
+    g_assert_cmpuint (gnc_pricedb_get_num_prices (fixture->pricedb), ==,
+                      num_prices + 2);
+    g_assert_cmpint (gnc_pricedb_num_prices (fixture->pricedb, c->bgn), ==, 2);
+    g_assert (gnc_pricedb_has_prices (fixture->pricedb, c->bgn, c->dkk));
+
+    /* Looking up the series brings the prices back as they were. */
+    price = gnc_pricedb_lookup_latest (fixture->pricedb, c->bgn, c->dkk);
+    g_assert (price != NULL);
+    g_assert (guid_equal (gnc_price_get_guid (price), &guid2));
+    g_assert_cmpint (gnc_price_get_time64 (price), ==, t2);
+    g_assert_cmpint (gnc_price_get_source (price), ==, PRICE_SOURCE_USER_PRICE);
+    g_assert_cmpstr (gnc_price_get_typestr (price), ==, "nav");
+    g_assert (gnc_numeric_equal (gnc_price_get_value (price),
+                                 gnc_numeric_create(38107, 10000)));
+    g_assert (!qof_instance_get_dirty_flag (price));
+    gnc_price_unref (price);
+    g_assert_cmpuint (gnc_pricedb_get_num_prices (fixture->pricedb), ==,
+                      num_prices + 2);
+
+    /* So does looking a packed price up by its GUID. */
+    g_assert_cmpuint (gnc_pricedb_compact (fixture->pricedb), ==, 2);
+    price = gnc_price_lookup (&guid1, book);
+    g_assert (price != NULL);
+    g_assert_cmpint (gnc_price_get_time64 (price), ==, t1);
+    g_assert (gnc_numeric_equal (gnc_price_get_value (price),
+                                 gnc_numeric_create(38051, 10000)));
+
+    /* A series held outside the database stays unpacked. */
+    gnc_price_ref (price);
+    g_assert_cmpuint (gnc_pricedb_compact (fixture->pricedb), ==, 0);
+    gnc_price_unref (price);
+}
+
 /* gnc_pricedb_lookup_at_time64
 GNCPrice *
 gnc_pricedb_lookup_at_time64(GNCPriceDB *db,// Local: 0:0:0
 */
+static void
+test_gnc_pricedb_lookup_at_time64 (PriceDBFixture *fixture, gconstpointer pData)
+{
+    time64 t = gnc_dmy2time64(17, 11, 2012);
+    GNCPrice *before =
+        gnc_pricedb_lookup_nearest_before_t64(fixture->pricedb,
+                                              fixture->com->usd,
+                                              fixture->com->aud, t);
+    time64 price_t = gnc_price_get_time64 (before);
+    GNCPrice *price = gnc_pricedb_lookup_at_time64(fixture->pricedb,
+                                                   fixture->com->usd,
+                                                   fixture->com->aud, price_t);
+    g_assert (price == before);
+    gnc_price_unref (price);
+    price = gnc_pricedb_lookup_at_time64(fixture->pricedb, fixture->com->aud,
+                                         fixture->com->usd, price_t);
+    g_assert (price == before);
+    gnc_price_unref (price);
+    price = gnc_pricedb_lookup_at_time64(fixture->pricedb, fixture->com->usd,
+                                         fixture->com->aud, price_t + 1);
+    g_assert (price == NULL);
+    gnc_price_unref (before);
+}
+
+/* The sorted arrays the lookups search must follow prices being added and
+ * removed. */
+static void
+test_gnc_pricedb_lookup_after_change (PriceDBFixture *fixture, gconstpointer pData)
+{
+    QofBook *book = qof_instance_get_book (fixture->pricedb);
+    time64 t = gnc_dmy2time64(1, 1, 2030);
+    GNCPrice *latest = gnc_pricedb_lookup_latest(fixture->pricedb,
+                                                 fixture->com->usd,
+                                                 fixture->com->aud);
+    GNCPrice *added = construct_price(book, fixture->com->aud, fixture->com->usd,
+                                      t, PRICE_SOURCE_USER_PRICE,
+                                      gnc_numeric_create(76, 100));
+    GNCPrice *price;
+
+    g_assert (latest != NULL);
+    g_assert (gnc_pricedb_add_price(fixture->pricedb, added));
+    price = gnc_pricedb_lookup_latest(fixture->pricedb, fixture->com->usd,
+                                      fixture->com->aud);
+    g_assert (price == added);
+    gnc_price_unref (price);
+    price = gnc_pricedb_lookup_nearest_in_time64(fixture->pricedb,
+                                                 fixture->com->usd,
+                                                 fixture->com->aud, t + 60);
+    g_assert (price == added);
+    gnc_price_unref (price);
+
+    g_assert (gnc_pricedb_remove_price(fixture->pricedb, added));
+    price = gnc_pricedb_lookup_latest(fixture->pricedb, fixture->com->usd,
+                                      fixture->com->aud);
+    g_assert (price == latest);
+    gnc_price_unref (price);
+    price = gnc_pricedb_lookup_at_time64(fixture->pricedb, fixture->com->usd,
+                                         fixture->com->aud, t);
+    g_assert (price == NULL);
+    gnc_price_unref (latest);
+}
+
 /* lookup_nearest_in_time
 static GNCPrice *
 lookup_nearest_in_time(GNCPriceDB *db,// Local: 2:0:0
@@ -1165,6 +1437,69 @@ test_gnc_pricedb_lookup_nearest_before_t64 (PriceDBFixture *fixture, gconstpoint
     g_assert_cmpstr(GET_CUR_NAME(price), ==, "USD");
 
 }
+
+/* gnc_pricedb_lookup_nearest_before_matrix_t64
+GNCPrice **
+gnc_pricedb_lookup_nearest_before_matrix_t64 (GNCPriceDB *db,
+*/
+static void
+test_gnc_pricedb_lookup_nearest_before_matrix_t64 (PriceDBFixture *fixture,
+                                                   gconstpointer pData)
+{
+    Commodities *c = fixture->com;
+    time64 times[] = {gnc_dmy2time64(1, 1, 1990), gnc_dmy2time64(16, 11, 2012),
+                      gnc_dmy2time64(17, 11, 2012), gnc_dmy2time64(1, 1, 2020)};
+    guint n_times = G_N_ELEMENTS (times), row, col;
+    CommodityList *commodities = NULL, *node;
+    PriceList *prices, *price_node;
+    GNCPrice **matrix;
+
+    commodities = g_list_append (commodities, c->aud);
+    commodities = g_list_append (commodities, c->bgn);
+    commodities = g_list_append (commodities, c->gbp);
+    commodities = g_list_append (commodities, c->amzn);
+    g_assert (gnc_pricedb_lookup_nearest_before_matrix_t64 (fixture->pricedb,
+                                                            NULL, c->usd,
+                                                            times, n_times)
+              == NULL);
+
+    matrix = gnc_pricedb_lookup_nearest_before_matrix_t64 (fixture->pricedb,
+                                                           commodities, c->usd,
+                                                           times, n_times);
+    g_assert (matrix != NULL);
+    for (node = commodities, row = 0; node; node = node->next, row++)
+        for (col = 0; col < n_times; col++)
+        {
+            GNCPrice *price =
+                gnc_pricedb_lookup_nearest_before_t64 (fixture->pricedb,
+                                                       node->data, c->usd,
+                                                       times[col]);
+            g_assert (matrix[row * n_times + col] == price);
+            gnc_price_unref (price);
+        }
+    /* No BGN prices in USD, and no prices at all in 1990. */
+    g_assert (matrix[1 * n_times + 1] == NULL);
+    g_assert (matrix[0] == NULL);
+    g_assert (matrix[0 * n_times + 1] != NULL);
+    gnc_price_matrix_destroy (matrix, g_list_length (commodities) * n_times);
+
+    prices = gnc_pricedb_lookup_nearest_before_commodities_t64 (fixture->pricedb,
+                                                                commodities,
+                                                                c->usd,
+                                                                times[2]);
+    g_assert_cmpuint (g_list_length (prices), ==, g_list_length (commodities));
+    for (node = commodities, price_node = prices; node;
+         node = node->next, price_node = price_node->next)
+    {
+        GNCPrice *price =
+            gnc_pricedb_lookup_nearest_before_t64 (fixture->pricedb, node->data,
+                                                   c->usd, times[2]);
+        g_assert (price_node->data == price);
+        gnc_price_unref (price);
+    }
+    gnc_price_list_destroy (prices);
+    g_list_free (commodities);
+}
 /* direct_balance_conversion
 static gnc_numeric
 direct_balance_conversion (GNCPriceDB *db, gnc_numeric bal,// Local: 2:0:0
@@ -1399,6 +1734,120 @@ test_gnc_pricedb_get_nearest_price (PriceDBFixture *fixture, gconstpointer pData
     g_assert_cmpint(result.denom, ==, 1331);
 }
 
+/* get_nearest_price memoizes its rates; they must follow changes to the
+ * prices they were found from. */
+static void
+test_gnc_pricedb_get_nearest_price_cached (PriceDBFixture *fixture,
+                                           gconstpointer pData)
+{
+    QofBook *book = qof_instance_get_book (fixture->pricedb);
+    time64 t = gnc_dmy2time64(15, 8, 2011);
+    GNCPrice *price;
+    gnc_numeric result;
+
+    result = gnc_pricedb_get_nearest_price (fixture->pricedb,
+                                            fixture->com->amzn,
+                                            fixture->com->aud, t);
+    g_assert_cmpint(result.num, ==, 278150);
+    g_assert_cmpint(result.denom, ==, 1331);
+    result = gnc_pricedb_get_nearest_price (fixture->pricedb,
+                                            fixture->com->amzn,
+                                            fixture->com->aud, t);
+    g_assert_cmpint(result.num, ==, 278150);
+    g_assert_cmpint(result.denom, ==, 1331);
+
+    price = construct_price(book, fixture->com->amzn, fixture->com->aud, t,
+                            PRICE_SOURCE_USER_PRICE, gnc_numeric_create(300, 1));
+    g_assert (gnc_pricedb_add_price(fixture->pricedb, price));
+    result = gnc_pricedb_get_nearest_price (fixture->pricedb,
+                                            fixture->com->amzn,
+                                            fixture->com->aud, t);
+    g_assert_cmpint(result.num, ==, 300);
+    g_assert_cmpint(result.denom, ==, 1);
+
+    gnc_price_set_value (price, gnc_numeric_create(310, 1));
+    result = gnc_pricedb_get_nearest_price (fixture->pricedb,
+                                            fixture->com->amzn,
+                                            fixture->com->aud, t);
+    g_assert_cmpint(result.num, ==, 310);
+    g_assert_cmpint(result.denom, ==, 1);
+
+    g_assert (gnc_pricedb_remove_price(fixture->pricedb, price));
+    result = gnc_pricedb_get_nearest_price (fixture->pricedb,
+                                            fixture->com->amzn,
+                                            fixture->com->aud, t);
+    g_assert_cmpint(result.num, ==, 278150);
+    g_assert_cmpint(result.denom, ==, 1331);
+}
+
+#define CONCURRENT_LOOKUP_DAYS 60
+#define CONCURRENT_LOOKUP_THREADS 4
+
+typedef struct
+{
+    PriceDBFixture *fixture;
+    time64 start;
+    gnc_numeric expected[CONCURRENT_LOOKUP_DAYS];
+    GNCPrice *latest;
+} ConcurrentLookupData;
+
+static gpointer
+concurrent_lookup_thread (gpointer user_data)
+{
+    ConcurrentLookupData *data = user_data;
+    Commodities *c = data->fixture->com;
+    gboolean ok = TRUE;
+    gint day;
+
+    for (day = 0; day < CONCURRENT_LOOKUP_DAYS; day++)
+    {
+        time64 t = data->start + day * 86400;
+        gnc_numeric rate =
+            gnc_pricedb_get_nearest_price (data->fixture->pricedb, c->amzn,
+                                           c->aud, t);
+        GNCPrice *latest =
+            gnc_pricedb_lookup_latest (data->fixture->pricedb, c->amzn, c->usd);
+        if (!gnc_numeric_equal (rate, data->expected[day]) ||
+            latest != data->latest)
+            ok = FALSE;
+        gnc_price_unref (latest);
+    }
+    return GINT_TO_POINTER (ok);
+}
+
+/* Lookups from several threads at once, each filling the series and
+ * conversion caches, get the same answers as lookups from one. */
+static void
+test_gnc_pricedb_concurrent_lookups (PriceDBFixture *fixture,
+                                     gconstpointer pData)
+{
+    ConcurrentLookupData data;
+    GThread *threads[CONCURRENT_LOOKUP_THREADS];
+    Commodities *c = fixture->com;
+    guint32 refcount;
+    gint day, i;
+
+    data.fixture = fixture;
+    data.start = gnc_dmy2time64(1, 7, 2011);
+    for (day = 0; day < CONCURRENT_LOOKUP_DAYS; day++)
+        data.expected[day] =
+            gnc_pricedb_get_nearest_price (fixture->pricedb, c->amzn, c->aud,
+                                           data.start + day * 86400);
+    data.latest = gnc_pricedb_lookup_latest (fixture->pricedb, c->amzn, c->usd);
+    g_assert (data.latest != NULL);
+    refcount = data.latest->refcount;
+    g_hash_table_remove_all (fixture->pricedb->conversion_cache);
+    g_hash_table_remove_all (fixture->pricedb->series_hash);
+
+    for (i = 0; i < CONCURRENT_LOOKUP_THREADS; i++)
+        threads[i] = g_thread_new ("price lookup", concurrent_lookup_thread,
+                                   &data);
+    for (i = 0; i < CONCURRENT_LOOKUP_THREADS; i++)
+        g_assert (GPOINTER_TO_INT (g_thread_join (threads[i])));
+    g_assert_cmpuint (data.latest->refcount, ==, refcount);
+    gnc_price_unref (data.latest);
+}
+
 static void
 test_gnc_pricedb_get_nearest_before_price (PriceDBFixture *fixture, gconstpointer pData)
 {
@@ -1686,10 +2135,17 @@ test_suite_gnc_pricedb (void)
 // GNC_TEST_ADD (suitename, "hash values helper", PriceDBFixture, NULL, setup, test_hash_values_helper, teardown);
     GNC_TEST_ADD (suitename, "gnc pricedb has prices", PriceDBFixture, NULL, setup, test_gnc_pricedb_has_prices, teardown);
     GNC_TEST_ADD (suitename, "gnc pricedb get prices", PriceDBFixture, NULL, setup, test_gnc_pricedb_get_prices, teardown);
+    GNC_TEST_ADD (suitename, "gnc pricedb nth price", PriceDBFixture, NULL, setup, test_gnc_pricedb_nth_price, teardown);
     GNC_TEST_ADD (suitename, "gnc pricedb lookup day", PriceDBFixture, NULL, setup, test_gnc_pricedb_lookup_day_t64, teardown);
+    GNC_TEST_ADD (suitename, "gnc pricedb add prices bulk", PriceDBFixture, NULL, setup, test_gnc_pricedb_add_prices_bulk, teardown);
+    GNC_TEST_ADD (suitename, "gnc pricedb remove prices", PriceDBFixture, NULL, setup, test_gnc_pricedb_remove_prices, teardown);
+    GNC_TEST_ADD (suitename, "gnc pricedb compact", PriceDBFixture, NULL, setup, test_gnc_pricedb_compact, teardown);
+    GNC_TEST_ADD (suitename, "gnc pricedb lookup at time", PriceDBFixture, NULL, setup, test_gnc_pricedb_lookup_at_time64, teardown);
+    GNC_TEST_ADD (suitename, "gnc pricedb lookup after change", PriceDBFixture, NULL, setup, test_gnc_pricedb_lookup_after_change, teardown);
 // GNC_TEST_ADD (suitename, "lookup nearest in time", Fixture, NULL, setup, test_lookup_nearest_in_time, teardown);
     GNC_TEST_ADD (suitename, "gnc pricedb lookup nearest in time", PriceDBFixture, NULL, setup, test_gnc_pricedb_lookup_nearest_in_time64, teardown);
     GNC_TEST_ADD (suitename, "gnc pricedb lookup nearest before in time", PriceDBFixture, NULL, setup, test_gnc_pricedb_lookup_nearest_before_t64, teardown);
+    GNC_TEST_ADD (suitename, "gnc pricedb lookup nearest before matrix", PriceDBFixture, NULL, setup, test_gnc_pricedb_lookup_nearest_before_matrix_t64, teardown);
 // GNC_TEST_ADD (suitename, "direct balance conversion", Fixture, NULL, setup, test_direct_balance_conversion, teardown);
 // GNC_TEST_ADD (suitename, "extract common prices", Fixture, NULL, setup, test_extract_common_prices, teardown);
 // GNC_TEST_ADD (suitename, "convert balance", Fixture, NULL, setup, test_convert_balance, teardown);
@@ -1699,6 +2155,8 @@ test_suite_gnc_pricedb (void)
     GNC_TEST_ADD (suitename, "gnc pricedb convert balance nearest before price", PriceDBFixture, NULL, setup, test_gnc_pricedb_convert_balance_nearest_before_price_t64, teardown);
     GNC_TEST_ADD (suitename, "gnc pricedb get latest price", PriceDBFixture, NULL, setup, test_gnc_pricedb_get_latest_price, teardown);
     GNC_TEST_ADD (suitename, "gnc pricedb get nearest price", PriceDBFixture, NULL, setup, test_gnc_pricedb_get_nearest_price, teardown);
+    GNC_TEST_ADD (suitename, "gnc pricedb get nearest price cached", PriceDBFixture, NULL, setup, test_gnc_pricedb_get_nearest_price_cached, teardown);
+    GNC_TEST_ADD (suitename, "gnc pricedb concurrent lookups", PriceDBFixture, NULL, setup, test_gnc_pricedb_concurrent_lookups, teardown);
     GNC_TEST_ADD (suitename, "gnc pricedb get nearest before price", PriceDBFixture, NULL, setup, test_gnc_pricedb_get_nearest_before_price, teardown);
 // GNC_TEST_ADD (suitename, "pricedb foreach pricelist", Fixture, NULL, setup, test_pricedb_foreach_pricelist, teardown);
 // GNC_TEST_ADD (suitename, "pricedb foreach currencies hash", Fixture, NULL, setup, test_pricedb_foreach_currencies_hash, teardown);